@@ -0,0 +1,381 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Microbenchmarks of the DocDB hot paths: key and value encoding, write batch construction, and
+// iteration over data with and without transaction intents.
+//
+// Every benchmark logs one JSON object per measurement, and appends it to
+// --docdb_bench_output_file if set, so that results can be collected for regression tracking.
+// Defaults are small enough for the benchmarks to run as part of the tests, e.g.
+//
+//   docdb-bench --docdb_bench_num_ops=10000000 --docdb_bench_num_rows=1000000 \
+//       --docdb_bench_output_file=/tmp/docdb-bench.json
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/common/transaction.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/util/format.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/monotime.h"
+#include "yb/util/random.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(docdb_bench_num_ops, 100000,
+             "Number of operations measured by each DocDB benchmark.");
+DEFINE_int32(docdb_bench_num_rows, 10000,
+             "Number of rows loaded for the DocDB iterator benchmarks.");
+DEFINE_string(docdb_bench_output_file, "",
+              "File to append the DocDB benchmark results to, one JSON object per line.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr int kNarrowSchemaValueColumns = 2;
+constexpr int kWideSchemaValueColumns = 32;
+constexpr int kRowsPerWriteBatch = 100;
+constexpr int kScanBatchSize = 64;
+
+// Regular records are written at kWriteMicros, intents of the benchmark transaction at
+// kIntentMicros, and all of them are read at kReadMicros, after the transaction commit.
+constexpr uint64_t kWriteMicros = 1000;
+constexpr uint64_t kIntentMicros = 2000;
+constexpr uint64_t kCommitMicros = 3000;
+constexpr uint64_t kReadMicros = 5000;
+
+// Knows the commit time of a single transaction locally, so that resolving its intents doesn't
+// have to wait for a status tablet.
+class CommittedTransactionStatusManager : public TransactionStatusManager {
+ public:
+  CommittedTransactionStatusManager(const TransactionId& id, HybridTime commit_time)
+      : id_(id), commit_time_(commit_time) {}
+
+  HybridTime LocalCommitTime(const TransactionId& id) override {
+    return id == id_ ? commit_time_ : HybridTime::kInvalid;
+  }
+
+  void RequestStatusAt(const StatusRequest& request) override {
+    request.callback(TransactionStatusResult{TransactionStatus::ABORTED, HybridTime::kMin});
+  }
+
+  int64_t RegisterRequest() override {
+    return 0;
+  }
+
+  boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
+    return boost::none;
+  }
+
+  void Abort(const TransactionId& id, TransactionStatusCallback callback) override {
+  }
+
+ private:
+  const TransactionId id_;
+  const HybridTime commit_time_;
+};
+
+// A table with a single int64 range key column and 'num_value_columns' int64 value columns.
+Schema MakeSchema(int num_value_columns) {
+  std::vector<ColumnSchema> columns;
+  std::vector<ColumnId> column_ids;
+  columns.emplace_back("k", DataType::INT64, /* is_nullable = */ false);
+  column_ids.push_back(kFirstColumnId);
+  for (int i = 0; i != num_value_columns; ++i) {
+    columns.emplace_back(Format("v$0", i), DataType::INT64, /* is_nullable = */ true);
+    column_ids.emplace_back(kFirstColumnId + 1 + i);
+  }
+  return Schema(columns, column_ids, 1);
+}
+
+KeyBytes EncodedRowKey(int64_t row) {
+  return DocKey(PrimitiveValues(row)).Encode();
+}
+
+} // namespace
+
+class DocDBBench : public DocDBTestBase {
+ protected:
+  // Calls op(i) for every i in [0, num_ops) and reports the time taken under 'name'.
+  template <class Op>
+  void Measure(const std::string& name, int num_ops, const Op& op) {
+    const MonoTime start = MonoTime::Now();
+    for (int i = 0; i != num_ops; ++i) {
+      op(i);
+    }
+    Report(name, num_ops, MonoTime::Now() - start);
+  }
+
+  void Report(const std::string& name, int64_t num_ops, const MonoDelta& elapsed) {
+    const int64_t elapsed_nanos = std::max<int64_t>(elapsed.ToNanoseconds(), 1);
+    std::stringstream out;
+    JsonWriter writer(&out, JsonWriter::COMPACT);
+    writer.StartObject();
+    writer.String("benchmark");
+    writer.String(name);
+    writer.String("ops");
+    writer.Int64(num_ops);
+    writer.String("elapsed_us");
+    writer.Int64(elapsed.ToMicroseconds());
+    writer.String("ns_per_op");
+    writer.Double(num_ops == 0 ? 0 : static_cast<double>(elapsed_nanos) / num_ops);
+    writer.String("ops_per_sec");
+    writer.Double(num_ops * 1e9 / elapsed_nanos);
+    writer.EndObject();
+
+    LOG(INFO) << "DocDB benchmark result: " << out.str();
+    if (!FLAGS_docdb_bench_output_file.empty()) {
+      std::ofstream output_file(FLAGS_docdb_bench_output_file, std::ios::app);
+      output_file << out.str() << std::endl;
+    }
+  }
+
+  // Writes FLAGS_docdb_bench_num_rows rows of 'schema' and flushes them. If 'intent_every_n' is
+  // set, every n-th row is then overwritten by the intents of a transaction, left unflushed as
+  // they would be for a recent transaction.
+  void LoadRows(const Schema& schema, int intent_every_n = 0) {
+    auto dwb = MakeDocWriteBatch();
+    for (int row = 0; row != FLAGS_docdb_bench_num_rows; ++row) {
+      WriteRow(schema, row, &dwb);
+      if ((row + 1) % kRowsPerWriteBatch == 0) {
+        ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(kWriteMicros)));
+      }
+    }
+    if (!dwb.IsEmpty()) {
+      ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(kWriteMicros)));
+    }
+    ASSERT_OK(FlushRocksDB());
+
+    if (intent_every_n == 0) {
+      return;
+    }
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    SetCurrentTransactionId(txn_id_);
+    for (int row = 0; row < FLAGS_docdb_bench_num_rows; row += intent_every_n) {
+      WriteRow(schema, row, &dwb);
+      ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(kIntentMicros)));
+    }
+    ResetCurrentTransactionId();
+  }
+
+  void WriteRow(const Schema& schema, int64_t row, DocWriteBatch* dwb) {
+    const KeyBytes encoded_doc_key = EncodedRowKey(row);
+    for (size_t i = schema.num_key_columns(); i != schema.num_columns(); ++i) {
+      ASSERT_OK(dwb->SetPrimitive(
+          DocPath(encoded_doc_key, PrimitiveValue(schema.column_id(i))),
+          PrimitiveValue(row * 1000 + static_cast<int64_t>(i))));
+    }
+  }
+
+  TransactionOperationContextOpt TxnContext() {
+    return TransactionOperationContext(GenerateTransactionId(), &txn_status_manager_);
+  }
+
+  void BenchmarkSeeks(const std::string& name, const TransactionOperationContextOpt& txn_context) {
+    std::vector<DocKey> keys;
+    keys.reserve(FLAGS_docdb_bench_num_ops);
+    Random rng(SeedRandom());
+    for (int i = 0; i != FLAGS_docdb_bench_num_ops; ++i) {
+      keys.emplace_back(PrimitiveValues(
+          static_cast<int64_t>(rng.Uniform(FLAGS_docdb_bench_num_rows))));
+    }
+
+    auto iter = CreateIntentAwareIterator(
+        rocksdb(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+        txn_context, ReadHybridTime::FromMicros(kReadMicros));
+    auto seek = [&iter, &keys](int i) {
+      iter->Seek(keys[i]);
+      CHECK(iter->valid());
+      CHECK_OK(iter->FetchKey().status());
+    };
+    Measure(name + ".RandomSeek", FLAGS_docdb_bench_num_ops, seek);
+
+    std::sort(keys.begin(), keys.end());
+    Measure(name + ".AscendingSeek", FLAGS_docdb_bench_num_ops, seek);
+  }
+
+  void BenchmarkScans(const std::string& name, const Schema& schema) {
+    std::vector<StringPiece> value_columns;
+    for (size_t i = schema.num_key_columns(); i != schema.num_columns(); ++i) {
+      value_columns.push_back(schema.column(i).name());
+    }
+    Schema projection;
+    ASSERT_OK(schema.CreateProjectionByNames(value_columns, &projection));
+
+    {
+      DocRowwiseIterator iter(projection, schema, kNonTransactionalOperationContext, rocksdb(),
+                              ReadHybridTime::FromMicros(kReadMicros));
+      const MonoTime start = MonoTime::Now();
+      ASSERT_OK(iter.Init());
+      QLTableRow row;
+      int num_rows = 0;
+      while (iter.HasNext()) {
+        ASSERT_OK(iter.NextRow(&row));
+        ++num_rows;
+      }
+      Report(name + ".NextRow", num_rows, MonoTime::Now() - start);
+      ASSERT_EQ(FLAGS_docdb_bench_num_rows, num_rows);
+    }
+
+    {
+      DocRowwiseIterator iter(projection, schema, kNonTransactionalOperationContext, rocksdb(),
+                              ReadHybridTime::FromMicros(kReadMicros));
+      const MonoTime start = MonoTime::Now();
+      ASSERT_OK(iter.Init());
+      std::vector<QLTableRow> rows;
+      size_t num_rows = 0;
+      while (iter.HasNext()) {
+        size_t batch_rows = 0;
+        ASSERT_OK(iter.NextRowBatch(iter.schema(), kScanBatchSize, &rows, &batch_rows));
+        num_rows += batch_rows;
+      }
+      Report(name + ".NextRowBatch", num_rows, MonoTime::Now() - start);
+      ASSERT_EQ(FLAGS_docdb_bench_num_rows, static_cast<int>(num_rows));
+    }
+  }
+
+  const TransactionId txn_id_ = GenerateTransactionId();
+  CommittedTransactionStatusManager txn_status_manager_{
+      txn_id_, HybridTime::FromMicros(kCommitMicros)};
+};
+
+TEST_F(DocDBBench, KeyEncoding) {
+  const DocKey doc_key(0x1234, PrimitiveValues("user-1234567890"),
+                       PrimitiveValues(static_cast<int64_t>(42), "range-component"));
+  const SubDocKey subdoc_key(doc_key, PrimitiveValue(ColumnId(kFirstColumnId + 3)),
+                             HybridTime::FromMicros(kWriteMicros));
+  const int num_ops = FLAGS_docdb_bench_num_ops;
+
+  KeyBytes encoded;
+  Measure("DocKey.Encode", num_ops, [&](int) {
+    encoded = doc_key.Encode();
+  });
+  Measure("DocKey.Decode", num_ops, [&](int) {
+    DocKey decoded;
+    CHECK_OK(decoded.FullyDecodeFrom(encoded.AsSlice()));
+  });
+  Measure("DocKey.EncodedSize", num_ops, [&](int) {
+    CHECK_OK(DocKey::EncodedSize(encoded.AsSlice(), DocKeyPart::WHOLE_DOC_KEY).status());
+  });
+
+  Measure("SubDocKey.Encode", num_ops, [&](int) {
+    encoded = subdoc_key.Encode();
+  });
+  Measure("SubDocKey.Decode", num_ops, [&](int) {
+    SubDocKey decoded;
+    CHECK_OK(decoded.FullyDecodeFrom(encoded.AsSlice()));
+  });
+}
+
+TEST_F(DocDBBench, PrimitiveValueSerialization) {
+  const std::vector<PrimitiveValue> values = {
+      PrimitiveValue(static_cast<int64_t>(1234567890123)),
+      PrimitiveValue("a string value of a typical size"),
+      PrimitiveValue::Double(3.14159),
+      PrimitiveValue(ColumnId(kFirstColumnId + 7)),
+  };
+  const int num_ops = FLAGS_docdb_bench_num_ops;
+
+  KeyBytes key_bytes;
+  Measure("PrimitiveValue.AppendToKey", num_ops, [&](int i) {
+    key_bytes.Clear();
+    values[i % values.size()].AppendToKey(&key_bytes);
+  });
+  std::vector<KeyBytes> encoded_keys;
+  for (const auto& value : values) {
+    encoded_keys.push_back(value.ToKeyBytes());
+  }
+  Measure("PrimitiveValue.DecodeFromKey", num_ops, [&](int i) {
+    PrimitiveValue decoded;
+    Slice slice = encoded_keys[i % encoded_keys.size()].AsSlice();
+    CHECK_OK(decoded.DecodeFromKey(&slice));
+  });
+
+  std::string encoded_value;
+  Measure("PrimitiveValue.ToValue", num_ops, [&](int i) {
+    encoded_value = values[i % values.size()].ToValue();
+  });
+  std::vector<std::string> encoded_values;
+  for (const auto& value : values) {
+    encoded_values.push_back(value.ToValue());
+  }
+  Measure("PrimitiveValue.DecodeFromValue", num_ops, [&](int i) {
+    PrimitiveValue decoded;
+    CHECK_OK(decoded.DecodeFromValue(encoded_values[i % encoded_values.size()]));
+  });
+}
+
+TEST_F(DocDBBench, DocWriteBatchConstruction) {
+  const Schema schema = MakeSchema(kNarrowSchemaValueColumns);
+  std::vector<KeyBytes> encoded_keys;
+  for (int row = 0; row != kRowsPerWriteBatch; ++row) {
+    encoded_keys.push_back(EncodedRowKey(row));
+  }
+
+  // Every op sets one column, and the batch is cleared when it has a full set of rows, like the
+  // batch of a typical multi-row write.
+  const int num_value_columns = kNarrowSchemaValueColumns;
+  auto dwb = MakeDocWriteBatch();
+  Measure("DocWriteBatch.SetPrimitive", FLAGS_docdb_bench_num_ops, [&](int i) {
+    const int row = (i / num_value_columns) % kRowsPerWriteBatch;
+    const int column = i % num_value_columns;
+    CHECK_OK(dwb.SetPrimitive(
+        DocPath(encoded_keys[row], PrimitiveValue(schema.column_id(1 + column))),
+        PrimitiveValue(static_cast<int64_t>(i))));
+    if (i % (kRowsPerWriteBatch * num_value_columns) ==
+            kRowsPerWriteBatch * num_value_columns - 1) {
+      dwb.Clear();
+    }
+  });
+}
+
+TEST_F(DocDBBench, IntentAwareIteratorSeek) {
+  const Schema schema = MakeSchema(kNarrowSchemaValueColumns);
+  ASSERT_NO_FATALS(LoadRows(schema));
+  BenchmarkSeeks("IntentAwareIterator.NoTransaction", boost::none);
+  BenchmarkSeeks("IntentAwareIterator.NoIntents", TxnContext());
+}
+
+TEST_F(DocDBBench, IntentAwareIteratorSeekWithIntents) {
+  const Schema schema = MakeSchema(kNarrowSchemaValueColumns);
+  ASSERT_NO_FATALS(LoadRows(schema, /* intent_every_n = */ 10));
+  BenchmarkSeeks("IntentAwareIterator.WithIntents", TxnContext());
+}
+
+TEST_F(DocDBBench, DocRowwiseIteratorNarrowScan) {
+  const Schema schema = MakeSchema(kNarrowSchemaValueColumns);
+  ASSERT_NO_FATALS(LoadRows(schema));
+  ASSERT_NO_FATALS(BenchmarkScans("DocRowwiseIterator.NarrowScan", schema));
+}
+
+TEST_F(DocDBBench, DocRowwiseIteratorWideScan) {
+  const Schema schema = MakeSchema(kWideSchemaValueColumns);
+  ASSERT_NO_FATALS(LoadRows(schema));
+  ASSERT_NO_FATALS(BenchmarkScans("DocRowwiseIterator.WideScan", schema));
+}
+
+} // namespace docdb
+} // namespace yb
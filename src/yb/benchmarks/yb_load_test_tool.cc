@@ -40,6 +40,7 @@
 #include "yb/util/threadpool.h"
 
 #include "yb/integration-tests/load_generator.h"
+#include "yb/integration-tests/workload_generator.h"
 
 DEFINE_int32(rpc_timeout_sec, 30, "Timeout for RPC calls, in seconds");
 
@@ -102,6 +103,42 @@ DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_string(
+    workload, "",
+    "Run a YCSB-style workload instead of the writer and reader threads, given as a mix of "
+    "<op>=<weight> with ops read, update, insert, scan and rmw, e.g. read=95,update=5. The "
+    "num_rows keys are loaded first unless --workload_skip_load is set.");
+
+DEFINE_string(
+    workload_key_distribution, "uniform",
+    "Distribution of the keys accessed by the workload: uniform, zipfian or latest.");
+
+DEFINE_int32(workload_num_threads, 8, "Number of threads running the workload.");
+
+DEFINE_int64(
+    workload_num_ops, 0,
+    "Number of workload operations to run, 0 to run for --workload_duration_sec instead.");
+
+DEFINE_int32(workload_duration_sec, 60, "How long to run the workload for.");
+
+DEFINE_double(
+    workload_target_ops_per_sec, 0,
+    "Total rate at which workload operations are started, independently of how long they take, "
+    "so that latencies include the time spent waiting behind slow operations. 0 runs every "
+    "thread as fast as possible.");
+
+DEFINE_int32(workload_scan_length, 100, "Number of rows read by a workload scan.");
+
+DEFINE_bool(
+    workload_skip_load, false,
+    "Assume the keys were loaded by an earlier workload run with the same --workload_client_id.");
+
+DEFINE_string(workload_client_id, "workload", "Part of every key of the workload.");
+
+DEFINE_string(
+    workload_histogram_output_file, "",
+    "File to write the latency percentile distribution of every workload op type to.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -140,6 +177,9 @@ using yb::load_generator::MultiThreadedReader;
 using yb::load_generator::MultiThreadedWriter;
 using yb::load_generator::SingleThreadedScanner;
 using yb::load_generator::FormatHexForLoadTestKey;
+using yb::load_generator::Workload;
+using yb::load_generator::WorkloadMix;
+using yb::load_generator::WorkloadOptions;
 
 // ------------------------------------------------------------------------------------------------
 
@@ -149,6 +189,8 @@ void CreateYBTable(const YBTableName &table_name, const shared_ptr<YBClient> &cl
 
 void LaunchYBLoadTest(SessionFactory *session_factory);
 
+void RunWorkload(const Workload::SessionCreator& session_creator);
+
 shared_ptr<YBClient> CreateYBClient();
 
 void SetupYBTable(const shared_ptr<YBClient> &client);
@@ -188,7 +230,11 @@ int main(int argc, char *argv[]) {
 
       yb::client::TableHandle table;
       CHECK_OK(table.Open(table_name, client.get()));
-      if (FLAGS_reads_only) {
+      if (!FLAGS_workload.empty()) {
+        RunWorkload([&client, &table] {
+          return yb::load_generator::NewYBWorkloadSession(client.get(), &table);
+        });
+      } else if (FLAGS_reads_only) {
         SingleThreadedScanner scanner(&table);
         scanner.CountRows();
       } else if (FLAGS_noop_only) {
@@ -206,7 +252,11 @@ int main(int argc, char *argv[]) {
         LOG(INFO) << "Done creating redis table";
         return 0;
       }
-      if (FLAGS_noop_only) {
+      if (!FLAGS_workload.empty()) {
+        RunWorkload([] {
+          return yb::load_generator::NewRedisWorkloadSession(FLAGS_target_redis_server_addresses);
+        });
+      } else if (FLAGS_noop_only) {
         RedisNoopSessionFactory session_factory(FLAGS_target_redis_server_addresses);
         LaunchYBLoadTest(&session_factory);
       } else {
@@ -383,3 +433,29 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     reader.WaitForCompletion();
   }
 }
+
+void RunWorkload(const Workload::SessionCreator& session_creator) {
+  auto mix = WorkloadMix::Parse(FLAGS_workload);
+  CHECK_OK(mix);
+
+  WorkloadOptions options;
+  options.mix = *mix;
+  options.key_distribution = FLAGS_workload_key_distribution;
+  options.num_threads = FLAGS_workload_num_threads;
+  options.num_initial_keys = FLAGS_num_rows;
+  options.load_initial_keys = !FLAGS_workload_skip_load;
+  options.num_ops = FLAGS_workload_num_ops;
+  options.duration = MonoDelta::FromSeconds(FLAGS_workload_duration_sec);
+  options.target_ops_per_sec = FLAGS_workload_target_ops_per_sec;
+  options.value_size = FLAGS_value_size_bytes;
+  options.scan_length = FLAGS_workload_scan_length;
+  options.client_id = FLAGS_workload_client_id;
+
+  Workload workload(options, session_creator);
+  CHECK_OK(workload.Run());
+  if (!FLAGS_workload_histogram_output_file.empty()) {
+    CHECK_OK(yb::WriteStringToFile(
+        yb::Env::Default(), workload.PercentileDistributions(),
+        FLAGS_workload_histogram_output_file));
+  }
+}
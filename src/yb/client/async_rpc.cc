@@ -12,6 +12,9 @@
 //
 
 #include "yb/client/async_rpc.h"
+
+#include <algorithm>
+
 #include "yb/client/batcher.h"
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
@@ -24,6 +27,7 @@
 
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -44,6 +48,32 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_histogram(
+    server, yb_client_ops_per_rpc, "Number of operations in a Write/Read rpc",
+    yb::MetricUnit::kOperations, "Number of operations batched into a single Write/Read rpc",
+    100000LU, 2);
+METRIC_DEFINE_counter(
+    server, yb_client_hedged_reads, "Hedged reads", yb::MetricUnit::kRequests,
+    "Number of reads that were also sent to a second replica because the first one was slow");
+METRIC_DEFINE_counter(
+    server, yb_client_hedged_reads_won, "Hedged reads won", yb::MetricUnit::kRequests,
+    "Number of hedged reads that were answered before the original read");
+
+DEFINE_int32(client_hedged_read_max_percent, 5,
+             "Reads that may be served by any replica are hedged to a second replica when the "
+             "first one is slow, for at most this percentage of such reads. 0 disables hedging.");
+TAG_FLAG(client_hedged_read_max_percent, runtime);
+TAG_FLAG(client_hedged_read_max_percent, advanced);
+
+DEFINE_double(client_hedged_read_latency_percentile, 95,
+              "Reads are hedged when they take longer than this percentile of the remote read "
+              "latency.");
+TAG_FLAG(client_hedged_read_latency_percentile, advanced);
+
+DEFINE_int32(client_hedged_read_min_delay_ms, 2,
+             "Reads are never hedged earlier than this.");
+TAG_FLAG(client_hedged_read_min_delay_ms, advanced);
+
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -74,7 +104,57 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      ops_per_rpc(METRIC_yb_client_ops_per_rpc.Instantiate(entity)),
+      hedged_reads(METRIC_yb_client_hedged_reads.Instantiate(entity)),
+      hedged_reads_won(METRIC_yb_client_hedged_reads_won.Instantiate(entity)) {
+}
+
+namespace {
+
+// The latency percentile is not meaningful before there are enough reads.
+constexpr uint64_t kMinReadsForHedging = 100;
+// Up to this many hedged reads could be sent in a row after a period without hedging.
+constexpr int64_t kMaxHedgedReadBurst = 10;
+
+} // namespace
+
+MonoDelta AsyncRpcMetrics::HedgedReadDelay() {
+  // Computing the percentile walks the histogram, so its value is reused for a second.
+  const auto now = MonoTime::Now();
+  auto next_update = hedged_read_delay_next_update_.load(std::memory_order_acquire);
+  if (now.ToUint64() >= next_update &&
+      hedged_read_delay_next_update_.compare_exchange_strong(
+          next_update, (now + MonoDelta::FromSeconds(1)).ToUint64())) {
+    int64_t delay_us = 0;
+    if (remote_read_rpc_time->TotalCount() >= kMinReadsForHedging) {
+      delay_us = std::max<int64_t>(
+          remote_read_rpc_time->ValueAtPercentile(FLAGS_client_hedged_read_latency_percentile),
+          FLAGS_client_hedged_read_min_delay_ms * 1000);
+    }
+    hedged_read_delay_us_.store(delay_us, std::memory_order_release);
+  }
+  const auto delay_us = hedged_read_delay_us_.load(std::memory_order_acquire);
+  return delay_us != 0 ? MonoDelta::FromMicroseconds(delay_us) : MonoDelta();
+}
+
+void AsyncRpcMetrics::AddHedgedReadBudget() {
+  const int64_t max_budget = kMaxHedgedReadBurst * 100;
+  auto budget = hedged_read_budget_.load(std::memory_order_acquire);
+  while (budget < max_budget &&
+         !hedged_read_budget_.compare_exchange_weak(
+             budget, std::min(budget + FLAGS_client_hedged_read_max_percent, max_budget))) {
+  }
+}
+
+bool AsyncRpcMetrics::TryAcquireHedgedRead() {
+  auto budget = hedged_read_budget_.load(std::memory_order_acquire);
+  while (budget >= 100) {
+    if (hedged_read_budget_.compare_exchange_weak(budget, budget - 100)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 AsyncRpc::AsyncRpc(
@@ -83,7 +163,7 @@ AsyncRpc::AsyncRpc(
     : Rpc(batcher->deadline(), batcher->messenger()),
       batcher_(batcher),
       trace_(new Trace),
-      tablet_invoker_(yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX,
+      tablet_invoker_(yb_consistency_level != YBConsistencyLevel::STRONG,
                       batcher->client_,
                       this,
                       this,
@@ -418,7 +498,9 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
 ReadRpc::ReadRpc(
     const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
     bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel yb_consistency_level)
-    : AsyncRpcBase(batcher, tablet, allow_local_calls_in_curr_thread, ops, yb_consistency_level) {
+    : AsyncRpcBase(batcher, tablet, allow_local_calls_in_curr_thread, ops, yb_consistency_level),
+      hedging_enabled_(yb_consistency_level != YBConsistencyLevel::STRONG &&
+                       FLAGS_client_hedged_read_max_percent > 0 && async_rpc_metrics_) {
   TRACE_TO(trace_, "ReadRpc initiated to $0", tablet->tablet_id());
   req_.set_consistency_level(yb_consistency_level);
 
@@ -439,9 +521,17 @@ ReadRpc::ReadRpc(
         // in ProcessResponseFromTserver.
         auto* ql_op = down_cast<YBqlReadOp*>(op->yb_op.get());
         req_.add_ql_batch()->Swap(ql_op->mutable_request());
+        ql_op->mutable_read_ahead_pages()->clear();
         if (ql_op->read_time()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        if (yb_consistency_level == YBConsistencyLevel::BOUNDED_STALENESS) {
+          // The strictest bound of the batched reads is used for all of them.
+          uint64_t max_staleness_ms = std::max<int64_t>(ql_op->max_staleness().ToMilliseconds(), 0);
+          if (!req_.has_max_staleness_ms() || max_staleness_ms < req_.max_staleness_ms()) {
+            req_.set_max_staleness_ms(max_staleness_ms);
+          }
+        }
         break;
       }
       case YBOperation::Type::REDIS_WRITE: FALLTHROUGH_INTENDED;
@@ -474,17 +564,150 @@ ReadRpc::~ReadRpc() {
   }
 }
 
+void ReadRpc::Finished(const Status& status) {
+  if (hedging_enabled_) {
+    bool hedge_won;
+    {
+      std::lock_guard<simple_spinlock> l(hedge_lock_);
+      hedge_won = hedge_state_ == HedgeState::kHedgeWon;
+      if (!hedge_won) {
+        hedge_state_ = HedgeState::kDone;
+        resp_.Swap(&primary_resp_);
+      }
+    }
+    if (hedge_won) {
+      // The ops were already completed with the response of the hedged read.
+      tablet_invoker_.ResponseIgnored();
+      retained_self_.reset();
+      return;
+    }
+  }
+  AsyncRpc::Finished(status);
+}
+
 void ReadRpc::CallRemoteMethod() {
   auto trace = trace_; // It is possible that we receive reply before returning from ReadAsync.
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
+  tserver::ReadResponsePB* resp = &resp_;
+  if (hedging_enabled_) {
+    // Must be scheduled before the read is sent, since this object could be destroyed by the
+    // response before ReadAsync returns.
+    ScheduleHedgedRead();
+    resp = &primary_resp_;
+  }
   tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, mutable_retrier()->mutable_controller(),
+      req_, resp, mutable_retrier()->mutable_controller(),
       std::bind(&ReadRpc::Finished, this, Status::OK()));
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+void ReadRpc::ScheduleHedgedRead() {
+  {
+    std::lock_guard<simple_spinlock> l(hedge_lock_);
+    // Only the first attempt is hedged, retries already go to other replicas.
+    if (hedge_state_ != HedgeState::kNone) {
+      return;
+    }
+    hedge_state_ = HedgeState::kDone;
+  }
+  // Local reads don't wait for the network, and their request is not serialized, so it could
+  // not be shared with a hedged read.
+  if (IsLocalCall()) {
+    return;
+  }
+  async_rpc_metrics_->AddHedgedReadBudget();
+  auto delay = async_rpc_metrics_->HedgedReadDelay();
+  if (!delay.Initialized()) {
+    return;
+  }
+  {
+    std::lock_guard<simple_spinlock> l(hedge_lock_);
+    hedge_state_ = HedgeState::kScheduled;
+  }
+  std::weak_ptr<rpc::RpcCommand> weak_self = shared_from_this();
+  batcher_->messenger()->ScheduleOnReactor(
+      [weak_self](const Status& status) {
+        auto self = weak_self.lock();
+        if (self && status.ok()) {
+          down_cast<ReadRpc*>(self.get())->SendHedgedRead();
+        }
+      },
+      delay);
+}
+
+void ReadRpc::SendHedgedRead() {
+  RemoteTabletServer* ts;
+  {
+    std::lock_guard<simple_spinlock> l(hedge_lock_);
+    if (hedge_state_ != HedgeState::kScheduled) {
+      return;
+    }
+    ts = tablet_invoker_.SelectHedgeTabletServer();
+    if (ts == nullptr || !async_rpc_metrics_->TryAcquireHedgedRead()) {
+      hedge_state_ = HedgeState::kDone;
+      return;
+    }
+    hedged_read_.reset(new HedgedRead);
+    hedged_read_->req = req_;
+    hedge_state_ = HedgeState::kSent;
+  }
+  TRACE_TO(trace_, "Hedging read to $0", ts->ToString());
+  // Released when the hedged read finishes.
+  hedge_retained_self_ = shared_from_this();
+  ts->InitProxy(&tablet_invoker_.client(),
+                Bind(&ReadRpc::HedgedReadProxyReady, Unretained(this), ts));
+}
+
+void ReadRpc::HedgedReadProxyReady(RemoteTabletServer* ts, const Status& status) {
+  if (!status.ok()) {
+    auto retained_self = std::move(hedge_retained_self_);
+    std::lock_guard<simple_spinlock> l(hedge_lock_);
+    if (hedge_state_ == HedgeState::kSent) {
+      hedge_state_ = HedgeState::kDone;
+    }
+    return;
+  }
+  async_rpc_metrics_->hedged_reads->Increment();
+  hedged_read_->controller.set_deadline(deadline());
+  auto start = MonoTime::Now();
+  ts->RpcStarted();
+  ts->proxy()->ReadAsync(
+      hedged_read_->req, &hedged_read_->resp, &hedged_read_->controller,
+      std::bind(&ReadRpc::HedgedReadFinished, this, ts, start));
+}
+
+void ReadRpc::HedgedReadFinished(RemoteTabletServer* ts, MonoTime start) {
+  auto retained_self = std::move(hedge_retained_self_);
+  ts->RpcFinished(MonoTime::Now() - start);
+  Status status = hedged_read_->controller.status();
+  if (status.ok() && hedged_read_->resp.has_error()) {
+    status = StatusFromPB(hedged_read_->resp.error().status());
+  }
+  {
+    std::lock_guard<simple_spinlock> l(hedge_lock_);
+    if (hedge_state_ != HedgeState::kSent) {
+      // The original replica answered first.
+      return;
+    }
+    if (!status.ok()) {
+      // Errors are left to the original read and its retries.
+      hedge_state_ = HedgeState::kDone;
+      return;
+    }
+    hedge_state_ = HedgeState::kHedgeWon;
+    resp_.Swap(&hedged_read_->resp);
+  }
+  TRACE_TO(trace_, "Hedged read answered first by $0", ts->ToString());
+  async_rpc_metrics_->hedged_reads_won->Increment();
+  // Same as AsyncRpc::Finished for a successful response, retained_self_ is reset when the
+  // original replica answers.
+  ProcessResponseFromTserver(status);
+  batcher_->RemoveInFlightOpsAfterFlushing(ops_, status, PropagatedHybridTime());
+  batcher_->CheckForFinishedFlush();
+}
+
 void ReadRpc::ProcessResponseFromTserver(const Status& status) {
   TRACE_TO(trace_, "ProcessResponseFromTserver($0)", status.ToString(false));
   if (resp_.has_trace_buffer()) {
@@ -496,6 +719,8 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
   }
 
   // Retrieve Redis and QL responses and make sure we received all the responses back.
+  const auto& controller = ResponseController();
+  std::vector<YBqlReadOp*> ql_ops;
   size_t redis_idx = 0;
   size_t ql_idx = 0;
   for (auto& op : ops_) {
@@ -525,11 +750,11 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
-              ql_response.rows_data_sidecar(), &rows_data));
+          CHECK_OK(controller.GetSidecar(ql_response.rows_data_sidecar(), &rows_data));
           down_cast<YBqlReadOp*>(yb_op)->mutable_rows_data()->assign(
               util::to_char_ptr(rows_data.data()), rows_data.size());
         }
+        ql_ops.push_back(ql_op);
         ql_idx++;
         break;
       }
@@ -549,9 +774,30 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
                              ql_idx, resp_.ql_batch().size());
     batcher_->AddOpCountMismatchError();
     Failed(STATUS(IllegalState, "Read response count mismatch"));
+    return;
+  }
+
+  for (auto& page : *resp_.mutable_ql_read_ahead_pages()) {
+    if (page.ql_batch_index() >= ql_ops.size()) {
+      LOG(DFATAL) << "Read ahead page for unknown request: " << page.ShortDebugString();
+      continue;
+    }
+    auto* pages = ql_ops[page.ql_batch_index()]->mutable_read_ahead_pages();
+    pages->emplace_back();
+    pages->back().response.Swap(page.mutable_response());
+    if (pages->back().response.has_rows_data_sidecar()) {
+      Slice rows_data;
+      CHECK_OK(controller.GetSidecar(pages->back().response.rows_data_sidecar(), &rows_data));
+      pages->back().rows_data.assign(util::to_char_ptr(rows_data.data()), rows_data.size());
+    }
   }
 }
 
+const rpc::RpcController& ReadRpc::ResponseController() {
+  std::lock_guard<simple_spinlock> l(hedge_lock_);
+  return hedge_state_ == HedgeState::kHedgeWon ? hedged_read_->controller : retrier().controller();
+}
+
 }  // namespace internal
 }  // namespace client
 }  // namespace yb
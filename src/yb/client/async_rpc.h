@@ -43,6 +43,24 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Histogram> ops_per_rpc;
+  scoped_refptr<Counter> hedged_reads;
+  scoped_refptr<Counter> hedged_reads_won;
+
+  // Delay after which a read that may be served by any replica is sent to a second replica too.
+  // Not initialized while there are too few reads to tell their latency percentile.
+  MonoDelta HedgedReadDelay();
+
+  // Hedged reads are limited to a percentage of the reads that could be hedged, so that they
+  // don't add much load if replicas are slow because of overload.
+  void AddHedgedReadBudget();
+  bool TryAcquireHedgedRead();
+
+ private:
+  std::atomic<int64_t> hedged_read_delay_us_{0};
+  std::atomic<uint64_t> hedged_read_delay_next_update_{0};
+  // In hundredths of a hedged read.
+  std::atomic<int64_t> hedged_read_budget_{0};
 };
 
 typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
@@ -147,6 +165,8 @@ class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResp
   void ProcessResponseFromTserver(const Status& status) override;
 };
 
+// Reads that don't have to go to the leader are hedged: if the replica has not answered within
+// the hedged read delay, the read is sent to another replica, and the first answer is used.
 class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadResponsePB> {
  public:
   ReadRpc(
@@ -157,8 +177,43 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   virtual ~ReadRpc();
 
  private:
+  void Finished(const Status& status) override;
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  void ScheduleHedgedRead();
+  void SendHedgedRead();
+  void HedgedReadProxyReady(RemoteTabletServer* ts, const Status& status);
+  void HedgedReadFinished(RemoteTabletServer* ts, MonoTime start);
+
+  // Controller of the call whose response is in resp_, used to get its sidecars.
+  const rpc::RpcController& ResponseController();
+
+  enum class HedgeState {
+    kNone,
+    kScheduled,
+    kSent,
+    // The first answer came from the original replica, or hedging was given up.
+    kDone,
+    kHedgeWon,
+  };
+
+  // The hedged read has its own copy of the request, since req_ is moved back into the
+  // operations as soon as either replica answers.
+  struct HedgedRead {
+    tserver::ReadRequestPB req;
+    tserver::ReadResponsePB resp;
+    rpc::RpcController controller;
+  };
+
+  const bool hedging_enabled_;
+  simple_spinlock hedge_lock_;
+  HedgeState hedge_state_ = HedgeState::kNone;
+  std::unique_ptr<HedgedRead> hedged_read_;
+  rpc::RpcCommandPtr hedge_retained_self_;
+  // When hedging is enabled, the original replica answers here, so that resp_ only receives
+  // the winning response.
+  tserver::ReadResponsePB primary_resp_;
 };
 
 }  // namespace internal
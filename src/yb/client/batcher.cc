@@ -164,6 +164,11 @@ int Batcher::CountBufferedOperations() const {
   }
 }
 
+size_t Batcher::MaxBufferedOpsPerTablet() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return state_ == kGatheringOps ? max_buffered_ops_per_tablet_ : 0;
+}
+
 void Batcher::CheckForFinishedFlush() {
   std::shared_ptr<YBSessionData> session_data;
   {
@@ -227,6 +232,24 @@ void Batcher::FlushAsync(boost::function<void(const Status&)> callback) {
   FlushBuffersIfReady();
 }
 
+namespace {
+
+size_t RequestSize(const YBOperation& yb_op) {
+  switch (yb_op.type()) {
+    case YBOperation::Type::QL_READ:
+      return down_cast<const YBqlReadOp&>(yb_op).request().ByteSize();
+    case YBOperation::Type::QL_WRITE:
+      return down_cast<const YBqlWriteOp&>(yb_op).request().ByteSize();
+    case YBOperation::Type::REDIS_READ:
+      return down_cast<const YBRedisReadOp&>(yb_op).request().ByteSize();
+    case YBOperation::Type::REDIS_WRITE:
+      return down_cast<const YBRedisWriteOp&>(yb_op).request().ByteSize();
+  }
+  FATAL_INVALID_ENUM_VALUE(YBOperation::Type, yb_op.type());
+}
+
+} // namespace
+
 Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
   // As soon as we get the op, start looking up where it belongs,
   // so that when the user calls Flush, we are ready to go.
@@ -252,6 +275,7 @@ Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
   }
 
   AddInFlightOp(in_flight_op);
+  buffer_bytes_used_.IncrementBy(RequestSize(*yb_op));
   VLOG(3) << "Looking up tablet for " << in_flight_op->yb_op->ToString();
 
   if (yb_op->tablet()) {
@@ -343,6 +367,11 @@ void Batcher::TabletLookupFinished(InFlightOpPtr op, const Status& s) {
     ops_queue_.push_back(op);
   }
 
+  if (state_ == kGatheringOps) {
+    max_buffered_ops_per_tablet_ = std::max(
+        max_buffered_ops_per_tablet_, ++buffered_ops_per_tablet_[op->tablet.get()]);
+  }
+
   l.unlock();
 
   FlushBuffersIfReady();
@@ -356,16 +385,21 @@ void Batcher::TransactionReady(const Status& status, const BatcherPtr& self) {
   }
 }
 
-YB_DEFINE_ENUM(OpGroup, (kWrite)(kLeaderRead)(kConsistentPrefixRead));
+YB_DEFINE_ENUM(OpGroup, (kWrite)(kLeaderRead)(kConsistentPrefixRead)(kBoundedStalenessRead));
 
 OpGroup GetOpGroup(const InFlightOpPtr& op) {
   if (!op->yb_op->read_only()) {
     return OpGroup::kWrite;
   }
-  if (op->yb_op->type() == YBOperation::Type::QL_READ &&
-      std::static_pointer_cast<YBqlReadOp>(op->yb_op)->yb_consistency_level() ==
-          YBConsistencyLevel::CONSISTENT_PREFIX) {
-    return OpGroup::kConsistentPrefixRead;
+  if (op->yb_op->type() == YBOperation::Type::QL_READ) {
+    switch (std::static_pointer_cast<YBqlReadOp>(op->yb_op)->yb_consistency_level()) {
+      case YBConsistencyLevel::CONSISTENT_PREFIX:
+        return OpGroup::kConsistentPrefixRead;
+      case YBConsistencyLevel::BOUNDED_STALENESS:
+        return OpGroup::kBoundedStalenessRead;
+      case YBConsistencyLevel::STRONG:
+        break;
+    }
   }
 
   return OpGroup::kLeaderRead;
@@ -485,10 +519,21 @@ void Batcher::FlushBuffer(
           this, tablet, allow_local_calls_in_curr_thread, std::move(ops),
           YBConsistencyLevel::CONSISTENT_PREFIX);
       break;
+    case OpGroup::kBoundedStalenessRead:
+      rpc = std::make_shared<ReadRpc>(
+          this, tablet, allow_local_calls_in_curr_thread, std::move(ops),
+          YBConsistencyLevel::BOUNDED_STALENESS);
+      break;
   }
   if (!rpc) {
     FATAL_INVALID_ENUM_VALUE(OpGroup, op_group);
   }
+  const auto num_ops = end - begin;
+  num_rpcs_sent_.fetch_add(1, std::memory_order_acq_rel);
+  num_ops_sent_.fetch_add(num_ops, std::memory_order_acq_rel);
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->ops_per_rpc->Increment(num_ops);
+  }
   rpc->SendRpc();
 }
 
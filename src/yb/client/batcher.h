@@ -32,6 +32,7 @@
 #ifndef YB_CLIENT_BATCHER_H_
 #define YB_CLIENT_BATCHER_H_
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -118,6 +119,24 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // "corked" (i.e not yet flushed). Once Flush has been called, this returns 0.
   int CountBufferedOperations() const;
 
+  // Return the largest number of buffered operations routed to a single tablet. Operations that
+  // are still looking up their tablets are not counted.
+  size_t MaxBufferedOpsPerTablet() const;
+
+  // Return the total size of the requests of the operations added to this batcher.
+  int64_t buffer_bytes_used() const {
+    return buffer_bytes_used_.Load();
+  }
+
+  // Number of RPCs sent by this batcher and of operations sent in them.
+  int64_t num_rpcs_sent() const {
+    return num_rpcs_sent_.load(std::memory_order_acquire);
+  }
+
+  int64_t num_ops_sent() const {
+    return num_ops_sent_.load(std::memory_order_acquire);
+  }
+
   // Flush any buffered operations. The callback will be called once there are no
   // more pending operations from this Batcher. If all of the operations succeeded,
   // then the callback will receive Status::OK. Otherwise, it will receive IOError,
@@ -258,6 +277,14 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // The number of bytes used in the buffer for pending operations.
   AtomicInt<int64_t> buffer_bytes_used_;
 
+  // Number of operations per tablet that finished lookup while gathering ops.
+  // Protected by lock_.
+  std::unordered_map<const RemoteTablet*, size_t> buffered_ops_per_tablet_;
+  size_t max_buffered_ops_per_tablet_ = 0;
+
+  std::atomic<int64_t> num_rpcs_sent_{0};
+  std::atomic<int64_t> num_ops_sent_{0};
+
   std::shared_ptr<yb::client::internal::AsyncRpcMetrics> async_rpc_metrics_;
 
   YBTransactionPtr transaction_;
@@ -395,7 +395,9 @@ RemoteTabletServer* YBClient::Data::SelectTServer(const RemoteTablet* rt,
       break;
     }
     case CLOSEST_REPLICA:
-    case FIRST_REPLICA: {
+    case FIRST_REPLICA:
+    case LEAST_OUTSTANDING_REQUESTS:
+    case POWER_OF_TWO_CHOICES: {
       rt->GetRemoteTabletServers(candidates);
       // Filter out all the blacklisted candidates.
       vector<RemoteTabletServer*> filtered;
@@ -439,6 +441,31 @@ RemoteTabletServer* YBClient::Data::SelectTServer(const RemoteTablet* rt,
         if (ret == nullptr && !filtered.empty()) {
           ret = filtered[rand() % filtered.size()];
         }
+      } else if (selection == LEAST_OUTSTANDING_REQUESTS) {
+        for (RemoteTabletServer* rts : filtered) {
+          if (ret == nullptr || rts->outstanding_rpcs() < ret->outstanding_rpcs() ||
+              (rts->outstanding_rpcs() == ret->outstanding_rpcs() &&
+               rts->latency_ewma_us() < ret->latency_ewma_us())) {
+            ret = rts;
+          }
+        }
+      } else if (!filtered.empty()) {
+        // POWER_OF_TWO_CHOICES. Servers without a latency sample yet look the fastest, so that
+        // they get one.
+        auto expected_latency = [](const RemoteTabletServer* rts) {
+          return (rts->latency_ewma_us() + 1) * (rts->outstanding_rpcs() + 1);
+        };
+        ret = filtered[rand() % filtered.size()];
+        if (filtered.size() > 1) {
+          size_t other_index = rand() % (filtered.size() - 1);
+          RemoteTabletServer* other = filtered[other_index];
+          if (other == ret) {
+            other = filtered.back();
+          }
+          if (expected_latency(other) < expected_latency(ret)) {
+            ret = other;
+          }
+        }
       }
       break;
     }
@@ -573,6 +600,9 @@ Status YBClient::Data::IsCreateTableInProgress(YBClient* client,
   }
 
   *create_in_progress = !resp.done();
+  VLOG_IF(1, *create_in_progress) << "Creating table " << table_name.ToString() << ": "
+                                  << resp.num_running_tablets() << " of " << resp.num_tablets()
+                                  << " tablets running";
   return Status::OK();
 }
 
@@ -645,6 +645,64 @@ TEST_F(ClientTest, TestScanPredicateNonKeyColNotProjected) {
   ASSERT_EQ(nrows, 6);
 }
 
+TEST_F(ClientTest, TestWriteOpTemplate) {
+  const auto& columns = client_table_.schema().columns();
+  auto op_template = client_table_.NewWriteOpTemplate(
+      QLWriteRequestPB::QL_STMT_INSERT, {columns[1].name(), columns[2].name(), columns[3].name()});
+  ASSERT_EQ(4U, op_template->num_bound_values());
+
+  auto session = CreateSession();
+  for (int i = 0; i != FLAGS_test_scan_num_rows; ++i) {
+    auto op = op_template->NewOp();
+    op_template->BoundValue(op.get(), 0)->set_int32_value(i);
+    op_template->BoundValue(op.get(), 1)->set_int32_value(i * 2);
+    op_template->BoundValue(op.get(), 2)->set_string_value(StringPrintf("hello %d", i));
+    op_template->BoundValue(op.get(), 3)->set_int32_value(i * 3);
+    if (i == 0) {
+      QLWriteRequestPB expected = BuildTestRow(client_table_, i)->request();
+      QLWriteRequestPB actual = op->request();
+      for (auto* req : {&expected, &actual}) {
+        req->clear_request_id();
+        req->clear_query_id();
+      }
+      ASSERT_EQ(expected.ShortDebugString(), actual.ShortDebugString());
+    }
+    ASSERT_OK(session->Apply(op));
+  }
+  FlushSessionOrDie(session);
+
+  ASSERT_EQ(FLAGS_test_scan_num_rows, CountRowsFromClient(client_table_));
+}
+
+TEST_F(ClientTest, TestParallelTableScan) {
+  ASSERT_NO_FATALS(InsertTestRows(client_table_, FLAGS_test_scan_num_rows));
+
+  TableScanOptions options;
+  options.columns = std::vector<std::string>{"key", "int_val"};
+  options.parallelism = 2;
+  options.prefetch_depth = 3;
+  options.page_size = 7;
+  options.read_ahead_pages = 2;
+  TableScanner scanner(&client_table_, options);
+
+  std::set<int32_t> keys;
+  QLRowBlock block;
+  for (;;) {
+    auto has_block = scanner.Next(&block);
+    ASSERT_OK(has_block);
+    if (!*has_block) {
+      break;
+    }
+    ASSERT_LE(block.rows().size(), options.page_size);
+    for (const auto& row : block.rows()) {
+      int32_t key = row.column(0).int32_value();
+      ASSERT_EQ(key * 2, row.column(1).int32_value());
+      ASSERT_TRUE(keys.insert(key).second) << "Duplicate key: " << key;
+    }
+  }
+  ASSERT_EQ(FLAGS_test_scan_num_rows, static_cast<int>(keys.size()));
+}
+
 TEST_F(ClientTest, TestGetTabletServerBlacklist) {
   TableHandle table;
   ASSERT_NO_FATALS(CreateTable(YBTableName("blacklist"), 3, kNumTablets, &table));
@@ -702,6 +760,8 @@ TEST_F(ClientTest, TestGetTabletServerBlacklist) {
   selections.push_back(YBClient::LEADER_ONLY);
   selections.push_back(YBClient::CLOSEST_REPLICA);
   selections.push_back(YBClient::FIRST_REPLICA);
+  selections.push_back(YBClient::LEAST_OUTSTANDING_REQUESTS);
+  selections.push_back(YBClient::POWER_OF_TWO_CHOICES);
   for (YBClient::ReplicaSelection selection : selections) {
     Status s = client_->data_->GetTabletServer(client_.get(), rt, selection,
                                                blacklist, &candidates, &rts);
@@ -721,6 +781,53 @@ TEST_F(ClientTest, TestGetTabletServerBlacklist) {
   }
 }
 
+TEST_F(ClientTest, TestLatencyAwareReplicaSelection) {
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(YBTableName("replica_selection"), 3, kNumTablets, &table));
+  InsertTestRows(table, 1, 0);
+
+  scoped_refptr<internal::RemoteTablet> rt;
+  vector<internal::RemoteTabletServer*> tservers;
+  while (true) {
+    Synchronizer sync;
+    client_->data_->meta_cache_->LookupTabletByKey(table.get(), "", MonoTime::Max(), &rt,
+                                                  sync.AsStatusCallback());
+    ASSERT_OK(sync.Wait());
+    rt->GetRemoteTabletServers(&tservers);
+    if (tservers.size() == 3) {
+      break;
+    }
+    rt->MarkStale();
+    SleepFor(MonoDelta::FromMilliseconds(10));
+  }
+
+  // The first replica is slow and busy, the last one is fast and idle.
+  const MonoDelta kLatencies[] = { 100ms, 10ms, 1ms };
+  const int kOutstanding[] = { 2, 1, 0 };
+  for (size_t i = 0; i != tservers.size(); ++i) {
+    tservers[i]->RpcStarted();
+    tservers[i]->RpcFinished(kLatencies[i]);
+    for (int j = 0; j != kOutstanding[i]; ++j) {
+      tservers[i]->RpcStarted();
+    }
+  }
+
+  vector<internal::RemoteTabletServer*> candidates;
+  ASSERT_EQ(tservers[2], client_->data_->SelectTServer(
+      rt.get(), YBClient::LEAST_OUTSTANDING_REQUESTS, {}, &candidates));
+  for (int i = 0; i != 20; ++i) {
+    // The slowest replica loses any comparison.
+    ASSERT_NE(tservers[0], client_->data_->SelectTServer(
+        rt.get(), YBClient::POWER_OF_TWO_CHOICES, {}, &candidates));
+  }
+
+  for (size_t i = 0; i != tservers.size(); ++i) {
+    for (int j = 0; j != kOutstanding[i]; ++j) {
+      tservers[i]->RpcFinished(MonoDelta());
+    }
+  }
+}
+
 TEST_F(ClientTest, TestScanWithEncodedRangePredicate) {
   TableHandle table;
   ASSERT_NO_FATALS(CreateTable(YBTableName("split-table"),
@@ -969,6 +1076,57 @@ TEST_F(ClientTest, TestMultipleMultiRowManualBatches) {
   ASSERT_EQ("{ int32:0, int32:0, string:\"hello world\", null }", rows[0]);
 }
 
+// Test that a session in AUTO_FLUSH_BACKGROUND mode sends its rows without an explicit flush,
+// batching the rows applied within the linger delay.
+TEST_F(ClientTest, TestSessionFutures) {
+  constexpr int kNumRows = 100;
+  auto session = CreateSession();
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(session->Apply(BuildTestRow(client_table_, i)));
+  }
+  auto flush_future = session->FlushFuture();
+  // Polled the same way an event loop would do it.
+  while (flush_future.wait_for(0s) != std::future_status::ready) {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_OK(flush_future.get());
+
+  auto op = client_table_.NewReadOp();
+  auto req = op->mutable_request();
+  QLAddInt32HashValue(req, kNumRows / 2);
+  client_table_.AddColumns({"int_val"}, req);
+  ASSERT_OK(session->ReadFuture(op).get());
+  ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+  auto rowblock = op->MakeRowBlock();
+  ASSERT_OK(rowblock);
+  ASSERT_EQ(1U, rowblock->row_count());
+  ASSERT_EQ(kNumRows, rowblock->rows()[0].column(0).int32_value());
+}
+
+TEST_F(ClientTest, TestAutoFlushBackground) {
+  auto session = CreateSession();
+  ASSERT_OK(session->SetFlushMode(YBSession::AUTO_FLUSH_BACKGROUND));
+
+  const int kNumRows = 100;
+  session->SetBackgroundFlushPolicy({MonoDelta::FromMilliseconds(200), kNumRows, 1024 * 1024});
+
+  for (int i = 0; i < kNumRows / 2; i++) {
+    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, i, i * 10, "hello world"));
+  }
+  ASSERT_OK(WaitFor([session]() { return session->GetFlushStats().ops == kNumRows / 2; },
+                    10s, "Background flush"));
+  ASSERT_EQ(kNumRows / 2, CountRowsFromClient(client_table_));
+  ASSERT_LE(session->GetFlushStats().rpcs, kNumTablets);
+
+  // The explicit flush waits for the rest of the rows, which don't reach the size limits.
+  for (int i = kNumRows / 2; i < kNumRows; i++) {
+    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, i, i * 10, "hello world"));
+  }
+  FlushSessionOrDie(session);
+  ASSERT_FALSE(session->HasPendingOperations());
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+}
+
 // Test a batch where one of the inserted rows succeeds and duplicates succeed too.
 TEST_F(ClientTest, TestBatchWithDuplicates) {
   auto session = CreateSession();
@@ -1370,6 +1528,26 @@ TEST_F(ClientTest, TestReplicatedMultiTabletTable) {
   // and ensure that the client handles refreshing the leader.
 }
 
+// Bounded staleness reads are served by the closest replica, which could be a follower that has
+// not applied the latest writes yet, so wait for all rows to become visible.
+TEST_F(ClientTest, TestBoundedStalenessReads) {
+  const YBTableName kReplicatedTable("replicated_bounded_staleness");
+  const int kNumRowsToWrite = 100;
+  const int kNumReplicas = 3;
+
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kReplicatedTable,
+                               kNumReplicas,
+                               kNumTablets,
+                               &table));
+  ASSERT_NO_FATALS(InsertTestRows(table, kNumRowsToWrite));
+
+  ASSERT_OK(WaitFor([&table]() {
+    return CountRowsFromClient(table, YBConsistencyLevel::BOUNDED_STALENESS,
+                               kNoBound, kNoBound) == kNumRowsToWrite;
+  }, MonoDelta::FromSeconds(30), "Read all rows with bounded staleness"));
+}
+
 TEST_F(ClientTest, TestReplicatedMultiTabletTableFailover) {
   const YBTableName kReplicatedTable("replicated_failover_on_reads");
   const int kNumRowsToWrite = 100;
@@ -1650,6 +1828,58 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+TEST_F(ClientTest, TestSharedMessenger) {
+  shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+                .add_master_server_addr(ToString(cluster_->mini_master()->bound_rpc_addr()))
+                .use_messenger(client_->messenger())
+                .Build(&client));
+  ASSERT_EQ(client_->messenger(), client->messenger());
+
+  {
+    TableHandle table;
+    ASSERT_OK(table.Open(kTableName, client.get()));
+    ASSERT_NO_FATALS(InsertTestRows(client.get(), table, FLAGS_test_scan_num_rows));
+  }
+  // The messenger is still used by the other client after this one is destroyed.
+  client.reset();
+  ASSERT_EQ(FLAGS_test_scan_num_rows, CountRowsFromClient(client_table_));
+}
+
+// Tests that concurrent lookups on a cold meta cache are all served, while sharing master lookups.
+TEST_F(ClientTest, TestConcurrentColdLookups) {
+  shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+                .add_master_server_addr(ToString(cluster_->mini_master()->bound_rpc_addr()))
+                .Build(&client));
+  TableHandle table;
+  ASSERT_OK(table.Open(kTableName, client.get()));
+  auto* meta_cache = client->data_->meta_cache_.get();
+  int initial_permits = meta_cache->master_lookup_sem_.GetValue();
+
+  constexpr int kNumLookups = 100;
+  std::vector<std::string> partition_keys;
+  std::vector<scoped_refptr<internal::RemoteTablet>> tablets(kNumLookups);
+  std::vector<std::unique_ptr<Synchronizer>> syncs;
+  for (int i = 0; i != kNumLookups; ++i) {
+    partition_keys.push_back(PartitionSchema::EncodeMultiColumnHashValue(i * 655));
+    syncs.push_back(std::make_unique<Synchronizer>());
+  }
+  for (int i = 0; i != kNumLookups; ++i) {
+    meta_cache->LookupTabletByKey(table.get(), partition_keys[i], MonoTime::Now() + 30s,
+                                  &tablets[i], syncs[i]->AsStatusCallback());
+  }
+  for (int i = 0; i != kNumLookups; ++i) {
+    ASSERT_OK(syncs[i]->Wait());
+    ASSERT_TRUE(tablets[i]->partition().ContainsKey(partition_keys[i]))
+        << i << ": " << tablets[i]->tablet_id();
+  }
+
+  ASSERT_EQ(initial_permits, meta_cache->master_lookup_sem_.GetValue());
+  std::lock_guard<std::mutex> lock(meta_cache->in_flight_lookups_mutex_);
+  ASSERT_TRUE(meta_cache->in_flight_lookups_.empty());
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 
@@ -65,6 +65,7 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
 #include "yb/rpc/messenger.h"
+#include "yb/util/async_util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/init.h"
 #include "yb/util/logging.h"
@@ -265,6 +266,11 @@ YBClientBuilder& YBClientBuilder::set_client_name(const std::string& name) {
   return *this;
 }
 
+YBClientBuilder& YBClientBuilder::use_messenger(const std::shared_ptr<rpc::Messenger>& messenger) {
+  data_->messenger_ = messenger;
+  return *this;
+}
+
 YBClientBuilder& YBClientBuilder::set_tserver_uuid(const TabletServerId& uuid) {
   data_->uuid_ = uuid;
   return *this;
@@ -281,10 +287,14 @@ Status YBClientBuilder::Build(shared_ptr<YBClient>* client) {
   shared_ptr<YBClient> c(new YBClient());
 
   // Init messenger.
-  MessengerBuilder builder(data_->client_name_);
-  builder.set_num_reactors(data_->num_reactors_);
-  builder.set_metric_entity(data_->metric_entity_);
-  RETURN_NOT_OK(builder.Build().MoveTo(&c->data_->messenger_));
+  if (data_->messenger_) {
+    c->data_->messenger_ = data_->messenger_;
+  } else {
+    MessengerBuilder builder(data_->client_name_);
+    builder.set_num_reactors(data_->num_reactors_);
+    builder.set_metric_entity(data_->metric_entity_);
+    RETURN_NOT_OK(builder.Build().MoveTo(&c->data_->messenger_));
+  }
 
   c->data_->master_server_endpoint_ = data_->master_server_endpoint_;
   c->data_->master_server_addrs_ = data_->master_server_addrs_;
@@ -1418,6 +1428,14 @@ Status YBSession::SetFlushMode(FlushMode m) {
   return data_->SetFlushMode(m);
 }
 
+void YBSession::SetBackgroundFlushPolicy(const BackgroundFlushPolicy& policy) {
+  data_->SetBackgroundFlushPolicy(policy);
+}
+
+YBSession::FlushStats YBSession::GetFlushStats() const {
+  return data_->GetFlushStats();
+}
+
 void YBSession::SetTimeout(MonoDelta timeout) {
   data_->SetTimeout(timeout);
 }
@@ -1430,6 +1448,10 @@ void YBSession::FlushAsync(boost::function<void(const Status&)> callback) {
   data_->FlushAsync(std::move(callback));
 }
 
+std::future<Status> YBSession::FlushFuture() {
+  return MakeFuture<Status>([this](auto callback) { FlushAsync(std::move(callback)); });
+}
+
 bool YBSession::HasPendingOperations() const {
   return data_->HasPendingOperations();
 }
@@ -1447,6 +1469,12 @@ void YBSession::ReadAsync(std::shared_ptr<YBOperation> yb_op,
   FlushAsync(std::move(callback));
 }
 
+std::future<Status> YBSession::ReadFuture(std::shared_ptr<YBOperation> yb_op) {
+  return MakeFuture<Status>([this, &yb_op](auto callback) {
+    ReadAsync(std::move(yb_op), std::move(callback));
+  });
+}
+
 Status YBSession::Apply(std::shared_ptr<YBOperation> yb_op) {
   return data_->Apply(std::move(yb_op));
 }
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -201,6 +202,12 @@ class YBClientBuilder {
   // Sets client name to be used for naming the client's messenger/reactors.
   YBClientBuilder& set_client_name(const std::string& name);
 
+  // Use the messenger of another client instead of building a new one, so clients of the same
+  // process share reactor threads and connections to the servers. Tablet server proxies of
+  // different clients then also share connections. num_reactors, metric_entity and client_name
+  // are ignored for messenger creation in this case.
+  YBClientBuilder& use_messenger(const std::shared_ptr<rpc::Messenger>& messenger);
+
   // Sets skip master leader resolution.
   // Used in tests, when we do not have real master.
   YBClientBuilder& set_skip_master_leader_resolution(bool value);
@@ -410,7 +417,15 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
     CLOSEST_REPLICA,
 
     // Select the first replica in the list.
-    FIRST_REPLICA
+    FIRST_REPLICA,
+
+    // Select the replica with the fewest requests outstanding from this client, preferring the
+    // one with the lower latency on ties.
+    LEAST_OUTSTANDING_REQUESTS,
+
+    // Compare two random replicas and select the one with the lower expected latency, i.e. its
+    // average latency scaled by its outstanding requests.
+    POWER_OF_TWO_CHOICES
   };
 
   bool IsMultiMaster() const;
@@ -474,7 +489,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   friend class internal::TabletInvoker;
   friend class PlacementInfoTest;
 
+  FRIEND_TEST(ClientTest, TestConcurrentColdLookups);
   FRIEND_TEST(ClientTest, TestGetTabletServerBlacklist);
+  FRIEND_TEST(ClientTest, TestLatencyAwareReplicaSelection);
   FRIEND_TEST(ClientTest, TestMasterDown);
   FRIEND_TEST(ClientTest, TestMasterLookupPermits);
   FRIEND_TEST(ClientTest, TestReplicatedMultiTabletTableFailover);
@@ -886,10 +903,10 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
     // to retrieve them.
     // TODO: provide an API for the user to specify a callback to do their own
     // error reporting.
-    // TODO: specify which threads the background activity runs on (probably the
-    // messenger IO threads?)
     //
-    // NOTE: This is not implemented yet, see KUDU-456.
+    // Applied operations linger in the session so that more of them are sent in a single RPC
+    // to each tablet, see BackgroundFlushPolicy. Flushes triggered by the linger delay run on
+    // the messenger reactor threads.
     //
     // The Flush() call can be used to block until the buffer is empty.
     AUTO_FLUSH_BACKGROUND,
@@ -919,6 +936,31 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   //   if the buffer space is exhausted, then write calls will return an error.
   CHECKED_STATUS SetMutationBufferSpace(size_t size) WARN_UNUSED_RESULT;
 
+  // Controls when the operations applied in AUTO_FLUSH_BACKGROUND mode are sent. Buffered
+  // operations are flushed as soon as any of the limits is reached.
+  struct BackgroundFlushPolicy {
+    // How long the first buffered operation may wait for others to join its batch.
+    MonoDelta max_delay;
+    // Number of buffered operations for a single tablet that is worth an RPC of its own.
+    int target_ops_per_tablet;
+    // Total size of the requests of the buffered operations.
+    size_t max_bytes;
+  };
+
+  // Set the background flush policy. The default one is configured by the
+  // client_background_flush_* flags.
+  void SetBackgroundFlushPolicy(const BackgroundFlushPolicy& policy);
+
+  // Number of tablet RPCs sent by this session and of operations sent in them, for telling how
+  // well the operations of the session are batched.
+  struct FlushStats {
+    int64_t rpcs = 0;
+    int64_t ops = 0;
+  };
+
+  // Returns the stats of the batches that have finished so far.
+  FlushStats GetFlushStats() const;
+
   // Set the timeout for writes made in this session.
   void SetTimeout(MonoDelta timeout);
 
@@ -926,6 +968,9 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   void ReadAsync(std::shared_ptr<YBOperation> yb_op, boost::function<void(const Status&)> callback);
 
+  // Utility function for ReadAsync.
+  std::future<Status> ReadFuture(std::shared_ptr<YBOperation> yb_op);
+
   // TODO: add "doAs" ability here for proxy servers to be able to act on behalf of
   // other users, assuming access rights.
 
@@ -980,6 +1025,10 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   CHECKED_STATUS Flush() WARN_UNUSED_RESULT;
   void FlushAsync(boost::function<void(const Status&)> callback);
 
+  // Utility function for FlushAsync. The future becomes ready when the callback would be called,
+  // so an event loop could poll it with wait_for(0s) instead of dedicating a thread to Flush.
+  std::future<Status> FlushFuture();
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
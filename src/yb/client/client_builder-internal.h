@@ -76,6 +76,9 @@ class YBClientBuilder::Data {
   TabletServerId uuid_;
 
   bool skip_master_leader_resolution_ = false;
+
+  // Messenger shared with other clients, a new one is built when it is not set.
+  std::shared_ptr<rpc::Messenger> messenger_;
  private:
   DISALLOW_COPY_AND_ASSIGN(Data);
 };
@@ -30,9 +30,11 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
+#include <boost/optional.hpp>
 #include <glog/logging.h>
 
 #include "yb/client/meta_cache.h"
@@ -49,9 +51,17 @@
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
 
+DEFINE_int32(client_table_locations_prefetch_max_tablets, 4096,
+             "The first master lookup for a table fetches the locations of up to this many of its "
+             "tablets from the start of the table, so that a cold cache is filled by a single "
+             "lookup for most tables. 0 disables it.");
+TAG_FLAG(client_table_locations_prefetch_max_tablets, advanced);
+TAG_FLAG(client_table_locations_prefetch_max_tablets, runtime);
+
 using std::string;
 using std::map;
 using std::shared_ptr;
@@ -165,6 +175,24 @@ const CloudInfoPB& RemoteTabletServer::cloud_info() const {
   return cloud_info_pb_;
 }
 
+void RemoteTabletServer::RpcStarted() {
+  outstanding_rpcs_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void RemoteTabletServer::RpcFinished(MonoDelta latency) {
+  outstanding_rpcs_.fetch_sub(1, std::memory_order_acq_rel);
+  if (!latency.Initialized()) {
+    return;
+  }
+  // Each sample has a weight of 1/8, so a slow server is noticed after a few RPCs.
+  const int64_t sample = latency.ToMicroseconds();
+  int64_t old_ewma = latency_ewma_us_.load(std::memory_order_acquire);
+  int64_t new_ewma;
+  do {
+    new_ewma = old_ewma == 0 ? sample : old_ewma + (sample - old_ewma) / 8;
+  } while (!latency_ewma_us_.compare_exchange_weak(old_ewma, new_ewma));
+}
+
 shared_ptr<TabletServerServiceProxy> RemoteTabletServer::proxy() const {
   std::lock_guard<simple_spinlock> l(lock_);
   CHECK(proxy_);
@@ -203,17 +231,15 @@ void RemoteTablet::Refresh(const TabletServerMap& tservers,
     rep.failed = false;
     replicas_.push_back(rep);
   }
-  stale_ = false;
+  stale_.store(false, std::memory_order_release);
 }
 
 void RemoteTablet::MarkStale() {
-  std::lock_guard<simple_spinlock> l(lock_);
-  stale_ = true;
+  stale_.store(true, std::memory_order_release);
 }
 
 bool RemoteTablet::stale() const {
-  std::lock_guard<simple_spinlock> l(lock_);
-  return stale_;
+  return stale_.load(std::memory_order_acquire);
 }
 
 bool RemoteTablet::MarkReplicaFailed(RemoteTabletServer *ts,
@@ -389,6 +415,13 @@ class LookupRpc : public Rpc {
   virtual RemoteTabletPtr FastLookup() = 0;
   virtual void DoSendRpc() = 0;
 
+  // Returns true when the lookup was parked until an in-flight lookup that would also satisfy it
+  // finishes, it is sent again after that.
+  virtual bool WaitForInFlightLookup() { return false; }
+
+  // Invoked after the user callback, when the lookup will not be retried anymore.
+  virtual void LookupFinished() {}
+
   void NewLeaderMasterDeterminedCb(const Status& status);
 
   // Pointer back to the tablet cache. Populated with location information
@@ -447,6 +480,16 @@ void LookupRpc::SendRpc() {
 
   meta_cache_->rpcs_.Register(shared_from_this(), &retained_self_);
 
+  // Only a registered lookup is kept alive while it waits.
+  if (retained_self_ != meta_cache_->rpcs_.InvalidHandle() && WaitForInFlightLookup()) {
+    VLOG(3) << "Waiting for in-flight master lookup: " << ToString();
+    if (has_permit_) {
+      meta_cache_->ReleaseMasterLookupPermit();
+      has_permit_ = false;
+    }
+    return;
+  }
+
   // Slow path: must lookup the tablet in the master.
   VLOG(3) << "Fast lookup: no known tablet for " << ToString()
           << ": refreshing our metadata from the Master";
@@ -558,6 +601,7 @@ void LookupRpc::DoFinished(const Status& status,
     LOG(WARNING) << new_status.ToString();
     Notify(new_status);
   }
+  LookupFinished();
 }
 
 RemoteTabletPtr MetaCache::ProcessTabletLocations(
@@ -566,6 +610,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
   RemoteTabletPtr result;
   bool first = true;
+  std::vector<std::string> updated_table_ids;
 
   std::lock_guard<rw_spinlock> l(lock_);
   for (const TabletLocationsPB& loc : locations) {
@@ -593,6 +638,9 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
       CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
       CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+      if (updated_table_ids.empty() || updated_table_ids.back() != loc.table_id()) {
+        updated_table_ids.push_back(loc.table_id());
+      }
     }
     remote->Refresh(ts_cache_, loc.replicas());
 
@@ -602,10 +650,81 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
     }
   }
 
+  if (!updated_table_ids.empty()) {
+    UpdateTablePartitions(updated_table_ids);
+  }
+
   CHECK_NOTNULL(result.get());
   return result;
 }
 
+void MetaCache::UpdateTablePartitions(const std::vector<std::string>& table_ids) {
+  DCHECK(lock_.is_write_locked());
+
+  auto old_partitions = std::atomic_load_explicit(&table_partitions_, std::memory_order_acquire);
+  auto new_partitions = old_partitions ? std::make_shared<TablePartitionsMap>(*old_partitions)
+                                       : std::make_shared<TablePartitionsMap>();
+  for (const auto& table_id : table_ids) {
+    auto table_partitions = std::make_shared<TablePartitions>();
+    const TabletMap& tablets_by_key = tablets_by_table_and_key_[table_id];
+    table_partitions->tablets.reserve(tablets_by_key.size());
+    bool hash_partitioned = true;
+    for (const auto& entry : tablets_by_key) {
+      table_partitions->tablets.push_back(entry.second);
+      hash_partitioned = hash_partitioned &&
+          (entry.first.empty() || entry.first.size() == PartitionSchema::kPartitionKeySize);
+    }
+    if (hash_partitioned) {
+      table_partitions->hash_partition_starts.reserve(tablets_by_key.size());
+      for (const auto& entry : tablets_by_key) {
+        table_partitions->hash_partition_starts.push_back(
+            entry.first.empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(entry.first));
+      }
+      table_partitions->BuildHashBucketBounds();
+    }
+    (*new_partitions)[table_id] = std::move(table_partitions);
+  }
+  std::atomic_store_explicit(
+      &table_partitions_, std::shared_ptr<const TablePartitionsMap>(std::move(new_partitions)),
+      std::memory_order_release);
+}
+
+void MetaCache::TablePartitions::BuildHashBucketBounds() {
+  constexpr size_t kNumBuckets = 1 << 8;
+  hash_bucket_bounds.resize(kNumBuckets + 1);
+  auto it = hash_partition_starts.begin();
+  for (size_t bucket = 0; bucket != kNumBuckets; ++bucket) {
+    it = std::upper_bound(it, hash_partition_starts.end(), bucket << 8);
+    hash_bucket_bounds[bucket] = it - hash_partition_starts.begin();
+  }
+  hash_bucket_bounds[kNumBuckets] = hash_partition_starts.size();
+}
+
+RemoteTabletPtr MetaCache::TablePartitions::Find(const std::string& partition_key) const {
+  size_t index;
+  if (!hash_partition_starts.empty() &&
+      (partition_key.empty() || partition_key.size() == PartitionSchema::kPartitionKeySize)) {
+    const uint16_t hash_code =
+        partition_key.empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+    const size_t bucket = hash_code >> 8;
+    const auto begin = hash_partition_starts.begin();
+    index = std::upper_bound(
+        begin + hash_bucket_bounds[bucket], begin + hash_bucket_bounds[bucket + 1], hash_code) -
+        begin;
+  } else {
+    index = std::upper_bound(
+        tablets.begin(), tablets.end(), partition_key,
+        [](const std::string& key, const RemoteTabletPtr& tablet) {
+          return key < tablet->partition().partition_key_start();
+        }) - tablets.begin();
+  }
+  if (PREDICT_FALSE(index == 0)) {
+    // No tablets with a start partition key lower than 'partition_key'.
+    return nullptr;
+  }
+  return tablets[index - 1];
+}
+
 class LookupByIdRpc : public LookupRpc {
  public:
   LookupByIdRpc(const scoped_refptr<MetaCache>& meta_cache,
@@ -681,8 +800,13 @@ class LookupByKeyRpc : public LookupRpc {
 
   void DoSendRpc() override {
     // Fill out the request.
+    req_.Clear();
     req_.mutable_table()->set_table_id(table_->id());
-    req_.set_partition_key_start(partition_key_);
+    if (full_table_) {
+      req_.set_max_returned_locations(FLAGS_client_table_locations_prefetch_max_tablets);
+    } else {
+      req_.set_partition_key_start(partition_key_);
+    }
 
     // The end partition key is left unset intentionally so that we'll prefetch
     // some additional tablets.
@@ -692,12 +816,61 @@ class LookupByKeyRpc : public LookupRpc {
   }
 
  private:
+  bool WaitForInFlightLookup() override {
+    if (in_flight_key_) {
+      // Already the in-flight lookup for its key, i.e. this is a retry.
+      return false;
+    }
+    // Concurrent lookups of a table that is not cached yet all wait for the same full table
+    // lookup, the ones of a cached table only wait for lookups of the same key.
+    const auto max_tablets = FLAGS_client_table_locations_prefetch_max_tablets;
+    full_table_ = max_tablets > 0 && !meta_cache()->IsTableCached(table_->id());
+    MetaCache::InFlightLookupKey key(table_->id(), full_table_ ? std::string() : partition_key_);
+    if (meta_cache()->JoinInFlightLookup(key, [this] { SendRpc(); })) {
+      return true;
+    }
+    in_flight_key_ = std::move(key);
+    return false;
+  }
+
+  void LookupFinished() override {
+    if (in_flight_key_) {
+      meta_cache()->FinishInFlightLookup(*in_flight_key_);
+      in_flight_key_ = boost::none;
+    }
+  }
+
   void Finished(const Status& status) override {
+    if (full_table_ && retrier().controller().status().ok() && !resp_.has_error() &&
+        resp_.tablet_locations_size() != 0) {
+      meta_cache()->ProcessTabletLocations(resp_.tablet_locations());
+      full_table_result_ = FastLookup();
+      if (!full_table_result_) {
+        // The table has more tablets than were fetched, look up the tablet of the key itself.
+        VLOG(2) << ToString() << ": key is not covered by the prefetched tablets";
+        full_table_ = false;
+        mutable_retrier()->mutable_controller()->Reset();
+        SendRpc();
+        return;
+      }
+    }
     DoFinished(status, resp_, [this] {
+      if (full_table_result_) {
+        return full_table_result_;
+      }
       return meta_cache()->ProcessTabletLocations(resp_.tablet_locations());
     });
   }
 
+  // Whether locations are requested from the start of the table, instead of partition_key_.
+  bool full_table_ = false;
+
+  // The tablet of partition_key_, when it was found among the tablets of a full table lookup.
+  RemoteTabletPtr full_table_result_;
+
+  // Set when this is the in-flight lookup that the lookups with same key wait for.
+  boost::optional<MetaCache::InFlightLookupKey> in_flight_key_;
+
   // Table to lookup.
   const YBTable* table_;
 
@@ -713,28 +886,32 @@ class LookupByKeyRpc : public LookupRpc {
 
 RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
                                                      const string& partition_key) {
-  shared_lock<rw_spinlock> l(lock_);
-  const TabletMap* tablets = FindOrNull(tablets_by_table_and_key_, table->id());
-  if (PREDICT_FALSE(!tablets)) {
+  auto table_partitions = std::atomic_load_explicit(
+      &table_partitions_, std::memory_order_acquire);
+  if (PREDICT_FALSE(!table_partitions)) {
+    return nullptr;
+  }
+  auto it = table_partitions->find(table->id());
+  if (PREDICT_FALSE(it == table_partitions->end())) {
     // No cache available for this table.
     return nullptr;
   }
 
-  const scoped_refptr<RemoteTablet>* r = FindFloorOrNull(*tablets, partition_key);
+  // The snapshot keeps the tablets alive while they are searched.
+  const RemoteTabletPtr& r = it->second->Find(partition_key);
   if (PREDICT_FALSE(!r)) {
-    // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
 
   // Stale entries must be re-fetched.
-  if ((*r)->stale()) {
+  if (r->stale()) {
     return nullptr;
   }
 
-  if ((*r)->partition().partition_key_end().compare(partition_key) > 0 ||
-      (*r)->partition().partition_key_end().empty()) {
+  if (r->partition().partition_key_end().compare(partition_key) > 0 ||
+      r->partition().partition_key_end().empty()) {
     // partition_key < partition.end OR tablet doesn't end.
-    return *r;
+    return r;
   }
 
   return nullptr;
@@ -790,6 +967,41 @@ void MetaCache::MarkTSFailed(RemoteTabletServer* ts,
   }
 }
 
+bool MetaCache::IsTableCached(const std::string& table_id) {
+  auto table_partitions = std::atomic_load_explicit(
+      &table_partitions_, std::memory_order_acquire);
+  return table_partitions && table_partitions->count(table_id) != 0;
+}
+
+bool MetaCache::JoinInFlightLookup(const InFlightLookupKey& key, std::function<void()> waiter) {
+  std::lock_guard<std::mutex> lock(in_flight_lookups_mutex_);
+  auto it = in_flight_lookups_.find(key);
+  if (it == in_flight_lookups_.end()) {
+    in_flight_lookups_.emplace(key, std::vector<std::function<void()>>());
+    return false;
+  }
+  it->second.push_back(std::move(waiter));
+  return true;
+}
+
+void MetaCache::FinishInFlightLookup(const InFlightLookupKey& key) {
+  std::vector<std::function<void()>> waiters;
+  {
+    std::lock_guard<std::mutex> lock(in_flight_lookups_mutex_);
+    auto it = in_flight_lookups_.find(key);
+    if (it == in_flight_lookups_.end()) {
+      LOG(DFATAL) << "No in-flight lookup for " << key.first;
+      return;
+    }
+    waiters.swap(it->second);
+    in_flight_lookups_.erase(it);
+  }
+  // Most waiters are served from the cache now, the others send their own lookups.
+  for (auto& waiter : waiters) {
+    waiter();
+  }
+}
+
 bool MetaCache::AcquireMasterLookupPermit() {
   return master_lookup_sem_.TryAcquire();
 }
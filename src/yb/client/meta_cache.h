@@ -33,7 +33,10 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -76,6 +79,7 @@ class TSInfoPB;
 
 namespace client {
 
+class ClientTest_TestConcurrentColdLookups_Test;
 class ClientTest_TestMasterLookupPermits_Test;
 class YBClient;
 class YBTable;
@@ -117,6 +121,21 @@ class RemoteTabletServer {
 
   const CloudInfoPB& cloud_info() const;
 
+  // Track the RPCs sent by this client to the tablet server, so that reads could prefer the
+  // replicas that respond faster. 'latency' is not recorded when it is not initialized.
+  void RpcStarted();
+  void RpcFinished(MonoDelta latency);
+
+  // Number of RPCs sent to this tablet server that have not finished yet.
+  int outstanding_rpcs() const {
+    return outstanding_rpcs_.load(std::memory_order_acquire);
+  }
+
+  // Exponentially weighted moving average of RPC latency, 0 before the first RPC finishes.
+  int64_t latency_ewma_us() const {
+    return latency_ewma_us_.load(std::memory_order_acquire);
+  }
+
  private:
   // Internal callback for DNS resolution.
   void DnsResolutionFinished(const HostPort& hp,
@@ -132,6 +151,9 @@ class RemoteTabletServer {
   yb::CloudInfoPB cloud_info_pb_;
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
 
+  std::atomic<int> outstanding_rpcs_{0};
+  std::atomic<int64_t> latency_ewma_us_{0};
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTabletServer);
 };
 
@@ -219,9 +241,10 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   const std::string tablet_id_;
   const Partition partition_;
 
-  // All non-const members are protected by 'lock_'.
+  // All non-const members except stale_ are protected by 'lock_'.
   mutable simple_spinlock lock_;
-  bool stale_;
+  // Checked on every lookup of the tablet, so it is read without lock_.
+  std::atomic<bool> stale_;
   std::vector<RemoteReplica> replicas_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
@@ -280,6 +303,7 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   friend class LookupByKeyRpc;
   friend class LookupByIdRpc;
 
+  FRIEND_TEST(client::ClientTest, TestConcurrentColdLookups);
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
 
   // Called on the slow LookupTablet path when the master responds. Populates
@@ -294,6 +318,9 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   RemoteTabletPtr LookupTabletByIdFastPath(const std::string& tablet_id);
 
+  // Whether locations of any tablet of the table were cached.
+  bool IsTableCached(const std::string& table_id);
+
   // Update our information about the given tablet server.
   //
   // This is called when we get some response from the master which contains
@@ -321,6 +348,35 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   typedef std::map<std::string, RemoteTabletPtr> TabletMap;
   std::unordered_map<std::string, TabletMap> tablets_by_table_and_key_;
 
+  // Immutable copy of the tablets of a table from tablets_by_table_and_key_, sorted by start
+  // partition key, that is searched without taking lock_.
+  struct TablePartitions {
+    std::vector<RemoteTabletPtr> tablets;
+    // Start partition keys of the tablets when all of them are hash partitions, i.e. their start
+    // keys are empty or 2-byte hash codes. A contiguous array of integers is cheaper to search
+    // than the strings.
+    std::vector<uint16_t> hash_partition_starts;
+    // For each value of the high byte of a hash code, the number of hash_partition_starts not
+    // greater than the lowest hash code with that byte. Narrows the search for the tablet of a
+    // hash code down to the starts within one such range, usually none or one.
+    std::vector<uint32_t> hash_bucket_bounds;
+
+    void BuildHashBucketBounds();
+    RemoteTabletPtr Find(const std::string& partition_key) const;
+  };
+  typedef std::unordered_map<std::string, std::shared_ptr<const TablePartitions>>
+      TablePartitionsMap;
+
+  // Rebuilds the partitions of the given tables in table_partitions_.
+  //
+  // NOTE: Must be called with lock_ held for writing.
+  void UpdateTablePartitions(const std::vector<std::string>& table_ids);
+
+  // Snapshot of the partitions of all cached tables, replaced as a whole on every update, so the
+  // routing of operations only does an atomic load of the pointer. Accessed with std::atomic_load
+  // and std::atomic_store.
+  std::shared_ptr<const TablePartitionsMap> table_partitions_;
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
@@ -330,6 +386,19 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // permits have been acquired.
   Semaphore master_lookup_sem_;
 
+  // Identifies a master lookup by table ID and start partition key of the request.
+  typedef std::pair<std::string, std::string> InFlightLookupKey;
+
+  // If a master lookup with the same key is in flight, adds waiter to be invoked once it has
+  // finished and returns true. Otherwise the caller becomes the in-flight lookup for the key and
+  // should call FinishInFlightLookup when it finishes.
+  bool JoinInFlightLookup(const InFlightLookupKey& key, std::function<void()> waiter);
+  void FinishInFlightLookup(const InFlightLookupKey& key);
+
+  std::mutex in_flight_lookups_mutex_;
+  // Waiters of in-flight master lookups.
+  std::map<InFlightLookupKey, std::vector<std::function<void()>>> in_flight_lookups_;
+
   rpc::Rpcs rpcs_;
 
   DISALLOW_COPY_AND_ASSIGN(MetaCache);
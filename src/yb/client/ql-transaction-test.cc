@@ -52,6 +52,7 @@ DECLARE_uint64(max_clock_skew_usec);
 DECLARE_bool(transaction_allow_rerequest_status_in_tests);
 DECLARE_bool(use_test_clock);
 DECLARE_uint64(transaction_delay_status_reply_usec_in_tests);
+DECLARE_int32(txn_max_apply_batch_records);
 
 namespace yb {
 namespace client {
@@ -524,6 +525,40 @@ TEST_F(QLTransactionTest, InsertUpdate) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, ApplyInSeveralBatches) {
+  google::FlagSaver flag_saver;
+
+  // Applying a transaction takes more than 3 records per tablet, so each apply is split.
+  FLAGS_txn_max_apply_batch_records = 3;
+  WriteData(); // Add data
+  WriteData(WriteOpType::UPDATE); // Update data
+  VerifyData(1, WriteOpType::UPDATE);
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyData(1, WriteOpType::UPDATE);
+}
+
+TEST_F(QLTransactionTest, ReadYourWrites) {
+  auto txn = CreateTransaction();
+  auto session = CreateSession(txn);
+  WriteRows(session);
+  for (size_t r = 0; r != kNumRows; ++r) {
+    VERIFY_ROW(session, KeyForTransactionAndIndex(0, r), ValueForTransactionAndIndex(0, r));
+  }
+  ASSERT_EQ(kNumRows, txn->TEST_CountReadsServedFromWrites());
+
+  // Read of the key that was not written by transaction should go to tablet server.
+  auto row = SelectRow(session, KeyForTransactionAndIndex(1, 0));
+  ASSERT_TRUE(!row.ok() && row.status().IsNotFound()) << row;
+  ASSERT_EQ(kNumRows, txn->TEST_CountReadsServedFromWrites());
+
+  ASSERT_OK(UpdateRow(session, KeyForTransactionAndIndex(0, 0), -1));
+  VERIFY_ROW(session, KeyForTransactionAndIndex(0, 0), -1);
+  ASSERT_EQ(kNumRows + 1, txn->TEST_CountReadsServedFromWrites());
+
+  ASSERT_OK(txn->CommitFuture().get());
+  VERIFY_ROW(CreateSession(), KeyForTransactionAndIndex(0, 0), -1);
+}
+
 TEST_F(QLTransactionTest, Cleanup) {
   WriteData();
   VerifyData();
@@ -941,28 +976,30 @@ struct TransactionState {
     auto resp = status_future.get();
     ASSERT_OK(resp);
 
-    if (resp->status() == TransactionStatus::ABORTED) {
+    ASSERT_EQ(1, resp->status_size());
+    ASSERT_EQ(1, resp->status_hybrid_time_size());
+    if (resp->status(0) == TransactionStatus::ABORTED) {
       ASSERT_TRUE(commit_future.valid());
       transaction = nullptr;
       return;
     }
 
-    auto new_time = HybridTime(resp->status_hybrid_time());
+    auto new_time = HybridTime(resp->status_hybrid_time(0));
     if (last_status == TransactionStatus::PENDING) {
-      if (resp->status() == TransactionStatus::PENDING) {
+      if (resp->status(0) == TransactionStatus::PENDING) {
         ASSERT_GE(new_time, status_time);
       } else {
-        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status());
+        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status(0));
         ASSERT_GT(new_time, status_time);
       }
     } else {
       ASSERT_EQ(last_status, TransactionStatus::COMMITTED);
-      ASSERT_EQ(resp->status(), TransactionStatus::COMMITTED)
-          << "Bad transaction status: " << TransactionStatus_Name(resp->status());
+      ASSERT_EQ(resp->status(0), TransactionStatus::COMMITTED)
+          << "Bad transaction status: " << TransactionStatus_Name(resp->status(0));
       ASSERT_EQ(status_time, new_time);
     }
     status_time = new_time;
-    last_status = resp->status();
+    last_status = resp->status(0);
   }
 };
 
@@ -1024,7 +1061,7 @@ TEST_F(QLTransactionTest, StatusEvolution) {
       }
       tserver::GetTransactionStatusRequestPB req;
       req.set_tablet_id(state.metadata.status_tablet);
-      req.set_transaction_id(state.metadata.transaction_id.data,
+      req.add_transaction_id(state.metadata.transaction_id.data,
                              state.metadata.transaction_id.size());
       state.status_future = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
           GetTransactionStatus, &rpcs)(
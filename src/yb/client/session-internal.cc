@@ -38,8 +38,28 @@
 #include "yb/client/batcher.h"
 #include "yb/client/callbacks.h"
 #include "yb/client/error_collector.h"
+#include "yb/client/transaction.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/rpc/messenger.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(client_background_flush_max_delay_ms, 5,
+             "How long the first operation applied to a session in AUTO_FLUSH_BACKGROUND mode "
+             "may wait for other operations to be batched with it.");
+TAG_FLAG(client_background_flush_max_delay_ms, advanced);
+
+DEFINE_int32(client_background_flush_target_ops_per_tablet, 100,
+             "A session in AUTO_FLUSH_BACKGROUND mode flushes its operations as soon as this "
+             "many of them are buffered for a single tablet.");
+TAG_FLAG(client_background_flush_target_ops_per_tablet, advanced);
+
+DEFINE_int64(client_background_flush_max_bytes, 1024 * 1024,
+             "A session in AUTO_FLUSH_BACKGROUND mode flushes its operations as soon as their "
+             "requests take this many bytes.");
+TAG_FLAG(client_background_flush_max_bytes, advanced);
+
 MAKE_ENUM_LIMITS(yb::client::YBSession::FlushMode,
                  yb::client::YBSession::AUTO_FLUSH_SYNC,
                  yb::client::YBSession::MANUAL_FLUSH);
@@ -58,7 +78,11 @@ YBSessionData::YBSessionData(shared_ptr<YBClient> client,
                              const YBTransactionPtr& transaction)
     : client_(std::move(client)),
       transaction_(transaction),
-      error_collector_(new ErrorCollector()) {
+      error_collector_(new ErrorCollector()),
+      background_flush_policy_{
+          MonoDelta::FromMilliseconds(FLAGS_client_background_flush_max_delay_ms),
+          FLAGS_client_background_flush_target_ops_per_tablet,
+          static_cast<size_t>(FLAGS_client_background_flush_max_bytes)} {
   const auto metric_entity = client_->messenger()->metric_entity();
   async_rpc_metrics_ = metric_entity ? std::make_shared<AsyncRpcMetrics>(metric_entity) : nullptr;
 }
@@ -69,7 +93,10 @@ YBSessionData::~YBSessionData() {
 void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
   transaction_ = std::move(transaction);
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
+  {
+    std::lock_guard<std::mutex> l(batcher_mutex_);
+    old_batcher.swap(batcher_);
+  }
   if (old_batcher) {
     LOG_IF(DFATAL, old_batcher->HasPendingOperations()) << "SetTransaction with non empty batcher";
     old_batcher->Abort(STATUS(Aborted, "Transaction changed"));
@@ -79,9 +106,12 @@ void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
 void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
   std::lock_guard<simple_spinlock> l(lock_);
   CHECK_EQ(flushed_batchers_.erase(batcher), 1);
+  flush_stats_.rpcs += batcher->num_rpcs_sent();
+  flush_stats_.ops += batcher->num_ops_sent();
 }
 
 void YBSessionData::Abort() {
+  std::lock_guard<std::mutex> l(batcher_mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     batcher_->Abort(STATUS(Aborted, "Batch aborted"));
     batcher_.reset();
@@ -89,6 +119,7 @@ void YBSessionData::Abort() {
 }
 
 Status YBSessionData::Close(bool force) {
+  std::lock_guard<std::mutex> l(batcher_mutex_);
   if (batcher_) {
     if (batcher_->HasPendingOperations() && !force) {
       return STATUS(IllegalState, "Could not close. There are pending operations.");
@@ -100,8 +131,6 @@ Status YBSessionData::Close(bool force) {
 }
 
 void YBSessionData::FlushAsync(boost::function<void(const Status&)> callback) {
-  CHECK_NE(flush_mode_, YBSession::AUTO_FLUSH_BACKGROUND) << "TODO: handle flush background mode";
-
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
   //
@@ -110,19 +139,112 @@ void YBSessionData::FlushAsync(boost::function<void(const Status&)> callback) {
   // the batch fails "inline" on the same thread.
 
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
-  if (old_batcher) {
+  {
+    std::lock_guard<std::mutex> l(batcher_mutex_);
+    old_batcher.swap(batcher_);
+  }
+
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    // The callback waits for all the ops applied so far, including those flushed in the
+    // background.
+    if (old_batcher) {
+      FlushInBackground(std::move(old_batcher), allow_local_calls_in_curr_thread_);
+    }
+    Status status;
     {
       std::lock_guard<simple_spinlock> l(lock_);
-      flushed_batchers_.insert(old_batcher);
+      if (background_flushes_in_flight_ != 0) {
+        background_flush_waiters_.push_back(std::move(callback));
+        return;
+      }
+      status = std::move(background_flush_status_);
+      background_flush_status_ = Status::OK();
     }
-    old_batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
-    old_batcher->FlushAsync(std::move(callback));
+    callback(status);
+    return;
+  }
+
+  if (old_batcher) {
+    StartFlush(
+        std::move(old_batcher), allow_local_calls_in_curr_thread_, std::move(callback));
   } else {
     callback(Status::OK());
   }
 }
 
+void YBSessionData::StartFlush(internal::BatcherPtr batcher,
+                               bool allow_local_calls_in_curr_thread,
+                               boost::function<void(const Status&)> callback) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    flushed_batchers_.insert(batcher);
+  }
+  batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread);
+  batcher->FlushAsync(std::move(callback));
+}
+
+void YBSessionData::FlushInBackground(internal::BatcherPtr batcher,
+                                      bool allow_local_calls_in_curr_thread) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    ++background_flushes_in_flight_;
+  }
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  StartFlush(std::move(batcher), allow_local_calls_in_curr_thread, [weak_self](const Status& s) {
+    auto self = weak_self.lock();
+    if (self) {
+      self->BackgroundFlushFinished(s);
+    }
+  });
+}
+
+void YBSessionData::BackgroundFlushFinished(const Status& status) {
+  std::vector<boost::function<void(const Status&)>> waiters;
+  Status waiters_status;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    if (!status.ok()) {
+      background_flush_status_ = status;
+    }
+    if (--background_flushes_in_flight_ != 0 || background_flush_waiters_.empty()) {
+      return;
+    }
+    waiters.swap(background_flush_waiters_);
+    waiters_status = std::move(background_flush_status_);
+    background_flush_status_ = Status::OK();
+  }
+  for (auto& waiter : waiters) {
+    waiter(waiters_status);
+  }
+}
+
+void YBSessionData::ScheduleBackgroundFlush(const internal::BatcherPtr& batcher) {
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  client_->messenger()->ScheduleOnReactor(
+      [weak_self, batcher](const Status&) {
+        // The batcher is flushed even if the task was aborted, so its ops fail instead of being
+        // left buffered.
+        auto self = weak_self.lock();
+        if (self) {
+          self->FlushBackgroundBatcher(batcher);
+        }
+      },
+      background_flush_policy_.max_delay);
+}
+
+void YBSessionData::FlushBackgroundBatcher(const internal::BatcherPtr& batcher) {
+  {
+    std::lock_guard<std::mutex> l(batcher_mutex_);
+    if (batcher_ != batcher) {
+      // Already flushed because it reached the size limits, or by an explicit flush.
+      return;
+    }
+    batcher_.reset();
+  }
+  // Local calls must not run on the reactor thread.
+  FlushInBackground(batcher, /* allow_local_calls_in_curr_thread */ false);
+}
+
 bool YBSessionData::allow_local_calls_in_curr_thread() const {
   return allow_local_calls_in_curr_thread_;
 }
@@ -132,21 +254,51 @@ void YBSessionData::set_allow_local_calls_in_curr_thread(bool flag) {
 }
 
 Status YBSessionData::Apply(std::shared_ptr<YBOperation> yb_op) {
-  if (!batcher_) {
-    batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
-                               transaction_));
-    if (timeout_.Initialized()) {
-      batcher_->SetTimeout(timeout_);
+  if (transaction_ && yb_op->type() == YBOperation::QL_READ &&
+      transaction_->ServeReadFromWrites(static_cast<YBqlReadOp*>(yb_op.get()))) {
+    return Status::OK();
+  }
+  internal::BatcherPtr new_batcher;
+  internal::BatcherPtr full_batcher;
+  {
+    std::lock_guard<std::mutex> l(batcher_mutex_);
+    if (!batcher_) {
+      batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
+                                 transaction_));
+      if (timeout_.Initialized()) {
+        batcher_->SetTimeout(timeout_);
+      }
+      new_batcher = batcher_;
+    }
+    Status s = batcher_->Add(yb_op);
+    if (!PREDICT_FALSE(s.ok())) {
+      error_collector_->AddError(yb_op, s);
+      return s;
+    }
+    if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND &&
+        (batcher_->MaxBufferedOpsPerTablet() >=
+             static_cast<size_t>(background_flush_policy_.target_ops_per_tablet) ||
+         static_cast<size_t>(batcher_->buffer_bytes_used()) >=
+             background_flush_policy_.max_bytes)) {
+      full_batcher.swap(batcher_);
     }
   }
-  Status s = batcher_->Add(yb_op);
-  if (!PREDICT_FALSE(s.ok())) {
-    error_collector_->AddError(yb_op, s);
-    return s;
+  if (transaction_ && !yb_op->read_only()) {
+    transaction_->WriteAdded(*yb_op);
   }
 
-  if (flush_mode_ == YBSession::AUTO_FLUSH_SYNC) {
-    return Flush();
+  switch (flush_mode_) {
+    case YBSession::AUTO_FLUSH_SYNC:
+      return Flush();
+    case YBSession::AUTO_FLUSH_BACKGROUND:
+      if (full_batcher) {
+        FlushInBackground(std::move(full_batcher), allow_local_calls_in_curr_thread_);
+      } else if (new_batcher) {
+        ScheduleBackgroundFlush(new_batcher);
+      }
+      return Status::OK();
+    case YBSession::MANUAL_FLUSH:
+      return Status::OK();
   }
 
   return Status::OK();
@@ -159,10 +311,7 @@ Status YBSessionData::Flush() {
 }
 
 Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
-  if (mode == YBSession::AUTO_FLUSH_BACKGROUND) {
-    return STATUS(NotSupported, "AUTO_FLUSH_BACKGROUND has not been implemented in the"
-        " c++ client (see KUDU-456).");
-  }
+  std::lock_guard<std::mutex> l(batcher_mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     // TODO: there may be a more reasonable behavior here.
     return STATUS(IllegalState, "Cannot change flush mode when writes are buffered");
@@ -176,8 +325,18 @@ Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
   return Status::OK();
 }
 
+void YBSessionData::SetBackgroundFlushPolicy(const YBSession::BackgroundFlushPolicy& policy) {
+  background_flush_policy_ = policy;
+}
+
+YBSession::FlushStats YBSessionData::GetFlushStats() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return flush_stats_;
+}
+
 void YBSessionData::SetTimeout(MonoDelta timeout) {
   CHECK_GE(timeout, MonoDelta::kZero);
+  std::lock_guard<std::mutex> l(batcher_mutex_);
   timeout_ = timeout;
   if (batcher_) {
     batcher_->SetTimeout(timeout);
@@ -186,12 +345,16 @@ void YBSessionData::SetTimeout(MonoDelta timeout) {
 
 int YBSessionData::CountBufferedOperations() const {
   CHECK_EQ(flush_mode_, YBSession::MANUAL_FLUSH);
+  std::lock_guard<std::mutex> l(batcher_mutex_);
   return batcher_ ? batcher_->CountBufferedOperations() : 0;
 }
 
 bool YBSessionData::HasPendingOperations() const {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    return true;
+  {
+    std::lock_guard<std::mutex> l(batcher_mutex_);
+    if (batcher_ && batcher_->HasPendingOperations()) {
+      return true;
+    }
   }
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& b : flushed_batchers_) {
@@ -32,7 +32,9 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <mutex>
 #include <unordered_set>
+#include <vector>
 
 #include "yb/client/async_rpc.h"
 #include "yb/util/locks.h"
@@ -80,6 +82,8 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   CHECKED_STATUS Close(bool force);
 
   CHECKED_STATUS SetFlushMode(YBSession::FlushMode mode);
+  void SetBackgroundFlushPolicy(const YBSession::BackgroundFlushPolicy& policy);
+  YBSession::FlushStats GetFlushStats() const;
   void SetTimeout(MonoDelta timeout);
   bool HasPendingOperations() const;
   int CountBufferedOperations() const;
@@ -99,15 +103,32 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   bool allow_local_calls_in_curr_thread() const;
 
  private:
+  // Sends the ops of 'batcher', which has been detached from batcher_.
+  void StartFlush(internal::BatcherPtr batcher, bool allow_local_calls_in_curr_thread,
+                  boost::function<void(const Status&)> callback);
+
+  // Flushes 'batcher' in AUTO_FLUSH_BACKGROUND mode, completion is tracked by
+  // background_flushes_in_flight_.
+  void FlushInBackground(internal::BatcherPtr batcher, bool allow_local_calls_in_curr_thread);
+  void BackgroundFlushFinished(const Status& status);
+
+  // Flushes 'batcher' when its linger delay expires, unless it has been flushed already.
+  void ScheduleBackgroundFlush(const internal::BatcherPtr& batcher);
+  void FlushBackgroundBatcher(const internal::BatcherPtr& batcher);
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
   YBTransactionPtr transaction_;
   bool allow_local_calls_in_curr_thread_ = true;
 
-  // Lock protecting flushed_batchers_.
+  // Lock protecting flushed_batchers_, flush_stats_ and the state of background flushes.
   mutable simple_spinlock lock_;
 
+  // Protects batcher_, which is flushed from reactor threads in AUTO_FLUSH_BACKGROUND mode.
+  // Acquired before lock_.
+  mutable std::mutex batcher_mutex_;
+
   // Buffer for errors.
   scoped_refptr<internal::ErrorCollector> error_collector_;
 
@@ -126,6 +147,17 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
 
   YBSession::FlushMode flush_mode_ = YBSession::AUTO_FLUSH_SYNC;
 
+  YBSession::BackgroundFlushPolicy background_flush_policy_;
+
+  // Number of batchers flushed in AUTO_FLUSH_BACKGROUND mode that have not finished yet, and
+  // the callbacks waiting for all of them to finish.
+  int background_flushes_in_flight_ = 0;
+  std::vector<boost::function<void(const Status&)>> background_flush_waiters_;
+  // Error of a background flush, reported to the next flush callback.
+  Status background_flush_status_;
+
+  YBSession::FlushStats flush_stats_;
+
   // Timeout for the next batch.
   MonoDelta timeout_;
 
@@ -107,6 +107,16 @@ std::shared_ptr<YBqlReadOp> TableHandle::NewReadOp() const {
   return op;
 }
 
+std::unique_ptr<YBqlWriteOpTemplate> TableHandle::NewWriteOpTemplate(
+    QLWriteRequestPB::QLStmtType type, const std::vector<std::string>& value_columns) const {
+  std::vector<int32_t> column_ids;
+  column_ids.reserve(value_columns.size());
+  for (const auto& column : value_columns) {
+    column_ids.push_back(ColumnId(column));
+  }
+  return std::make_unique<YBqlWriteOpTemplate>(table_, type, column_ids);
+}
+
 QLValuePB* TableHandle::PrepareColumn(QLWriteRequestPB* req, const string& column_name) const {
   return QLPrepareColumn(req, ColumnId(column_name));
 }
@@ -160,6 +170,38 @@ void TableHandle::AddColumns(const std::vector<std::string>& columns, QLReadRequ
   }
 }
 
+namespace {
+
+YBqlReadOpPtr NewTabletReadOp(const TableHandle& table, const TableIteratorOptions& options,
+                              const master::TabletLocationsPB& tablet) {
+  auto op = table.NewReadOp();
+  auto req = op->mutable_request();
+  op->set_yb_consistency_level(options.consistency);
+
+  const auto& key_start = tablet.partition().partition_key_start();
+  if (!key_start.empty()) {
+    req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(key_start));
+  }
+
+  if (options.filter) {
+    options.filter(table, req->mutable_where_expr()->mutable_condition());
+  }
+  if (options.read_time) {
+    op->SetReadTime(options.read_time);
+  }
+  table.AddColumns(*options.columns, req);
+  return op;
+}
+
+Status CheckReadResponse(const YBqlReadOp& op) {
+  if (QLResponsePB::YQL_STATUS_OK != op.response().status()) {
+    return STATUS_FORMAT(RuntimeError, "Error for $0: $1", op, op.response());
+  }
+  return Status::OK();
+}
+
+} // namespace
+
 TableIteratorOptions::TableIteratorOptions() {}
 
 TableIterator::TableIterator() : table_(nullptr) {}
@@ -189,23 +231,7 @@ TableIterator::TableIterator(const TableHandle* table, const TableIteratorOption
     if (!options.tablet.empty() && options.tablet != tablet.tablet_id()) {
       continue;
     }
-    auto op = table->NewReadOp();
-    auto req = op->mutable_request();
-    op->set_yb_consistency_level(options.consistency);
-
-    const auto& key_start = tablet.partition().partition_key_start();
-    if (!key_start.empty()) {
-      req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(key_start));
-    }
-
-    if (options.filter) {
-      options.filter(*table_, req->mutable_where_expr()->mutable_condition());
-    }
-    if (options.read_time) {
-      op->SetReadTime(options.read_time);
-    }
-    table_->AddColumns(*options.columns, req);
-    ops_.push_back(std::move(op));
+    ops_.push_back(NewTabletReadOp(*table, options, tablet));
   }
 
   ExecuteOps();
@@ -222,9 +248,9 @@ void TableIterator::ExecuteOps() {
   REPORT_AND_RETURN_IF_NOT_OK(session_->Flush());
 
   for (size_t i = executed_ops_; i != new_executed_ops; ++i) {
-    const auto& op = ops_[i];
-    if (QLResponsePB::YQL_STATUS_OK != op->response().status()) {
-      HandleError(STATUS_FORMAT(RuntimeError, "Error for $0: $1", *op, op->response()));
+    auto status = CheckReadResponse(*ops_[i]);
+    if (!status.ok()) {
+      HandleError(status);
     }
   }
 
@@ -272,6 +298,161 @@ void TableIterator::HandleError(const Status& status) {
   }
 }
 
+TableScanner::TableScanner(const TableHandle* table, const TableScanOptions& options)
+    : table_(table), options_(options) {
+  auto client = (*table)->client();
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+  status_ = client->GetTablets(table->name(), 0, &tablets);
+  if (!status_.ok()) {
+    return;
+  }
+
+  TableIteratorOptions op_options = options;
+  if (!op_options.columns) {
+    op_options.columns = table->AllColumnNames();
+  }
+  tablets_.reserve(tablets.size());
+  for (const auto& tablet : tablets) {
+    if (!options.tablet.empty() && options.tablet != tablet.tablet_id()) {
+      continue;
+    }
+    TabletScan scan;
+    scan.op = NewTabletReadOp(*table, op_options, tablet);
+    if (options.page_size != 0) {
+      scan.op->mutable_request()->set_limit(options.page_size);
+      scan.op->mutable_request()->set_return_paging_state(true);
+      scan.op->mutable_request()->set_read_ahead_pages(options.read_ahead_pages);
+    }
+    scan.session = client->NewSession();
+    status_ = scan.session->SetFlushMode(YBSession::MANUAL_FLUSH);
+    if (!status_.ok()) {
+      return;
+    }
+    scan.session->SetTimeout(60s);
+    ready_tablets_.push_back(tablets_.size());
+    tablets_.push_back(std::move(scan));
+  }
+
+  std::vector<size_t> reads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PickReads(&reads);
+  }
+  StartReads(reads);
+}
+
+TableScanner::~TableScanner() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  closing_ = true;
+  cond_.wait(lock, [this] { return reads_in_flight_ == 0; });
+}
+
+Result<bool> TableScanner::Next(QLRowBlock* block) {
+  std::vector<size_t> reads;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {
+      return !status_.ok() || !blocks_.empty() ||
+             (reads_in_flight_ == 0 && ready_tablets_.empty());
+    });
+    RETURN_NOT_OK(status_);
+    if (blocks_.empty()) {
+      return false;
+    }
+    *block = std::move(blocks_.front());
+    blocks_.pop_front();
+    // Consuming a block frees a slot for the next read.
+    PickReads(&reads);
+  }
+  StartReads(reads);
+  return true;
+}
+
+void TableScanner::PickReads(std::vector<size_t>* reads) {
+  const size_t parallelism = std::max<size_t>(options_.parallelism, 1);
+  const size_t prefetch_depth = std::max<size_t>(options_.prefetch_depth, 1);
+  while (!closing_ && status_.ok() && !ready_tablets_.empty() &&
+         reads_in_flight_ < parallelism && reads_in_flight_ + blocks_.size() < prefetch_depth) {
+    reads->push_back(ready_tablets_.front());
+    ready_tablets_.pop_front();
+    ++reads_in_flight_;
+  }
+}
+
+void TableScanner::StartReads(const std::vector<size_t>& reads) {
+  // The flush callback could be invoked synchronously, so the mutex should not be held here.
+  for (auto index : reads) {
+    auto& scan = tablets_[index];
+    auto status = scan.session->Apply(scan.op);
+    if (!status.ok()) {
+      ReadDone(index, status);
+      continue;
+    }
+    scan.session->FlushAsync([this, index](const Status& flush_status) {
+      ReadDone(index, flush_status);
+    });
+  }
+}
+
+void TableScanner::ReadDone(size_t index, const Status& status) {
+  bool has_more_pages = false;
+  auto process_status = status.ok() ? ProcessResponse(index, &has_more_pages) : status;
+
+  std::vector<size_t> reads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --reads_in_flight_;
+    if (!process_status.ok()) {
+      if (status_.ok()) {
+        status_ = process_status;
+      }
+    } else if (has_more_pages) {
+      ready_tablets_.push_back(index);
+    }
+    PickReads(&reads);
+    cond_.notify_all();
+  }
+  StartReads(reads);
+}
+
+Status TableScanner::ProcessResponse(size_t index, bool* has_more_pages) {
+  auto& scan = tablets_[index];
+  RETURN_NOT_OK(CheckReadResponse(*scan.op));
+  std::vector<QLRowBlock> blocks;
+  auto block = scan.op->MakeRowBlock();
+  RETURN_NOT_OK(block);
+  blocks.push_back(std::move(*block));
+  const QLResponsePB* last_response = &scan.op->response();
+  const auto& read_ahead_pages = scan.op->read_ahead_pages();
+  for (size_t i = 0; i != read_ahead_pages.size(); ++i) {
+    last_response = &read_ahead_pages[i].response;
+    block = scan.op->MakeReadAheadRowBlock(i);
+    RETURN_NOT_OK(block);
+    blocks.push_back(std::move(*block));
+  }
+
+  // A paging state without the next row key just points to the next tablet, that is read by
+  // its own scan.
+  *has_more_pages = last_response->has_paging_state() &&
+                    !last_response->paging_state().next_row_key().empty();
+  if (*has_more_pages) {
+    auto next_op = table_->NewReadOp();
+    *next_op->mutable_request() = scan.op->request();
+    *next_op->mutable_request()->mutable_paging_state() = last_response->paging_state();
+    next_op->set_yb_consistency_level(scan.op->yb_consistency_level());
+    next_op->SetReadTime(scan.op->read_time());
+    scan.op = std::move(next_op);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& page_block : blocks) {
+    if (!page_block.rows().empty()) {
+      blocks_.push_back(std::move(page_block));
+    }
+  }
+  return Status::OK();
+}
+
 template <>
 void FilterBetweenImpl<int32_t>::operator()(
     const TableHandle& table, QLConditionPB* condition) const {
@@ -14,6 +14,9 @@
 #ifndef YB_CLIENT_TABLE_HANDLE_H
 #define YB_CLIENT_TABLE_HANDLE_H
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <unordered_map>
 
 #include <boost/optional.hpp>
@@ -25,6 +28,7 @@
 #include "yb/common/ql_rowblock.h"
 #include "yb/common/read_hybrid_time.h"
 
+#include "yb/util/result.h"
 #include "yb/util/strongly_typed_bool.h"
 
 namespace yb {
@@ -39,6 +43,7 @@ class YBTableName;
 class YBClient;
 class YBqlReadOp;
 class YBqlWriteOp;
+class YBqlWriteOpTemplate;
 class YBSchema;
 class YBSchemaBuilder;
 
@@ -91,6 +96,10 @@ class TableHandle {
 
   std::shared_ptr<YBqlReadOp> NewReadOp() const;
 
+  // Template for write operations that set all key columns and the specified value columns.
+  std::unique_ptr<YBqlWriteOpTemplate> NewWriteOpTemplate(
+      QLWriteRequestPB::QLStmtType type, const std::vector<std::string>& value_columns) const;
+
   int32_t ColumnId(const std::string &column_name) const {
     auto it = column_ids_.find(column_name);
     return it != column_ids_.end() ? it->second : -1;
@@ -227,6 +236,65 @@ class TableRange {
   TableIteratorOptions options_;
 };
 
+struct TableScanOptions : public TableIteratorOptions {
+  // Max number of tablets that are read concurrently.
+  size_t parallelism = 8;
+
+  // Max number of row blocks that are either being read or buffered for the consumer.
+  size_t prefetch_depth = 16;
+
+  // Max number of rows returned by a single read, 0 means reading each tablet at once.
+  uint64_t page_size = 1024;
+
+  // Number of pages that the tablet server could read ahead and return with each page, so that
+  // a tablet is not read one round trip per page. Pages read ahead are queued on top of
+  // prefetch_depth.
+  uint32_t read_ahead_pages = 4;
+};
+
+// Scans all tablets of the table concurrently, paging through each of them.
+// Row blocks are delivered in the order reads complete, so rows of different tablets interleave.
+// Unless read_time is specified in options, every page is read at its own hybrid time.
+class TableScanner {
+ public:
+  TableScanner(const TableHandle* table, const TableScanOptions& options);
+
+  // Waits for reads that are still in flight.
+  ~TableScanner();
+
+  TableScanner(const TableScanner&) = delete;
+  void operator=(const TableScanner&) = delete;
+
+  // Waits for the next row block and moves it to block.
+  // Returns false when all tablets were read.
+  Result<bool> Next(QLRowBlock* block);
+
+ private:
+  struct TabletScan {
+    YBqlReadOpPtr op;
+    YBSessionPtr session;
+  };
+
+  // Picks tablets to read next, so that they could be flushed after releasing the mutex.
+  void PickReads(std::vector<size_t>* reads);
+  void StartReads(const std::vector<size_t>& reads);
+  void ReadDone(size_t index, const Status& status);
+  Status ProcessResponse(size_t index, bool* has_more_pages);
+
+  const TableHandle* table_;
+  const TableScanOptions options_;
+  std::vector<TabletScan> tablets_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // Tablets that have pages to read but are waiting for a free slot.
+  std::deque<size_t> ready_tablets_;
+  size_t reads_in_flight_ = 0;
+  std::deque<QLRowBlock> blocks_;
+  Status status_;
+  bool closing_ = false;
+};
+
 YB_STRONGLY_TYPED_BOOL(Inclusive);
 
 template <class T>
@@ -22,6 +22,13 @@
 
 #include "yb/tserver/tserver_service.proxy.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_string(client_read_replica_selection, "closest",
+              "How the client selects the replica for reads that do not have to go to the leader: "
+              "closest, least_outstanding or power_of_two_choices.");
+TAG_FLAG(client_read_replica_selection, advanced);
+
 namespace yb {
 namespace client {
 namespace internal {
@@ -42,10 +49,25 @@ TabletInvoker::TabletInvoker(bool consistent_prefix,
         trace_(trace),
         consistent_prefix_(consistent_prefix) {}
 
+namespace {
+
+YBClient::ReplicaSelection ReadReplicaSelection() {
+  const std::string& selection = FLAGS_client_read_replica_selection;
+  if (selection == "least_outstanding") {
+    return YBClient::ReplicaSelection::LEAST_OUTSTANDING_REQUESTS;
+  }
+  if (selection == "power_of_two_choices") {
+    return YBClient::ReplicaSelection::POWER_OF_TWO_CHOICES;
+  }
+  LOG_IF(DFATAL, selection != "closest") << "Unknown read replica selection: " << selection;
+  return YBClient::ReplicaSelection::CLOSEST_REPLICA;
+}
+
+} // namespace
+
 void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
   std::vector<RemoteTabletServer*> candidates;
-  current_ts_ = client_->data_->SelectTServer(tablet_.get(),
-                                              YBClient::ReplicaSelection::CLOSEST_REPLICA, {},
+  current_ts_ = client_->data_->SelectTServer(tablet_.get(), ReadReplicaSelection(), {},
                                               &candidates);
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
@@ -161,6 +183,9 @@ void TabletInvoker::InitTSProxyCb(const Status& status) {
   VLOG(2) << "Tablet " << tablet_id_ << ": Writing batch to replica "
           << current_ts_->ToString();
 
+  rpc_ts_ = current_ts_;
+  rpc_start_ = MonoTime::Now();
+  rpc_ts_->RpcStarted();
   rpc_->SendRpcToTserver();
 }
 
@@ -180,10 +205,31 @@ void TabletInvoker::FailToNewReplica(const Status& reason) {
   LOG_IF(DFATAL, !status.ok()) << "Retry failed: " << status;
 }
 
+void TabletInvoker::MarkLeaderFromHint() {
+  const auto* error = rpc_->response_error();
+  if (!tablet_ || error == nullptr || !error->has_leader_uuid()) {
+    return;
+  }
+  std::vector<RemoteTabletServer*> replicas;
+  tablet_->GetRemoteTabletServers(&replicas);
+  for (RemoteTabletServer* ts : replicas) {
+    if (ts->permanent_uuid() == error->leader_uuid()) {
+      VLOG(1) << "Tablet " << tablet_id_ << ": " << current_ts_->ToString()
+              << " reported " << ts->ToString() << " as the leader";
+      followers_.erase(ts);
+      tablet_->MarkTServerAsLeader(ts);
+      return;
+    }
+  }
+}
+
 bool TabletInvoker::Done(Status* status) {
   TRACE_TO(trace_, "Done($0)", status->ToString(false));
   ADOPT_TRACE(trace_);
 
+  // Timeouts are recorded too, they are what makes a slow server look slow.
+  TabletServerRpcFinished(/* record_latency */ !status->IsAborted());
+
   if (status->IsAborted() || retrier_->finished()) {
     return true;
   }
@@ -208,6 +254,16 @@ bool TabletInvoker::Done(Status* status) {
     *status = resp_error_status;
   }
 
+  // The leader is overloaded, retry it after the backoff it asked for, so that overload turns
+  // into slower writes instead of failures.
+  if (status->IsServiceUnavailable() &&
+      ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::SERVER_BUSY) {
+    auto retry_status = retrier_->DelayedRetry(
+        command_, *status, MonoDelta::FromMilliseconds(rpc_->response_error()->backoff_ms()));
+    LOG_IF(DFATAL, !retry_status.ok()) << "Retry failed: " << retry_status;
+    return false;
+  }
+
   // Oops, we failed over to a replica that wasn't a LEADER. Unlikely as
   // we're using consensus configuration information from the master, but still possible
   // (e.g. leader restarted and became a FOLLOWER). Try again.
@@ -226,6 +282,7 @@ bool TabletInvoker::Done(Status* status) {
     // Else the leader became a follower and must be reset on retry.
     if (!leader_is_not_ready) {
       followers_.insert(current_ts_);
+      MarkLeaderFromHint();
     }
 
     if (status->IsIllegalState() || TabletNotFoundOnTServer(rpc_->response_error(), *status)) {
@@ -264,6 +321,27 @@ bool TabletInvoker::Done(Status* status) {
   return true;
 }
 
+void TabletInvoker::ResponseIgnored() {
+  TabletServerRpcFinished(/* record_latency */ true);
+}
+
+void TabletInvoker::TabletServerRpcFinished(bool record_latency) {
+  if (rpc_ts_ != nullptr) {
+    rpc_ts_->RpcFinished(record_latency ? MonoTime::Now() - rpc_start_ : MonoDelta());
+    rpc_ts_ = nullptr;
+  }
+}
+
+RemoteTabletServer* TabletInvoker::SelectHedgeTabletServer() const {
+  if (!tablet_ || !current_ts_) {
+    return nullptr;
+  }
+  std::vector<RemoteTabletServer*> candidates;
+  return client_->data_->SelectTServer(
+      tablet_.get(), YBClient::ReplicaSelection::LEAST_OUTSTANDING_REQUESTS,
+      {current_ts_->permanent_uuid()}, &candidates);
+}
+
 void TabletInvoker::InitialLookupTabletDone(const Status& status) {
   VLOG(1) << "InitialLookupTabletDone(" << status << ")";
 
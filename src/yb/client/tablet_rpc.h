@@ -64,6 +64,12 @@ class TabletInvoker {
   void Execute(const std::string& tablet_id);
   bool Done(Status* status);
 
+  // Called instead of Done when the response is no longer needed, e.g. a hedged read answered.
+  void ResponseIgnored();
+
+  // Selects a replica other than the current one for a hedged read, nullptr if there is none.
+  RemoteTabletServer* SelectHedgeTabletServer() const;
+
   bool IsLocalCall() const;
 
   const RemoteTabletPtr& tablet() const { return tablet_; }
@@ -86,12 +92,18 @@ class TabletInvoker {
   // new replica.
   void FailToNewReplica(const Status& reason);
 
+  // Marks the replica that the rejecting tablet server reported as the leader, if any, as the
+  // leader in the meta cache, so that the retry goes there directly.
+  void MarkLeaderFromHint();
+
   // Called when we finish a lookup (to find the new consensus leader). Retries
   // the rpc after a short delay.
   void LookupTabletCb(const Status& status);
 
   void InitialLookupTabletDone(const Status& status);
 
+  void TabletServerRpcFinished(bool record_latency);
+
   // If we receive TABLET_NOT_FOUND and current_ts_ is set, that means we contacted a tserver
   // with a tablet_id, but the tserver no longer has that tablet.
   bool TabletNotFoundOnTServer(const tserver::TabletServerErrorPB* error_code,
@@ -129,6 +141,10 @@ class TabletInvoker {
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
   RemoteTabletServer* current_ts_ = nullptr;
+
+  // The TS that the RPC in flight was sent to, and when it was sent.
+  RemoteTabletServer* rpc_ts_ = nullptr;
+  MonoTime rpc_start_;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
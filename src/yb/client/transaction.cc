@@ -15,8 +15,11 @@
 
 #include "yb/client/transaction.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
+#include <boost/optional.hpp>
+
 #include "yb/client/async_rpc.h"
 #include "yb/client/client.h"
 #include "yb/client/in_flight_op.h"
@@ -26,11 +29,13 @@
 #include "yb/client/transaction_rpc.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/common/ql_rowblock.h"
 #include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/scheduler.h"
 
+#include "yb/util/faststring.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/result.h"
@@ -43,6 +48,9 @@ DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat du
 DEFINE_uint64(max_clock_skew_usec, 50000,
               "Transaction read clock skew in usec. Is maximum allowed time delta between servers "
               "of a single cluster.");
+DEFINE_bool(transaction_read_your_writes_cache, true,
+            "Serve point reads of rows written by the transaction from the values it wrote, "
+            "without sending them to the tablet server.");
 
 namespace yb {
 namespace client {
@@ -56,6 +64,270 @@ TransactionMetadata CreateMetadata(TransactionManager* manager, IsolationLevel i
 
 YB_STRONGLY_TYPED_BOOL(Child);
 
+// Caches rows written by the transaction, so point reads of those rows could be served without
+// going to tablet server.
+// Only simple writes to tables keyed by hash columns only are cached, i.e. writes that set columns
+// to literal scalar values. Any other write invalidates all cached rows of its table.
+// A row is not cached while there are unflushed writes of it, because the order in which
+// concurrent writes are applied is unknown.
+class WriteCache {
+ public:
+  void WriteAdded(const YBOperation& op) {
+    if (op.type() != YBOperation::QL_WRITE) {
+      return;
+    }
+    std::string key;
+    bool opaque = !WriteKey(static_cast<const YBqlWriteOp&>(op), &key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& table = tables_[op.table()->id()];
+    if (opaque) {
+      ++table.pending_opaque_writes;
+      table.rows.clear();
+    } else {
+      ++table.pending_writes[key];
+      table.rows.erase(key);
+    }
+  }
+
+  void Flushed(const internal::InFlightOps& ops, const Status& status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& in_flight_op : ops) {
+      const auto& op = *in_flight_op->yb_op;
+      if (op.type() != YBOperation::QL_WRITE) {
+        continue;
+      }
+      const auto& write_op = static_cast<const YBqlWriteOp&>(op);
+      std::string key;
+      bool opaque = !WriteKey(write_op, &key);
+      auto table_it = tables_.find(op.table()->id());
+      if (table_it == tables_.end()) {
+        continue;
+      }
+      auto& table = table_it->second;
+      if (opaque) {
+        DCHECK_GT(table.pending_opaque_writes, 0);
+        --table.pending_opaque_writes;
+        table.rows.clear();
+        continue;
+      }
+      auto pending_it = table.pending_writes.find(key);
+      if (pending_it == table.pending_writes.end()) {
+        continue;
+      }
+      if (--pending_it->second != 0 || table.pending_opaque_writes != 0 || !status.ok() ||
+          !in_flight_op->yb_op->succeeded() ||
+          !ApplyWrite(write_op.request(), &table.rows[key])) {
+        table.rows.erase(key);
+      }
+      if (pending_it->second == 0) {
+        table.pending_writes.erase(pending_it);
+      }
+    }
+  }
+
+  // Returns true if the read was served from cache. In this case the response of the read is
+  // filled.
+  bool ServeRead(YBqlReadOp* op) {
+    const auto& req = op->request();
+    const auto& schema = op->table()->schema();
+    if (req.client() != YQL_CLIENT_CQL || req.has_where_expr() || req.has_paging_state() ||
+        req.has_max_hash_code() || req.distinct() || req.is_aggregate() ||
+        (req.has_limit() && req.limit() == 0) ||
+        req.rsrow_desc().rscol_descs_size() != req.selected_exprs_size() ||
+        static_cast<size_t>(req.hashed_column_values_size()) != schema.num_hash_key_columns()) {
+      return false;
+    }
+    std::string key;
+    if (!EncodeKey(req.hashed_column_values(), &key)) {
+      return false;
+    }
+
+    QLRowBlock block(Schema(op->MakeColumnSchemasFromRequest(), 0));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto table_it = tables_.find(op->table()->id());
+      if (table_it == tables_.end()) {
+        return false;
+      }
+      auto row_it = table_it->second.rows.find(key);
+      if (row_it == table_it->second.rows.end()) {
+        return false;
+      }
+      const auto& row = row_it->second;
+      bool exists = row.liveness;
+      for (auto it = row.columns.begin(); !exists && it != row.columns.end(); ++it) {
+        exists = it->second.value_case() != QLValuePB::VALUE_NOT_SET;
+      }
+      if (!exists && !row.complete) {
+        return false;
+      }
+      if (exists) {
+        std::vector<QLValue> values;
+        values.reserve(req.selected_exprs_size());
+        for (const auto& expr : req.selected_exprs()) {
+          if (!expr.has_column_id()) {
+            return false;
+          }
+          auto value = ColumnValue(schema, req.hashed_column_values(), row, expr.column_id());
+          if (!value) {
+            return false;
+          }
+          values.emplace_back(*value);
+        }
+        block.Extend().SetColumnValues(values);
+      }
+    }
+
+    faststring buffer;
+    block.Serialize(req.client(), &buffer);
+    op->mutable_rows_data()->assign(buffer.c_str(), buffer.size());
+    op->mutable_response()->set_status(QLResponsePB::YQL_STATUS_OK);
+    ++reads_served_;
+    return true;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& table : tables_) {
+      table.second.rows.clear();
+    }
+  }
+
+  size_t reads_served() const {
+    return reads_served_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct CachedRow {
+    // Row was inserted, so it exists even when all its columns are null.
+    bool liveness = false;
+    // Row was deleted, so values of all columns that are not present in columns are null.
+    bool complete = false;
+    std::unordered_map<int32_t, QLValuePB> columns;
+  };
+
+  struct CachedTable {
+    size_t pending_opaque_writes = 0;
+    std::unordered_map<std::string, size_t> pending_writes;
+    std::unordered_map<std::string, CachedRow> rows;
+  };
+
+  static bool IsCacheableValue(const QLValuePB& value) {
+    switch (value.value_case()) {
+      case QLValuePB::VALUE_NOT_SET: FALLTHROUGH_INTENDED;
+      case QLValuePB::kInt8Value: FALLTHROUGH_INTENDED;
+      case QLValuePB::kInt16Value: FALLTHROUGH_INTENDED;
+      case QLValuePB::kInt32Value: FALLTHROUGH_INTENDED;
+      case QLValuePB::kInt64Value: FALLTHROUGH_INTENDED;
+      case QLValuePB::kFloatValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kDoubleValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kStringValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kBoolValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kTimestampValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kBinaryValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kInetaddressValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kUuidValue: FALLTHROUGH_INTENDED;
+      case QLValuePB::kTimeuuidValue:
+        return true;
+      default:
+        // Collections are ordered by tablet server, while decimals and varints are normalized
+        // there. So such values could be read back in another form than they were written.
+        return false;
+    }
+  }
+
+  static bool EncodeKey(const google::protobuf::RepeatedPtrField<QLExpressionPB>& hashed_values,
+                        std::string* key) {
+    if (hashed_values.empty()) {
+      return false;
+    }
+    for (const auto& expr : hashed_values) {
+      if (!expr.has_value() || expr.value().value_case() == QLValuePB::VALUE_NOT_SET ||
+          !IsCacheableValue(expr.value())) {
+        return false;
+      }
+      auto encoded_value = expr.value().SerializeAsString();
+      *key += std::to_string(encoded_value.size());
+      *key += ':';
+      *key += encoded_value;
+    }
+    return true;
+  }
+
+  // Fills key of row written by op. Returns false if write could affect other rows of the table,
+  // or rows of this table cannot be cached at all.
+  static bool WriteKey(const YBqlWriteOp& op, std::string* key) {
+    const auto& req = op.request();
+    const auto& schema = op.table()->schema();
+    // Values could expire during transaction when table has default TTL.
+    if (schema.num_range_key_columns() != 0 || schema.table_properties().HasDefaultTimeToLive() ||
+        static_cast<size_t>(req.hashed_column_values_size()) != schema.num_hash_key_columns()) {
+      return false;
+    }
+    return EncodeKey(req.hashed_column_values(), key);
+  }
+
+  // Applies write to cached row, returns false if result of write cannot be determined.
+  static bool ApplyWrite(const QLWriteRequestPB& req, CachedRow* row) {
+    if (req.has_where_expr() || req.has_if_expr() || req.has_ttl() ||
+        req.has_user_timestamp_usec()) {
+      return false;
+    }
+    for (const auto& column_value : req.column_values()) {
+      if (column_value.subscript_args_size() != 0 ||
+          (req.type() != QLWriteRequestPB::QL_STMT_DELETE &&
+           (!column_value.expr().has_value() || !IsCacheableValue(column_value.expr().value())))) {
+        return false;
+      }
+    }
+    switch (req.type()) {
+      case QLWriteRequestPB::QL_STMT_INSERT:
+        row->liveness = true;
+        FALLTHROUGH_INTENDED;
+      case QLWriteRequestPB::QL_STMT_UPDATE:
+        for (const auto& column_value : req.column_values()) {
+          row->columns[column_value.column_id()] = column_value.expr().value();
+        }
+        return true;
+      case QLWriteRequestPB::QL_STMT_DELETE:
+        if (req.column_values().empty()) {
+          row->liveness = false;
+          row->complete = true;
+          row->columns.clear();
+        } else {
+          for (const auto& column_value : req.column_values()) {
+            row->columns[column_value.column_id()].Clear();
+          }
+        }
+        return true;
+    }
+    return false;
+  }
+
+  static boost::optional<QLValuePB> ColumnValue(
+      const YBSchema& schema,
+      const google::protobuf::RepeatedPtrField<QLExpressionPB>& hashed_values,
+      const CachedRow& row, int32_t column_id) {
+    for (size_t i = 0; i != schema.num_hash_key_columns(); ++i) {
+      if (schema.ColumnId(i) == column_id) {
+        return hashed_values.Get(i).value();
+      }
+    }
+    auto it = row.columns.find(column_id);
+    if (it != row.columns.end()) {
+      return it->second;
+    }
+    if (row.complete) {
+      return QLValuePB();
+    }
+    return boost::none;
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<TableId, CachedTable> tables_;
+  std::atomic<size_t> reads_served_{0};
+};
+
 } // namespace
 
 Result<ChildTransactionData> ChildTransactionData::FromPB(const ChildTransactionDataPB& data) {
@@ -128,7 +400,7 @@ class YBTransaction::Impl final {
     {
       std::lock_guard<std::mutex> lock(mutex_);
       if (!ready_) {
-        RequestStatusTablet();
+        RequestStatusTablet(PreferredStatusTabletServer(ops));
         waiters_.push_back(std::move(waiter));
         VLOG_WITH_PREFIX(1) << "Prepare, rejected";
         return false;
@@ -163,6 +435,7 @@ class YBTransaction::Impl final {
 
   void Flushed(
       const internal::InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time) {
+    write_cache_.Flushed(ops, status);
     if (status.ok()) {
       manager_->UpdateClock(propagated_hybrid_time);
       std::lock_guard<std::mutex> lock(mutex_);
@@ -330,6 +603,8 @@ class YBTransaction::Impl final {
     for (const auto& tablet : result.tablets()) {
       tablets_[tablet.tablet_id()].MergeFromPB(tablet);
     }
+    // Child could write rows cached by this transaction.
+    write_cache_.Clear();
 
     HybridTime restart_read_ht(result.restart_read_ht());
     if (restart_read_ht.is_valid()) {
@@ -344,6 +619,18 @@ class YBTransaction::Impl final {
     return Status::OK();
   }
 
+  void WriteAdded(const YBOperation& op) {
+    write_cache_.WriteAdded(op);
+  }
+
+  bool ServeReadFromWrites(YBqlReadOp* op) {
+    return FLAGS_transaction_read_your_writes_cache && write_cache_.ServeRead(op);
+  }
+
+  size_t TEST_CountReadsServedFromWrites() const {
+    return write_cache_.reads_served();
+  }
+
   const std::string& LogPrefix() {
     return log_prefix_;
   }
@@ -462,12 +749,30 @@ class YBTransaction::Impl final {
     manager_->rpcs().Unregister(&abort_handle_);
   }
 
-  void RequestStatusTablet() {
+  // Prefer status tablet co-located with leader of the first involved tablet, so transactions
+  // that write to a single tablet don't need network round trips between participant and
+  // coordinator.
+  static std::string PreferredStatusTabletServer(
+      const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    for (const auto& op : ops) {
+      if (op->tablet == nullptr) {
+        continue;
+      }
+      auto* leader = op->tablet->LeaderTServer();
+      if (leader != nullptr) {
+        return leader->permanent_uuid();
+      }
+    }
+    return std::string();
+  }
+
+  void RequestStatusTablet(const std::string& preferred_tserver = std::string()) {
     if (requested_status_tablet_) {
       return;
     }
     requested_status_tablet_ = true;
     manager_->PickStatusTablet(
+        preferred_tserver,
         std::bind(&Impl::StatusTabletPicked, this, _1, transaction_->shared_from_this()));
   }
 
@@ -658,6 +963,7 @@ class YBTransaction::Impl final {
   // Restarts that happen during transaction lifetime. Used to initialise local_limits for
   // restarted transaction.
   std::unordered_map<TabletId, HybridTime> restarts_;
+  WriteCache write_cache_;
 };
 
 YBTransaction::YBTransaction(TransactionManager* manager,
@@ -683,6 +989,18 @@ void YBTransaction::Flushed(
   impl_->Flushed(ops, status, propagated_hybrid_time);
 }
 
+void YBTransaction::WriteAdded(const YBOperation& op) {
+  impl_->WriteAdded(op);
+}
+
+bool YBTransaction::ServeReadFromWrites(YBqlReadOp* op) {
+  return impl_->ServeReadFromWrites(op);
+}
+
+size_t YBTransaction::TEST_CountReadsServedFromWrites() const {
+  return impl_->TEST_CountReadsServedFromWrites();
+}
+
 void YBTransaction::Commit(CommitCallback callback) {
   impl_->Commit(std::move(callback));
 }
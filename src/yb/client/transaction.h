@@ -92,6 +92,13 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   void Flushed(
       const internal::InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
+  // Notifies transaction that specified op was added to batch, so it is not flushed yet.
+  void WriteAdded(const YBOperation& op);
+
+  // Tries to serve point read from rows written by this transaction.
+  // Returns true and fills response of op when succeeded, so op should not be sent to tserver.
+  bool ServeReadFromWrites(YBqlReadOp* op);
+
   // Commits this transaction.
   void Commit(CommitCallback callback);
 
@@ -123,6 +130,8 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
 
   std::shared_future<TransactionMetadata> TEST_GetMetadata() const;
 
+  size_t TEST_CountReadsServedFromWrites() const;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -23,6 +23,8 @@
 
 #include "yb/client/client.h"
 
+#include "yb/master/master.pb.h"
+
 DEFINE_uint64(transaction_table_num_tablets, 24,
               "Automatically create transaction table with specified number of tablets if missing. "
               "0 to disable.");
@@ -42,8 +44,10 @@ class PickStatusTabletTask {
  public:
   PickStatusTabletTask(const YBClientPtr& client,
                        std::atomic<bool>* status_table_exists,
+                       std::string preferred_tserver,
                        PickStatusTabletCallback callback)
-      : client_(client), status_table_exists_(status_table_exists), callback_(std::move(callback)) {
+      : client_(client), status_table_exists_(status_table_exists),
+        preferred_tserver_(std::move(preferred_tserver)), callback_(std::move(callback)) {
   }
 
   void Run() {
@@ -54,10 +58,12 @@ class PickStatusTabletTask {
     }
 
     // TODO(dtxn) async
-    // TODO(dtxn) prefer tablets with leader on the local node
     // TODO(dtxn) prevent deletion of picked tablet
     std::vector<std::string> tablets;
-    status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
+    std::vector<master::TabletLocationsPB> locations;
+    status = client_->GetTablets(
+        kTransactionTableName, 0, &tablets, /* ranges */ nullptr,
+        preferred_tserver_.empty() ? nullptr : &locations);
     if (!status.ok()) {
       callback_(status);
       return;
@@ -66,7 +72,20 @@ class PickStatusTabletTask {
       callback_(STATUS_FORMAT(IllegalState, "No tablets in table $0", kTransactionTableName));
       return;
     }
-    callback_(RandomElement(tablets));
+
+    // Status tablet with leader on the same node as the first tablet involved in transaction
+    // saves network round trips between transaction participant and coordinator.
+    std::vector<std::string> preferred_tablets;
+    for (const auto& location : locations) {
+      for (const auto& replica : location.replicas()) {
+        if (replica.role() == consensus::RaftPeerPB::LEADER &&
+            replica.ts_info().permanent_uuid() == preferred_tserver_) {
+          preferred_tablets.push_back(location.tablet_id());
+          break;
+        }
+      }
+    }
+    callback_(RandomElement(preferred_tablets.empty() ? tablets : preferred_tablets));
   }
 
   void Done(const Status& status) {
@@ -116,6 +135,7 @@ class PickStatusTabletTask {
 
   YBClientPtr client_;
   std::atomic<bool>* status_table_exists_;
+  std::string preferred_tserver_;
   PickStatusTabletCallback callback_;
 };
 
@@ -132,8 +152,9 @@ class TransactionManager::Impl {
         thread_pool_("TransactionManager", kQueueLimit, kMaxWorkers),
         tasks_pool_(kQueueLimit) {}
 
-  void PickStatusTablet(PickStatusTabletCallback callback) {
-    if (!tasks_pool_.Enqueue(&thread_pool_, client_, &status_table_exists_, std::move(callback))) {
+  void PickStatusTablet(const std::string& preferred_tserver, PickStatusTabletCallback callback) {
+    if (!tasks_pool_.Enqueue(
+            &thread_pool_, client_, &status_table_exists_, preferred_tserver, std::move(callback))) {
       callback(STATUS_FORMAT(ServiceUnavailable, "Tasks overflow, exists: $0", tasks_pool_.size()));
     }
   }
@@ -171,8 +192,9 @@ TransactionManager::TransactionManager(
 TransactionManager::~TransactionManager() {
 }
 
-void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback) {
-  impl_->PickStatusTablet(std::move(callback));
+void TransactionManager::PickStatusTablet(
+    const std::string& preferred_tserver, PickStatusTabletCallback callback) {
+  impl_->PickStatusTablet(preferred_tserver, std::move(callback));
 }
 
 const YBClientPtr& TransactionManager::client() const {
@@ -39,7 +39,9 @@ class TransactionManager {
   TransactionManager(const YBClientPtr& client, const scoped_refptr<ClockBase>& clock);
   ~TransactionManager();
 
-  void PickStatusTablet(PickStatusTabletCallback callback);
+  // Picks status tablet for new transaction. Tablets with leader on preferred_tserver are picked
+  // if there are any. Empty preferred_tserver means no preference.
+  void PickStatusTablet(const std::string& preferred_tserver, PickStatusTabletCallback callback);
 
   rpc::Rpcs& rpcs();
   const YBClientPtr& client() const;
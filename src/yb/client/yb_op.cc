@@ -121,6 +121,12 @@ const std::string& YBRedisReadOp::GetKey() const {
 }
 
 Status YBRedisReadOp::GetPartitionKey(std::string *partition_key) const {
+  if (redis_read_request_->has_scan_request()) {
+    // SCAN goes to the tablet of the hash code it continues from.
+    *partition_key = PartitionSchema::EncodeMultiColumnHashValue(
+        redis_read_request_->key_value().hash_code());
+    return Status::OK();
+  }
   const Slice& slice(redis_read_request_->key_value().key());
   return table_->partition_schema().EncodeRedisKey(slice, partition_key);
 }
@@ -185,6 +191,52 @@ uint16_t YBqlWriteOp::GetHashCode() const {
   return ql_write_request_->hash_code();
 }
 
+// YBqlWriteOpTemplate ---------------------------------------------------------
+
+YBqlWriteOpTemplate::YBqlWriteOpTemplate(
+    const shared_ptr<YBTable>& table, QLWriteRequestPB::QLStmtType type,
+    const std::vector<int32_t>& value_column_ids)
+    : table_(table) {
+  const auto& schema = table->InternalSchema();
+  num_hash_key_columns_ = schema.num_hash_key_columns();
+  num_key_columns_ = schema.num_key_columns();
+
+  prototype_.set_type(type);
+  prototype_.set_client(YQL_CLIENT_CQL);
+  prototype_.set_schema_version(table->schema().version());
+  for (size_t i = 0; i != num_key_columns_; ++i) {
+    auto* expr = i < num_hash_key_columns_ ? prototype_.add_hashed_column_values()
+                                           : prototype_.add_range_column_values();
+    expr->mutable_value();
+  }
+  for (auto column_id : value_column_ids) {
+    auto* column_value = prototype_.add_column_values();
+    column_value->set_column_id(column_id);
+    column_value->mutable_expr()->mutable_value();
+  }
+}
+
+shared_ptr<YBqlWriteOp> YBqlWriteOpTemplate::NewOp() const {
+  auto op = std::make_shared<YBqlWriteOp>(table_);
+  auto* req = op->mutable_request();
+  req->CopyFrom(prototype_);
+  req->set_request_id(reinterpret_cast<uint64_t>(op.get()));
+  req->set_query_id(reinterpret_cast<int64_t>(op.get()));
+  return op;
+}
+
+QLValuePB* YBqlWriteOpTemplate::BoundValue(YBqlWriteOp* op, size_t index) const {
+  DCHECK_LT(index, num_bound_values());
+  auto* req = op->mutable_request();
+  if (index < num_hash_key_columns_) {
+    return req->mutable_hashed_column_values(index)->mutable_value();
+  }
+  if (index < num_key_columns_) {
+    return req->mutable_range_column_values(index - num_hash_key_columns_)->mutable_value();
+  }
+  return req->mutable_column_values(index - num_key_columns_)->mutable_expr()->mutable_value();
+}
+
 size_t YBqlWriteOp::Hash::operator() (const shared_ptr<YBqlWriteOp>& op) const {
   return op->GetHashCode();
 }
@@ -340,15 +392,27 @@ std::vector<ColumnSchema> YBqlReadOp::MakeColumnSchemasFromRequest() const {
   return MakeColumnSchemasFromColDesc(request().rsrow_desc().rscol_descs());
 }
 
-Result<QLRowBlock> YBqlReadOp::MakeRowBlock() const {
-  Schema schema(MakeColumnSchemasFromRequest(), 0);
+namespace {
+
+Result<QLRowBlock> MakeRowBlockFromData(const YBqlReadOp& op, const std::string& rows_data) {
+  Schema schema(op.MakeColumnSchemasFromRequest(), 0);
   QLRowBlock result(schema);
-  Slice data(rows_data_);
+  Slice data(rows_data);
   if (!data.empty()) {
-    RETURN_NOT_OK(result.Deserialize(request().client(), &data));
+    RETURN_NOT_OK(result.Deserialize(op.request().client(), &data));
   }
   return result;
 }
 
+} // namespace
+
+Result<QLRowBlock> YBqlReadOp::MakeRowBlock() const {
+  return MakeRowBlockFromData(*this, rows_data_);
+}
+
+Result<QLRowBlock> YBqlReadOp::MakeReadAheadRowBlock(size_t index) const {
+  return MakeRowBlockFromData(*this, read_ahead_pages_[index].rows_data);
+}
+
 }  // namespace client
 }  // namespace yb
@@ -34,12 +34,15 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "yb/common/partial_row.h"
 #include "yb/common/partition.h"
+#include "yb/common/ql_protocol.pb.h"
 #include "yb/common/read_hybrid_time.h"
 
 #include "yb/client/meta_cache.h"
+#include "yb/util/monotime.h"
 
 namespace yb {
 
@@ -267,6 +270,29 @@ class YBqlWriteOp : public YBqlOp {
   std::unique_ptr<QLWriteRequestPB> ql_write_request_;
 };
 
+// Precomputed static part of QL write operations that set the same columns, so that bulk loaders
+// only fill bound values instead of building the whole request of each operation.
+// Bound values are ordered as hash key columns, range key columns, then value columns.
+class YBqlWriteOpTemplate {
+ public:
+  YBqlWriteOpTemplate(const std::shared_ptr<YBTable>& table, QLWriteRequestPB::QLStmtType type,
+                      const std::vector<int32_t>& value_column_ids);
+
+  std::shared_ptr<YBqlWriteOp> NewOp() const;
+
+  QLValuePB* BoundValue(YBqlWriteOp* op, size_t index) const;
+
+  size_t num_bound_values() const {
+    return num_key_columns_ + prototype_.column_values_size();
+  }
+
+ private:
+  std::shared_ptr<YBTable> table_;
+  QLWriteRequestPB prototype_;
+  size_t num_hash_key_columns_;
+  size_t num_key_columns_;
+};
+
 class YBqlReadOp : public YBqlOp {
  public:
   virtual ~YBqlReadOp();
@@ -298,12 +324,34 @@ class YBqlReadOp : public YBqlOp {
     yb_consistency_level_ = yb_consistency_level;
   }
 
+  // How far behind the current time a BOUNDED_STALENESS read could be, 10 seconds by default.
+  MonoDelta max_staleness() const {
+    return max_staleness_;
+  }
+
+  void set_max_staleness(MonoDelta max_staleness) {
+    max_staleness_ = max_staleness;
+  }
+
   std::vector<ColumnSchema> MakeColumnSchemasFromRequest() const;
   Result<QLRowBlock> MakeRowBlock() const;
 
   const ReadHybridTime& read_time() const { return read_time_; }
   void SetReadTime(const ReadHybridTime& value) { read_time_ = value; }
 
+  // Page that follows response() and was read ahead by the tablet server at the same read time,
+  // see QLReadRequestPB::read_ahead_pages.
+  struct ReadAheadPage {
+    QLResponsePB response;
+    std::string rows_data;
+  };
+
+  // Pages in order, the paging state of the last one is where the next fetch should continue.
+  const std::vector<ReadAheadPage>& read_ahead_pages() const { return read_ahead_pages_; }
+  std::vector<ReadAheadPage>* mutable_read_ahead_pages() { return &read_ahead_pages_; }
+
+  Result<QLRowBlock> MakeReadAheadRowBlock(size_t index) const;
+
  protected:
   virtual Type type() const override { return QL_READ; }
 
@@ -312,7 +360,9 @@ class YBqlReadOp : public YBqlOp {
   explicit YBqlReadOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
+  MonoDelta max_staleness_ = MonoDelta::FromSeconds(10);
   ReadHybridTime read_time_;
+  std::vector<ReadAheadPage> read_ahead_pages_;
 };
 
 std::vector<ColumnSchema> MakeColumnSchemasFromColDesc(
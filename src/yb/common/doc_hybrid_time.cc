@@ -13,6 +13,7 @@
 
 #include "yb/common/doc_hybrid_time.h"
 
+#include "yb/gutil/macros.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/cast.h"
@@ -23,6 +24,7 @@
 using yb::util::VarInt;
 using yb::util::FastEncodeDescendingSignedVarInt;
 using yb::util::FastDecodeDescendingSignedVarInt;
+using yb::util::FastDecodeDescendingSignedVarInts;
 using yb::util::FormatBytesAsStr;
 using yb::util::FormatSliceAsStr;
 using yb::util::QuotesType;
@@ -85,18 +87,12 @@ char* DocHybridTime::EncodedInDocDbFormat(char* dest) const {
 Status DocHybridTime::DecodeFrom(Slice *slice) {
   const size_t previous_size = slice->size();
   {
-    // Currently we just ignore the generation number as it should always be 0.
-    int64_t ht_generation_number;
-    RETURN_NOT_OK(FastDecodeDescendingSignedVarInt(slice, &ht_generation_number));
-
-    int64_t decoded_micros = 0;
-    RETURN_NOT_OK(FastDecodeDescendingSignedVarInt(slice, &decoded_micros));
-    decoded_micros += kYugaByteMicrosecondEpoch;
-
-    int64_t decoded_logical = 0;
-    RETURN_NOT_OK(FastDecodeDescendingSignedVarInt(slice, &decoded_logical));
-
-    hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(decoded_micros, decoded_logical);
+    // The generation number, microseconds and logical value, decoded at once. Currently we just
+    // ignore the generation number as it should always be 0.
+    int64_t decoded[3];
+    RETURN_NOT_OK(FastDecodeDescendingSignedVarInts(slice, decoded, arraysize(decoded)));
+    const int64_t decoded_micros = decoded[1] + kYugaByteMicrosecondEpoch;
+    hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(decoded_micros, decoded[2]);
   }
 
   int64_t decoded_shifted_write_id = 0;
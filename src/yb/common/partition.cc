@@ -246,11 +246,11 @@ Status PartitionSchema::EncodeKey(const RepeatedPtrField<QLExpressionPB>& hash_c
 
   switch (hash_schema_) {
     case YBHashSchema::kMultiColumnHash: {
-      string tmp;
+      YBPartition::HashBuilder hasher;
       for (const auto &col_expr_pb : hash_col_values) {
-        AppendToKey(col_expr_pb.value(), &tmp);
+        AppendToKey(col_expr_pb.value(), &hasher);
       }
-      const uint16_t hash_value = YBPartition::HashColumnCompoundValue(tmp);
+      const uint16_t hash_value = hasher.Finish();
       *buf = EncodeMultiColumnHashValue(hash_value);
       return Status::OK();
     }
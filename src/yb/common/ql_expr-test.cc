@@ -0,0 +1,158 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_expr.h"
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_macros.h"
+
+namespace yb {
+
+namespace {
+
+constexpr ColumnIdRep kColumnA = 10;
+constexpr ColumnIdRep kColumnB = 11;
+
+void AddColumnOperand(QLConditionPB* condition, ColumnIdRep column_id) {
+  condition->add_operands()->set_column_id(column_id);
+}
+
+void AddInt32Operand(QLConditionPB* condition, int32_t value) {
+  condition->add_operands()->mutable_value()->set_int32_value(value);
+}
+
+// Adds "column op value" to the given AND / OR condition.
+void AddRelation(QLConditionPB* condition, ColumnIdRep column_id, QLOperator op, int32_t value) {
+  QLConditionPB* relation = condition->add_operands()->mutable_condition();
+  relation->set_op(op);
+  AddColumnOperand(relation, column_id);
+  AddInt32Operand(relation, value);
+}
+
+QLTableRow MakeRow(int32_t a, bool with_b, int32_t b) {
+  QLTableRow row;
+  row.AllocColumn(kColumnA).value.set_int32_value(a);
+  if (with_b) {
+    row.AllocColumn(kColumnB).value.set_int32_value(b);
+  }
+  return row;
+}
+
+// Checks that the compiled condition matches the interpreted one for a range of rows.
+void CheckCondition(const QLConditionPB& condition) {
+  QLExprExecutor executor;
+  QLCompiledCondition compiled(condition, &executor);
+  for (int32_t a = 0; a < 10; ++a) {
+    for (int32_t b = 0; b < 10; ++b) {
+      const QLTableRow row = MakeRow(a, b != 0, b);
+      bool expected = false, actual = false;
+      ASSERT_OK(executor.EvalCondition(condition, row, &expected));
+      ASSERT_OK(compiled.Eval(row, &actual));
+      ASSERT_EQ(expected, actual) << condition.ShortDebugString() << " " << row.ToString();
+    }
+  }
+}
+
+} // namespace
+
+TEST(QLCompiledConditionTest, TestRelations) {
+  for (QLOperator op : {QL_OP_EQUAL, QL_OP_LESS_THAN, QL_OP_LESS_THAN_EQUAL, QL_OP_GREATER_THAN,
+                        QL_OP_GREATER_THAN_EQUAL, QL_OP_NOT_EQUAL}) {
+    QLConditionPB condition;
+    condition.set_op(QL_OP_AND);
+    AddRelation(&condition, kColumnA, op, 5);
+    CheckCondition(condition);
+  }
+}
+
+TEST(QLCompiledConditionTest, TestLogicalOperators) {
+  QLConditionPB condition;
+  condition.set_op(QL_OP_OR);
+  AddRelation(&condition, kColumnA, QL_OP_LESS_THAN, 3);
+  QLConditionPB* conjunction = condition.add_operands()->mutable_condition();
+  conjunction->set_op(QL_OP_AND);
+  AddRelation(conjunction, kColumnA, QL_OP_GREATER_THAN, 6);
+  AddRelation(conjunction, kColumnB, QL_OP_NOT_EQUAL, 4);
+  CheckCondition(condition);
+
+  QLConditionPB negation;
+  negation.set_op(QL_OP_NOT);
+  *negation.add_operands()->mutable_condition() = condition;
+  CheckCondition(negation);
+}
+
+TEST(QLCompiledConditionTest, TestNullsBetweenAndIn) {
+  QLConditionPB condition;
+  condition.set_op(QL_OP_AND);
+  QLConditionPB* is_not_null = condition.add_operands()->mutable_condition();
+  is_not_null->set_op(QL_OP_IS_NOT_NULL);
+  AddColumnOperand(is_not_null, kColumnB);
+  QLConditionPB* between = condition.add_operands()->mutable_condition();
+  between->set_op(QL_OP_BETWEEN);
+  AddColumnOperand(between, kColumnA);
+  AddInt32Operand(between, 2);
+  AddInt32Operand(between, 7);
+  QLConditionPB* in = condition.add_operands()->mutable_condition();
+  in->set_op(QL_OP_IN);
+  AddColumnOperand(in, kColumnB);
+  QLSeqValuePB* list = in->add_operands()->mutable_value()->mutable_list_value();
+  list->add_elems()->set_int32_value(1);
+  list->add_elems()->set_int32_value(5);
+  list->add_elems()->set_int32_value(8);
+  CheckCondition(condition);
+
+  in->set_op(QL_OP_NOT_IN);
+  is_not_null->set_op(QL_OP_IS_NULL);
+  condition.set_op(QL_OP_OR);
+  CheckCondition(condition);
+}
+
+TEST(QLCompiledConditionTest, TestIncomparableValues) {
+  QLConditionPB condition;
+  condition.set_op(QL_OP_EQUAL);
+  AddColumnOperand(&condition, kColumnA);
+  condition.add_operands()->mutable_value()->set_string_value("a");
+  QLExprExecutor executor;
+  QLCompiledCondition compiled(condition, &executor);
+  bool result = false;
+  ASSERT_FALSE(compiled.Eval(MakeRow(1, false, 0), &result).ok());
+}
+
+TEST(QLTableRowTest, TestColumnsOutOfOrder) {
+  QLTableRow row;
+  for (ColumnIdRep column_id : {5, 1, 9, 3, 7}) {
+    row.AllocColumn(column_id).value.set_int32_value(column_id * 10);
+  }
+  // Allocating an existing column returns it.
+  row.AllocColumn(3).ttl_seconds = 100;
+  ASSERT_EQ(5, row.ColumnCount());
+  for (ColumnIdRep column_id : {1, 3, 5, 7, 9}) {
+    const QLValuePB* value = row.GetColumn(column_id);
+    ASSERT_NE(nullptr, value);
+    ASSERT_EQ(column_id * 10, value->int32_value());
+  }
+  ASSERT_EQ(nullptr, row.GetColumn(4));
+  int64_t ttl_seconds = 0;
+  ASSERT_OK(row.GetTTL(3, &ttl_seconds));
+  ASSERT_EQ(100, ttl_seconds);
+  ASSERT_NOK(row.GetTTL(4, &ttl_seconds));
+
+  QLTableRow other;
+  ASSERT_FALSE(other.MatchColumn(7, row));
+  ASSERT_OK(other.CopyColumn(7, row));
+  ASSERT_TRUE(other.MatchColumn(7, row));
+  ASSERT_TRUE(other.MatchColumn(4, row));
+}
+
+} // namespace yb
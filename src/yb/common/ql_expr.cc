@@ -3,6 +3,9 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/common/ql_expr.h"
+
+#include <algorithm>
+
 #include "yb/common/ql_bfunc.h"
 
 namespace yb {
@@ -311,14 +314,249 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+const QLValuePB& NullValue() {
+  static const QLValuePB null_value;
+  return null_value;
+}
+
+} // namespace
+
+QLCompiledCondition::QLCompiledCondition(const QLConditionPB& condition, QLExprExecutor* executor)
+    : executor_(executor), predicate_(Compile(condition)) {
+}
+
+CHECKED_STATUS QLCompiledCondition::Eval(const QLTableRow& table_row, bool* result) const {
+  return predicate_(table_row, result);
+}
+
+QLCompiledCondition::Operand QLCompiledCondition::CompileOperand(const QLExpressionPB& expr) {
+  switch (expr.expr_case()) {
+    case QLExpressionPB::ExprCase::kValue: {
+      const QLValuePB* value = &expr.value();
+      return [value](const QLTableRow& table_row, QLValue* temp) -> Result<const QLValuePB*> {
+        return value;
+      };
+    }
+
+    case QLExpressionPB::ExprCase::kColumnId: {
+      const ColumnIdRep column_id = expr.column_id();
+      return [column_id](const QLTableRow& table_row, QLValue* temp) -> Result<const QLValuePB*> {
+        const QLValuePB* value = table_row.GetColumn(column_id);
+        return value != nullptr ? value : &NullValue();
+      };
+    }
+
+    case QLExpressionPB::ExprCase::kSubscriptedCol: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::kBfcall: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::kTscall: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::kCondition: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::kBocall: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::kBindId: FALLTHROUGH_INTENDED;
+    case QLExpressionPB::ExprCase::EXPR_NOT_SET:
+      break;
+  }
+
+  QLExprExecutor* executor = executor_;
+  return [executor, &expr](const QLTableRow& table_row, QLValue* temp)
+      -> Result<const QLValuePB*> {
+    RETURN_NOT_OK(executor->EvalExpr(expr, table_row, temp));
+    return &temp->value();
+  };
+}
+
+template <class Compare>
+QLCompiledCondition::Predicate QLCompiledCondition::CompileRelation(
+    const QLConditionPB& condition, const Compare& compare) {
+  const auto& operands = condition.operands();
+  CHECK_EQ(operands.size(), 2);
+  Operand left = CompileOperand(operands.Get(0));
+  Operand right = CompileOperand(operands.Get(1));
+  return [left, right, compare](const QLTableRow& table_row, bool* result) -> Status {
+    QLValue left_temp, right_temp;
+    auto left_value = left(table_row, &left_temp);
+    RETURN_NOT_OK(left_value);
+    auto right_value = right(table_row, &right_temp);
+    RETURN_NOT_OK(right_value);
+    if (!Comparable(**left_value, **right_value)) {
+      return STATUS(RuntimeError, "values not comparable");
+    }
+    *result = compare(**left_value, **right_value);
+    return Status::OK();
+  };
+}
+
+QLCompiledCondition::Predicate QLCompiledCondition::CompileIn(const QLConditionPB& condition,
+                                                              const bool in) {
+  const auto& operands = condition.operands();
+  CHECK_EQ(operands.size(), 2);
+  Operand left = CompileOperand(operands.Get(0));
+  Operand right = CompileOperand(operands.Get(1));
+  return [left, right, in](const QLTableRow& table_row, bool* result) -> Status {
+    QLValue left_temp, right_temp;
+    auto left_value = left(table_row, &left_temp);
+    RETURN_NOT_OK(left_value);
+    auto right_value = right(table_row, &right_temp);
+    RETURN_NOT_OK(right_value);
+    *result = !in;
+    for (const QLValuePB& elem : (*right_value)->list_value().elems()) {
+      if (!Comparable(elem, **left_value)) {
+        return STATUS(RuntimeError, "values not comparable");
+      }
+      if (elem == **left_value) {
+        *result = in;
+        break;
+      }
+    }
+    return Status::OK();
+  };
+}
+
+QLCompiledCondition::Predicate QLCompiledCondition::Compile(const QLConditionPB& condition) {
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_NOT: {
+      CHECK_EQ(operands.size(), 1);
+      CHECK_EQ(operands.Get(0).expr_case(), QLExpressionPB::ExprCase::kCondition);
+      Predicate operand = Compile(operands.Get(0).condition());
+      return [operand](const QLTableRow& table_row, bool* result) -> Status {
+        RETURN_NOT_OK(operand(table_row, result));
+        *result = !*result;
+        return Status::OK();
+      };
+    }
+
+    case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_NOT_NULL: {
+      CHECK_EQ(operands.size(), 1);
+      Operand operand = CompileOperand(operands.Get(0));
+      const bool is_null = condition.op() == QL_OP_IS_NULL;
+      return [operand, is_null](const QLTableRow& table_row, bool* result) -> Status {
+        QLValue temp;
+        auto value = operand(table_row, &temp);
+        RETURN_NOT_OK(value);
+        *result = IsNull(**value) == is_null;
+        return Status::OK();
+      };
+    }
+
+    case QL_OP_EQUAL:
+      return CompileRelation(condition, std::equal_to<QLValuePB>());
+
+    case QL_OP_LESS_THAN:
+      return CompileRelation(condition, std::less<QLValuePB>());
+
+    case QL_OP_LESS_THAN_EQUAL:
+      return CompileRelation(condition, std::less_equal<QLValuePB>());
+
+    case QL_OP_GREATER_THAN:
+      return CompileRelation(condition, std::greater<QLValuePB>());
+
+    case QL_OP_GREATER_THAN_EQUAL:
+      return CompileRelation(condition, std::greater_equal<QLValuePB>());
+
+    case QL_OP_NOT_EQUAL:
+      return CompileRelation(condition, std::not_equal_to<QLValuePB>());
+
+    case QL_OP_AND: FALLTHROUGH_INTENDED;
+    case QL_OP_OR: {
+      CHECK_GT(operands.size(), 0);
+      std::vector<Predicate> predicates;
+      predicates.reserve(operands.size());
+      for (const auto& operand : operands) {
+        CHECK_EQ(operand.expr_case(), QLExpressionPB::ExprCase::kCondition);
+        predicates.push_back(Compile(operand.condition()));
+      }
+      // AND stops at the first false operand and OR at the first true one.
+      const bool stop_value = condition.op() == QL_OP_OR;
+      return [predicates, stop_value](const QLTableRow& table_row, bool* result) -> Status {
+        for (const auto& predicate : predicates) {
+          RETURN_NOT_OK(predicate(table_row, result));
+          if (*result == stop_value) {
+            break;
+          }
+        }
+        return Status::OK();
+      };
+    }
+
+    case QL_OP_BETWEEN: {
+      CHECK_EQ(operands.size(), 3);
+      Operand operand = CompileOperand(operands.Get(0));
+      Operand lower = CompileOperand(operands.Get(1));
+      Operand upper = CompileOperand(operands.Get(2));
+      return [operand, lower, upper](const QLTableRow& table_row, bool* result) -> Status {
+        QLValue temp, lower_temp, upper_temp;
+        auto value = operand(table_row, &temp);
+        RETURN_NOT_OK(value);
+        auto lower_value = lower(table_row, &lower_temp);
+        RETURN_NOT_OK(lower_value);
+        auto upper_value = upper(table_row, &upper_temp);
+        RETURN_NOT_OK(upper_value);
+        if (!Comparable(**value, **lower_value) || !Comparable(**value, **upper_value)) {
+          return STATUS(RuntimeError, "values not comparable");
+        }
+        *result = **value >= **lower_value && **value <= **upper_value;
+        return Status::OK();
+      };
+    }
+
+    case QL_OP_EXISTS: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EXISTS: {
+      const bool exists = condition.op() == QL_OP_EXISTS;
+      return [exists](const QLTableRow& table_row, bool* result) -> Status {
+        *result = table_row.IsEmpty() != exists;
+        return Status::OK();
+      };
+    }
+
+    case QL_OP_IN:
+      return CompileIn(condition, true /* in */);
+
+    case QL_OP_NOT_IN:
+      return CompileIn(condition, false /* in */);
+
+    case QL_OP_IS_TRUE: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_FALSE: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_BETWEEN: FALLTHROUGH_INTENDED;
+    case QL_OP_LIKE: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_LIKE: FALLTHROUGH_INTENDED;
+    case QL_OP_NOOP:
+      break;
+  }
+
+  // Leave the remaining operators to the executor.
+  QLExprExecutor* executor = executor_;
+  return [executor, &condition](const QLTableRow& table_row, bool* result) -> Status {
+    return executor->EvalCondition(condition, table_row, result);
+  };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+const QLTableColumn* QLTableRow::FindColumn(ColumnIdRep col_id) const {
+  auto it = std::lower_bound(
+      columns_.begin(), columns_.end(), col_id,
+      [](const std::pair<ColumnIdRep, QLTableColumn>& column, ColumnIdRep id) {
+        return column.first < id;
+      });
+  return it != columns_.end() && it->first == col_id ? &it->second : nullptr;
+}
+
+const QLValuePB* QLTableRow::GetColumn(ColumnIdRep col_id) const {
+  const auto* column = FindColumn(col_id);
+  return column == nullptr ? nullptr : &column->value;
+}
+
 CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLValue *col_value) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* column = FindColumn(col_id);
+  if (column == nullptr) {
     col_value->SetNull();
     return Status::OK();
   }
 
-  *col_value = col_iter->second.value;
+  *col_value = column->value;
   return Status::OK();
 }
 
@@ -327,21 +565,21 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
                                                  QLValue *col_value) const {
   col_value->SetNull();
 
-  const auto& col_iter = col_map_.find(subcol.column_id());
-  if (col_iter == col_map_.end()) {
+  const auto* column = FindColumn(subcol.column_id());
+  if (column == nullptr) {
     // Not exists.
     return Status::OK();
-  } else if (col_iter->second.value.has_map_value()) {
+  } else if (column->value.has_map_value()) {
     // map['key']
-    auto& map = col_iter->second.value.map_value();
+    auto& map = column->value.map_value();
     for (int i = 0; i < map.keys_size(); i++) {
       if (map.keys(i) == index_arg.value()) {
           *col_value = map.values(i);
       }
     }
-  } else if (col_iter->second.value.has_list_value()) {
+  } else if (column->value.has_list_value()) {
     // list[index]
-    auto& list = col_iter->second.value.list_value();
+    auto& list = column->value.list_value();
     if (index_arg.value().has_int32_value()) {
       int list_index = index_arg.int32_value();
       if (list_index >= 0 && list_index < list.elems_size()) {
@@ -353,61 +591,74 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
 }
 
 CHECKED_STATUS QLTableRow::GetTTL(ColumnIdRep col_id, int64_t *ttl_seconds) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *ttl_seconds = col_iter->second.ttl_seconds;
+  *ttl_seconds = column->ttl_seconds;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetWriteTime(ColumnIdRep col_id, int64_t *write_time) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* column = FindColumn(col_id);
+  if (column == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *write_time = col_iter->second.write_time;
+  *write_time = column->write_time;
   return Status::OK();
 }
 
 CHECKED_STATUS QLTableRow::GetValue(ColumnIdRep col_id, QLValue *column) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto* found = FindColumn(col_id);
+  if (found == nullptr) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
-  *column = std::move(col_iter->second.value);
+  *column = found->value;
   return Status::OK();
 }
 
 bool QLTableRow::MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const {
-  auto this_iter = col_map_.find(col_id);
-  auto source_iter = source.col_map_.find(col_id);
-  if (this_iter != col_map_.end() && source_iter != source.col_map_.end()) {
-    return this_iter->second.value == source_iter->second.value;
+  const auto* this_column = FindColumn(col_id);
+  const auto* source_column = source.FindColumn(col_id);
+  if (this_column != nullptr && source_column != nullptr) {
+    return this_column->value == source_column->value;
   }
-  if (this_iter != col_map_.end() || source_iter != source.col_map_.end()) {
+  if (this_column != nullptr || source_column != nullptr) {
     return false;
   }
   return true;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id) {
-  return col_map_[col_id];
+  // Columns are usually added in the order of their ids, so check the end first.
+  auto it = columns_.end();
+  if (!columns_.empty() && columns_.back().first >= col_id) {
+    it = std::lower_bound(
+        columns_.begin(), columns_.end(), col_id,
+        [](const std::pair<ColumnIdRep, QLTableColumn>& column, ColumnIdRep id) {
+          return column.first < id;
+        });
+    if (it->first == col_id) {
+      return it->second;
+    }
+  }
+  return columns_.emplace(it, col_id, QLTableColumn())->second;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValue& ql_value) {
-  col_map_[col_id].value = ql_value.value();
-  return col_map_[col_id];
+  QLTableColumn& column = AllocColumn(col_id);
+  column.value = ql_value.value();
+  return column;
 }
 
 CHECKED_STATUS QLTableRow::CopyColumn(ColumnIdRep col_id,
                                       const QLTableRow& source) {
-  auto col_iter = source.col_map_.find(col_id);
-  if (col_iter != source.col_map_.end()) {
-    col_map_[col_id] = col_iter->second;
+  const auto* column = source.FindColumn(col_id);
+  if (column != nullptr) {
+    AllocColumn(col_id) = *column;
   }
   return Status::OK();
 }
@@ -417,9 +668,9 @@ std::string QLTableRow::ToString(const Schema& schema) const {
   ret.append("{ ");
 
   for (size_t col_idx = 0; col_idx < schema.num_columns(); col_idx++) {
-    auto it = col_map_.find(schema.column_id(col_idx));
-    if (it != col_map_.end() && it->second.value.value_case() != QLValuePB::VALUE_NOT_SET) {
-      ret += it->second.value.ShortDebugString();
+    const auto* column = FindColumn(schema.column_id(col_idx));
+    if (column != nullptr && column->value.value_case() != QLValuePB::VALUE_NOT_SET) {
+      ret += column->value.ShortDebugString();
     } else {
       ret += "null";
     }
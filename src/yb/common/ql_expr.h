@@ -7,9 +7,14 @@
 #ifndef YB_COMMON_QL_EXPR_H_
 #define YB_COMMON_QL_EXPR_H_
 
+#include <functional>
+#include <utility>
+#include <vector>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_bfunc.h"
+#include "yb/util/result.h"
 
 namespace yb {
 
@@ -43,16 +48,16 @@ class QLTableRow {
 
   // Check if row is empty (no column).
   bool IsEmpty() const {
-    return col_map_.empty();
+    return columns_.empty();
   }
 
   // Get column count.
   size_t ColumnCount() const {
-    return col_map_.size();
+    return columns_.size();
   }
 
   // Clear the row.
-  void Clear() { col_map_.clear(); }
+  void Clear() { columns_.clear(); }
 
   // Compare column value between two rows.
   bool MatchColumn(ColumnIdRep col_id, const QLTableRow& source) const;
@@ -87,6 +92,9 @@ class QLTableRow {
     return GetValue(col.rep(), column);
   }
 
+  // Get the column value without copying it, or null if the column is not in the row.
+  const QLValuePB* GetColumn(ColumnIdRep col_id) const;
+
   // Get the column value in PB format.
   CHECKED_STATUS ReadColumn(ColumnIdRep col_id, QLValue *col_value) const;
   CHECKED_STATUS ReadSubscriptedColumn(const QLSubscriptedColPB& subcol,
@@ -95,20 +103,26 @@ class QLTableRow {
 
   // For testing only (no status check).
   const QLTableColumn& TestValue(ColumnIdRep col_id) const {
-    return col_map_.at(col_id);
+    return *CHECK_NOTNULL(FindColumn(col_id));
   }
   const QLTableColumn& TestValue(const ColumnId& col) const {
-    return col_map_.at(col.rep());
+    return TestValue(col.rep());
   }
 
   std::string ToString() const {
-    return yb::ToString(col_map_);
+    return yb::ToString(columns_);
   }
 
   std::string ToString(const Schema& schema) const;
 
  private:
-  std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
+  // Returns the column with the given id, or null if the row does not have it.
+  const QLTableColumn* FindColumn(ColumnIdRep col_id) const;
+
+  // The columns of a row are few and mostly added in the order of their ids, so they are kept in
+  // a vector sorted by id. There is a single allocation per row instead of one per column, and
+  // a row reused for the next one keeps it.
+  std::vector<std::pair<ColumnIdRep, QLTableColumn>> columns_;
 };
 
 class QLExprExecutor {
@@ -159,6 +173,34 @@ class QLExprExecutor {
                                        QLValue *result);
 };
 
+// A condition compiled once per request into closures that are reused for every row, so that
+// evaluating it per row neither walks and switches over the protobuf tree nor copies constant and
+// column operands. Operators and operands that are not compiled are evaluated by the executor.
+class QLCompiledCondition {
+ public:
+  // The condition and the executor must outlive the compiled condition.
+  QLCompiledCondition(const QLConditionPB& condition, QLExprExecutor* executor);
+
+  CHECKED_STATUS Eval(const QLTableRow& table_row, bool* result) const;
+
+ private:
+  typedef std::function<Status(const QLTableRow&, bool*)> Predicate;
+
+  // Returns the value of an operand for the given row. The value points into the row, into the
+  // condition or into 'temp'.
+  typedef std::function<Result<const QLValuePB*>(const QLTableRow&, QLValue* temp)> Operand;
+
+  Predicate Compile(const QLConditionPB& condition);
+  Operand CompileOperand(const QLExpressionPB& expr);
+
+  template <class Compare>
+  Predicate CompileRelation(const QLConditionPB& condition, const Compare& compare);
+  Predicate CompileIn(const QLConditionPB& condition, bool in);
+
+  QLExprExecutor* const executor_;
+  Predicate predicate_;
+};
+
 } // namespace yb
 
 #endif // YB_COMMON_QL_EXPR_H_
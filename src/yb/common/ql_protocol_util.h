@@ -68,11 +68,11 @@ void QLAddNullColumnValue(QLWriteRequestPB* req, int column_id);
 
 template <class RequestPB>
 void QLSetHashCode(RequestPB* req) {
-  std::string tmp;
+  YBPartition::HashBuilder hasher;
   for (const auto& column : req->hashed_column_values()) {
-    AppendToKey(column.value(), &tmp);
+    AppendToKey(column.value(), &hasher);
   }
-  req->set_hash_code(YBPartition::HashColumnCompoundValue(tmp));
+  req->set_hash_code(hasher.Finish());
 }
 
 QLValuePB* QLPrepareColumn(QLWriteRequestPB* req, int column_id);
@@ -14,6 +14,8 @@
 #ifndef YB_COMMON_QL_ROWWISE_ITERATOR_INTERFACE_H
 #define YB_COMMON_QL_ROWWISE_ITERATOR_INTERFACE_H
 
+#include <vector>
+
 #include "yb/common/ql_rowblock.h"
 #include "yb/common/ql_resultset.h"
 #include "yb/common/ql_scanspec.h"
@@ -45,6 +47,18 @@ class QLRowwiseIteratorIf {
     return DoNextRow(schema(), table_row);
   }
 
+  // Read up to max_rows next rows using the specified projection. Rows already present in
+  // table_rows are cleared and reused, so that their column maps are not reallocated for every
+  // batch. The batch ends early at the end of the scan or when IsNextStaticColumn() changes, so
+  // static and non-static rows are never mixed in one batch. Sets *num_rows to the number of rows
+  // read.
+  CHECKED_STATUS NextRowBatch(const Schema& projection,
+                              size_t max_rows,
+                              std::vector<QLTableRow>* table_rows,
+                              size_t* num_rows) {
+    return DoNextRowBatch(projection, max_rows, table_rows, num_rows);
+  }
+
   // Skip the current row.
   virtual void SkipRow() = 0;
 
@@ -63,6 +77,30 @@ class QLRowwiseIteratorIf {
 
  private:
   virtual CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) = 0;
+
+  virtual CHECKED_STATUS DoNextRowBatch(const Schema& projection,
+                                        size_t max_rows,
+                                        std::vector<QLTableRow>* table_rows,
+                                        size_t* num_rows) {
+    *num_rows = 0;
+    bool batch_is_static = false;
+    while (*num_rows < max_rows && HasNext()) {
+      const bool next_is_static = IsNextStaticColumn();
+      if (*num_rows == 0) {
+        batch_is_static = next_is_static;
+      } else if (next_is_static != batch_is_static) {
+        break;
+      }
+      if (table_rows->size() <= *num_rows) {
+        table_rows->emplace_back();
+      }
+      QLTableRow& table_row = (*table_rows)[*num_rows];
+      table_row.Clear();
+      RETURN_NOT_OK(DoNextRow(projection, &table_row));
+      ++*num_rows;
+    }
+    return Status::OK();
+  }
 };
 
 }  // namespace common
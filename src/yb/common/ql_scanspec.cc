@@ -137,13 +137,26 @@ QLScanRange::QLScanRange(const Schema& schema, const QLConditionPB& condition)
     case QL_OP_IN: {
       if (has_range_column) {
         QL_GET_COLUMN_VALUE_EXPR_ELSE_RETURN(col_expr, val_expr);
-        // - <column> IN (<value>) --> min/max values = <value>
-        // TODO(Mihnea) handle the other cases here too
-        if (val_expr->value().list_value().elems_size() == 1) {
-          QLValuePB value = val_expr->value().list_value().elems(0);
+        // - <column> IN (<values>) --> min/max values = min/max of <values>
+        const auto& elems = val_expr->value().list_value().elems();
+        const QLValuePB* min_value = nullptr;
+        const QLValuePB* max_value = nullptr;
+        for (const auto& elem : elems) {
+          if (IsNull(elem)) {
+            // A null never matches, but keep the range unbounded to stay on the safe side.
+            return;
+          }
+          if (min_value == nullptr || elem < *min_value) {
+            min_value = &elem;
+          }
+          if (max_value == nullptr || *max_value < elem) {
+            max_value = &elem;
+          }
+        }
+        if (min_value != nullptr) {
           const ColumnId column_id(col_expr->column_id());
-          ranges_.at(column_id).min_value = value;
-          ranges_.at(column_id).max_value = value;
+          ranges_.at(column_id).min_value = *min_value;
+          ranges_.at(column_id).max_value = *max_value;
         }
       }
       return;
@@ -298,12 +311,15 @@ QLScanSpec::QLScanSpec(const QLConditionPB* condition,
   if (executor_ == nullptr) {
     executor_ = std::make_shared<QLExprExecutor>();
   }
+  if (condition_ != nullptr) {
+    compiled_condition_ = std::make_unique<QLCompiledCondition>(*condition_, executor_.get());
+  }
 }
 
 // Evaluate the WHERE condition for the given row.
 CHECKED_STATUS QLScanSpec::Match(const QLTableRow& table_row, bool* match) const {
   if (condition_ != nullptr) {
-    return executor_->EvalCondition(*condition_, table_row, match);
+    return compiled_condition_->Eval(table_row, match);
   }
   *match = true;
   return Status::OK();
@@ -17,6 +17,7 @@
 #define YB_COMMON_QL_SCANSPEC_H
 
 #include <map>
+#include <memory>
 
 #include "yb/common/schema.h"
 #include "yb/common/ql_protocol.pb.h"
@@ -83,6 +84,9 @@ class QLScanSpec {
   const QLConditionPB* condition_;
   const bool is_forward_scan_;
   QLExprExecutor::SharedPtr executor_;
+
+  // The WHERE condition compiled once for all the rows scanned.
+  std::unique_ptr<QLCompiledCondition> compiled_condition_;
 };
 
 } // namespace common
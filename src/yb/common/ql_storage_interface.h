@@ -45,6 +45,21 @@ class QLStorageIf {
                                          std::unique_ptr<common::QLScanSpec>* spec,
                                          std::unique_ptr<common::QLScanSpec>* static_row_spec,
                                          ReadHybridTime* req_read_time) const = 0;
+
+  // Returns the iterator that an earlier read left positioned at the paging state of the request,
+  // if the storage kept it, so the scan continues without seeking again. The iterator is already
+  // initialized. Returns nullptr otherwise.
+  virtual std::unique_ptr<QLRowwiseIteratorIf> TakeCachedIterator(
+      const QLReadRequestPB& request) const {
+    return nullptr;
+  }
+
+  // Offers the iterator of a read that returned a paging state for the read of the next page. The
+  // iterator must own its projection.
+  virtual void CacheIterator(const QLReadRequestPB& request,
+                             const QLResponsePB& response,
+                             std::unique_ptr<QLRowwiseIteratorIf> iter) const {
+  }
 };
 
 }  // namespace common
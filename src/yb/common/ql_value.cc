@@ -128,10 +128,13 @@ int QLValue::CompareTo(const QLValue& other) const {
   return 0;
 }
 
+namespace {
+
 // TODO(mihnea) After the hash changes, this method does not do the key encoding anymore
 // (not needed for hash computation), so AppendToBytes() is better describes what this method does.
 // The internal methods such as AppendIntToKey should be renamed accordingly.
-void AppendToKey(const QLValuePB &value_pb, string *bytes) {
+template <class Buffer>
+void DoAppendToKey(const QLValuePB &value_pb, Buffer *bytes) {
   switch (value_pb.value_case()) {
     case QLValue::InternalType::kInt8Value: {
       YBPartition::AppendIntToKey<int8, uint8>(value_pb.int8_value(), bytes);
@@ -200,7 +203,7 @@ void AppendToKey(const QLValuePB &value_pb, string *bytes) {
     }
     case QLValue::InternalType::kFrozenValue: {
       for (const auto& elem_pb : value_pb.frozen_value().elems()) {
-        AppendToKey(elem_pb, bytes);
+        DoAppendToKey(elem_pb, bytes);
       }
       break;
     }
@@ -215,6 +218,16 @@ void AppendToKey(const QLValuePB &value_pb, string *bytes) {
   }
 }
 
+} // namespace
+
+void AppendToKey(const QLValuePB &value_pb, string *bytes) {
+  DoAppendToKey(value_pb, bytes);
+}
+
+void AppendToKey(const QLValuePB &value_pb, YBPartition::HashBuilder *hasher) {
+  DoAppendToKey(value_pb, hasher);
+}
+
 void QLValue::Serialize(
     const std::shared_ptr<QLType>& ql_type, const QLClient& client, faststring* buffer) const {
   CHECK_EQ(client, YQL_CLIENT_CQL);
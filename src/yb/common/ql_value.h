@@ -31,6 +31,8 @@ namespace yb {
 
 //--------------------------------------------------------------------------------------------------
 void AppendToKey(const QLValuePB &value_pb, std::string *bytes);
+// Hashes the same bytes as the above appends, for computing the hash code of a row directly.
+void AppendToKey(const QLValuePB &value_pb, YBPartition::HashBuilder *hasher);
 
 //--------------------------------------------------------------------------------------------------
 // An abstract class that defines a QL value interface to support different implementations
@@ -40,6 +40,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include <glog/logging.h>
 
 #include "yb/common/ql_type.h"
@@ -358,6 +360,8 @@ class TableProperties {
     contain_counters_ = other.contain_counters_;
     is_transactional_ = other.is_transactional_;
     copartition_table_id_ = other.copartition_table_id_;
+    cache_priority_ = other.cache_priority_;
+    in_memory_ = other.in_memory_;
   }
 
   // Containing counters is a internal property instead of a user-defined property, so we don't use
@@ -410,6 +414,30 @@ class TableProperties {
     copartition_table_id_ = copartition_table_id;
   }
 
+  bool HasCachePriority() const {
+    return cache_priority_.is_initialized();
+  }
+
+  CachePriority cache_priority() const {
+    return cache_priority_.get_value_or(NORMAL_CACHE_PRIORITY);
+  }
+
+  void SetCachePriority(CachePriority cache_priority) {
+    cache_priority_ = cache_priority;
+  }
+
+  bool HasInMemory() const {
+    return in_memory_.is_initialized();
+  }
+
+  bool in_memory() const {
+    return in_memory_.get_value_or(false);
+  }
+
+  void SetInMemory(bool in_memory) {
+    in_memory_ = in_memory;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const {
     if (HasDefaultTimeToLive()) {
       pb->set_default_time_to_live(default_time_to_live_);
@@ -419,6 +447,13 @@ class TableProperties {
     if (HasCopartitionTableId()) {
       pb->set_copartition_table_id(copartition_table_id_);
     }
+    // Only set when specified, so that altering other properties keeps the current priority.
+    if (HasCachePriority()) {
+      pb->set_cache_priority(*cache_priority_);
+    }
+    if (HasInMemory()) {
+      pb->set_in_memory(*in_memory_);
+    }
   }
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -435,6 +470,12 @@ class TableProperties {
     if (pb.has_copartition_table_id()) {
       table_properties.SetCopartitionTableId(pb.copartition_table_id());
     }
+    if (pb.has_cache_priority()) {
+      table_properties.SetCachePriority(pb.cache_priority());
+    }
+    if (pb.has_in_memory()) {
+      table_properties.SetInMemory(pb.in_memory());
+    }
     return table_properties;
   }
 
@@ -448,6 +489,12 @@ class TableProperties {
     if (pb.has_copartition_table_id()) {
       SetCopartitionTableId(pb.copartition_table_id());
     }
+    if (pb.has_cache_priority()) {
+      SetCachePriority(pb.cache_priority());
+    }
+    if (pb.has_in_memory()) {
+      SetInMemory(pb.in_memory());
+    }
   }
 
   void Reset() {
@@ -455,6 +502,8 @@ class TableProperties {
     contain_counters_ = false;
     is_transactional_ = false;
     copartition_table_id_ = kNoCopartitionTableId;
+    cache_priority_ = boost::none;
+    in_memory_ = boost::none;
   }
 
  private:
@@ -463,6 +512,8 @@ class TableProperties {
   bool contain_counters_;
   bool is_transactional_;
   TableId copartition_table_id_;
+  boost::optional<CachePriority> cache_priority_;
+  boost::optional<bool> in_memory_;
 };
 
 // The schema for a set of rows.
@@ -55,6 +55,15 @@ static constexpr auto kCachingKeys = "keys";
 static constexpr auto kCachingRowsPerPartition = "rows_per_partition";
 static constexpr auto kCachingAll = "ALL";
 static constexpr auto kCachingNone = "NONE";
+static constexpr auto kCachingPriority = "priority";
+static constexpr auto kCachingInMemory = "in_memory";
+
+// Values of the caching 'priority' sub-option, mapped to the CachePriority of the table.
+static const std::map<std::string, CachePriority> kCachingPriorityValues = {
+    {"normal", NORMAL_CACHE_PRIORITY},
+    {"high", HIGH_CACHE_PRIORITY},
+    {"low", LOW_CACHE_PRIORITY},
+};
 
 inline static bool IsValidCachingKeysString(const std::string& str) {
   std::string upper_str;
@@ -70,6 +79,17 @@ inline static bool IsValidCachingRowsPerPartitionInt(const int64_t val) {
   return val <= std::numeric_limits<int32_t>::max();
 }
 
+inline static bool ParseCachingPriorityString(const std::string& str, CachePriority* priority) {
+  std::string lower_str;
+  ToLowerCase(str, &lower_str);
+  auto it = kCachingPriorityValues.find(lower_str);
+  if (it == kCachingPriorityValues.end()) {
+    return false;
+  }
+  *priority = it->second;
+  return true;
+}
+
 }  // namespace common
 }  // namespace yb
 
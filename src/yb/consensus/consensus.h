@@ -349,6 +349,15 @@ class Consensus : public RefCountedThreadSafe<Consensus> {
     return STATUS(NotFound, "Not implemented.");
   }
 
+  // Reads the committed ops that follow the op with index 'after_op_index', up to about
+  // 'max_size_bytes' of them, from the log cache when they are still there and from the log
+  // otherwise. Used for change data capture.
+  virtual CHECKED_STATUS ReadCommittedReplicates(int64_t after_op_index,
+                                                 int max_size_bytes,
+                                                 ReplicateMsgs* messages) {
+    return STATUS(NotSupported, "Not implemented.");
+  }
+
   // Assuming we are the leader, wait until we have a valid leader lease (i.e. the old leader's
   // lease has expired, and we have replicated a new lease that has not expired yet).
   virtual CHECKED_STATUS WaitForLeaderLeaseImprecise(MonoTime deadline) = 0;
@@ -64,6 +64,7 @@ DEFINE_int32(consensus_rpc_timeout_ms, 2000,
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_bool(enable_multi_raft_heartbeat_batcher);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -265,16 +266,29 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
   controller_.Reset();
 
+  // Heartbeats of idle tablets could be sent together with the heartbeats of other tablets to the
+  // same server.
+  if (!req_has_ops &&
+      proxy_->BatchedHeartbeatAsync(
+          &request_, &response_,
+          std::bind(&Peer::ProcessResponseWithStatus, this, std::placeholders::_1))) {
+    return;
+  }
+
   proxy_->UpdateAsync(&request_, &response_, &controller_, std::bind(&Peer::ProcessResponse, this));
 }
 
 void Peer::ProcessResponse() {
+  ProcessResponseWithStatus(controller_.status());
+}
+
+void Peer::ProcessResponseWithStatus(const Status& status) {
   // Note: This method runs on the reactor thread.
 
   DCHECK_LE(sem_.GetValue(), 0) << "Got a response when nothing was pending";
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  if (!status.ok()) {
+    if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -282,7 +296,7 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
+    ProcessResponseError(status);
     return;
   }
 
@@ -404,9 +418,11 @@ Peer::~Peer() {
 }
 
 RpcPeerProxy::RpcPeerProxy(gscoped_ptr<HostPort> hostport,
-                           gscoped_ptr<ConsensusServiceProxy> consensus_proxy)
+                           gscoped_ptr<ConsensusServiceProxy> consensus_proxy,
+                           MultiRaftHeartbeatBatcherPtr heartbeat_batcher)
     : hostport_(hostport.Pass()),
-      consensus_proxy_(consensus_proxy.Pass()) {
+      consensus_proxy_(consensus_proxy.Pass()),
+      heartbeat_batcher_(std::move(heartbeat_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -417,6 +433,16 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+bool RpcPeerProxy::BatchedHeartbeatAsync(const ConsensusRequestPB* request,
+                                         ConsensusResponsePB* response,
+                                         const MultiRaftHeartbeatCallback& callback) {
+  if (!heartbeat_batcher_ || !FLAGS_enable_multi_raft_heartbeat_batcher) {
+    return false;
+  }
+  heartbeat_batcher_->AddRequestToBatch(*request, response, callback);
+  return true;
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -466,8 +492,10 @@ Status CreateConsensusServiceProxyForHost(const shared_ptr<Messenger>& messenger
 
 } // anonymous namespace
 
-RpcPeerProxyFactory::RpcPeerProxyFactory(shared_ptr<Messenger> messenger)
-    : messenger_(std::move(messenger)) {}
+RpcPeerProxyFactory::RpcPeerProxyFactory(shared_ptr<Messenger> messenger,
+                                         MultiRaftManager* multi_raft_manager)
+    : messenger_(std::move(messenger)),
+      multi_raft_manager_(multi_raft_manager) {}
 
 Status RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb,
                                      gscoped_ptr<PeerProxy>* proxy) {
@@ -475,7 +503,15 @@ Status RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb,
   RETURN_NOT_OK(HostPortFromPB(peer_pb.last_known_addr(), hostport.get()));
   gscoped_ptr<ConsensusServiceProxy> new_proxy;
   RETURN_NOT_OK(CreateConsensusServiceProxyForHost(messenger_, *hostport, &new_proxy));
-  proxy->reset(new RpcPeerProxy(hostport.Pass(), new_proxy.Pass()));
+  MultiRaftHeartbeatBatcherPtr heartbeat_batcher;
+  if (multi_raft_manager_) {
+    auto batcher = multi_raft_manager_->AddOrGetBatcher(peer_pb);
+    if (!batcher.ok()) {
+      return batcher.status();
+    }
+    heartbeat_batcher = std::move(*batcher);
+  }
+  proxy->reset(new RpcPeerProxy(hostport.Pass(), new_proxy.Pass(), std::move(heartbeat_batcher)));
   return Status::OK();
 }
 
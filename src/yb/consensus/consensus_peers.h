@@ -42,6 +42,7 @@
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/ref_counted_replicate.h"
 #include "yb/consensus/consensus_util.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/rpc/response_callback.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/util/countdown_latch.h"
@@ -173,6 +174,10 @@ class Peer {
   // lock-taking.
   void ProcessResponse();
 
+  // Same as ProcessResponse(), with the status of the RPC that carried the request, which is not
+  // controller_ for batched heartbeats.
+  void ProcessResponseWithStatus(const Status& status);
+
   // Run on 'raft_pool_token'. Does response handling that requires IO or may block.
   void DoProcessResponse();
 
@@ -255,6 +260,15 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a status-only request to a remote peer, as a part of one RPC carrying the requests of
+  // several tablets to the same server. Returns false if heartbeat batching is not supported or
+  // disabled, in which case the request should be sent with UpdateAsync().
+  virtual bool BatchedHeartbeatAsync(const ConsensusRequestPB* request,
+                                     ConsensusResponsePB* response,
+                                     const MultiRaftHeartbeatCallback& callback) {
+    return false;
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
@@ -302,13 +316,18 @@ class PeerProxyFactory {
 class RpcPeerProxy : public PeerProxy {
  public:
   RpcPeerProxy(gscoped_ptr<HostPort> hostport,
-               gscoped_ptr<ConsensusServiceProxy> consensus_proxy);
+               gscoped_ptr<ConsensusServiceProxy> consensus_proxy,
+               MultiRaftHeartbeatBatcherPtr heartbeat_batcher);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            ConsensusResponsePB* response,
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  virtual bool BatchedHeartbeatAsync(const ConsensusRequestPB* request,
+                                     ConsensusResponsePB* response,
+                                     const MultiRaftHeartbeatCallback& callback) override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
@@ -334,12 +353,17 @@ class RpcPeerProxy : public PeerProxy {
  private:
   gscoped_ptr<HostPort> hostport_;
   gscoped_ptr<ConsensusServiceProxy> consensus_proxy_;
+  // Shared by the proxies of all tablets to the same remote server, null if batching is not used.
+  MultiRaftHeartbeatBatcherPtr heartbeat_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
-  explicit RpcPeerProxyFactory(std::shared_ptr<rpc::Messenger> messenger);
+  // 'multi_raft_manager' provides the heartbeat batchers, it could be null to send every
+  // heartbeat as a separate RPC. It is not owned and must outlive the factory.
+  RpcPeerProxyFactory(std::shared_ptr<rpc::Messenger> messenger,
+                      MultiRaftManager* multi_raft_manager);
 
   virtual CHECKED_STATUS NewProxy(const RaftPeerPB& peer_pb,
                           gscoped_ptr<PeerProxy>* proxy) override;
@@ -347,6 +371,7 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   virtual ~RpcPeerProxyFactory();
  private:
   std::shared_ptr<rpc::Messenger> messenger_;
+  MultiRaftManager* const multi_raft_manager_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
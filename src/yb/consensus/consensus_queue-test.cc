@@ -51,6 +51,8 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(log_min_seconds_to_retain);
+DECLARE_int32(log_min_segments_to_retain);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -541,6 +543,50 @@ TEST_F(ConsensusQueueTest, TestQueueLoadsOperationsForPeer) {
   request.mutable_ops()->ExtractSubrange(0, request.ops().size(), nullptr);
 }
 
+// A peer that lags behind the logs garbage collected by the leader is remotely bootstrapped.
+TEST_F(ConsensusQueueTest, TestRemoteBootstrapsPeerBehindLogGC) {
+  FLAGS_log_min_seconds_to_retain = 0;
+  FLAGS_log_min_segments_to_retain = 1;
+
+  OpId opid = MakeOpId(1, 1);
+  for (int i = 1; i <= 100; i++) {
+    ASSERT_OK(log::AppendNoOpToLogSync(clock_, log_.get(), &opid));
+    if (i % 10 == 0) {
+      ASSERT_OK(log_->AllocateSegmentAndRollOver());
+    }
+  }
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  int num_gced = 0;
+  ASSERT_OK(log_->GC(80, &num_gced));
+  ASSERT_GT(num_gced, 0);
+
+  CloseAndReopenQueue();
+  OpId committed_index = MakeOpId(1, 100);
+  queue_->Init(committed_index);
+  queue_->SetLeaderMode(committed_index, committed_index.term(), BuildRaftConfigPBForTests(3));
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+  ASSERT_NO_FATALS(UpdatePeerWatermarkToOp(&request,
+                                           &response,
+                                           MakeOpId(1, 50),
+                                           MinimumOpId(),
+                                           &more_pending));
+  ASSERT_TRUE(more_pending);
+
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap = false;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(needs_remote_bootstrap);
+  ASSERT_EQ(0, request.ops_size());
+
+  StartRemoteBootstrapRequestPB rb_request;
+  ASSERT_OK(queue_->GetRemoteBootstrapRequestForPeer(kPeerUuid, &rb_request));
+  ASSERT_TRUE(rb_request.replace_lagging_replica());
+}
+
 // This tests that the queue is able to handle operation overwriting, i.e. when a
 // newly tracked peer reports the last received operations as some operation that
 // doesn't exist in the leader's log. In particular it tests the case where a
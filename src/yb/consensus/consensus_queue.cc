@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -96,6 +97,12 @@ DECLARE_int32(rpc_max_message_size);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DEFINE_bool(remote_bootstrap_lagging_followers, true,
+            "Whether a follower that lags behind the logs garbage collected by the leader is "
+            "remotely bootstrapped from the leader, instead of being failed and evicted.");
+TAG_FLAG(remote_bootstrap_lagging_followers, advanced);
+TAG_FLAG(remote_bootstrap_lagging_followers, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -398,6 +405,18 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       if (PREDICT_TRUE(s.IsNotFound())) {
         // It's normal to have a NotFound() here if a follower falls behind where
         // the leader has GCed its logs.
+        if (FLAGS_remote_bootstrap_lagging_followers) {
+          // The data of the missing ops is in the flushed SST files, so the follower catches up
+          // from a copy of them and then from the log.
+          LOG_WITH_PREFIX_UNLOCKED(INFO)
+              << "The logs necessary to catch up peer " << uuid << " have been garbage "
+              << "collected, it will be remotely bootstrapped: " << s;
+          LockGuard lock(queue_lock_);
+          peer->needs_remote_bootstrap = true;
+          peer->lagging_behind_log_gc = true;
+          *needs_remote_bootstrap = true;
+          return Status::OK();
+        }
         string msg = Substitute("The logs necessary to catch up peer $0 have been "
                                 "garbage collected. The follower will never be able "
                                 "to catch up ($1)", uuid, s.ToString());
@@ -475,7 +494,9 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
   req->set_bootstrap_peer_uuid(local_peer_uuid_);
   *req->mutable_bootstrap_peer_addr() = local_peer_pb_.last_known_addr();
   req->set_caller_term(queue_state_.current_term);
+  req->set_replace_lagging_replica(peer->lagging_behind_log_gc);
   peer->needs_remote_bootstrap = false; // Now reset the flag.
+  peer->lagging_behind_log_gc = false;
   return Status::OK();
 }
 
@@ -913,6 +934,17 @@ void PeerMessageQueue::ClearUnlocked() {
   queue_state_.state = State::kQueueClosed;
 }
 
+Status PeerMessageQueue::ReadOps(int64_t after_op_index,
+                                 int max_size_bytes,
+                                 ReplicateMsgs* messages) {
+  OpId preceding_op;
+  return log_cache_.ReadOps(after_op_index, max_size_bytes, messages, &preceding_op);
+}
+
+void PeerMessageQueue::EvictLogCache() {
+  log_cache_.EvictThroughOp(std::numeric_limits<int64_t>::max());
+}
+
 void PeerMessageQueue::Close() {
   raft_pool_observers_token_->Shutdown();
   LockGuard lock(queue_lock_);
@@ -86,6 +86,12 @@ extern const char kConsensusQueueParentTrackerId[];
 //
 // TODO Currently this class is able to track one outstanding operation per peer. If we want to have
 // more than one outstanding RPC we need to modify it.
+// Note that a single outstanding request does not limit replication throughput to one batch per
+// round trip of ops appended at a time: all ops appended while a request is in flight are sent in
+// the next request, up to consensus_max_batch_size_bytes. Pipelining would need next_index to be
+// advanced when a request is sent rather than when it is acknowledged, handling of out of order
+// and failed responses, in particular LMP mismatch, and followers that process Update requests
+// in order they were sent.
 class PeerMessageQueue {
  public:
   struct TrackedPeer {
@@ -148,6 +154,9 @@ class PeerMessageQueue {
     // Whether the follower was detected to need remote bootstrap.
     bool needs_remote_bootstrap = false;
 
+    // Whether it needs it because the logs it is missing were garbage collected.
+    bool lagging_behind_log_gc = false;
+
     // Member type of this peer in the config.
     RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
 
@@ -256,6 +265,14 @@ class PeerMessageQueue {
                                 const ConsensusResponsePB& response,
                                 bool* more_pending);
 
+  // Reads the ops that follow the op with index 'after_op_index' through the log cache, see
+  // LogCache::ReadOps().
+  CHECKED_STATUS ReadOps(int64_t after_op_index, int max_size_bytes, ReplicateMsgs* messages);
+
+  // Evicts all the ops that are already in the log from the log cache, e.g. of an idle tablet.
+  // Peers that still need them read them back from the log.
+  void EvictLogCache();
+
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
   virtual void Close();
@@ -52,6 +52,8 @@ DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
 DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(log_group_commit_window_usec);
+DECLARE_bool(log_compress_entry_batches);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
@@ -207,6 +209,48 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+// Tests that a segment with both compressed and uncompressed entry batches is read back.
+TEST_F(LogTest, TestCompressedEntryBatches) {
+  google::FlagSaver flag_saver;
+  constexpr int kBatchSize = 50;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+
+  int64_t start_offset = log_->active_segment_->written_offset();
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, kBatchSize));
+  int64_t uncompressed_size = log_->active_segment_->written_offset() - start_offset;
+
+  FLAGS_log_compress_entry_batches = true;
+  start_offset = log_->active_segment_->written_offset();
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, kBatchSize));
+  int64_t compressed_size = log_->active_segment_->written_offset() - start_offset;
+  ASSERT_LT(compressed_size, uncompressed_size);
+
+  FLAGS_log_compress_entry_batches = false;
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, kBatchSize));
+
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  LogEntries entries;
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_OK(segments[0]->ReadEntries(&entries));
+  ASSERT_EQ(3 * kBatchSize, entries.size());
+  for (int i = 0; i != entries.size(); ++i) {
+    ASSERT_EQ(i + 1, entries[i]->replicate().id().index());
+  }
+
+  // Compressed batch should also be readable using the log index.
+  OpId loaded_op;
+  ASSERT_OK(log_->GetLogReader()->LookupOpId(kBatchSize + 1, &loaded_op));
+  ASSERT_EQ(kBatchSize + 1, loaded_op.index());
+
+  ASSERT_OK(log_->Close());
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
@@ -222,6 +266,29 @@ TEST_F(LogTest, TestFsync) {
   ASSERT_OK(log_->Close());
 }
 
+// Tests that entries are appended when fsync waits for more entry batches to arrive.
+TEST_F(LogTest, TestFsyncGroupCommitWindow) {
+  google::FlagSaver flag_saver;
+  FLAGS_log_group_commit_window_usec = 1000;
+  options_.durable_wal_write = true;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(0);
+  opid.set_index(1);
+
+  ASSERT_OK(AppendNoOps(&opid, 10));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  LogEntries entries;
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_OK(segments[0]->ReadEntries(&entries));
+  ASSERT_EQ(10, entries.size());
+
+  ASSERT_OK(log_->Close());
+}
+
 // Tests interval for durable wal write
 TEST_F(LogTest, TestFsyncInterval) {
   options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
@@ -96,6 +96,14 @@ DEFINE_int32(group_commit_queue_size_bytes, 4_MB,
              "Maximum size of the group commit queue in bytes");
 TAG_FLAG(group_commit_queue_size_bytes, advanced);
 
+DEFINE_int32(log_group_commit_window_usec, 0,
+             "When durable_wal_write is turned on, the maximum number of microseconds the log "
+             "append thread waits for more entry batches after the first one, so that a single "
+             "fsync covers all of them. The actual wait adapts to recent fsync latency and "
+             "entry batch arrival rate. Zero disables waiting.");
+TAG_FLAG(log_group_commit_window_usec, runtime);
+TAG_FLAG(log_group_commit_window_usec, advanced);
+
 // Fault/latency injection flags.
 // -----------------------------
 DEFINE_bool(log_inject_latency, false,
@@ -153,8 +161,19 @@ class Log::AppendThread {
  private:
   void RunThread();
 
+  // Returns how long to wait for more entry batches before syncing the log.
+  MonoDelta GroupCommitWindow() const;
+
+  // Updates the moving averages used to calculate the group commit window.
+  void UpdateGroupCommitStats(size_t num_batches, MonoDelta sync_latency);
+
   Log* const log_;
 
+  // Moving averages of fsync latency and of interval between arrivals of entry batches.
+  double avg_sync_usec_ = 0;
+  double avg_arrival_interval_usec_ = 0;
+  MonoTime last_drain_time_;
+
   // Lock to protect access to thread_ during shutdown.
   mutable std::mutex lock_;
   scoped_refptr<Thread> thread_;
@@ -196,6 +215,21 @@ void Log::AppendThread::RunThread() {
       shutting_down = true;
     }
 
+    auto group_commit_window = GroupCommitWindow();
+    if (!shutting_down && group_commit_window && !entry_batches.empty()) {
+      auto wait_start = MonoTime::Now();
+      auto group_commit_deadline = wait_start + group_commit_window;
+      while (!shutting_down && MonoTime::Now() < group_commit_deadline) {
+        if (!log_->entry_queue()->BlockingDrainTo(&entry_batches, group_commit_deadline)) {
+          shutting_down = true;
+        }
+      }
+      if (log_->metrics_) {
+        log_->metrics_->group_commit_wait->Increment(
+            MonoTime::Now().GetDeltaSince(wait_start).ToMicroseconds());
+      }
+    }
+
     auto sleep_duration = log_->sleep_duration_.load(std::memory_order_acquire);
     if (sleep_duration.count() > 0) {
       std::this_thread::sleep_for(sleep_duration);
@@ -227,10 +261,13 @@ void Log::AppendThread::RunThread() {
           log_->periodic_sync_earliest_unsync_entry_time_ = MonoTime::Now();
         }
         log_->periodic_sync_unsynced_bytes_ += entry_batch->total_size_bytes();
+        ++log_->unsynced_entry_batches_;
       }
     }
 
+    auto sync_start = MonoTime::Now();
     Status s = log_->Sync();
+    UpdateGroupCommitStats(entry_batches.size(), MonoTime::Now().GetDeltaSince(sync_start));
     if (PREDICT_FALSE(!s.ok())) {
       LOG(ERROR) << "Error syncing log" << s.ToString();
       DLOG(FATAL) << "Aborting: " << s.ToString();
@@ -257,6 +294,39 @@ void Log::AppendThread::RunThread() {
   VLOG(1) << "Exiting AppendThread for tablet " << log_->tablet_id();
 }
 
+MonoDelta Log::AppendThread::GroupCommitWindow() const {
+  auto max_window_usec = FLAGS_log_group_commit_window_usec;
+  if (!log_->durable_wal_write_ || max_window_usec <= 0) {
+    return MonoDelta();
+  }
+  // Waiting only pays off when at least one more batch is expected to arrive while we wait.
+  // We wait at most half of fsync latency, so the latency of the batches that are already
+  // in the group increases by at most 50%.
+  auto window_usec = avg_sync_usec_ / 2;
+  if (window_usec < 1 || window_usec < avg_arrival_interval_usec_) {
+    return MonoDelta();
+  }
+  return MonoDelta::FromMicroseconds(
+      std::min<int64_t>(static_cast<int64_t>(window_usec), max_window_usec));
+}
+
+void Log::AppendThread::UpdateGroupCommitStats(size_t num_batches, MonoDelta sync_latency) {
+  // Weight of the most recent sample in moving averages.
+  constexpr double kWeight = 0.125;
+
+  auto now = MonoTime::Now();
+  if (num_batches != 0 && last_drain_time_.Initialized()) {
+    double arrival_interval_usec =
+        now.GetDeltaSince(last_drain_time_).ToMicroseconds() / static_cast<double>(num_batches);
+    avg_arrival_interval_usec_ +=
+        (arrival_interval_usec - avg_arrival_interval_usec_) * kWeight;
+  }
+  last_drain_time_ = now;
+  if (log_->durable_wal_write_) {
+    avg_sync_usec_ += (sync_latency.ToMicroseconds() - avg_sync_usec_) * kWeight;
+  }
+}
+
 void Log::AppendThread::Shutdown() {
   log_->entry_queue()->Shutdown();
   std::lock_guard<std::mutex> lock_guard(lock_);
@@ -634,6 +704,10 @@ Status Log::Sync() {
     if (durable_wal_write_ || timed_or_data_limit_sync) {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
+      if (metrics_) {
+        metrics_->entry_batches_per_sync->Increment(unsynced_entry_batches_);
+      }
+      unsynced_entry_batches_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
         RETURN_NOT_OK(active_segment_->Sync());
 
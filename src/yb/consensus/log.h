@@ -252,6 +252,7 @@ class Log : public RefCountedThreadSafe<Log> {
   friend class LogTest;
   friend class LogTestBase;
   FRIEND_TEST(LogTest, TestMultipleEntriesInABatch);
+  FRIEND_TEST(LogTest, TestCompressedEntryBatches);
   FRIEND_TEST(LogTest, TestReadLogWithReplacedReplicates);
   FRIEND_TEST(LogTest, TestWriteAndReadToAndFromInProgressSegment);
 
@@ -423,6 +424,9 @@ class Log : public RefCountedThreadSafe<Log> {
   // For periodic sync, indicates number of bytes which need to be sync'ed.
   size_t periodic_sync_unsynced_bytes_ = 0;
 
+  // Number of entry batches appended since the last fsync.
+  size_t unsynced_entry_batches_ = 0;
+
   // If true, ignore the 'durable_wal_write_' flags above.  This is used to disable fsync during
   // bootstrap.
   bool sync_disabled_;
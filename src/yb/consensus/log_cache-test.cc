@@ -51,6 +51,7 @@ using std::shared_ptr;
 
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
+DECLARE_int32(log_cache_compressed_size_limit_mb);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -303,6 +304,48 @@ TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   ASSERT_LE(cache_->BytesUsed(), 1024 * 1024);
 }
 
+// Test that the ops evicted because of the memory limit are served from the compressed tier.
+TEST_F(LogCacheTest, TestCompressedTier) {
+  FLAGS_log_cache_size_limit_mb = 1;
+  FLAGS_log_cache_compressed_size_limit_mb = 1;
+  CloseAndReopenCache(MinimumOpId());
+
+  const int kPayloadSize = 400 * 1024;
+  for (int i = 1; i <= 4; ++i) {
+    ASSERT_OK(AppendReplicateMessagesToCache(i, 1, kPayloadSize));
+    ASSERT_OK(log_->WaitUntilAllFlushed());
+  }
+  ASSERT_EQ(2, cache_->num_cached_ops());
+  ASSERT_EQ(2, cache_->metrics_.log_cache_compressed_num_ops->value());
+  // The payload is all zeros, so it is compressed well.
+  ASSERT_GT(cache_->metrics_.log_cache_compressed_size->value(), 0);
+  ASSERT_LT(cache_->metrics_.log_cache_compressed_size->value(), 100 * 1024);
+  ASSERT_EQ(cache_->metrics_.log_cache_compressed_size->value(),
+            cache_->compressed_tracker_->consumption());
+
+  ReplicateMsgs messages;
+  OpId preceding;
+  ASSERT_OK(cache_->ReadOps(0, 8 * 1024 * 1024, &messages, &preceding));
+  ASSERT_EQ(4, messages.size());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i + 1, messages[i]->id().index());
+    EXPECT_EQ(kPayloadSize, messages[i]->noop_request().payload_for_tests().size());
+  }
+  EXPECT_EQ(2, cache_->metrics_.log_cache_compressed_hits->value());
+  EXPECT_EQ(2, cache_->metrics_.log_cache_hits->value());
+  EXPECT_EQ(0, cache_->metrics_.log_cache_disk_reads->value());
+
+  // Ops replicated to all peers are dropped from both tiers.
+  cache_->EvictThroughOp(2);
+  ASSERT_EQ(0, cache_->metrics_.log_cache_compressed_num_ops->value());
+  ASSERT_EQ(0, cache_->compressed_tracker_->consumption());
+
+  messages.clear();
+  ASSERT_OK(cache_->ReadOps(0, 8 * 1024 * 1024, &messages, &preceding));
+  ASSERT_EQ(4, messages.size());
+  EXPECT_EQ(2, cache_->metrics_.log_cache_disk_reads->value());
+}
+
 // Test that the log cache properly replaces messages when an index
 // is reused. This is a regression test for a bug where the memtracker's
 // consumption wasn't properly managed when messages were replaced.
@@ -40,6 +40,7 @@
 #include <gflags/gflags.h>
 #include <google/protobuf/wire_format_lite.h>
 #include <google/protobuf/wire_format_lite_inl.h>
+#include <snappy.h>
 
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
@@ -68,6 +69,13 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_int32(log_cache_compressed_size_limit_mb, 32,
+             "The total per-tablet size of compressed consensus entries which may be kept in "
+             "memory after being evicted from the log cache because of its size limit, so that "
+             "followers which fell behind do not have to be caught up from disk. The compressed "
+             "entries also count towards 'global_log_cache_size_limit_mb'. Set to 0 to disable.");
+TAG_FLAG(log_cache_compressed_size_limit_mb, advanced);
+
 using strings::Substitute;
 
 namespace yb {
@@ -79,8 +87,27 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_num_ops, "Log Cache Operation Count"
 METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
                           MetricUnit::kBytes,
                           "Amount of memory in use for caching the local log.");
+METRIC_DEFINE_gauge_int64(tablet, log_cache_compressed_num_ops,
+                          "Log Cache Compressed Operation Count",
+                          MetricUnit::kOperations,
+                          "Number of operations in the compressed tier of the log cache.");
+METRIC_DEFINE_gauge_int64(tablet, log_cache_compressed_size, "Log Cache Compressed Memory Usage",
+                          MetricUnit::kBytes,
+                          "Amount of memory in use for the compressed tier of the log cache.");
+METRIC_DEFINE_counter(tablet, log_cache_hits, "Log Cache Hits",
+                      MetricUnit::kOperations,
+                      "Number of operations read for peers from the log cache.");
+METRIC_DEFINE_counter(tablet, log_cache_compressed_hits, "Log Cache Compressed Tier Hits",
+                      MetricUnit::kOperations,
+                      "Number of operations read for peers from the compressed tier of the log "
+                      "cache, after missing the uncompressed tier.");
+METRIC_DEFINE_counter(tablet, log_cache_disk_reads, "Log Cache Disk Reads",
+                      MetricUnit::kOperations,
+                      "Number of operations read for peers from disk, after missing both tiers "
+                      "of the log cache.");
 
 static const char kParentMemTrackerId[] = "log_cache";
+static const char kCompressedMemTrackerId[] = "log_cache_compressed";
 
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
 
@@ -110,18 +137,30 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                                      local_uuid, tablet_id),
       parent_tracker_);
 
+  // The compressed tier is also accounted against the global limit.
+  compressed_tracker_ = MemTracker::CreateTracker(
+      FLAGS_log_cache_compressed_size_limit_mb * 1024 * 1024,
+      Substitute("$0:$1:$2", kCompressedMemTrackerId, local_uuid, tablet_id),
+      parent_tracker_);
+
   // Put a fake message at index 0, since this simplifies a lot of our
   // code paths elsewhere.
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
-  InsertOrDie(&cache_, 0, zero_op);
+  auto zero_entry = MakeCacheEntry(zero_op);
+  // The special '0' op is not accounted in the MemTracker.
+  zero_entry.mem_usage = 0;
+  InsertOrDie(&cache_, 0, zero_entry);
 }
 
 LogCache::~LogCache() {
   tracker_->Release(tracker_->consumption());
   cache_.clear();
+  compressed_tracker_->Release(compressed_tracker_->consumption());
+  compressed_cache_.clear();
 
   tracker_->UnregisterFromParent();
+  compressed_tracker_->UnregisterFromParent();
   // Unregister the log cache root only if all the log caches are gone (nobody else owns it).
   parent_tracker_->UnregisterFromParentIfNoChildren();
 }
@@ -155,17 +194,20 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
     for (int64_t i = first_idx_in_batch; i < next_sequential_op_index_; ++i) {
       auto it = cache_.find(i);
       if (it != cache_.end()) {
-        ReplicateMsgPtr msg = it->second;
+        AccountForMessageRemovalUnlocked(it->second);
         cache_.erase(it);
-        AccountForMessageRemovalUnlocked(msg);
       }
     }
+    RemoveCompressedUnlocked(first_idx_in_batch, next_sequential_op_index_ - 1);
   }
 
 
+  std::vector<CacheEntry> entries;
+  entries.reserve(msgs.size());
   int64_t mem_required = 0;
   for (const auto& msg : msgs) {
-    mem_required += msg->SpaceUsed();
+    entries.push_back(MakeCacheEntry(msg));
+    mem_required += entries.back().mem_usage;
   }
 
   // Try to consume the memory. If it can't be consumed, we may need to evict.
@@ -181,7 +223,7 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
 
     // TODO: we should also try to evict from other tablets - probably better to
     // evict really old ops from another tablet than evict recent ops from this one.
-    EvictSomeUnlocked(min_pinned_op_index_, need_to_free);
+    EvictSomeUnlocked(min_pinned_op_index_, need_to_free, true /* spill */);
 
     // Force consuming, so that we don't refuse appending data. We might
     // blow past our limit a little bit (as much as the number of tablets times
@@ -192,8 +234,9 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
     borrowed_memory = parent_tracker_->LimitExceeded();
   }
 
-  for (const auto& msg : msgs) {
-    InsertOrDie(&cache_,  msg->id().index(), msg);
+  for (auto& entry : entries) {
+    auto index = entry.msg->id().index();
+    InsertOrDie(&cache_, index, std::move(entry));
   }
 
   // We drop the lock during the AsyncAppendReplicates call, since it may block
@@ -238,7 +281,7 @@ void LogCache::LogCallback(int64_t last_idx_in_batch,
     if (borrowed_memory) {
       int64_t spare_capacity = parent_tracker_->SpareCapacity();
       if (spare_capacity < 0) {
-        EvictSomeUnlocked(min_pinned_op_index_, -spare_capacity);
+        EvictSomeUnlocked(min_pinned_op_index_, -spare_capacity, true /* spill */);
       }
     }
   }
@@ -266,7 +309,12 @@ Status LogCache::LookupOpId(int64_t op_index, OpId* op_id) const {
     }
     auto iter = cache_.find(op_index);
     if (iter != cache_.end()) {
-      *op_id = iter->second->id();
+      *op_id = iter->second.msg->id();
+      return Status::OK();
+    }
+    auto compressed_iter = compressed_cache_.find(op_index);
+    if (compressed_iter != compressed_cache_.end()) {
+      *op_id = compressed_iter->second.id;
       return Status::OK();
     }
   }
@@ -304,7 +352,26 @@ Status LogCache::ReadOps(int64_t after_op_index,
     // If the messages the peer needs haven't been loaded into the queue yet,
     // load them.
     MessageCache::const_iterator iter = cache_.lower_bound(next_index);
-    if (iter == cache_.end() || iter->first != next_index) {
+    auto compressed_iter = compressed_cache_.lower_bound(next_index);
+    if ((iter == cache_.end() || iter->first != next_index) &&
+        compressed_iter != compressed_cache_.end() && compressed_iter->first == next_index) {
+      // Pull contiguous messages from the compressed tier until the size limit is achieved.
+      for (; compressed_iter != compressed_cache_.end() &&
+             compressed_iter->first == next_index; ++compressed_iter) {
+        remaining_space -= compressed_iter->second.tracked_size;
+        if (remaining_space < 0 && !messages->empty()) {
+          break;
+        }
+
+        auto msg = UncompressMessage(compressed_iter->second);
+        if (!msg.ok()) {
+          return msg.status();
+        }
+        messages->push_back(std::move(*msg));
+        metrics_.log_cache_compressed_hits->Increment();
+        next_index++;
+      }
+    } else if (iter == cache_.end() || iter->first != next_index) {
       int64_t up_to;
       if (iter == cache_.end()) {
         // Read all the way to the current op
@@ -313,6 +380,10 @@ Status LogCache::ReadOps(int64_t after_op_index,
         // Read up to the next entry that's in the cache
         up_to = iter->first - 1;
       }
+      if (compressed_iter != compressed_cache_.end()) {
+        // Or up to the next entry that's in the compressed tier.
+        up_to = std::min<int64_t>(up_to, compressed_iter->first - 1);
+      }
 
       l.unlock();
 
@@ -331,6 +402,7 @@ Status LogCache::ReadOps(int64_t after_op_index,
         remaining_space -= TotalByteSizeForMessage(*msg);
         if (remaining_space > 0 || messages->empty()) {
           messages->push_back(msg);
+          metrics_.log_cache_disk_reads->Increment();
           next_index++;
         }
       }
@@ -338,18 +410,19 @@ Status LogCache::ReadOps(int64_t after_op_index,
     } else {
       // Pull contiguous messages from the cache until the size limit is achieved.
       for (; iter != cache_.end(); ++iter) {
-        const ReplicateMsgPtr& msg = iter->second;
+        const ReplicateMsgPtr& msg = iter->second.msg;
         int64_t index = msg->id().index();
         if (index != next_index) {
           continue;
         }
 
-        remaining_space -= TotalByteSizeForMessage(*msg);
+        remaining_space -= iter->second.tracked_size;
         if (remaining_space < 0 && !messages->empty()) {
           break;
         }
 
         messages->push_back(msg);
+        metrics_.log_cache_hits->Increment();
         next_index++;
       }
     }
@@ -361,10 +434,11 @@ Status LogCache::ReadOps(int64_t after_op_index,
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
 
-  EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
+  EvictSomeUnlocked(index, MathLimits<int64_t>::kMax, false /* spill */);
+  RemoveCompressedUnlocked(0, index);
 }
 
-void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
+void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict, bool spill) {
   DCHECK(lock_.is_locked());
   VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting log cache index <= "
                       << stop_after_index
@@ -373,7 +447,7 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
 
   int64_t bytes_evicted = 0;
   for (auto iter = cache_.begin(); iter != cache_.end();) {
-    const ReplicateMsgPtr& msg = iter->second;
+    const ReplicateMsgPtr& msg = iter->second.msg;
     VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << msg->id();
     int64_t msg_index = msg->id().index();
     if (msg_index == 0) {
@@ -394,8 +468,11 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
     }
 
     VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << msg->id();
-    AccountForMessageRemovalUnlocked(msg);
-    bytes_evicted += msg->SpaceUsed();
+    if (spill) {
+      SpillToCompressedTierUnlocked(iter->second);
+    }
+    AccountForMessageRemovalUnlocked(iter->second);
+    bytes_evicted += iter->second.mem_usage;
     cache_.erase(iter++);
 
     if (bytes_evicted >= bytes_to_evict) {
@@ -405,12 +482,71 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
   VLOG_WITH_PREFIX_UNLOCKED(1) << "Evicting log cache: after state: " << ToStringUnlocked();
 }
 
-void LogCache::AccountForMessageRemovalUnlocked(const ReplicateMsgPtr& msg) {
-  tracker_->Release(msg->SpaceUsed());
-  metrics_.log_cache_size->DecrementBy(msg->SpaceUsed());
+LogCache::CacheEntry LogCache::MakeCacheEntry(ReplicateMsgPtr msg) {
+  auto mem_usage = msg->SpaceUsed();
+  auto tracked_size = TotalByteSizeForMessage(*msg);
+  return CacheEntry{std::move(msg), mem_usage, tracked_size};
+}
+
+void LogCache::AccountForMessageRemovalUnlocked(const CacheEntry& entry) {
+  tracker_->Release(entry.mem_usage);
+  metrics_.log_cache_size->DecrementBy(entry.mem_usage);
   metrics_.log_cache_num_ops->Decrement();
 }
 
+void LogCache::SpillToCompressedTierUnlocked(const CacheEntry& entry) {
+  if (compressed_tracker_->limit() <= 0) {
+    return;
+  }
+
+  std::string serialized;
+  if (!entry.msg->SerializeToString(&serialized)) {
+    LOG_WITH_PREFIX_UNLOCKED(DFATAL) << "Failed to serialize " << entry.msg->id();
+    return;
+  }
+  CompressedEntry compressed_entry;
+  compressed_entry.id = entry.msg->id();
+  snappy::Compress(serialized.data(), serialized.size(), &compressed_entry.data);
+  compressed_entry.data.shrink_to_fit();
+  compressed_entry.mem_usage = sizeof(CompressedEntry) + compressed_entry.data.capacity();
+  compressed_entry.tracked_size = entry.tracked_size;
+
+  // Entries are evicted oldest first, so keep the entries that are already compressed, since the
+  // lagging peers would ask for them first.
+  if (!compressed_tracker_->TryConsume(compressed_entry.mem_usage)) {
+    VLOG_WITH_PREFIX_UNLOCKED(2) << "No space in compressed tier for " << entry.msg->id();
+    return;
+  }
+  metrics_.log_cache_compressed_size->IncrementBy(compressed_entry.mem_usage);
+  metrics_.log_cache_compressed_num_ops->Increment();
+  auto index = compressed_entry.id.index();
+  InsertOrDie(&compressed_cache_, index, std::move(compressed_entry));
+}
+
+void LogCache::RemoveCompressedUnlocked(int64_t from_index, int64_t to_index) {
+  auto begin = compressed_cache_.lower_bound(from_index);
+  auto end = compressed_cache_.upper_bound(to_index);
+  for (auto it = begin; it != end; ++it) {
+    compressed_tracker_->Release(it->second.mem_usage);
+    metrics_.log_cache_compressed_size->DecrementBy(it->second.mem_usage);
+    metrics_.log_cache_compressed_num_ops->Decrement();
+  }
+  compressed_cache_.erase(begin, end);
+}
+
+Result<ReplicateMsgPtr> LogCache::UncompressMessage(const CompressedEntry& entry) const {
+  std::string serialized;
+  if (!snappy::Uncompress(entry.data.data(), entry.data.size(), &serialized)) {
+    return STATUS_FORMAT(Corruption, "Failed to uncompress cached op $0",
+                         OpIdToString(entry.id));
+  }
+  auto msg = std::make_shared<ReplicateMsg>();
+  if (!msg->ParseFromString(serialized)) {
+    return STATUS_FORMAT(Corruption, "Failed to parse cached op $0", OpIdToString(entry.id));
+  }
+  return msg;
+}
+
 int64_t LogCache::BytesUsed() const {
   return tracker_->consumption();
 }
@@ -457,7 +593,7 @@ void LogCache::DumpToStrings(vector<string>* lines) const {
   lines->push_back(ToStringUnlocked());
   lines->push_back("Messages:");
   for (const MessageCache::value_type& entry : cache_) {
-    const ReplicateMsg* msg = entry.second.get();
+    const ReplicateMsg* msg = entry.second.msg.get();
     lines->push_back(
       Substitute("Message[$0] $1.$2 : REPLICATE. Type: $3, Size: $4",
                  counter++, msg->id().term(), msg->id().index(),
@@ -476,7 +612,7 @@ void LogCache::DumpToHtml(std::ostream& out) const {
 
   int counter = 0;
   for (const MessageCache::value_type& entry : cache_) {
-    const ReplicateMsg* msg = entry.second.get();
+    const ReplicateMsg* msg = entry.second.msg.get();
     out << Substitute("<tr><th>$0</th><th>$1.$2</th><td>REPLICATE $3</td>"
                       "<td>$4</td><td>$5</td></tr>",
                       counter++, msg->id().term(), msg->id().index(),
@@ -490,7 +626,12 @@ void LogCache::DumpToHtml(std::ostream& out) const {
   x.Instantiate(metric_entity, 0)
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : log_cache_num_ops(INSTANTIATE_METRIC(METRIC_log_cache_num_ops)),
-    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)) {
+    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)),
+    log_cache_compressed_num_ops(INSTANTIATE_METRIC(METRIC_log_cache_compressed_num_ops)),
+    log_cache_compressed_size(INSTANTIATE_METRIC(METRIC_log_cache_compressed_size)),
+    log_cache_hits(METRIC_log_cache_hits.Instantiate(metric_entity)),
+    log_cache_compressed_hits(METRIC_log_cache_compressed_hits.Instantiate(metric_entity)),
+    log_cache_disk_reads(METRIC_log_cache_disk_reads.Instantiate(metric_entity)) {
 }
 #undef INSTANTIATE_METRIC
 
@@ -45,6 +45,7 @@
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/result.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -67,6 +68,10 @@ class ReplicateMsg;
 // can be appended to the end as they are written to the log. Readers
 // fetch entries that were explicitly appended, or they can fetch older
 // entries which are asynchronously fetched from the disk.
+//
+// Entries evicted because of the memory limit, before all peers have received them, are kept
+// Snappy-compressed in a second tier of the cache, with its own per-tablet memory limit, so that
+// a peer which fell behind for a short time can be caught up without reading from disk.
 class LogCache {
  public:
   LogCache(const scoped_refptr<MetricEntity>& metric_entity,
@@ -152,16 +157,51 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestCompressedTier);
   friend class LogCacheTest;
 
   // Try to evict the oldest operations from the queue, stopping either when
   // 'bytes_to_evict' bytes have been evicted, or the op with index
   // 'stop_after_index' has been evicted, whichever comes first.
-  void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+  // If 'spill' is true, the evicted operations are moved to the compressed tier, otherwise they
+  // are dropped from both tiers.
+  void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict, bool spill);
+
+  struct CacheEntry {
+    ReplicateMsgPtr msg;
+    // The cached memory footprint of the message, as accounted in the MemTracker.
+    int64_t mem_usage;
+    // The cached size of the message on the wire, see TotalByteSizeForMessage.
+    int64_t tracked_size;
+  };
+
+  // Creates an entry for the given message, calculating its sizes once, so they are not
+  // recomputed every time the message is read for a peer.
+  static CacheEntry MakeCacheEntry(ReplicateMsgPtr msg);
 
   // Update metrics and MemTracker to account for the removal of the
   // given message.
-  void AccountForMessageRemovalUnlocked(const ReplicateMsgPtr& msg);
+  void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
+
+  struct CompressedEntry {
+    OpId id;
+    // The message serialized and compressed with Snappy.
+    std::string data;
+    // The memory footprint of the entry, as accounted in the compressed tier MemTracker.
+    int64_t mem_usage;
+    // The size of the message on the wire, see TotalByteSizeForMessage.
+    int64_t tracked_size;
+  };
+
+  // Compresses the message of the given entry into the compressed tier. The message is skipped
+  // if the compressed tier does not have enough memory left.
+  void SpillToCompressedTierUnlocked(const CacheEntry& entry);
+
+  // Removes compressed entries with indexes in range [from_index, to_index].
+  void RemoveCompressedUnlocked(int64_t from_index, int64_t to_index);
+
+  // Restores the message from the given compressed entry.
+  Result<ReplicateMsgPtr> UncompressMessage(const CompressedEntry& entry) const;
 
   // Return a string with stats
   std::string StatsStringUnlocked() const;
@@ -187,9 +227,14 @@ class LogCache {
 
   // An ordered map that serves as the buffer for the cached messages.
   // Maps from log index -> ReplicateMsg
-  typedef std::map<uint64_t, ReplicateMsgPtr> MessageCache;
+  typedef std::map<uint64_t, CacheEntry> MessageCache;
   MessageCache cache_;
 
+  // The second tier of the cache, holding compressed messages evicted from cache_.
+  // Maps from log index -> CompressedEntry.
+  typedef std::map<uint64_t, CompressedEntry> CompressedMessageCache;
+  CompressedMessageCache compressed_cache_;
+
   // The next log index to append. Each append operation must either
   // start with this log index, or go backward (but never skip forward).
   int64_t next_sequential_op_index_;
@@ -213,6 +258,9 @@ class LogCache {
   // A MemTracker for this instance.
   std::shared_ptr<MemTracker> tracker_;
 
+  // A MemTracker for the compressed tier of this instance, also parented to parent_tracker_.
+  std::shared_ptr<MemTracker> compressed_tracker_;
+
   struct Metrics {
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -221,6 +269,15 @@ class LogCache {
 
     // Keeps track of the memory consumed by the cache, in bytes.
     scoped_refptr<AtomicGauge<int64_t> > log_cache_size;
+
+    // Keeps track of the number of operations and memory in the compressed tier.
+    scoped_refptr<AtomicGauge<int64_t> > log_cache_compressed_num_ops;
+    scoped_refptr<AtomicGauge<int64_t> > log_cache_compressed_size;
+
+    // Number of operations read by peers from each tier of the cache, and from disk.
+    scoped_refptr<Counter> log_cache_hits;
+    scoped_refptr<Counter> log_cache_compressed_hits;
+    scoped_refptr<Counter> log_cache_disk_reads;
   };
   Metrics metrics_;
 
@@ -93,6 +93,28 @@ TEST_F(LogIndexTest, TestBasic) {
   VerifyEntry(MakeOpId(5, 1), 1, 50000);
 }
 
+TEST_F(LogIndexTest, TestGetEntries) {
+  // The range crosses the boundary of index chunks.
+  for (int64_t index = 999990; index <= 1000010; ++index) {
+    ASSERT_OK(AddEntry(MakeOpId(2, index), 3, index * 10));
+  }
+
+  std::vector<LogIndexEntry> entries;
+  ASSERT_OK(index_->GetEntries(999990, 1000010, &entries));
+  ASSERT_EQ(21, entries.size());
+  for (int64_t index = 999990; index <= 1000010; ++index) {
+    SCOPED_TRACE(index);
+    const auto& entry = entries[index - 999990];
+    EXPECT_EQ(2, entry.op_id.term());
+    EXPECT_EQ(index, entry.op_id.index());
+    EXPECT_EQ(3, entry.segment_sequence_number);
+    EXPECT_EQ(index * 10, entry.offset_in_segment);
+  }
+
+  Status s = index_->GetEntries(999990, 1000011, &entries);
+  EXPECT_TRUE(s.IsNotFound()) << s.ToString();
+}
+
 // This test relies on kEntriesPerIndexChunk being 1000000, and that's no longer
 // the case after D1719 (2fe27d886390038bc734ea28638a1b1435e7d0d4) on Mac.
 #if !defined(__APPLE__)
@@ -49,6 +49,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -157,7 +158,8 @@ Status LogIndex::IndexChunk::Open() {
 
   mapping_ = static_cast<uint8_t*>(mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE,
                                         MAP_SHARED, fd_, 0));
-  if (mapping_ == nullptr) {
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
     int err = errno;
     return STATUS(IOError, "Unable to mmap()", ErrnoToString(err), err);
   }
@@ -272,6 +274,36 @@ Status LogIndex::GetEntry(int64_t index, LogIndexEntry* entry) {
   return Status::OK();
 }
 
+Status LogIndex::GetEntries(int64_t start_index, int64_t end_index,
+                            std::vector<LogIndexEntry>* entries) {
+  entries->clear();
+  if (end_index < start_index) {
+    return Status::OK();
+  }
+  entries->reserve(end_index - start_index + 1);
+  int64_t index = start_index;
+  while (index <= end_index) {
+    scoped_refptr<IndexChunk> chunk;
+    RETURN_NOT_OK(GetChunkForIndex(index, false /* do not create */, &chunk));
+    int64_t last_index_in_chunk = (index / kEntriesPerIndexChunk + 1) * kEntriesPerIndexChunk - 1;
+    int64_t chunk_end_index = std::min(end_index, last_index_in_chunk);
+    for (; index <= chunk_end_index; ++index) {
+      PhysicalEntry phys;
+      chunk->GetEntry(index % kEntriesPerIndexChunk, &phys);
+      if (phys.offset_in_segment == 0) {
+        return STATUS(NotFound, "entry not found");
+      }
+      entries->emplace_back();
+      auto& entry = entries->back();
+      entry.op_id = consensus::MakeOpId(phys.term, index);
+      entry.segment_sequence_number = phys.segment_sequence_number;
+      entry.offset_in_segment = phys.offset_in_segment;
+    }
+  }
+
+  return Status::OK();
+}
+
 void LogIndex::GC(int64_t min_index_to_retain) {
   int min_chunk_to_retain = min_index_to_retain / kEntriesPerIndexChunk;
 
@@ -33,6 +33,7 @@
 #define YB_CONSENSUS_LOG_INDEX_H
 
 #include <string>
+#include <vector>
 #include <map>
 
 #include "yb/consensus/consensus.pb.h"
@@ -84,6 +85,13 @@ class LogIndex : public RefCountedThreadSafe<LogIndex> {
   // Returns NotFound() if the given log entry was never written.
   CHECKED_STATUS GetEntry(int64_t index, LogIndexEntry* entry);
 
+  // Retrieve existing entries with indexes in range [start_index, end_index] from the index.
+  // Each index chunk is looked up only once, so it is cheaper than calling GetEntry for every
+  // index of the range.
+  // Returns NotFound() if any of the log entries in the range was never written.
+  CHECKED_STATUS GetEntries(int64_t start_index, int64_t end_index,
+                            std::vector<LogIndexEntry>* entries);
+
   // Indicate that we no longer need to retain information about indexes lower than the
   // given index. Note that the implementation is conservative and _may_ choose to retain
   // earlier entries.
@@ -63,6 +63,16 @@ METRIC_DEFINE_histogram(tablet, log_entry_batches_per_group, "Log Group Commit B
                         "Number of log entry batches in a group commit group",
                         1024, 2);
 
+METRIC_DEFINE_histogram(tablet, log_entry_batches_per_sync, "Log Entry Batches Per Sync",
+                        yb::MetricUnit::kRequests,
+                        "Number of log entry batches made durable by a single fsync of the log",
+                        1024, 2);
+
+METRIC_DEFINE_histogram(tablet, log_group_commit_wait, "Log Group Commit Wait",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent waiting for more entry batches before syncing the log",
+                        60000000LU, 2);
+
 namespace yb {
 namespace log {
 
@@ -73,7 +83,9 @@ LogMetrics::LogMetrics(const scoped_refptr<MetricEntity>& metric_entity)
       MINIT(append_latency),
       MINIT(group_commit_latency),
       MINIT(roll_latency),
-      MINIT(entry_batches_per_group) {
+      MINIT(entry_batches_per_group),
+      MINIT(entry_batches_per_sync),
+      MINIT(group_commit_wait) {
 }
 #undef MINIT
 
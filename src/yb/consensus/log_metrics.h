@@ -56,6 +56,8 @@ struct LogMetrics {
   scoped_refptr<Histogram> group_commit_latency;
   scoped_refptr<Histogram> roll_latency;
   scoped_refptr<Histogram> entry_batches_per_group;
+  scoped_refptr<Histogram> entry_batches_per_sync;
+  scoped_refptr<Histogram> group_commit_wait;
 };
 
 // TODO extract and generalize this for all histogram metrics
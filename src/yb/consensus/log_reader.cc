@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <mutex>
+#include <vector>
 
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/opid_util.h"
@@ -330,17 +331,28 @@ Status LogReader::ReadReplicatesInRange(
   DCHECK_GE(up_to, starting_at);
   DCHECK(log_index_) << "Require an index to random-read logs";
 
+  // Number of index entries that are looked up at once.
+  constexpr int64_t kIndexLookupBatchSize = 1024;
+
   ReplicateMsgs replicates_tmp;
   LogIndexEntry prev_index_entry;
+  std::vector<LogIndexEntry> index_entries;
 
   int64_t total_size = 0;
   bool limit_exceeded = false;
   faststring tmp_buf;
   LogEntryBatchPB batch;
-  for (int index = starting_at; index <= up_to && !limit_exceeded; index++) {
-    LogIndexEntry index_entry;
-    RETURN_NOT_OK_PREPEND(log_index_->GetEntry(index, &index_entry),
-                          Substitute("Failed to read log index for op $0", index));
+  // Position in the batch to start looking for the next replicate from.
+  int batch_pos = 0;
+  for (int64_t index = starting_at; index <= up_to && !limit_exceeded; index++) {
+    size_t index_entry_idx = (index - starting_at) % kIndexLookupBatchSize;
+    if (index_entry_idx == 0) {
+      int64_t lookup_end = std::min(up_to, index + kIndexLookupBatchSize - 1);
+      RETURN_NOT_OK_PREPEND(log_index_->GetEntries(index, lookup_end, &index_entries),
+                            Substitute("Failed to read log index for ops $0-$1",
+                                       index, lookup_end));
+    }
+    const LogIndexEntry& index_entry = index_entries[index_entry_idx];
 
     // Since a given LogEntryBatch may contain multiple REPLICATE messages,
     // it's likely that this index entry points to the same batch as the previous
@@ -350,6 +362,7 @@ Status LogReader::ReadReplicatesInRange(
         index_entry.segment_sequence_number != prev_index_entry.segment_sequence_number ||
         index_entry.offset_in_segment != prev_index_entry.offset_in_segment) {
       RETURN_NOT_OK(ReadBatchUsingIndexEntry(index_entry, &tmp_buf, &batch));
+      batch_pos = 0;
 
       // Sanity-check the property that a batch should only have increasing indexes.
       int64_t prev_index = 0;
@@ -365,8 +378,10 @@ Status LogReader::ReadReplicatesInRange(
       }
     }
 
+    // Indexes in the batch are increasing, so the replicate for this index could only follow
+    // the replicate we found for the previous index.
     bool found = false;
-    for (int i = 0; i < batch.entry_size(); ++i) {
+    for (int i = batch_pos; i < batch.entry_size(); ++i) {
       LogEntryPB* entry = batch.mutable_entry(i);
       if (!entry->has_replicate()) {
         continue;
@@ -385,6 +400,7 @@ Status LogReader::ReadReplicatesInRange(
       } else {
         limit_exceeded = true;
       }
+      batch_pos = i + 1;
       found = true;
       break;
     }
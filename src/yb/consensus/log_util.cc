@@ -39,6 +39,7 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <snappy.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/ref_counted_replicate.h"
@@ -88,6 +89,12 @@ DEFINE_bool(log_async_preallocate_segments, true,
             "Whether the WAL segments preallocation should happen asynchronously");
 TAG_FLAG(log_async_preallocate_segments, advanced);
 
+DEFINE_bool(log_compress_entry_batches, false,
+            "Compress log entry batches with Snappy before writing them to log segments. "
+            "Segments that contain compressed batches cannot be read by versions that do not "
+            "support it, so enable only after all servers are upgraded.");
+TAG_FLAG(log_compress_entry_batches, advanced);
+
 namespace yb {
 namespace log {
 
@@ -114,6 +121,10 @@ const size_t kLogSegmentFooterMagicAndFooterLength  = 12;
 
 const size_t kEntryHeaderSize = 12;
 
+// The highest bit of the entry length in the entry header indicates that the batch data is
+// compressed. Entry length is limited by the RPC message size, so this bit is never set otherwise.
+const uint32_t kEntryCompressedFlag = 1U << 31;
+
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
 
@@ -651,7 +662,9 @@ Status ReadableLogSegment::ReadEntryHeader(int64_t *offset, EntryHeader* header)
 
 bool ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* header) {
   DCHECK_EQ(kEntryHeaderSize, data.size());
-  header->msg_length = DecodeFixed32(&data[0]);
+  uint32_t encoded_length = DecodeFixed32(&data[0]);
+  header->msg_length = encoded_length & ~kEntryCompressedFlag;
+  header->compressed = (encoded_length & kEntryCompressedFlag) != 0;
   header->msg_crc    = DecodeFixed32(&data[4]);
   header->header_crc = DecodeFixed32(&data[8]);
 
@@ -704,10 +717,20 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice entry_batch_data = entry_batch_slice;
+  std::string uncompressed;
+  if (header.compressed) {
+    if (!snappy::Uncompress(entry_batch_slice.cdata(), entry_batch_slice.size(), &uncompressed)) {
+      return STATUS(Corruption, Substitute("Could not uncompress entry in byte range $0-$1",
+                                           *offset, *offset + header.msg_length));
+    }
+    entry_batch_data = uncompressed;
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              entry_batch_data.data(),
+                              entry_batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -783,12 +806,24 @@ Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  // Compressed data is written only when it is smaller than the original data.
+  Slice data_to_write = data;
+  uint32_t compressed_flag = 0;
+  if (FLAGS_log_compress_entry_batches) {
+    snappy::Compress(data.cdata(), data.size(), &compress_buffer_);
+    if (compress_buffer_.size() < data.size()) {
+      data_to_write = compress_buffer_;
+      compressed_flag = kEntryCompressedFlag;
+    }
+  }
+
   // First encode the length of the message.
-  uint32_t len = data.size();
-  InlineEncodeFixed32(&header_buf[0], len);
+  uint32_t len = data_to_write.size();
+  DCHECK_EQ(len & kEntryCompressedFlag, 0);
+  InlineEncodeFixed32(&header_buf[0], len | compressed_flag);
 
   // Then the CRC of the message.
-  uint32_t msg_crc = crc::Crc32c(&data[0], data.size());
+  uint32_t msg_crc = crc::Crc32c(data_to_write.data(), data_to_write.size());
   InlineEncodeFixed32(&header_buf[4], msg_crc);
 
   // Then the CRC of the header
@@ -799,8 +834,8 @@ Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
   RETURN_NOT_OK(writable_file_->Append(Slice(header_buf, sizeof(header_buf))));
   written_offset_ += sizeof(header_buf);
 
-  RETURN_NOT_OK(writable_file_->Append(data));
-  written_offset_ += data.size();
+  RETURN_NOT_OK(writable_file_->Append(data_to_write));
+  written_offset_ += data_to_write.size();
 
   return Status::OK();
 }
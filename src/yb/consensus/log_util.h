@@ -215,9 +215,12 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   FRIEND_TEST(LogTest, TestWriteAndReadToAndFromInProgressSegment);
 
   struct EntryHeader {
-    // The length of the batch data.
+    // The length of the batch data, as stored in the segment.
     uint32_t msg_length;
 
+    // Whether the batch data is compressed.
+    bool compressed;
+
     // The CRC32C of the batch data.
     uint32_t msg_crc;
 
@@ -404,6 +407,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Buffer used to compress entry batches, reused to avoid allocations.
+  std::string compress_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
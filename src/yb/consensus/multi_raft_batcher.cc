@@ -0,0 +1,176 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <functional>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/common/wire_protocol.h"
+#include "yb/rpc/messenger.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+#include "yb/util/net/net_util.h"
+
+// Disabled by default, since servers which do not support the MultiRaftUpdateConsensus RPC would
+// reject the batches, e.g. during a rolling upgrade.
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "Whether status-only consensus requests of different tablets to the same remote "
+            "server are batched into a single RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, runtime);
+
+DEFINE_int32(multi_raft_heartbeat_window_ms, 10,
+             "For how long heartbeats to the same remote server are collected before being sent "
+             "as a single RPC.");
+TAG_FLAG(multi_raft_heartbeat_window_ms, advanced);
+
+DEFINE_int32(multi_raft_batch_size, 128,
+             "Maximum number of heartbeats sent to a remote server in a single RPC.");
+TAG_FLAG(multi_raft_batch_size, advanced);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    const std::shared_ptr<rpc::Messenger>& messenger, const Endpoint& remote)
+    : messenger_(messenger),
+      remote_(remote),
+      proxy_(messenger, remote) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  // Peers wait for their outstanding requests before releasing the batcher, so there should be
+  // no pending requests here. Fail them anyway, so their callbacks are always invoked.
+  if (current_batch_) {
+    LOG(DFATAL) << "Destroying a heartbeat batcher with " << current_batch_->callbacks.size()
+                << " pending requests";
+    for (auto& data : current_batch_->callbacks) {
+      data.callback(STATUS(Aborted, "Heartbeat batcher destroyed"));
+    }
+  }
+}
+
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(const ConsensusRequestPB& request,
+                                                  ConsensusResponsePB* response,
+                                                  MultiRaftHeartbeatCallback callback) {
+  BatchPtr batch_to_send;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<Batch>();
+      schedule_flush = true;
+    }
+    current_batch_->request.add_consensus_request()->CopyFrom(request);
+    current_batch_->callbacks.push_back({response, std::move(callback)});
+    if (current_batch_->callbacks.size() >= static_cast<size_t>(FLAGS_multi_raft_batch_size)) {
+      batch_to_send = std::move(current_batch_);
+      current_batch_.reset();
+      schedule_flush = false;
+    }
+  }
+
+  if (batch_to_send) {
+    SendBatch(std::move(batch_to_send));
+  } else if (schedule_flush) {
+    std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+    messenger_->ScheduleOnReactor(
+        [weak_self](const Status&) {
+          // The batch is sent even if the task was aborted, so its callbacks are invoked with
+          // the error of the RPC.
+          auto self = weak_self.lock();
+          if (self) {
+            self->FlushBatch();
+          }
+        },
+        MonoDelta::FromMilliseconds(FLAGS_multi_raft_heartbeat_window_ms));
+  }
+}
+
+void MultiRaftHeartbeatBatcher::FlushBatch() {
+  BatchPtr batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch = std::move(current_batch_);
+    current_batch_.reset();
+  }
+  if (batch) {
+    SendBatch(std::move(batch));
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendBatch(BatchPtr batch) {
+  VLOG(3) << "Sending a batch of " << batch->callbacks.size() << " heartbeats to "
+          << remote_;
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  // The batch keeps the request and the response alive until the RPC completes.
+  proxy_.MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      std::bind(&MultiRaftHeartbeatBatcher::ProcessResponse, shared_from_this(), batch));
+}
+
+void MultiRaftHeartbeatBatcher::ProcessResponse(BatchPtr batch) {
+  Status status = batch->controller.status();
+  if (status.ok() &&
+      static_cast<size_t>(batch->response.consensus_response_size()) != batch->callbacks.size()) {
+    status = STATUS_FORMAT(IllegalState, "Got $0 responses to a batch of $1 heartbeats",
+                           batch->response.consensus_response_size(), batch->callbacks.size());
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to send a batch of " << batch->callbacks.size() << " heartbeats to "
+                 << remote_ << ": " << status.ToString();
+    for (auto& data : batch->callbacks) {
+      data.callback(status);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i != batch->callbacks.size(); ++i) {
+    auto& data = batch->callbacks[i];
+    data.response->Swap(batch->response.mutable_consensus_response(i));
+    data.callback(Status::OK());
+  }
+}
+
+MultiRaftManager::MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger)
+    : messenger_(std::move(messenger)) {
+}
+
+Result<MultiRaftHeartbeatBatcherPtr> MultiRaftManager::AddOrGetBatcher(
+    const RaftPeerPB& remote_peer_pb) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& weak_batcher = batchers_[remote_peer_pb.permanent_uuid()];
+  auto batcher = weak_batcher.lock();
+  if (batcher) {
+    return batcher;
+  }
+
+  HostPort hostport;
+  RETURN_NOT_OK(HostPortFromPB(remote_peer_pb.last_known_addr(), &hostport));
+  std::vector<Endpoint> addrs;
+  RETURN_NOT_OK(hostport.ResolveAddresses(&addrs));
+  if (addrs.empty()) {
+    return STATUS_FORMAT(NetworkError, "Peer address $0 did not resolve", hostport.ToString());
+  }
+  batcher = std::make_shared<MultiRaftHeartbeatBatcher>(messenger_, addrs[0]);
+  weak_batcher = batcher;
+  return batcher;
+}
+
+} // namespace consensus
+} // namespace yb
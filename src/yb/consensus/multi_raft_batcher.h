@@ -0,0 +1,120 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus.proxy.h"
+#include "yb/consensus/metadata.pb.h"
+#include "yb/gutil/macros.h"
+#include "yb/rpc/rpc_controller.h"
+#include "yb/util/net/net_util.h"
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+} // namespace rpc
+
+namespace consensus {
+
+// Invoked with the status of the RPC that carried a batched request.
+typedef std::function<void(const Status&)> MultiRaftHeartbeatCallback;
+
+// Collects status-only consensus requests (heartbeats) sent by the tablets led by this server to
+// replicas located on the same remote server, and sends them as one MultiRaftUpdateConsensus RPC.
+//
+// A batch is sent when it reaches FLAGS_multi_raft_batch_size requests, or when
+// FLAGS_multi_raft_heartbeat_window_ms elapse after its first request was added.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(const std::shared_ptr<rpc::Messenger>& messenger,
+                            const Endpoint& remote);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds a copy of 'request' to the current batch. When the response to the batch is received,
+  // 'response' is filled and 'callback' is invoked. 'response' should stay valid until then.
+  // The callback is always invoked, with the error of the batch RPC if it failed.
+  void AddRequestToBatch(const ConsensusRequestPB& request,
+                         ConsensusResponsePB* response,
+                         MultiRaftHeartbeatCallback callback);
+
+ private:
+  struct ResponseCallbackData {
+    ConsensusResponsePB* response;
+    MultiRaftHeartbeatCallback callback;
+  };
+
+  struct Batch {
+    MultiRaftConsensusRequestPB request;
+    MultiRaftConsensusResponsePB response;
+    rpc::RpcController controller;
+    std::vector<ResponseCallbackData> callbacks;
+  };
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  // Sends the current batch, if any.
+  void FlushBatch();
+
+  void SendBatch(BatchPtr batch);
+
+  void ProcessResponse(BatchPtr batch);
+
+  std::shared_ptr<rpc::Messenger> messenger_;
+  const Endpoint remote_;
+  ConsensusServiceProxy proxy_;
+
+  std::mutex mutex_;
+  // The batch being collected, protected by mutex_.
+  BatchPtr current_batch_;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiRaftHeartbeatBatcher);
+};
+
+typedef std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcherPtr;
+
+// Server-wide registry of heartbeat batchers, one per remote server. The batchers are owned by
+// the peer proxies of the tablets, so a batcher is destroyed once no local tablet has a replica
+// on its remote server.
+class MultiRaftManager {
+ public:
+  explicit MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger);
+
+  // Returns the batcher for the server of the given peer, creating it if necessary.
+  Result<MultiRaftHeartbeatBatcherPtr> AddOrGetBatcher(const RaftPeerPB& remote_peer_pb);
+
+ private:
+  std::shared_ptr<rpc::Messenger> messenger_;
+
+  std::mutex mutex_;
+  // Maps the permanent uuid of a remote server to its batcher, protected by mutex_.
+  std::unordered_map<std::string, std::weak_ptr<MultiRaftHeartbeatBatcher>> batchers_;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiRaftManager);
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
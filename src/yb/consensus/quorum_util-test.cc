@@ -71,5 +71,20 @@ TEST(QuorumUtilTest, TestMemberExtraction) {
   ASSERT_EQ("B", peer_pb.permanent_uuid());
 }
 
+TEST(QuorumUtilTest, TestWitness) {
+  RaftConfigPB config;
+  SetPeerInfo("A", RaftPeerPB::VOTER, config.add_peers());
+  SetPeerInfo("B", RaftPeerPB::VOTER, config.add_peers());
+  SetPeerInfo("C", RaftPeerPB::VOTER, config.add_peers());
+  config.mutable_peers(2)->set_is_witness(true);
+
+  ASSERT_FALSE(IsRaftConfigWitness("A", config));
+  ASSERT_TRUE(IsRaftConfigWitness("C", config));
+  ASSERT_FALSE(IsRaftConfigWitness("invalid", config));
+  // A witness is a voter, so that it counts toward the majority.
+  ASSERT_TRUE(IsRaftConfigVoter("C", config));
+  ASSERT_EQ(2, MajoritySize(CountVoters(config)));
+}
+
 } // namespace consensus
 } // namespace yb
@@ -51,6 +51,9 @@ enum RaftConfigState {
 bool IsRaftConfigMember(const std::string& uuid, const RaftConfigPB& config);
 bool IsRaftConfigVoter(const std::string& uuid, const RaftConfigPB& config);
 
+// Whether the peer with the given uuid is a witness, i.e. a voter without data.
+bool IsRaftConfigWitness(const std::string& uuid, const RaftConfigPB& config);
+
 // Get the specified member of the config.
 // Returns Status::NotFound if a member with the specified uuid could not be
 // found in the config.
@@ -128,6 +128,12 @@ DEFINE_bool(follower_fail_all_prepare, false,
             "Warning! This is only intended for testing.");
 TAG_FLAG(follower_fail_all_prepare, unsafe);
 
+DEFINE_bool(use_preelection, true,
+            "Whether a candidate runs a pre-election first and only advances its term and starts "
+            "the actual election when a majority would vote for it.");
+TAG_FLAG(use_preelection, advanced);
+TAG_FLAG(use_preelection, runtime);
+
 DEFINE_int32(after_stepdown_delay_election_multiplier, 5,
              "After a peer steps down as a leader, the factor with which to multiply "
              "leader_failure_max_missed_heartbeat_periods to get the delay time before starting a "
@@ -229,8 +235,10 @@ scoped_refptr<RaftConsensus> RaftConsensus::Create(
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     LostLeadershipListener lost_leadership_listener,
-    ThreadPool* raft_pool) {
-  gscoped_ptr<PeerProxyFactory> rpc_factory(new RpcPeerProxyFactory(messenger));
+    ThreadPool* raft_pool,
+    MultiRaftManager* multi_raft_manager) {
+  gscoped_ptr<PeerProxyFactory> rpc_factory(
+      new RpcPeerProxyFactory(messenger, multi_raft_manager));
 
   // The message queue that keeps track of which operations need to be replicated
   // where.
@@ -434,6 +442,17 @@ Status RaftConsensus::DoStartElection(
     const OpId& must_be_committed_opid,
     const std::string& originator_uuid,
     TEST_SuppressVoteRequest suppress_vote_request) {
+  return StartElectionImpl(mode, PreElected::kFalse, pending_commit, must_be_committed_opid,
+                           originator_uuid, suppress_vote_request);
+}
+
+Status RaftConsensus::StartElectionImpl(
+    ElectionMode mode,
+    PreElected preelected,
+    const bool pending_commit,
+    const OpId& must_be_committed_opid,
+    const std::string& originator_uuid,
+    TEST_SuppressVoteRequest suppress_vote_request) {
   TRACE_EVENT2("consensus", "RaftConsensus::StartElection",
                "peer", peer_uuid(),
                "tablet", tablet_id());
@@ -454,6 +473,11 @@ Status RaftConsensus::DoStartElection(
       LOG_WITH_PREFIX_UNLOCKED(INFO) << "Not starting election -- role is LEARNER, pending="
                                      << state_->IsConfigChangePendingUnlocked();
       return Status::OK();
+    } else if (IsRaftConfigWitness(state_->GetPeerUuid(), state_->GetActiveConfigUnlocked())) {
+      // A witness has no data to serve as the leader, one of the other voters has to win.
+      RETURN_NOT_OK(SnoozeFailureDetectorUnlocked());
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Not starting election -- this peer is a witness";
+      return Status::OK();
     } else if (PREDICT_FALSE(active_role == RaftPeerPB::NON_PARTICIPANT)) {
       // Avoid excessive election noise while in this state.
       RETURN_NOT_OK(SnoozeFailureDetectorUnlocked());
@@ -492,8 +516,20 @@ Status RaftConsensus::DoStartElection(
             << "Triggering leader election, mode=" << mode;
       }
 
+      const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
+      int num_voters = CountVoters(active_config);
+
+      // A failed node that keeps timing out would otherwise advance the term on every attempt,
+      // and make the healthy leader step down when it reaches it. So, unless the old leader is
+      // handing over, a majority has to agree before the term is advanced. Nobody is disturbed
+      // in a single voter config.
+      const bool preelection = !preelected && FLAGS_use_preelection && num_voters > 1 &&
+                               mode == NORMAL_ELECTION && !suppress_vote_request;
+
       // Increment the term.
-      RETURN_NOT_OK(IncrementTermUnlocked());
+      if (!preelection) {
+        RETURN_NOT_OK(IncrementTermUnlocked());
+      }
 
       // Snooze to avoid the election timer firing again as much as possible.
       // We do not disable the election timer while running an election.
@@ -502,18 +538,18 @@ Status RaftConsensus::DoStartElection(
       MonoDelta timeout = LeaderElectionExpBackoffDeltaUnlocked();
       RETURN_NOT_OK(SnoozeFailureDetectorUnlocked(timeout, ALLOW_LOGGING));
 
-      const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
-      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Starting election with config: "
-                                     << active_config.ShortDebugString();
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Starting " << (preelection ? "pre-election" : "election")
+                                     << " with config: " << active_config.ShortDebugString();
 
       // Initialize the VoteCounter.
-      int num_voters = CountVoters(active_config);
       int majority_size = MajoritySize(num_voters);
       auto counter = std::make_unique<VoteCounter>(num_voters, majority_size);
 
       // Vote for ourselves.
       // TODO: Consider using a separate Mutex for voting, which must sync to disk.
-      RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      if (!preelection) {
+        RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      }
       bool duplicate;
       RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
       CHECK(!duplicate) << state_->LogPrefixUnlocked()
@@ -523,10 +559,11 @@ Status RaftConsensus::DoStartElection(
       VoteRequestPB request;
       request.set_ignore_live_leader(mode == ELECT_EVEN_IF_LEADER_IS_ALIVE);
       request.set_candidate_uuid(state_->GetPeerUuid());
-      request.set_candidate_term(state_->GetCurrentTermUnlocked());
+      request.set_candidate_term(state_->GetCurrentTermUnlocked() + (preelection ? 1 : 0));
       request.set_tablet_id(state_->GetOptions().tablet_id);
       *request.mutable_candidate_status()->mutable_last_received() =
         state_->GetLastReceivedOpIdUnlocked();
+      request.set_preelection(preelection);
 
       election.reset(new LeaderElection(
           active_config,
@@ -535,7 +572,8 @@ Status RaftConsensus::DoStartElection(
           std::move(counter),
           timeout,
           suppress_vote_request,
-          Bind(&RaftConsensus::ElectionCallback, this, originator_uuid)));
+          preelection ? Bind(&RaftConsensus::PreElectionCallback, this, originator_uuid)
+                      : Bind(&RaftConsensus::ElectionCallback, this, originator_uuid)));
 
       // Clear the pending election op id so that we won't start the same pending election again.
       state_->ClearPendingElectionOpIdUnlocked();
@@ -661,7 +699,8 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
     bool new_leader_found = false;
     const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
     for (const RaftPeerPB& peer : active_config.peers()) {
-      if (peer.member_type() == RaftPeerPB::VOTER &&
+      // A witness cannot take over the leadership, it has no data.
+      if (peer.member_type() == RaftPeerPB::VOTER && !peer.is_witness() &&
           peer.permanent_uuid() == new_leader_uuid) {
         auto election_state = std::make_shared<RunLeaderElectionState>();
         RETURN_NOT_OK(peer_proxy_factory_->NewProxy(peer, &election_state->proxy));
@@ -1862,6 +1901,11 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondAlreadyVotedForOther(request, response);
   }
 
+  // Nothing is changed for a pre-election.
+  if (request->preelection()) {
+    return RequestPreVote(request, response);
+  }
+
   // The term advanced.
   if (request->candidate_term() > state_->GetCurrentTermUnlocked()) {
     RETURN_NOT_OK_PREPEND(HandleTermAdvanceUnlocked(request->candidate_term()),
@@ -2345,6 +2389,24 @@ Status RaftConsensus::RequestVoteRespondIsBusy(const VoteRequestPB* request,
   return Status::OK();
 }
 
+Status RaftConsensus::RequestPreVote(const VoteRequestPB* request, VoteResponsePB* response) {
+  consensus::OpId local_last_logged_opid;
+  GetLatestOpIdFromLog().ToPB(&local_last_logged_opid);
+  if (OpIdLessThan(request->candidate_status().last_received(), local_last_logged_opid)) {
+    return RequestVoteRespondLastOpIdTooOld(local_last_logged_opid, request, response);
+  }
+
+  // Neither the term nor the vote are persisted, so the vote is only granted in the term that was
+  // asked for. The candidate still has to win the actual election in it.
+  response->set_responder_term(request->candidate_term());
+  response->set_vote_granted(true);
+  LOG(INFO) << Substitute("$0: Granting yes pre-vote for candidate $1 in term $2.",
+                          GetRequestVoteLogPrefixUnlocked(),
+                          request->candidate_uuid(),
+                          request->candidate_term());
+  return Status::OK();
+}
+
 Status RaftConsensus::RequestVoteRespondVoteGranted(const VoteRequestPB* request,
                                                     VoteResponsePB* response) {
   // We know our vote will be "yes", so avoid triggering an election while we
@@ -2550,6 +2612,47 @@ void RaftConsensus::ElectionCallback(const std::string& originator_uuid,
               state_->LogPrefixThreadSafe() + "Unable to run election callback");
 }
 
+void RaftConsensus::PreElectionCallback(const std::string& originator_uuid,
+                                        const ElectionResult& result) {
+  // Same as ElectionCallback, runs on a reactor thread.
+  WARN_NOT_OK(raft_pool_token_->SubmitClosure(
+              Bind(&RaftConsensus::DoPreElectionCallback, this, originator_uuid, result)),
+              state_->LogPrefixThreadSafe() + "Unable to run pre-election callback");
+}
+
+void RaftConsensus::DoPreElectionCallback(const std::string& originator_uuid,
+                                          const ElectionResult& result) {
+  {
+    ReplicaState::UniqueLock lock;
+    Status s = state_->LockForRead(&lock);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG_WITH_PREFIX(INFO) << "Received pre-election callback for term "
+                            << result.election_term << " while not running: " << s;
+      return;
+    }
+    if (result.decision == VOTE_DENIED) {
+      // Back off as for a lost election, but the term was left as is.
+      ignore_result(SnoozeFailureDetectorUnlocked(LeaderElectionExpBackoffDeltaUnlocked(),
+                                                  ALLOW_LOGGING));
+      LOG_WITH_PREFIX_UNLOCKED(INFO)
+          << "Pre-election lost for term " << result.election_term << ". Reason: "
+          << (!result.message.empty() ? result.message : "None given");
+      return;
+    }
+    if (result.election_term != state_->GetCurrentTermUnlocked() + 1) {
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Pre-election decision for defunct term "
+                                     << result.election_term;
+      return;
+    }
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Pre-election won for term " << result.election_term;
+  WARN_NOT_OK(StartElectionImpl(NORMAL_ELECTION, PreElected::kTrue, false /* pending_commit */,
+                                OpId::default_instance(), originator_uuid,
+                                TEST_SuppressVoteRequest::kFalse),
+              state_->LogPrefixThreadSafe() + "Unable to start election after pre-election");
+}
+
 void RaftConsensus::NotifyOriginatorAboutLostElection(const std::string& originator_uuid) {
   if (originator_uuid.empty()) {
     return;
@@ -2687,6 +2790,22 @@ Status RaftConsensus::GetLastOpId(OpIdType type, OpId* id) {
   return Status::OK();
 }
 
+Status RaftConsensus::ReadCommittedReplicates(int64_t after_op_index,
+                                              int max_size_bytes,
+                                              ReplicateMsgs* messages) {
+  OpId committed_op_id;
+  RETURN_NOT_OK(GetLastOpId(COMMITTED_OPID, &committed_op_id));
+  if (committed_op_id.index() <= after_op_index) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(queue_->ReadOps(after_op_index, max_size_bytes, messages));
+  // The cache also has the ops that were appended but are not committed yet.
+  while (!messages->empty() && messages->back()->id().index() > committed_op_id.index()) {
+    messages->pop_back();
+  }
+  return Status::OK();
+}
+
 void RaftConsensus::MarkDirty(std::shared_ptr<StateChangeContext> context) {
   LOG(INFO) << "Calling mark dirty synchronously for reason code " << context->reason;
   mark_dirty_clbk_.Run(context);
@@ -2854,6 +2973,10 @@ uint64_t RaftConsensus::OnDiskSize() const {
   return state_->OnDiskSize();
 }
 
+void RaftConsensus::EvictLogCache() {
+  queue_->EvictLogCache();
+}
+
 yb::OpId RaftConsensus::WaitForSafeOpIdToApply(const yb::OpId& op_id) {
   return log_->WaitForSafeOpIdToApply(op_id);
 }
@@ -71,6 +71,7 @@ class Clock;
 
 namespace consensus {
 class ConsensusMetadata;
+class MultiRaftManager;
 class Peer;
 class PeerProxyFactory;
 class PeerManager;
@@ -79,6 +80,8 @@ struct ElectionResult;
 
 typedef std::function<void()> LostLeadershipListener;
 
+YB_STRONGLY_TYPED_BOOL(PreElected);
+
 constexpr int32_t kDefaultLeaderLeaseDurationMs = 2000;
 
 class RaftConsensus : public Consensus,
@@ -100,7 +103,8 @@ class RaftConsensus : public Consensus,
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     LostLeadershipListener lost_leadership_listener,
-    ThreadPool* raft_pool);
+    ThreadPool* raft_pool,
+    MultiRaftManager* multi_raft_manager);
 
   RaftConsensus(const ConsensusOptions& options,
     std::unique_ptr<ConsensusMetadata> cmeta,
@@ -212,12 +216,19 @@ class RaftConsensus : public Consensus,
 
   CHECKED_STATUS GetLastOpId(OpIdType type, OpId* id) override;
 
+  CHECKED_STATUS ReadCommittedReplicates(int64_t after_op_index,
+                                         int max_size_bytes,
+                                         ReplicateMsgs* messages) override;
+
   MicrosTime MajorityReplicatedHtLeaseExpiration(
       MicrosTime min_allowed, MonoTime deadline) const override;
 
   // The on-disk size of the consensus metadata.
   uint64_t OnDiskSize() const;
 
+  // See PeerMessageQueue::EvictLogCache.
+  void EvictLogCache();
+
   void SetPropagatedSafeTimeProvider(std::function<HybridTime()> provider);
 
   void SetPropagatedSafeTimeUpdater(std::function<void()> updater);
@@ -261,6 +272,15 @@ class RaftConsensus : public Consensus,
       const std::string& originator_uuid,
       TEST_SuppressVoteRequest suppress_vote_request) override;
 
+  // Starts the election, after a pre-election unless 'preelected' or pre-elections do not apply.
+  CHECKED_STATUS StartElectionImpl(
+      ElectionMode mode,
+      PreElected preelected,
+      const bool pending_commit,
+      const OpId& must_be_committed_opid,
+      const std::string& originator_uuid,
+      TEST_SuppressVoteRequest suppress_vote_request);
+
   friend class ReplicaState;
   friend class RaftConsensusQuorumTest;
 
@@ -418,6 +438,9 @@ class RaftConsensus : public Consensus,
   CHECKED_STATUS RequestVoteRespondIsBusy(const VoteRequestPB* request,
                                   VoteResponsePB* response);
 
+  // Responds to a pre-election VoteRequest, without changing the term or recording a vote.
+  CHECKED_STATUS RequestPreVote(const VoteRequestPB* request, VoteResponsePB* response);
+
   // Respond to VoteRequest that the vote is granted for candidate.
   CHECKED_STATUS RequestVoteRespondVoteGranted(const VoteRequestPB* request,
                                        VoteResponsePB* response);
@@ -426,6 +449,10 @@ class RaftConsensus : public Consensus,
   // reactor thread, so it simply defers its work to DoElectionCallback.
   void ElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
   void DoElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+
+  // Same for the pre-election, the actual election is started when it is won.
+  void PreElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+  void DoPreElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
   void NotifyOriginatorAboutLostElection(const std::string& originator_uuid);
 
   // Helper struct that tracks the RunLeaderElection as part of leadership transferral.
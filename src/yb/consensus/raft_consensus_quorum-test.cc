@@ -1000,5 +1000,59 @@ TEST_F(RaftConsensusQuorumTest, TestRequestVote) {
   LOG(INFO) << "Follower rejected old heartbeat, as expected: " << res.ShortDebugString();
 }
 
+TEST_F(RaftConsensusQuorumTest, TestRequestPreVote) {
+  ASSERT_OK(BuildAndStartConfig(3));
+
+  OpId last_op_id;
+  vector<scoped_refptr<ConsensusRound> > rounds;
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 2, // The index of the initial leader.
+                                 WAIT_FOR_ALL_REPLICAS,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, 0, 2);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, 1, 2);
+
+  const int kPeerIndex = 1;
+  scoped_refptr<RaftConsensus> peer;
+  CHECK_OK(peers_->GetPeerByIdx(kPeerIndex, &peer));
+
+  VoteRequestPB request;
+  request.set_tablet_id(kTestTablet);
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(last_op_id);
+  request.set_candidate_uuid("peer-0");
+  request.set_candidate_term(last_op_id.term() + 1);
+  request.set_preelection(true);
+
+  // A live leader is not disturbed by a pre-election either.
+  VoteResponsePB response;
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LEADER_IS_ALIVE, response.consensus_error().code());
+
+  // The pre-vote is granted without the voter advancing its term or recording the vote.
+  request.set_ignore_live_leader(true);
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+  ASSERT_EQ(last_op_id.term() + 1, response.responder_term());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kPeerIndex, last_op_id.term()));
+
+  // So another candidate can still be pre-elected for the same term.
+  request.set_candidate_uuid("peer-2");
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+
+  // A candidate that is behind is refused.
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(MinimumOpId());
+  response.Clear();
+  ASSERT_OK(peer->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LAST_OPID_TOO_OLD, response.consensus_error().code());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kPeerIndex, last_op_id.term()));
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -24,9 +24,20 @@
 #include "yb/docdb/intent.h"
 #include "yb/docdb/shared_lock_manager.h"
 
+#include "yb/server/clock.h"
+
+#include "yb/util/atomic.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 
 using namespace std::placeholders;
+using namespace std::literals;
+
+DEFINE_int32(transaction_conflict_max_wait_ms, 1000,
+             "How long a transaction waits for a conflicting transaction of higher priority to "
+             "complete, before its write fails and is retried by the client.");
+TAG_FLAG(transaction_conflict_max_wait_ms, advanced);
+TAG_FLAG(transaction_conflict_max_wait_ms, runtime);
 
 namespace yb {
 namespace docdb {
@@ -75,6 +86,10 @@ class ConflictResolverContext {
 
   virtual HybridTime GetHybridTime() = 0;
 
+  // Called when CheckPriority failed with TryAgain, waits for the conflicting transactions to make
+  // progress. Returns false when no longer willing to wait.
+  virtual bool WaitForConflicts() = 0;
+
  protected:
   ~ConflictResolverContext() {}
 };
@@ -180,7 +195,15 @@ class ConflictResolver {
         return Status::OK();
       }
 
-      RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
+      auto status = context_.CheckPriority(this, &transactions_);
+      if (!status.ok()) {
+        // Waiting here for the transaction we lost to, instead of failing right away, keeps the
+        // lock on the keys, so the other writers of the same keys queue up behind us.
+        if (status.IsTryAgain() && context_.WaitForConflicts()) {
+          continue;
+        }
+        return status;
+      }
 
       AbortTransactions();
 
@@ -286,13 +309,27 @@ class ConflictResolver {
   std::vector<TransactionData> transactions_;
 };
 
+// Wound-wait order of transactions: higher priority first, then the one that started earlier, so
+// that of two conflicting transactions exactly one yields.
+bool HasPriorityOver(const TransactionId& our_id, const TransactionMetadata& ours,
+                     const TransactionId& their_id, const TransactionMetadata& theirs) {
+  if (ours.priority != theirs.priority) {
+    return ours.priority > theirs.priority;
+  }
+  if (ours.start_time != theirs.start_time) {
+    return ours.start_time < theirs.start_time;
+  }
+  return our_id < their_id;
+}
+
 // Utility class for ResolveTransactionConflicts implementation.
 class TransactionConflictResolverContext : public ConflictResolverContext {
  public:
   TransactionConflictResolverContext(const KeyValueWriteBatchPB& write_batch,
-                                     HybridTime hybrid_time)
+                                     server::Clock* clock)
       : write_batch_(write_batch),
-        hybrid_time_(hybrid_time),
+        clock_(clock),
+        hybrid_time_(clock->Now()),
         transaction_id_(FullyDecodeTransactionId(
             write_batch.transaction().transaction_id()))
   {}
@@ -359,7 +396,6 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
 
   CHECKED_STATUS CheckPriority(ConflictResolver* resolver,
                                std::vector<TransactionData>* transactions) override {
-    auto our_priority = metadata_.priority;
     for (auto& transaction : *transactions) {
       if (!fetched_metadata_for_transactions_) {
         auto their_metadata = resolver->Metadata(transaction.id);
@@ -371,16 +407,34 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
         }
         transaction.metadata = std::move(*their_metadata);
       }
-      auto their_priority = transaction.metadata.priority;
-      if (our_priority < their_priority) {
+    }
+    fetched_metadata_for_transactions_ = true;
+
+    for (const auto& transaction : *transactions) {
+      if (!HasPriorityOver(*transaction_id_, metadata_, transaction.id, transaction.metadata)) {
         return MakeConflictStatus(transaction.id, "higher priority");
       }
     }
-    fetched_metadata_for_transactions_ = true;
 
     return Status::OK();
   }
 
+  bool WaitForConflicts() override {
+    auto now = MonoTime::Now();
+    if (!wait_deadline_.Initialized()) {
+      wait_deadline_ = now + MonoDelta::FromMilliseconds(
+          GetAtomicFlag(&FLAGS_transaction_conflict_max_wait_ms));
+    }
+    if (now >= wait_deadline_) {
+      return false;
+    }
+    SleepFor(std::min(MonoDelta(wait_backoff_), wait_deadline_ - now));
+    wait_backoff_ = std::min(wait_backoff_ * 2, std::chrono::milliseconds(50ms));
+    // Statuses are requested at this time, so it has to move for a commit to become visible.
+    hybrid_time_ = clock_->Now();
+    return true;
+  }
+
   CHECKED_STATUS CheckConflictWithCommitted(
       const TransactionId& id, HybridTime commit_time) override {
     if (metadata_.isolation == yb::IsolationLevel::SNAPSHOT_ISOLATION) {
@@ -396,12 +450,15 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   }
 
   const KeyValueWriteBatchPB& write_batch_;
+  server::Clock* const clock_;
   HybridTime hybrid_time_;
   Result<TransactionId> transaction_id_;
   TransactionMetadata metadata_;
   IntentTypePair intent_types_;
   Status result_ = Status::OK();
   bool fetched_metadata_for_transactions_ = false;
+  MonoTime wait_deadline_;
+  std::chrono::milliseconds wait_backoff_ = 1ms;
 };
 
 class OperationConflictResolverContext : public ConflictResolverContext {
@@ -448,6 +505,10 @@ class OperationConflictResolverContext : public ConflictResolverContext {
     return hybrid_time_;
   }
 
+  bool WaitForConflicts() override {
+    return false;
+  }
+
   CHECKED_STATUS CheckConflictWithCommitted(
       const TransactionId& id, HybridTime commit_time) override {
     hybrid_time_.MakeAtLeast(commit_time);
@@ -462,11 +523,10 @@ class OperationConflictResolverContext : public ConflictResolverContext {
 } // namespace
 
 Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
-                                   HybridTime hybrid_time,
+                                   server::Clock* clock,
                                    rocksdb::DB* db,
                                    TransactionStatusManager* status_manager) {
-  DCHECK(hybrid_time.is_valid());
-  TransactionConflictResolverContext context(write_batch, hybrid_time);
+  TransactionConflictResolverContext context(write_batch, clock);
   ConflictResolver resolver(db, status_manager, &context);
   return resolver.Resolve();
 }
@@ -31,6 +31,10 @@ namespace yb {
 class HybridTime;
 class TransactionStatusManager;
 
+namespace server {
+class Clock;
+}
+
 namespace docdb {
 
 class KeyValueWriteBatchPB;
@@ -39,14 +43,15 @@ class KeyValueWriteBatchPB;
 // Read all intents that could conflict with intents generated by provided write_batch.
 // Forms set of conflicting transactions.
 // Tries to abort transactions with lower priority.
-// If it conflicts with transaction with higher priority or committed one then error is returned.
+// Waits up to --transaction_conflict_max_wait_ms for transactions with higher priority to complete.
+// If it still conflicts with one of them, or with a committed one, then error is returned.
 //
 // write_batch - values that would be written as part of transaction.
-// hybrid_time - current hybrid time.
+// clock - clock of the tablet, statuses of the conflicting transactions are requested at its time.
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
-                                           HybridTime hybrid_time,
+                                           server::Clock* clock,
                                            rocksdb::DB* db,
                                            TransactionStatusManager* status_manager);
 
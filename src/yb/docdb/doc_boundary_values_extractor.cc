@@ -13,10 +13,15 @@
 //
 //
 
+#include <limits>
+
 #include "yb/rocksdb/db/dbformat.h"
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/value.h"
+#include "yb/gutil/endian.h"
 
 namespace yb {
 namespace docdb {
@@ -27,9 +32,16 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
                          size_t index,
                          PrimitiveValue* out);
 
+MicrosTime MaxExpirationMicros(const rocksdb::UserBoundaryValues& values, MonoDelta table_ttl);
+
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+// Expiration time of entries with a TTL of their own. Entries that never expire, as well as
+// intents and other entries whose value could not be decoded, use kNeverExpires.
+constexpr rocksdb::UserBoundaryTag kValueExpirationTag = 2;
+// Physical write time of entries without a TTL of their own, which expire by the table TTL.
+constexpr rocksdb::UserBoundaryTag kTableTtlWriteTimeTag = 3;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +92,62 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+constexpr MicrosTime kNeverExpires = std::numeric_limits<MicrosTime>::max();
+
+// Wrapper for UserBoundaryValue that stores a time in microseconds, encoded in big endian order,
+// so encoded values compare the same way as times.
+class MicrosTimeValue : public rocksdb::UserBoundaryValue {
+ public:
+  MicrosTimeValue(rocksdb::UserBoundaryTag tag, MicrosTime micros) : tag_(tag) {
+    BigEndian::Store64(buffer_, micros);
+  }
+
+  static CHECKED_STATUS Create(rocksdb::UserBoundaryTag tag, Slice data,
+                               rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(MicrosTime)) {
+      return STATUS_SUBSTITUTE(Corruption, "Wrong size of encoded time: $0", data.size());
+    }
+
+    *value = std::make_shared<MicrosTimeValue>(tag, BigEndian::Load64(data.data()));
+    return Status::OK();
+  }
+
+  virtual ~MicrosTimeValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return tag_;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const MicrosTimeValue*>(&pre_rhs);
+    return memcmp(buffer_, rhs->buffer_, sizeof(buffer_));
+  }
+
+  MicrosTime value() const {
+    return BigEndian::Load64(buffer_);
+  }
+
+ private:
+  rocksdb::UserBoundaryTag tag_;
+  uint8_t buffer_[sizeof(MicrosTime)];
+};
+
+// Returns the time after which an entry with the given TTL written at the given time has expired.
+// The table TTL is applied to entries without a TTL of their own by MaxExpirationMicros.
+MicrosTime ValueExpirationMicros(MicrosTime write_micros, const MonoDelta& ttl) {
+  if (ttl.ToMilliseconds() == kResetTTL) {
+    return kNeverExpires;
+  }
+  // Round up, so the entry has expired at every hybrid time with a greater physical component.
+  const uint64_t ttl_micros = (ttl.ToNanoseconds() + 999) / 1000;
+  return write_micros < kNeverExpires - ttl_micros ? write_micros + ttl_micros : kNeverExpires;
+}
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -147,6 +215,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kValueExpirationTag || tag == kTableTtlWriteTimeTag) {
+      return MicrosTimeValue::Create(tag, data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -159,7 +230,22 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
         static_cast<ValueType>(user_key[0]) == ValueType::kIntentPrefix &&
         static_cast<ValueType>(user_key[1]) == ValueType::kTransactionId) {
       // Skipping reverse index from transaction id to keys of write intents belonging to that
-      // transaction.
+      // transaction. Files containing it should not be dropped as expired though.
+      values->push_back(std::make_shared<MicrosTimeValue>(kValueExpirationTag, kNeverExpires));
+      return Status::OK();
+    }
+
+    if (!user_key.empty() &&
+        static_cast<ValueType>(user_key[0]) == ValueType::kRangeTombstonePrefix) {
+      // Range tombstones have no DocKey, only their hybrid time is recorded. They hide older data
+      // of other files, so files containing them should not be dropped as expired either.
+      int encoded_ht_size = 0;
+      RETURN_NOT_OK(DocHybridTime::CheckAndGetEncodedSize(user_key, &encoded_ht_size));
+      rocksdb::UserBoundaryValuePtr doc_ht;
+      RETURN_NOT_OK(DocHybridTimeValue::Create(
+          Slice(user_key.data() + user_key.size() - encoded_ht_size, encoded_ht_size), &doc_ht));
+      values->push_back(std::move(doc_ht));
+      values->push_back(std::make_shared<MicrosTimeValue>(kValueExpirationTag, kNeverExpires));
       return Status::OK();
     }
 
@@ -183,11 +269,36 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
       values->push_back(std::move(temp));
     }
 
+    RETURN_NOT_OK(ExtractExpiration(user_key, slices.back(), value, values));
+
     DCHECK(PerformSanityCheck(user_key, slices, *values));
 
     return Status::OK();
   }
 
+  // Records when the entry expires, so files whose entries have all expired could be dropped
+  // without reading them.
+  CHECKED_STATUS ExtractExpiration(Slice user_key, Slice encoded_doc_ht, Slice value,
+                                   rocksdb::UserBoundaryValues* values) {
+    MonoDelta ttl;
+    if (static_cast<ValueType>(user_key[0]) == ValueType::kIntentPrefix ||
+        !Value::DecodeTTL(value, &ttl).ok()) {
+      values->push_back(std::make_shared<MicrosTimeValue>(kValueExpirationTag, kNeverExpires));
+      return Status::OK();
+    }
+    DocHybridTime doc_ht;
+    RETURN_NOT_OK(doc_ht.FullyDecodeFrom(encoded_doc_ht));
+    if (ttl.Equals(Value::kMaxTtl)) {
+      values->push_back(std::make_shared<MicrosTimeValue>(
+          kTableTtlWriteTimeTag, doc_ht.hybrid_time().GetPhysicalValueMicros()));
+    } else {
+      values->push_back(std::make_shared<MicrosTimeValue>(
+          kValueExpirationTag,
+          ValueExpirationMicros(doc_ht.hybrid_time().GetPhysicalValueMicros(), ttl)));
+    }
+    return Status::OK();
+  }
+
   rocksdb::UserFrontierPtr CreateFrontier() override {
     return new docdb::ConsensusFrontier();
   }
@@ -253,6 +364,29 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+// Returns the time after which all entries of a file with the given largest boundary values have
+// expired, or kNeverExpires if there is no such time.
+MicrosTime MaxExpirationMicros(const rocksdb::UserBoundaryValues& values, MonoDelta table_ttl) {
+  auto value_expiration = rocksdb::UserValueWithTag(values, kValueExpirationTag);
+  auto table_ttl_write_time = rocksdb::UserValueWithTag(values, kTableTtlWriteTimeTag);
+  if (!value_expiration && !table_ttl_write_time) {
+    // The file was written before expiration was tracked, or was added from outside.
+    return kNeverExpires;
+  }
+  MicrosTime result = 0;
+  if (value_expiration) {
+    result = down_cast<MicrosTimeValue*>(value_expiration.get())->value();
+  }
+  if (table_ttl_write_time) {
+    if (table_ttl.Equals(Value::kMaxTtl)) {
+      return kNeverExpires;
+    }
+    const auto* write_time = down_cast<MicrosTimeValue*>(table_ttl_write_time.get());
+    result = std::max(result, ValueExpirationMicros(write_time->value(), table_ttl));
+  }
+  return result;
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
@@ -269,6 +269,38 @@ TEST(DocKeyTest, TestBasicSubDocKeyEncodingDecoding) {
   ASSERT_EQ(subdoc_key.doc_hybrid_time(), time);
 }
 
+TEST(DocKeyTest, TestSubDocKeyDecodingWithKnownDocKey) {
+  const DocKey doc_key({PrimitiveValue("some_doc_key"), PrimitiveValue(10)});
+  const DocKey other_doc_key({PrimitiveValue("other_doc_key")});
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+
+  SubDocKey decoded_subdoc_key(doc_key);
+  for (const auto& subdoc_key : {
+      SubDocKey(doc_key, PrimitiveValue("sk1"), HybridTime::FromMicros(1000)),
+      SubDocKey(doc_key, PrimitiveValue("sk1"), PrimitiveValue(20), HybridTime::FromMicros(2000)),
+      SubDocKey(doc_key, HybridTime::FromMicros(3000)),
+      SubDocKey(doc_key, PrimitiveValue("sk2"), HybridTime::FromMicros(4000))}) {
+    ASSERT_OK(decoded_subdoc_key.FullyDecodeFromWithKnownDocKey(
+        subdoc_key.Encode().AsSlice(), encoded_doc_key.AsSlice()));
+    ASSERT_EQ(subdoc_key, decoded_subdoc_key);
+  }
+
+  // A key of another document is fully decoded.
+  const SubDocKey other_subdoc_key(
+      other_doc_key, PrimitiveValue("sk1"), HybridTime::FromMicros(5000));
+  ASSERT_OK(decoded_subdoc_key.FullyDecodeFromWithKnownDocKey(
+      other_subdoc_key.Encode().AsSlice(), encoded_doc_key.AsSlice()));
+  ASSERT_EQ(other_subdoc_key, decoded_subdoc_key);
+
+  // Extra bytes after the hybrid time are reported.
+  KeyBytes with_extra_bytes(
+      SubDocKey(doc_key, PrimitiveValue("sk1"), HybridTime::FromMicros(1000)).Encode());
+  with_extra_bytes.AppendRawBytes("x", 1);
+  SubDocKey same_doc_key(doc_key);
+  ASSERT_NOK(same_doc_key.FullyDecodeFromWithKnownDocKey(
+      with_extra_bytes.AsSlice(), encoded_doc_key.AsSlice()));
+}
+
 TEST(DocKeyTest, TestRandomizedDocKeyRoundTripEncodingDecoding) {
   TestRoundTripDocOrSubDocKeyEncodingDecoding<DocKey>();
 }
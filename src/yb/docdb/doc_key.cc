@@ -417,6 +417,16 @@ Status SubDocKey::DecodeFrom(rocksdb::Slice* slice, HybridTimeRequired require_h
   return DoDecode(slice, require_hybrid_time, DecodeCallback(this));
 }
 
+// Same as DecodeCallback, but keeps the DocKey already present in the SubDocKey.
+class SubDocKey::DecodeSubkeysCallback : public SubDocKey::DecodeCallback {
+ public:
+  explicit DecodeSubkeysCallback(SubDocKey* key) : DecodeCallback(key) {}
+
+  CHECKED_STATUS DecodeDocKey(Slice* slice) const {
+    return Status::OK();
+  }
+};
+
 Result<bool> SubDocKey::DecodeSubkey(Slice* slice) {
   return DecodeSubkey(slice, DummyCallback());
 }
@@ -481,6 +491,27 @@ Status SubDocKey::FullyDecodeFrom(const rocksdb::Slice& slice,
   return status;
 }
 
+Status SubDocKey::FullyDecodeFromWithKnownDocKey(const rocksdb::Slice& slice,
+                                                 const rocksdb::Slice& encoded_doc_key,
+                                                 HybridTimeRequired require_hybrid_time) {
+  if (encoded_doc_key.empty() || !slice.starts_with(encoded_doc_key)) {
+    return FullyDecodeFrom(slice, require_hybrid_time);
+  }
+  // The DocKey encoding is self-delimiting, so a key starting with encoded_doc_key has exactly
+  // this DocKey.
+  rocksdb::Slice mutable_slice(slice.data() + encoded_doc_key.size(),
+                               slice.size() - encoded_doc_key.size());
+  subkeys_.clear();
+  doc_ht_ = DocHybridTime::kInvalid;
+  Status status = DoDecode(&mutable_slice, require_hybrid_time, DecodeSubkeysCallback(this));
+  if (!mutable_slice.empty()) {
+    return STATUS_SUBSTITUTE(InvalidArgument,
+        "Expected all bytes of the slice to be decoded into DocKey, found $0 extra bytes: $1",
+        mutable_slice.size(), ToShortDebugStr(mutable_slice));
+  }
+  return status;
+}
+
 std::string SubDocKey::DebugSliceToString(Slice slice) {
   SubDocKey key;
   auto status = key.FullyDecodeFrom(slice, HybridTimeRequired::kFalse);
@@ -696,6 +727,15 @@ const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTrans
   return &HashedComponentsExtractor::GetInstance();
 }
 
+// ------------------------------------------------------------------------------------------------
+// DocKeySliceTransform
+// ------------------------------------------------------------------------------------------------
+
+Slice DocKeySliceTransform::Transform(const Slice& key) const {
+  auto size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+  return size.ok() ? Slice(key.data(), *size) : key;
+}
+
 }  // namespace docdb
 
 }  // namespace yb
@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/util/slice.h"
 #include "yb/util/strongly_typed_bool.h"
 
@@ -322,6 +323,15 @@ class SubDocKey {
       const rocksdb::Slice& slice,
       HybridTimeRequired hybrid_time_required = HybridTimeRequired::kTrue);
 
+  // Same as FullyDecodeFrom, but when the slice starts with encoded_doc_key, which must be the
+  // encoding of the DocKey already held by this SubDocKey, the DocKey is kept and only the subkeys
+  // and the hybrid time are decoded. Used when decoding many keys of the same document, e.g. all
+  // the entries of a row visited during a scan. Falls back to a full decode otherwise.
+  CHECKED_STATUS FullyDecodeFromWithKnownDocKey(
+      const rocksdb::Slice& slice,
+      const rocksdb::Slice& encoded_doc_key,
+      HybridTimeRequired hybrid_time_required = HybridTimeRequired::kTrue);
+
   // Splits given RocksDB key into vector of slices that forms range_group of document key and
   // hybrid_time.
   static CHECKED_STATUS PartiallyDecode(Slice* slice,
@@ -467,6 +477,8 @@ class SubDocKey {
  private:
   class DecodeCallback;
   friend class DecodeCallback;
+  class DecodeSubkeysCallback;
+  friend class DecodeSubkeysCallback;
 
   // Attempts to decode and consume a subkey from the beginning of the given slice.
   // A non-error false result means e.g. that the slice is empty or if the next thing is an encoded
@@ -499,9 +511,13 @@ std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 // This filter policy only takes into account hashed components of keys for filtering.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
+  // With split_block, new filters use the split block layout, see NewFixedSizeFilterPolicy. Files
+  // with either layout are read by either policy.
+  DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger,
+                         bool split_block = false) {
     builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger,
+        split_block));
   }
 
   const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
@@ -522,6 +538,19 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
 };
 
+// Maps a key to its encoded DocKey, so that the memtable groups all keys of a document together.
+// Keys that could not be decoded as a DocKey are mapped to themselves.
+class DocKeySliceTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "DocKeySliceTransform"; }
+
+  Slice Transform(const Slice& key) const override;
+
+  bool InDomain(const Slice& key) const override { return true; }
+
+  bool InRange(const Slice& prefix) const override { return true; }
+};
+
 }  // namespace docdb
 }  // namespace yb
 
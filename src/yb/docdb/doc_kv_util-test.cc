@@ -14,6 +14,7 @@
 #include "yb/docdb/doc_kv_util.h"
 
 #include <string>
+#include <vector>
 
 #include "yb/docdb/value.h"
 #include "yb/util/test_macros.h"
@@ -21,6 +22,7 @@
 #include "yb/util/bytes_formatter.h"
 
 #include "yb/util/slice.h"
+#include "yb/util/stopwatch.h"
 #include "yb/rocksdb/util/random.h"
 
 using std::string;
@@ -114,6 +116,34 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345); // initialize with a fixed seed
+  for (int i = 0; i < 1000; ++i) {
+    // Use long strings with few distinct characters, so that zero and 0xff characters show up at
+    // every position relative to the chunks processed at a time by the encoder and decoder.
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      static const char kChars[] = { '\0', '\x01', '\xfe', '\xff', 'a' };
+      s.push_back(kChars[rng.Next() % sizeof(kChars)]);
+    }
+    string encoded_str;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+    encoded_str.append("suffix");
+    for (bool get_result : { true, false }) {
+      rocksdb::Slice slice(encoded_str);
+      string decoded_str;
+      ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, get_result ? &decoded_str : nullptr));
+      ASSERT_EQ("suffix", slice.ToBuffer());
+      ASSERT_EQ(get_result ? s : "", decoded_str);
+    }
+
+    string zero_encoded_str = ZeroEncodeStr(s);
+    ASSERT_EQ(s, DecodeZeroEncodedStr(zero_encoded_str));
+  }
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
@@ -163,5 +193,44 @@ TEST(DocKVUtilTest, DoubleEncoding) {
   }
 }
 
+#ifdef NDEBUG
+TEST(DocKVUtilTest, BenchmarkZeroEncoding) {
+  rocksdb::Random rng(12345);
+  std::vector<string> strs(1000);
+  for (auto& s : strs) {
+    s.resize(100);
+    for (auto& c : s) {
+      c = static_cast<char>(rng.Next());
+    }
+  }
+
+  size_t total_size = 0; // use the results to avoid optimizing the loops out.
+  LOG_TIMING(INFO, "Encoding and decoding strings in ascending order") {
+    for (int trial = 0; trial < 1000; ++trial) {
+      for (const auto& s : strs) {
+        const string encoded_str = ZeroEncodeStr(s);
+        rocksdb::Slice slice(encoded_str);
+        string decoded_str;
+        ASSERT_OK(DecodeZeroEncodedStr(&slice, &decoded_str));
+        total_size += decoded_str.size();
+      }
+    }
+  }
+  LOG_TIMING(INFO, "Encoding and decoding strings in descending order") {
+    for (int trial = 0; trial < 1000; ++trial) {
+      for (const auto& s : strs) {
+        string encoded_str;
+        ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+        rocksdb::Slice slice(encoded_str);
+        string decoded_str;
+        ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+        total_size += decoded_str.size();
+      }
+    }
+  }
+  ASSERT_EQ(2 * 1000 * strs.size() * 100, total_size);
+}
+#endif
+
 }  // namespace docdb
 }  // namespace yb
@@ -13,6 +13,10 @@
 
 #include "yb/docdb/doc_kv_util.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/value.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -72,6 +76,36 @@ Status CheckHybridTimeSizeAndValueType(
   return Status::OK();
 }
 
+namespace {
+
+#ifdef __SSE2__
+// Strings are scanned this many bytes at a time for the characters that need escaping.
+constexpr ptrdiff_t kEncodingChunkSize = 16;
+
+// Returns a mask with bit i set if the i-th of the kEncodingChunkSize bytes at p is equal to c.
+inline int ChunkByteMask(const char* p, char c) {
+  const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c)));
+}
+#endif
+
+// Appends n bytes starting at p to dest, with every byte xor-ed with X.
+template <char X>
+inline void AppendXorEncoded(const char* p, size_t n, string* dest) {
+  if (X == '\0') {
+    dest->append(p, n);
+    return;
+  }
+  const size_t old_size = dest->size();
+  dest->resize(old_size + n);
+  char* out = &(*dest)[old_size];
+  for (size_t i = 0; i != n; ++i) {
+    out[i] = p[i] ^ X;
+  }
+}
+
+}  // namespace
+
 template <char END_OF_STRING>
 void AppendEncodedStrToKey(const string &s, string *dest) {
   static_assert(END_OF_STRING == '\0' || END_OF_STRING == '\xff',
@@ -79,14 +113,30 @@ void AppendEncodedStrToKey(const string &s, string *dest) {
   if (END_OF_STRING == '\0' && s.find('\0') == string::npos) {
     // Fast path: no zero characters, nothing to encode.
     dest->append(s);
-  } else {
-    for (char c : s) {
-      if (c == '\0') {
-        dest->push_back(END_OF_STRING);
-        dest->push_back(END_OF_STRING ^ 1);
-      } else {
-        dest->push_back(END_OF_STRING ^ c);
-      }
+    return;
+  }
+  const char* p = s.data();
+  const char* const end = p + s.size();
+#ifdef __SSE2__
+  // Copy the runs of bytes preceding each zero character a chunk at a time.
+  while (end - p >= kEncodingChunkSize) {
+    const int zeros_mask = ChunkByteMask(p, '\0');
+    const size_t run_length = zeros_mask == 0 ? kEncodingChunkSize : __builtin_ctz(zeros_mask);
+    AppendXorEncoded<END_OF_STRING>(p, run_length, dest);
+    p += run_length;
+    if (zeros_mask != 0) {
+      dest->push_back(END_OF_STRING);
+      dest->push_back(END_OF_STRING ^ 1);
+      ++p;
+    }
+  }
+#endif
+  for (; p != end; ++p) {
+    if (*p == '\0') {
+      dest->push_back(END_OF_STRING);
+      dest->push_back(END_OF_STRING ^ 1);
+    } else {
+      dest->push_back(END_OF_STRING ^ *p);
     }
   }
 }
@@ -122,6 +172,21 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   const char* end = p + slice->size();
 
   while (p != end) {
+#ifdef __SSE2__
+    // Skip to the next END_OF_STRING character a chunk at a time.
+    if (end - p >= kEncodingChunkSize) {
+      const int terminators_mask = ChunkByteMask(p, END_OF_STRING);
+      const size_t run_length =
+          terminators_mask == 0 ? kEncodingChunkSize : __builtin_ctz(terminators_mask);
+      if (result != nullptr) {
+        AppendXorEncoded<END_OF_STRING>(p, run_length, result);
+      }
+      p += run_length;
+      if (terminators_mask == 0) {
+        continue;
+      }
+    }
+#endif
     if (*p == END_OF_STRING) {
       ++p;
       if (p == end) {
@@ -34,6 +34,7 @@
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_bool(ql_pack_inserted_columns);
 
 using namespace std::literals; // NOLINT
 
@@ -101,6 +102,22 @@ class DocOperationTest : public DocDBTestBase {
     ASSERT_OK(WriteToRocksDB(doc_write_batch, hybrid_time));
   }
 
+  // Applies the write to a table with the given indexes and returns the index updates.
+  QLWriteOperation::IndexRequests WriteQLWithIndexes(QLWriteRequestPB* ql_writereq_pb,
+                                                     const Schema& schema,
+                                                     const IndexMap& index_map,
+                                                     const HybridTime& hybrid_time) {
+    QLResponsePB ql_writeresp_pb;
+    QLWriteOperation ql_write_op(schema, kNonTransactionalOperationContext, &index_map);
+    EXPECT_OK(ql_write_op.Init(ql_writereq_pb, &ql_writeresp_pb));
+    auto doc_write_batch = MakeDocWriteBatch();
+    HybridTime restart_read_ht;
+    EXPECT_OK(ql_write_op.Apply(
+        {&doc_write_batch, ReadHybridTime::SingleTime(hybrid_time), &restart_read_ht}));
+    EXPECT_OK(WriteToRocksDB(doc_write_batch, hybrid_time));
+    return ql_write_op.index_requests();
+  }
+
   void AssertWithTTL(QLWriteRequestPB_QLStmtType stmt_type) {
     if (stmt_type == QLWriteRequestPB::QL_STMT_INSERT) {
       AssertDocDbDebugDumpStrEq(R"#(
@@ -206,12 +223,14 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
       col->type()->ToQLTypePB(rscol_desc->mutable_ql_type());
     }
 
+    QLProjections projections;
+    EXPECT_OK(CreateQLProjections(schema, ql_read_req.column_refs(), &projections));
     QLReadOperation read_op(ql_read_req, kNonTransactionalOperationContext);
     QLRocksDBStorage ql_storage(rocksdb());
     QLResultSet resultset;
     HybridTime read_restart_ht;
     EXPECT_OK(read_op.Execute(
-        ql_storage, ReadHybridTime::SingleTime(read_time), schema, query_schema, &resultset,
+        ql_storage, ReadHybridTime::SingleTime(read_time), schema, projections, &resultset,
         &read_restart_ht));
     EXPECT_FALSE(read_restart_ht.is_valid());
 
@@ -328,6 +347,162 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ physical: 1000 w: 3 }]) ->
   EXPECT_EQ(3, row_block.row(0).column(3).int32_value());
 }
 
+TEST_F(DocOperationTest, TestQLWriteIndexUpdates) {
+  Schema schema = CreateSchema();
+
+  // Index on c1, with k as the range column and covering c2.
+  IndexInfoPB index_pb;
+  index_pb.set_table_id("index");
+  index_pb.set_version(1);
+  for (const auto& column : {std::make_pair(0, 1), std::make_pair(1, 0), std::make_pair(2, 2)}) {
+    auto* index_column = index_pb.add_columns();
+    index_column->set_column_id(column.first);
+    index_column->set_indexed_column_id(column.second);
+  }
+  index_pb.set_hash_column_count(1);
+  index_pb.set_range_column_count(1);
+  IndexMap index_map;
+  index_map.emplace("index", IndexInfo(index_pb));
+
+  const auto write_time = [](int micros) {
+    return HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(micros, 0);
+  };
+  const auto update_request = [this](QLWriteRequestPB::QLStmtType type, int32_t column_id,
+                                     int32_t value) {
+    QLWriteRequestPB ql_writereq_pb;
+    ql_writereq_pb.set_type(type);
+    AddPrimaryKeyColumn(&ql_writereq_pb, 1);
+    ql_writereq_pb.set_hash_code(0);
+    if (column_id >= 0) {
+      auto column = ql_writereq_pb.add_column_values();
+      column->set_column_id(column_id);
+      column->mutable_expr()->mutable_value()->set_int32_value(value);
+    }
+    return ql_writereq_pb;
+  };
+
+  // Inserting the row adds its index entry.
+  QLWriteRequestPB ql_writereq_pb = update_request(QLWriteRequestPB::QL_STMT_INSERT, -1, 0);
+  AddColumnValues(schema, {10, 20, 30}, &ql_writereq_pb);
+  auto index_requests = WriteQLWithIndexes(&ql_writereq_pb, schema, index_map, write_time(1000));
+  ASSERT_EQ(1U, index_requests.size());
+  EXPECT_EQ("index", index_requests[0].first);
+  const auto& insert_request = index_requests[0].second;
+  EXPECT_EQ(QLWriteRequestPB::QL_STMT_INSERT, insert_request.type());
+  EXPECT_EQ(1, insert_request.schema_version());
+  EXPECT_EQ(10, insert_request.hashed_column_values(0).value().int32_value());
+  EXPECT_EQ(1, insert_request.range_column_values(0).value().int32_value());
+  ASSERT_EQ(1, insert_request.column_values_size());
+  EXPECT_EQ(2, insert_request.column_values(0).column_id());
+  EXPECT_EQ(20, insert_request.column_values(0).expr().value().int32_value());
+
+  // Updating a column that is not indexed leaves the index alone.
+  ql_writereq_pb = update_request(QLWriteRequestPB::QL_STMT_UPDATE, 3, 31);
+  index_requests = WriteQLWithIndexes(&ql_writereq_pb, schema, index_map, write_time(2000));
+  ASSERT_EQ(0U, index_requests.size());
+
+  // Changing the indexed column replaces the index entry.
+  ql_writereq_pb = update_request(QLWriteRequestPB::QL_STMT_UPDATE, 1, 11);
+  index_requests = WriteQLWithIndexes(&ql_writereq_pb, schema, index_map, write_time(3000));
+  ASSERT_EQ(2U, index_requests.size());
+  EXPECT_EQ(QLWriteRequestPB::QL_STMT_DELETE, index_requests[0].second.type());
+  EXPECT_EQ(10, index_requests[0].second.hashed_column_values(0).value().int32_value());
+  EXPECT_EQ(0, index_requests[0].second.column_values_size());
+  EXPECT_EQ(QLWriteRequestPB::QL_STMT_INSERT, index_requests[1].second.type());
+  EXPECT_EQ(11, index_requests[1].second.hashed_column_values(0).value().int32_value());
+  EXPECT_EQ(20, index_requests[1].second.column_values(0).expr().value().int32_value());
+
+  // Deleting the row deletes its index entry.
+  ql_writereq_pb = update_request(QLWriteRequestPB::QL_STMT_DELETE, -1, 0);
+  index_requests = WriteQLWithIndexes(&ql_writereq_pb, schema, index_map, write_time(4000));
+  ASSERT_EQ(1U, index_requests.size());
+  EXPECT_EQ(QLWriteRequestPB::QL_STMT_DELETE, index_requests[0].second.type());
+  EXPECT_EQ(11, index_requests[0].second.hashed_column_values(0).value().int32_value());
+  EXPECT_EQ(1, index_requests[0].second.range_column_values(0).value().int32_value());
+}
+
+TEST_F(DocOperationTest, TestIndexInsertRequestForRow) {
+  // Index on c1, with k as the range column and covering c2.
+  IndexInfoPB index_pb;
+  index_pb.set_table_id("index");
+  index_pb.set_version(1);
+  for (const auto& column : {std::make_pair(0, 1), std::make_pair(1, 0), std::make_pair(2, 2)}) {
+    auto* index_column = index_pb.add_columns();
+    index_column->set_column_id(column.first);
+    index_column->set_indexed_column_id(column.second);
+  }
+  index_pb.set_hash_column_count(1);
+  index_pb.set_range_column_count(1);
+  const IndexInfo index(index_pb);
+
+  QLTableRow row;
+  row.AllocColumn(ColumnId(0)).value.set_int32_value(1);
+  row.AllocColumn(ColumnId(2)).value.set_int32_value(20);
+
+  // A row without the indexed column has no index entry.
+  QLWriteRequestPB index_request;
+  ASSERT_FALSE(IndexInsertRequestForRow(index, row, &index_request));
+
+  row.AllocColumn(ColumnId(1)).value.set_int32_value(10);
+  index_request.Clear();
+  ASSERT_TRUE(IndexInsertRequestForRow(index, row, &index_request));
+  EXPECT_EQ(QLWriteRequestPB::QL_STMT_INSERT, index_request.type());
+  EXPECT_EQ(1, index_request.schema_version());
+  EXPECT_EQ(10, index_request.hashed_column_values(0).value().int32_value());
+  EXPECT_EQ(1, index_request.range_column_values(0).value().int32_value());
+  ASSERT_EQ(1, index_request.column_values_size());
+  EXPECT_EQ(2, index_request.column_values(0).column_id());
+  EXPECT_EQ(20, index_request.column_values(0).expr().value().int32_value());
+}
+
+TEST_F(DocOperationTest, TestQLReadWritePackedRow) {
+  FLAGS_ql_pack_inserted_columns = true;
+  Schema schema = CreateSchema();
+  WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, vector<int>({1, 1, 2, 3}),
+             1000, HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 0));
+
+  AssertDocDbDebugDumpStrEq(R"#(
+SubDocKey(DocKey(0x0000, [1], []), [SystemColumnId(1); HT{ physical: 1000 }]) -> \
+    PackedRow(1: 1, 2: 2, 3: 3); ttl: 1.000s
+      )#");
+
+  QLRowBlock row_block = ReadQLRow(schema, 1,
+                                   HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(2000, 0));
+  ASSERT_EQ(1, row_block.row_count());
+  EXPECT_EQ(1, row_block.row(0).column(0).int32_value());
+  EXPECT_EQ(1, row_block.row(0).column(1).int32_value());
+  EXPECT_EQ(2, row_block.row(0).column(2).int32_value());
+  EXPECT_EQ(3, row_block.row(0).column(3).int32_value());
+
+  // A later update of a single column takes precedence over the packed value.
+  yb::QLWriteRequestPB ql_writereq_pb;
+  yb::QLResponsePB ql_writeresp_pb;
+  ql_writereq_pb.set_type(QLWriteRequestPB_QLStmtType_QL_STMT_UPDATE);
+  ql_writereq_pb.set_hash_code(0);
+  AddPrimaryKeyColumn(&ql_writereq_pb, 1);
+  auto column = ql_writereq_pb.add_column_values();
+  column->set_column_id(2);
+  column->mutable_expr()->mutable_value()->set_int32_value(20);
+  WriteQL(&ql_writereq_pb, schema, &ql_writeresp_pb,
+          HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1500, 0));
+
+  row_block = ReadQLRow(schema, 1, HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(2000, 0));
+  ASSERT_EQ(1, row_block.row_count());
+  EXPECT_EQ(1, row_block.row(0).column(1).int32_value());
+  EXPECT_EQ(20, row_block.row(0).column(2).int32_value());
+  EXPECT_EQ(3, row_block.row(0).column(3).int32_value());
+
+  // A newer packed row overwrites both the older packed row and the update.
+  WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, vector<int>({1, 4, 5, 6}),
+             1000, HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1600, 0));
+
+  row_block = ReadQLRow(schema, 1, HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(2000, 0));
+  ASSERT_EQ(1, row_block.row_count());
+  EXPECT_EQ(4, row_block.row(0).column(1).int32_value());
+  EXPECT_EQ(5, row_block.row(0).column(2).int32_value());
+  EXPECT_EQ(6, row_block.row(0).column(3).int32_value());
+}
+
 TEST_F(DocOperationTest, TestQLReadWithoutLivenessColumn) {
   const DocKey doc_key(0, PrimitiveValues(PrimitiveValue::Int32(100)), PrimitiveValues());
   KeyBytes encoded_doc_key(doc_key.Encode());
@@ -514,6 +689,7 @@ std::ostream& operator<<(std::ostream& out, const RowData& row) {
 class DocOperationRangeFilterTest : public DocOperationTest {
  public:
   void TestWithSortingType(ColumnSchema::SortingType schema_type, bool is_forward_scan = true);
+  void TestInCondition(ColumnSchema::SortingType schema_type);
  private:
 };
 
@@ -615,6 +791,55 @@ void DocOperationRangeFilterTest::TestWithSortingType(ColumnSchema::SortingType
 
 } // namespace
 
+void DocOperationRangeFilterTest::TestInCondition(ColumnSchema::SortingType schema_type) {
+  ColumnSchema hash_column("k", INT32, false, true);
+  ColumnSchema range_column("r", INT32, false, false, false, false, schema_type);
+  ColumnSchema value_column("v", INT32, false, false);
+  auto columns = { hash_column, range_column, value_column };
+  Schema schema(columns, CreateColumnIds(columns.size()), 2);
+
+  auto t = HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 0);
+  constexpr int32_t kKey = 1;
+  constexpr int32_t kNumRows = 20;
+  for (int32_t i = 0; i != kNumRows; ++i) {
+    WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, { kKey, i * 10, i }, 1000, t);
+  }
+
+  // Values outside of the written range and duplicates are allowed in the IN list.
+  const std::vector<int32_t> in_values = { 150, 30, -10, 30, 70, 1000 };
+  std::vector<RowData> expected_rows = { {kKey, 30, 3}, {kKey, 70, 7}, {kKey, 150, 15} };
+  if (schema_type == ColumnSchema::kDescending) {
+    std::reverse(expected_rows.begin(), expected_rows.end());
+  }
+
+  std::vector<PrimitiveValue> hashed_components = { PrimitiveValue::Int32(kKey) };
+  QLConditionPB condition;
+  condition.add_operands()->set_column_id(1_ColId);
+  condition.set_op(QL_OP_IN);
+  auto* list_value = condition.add_operands()->mutable_value()->mutable_list_value();
+  for (auto value : in_values) {
+    list_value->add_elems()->set_int32_value(value);
+  }
+
+  DocQLScanSpec ql_scan_spec(schema, -1, -1, hashed_components, &condition,
+                             rocksdb::kDefaultQueryId);
+  ASSERT_EQ(1, ql_scan_spec.range_options().size());
+  ASSERT_EQ(5, ql_scan_spec.range_options()[0].size());
+
+  DocRowwiseIterator ql_iter(schema, schema, boost::none, rocksdb(),
+                             ReadHybridTime::FromMicros(3000));
+  ASSERT_OK(ql_iter.Init(ql_scan_spec));
+  std::vector<RowData> fetched_rows;
+  while (ql_iter.HasNext()) {
+    QLTableRow value_map;
+    ASSERT_OK(ql_iter.NextRow(&value_map));
+    fetched_rows.push_back({ value_map.TestValue(0_ColId).value.int32_value(),
+                             value_map.TestValue(1_ColId).value.int32_value(),
+                             value_map.TestValue(2_ColId).value.int32_value() });
+  }
+  ASSERT_EQ(expected_rows, fetched_rows);
+}
+
 TEST_F_EX(DocOperationTest, QLRangeFilterAscending, DocOperationRangeFilterTest) {
   TestWithSortingType(ColumnSchema::kAscending, true);
 }
@@ -631,6 +856,14 @@ TEST_F_EX(DocOperationTest, TestQLDescAscScan, DocOperationRangeFilterTest) {
   TestWithSortingType(ColumnSchema::kDescending, false);
 }
 
+TEST_F_EX(DocOperationTest, QLRangeFilterInAscending, DocOperationRangeFilterTest) {
+  TestInCondition(ColumnSchema::kAscending);
+}
+
+TEST_F_EX(DocOperationTest, QLRangeFilterInDescending, DocOperationRangeFilterTest) {
+  TestInCondition(ColumnSchema::kDescending);
+}
+
 TEST_F(DocOperationTest, TestQLCompactions) {
   yb::QLWriteRequestPB ql_writereq_pb;
   yb::QLResponsePB ql_writeresp_pb;
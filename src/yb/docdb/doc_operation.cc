@@ -11,6 +11,9 @@
 // under the License.
 //
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "yb/common/partition.h"
 #include "yb/common/ql_scanspec.h"
 #include "yb/common/ql_storage_interface.h"
@@ -23,13 +26,26 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
+#include "yb/util/stol_utils.h"
 #include "yb/util/trace.h"
 
 DECLARE_bool(trace_docdb_calls);
 
+DEFINE_int32(ql_scan_batch_size, 64,
+             "Number of rows fetched from the DocDB iterator at a time by QL reads of tables "
+             "without static columns. Values of 1 or less fetch rows one at a time.");
+
+DEFINE_bool(ql_pack_inserted_columns, false,
+            "If true, a QL INSERT without a user timestamp that sets all non-static columns of "
+            "the row to scalar values stores them as a single packed row value instead of one "
+            "value per column.");
+
 using strings::Substitute;
 using yb::bfql::TSOpcode;
 
@@ -40,6 +56,12 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_int32(redis_chunked_string_min_bytes, 256 * 1024,
+             "APPEND and SETRANGE store the redis strings they make at least this long in chunks, "
+             "so that the later APPEND, SETRANGE, STRLEN and GETRANGE commands on them only read "
+             "and write the chunks they need. 0 or less keeps all the strings in a single value.");
+TAG_FLAG(redis_chunked_string_min_bytes, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -115,7 +137,67 @@ CHECKED_STATUS PrimitiveValueFromSubKeyStrict(const RedisKeyValueSubKeyPB &subke
   return PrimitiveValueFromSubKey(subkey_pb, primitive_value);
 }
 
-Result<RedisDataType> GetRedisValueType(
+// Redis strings that APPEND or SETRANGE make at least FLAGS_redis_chunked_string_min_bytes long
+// are stored as a kRedisString subdocument: the length of the string under the kCounter subkey,
+// which sorts before the int64 subkeys, and the bytes of the string in chunks of
+// kRedisStringChunkSize under the int64 chunk indexes. The bytes that no chunk covers, e.g. of
+// the gap that SETRANGE past the end leaves, are zeros.
+constexpr int64_t kRedisStringChunkSize = 64 * 1024;
+
+// Copies the bytes of the chunks of a kRedisString subdocument, that fall into
+// [begin, begin + out->size()), to out.
+void CopyRedisStringChunks(const SubDocument& doc, int64_t begin, std::string* out) {
+  if (doc.object_num_keys() == 0) {
+    return;
+  }
+  const int64_t end = begin + out->size();
+  for (const auto& entry : doc.object_container()) {
+    if (entry.first.value_type() != ValueType::kInt64 ||
+        entry.second.value_type() != ValueType::kString) {
+      continue;
+    }
+    const int64_t chunk_begin = entry.first.GetInt64() * kRedisStringChunkSize;
+    const std::string& chunk = entry.second.GetString();
+    const int64_t from = std::max(begin, chunk_begin);
+    const int64_t to = std::min<int64_t>(end, chunk_begin + chunk.size());
+    if (from < to) {
+      memcpy(&(*out)[from - begin], chunk.data() + from - chunk_begin, to - from);
+    }
+  }
+}
+
+int64_t RedisStringLength(const SubDocument& doc) {
+  const auto* length = doc.GetChild(PrimitiveValue(ValueType::kCounter));
+  return length && length->value_type() == ValueType::kInt64 ? length->GetInt64() : 0;
+}
+
+Result<RedisDataType> ToRedisDataType(ValueType value_type) {
+  switch (value_type) {
+    case ValueType::kInvalidValueType: FALLTHROUGH_INTENDED;
+    case ValueType::kTombstone:
+      return REDIS_TYPE_NONE;
+    case ValueType::kObject:
+      return REDIS_TYPE_HASH;
+    case ValueType::kRedisSet:
+      return REDIS_TYPE_SET;
+    case ValueType::kRedisTS:
+      return REDIS_TYPE_TIMESERIES;
+    case ValueType::kRedisSortedSet:
+      return REDIS_TYPE_SORTEDSET;
+    case ValueType::kRedisString: FALLTHROUGH_INTENDED;
+    case ValueType::kNull: FALLTHROUGH_INTENDED; // This value is a set member.
+    case ValueType::kString:
+      return REDIS_TYPE_STRING;
+    default:
+      return STATUS_FORMAT(Corruption,
+                           "Unknown value type for redis record: $0",
+                           static_cast<char>(value_type));
+  }
+}
+
+// Returns the value type of the key, or of its subkey_index'th subkey, or kInvalidValueType if
+// there is no such value.
+Result<ValueType> GetRedisDocValueType(
     rocksdb::DB* rocksdb,
     const ReadHybridTime& read_time,
     const RedisKeyValuePB &key_value_pb,
@@ -160,30 +242,20 @@ Result<RedisDataType> GetRedisValueType(
         rocksdb, data, redis_query_id, boost::none /* txn_op_context */, read_time));
   }
 
-  if (!doc_found) {
-    return REDIS_TYPE_NONE;
-  }
+  return doc_found ? doc.value_type() : ValueType::kInvalidValueType;
+}
 
-  switch (doc.value_type()) {
-    case ValueType::kInvalidValueType: FALLTHROUGH_INTENDED;
-    case ValueType::kTombstone:
-      return REDIS_TYPE_NONE;
-    case ValueType::kObject:
-      return REDIS_TYPE_HASH;
-    case ValueType::kRedisSet:
-      return REDIS_TYPE_SET;
-    case ValueType::kRedisTS:
-      return REDIS_TYPE_TIMESERIES;
-    case ValueType::kRedisSortedSet:
-      return REDIS_TYPE_SORTEDSET;
-    case ValueType::kNull: FALLTHROUGH_INTENDED; // This value is a set member.
-    case ValueType::kString:
-      return REDIS_TYPE_STRING;
-    default:
-      return STATUS_FORMAT(Corruption,
-                           "Unknown value type for redis record: $0",
-                           static_cast<char>(doc.value_type()));
-  }
+Result<RedisDataType> GetRedisValueType(
+    rocksdb::DB* rocksdb,
+    const ReadHybridTime& read_time,
+    const RedisKeyValuePB &key_value_pb,
+    rocksdb::QueryId redis_query_id,
+    DocWriteBatch* doc_write_batch = nullptr,
+    int subkey_index = -1) {
+  auto value_type = GetRedisDocValueType(
+      rocksdb, read_time, key_value_pb, redis_query_id, doc_write_batch, subkey_index);
+  RETURN_NOT_OK(value_type);
+  return ToRedisDataType(*value_type);
 }
 
 Result<RedisValue> GetRedisValue(
@@ -232,15 +304,279 @@ Result<RedisValue> GetRedisValue(
         return RedisValue{REDIS_TYPE_SORTEDSET};
       case ValueType::kRedisSet:
         return RedisValue{REDIS_TYPE_SET};
+      case ValueType::kRedisString: {
+        std::string value(RedisStringLength(doc), '\0');
+        CopyRedisStringChunks(doc, 0 /* begin */, &value);
+        return RedisValue{REDIS_TYPE_STRING, std::move(value), doc.GetTtl()};
+      }
       default:
         return STATUS_SUBSTITUTE(IllegalState, "Invalid value type: $0",
                                  static_cast<int>(doc.value_type()));
     }
   }
 
-  return RedisValue{REDIS_TYPE_STRING, doc.GetString()};
+  return RedisValue{REDIS_TYPE_STRING, doc.GetString(), doc.GetTtl()};
 }
 
+// Decodes a value written earlier in the same write batch, see DocWriteBatch::LookupPendingValue.
+Result<RedisValue> DecodePendingRedisValue(const std::string& encoded_value) {
+  Value value;
+  RETURN_NOT_OK(value.Decode(encoded_value));
+  switch (value.value_type()) {
+    case ValueType::kTombstone:
+      return RedisValue{REDIS_TYPE_NONE};
+    case ValueType::kString:
+      return RedisValue{REDIS_TYPE_STRING, value.primitive_value().GetString(),
+                        value.has_ttl() ? static_cast<int64_t>(value.ttl().ToSeconds()) : -1};
+    case ValueType::kObject:
+      return RedisValue{REDIS_TYPE_HASH};
+    case ValueType::kRedisTS:
+      return RedisValue{REDIS_TYPE_TIMESERIES};
+    case ValueType::kRedisSortedSet:
+      return RedisValue{REDIS_TYPE_SORTEDSET};
+    case ValueType::kRedisSet:
+      return RedisValue{REDIS_TYPE_SET};
+    default:
+      return STATUS_SUBSTITUTE(IllegalState, "Invalid value type: $0",
+                               static_cast<int>(value.value_type()));
+  }
+}
+
+// Writes a whole redis string value, in chunks if it is long enough.
+CHECKED_STATUS WriteRedisString(
+    const RedisKeyValuePB& kv, const std::string& value, rocksdb::QueryId redis_query_id,
+    DocWriteBatch* doc_write_batch) {
+  const DocPath doc_path = DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key());
+  const int64_t length = value.length();
+  if (FLAGS_redis_chunked_string_min_bytes <= 0 || length < FLAGS_redis_chunked_string_min_bytes) {
+    return doc_write_batch->SetPrimitive(doc_path, Value(PrimitiveValue(value)), redis_query_id);
+  }
+  SubDocument doc(ValueType::kRedisString);
+  doc.SetChildPrimitive(PrimitiveValue(ValueType::kCounter),
+                        PrimitiveValue(length));
+  for (int64_t index = 0; index * kRedisStringChunkSize < length; ++index) {
+    doc.SetChildPrimitive(
+        PrimitiveValue(index),
+        PrimitiveValue(value.substr(index * kRedisStringChunkSize, kRedisStringChunkSize)));
+  }
+  return doc_write_batch->InsertSubDocument(doc_path, doc, redis_query_id);
+}
+
+// A redis string key, whose value is read and written only in the parts that a command needs
+// when it is stored in chunks. Given a write batch, the reads see the earlier writes of the batch.
+class ChunkedRedisString {
+ public:
+  ChunkedRedisString(rocksdb::DB* rocksdb, const ReadHybridTime& read_time,
+                     const RedisKeyValuePB& kv, rocksdb::QueryId redis_query_id,
+                     DocWriteBatch* doc_write_batch = nullptr)
+      : rocksdb_(rocksdb), read_time_(read_time), kv_(kv), redis_query_id_(redis_query_id),
+        doc_write_batch_(doc_write_batch),
+        doc_key_(DocKey::FromRedisKey(kv.hash_code(), kv.key())) {
+  }
+
+  // Reads the whole value of a plain string, or just the length of a chunked one. Returns the type
+  // of the key, which is REDIS_TYPE_STRING for both.
+  Result<RedisDataType> ReadHead() {
+    if (doc_write_batch_) {
+      const auto* pending_value = doc_write_batch_->LookupPendingValue(doc_key_.Encode());
+      if (pending_value) {
+        Value value;
+        RETURN_NOT_OK(value.Decode(*pending_value));
+        if (value.value_type() != ValueType::kRedisString) {
+          auto redis_value = DecodePendingRedisValue(*pending_value);
+          RETURN_NOT_OK(redis_value);
+          value_ = std::move(*redis_value);
+          return value_.type;
+        }
+        // This batch wrote the string in chunks, over whatever RocksDB has.
+        chunked_ = true;
+        written_by_batch_ = true;
+        value_ = RedisValue{REDIS_TYPE_STRING};
+        RETURN_NOT_OK(ReadPendingLength());
+        return value_.type;
+      }
+    }
+
+    // Of a chunked string, read only the length.
+    const SubDocKeyBound high_subkey(
+        SubDocKey(doc_key_.doc_key(), PrimitiveValue(ValueType::kCounter)),
+        false /* is_exclusive */, false /* is_lower_bound */);
+    SubDocument doc;
+    bool doc_found = false;
+    GetSubDocumentData data = { &doc_key_, &doc, &doc_found };
+    data.high_subkey = &high_subkey;
+    RETURN_NOT_OK(GetSubDocument(
+        rocksdb_, data, redis_query_id_, boost::none /* txn_op_context */, read_time_));
+
+    if (!doc_found) {
+      // The bound leaves out all the subkeys of a collection, which is then not found, so check
+      // the type of the key. The type alone does not tell an expired string, which is not found
+      // either.
+      auto value_type = GetRedisDocValueType(rocksdb_, read_time_, kv_, redis_query_id_);
+      RETURN_NOT_OK(value_type);
+      auto type = ToRedisDataType(*value_type);
+      RETURN_NOT_OK(type);
+      value_ = RedisValue{*type == REDIS_TYPE_STRING ? REDIS_TYPE_NONE : *type};
+    } else if (doc.value_type() == ValueType::kRedisString) {
+      chunked_ = true;
+      value_ = RedisValue{REDIS_TYPE_STRING, std::string(), doc.GetTtl()};
+      length_ = RedisStringLength(doc);
+      RETURN_NOT_OK(ReadPendingLength());
+    } else if (!doc.IsPrimitive()) {
+      auto type = ToRedisDataType(doc.value_type());
+      RETURN_NOT_OK(type);
+      value_ = RedisValue{*type};
+    } else {
+      value_ = RedisValue{REDIS_TYPE_STRING, doc.GetString(), doc.GetTtl()};
+    }
+    return value_.type;
+  }
+
+  bool chunked() const { return chunked_; }
+
+  int64_t length() const { return chunked_ ? length_ : value_.value.length(); }
+
+  // Reads the bytes [begin, end) of the string.
+  Result<std::string> ReadRange(int64_t begin, int64_t end) {
+    if (!chunked_) {
+      return value_.value.substr(begin, end - begin);
+    }
+    std::string result(std::max<int64_t>(end - begin, 0), '\0');
+    if (result.empty()) {
+      return result;
+    }
+    const int64_t first_chunk = begin / kRedisStringChunkSize;
+    const int64_t last_chunk = (end - 1) / kRedisStringChunkSize;
+    if (!written_by_batch_) {
+      const SubDocKeyBound low_subkey(
+          SubDocKey(doc_key_.doc_key(), PrimitiveValue(first_chunk)),
+          false /* is_exclusive */, true /* is_lower_bound */);
+      const SubDocKeyBound high_subkey(
+          SubDocKey(doc_key_.doc_key(), PrimitiveValue(last_chunk)),
+          false /* is_exclusive */, false /* is_lower_bound */);
+      SubDocument doc;
+      bool doc_found = false;
+      GetSubDocumentData data = { &doc_key_, &doc, &doc_found };
+      data.low_subkey = &low_subkey;
+      data.high_subkey = &high_subkey;
+      RETURN_NOT_OK(GetSubDocument(
+          rocksdb_, data, redis_query_id_, boost::none /* txn_op_context */, read_time_));
+      if (doc_found && doc.value_type() == ValueType::kRedisString) {
+        CopyRedisStringChunks(doc, begin, &result);
+      }
+    }
+    if (doc_write_batch_) {
+      // The chunks written by this batch replace the ones in RocksDB as a whole.
+      SubDocument pending_chunks(ValueType::kRedisString);
+      for (int64_t index = first_chunk; index <= last_chunk; ++index) {
+        const auto* pending_value = doc_write_batch_->LookupPendingValue(
+            SubDocKey(doc_key_.doc_key(), PrimitiveValue(index)).Encode());
+        if (!pending_value) {
+          continue;
+        }
+        Value value;
+        RETURN_NOT_OK(value.Decode(*pending_value));
+        const int64_t from = std::max(begin, index * kRedisStringChunkSize);
+        const int64_t to = std::min(end, (index + 1) * kRedisStringChunkSize);
+        std::fill(result.begin() + (from - begin), result.begin() + (to - begin), '\0');
+        pending_chunks.SetChildPrimitive(PrimitiveValue(index), value.primitive_value());
+      }
+      CopyRedisStringChunks(pending_chunks, begin, &result);
+    }
+    return result;
+  }
+
+  // Reads the whole value.
+  Result<RedisValue> Read() {
+    if (chunked_) {
+      auto value = ReadRange(0, length_);
+      RETURN_NOT_OK(value);
+      value_.value = std::move(*value);
+      chunked_ = false;
+    }
+    return value_;
+  }
+
+  // Writes value at offset, like SETRANGE, and returns the new length of the string. Of a chunked
+  // string, rewrites only the chunks that the value overlaps.
+  Result<int64_t> Write(int64_t offset, const std::string& value) {
+    DCHECK_ONLY_NOTNULL(doc_write_batch_);
+    if (!chunked_) {
+      std::string& str = value_.value;
+      if (offset > static_cast<int64_t>(str.length())) {
+        str.resize(offset, 0);
+      }
+      str.replace(offset, value.length(), value);
+      value_.type = REDIS_TYPE_STRING;
+      RETURN_NOT_OK(WriteRedisString(kv_, str, redis_query_id_, doc_write_batch_));
+      return length();
+    }
+
+    const int64_t end = offset + value.length();
+    DocPath doc_path = DocPath::DocPathFromRedisKey(kv_.hash_code(), kv_.key());
+    for (int64_t index = offset / kRedisStringChunkSize;
+         index * kRedisStringChunkSize < end; ++index) {
+      const int64_t chunk_begin = index * kRedisStringChunkSize;
+      // The bytes [from, to) of the chunk are written, over the existing_size bytes it has.
+      const int64_t from = std::max(offset, chunk_begin) - chunk_begin;
+      const int64_t to = std::min(end, chunk_begin + kRedisStringChunkSize) - chunk_begin;
+      const int64_t existing_size = std::max<int64_t>(
+          std::min(length_, chunk_begin + kRedisStringChunkSize) - chunk_begin, 0);
+      std::string chunk;
+      if (existing_size > 0 && (from > 0 || to < existing_size)) {
+        auto existing = ReadRange(chunk_begin, chunk_begin + existing_size);
+        RETURN_NOT_OK(existing);
+        chunk = std::move(*existing);
+      }
+      chunk.resize(std::max<int64_t>(chunk.size(), to), '\0');
+      chunk.replace(from, to - from, value, chunk_begin + from - offset, to - from);
+      DocPath chunk_path = doc_path;
+      chunk_path.AddSubKey(PrimitiveValue(index));
+      RETURN_NOT_OK(doc_write_batch_->SetPrimitive(
+          chunk_path, Value(PrimitiveValue(chunk)), redis_query_id_));
+    }
+
+    if (end > length_) {
+      length_ = end;
+      doc_path.AddSubKey(PrimitiveValue(ValueType::kCounter));
+      RETURN_NOT_OK(doc_write_batch_->SetPrimitive(
+          doc_path, Value(PrimitiveValue(length_)), redis_query_id_));
+    }
+    return length_;
+  }
+
+ private:
+  CHECKED_STATUS ReadPendingLength() {
+    if (!doc_write_batch_) {
+      return Status::OK();
+    }
+    const auto* pending_value = doc_write_batch_->LookupPendingValue(
+        SubDocKey(doc_key_.doc_key(), PrimitiveValue(ValueType::kCounter)).Encode());
+    if (pending_value) {
+      Value value;
+      RETURN_NOT_OK(value.Decode(*pending_value));
+      if (value.value_type() != ValueType::kInt64) {
+        return STATUS_FORMAT(Corruption, "Invalid length of a chunked redis string: $0", value);
+      }
+      length_ = value.primitive_value().GetInt64();
+    }
+    return Status::OK();
+  }
+
+  rocksdb::DB* const rocksdb_;
+  const ReadHybridTime& read_time_;
+  const RedisKeyValuePB& kv_;
+  const rocksdb::QueryId redis_query_id_;
+  DocWriteBatch* const doc_write_batch_;
+  const SubDocKey doc_key_;
+
+  RedisValue value_{REDIS_TYPE_NONE};
+  bool chunked_ = false;
+  // Whether this batch wrote the chunked string, so that it is not read from RocksDB.
+  bool written_by_batch_ = false;
+  int64_t length_ = 0;
+};
+
 YB_STRONGLY_TYPED_BOOL(VerifySuccessIfMissing);
 
 // Set response based on the type match. Return whether the type matches what's expected.
@@ -424,6 +760,40 @@ CHECKED_STATUS GetCardinality(rocksdb::DB *rocksdb,
   return Status::OK();
 }
 
+struct SortedSetMemberLookup {
+  SubDocKey subdoc_key;
+  SubDocument score;
+  bool found = false;
+};
+
+// Looks up the scores of the given members of a sorted set in its reverse mapping, together with
+// the cardinality of the set, using a single iterator instead of one per member.
+CHECKED_STATUS GetSortedSetScoresAndCardinality(rocksdb::DB *rocksdb,
+                                                rocksdb::QueryId query_id,
+                                                ReadHybridTime hybrid_time,
+                                                const RedisKeyValuePB& kv,
+                                                const std::vector<PrimitiveValue>& members,
+                                                std::vector<SortedSetMemberLookup>* lookups,
+                                                int64_t* card) {
+  const DocKey doc_key = DocKey::FromRedisKey(kv.hash_code(), kv.key());
+  lookups->resize(members.size());
+  std::vector<GetSubDocumentData> data;
+  data.reserve(members.size() + 1);
+  for (size_t i = 0; i != members.size(); ++i) {
+    auto& lookup = (*lookups)[i];
+    lookup.subdoc_key = SubDocKey(doc_key, PrimitiveValue(ValueType::kSSReverse), members[i]);
+    data.emplace_back(&lookup.subdoc_key, &lookup.score, &lookup.found);
+  }
+  SubDocKey key_card(doc_key, PrimitiveValue(ValueType::kCounter));
+  SubDocument subdoc_card;
+  bool subdoc_card_found = false;
+  data.emplace_back(&key_card, &subdoc_card, &subdoc_card_found);
+  RETURN_NOT_OK(GetSubDocuments(
+      rocksdb, data, query_id, boost::none /* txn_op_context */, hybrid_time));
+  *card = subdoc_card_found ? subdoc_card.GetInt64() : 0;
+  return Status::OK();
+}
+
 template <typename AddResponseValues>
 CHECKED_STATUS GetAndPopulateResponseValues(
     rocksdb::DB* rocksdb,
@@ -454,6 +824,78 @@ CHECKED_STATUS GetAndPopulateResponseValues(
   return Status::OK();
 }
 
+// Aggregates the samples of a time series, which are ordered by descending timestamps, into
+// buckets. Adds the start and the aggregated value of each bucket to the response, in ascending
+// order of timestamps.
+CHECKED_STATUS PopulateAggregatedTimeSeries(const SubDocument::ObjectContainer& samples,
+                                            const RedisCollectionGetRangeRequestPB& request,
+                                            RedisResponsePB* response) {
+  const int64_t bucket_size = request.bucket_size();
+  const auto aggregation = request.aggregation();
+  auto* array = response->mutable_array_response();
+  bool has_bucket = false;
+  int64_t bucket_start = 0;
+  int64_t count = 0;
+  long double result = 0;
+  auto flush = [&]() {
+    if (!has_bucket) {
+      return;
+    }
+    array->add_elements(std::to_string(bucket_start));
+    switch (aggregation) {
+      case RedisCollectionGetRangeRequestPB_AggregationType_COUNT:
+        array->add_elements(std::to_string(count));
+        break;
+      case RedisCollectionGetRangeRequestPB_AggregationType_AVG:
+        array->add_elements(std::to_string(static_cast<double>(result / count)));
+        break;
+      default:
+        array->add_elements(std::to_string(static_cast<double>(result)));
+        break;
+    }
+  };
+  for (auto it = samples.rbegin(); it != samples.rend(); ++it) {
+    const int64_t timestamp = it->first.GetInt64();
+    // Buckets are aligned to multiples of their size, rounding negative timestamps down.
+    int64_t start = timestamp / bucket_size * bucket_size;
+    if (start > timestamp) {
+      start -= bucket_size;
+    }
+    if (!has_bucket || start != bucket_start) {
+      flush();
+      has_bucket = true;
+      bucket_start = start;
+      count = 0;
+      result = 0;
+    }
+    ++count;
+    if (aggregation == RedisCollectionGetRangeRequestPB_AggregationType_COUNT) {
+      continue;
+    }
+    auto value = util::CheckedStold(it->second.GetString());
+    if (!value.ok()) {
+      response->Clear();
+      response->set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
+      response->set_error_message("Time series value is not a number");
+      return Status::OK();
+    }
+    switch (aggregation) {
+      case RedisCollectionGetRangeRequestPB_AggregationType_MIN:
+        result = count == 1 ? *value : std::min(result, *value);
+        break;
+      case RedisCollectionGetRangeRequestPB_AggregationType_MAX:
+        result = count == 1 ? *value : std::max(result, *value);
+        break;
+      default:
+        result += *value;
+        break;
+    }
+  }
+  flush();
+  response->set_code(RedisResponsePB_RedisStatusCode_OK);
+  return Status::OK();
+}
+
 // Get normalized (with respect to card) upper and lower index bounds for reverse range scans.
 void GetNormalizedBounds(int64 low_idx, int64 high_idx, int64 card,
                          int64* low_idx_normalized, int64* high_idx_normalized) {
@@ -517,6 +959,15 @@ Result<RedisDataType> RedisWriteOperation::GetValueType(
 
 Result<RedisValue> RedisWriteOperation::GetValue(
     const DocOperationApplyData& data, int subkey_index) {
+  const RedisKeyValuePB& kv = request_.key_value();
+  if (kv.subkey_size() == 0) {
+    // Operations of one batch on the same key, e.g. pipelined increments of a counter, see the
+    // values written before them, without reading RocksDB again.
+    ChunkedRedisString value(data.doc_write_batch->rocksdb(), data.read_time, kv,
+                             redis_query_id(), data.doc_write_batch);
+    RETURN_NOT_OK(value.ReadHead());
+    return value.Read();
+  }
   return GetRedisValue(data.doc_write_batch->rocksdb(), data.read_time,
                        request_.key_value(), redis_query_id(), subkey_index);
 }
@@ -585,19 +1036,23 @@ Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
         // The top level mapping.
         SubDocument kv_entries;
 
+        // Check which of the values are already in the document, so that they could be deleted.
+        std::vector<PrimitiveValue> members;
+        members.reserve(kv.subkey_size());
+        for (int i = 0; i < kv.subkey_size(); i++) {
+          members.emplace_back(kv.value(i));
+        }
+        std::vector<SortedSetMemberLookup> lookups;
+        int64_t card;
+        RETURN_NOT_OK(GetSortedSetScoresAndCardinality(
+            data.doc_write_batch->rocksdb(), redis_query_id(), data.read_time, kv, members,
+            &lookups, &card));
+
         int new_elements_added = 0;
         int return_value = 0;
         for (int i = 0; i < kv.subkey_size(); i++) {
-          // Check whether the value is already in the document, if so delete it.
-          SubDocKey key_reverse = SubDocKey(DocKey::FromRedisKey(kv.hash_code(), kv.key()),
-                                            PrimitiveValue(ValueType::kSSReverse),
-                                            PrimitiveValue(kv.value(i)));
-          SubDocument subdoc_reverse;
-          bool subdoc_reverse_found = false;
-          GetSubDocumentData get_data = { &key_reverse, &subdoc_reverse, &subdoc_reverse_found };
-          RETURN_NOT_OK(GetSubDocument(
-              data.doc_write_batch->rocksdb(), get_data, redis_query_id(),
-              boost::none /* txn_op_context */, data.read_time));
+          const SubDocument& subdoc_reverse = lookups[i].score;
+          const bool subdoc_reverse_found = lookups[i].found;
 
           // Flag indicating whether we should add the given entry to the sorted set.
           bool should_add_entry = true;
@@ -677,9 +1132,6 @@ Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
         }
 
         if (new_elements_added > 0) {
-          int64_t card;
-          RETURN_NOT_OK(GetCardinality(data.doc_write_batch->rocksdb(), redis_query_id(),
-                                       data.read_time, kv, &card));
           // Insert card + new_elements_added back into the document for the updated card.
           kv_entries_card = SubDocument(PrimitiveValue(card + new_elements_added));
           kv_entries.SetChild(PrimitiveValue(ValueType::kCounter), SubDocument(kv_entries_card));
@@ -776,23 +1228,23 @@ Status RedisWriteOperation::ApplyAppend(const DocOperationApplyData& data) {
         "Append kv should have 1 value, found $0", kv.value_size());
   }
 
-  auto value = GetValue(data);
-  RETURN_NOT_OK(value);
+  ChunkedRedisString value(data.doc_write_batch->rocksdb(), data.read_time, kv,
+                           redis_query_id(), data.doc_write_batch);
+  auto type = value.ReadHead();
+  RETURN_NOT_OK(type);
 
-  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
+  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, *type, &response_,
                             VerifySuccessIfMissing::kTrue)) {
     // We've already set the error code in the response.
     return Status::OK();
   }
 
-  value->value += kv.value(0);
+  auto length = value.Write(value.length(), kv.value(0));
+  RETURN_NOT_OK(length);
 
   response_.set_code(RedisResponsePB_RedisStatusCode_OK);
-  response_.set_int_response(value->value.length());
-
-  return data.doc_write_batch->SetPrimitive(
-      DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key()), Value(PrimitiveValue(value->value)),
-      redis_query_id());
+  response_.set_int_response(*length);
+  return Status::OK();
 }
 
 // TODO (akashnil): Actually check if the value existed, return 0 if not. handle multidel in future.
@@ -833,20 +1285,23 @@ Status RedisWriteOperation::ApplyDel(const DocOperationApplyData& data) {
       SubDocument values_forward;
       SubDocument values_reverse;
       num_keys = kv.subkey_size();
+      // Check which of the values are already in the document.
+      // Todo(Rahul): Add values to the write batch cache and then do an additional check.
+      // As of now, we only check to see if a value is in rocksdb, and we should also check
+      // the write batch.
+      std::vector<PrimitiveValue> members;
+      members.reserve(kv.subkey_size());
       for (int i = 0; i < kv.subkey_size(); i++) {
-        // Check whether the value is already in the document.
-        SubDocument doc_reverse;
-        bool doc_reverse_found = false;
-        SubDocKey subdoc_key_reverse = SubDocKey(DocKey::FromRedisKey(kv.hash_code(), kv.key()),
-                                                 PrimitiveValue(ValueType::kSSReverse),
-                                                 PrimitiveValue(kv.subkey(i).string_subkey()));
-        // Todo(Rahul): Add values to the write batch cache and then do an additional check.
-        // As of now, we only check to see if a value is in rocksdb, and we should also check
-        // the write batch.
-        GetSubDocumentData get_data = { &subdoc_key_reverse, &doc_reverse, &doc_reverse_found };
-        RETURN_NOT_OK(GetSubDocument(
-        data.doc_write_batch->rocksdb(), get_data, redis_query_id(),
-        boost::none /* txn_op_context */, data.read_time));
+        members.emplace_back(kv.subkey(i).string_subkey());
+      }
+      std::vector<SortedSetMemberLookup> lookups;
+      int64_t card;
+      RETURN_NOT_OK(GetSortedSetScoresAndCardinality(
+          data.doc_write_batch->rocksdb(), redis_query_id(), data.read_time, kv, members,
+          &lookups, &card));
+      for (int i = 0; i < kv.subkey_size(); i++) {
+        const SubDocument& doc_reverse = lookups[i].score;
+        const bool doc_reverse_found = lookups[i].found;
         if (doc_reverse_found && doc_reverse.value_type() != ValueType::kTombstone) {
           // The value is already in the doc, needs to be removed.
           values_reverse.SetChild(PrimitiveValue(kv.subkey(i).string_subkey()),
@@ -862,9 +1317,6 @@ Status RedisWriteOperation::ApplyDel(const DocOperationApplyData& data) {
           num_keys--;
         }
       }
-      int64_t card;
-      RETURN_NOT_OK(GetCardinality(data.doc_write_batch->rocksdb(), redis_query_id(),
-                                   data.read_time, kv, &card));
       // The new cardinality is card - num_keys.
       values_card = SubDocument(PrimitiveValue(card - num_keys));
 
@@ -915,29 +1367,28 @@ Status RedisWriteOperation::ApplySetRange(const DocOperationApplyData& data) {
         "SetRange kv should have 1 value, found $0", kv.value_size());
   }
 
-  auto value = GetValue(data);
-  RETURN_NOT_OK(value);
+  ChunkedRedisString value(data.doc_write_batch->rocksdb(), data.read_time, kv,
+                           redis_query_id(), data.doc_write_batch);
+  auto type = value.ReadHead();
+  RETURN_NOT_OK(type);
 
-  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
+  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, *type, &response_,
                             VerifySuccessIfMissing::kTrue)) {
     // We've already set the error code in the response.
     return Status::OK();
   }
 
-  if (request_.set_range_request().offset() > value->value.length()) {
-    value->value.resize(request_.set_range_request().offset(), 0);
-  }
-  value->value.replace(request_.set_range_request().offset(), kv.value(0).length(), kv.value(0));
-  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
-  response_.set_int_response(value->value.length());
+  auto length = value.Write(request_.set_range_request().offset(), kv.value(0));
+  RETURN_NOT_OK(length);
 
-  return data.doc_write_batch->SetPrimitive(
-      DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key()),
-      Value(PrimitiveValue(value->value)), redis_query_id());
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  response_.set_int_response(*length);
+  return Status::OK();
 }
 
-Status RedisWriteOperation::ApplyIncr(const DocOperationApplyData& data, int64_t incr) {
+Status RedisWriteOperation::ApplyIncr(const DocOperationApplyData& data) {
   const RedisKeyValuePB& kv = request_.key_value();
+  const int64_t incr = request_.incr_request().increment_int();
 
   auto value = GetValue(data);
   RETURN_NOT_OK(value);
@@ -1073,6 +1524,8 @@ Status RedisReadOperation::Execute() {
       return ExecuteGetRange();
     case RedisReadRequestPB::RequestCase::kGetCollectionRangeRequest:
       return ExecuteCollectionGetRange();
+    case RedisReadRequestPB::RequestCase::kScanRequest:
+      return ExecuteScan();
     default:
       return STATUS(Corruption,
           Substitute("Unsupported redis write operation: $0", request_.request_case()));
@@ -1238,6 +1691,22 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
         GetSubDocumentData data = { &doc_key, &doc, &doc_found };
         data.low_subkey = &low_subkey;
         data.high_subkey = &high_subkey;
+        const auto& range_request = request_.get_collection_range_request();
+        if (range_request.has_aggregation()) {
+          if (range_request.bucket_size() <= 0) {
+            return STATUS(InvalidArgument, "Aggregation bucket size must be positive");
+          }
+          RETURN_NOT_OK(GetSubDocument(
+              db_, data, redis_query_id(), boost::none /* txn_op_context */, read_time_));
+          response_.set_allocated_array_response(new RedisArrayPB());
+          if (!doc_found) {
+            response_.set_code(RedisResponsePB_RedisStatusCode_NIL);
+          } else if (VerifyTypeAndSetCode(ValueType::kRedisTS, doc.value_type(), &response_)) {
+            RETURN_NOT_OK(PopulateAggregatedTimeSeries(
+                doc.object_container(), range_request, &response_));
+          }
+          return Status::OK();
+        }
         RETURN_NOT_OK(GetAndPopulateResponseValues(
             db_, redis_query_id(), read_time_, AddResponseValuesGeneric, data,
             ValueType::kRedisTS, request_, &response_,
@@ -1314,6 +1783,59 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
   return Status::OK();
 }
 
+Status RedisReadOperation::ExecuteScan() {
+  if (partition_ == nullptr) {
+    return STATUS(InvalidArgument, "SCAN requires the partition of the tablet");
+  }
+  const auto& scan_request = request_.scan_request();
+  const int64_t count = std::max(scan_request.count(), 1);
+  // When this tablet is scanned to its end, the scan continues from the next tablet.
+  const auto& partition_key_end = partition_->partition_key_end();
+  uint32_t next_cursor = partition_key_end.empty()
+      ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partition_key_end);
+
+  auto iter = CreateIntentAwareIterator(
+      db_, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
+      redis_query_id(), boost::none /* txn_op_context */, read_time_);
+  iter->Seek(DocKey::FromRedisKey(request_.key_value().hash_code(), ""));
+
+  response_.set_allocated_array_response(new RedisArrayPB());
+  int64_t keys_seen = 0;
+  DocKey doc_key;
+  while (iter->valid()) {
+    auto fetched_key = iter->FetchKey();
+    RETURN_NOT_OK(fetched_key);
+    Slice key_slice = *fetched_key;
+    const auto previous_hash = doc_key.hash();
+    RETURN_NOT_OK(doc_key.DecodeFrom(&key_slice));
+    // Stop only at a hash code boundary, so that the next scan could start from a hash code.
+    if (keys_seen >= count && doc_key.hash() != previous_hash) {
+      next_cursor = doc_key.hash();
+      break;
+    }
+    ++keys_seen;
+
+    SubDocKey subdoc_key(doc_key);
+    SubDocument doc;
+    bool doc_found = false;
+    GetSubDocumentData data = { &subdoc_key, &doc, &doc_found };
+    data.return_type_only = true;
+    RETURN_NOT_OK(GetSubDocument(
+        iter.get(), data, nullptr /* projection */, false /* is_iter_valid */));
+    if (doc_found && doc_key.hashed_group().size() == 1) {
+      const auto& key = doc_key.hashed_group()[0].GetString();
+      if (!scan_request.has_pattern() || MatchPattern(key, scan_request.pattern())) {
+        response_.mutable_array_response()->add_elements(key);
+      }
+    }
+    iter->SeekOutOfSubDoc(subdoc_key);
+  }
+
+  response_.set_next_cursor(next_cursor);
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  return Status::OK();
+}
+
 Result<RedisDataType> RedisReadOperation::GetValueType(int subkey_index) {
   return GetRedisValueType(db_, read_time_, request_.key_value(), redis_query_id(),
                            nullptr /* doc_write_batch */, subkey_index);
@@ -1381,6 +1903,24 @@ Status RedisReadOperation::ExecuteGet() {
       }
       return Status::OK();
     }
+    case RedisGetRequestPB_GetRequestType_TTL: {
+      // DocDB filters out expired values on read, so a missing key could also be an expired one.
+      // Collections have no TTL of their own, only their members do.
+      // Only the type is read first, to avoid reading whole collections.
+      auto type = GetValueType();
+      RETURN_NOT_OK(type);
+      response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+      if (*type == REDIS_TYPE_NONE) {
+        response_.set_int_response(-2);
+      } else if (*type != REDIS_TYPE_STRING) {
+        response_.set_int_response(-1);
+      } else {
+        auto value = GetValue();
+        RETURN_NOT_OK(value);
+        response_.set_int_response(value->type == REDIS_TYPE_NONE ? -2 : value->ttl_seconds);
+      }
+      return Status::OK();
+    }
     case RedisGetRequestPB_GetRequestType_MGET: {
       return STATUS(NotSupported, "MGET not yet supported");
     }
@@ -1392,14 +1932,32 @@ Status RedisReadOperation::ExecuteGet() {
         return Status::OK();
       }
 
+      // Look up all the fields with a single iterator, instead of creating one per field.
+      const auto& key_value = request_.key_value();
+      const DocKey doc_key = DocKey::FromRedisKey(key_value.hash_code(), key_value.key());
+      struct FieldLookup {
+        SubDocKey subdoc_key;
+        SubDocument doc;
+        bool doc_found = false;
+      };
+      std::vector<FieldLookup> lookups(key_value.subkey_size());
+      std::vector<GetSubDocumentData> data;
+      data.reserve(lookups.size());
+      for (int i = 0; i < key_value.subkey_size(); i++) {
+        PrimitiveValue subkey_primitive;
+        RETURN_NOT_OK(PrimitiveValueFromSubKey(key_value.subkey(i), &subkey_primitive));
+        lookups[i].subdoc_key = SubDocKey(doc_key, subkey_primitive);
+        data.emplace_back(&lookups[i].subdoc_key, &lookups[i].doc, &lookups[i].doc_found);
+      }
+      // TODO(dtxn) - pass correct transaction context when we implement cross-shard transactions
+      // support for Redis.
+      RETURN_NOT_OK(GetSubDocuments(
+          db_, data, redis_query_id(), boost::none /* txn_op_context */, read_time_));
+
       response_.set_allocated_array_response(new RedisArrayPB());
-      for (int i = 0; i < request_.key_value().subkey_size(); i++) {
-        // TODO: ENG-1803: It is inefficient to create a new iterator for each subkey causing a
-        // new seek. Consider reusing the same iterator.
-        auto value = GetValue(i);
-        RETURN_NOT_OK(value);
-        if (value->type == REDIS_TYPE_STRING) {
-          response_.mutable_array_response()->add_elements(value->value);
+      for (const auto& lookup : lookups) {
+        if (lookup.doc_found && lookup.doc.IsPrimitive()) {
+          response_.mutable_array_response()->add_elements(lookup.doc.GetString());
         } else {
           response_.mutable_array_response()->add_elements(""); // Empty is nil response.
         }
@@ -1429,13 +1987,14 @@ Status RedisReadOperation::ExecuteGet() {
 }
 
 Status RedisReadOperation::ExecuteStrLen() {
-  auto value = GetValue();
+  ChunkedRedisString value(db_, read_time_, request_.key_value(), redis_query_id());
+  auto type = value.ReadHead();
   response_.set_code(RedisResponsePB_RedisStatusCode_OK);
-  RETURN_NOT_OK(value);
+  RETURN_NOT_OK(type);
 
-  if (VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
+  if (VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, *type, &response_,
                            VerifySuccessIfMissing::kTrue)) {
-    SetOptionalInt(value->type, value->value.length(), &response_);
+    SetOptionalInt(*type, value.length(), &response_);
   }
   response_.set_code(RedisResponsePB_RedisStatusCode_OK);
 
@@ -1455,16 +2014,17 @@ Status RedisReadOperation::ExecuteExists() {
 }
 
 Status RedisReadOperation::ExecuteGetRange() {
-  auto value = GetValue();
-  RETURN_NOT_OK(value);
+  ChunkedRedisString value(db_, read_time_, request_.key_value(), redis_query_id());
+  auto type = value.ReadHead();
+  RETURN_NOT_OK(type);
 
-  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
+  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, *type, &response_,
       VerifySuccessIfMissing::kTrue)) {
     // We've already set the error code in the response.
     return Status::OK();
   }
 
-  const int32_t len = value->value.length();
+  const int32_t len = value.length();
   int32_t exclusive_end = request_.get_range_request().end() + 1;
   if (exclusive_end == 0) {
     exclusive_end = len;
@@ -1477,8 +2037,11 @@ Status RedisReadOperation::ExecuteGetRange() {
     end = start;
   }
 
+  // Of a chunked string, only the chunks in the range are read.
+  auto range = value.ReadRange(start, end);
+  RETURN_NOT_OK(range);
   response_.set_code(RedisResponsePB_RedisStatusCode_OK);
-  response_.set_string_response(value->value.c_str() + start, end - start);
+  response_.set_string_response(std::move(*range));
   return Status::OK();
 }
 
@@ -1499,6 +2062,41 @@ bool RequireReadForExpressions(const QLWriteRequestPB& request) {
           !request.column_refs().static_ids().empty());
 }
 
+// Returns true if the values of the columns referenced by the request are needed to evaluate it.
+// "UPDATE ... SET list[index] = ..." references the list only so that the write is done under a
+// read snapshot: ReplaceInList() reads the list elements it replaces itself, so the row does not
+// have to be read beforehand when nothing else refers to the list.
+bool RequireReadForEvaluation(const QLWriteRequestPB& request, const Schema& schema) {
+  if (request.has_if_expr()) {
+    return true;
+  }
+  if (!RequireReadForExpressions(request)) {
+    return false;
+  }
+  std::unordered_set<int32_t> subscripted_lists;
+  std::unordered_set<int32_t> other_columns;
+  for (const auto& column_value : request.column_values()) {
+    const auto column = schema.column_by_id(ColumnId(column_value.column_id()));
+    if (column.ok() && column->type()->main() == LIST && !column_value.subscript_args().empty()) {
+      subscripted_lists.insert(column_value.column_id());
+    } else {
+      other_columns.insert(column_value.column_id());
+    }
+  }
+  for (const auto column_id : other_columns) {
+    subscripted_lists.erase(column_id);
+  }
+  const auto& column_refs = request.column_refs();
+  for (const auto* ids : {&column_refs.ids(), &column_refs.static_ids()}) {
+    for (const auto column_id : *ids) {
+      if (subscripted_lists.count(column_id) == 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 // If range key portion is missing and there are no targeted columns this is a range operation
 // (e.g. range delete) -- it affects all rows within a hash key that match the where clause.
 // Note: If target columns are given this could just be e.g. a delete targeting a static column
@@ -1509,6 +2107,105 @@ bool IsRangeOperation(const QLWriteRequestPB& request, const Schema& schema) {
          request.column_values().empty();
 }
 
+// Returns true if the request sets every non-key, non-static column of the schema to a scalar
+// value, so that the values of all of them could be written as a single packed row.
+bool SetsAllColumnsToScalars(const QLWriteRequestPB& request, const Schema& schema) {
+  std::vector<bool> is_set(schema.num_columns(), false);
+  for (const auto& column_value : request.column_values()) {
+    if (!column_value.has_column_id()) {
+      return false;
+    }
+    const int idx = schema.find_column_by_id(ColumnId(column_value.column_id()));
+    if (idx == Schema::kColumnNotFound || idx < static_cast<int>(schema.num_key_columns())) {
+      return false;
+    }
+    const ColumnSchema& column = schema.column(idx);
+    if (column.is_static()) {
+      continue;
+    }
+    if (!column.type()->IsElementary() || !column_value.subscript_args().empty() ||
+        column_value.expr().has_tscall()) {
+      return false;
+    }
+    is_set[idx] = true;
+  }
+  for (size_t idx = schema.num_key_columns(); idx < schema.num_columns(); idx++) {
+    if (!schema.column(idx).is_static() && !is_set[idx]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Narrows [start, end) to the rows of a hash partition, whose DocKeys start with the given
+// prefix, that satisfy the given condition. Returns false unless the condition is a conjunction of
+// comparisons of the first range column with constants.
+bool NarrowRangeDeleteBounds(const QLConditionPB& condition, const Schema& schema,
+                             const KeyBytes& rows_prefix, std::string* start, std::string* end) {
+  const auto& operands = condition.operands();
+  if (condition.op() == QL_OP_AND) {
+    for (const auto& operand : operands) {
+      if (operand.expr_case() != QLExpressionPB::ExprCase::kCondition ||
+          !NarrowRangeDeleteBounds(operand.condition(), schema, rows_prefix, start, end)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (operands.size() != 2 ||
+      operands.Get(0).expr_case() != QLExpressionPB::ExprCase::kColumnId ||
+      operands.Get(1).expr_case() != QLExpressionPB::ExprCase::kValue ||
+      IsNull(operands.Get(1).value())) {
+    return false;
+  }
+  const size_t column_idx = schema.num_hash_key_columns();
+  if (ColumnId(operands.Get(0).column_id()) != schema.column_id(column_idx)) {
+    return false;
+  }
+  const auto sorting_type = schema.column(column_idx).sorting_type();
+  const bool descending = sorting_type == ColumnSchema::SortingType::kDescending;
+
+  // The rows with the given value of the first range column are those with DocKeys in
+  // [value_prefix, value_prefix + kMaxByte).
+  KeyBytes value_prefix = rows_prefix;
+  PrimitiveValue::FromQLValuePB(operands.Get(1).value(), sorting_type).AppendToKey(&value_prefix);
+  KeyBytes value_end = value_prefix;
+  value_end.AppendValueType(ValueType::kMaxByte);
+
+  bool narrow_start = false;
+  bool narrow_end = false;
+  bool inclusive = false;
+  switch (condition.op()) {
+    case QL_OP_EQUAL:
+      narrow_start = narrow_end = inclusive = true;
+      break;
+    case QL_OP_GREATER_THAN_EQUAL:
+      inclusive = true;
+      FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN:
+      // Key order is reversed for descending columns.
+      narrow_start = !descending;
+      narrow_end = descending;
+      break;
+    case QL_OP_LESS_THAN_EQUAL:
+      inclusive = true;
+      FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN:
+      narrow_start = descending;
+      narrow_end = !descending;
+      break;
+    default:
+      return false;
+  }
+  if (narrow_start) {
+    *start = std::max(*start, (inclusive ? value_prefix : value_end).data());
+  }
+  if (narrow_end) {
+    *end = std::min(*end, (inclusive ? value_end : value_prefix).data());
+  }
+  return true;
+}
+
 bool RequireRead(const QLWriteRequestPB& request, const Schema& schema) {
   // In case of a user supplied timestamp, we need a read (and hence appropriate locks for read
   // modify write) but it is at the docdb level on a per key basis instead of a QL read of the
@@ -1530,42 +2227,6 @@ void AddProjection(const Schema& schema, QLTableRow* table_row) {
   }
 }
 
-// Create projection schemas of static and non-static columns from a rowblock projection schema
-// (for read) and a WHERE / IF condition (for read / write). "schema" is the full table schema
-// and "rowblock_schema" is the selected columns from which we are splitting into static and
-// non-static column portions.
-CHECKED_STATUS CreateProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
-                                 Schema* static_projection, Schema* non_static_projection) {
-  // The projection schemas are used to scan docdb. Keep the columns to fetch in sorted order for
-  // more efficient scan in the iterator.
-  set<ColumnId> static_columns, non_static_columns;
-
-  // Add regular columns.
-  for (int32_t id : column_refs.ids()) {
-    const ColumnId column_id(id);
-    if (!schema.is_key_column(column_id)) {
-      non_static_columns.insert(column_id);
-    }
-  }
-
-  // Add static columns.
-  for (int32_t id : column_refs.static_ids()) {
-    const ColumnId column_id(id);
-    static_columns.insert(column_id);
-  }
-
-  RETURN_NOT_OK(
-      schema.CreateProjectionByIdsIgnoreMissing(
-          vector<ColumnId>(static_columns.begin(), static_columns.end()),
-          static_projection));
-  RETURN_NOT_OK(
-      schema.CreateProjectionByIdsIgnoreMissing(
-          vector<ColumnId>(non_static_columns.begin(), non_static_columns.end()),
-          non_static_projection));
-
-  return Status::OK();
-}
-
 CHECKED_STATUS PopulateRow(const QLTableRow& table_row,
                            const Schema& projection, size_t col_idx, QLRow* row) {
   for (size_t i = 0; i < projection.num_columns(); i++, col_idx++) {
@@ -1645,6 +2306,18 @@ Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response)
   require_read_ = RequireRead(*request, schema_);
 
   request_.Swap(request);
+  read_for_evaluation_ = RequireReadForEvaluation(request_, schema_);
+
+  // Indexes need the values of the indexed columns before the write to find the index entries to
+  // replace. Range operations do not update the indexes yet.
+  update_indexes_ = index_map_ != nullptr && !index_map_->empty() &&
+                    !IsRangeOperation(request_, schema_);
+  if (update_indexes_) {
+    AddIndexedColumnRefs();
+    require_read_ = require_read_ || !read_column_refs_.ids().empty() ||
+                    !read_column_refs_.static_ids().empty();
+  }
+
   // Determine if static / non-static columns are being written.
   bool write_static_columns = false;
   bool write_non_static_columns = false;
@@ -1705,6 +2378,28 @@ Status QLWriteOperation::InitializeKeys(const bool hashed_key, const bool primar
   return Status::OK();
 }
 
+void QLWriteOperation::AddIndexedColumnRefs() {
+  read_column_refs_ = request_.column_refs();
+  std::unordered_set<int32_t> column_ids(read_column_refs_.ids().begin(),
+                                         read_column_refs_.ids().end());
+  column_ids.insert(read_column_refs_.static_ids().begin(), read_column_refs_.static_ids().end());
+  for (const auto& index : *index_map_) {
+    for (const auto& index_column : index.second.columns()) {
+      const ColumnId column_id = index_column.indexed_column_id;
+      const int column_idx = schema_.find_column_by_id(column_id);
+      if (column_idx == Schema::kColumnNotFound || schema_.is_key_column(column_idx) ||
+          !column_ids.insert(column_id.rep()).second) {
+        continue;
+      }
+      if (schema_.column(column_idx).is_static()) {
+        read_column_refs_.add_static_ids(column_id.rep());
+      } else {
+        read_column_refs_.add_ids(column_id.rep());
+      }
+    }
+  }
+}
+
 void QLWriteOperation::GetDocPathsToLock(list<DocPath> *paths, IsolationLevel *level) const {
   if (hashed_doc_path_ != nullptr)
     paths->push_back(*hashed_doc_path_);
@@ -1737,7 +2432,7 @@ Status QLWriteOperation::ReadColumns(const DocOperationApplyData& data,
   }
 
   // Create projections to scan docdb.
-  RETURN_NOT_OK(CreateProjections(schema_, request_.column_refs(),
+  RETURN_NOT_OK(CreateProjections(schema_, read_column_refs(),
                                   static_projection, non_static_projection));
 
   // Generate hashed / primary key depending on if static / non-static columns are referenced in
@@ -1786,6 +2481,14 @@ Status QLWriteOperation::IsConditionSatisfied(const QLConditionPB& condition,
   // See if the if-condition is satisfied.
   RETURN_NOT_OK(EvalCondition(condition, *table_row, should_apply));
 
+  // Return only the columns referenced by the request, not the ones read for the indexes.
+  if (update_indexes_) {
+    static_projection = Schema();
+    non_static_projection = Schema();
+    RETURN_NOT_OK(CreateProjections(schema_, request_.column_refs(),
+                                    &static_projection, &non_static_projection));
+  }
+
   // Populate the result set to return the "applied" status, and optionally the present column
   // values if the condition is not satisfied and the row does exist (value_map is not empty).
   std::vector<ColumnSchema> columns;
@@ -1811,14 +2514,26 @@ Status QLWriteOperation::IsConditionSatisfied(const QLConditionPB& condition,
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   bool should_apply = true;
   QLTableRow table_row;
+  bool table_row_read = true;
   if (request_.has_if_expr()) {
     RETURN_NOT_OK(IsConditionSatisfied(request_.if_expr().condition(),
                                        data,
                                        &should_apply,
                                        &rowblock_,
                                        &table_row));
-  } else if (RequireReadForExpressions(request_)) {
+  } else if (read_for_evaluation_ ||
+             (update_indexes_ && (!read_column_refs_.ids().empty() ||
+                                  !read_column_refs_.static_ids().empty()))) {
     RETURN_NOT_OK(ReadColumns(data, nullptr, nullptr, &table_row));
+  } else {
+    table_row_read = false;
+  }
+
+  // The row as it will be after the write, for the index updates.
+  QLTableRow new_row;
+  bool row_deleted = false;
+  if (update_indexes_) {
+    new_row = table_row;
   }
 
   if (should_apply) {
@@ -1837,7 +2552,14 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         // Add the appropriate liveness column only for inserts.
         // We never use init markers for QL to ensure we perform writes without any reads to
         // ensure our write path is fast while complicating the read path a bit.
-        if (request_.type() == QLWriteRequestPB::QL_STMT_INSERT && pk_doc_path_ != nullptr) {
+        // A packed row written instead of the regular columns also serves as the liveness column.
+        const bool is_row_insert =
+            request_.type() == QLWriteRequestPB::QL_STMT_INSERT && pk_doc_path_ != nullptr;
+        const bool pack_columns = is_row_insert && FLAGS_ql_pack_inserted_columns &&
+                                  user_timestamp == Value::kInvalidUserTimestamp &&
+                                  SetsAllColumnsToScalars(request_, schema_);
+        PackedRowEncoder packed_row;
+        if (is_row_insert && !pack_columns) {
           const DocPath sub_path(pk_doc_path_->encoded_doc_key(),
                                  PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
           const auto value = Value(PrimitiveValue(), ttl, user_timestamp);
@@ -1845,10 +2567,6 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
               sub_path, value, request_.query_id()));
         }
 
-        if (request_.column_values_size() <= 0) {
-          break;
-        }
-
         for (const auto& column_value : request_.column_values()) {
           if (!column_value.has_column_id()) {
             return STATUS_FORMAT(InvalidArgument, "column id missing: $0",
@@ -1869,6 +2587,16 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
           const SubDocument& sub_doc =
               SubDocument::FromQLValuePB(expr_result.value(), column.sorting_type(), write_instr);
 
+          if (update_indexes_ && column_value.subscript_args().empty() &&
+              write_instr == TSOpcode::kScalarInsert) {
+            new_row.AllocColumn(column_id, expr_result);
+          }
+
+          if (pack_columns && !column.is_static()) {
+            packed_row.AddColumn(column_id, sub_doc);
+            continue;
+          }
+
           // Typical case, setting a columns value
           if (column_value.subscript_args().empty()) {
             switch (write_instr) {
@@ -1955,6 +2683,15 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
             }
           }
         }
+
+        if (pack_columns) {
+          const DocPath sub_path(
+              pk_doc_path_->encoded_doc_key(),
+              PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRowColumn));
+          const auto value = Value(PrimitiveValue::PackedRow(packed_row.Finish()), ttl);
+          RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+              sub_path, value, request_.query_id()));
+        }
         break;
       }
       case QLWriteRequestPB::QL_STMT_DELETE: {
@@ -1978,10 +2715,23 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
                 PrimitiveValue(column_id));
             RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(sub_path,
                                                              request_.query_id(), user_timestamp));
+            if (update_indexes_) {
+              new_row.AllocColumn(column_id, QLValue());
+            }
           }
         } else if (IsRangeOperation(request_, schema_)) {
-          // If the range columns are not specified, we read everything and delete all rows for
-          // which the where condition matches.
+          // When the matching rows form a key range, they are deleted by a single range tombstone
+          // without reading them.
+          std::string start, end;
+          if (GetRangeDeleteBounds(&start, &end)) {
+            if (start < end) {
+              data.doc_write_batch->DeleteRange(start, end);
+            }
+            break;
+          }
+
+          // Otherwise, if the range columns are not specified, we read everything and delete all
+          // rows for which the where condition matches.
 
           // Create the schema projection -- range deletes cannot reference non-primary key columns,
           // so the non-static projection is all we need, it should contain all referenced columns.
@@ -2026,10 +2776,15 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         } else {
           // Otherwise, delete the referenced row (all columns).
           RETURN_NOT_OK(DeleteRow(data.doc_write_batch, *pk_doc_path_));
+          row_deleted = true;
         }
         break;
       }
     }
+
+    if (update_indexes_) {
+      RETURN_NOT_OK(UpdateIndexes(table_row, table_row_read, new_row, row_deleted));
+    }
   }
 
   response_->set_status(QLResponsePB::YQL_STATUS_OK);
@@ -2037,6 +2792,153 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   return Status::OK();
 }
 
+namespace {
+
+// Sets the type and the index columns of a write to the index table, from the values of the first
+// num_columns index columns.
+void FillIndexWriteRequest(const IndexInfo& index,
+                           const QLWriteRequestPB::QLStmtType type,
+                           const std::vector<QLValuePB>& values,
+                           const size_t num_columns,
+                           QLWriteRequestPB* index_request) {
+  index_request->set_type(type);
+  index_request->set_schema_version(index.schema_version());
+  for (size_t i = 0; i < num_columns; i++) {
+    QLExpressionPB* expr;
+    if (i < index.hash_column_count()) {
+      expr = index_request->add_hashed_column_values();
+    } else if (i < index.key_column_count()) {
+      expr = index_request->add_range_column_values();
+    } else {
+      QLColumnValuePB* const column_value = index_request->add_column_values();
+      column_value->set_column_id(index.column(i).column_id.rep());
+      expr = column_value->mutable_expr();
+    }
+    *expr->mutable_value() = values[i];
+  }
+}
+
+} // namespace
+
+bool IndexInsertRequestForRow(const IndexInfo& index, const QLTableRow& row,
+                              QLWriteRequestPB* index_request) {
+  std::vector<QLValuePB> values;
+  values.reserve(index.columns().size());
+  for (const auto& index_column : index.columns()) {
+    QLValue value;
+    // ReadColumn() sets null for the columns not in the row.
+    CHECK_OK(row.ReadColumn(index_column.indexed_column_id.rep(), &value));
+    if (values.size() < index.key_column_count() && value.IsNull()) {
+      return false;
+    }
+    values.push_back(value.value());
+  }
+  FillIndexWriteRequest(index, QLWriteRequestPB::QL_STMT_INSERT, values, values.size(),
+                        index_request);
+  return true;
+}
+
+QLValuePB QLWriteOperation::IndexedColumnValue(const QLTableRow& row,
+                                              const ColumnId column_id) const {
+  const int column_idx = schema_.find_column_by_id(column_id);
+  if (column_idx != Schema::kColumnNotFound && schema_.is_key_column(column_idx)) {
+    const int num_hash_key_columns = schema_.num_hash_key_columns();
+    const auto& key_values = column_idx < num_hash_key_columns ? request_.hashed_column_values()
+                                                                : request_.range_column_values();
+    const int key_idx =
+        column_idx < num_hash_key_columns ? column_idx : column_idx - num_hash_key_columns;
+    if (key_idx < key_values.size()) {
+      return key_values.Get(key_idx).value();
+    }
+    return QLValuePB();
+  }
+  QLValue value;
+  // ReadColumn() sets null for the columns not in the row.
+  CHECK_OK(row.ReadColumn(column_id.rep(), &value));
+  return value.value();
+}
+
+Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row,
+                                       const bool existing_row_read,
+                                       const QLTableRow& new_row,
+                                       const bool row_deleted) {
+  // If nothing was read, the indexes cover key columns only and so the index keys do not change,
+  // but whether the row existed is not known.
+  const bool existing_row_exists = !existing_row_read || !existing_row.IsEmpty();
+
+  for (const auto& index_entry : *index_map_) {
+    const IndexInfo& index = index_entry.second;
+    const size_t key_column_count = index.key_column_count();
+    std::vector<QLValuePB> existing_values, new_values;
+    existing_values.reserve(index.columns().size());
+    new_values.reserve(index.columns().size());
+    for (const auto& index_column : index.columns()) {
+      existing_values.push_back(IndexedColumnValue(existing_row, index_column.indexed_column_id));
+      new_values.push_back(IndexedColumnValue(new_row, index_column.indexed_column_id));
+    }
+
+    // An existing row that is updated without changing the indexed columns needs no index write.
+    if (existing_row_read && existing_row_exists && !row_deleted &&
+        existing_values == new_values) {
+      continue;
+    }
+
+    // Rows with a null in the index key have no index entry.
+    const auto has_null_key = [key_column_count](const std::vector<QLValuePB>& values) {
+      return std::any_of(values.begin(), values.begin() + key_column_count,
+                         [](const QLValuePB& value) { return IsNull(value); });
+    };
+    const auto add_index_request = [this, &index](QLWriteRequestPB::QLStmtType type,
+                                                  const std::vector<QLValuePB>& values,
+                                                  const size_t num_columns) {
+      index_requests_.emplace_back(index.table_id(), QLWriteRequestPB());
+      QLWriteRequestPB* const index_request = &index_requests_.back().second;
+      index_request->set_client(request_.client());
+      index_request->set_request_id(request_.request_id());
+      if (request_.has_ttl() && type != QLWriteRequestPB::QL_STMT_DELETE) {
+        index_request->set_ttl(request_.ttl());
+      }
+      if (request_.has_user_timestamp_usec()) {
+        index_request->set_user_timestamp_usec(request_.user_timestamp_usec());
+      }
+      FillIndexWriteRequest(index, type, values, num_columns, index_request);
+    };
+
+    const bool key_changed =
+        !std::equal(existing_values.begin(), existing_values.begin() + key_column_count,
+                    new_values.begin());
+    if (existing_row_exists && (row_deleted || key_changed) && !has_null_key(existing_values)) {
+      add_index_request(QLWriteRequestPB::QL_STMT_DELETE, existing_values, key_column_count);
+    }
+    if (!row_deleted && !has_null_key(new_values)) {
+      add_index_request(QLWriteRequestPB::QL_STMT_INSERT, new_values, new_values.size());
+    }
+  }
+  return Status::OK();
+}
+
+bool QLWriteOperation::GetRangeDeleteBounds(std::string* start, std::string* end) const {
+  // Range tombstones cannot be written as intents, nor carry a user timestamp.
+  if (txn_op_context_ || request_.has_user_timestamp_usec() ||
+      schema_.num_hash_key_columns() == 0) {
+    return false;
+  }
+  // The hashed DocKey ends with the empty range group, the rows of the partition continue it with
+  // their range components instead. Its static columns sort before them.
+  const KeyBytes& hashed_doc_key = hashed_doc_path_->encoded_doc_key();
+  DCHECK_EQ(ValueType::kGroupEnd, static_cast<ValueType>(hashed_doc_key.data().back()));
+  KeyBytes rows_prefix(Slice(hashed_doc_key.data().data(), hashed_doc_key.size() - 1));
+  *start = rows_prefix.data();
+  start->push_back(static_cast<char>(ValueType::kGroupEnd) + 1);
+  // The hashed group also ends with kGroupEnd, so the partition ends before the key with the next
+  // byte in its place.
+  *end = rows_prefix.data();
+  end->back() = static_cast<char>(ValueType::kGroupEnd) + 1;
+  return !request_.has_where_expr() ||
+         NarrowRangeDeleteBounds(request_.where_expr().condition(), schema_, rows_prefix,
+                                 start, end);
+}
+
 Status QLWriteOperation::DeleteRow(DocWriteBatch* doc_write_batch,
                                    const DocPath row_path) {
   if (request_.has_user_timestamp_usec()) {
@@ -2050,13 +2952,15 @@ Status QLWriteOperation::DeleteRow(DocWriteBatch* doc_write_batch,
                                                   request_.user_timestamp_usec()));
     }
 
-    // Delete the liveness column as well.
-    const DocPath liveness_column(
-        row_path.encoded_doc_key(),
-        PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
-    RETURN_NOT_OK(doc_write_batch->DeleteSubDoc(liveness_column,
-                                                request_.query_id(),
-                                                request_.user_timestamp_usec()));
+    // Delete the liveness and packed row columns as well.
+    for (const auto system_column_id : {SystemColumnIds::kLivenessColumn,
+                                        SystemColumnIds::kPackedRowColumn}) {
+      const DocPath system_column(row_path.encoded_doc_key(),
+                                  PrimitiveValue::SystemColumnId(system_column_id));
+      RETURN_NOT_OK(doc_write_batch->DeleteSubDoc(system_column,
+                                                  request_.query_id(),
+                                                  request_.user_timestamp_usec()));
+    }
   } else {
     RETURN_NOT_OK(doc_write_batch->DeleteSubDoc(row_path));
   }
@@ -2067,7 +2971,7 @@ Status QLWriteOperation::DeleteRow(DocWriteBatch* doc_write_batch,
 Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
                                 const ReadHybridTime& read_time,
                                 const Schema& schema,
-                                const Schema& query_schema,
+                                const QLProjections& projections,
                                 QLResultSet* resultset,
                                 HybridTime* restart_read_ht) {
   size_t row_count_limit = std::numeric_limits<std::size_t>::max();
@@ -2078,13 +2982,13 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
     row_count_limit = request_.limit();
   }
 
-  // Create the projections of the non-key columns selected by the row block plus any referenced in
-  // the WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
+  // The projections of the non-key columns selected by the row block plus any referenced in the
+  // WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
   // projection only to scan sub-documents. The query schema is used to select only referenced
   // columns and key columns.
-  Schema static_projection, non_static_projection;
-  RETURN_NOT_OK(CreateProjections(schema, request_.column_refs(),
-                                  &static_projection, &non_static_projection));
+  const Schema& query_schema = projections.query_schema;
+  const Schema& static_projection = projections.static_projection;
+  const Schema& non_static_projection = projections.non_static_projection;
   const bool read_static_columns = !static_projection.columns().empty();
   const bool read_distinct_columns = request_.distinct();
 
@@ -2094,11 +2998,24 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
   RETURN_NOT_OK(ql_storage.BuildQLScanSpec(
       request_, read_time, schema, read_static_columns, static_projection, &spec,
       &static_row_spec, &req_read_time));
-  RETURN_NOT_OK(ql_storage.GetIterator(request_, query_schema, schema, txn_op_context_,
-                                       req_read_time, &iter));
-  RETURN_NOT_OK(iter->Init(*spec));
-  if (FLAGS_trace_docdb_calls) {
-    TRACE("Initialized iterator");
+  // Static rows are joined with the rows that follow them, and distinct and aggregate reads don't
+  // stop at a row boundary, so only plain scans continue on the iterator of the previous page.
+  const bool cache_iterator = !txn_op_context_ && !schema.has_statics() &&
+                              !read_distinct_columns && !request_.is_aggregate();
+  if (cache_iterator) {
+    iter = ql_storage.TakeCachedIterator(request_);
+  }
+  if (iter) {
+    if (FLAGS_trace_docdb_calls) {
+      TRACE("Continuing cached iterator");
+    }
+  } else {
+    RETURN_NOT_OK(ql_storage.GetIterator(request_, query_schema, schema, txn_op_context_,
+                                         req_read_time, &iter));
+    RETURN_NOT_OK(iter->Init(*spec));
+    if (FLAGS_trace_docdb_calls) {
+      TRACE("Initialized iterator");
+    }
   }
 
   QLTableRow static_row;
@@ -2121,6 +3038,22 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
   // Begin the normal fetch.
   int match_count = 0;
   bool static_dealt_with = true;
+  if (!schema.has_statics() && !read_distinct_columns && FLAGS_ql_scan_batch_size > 1) {
+    // Without static columns there is no static / non-static row join to do, so rows can be
+    // fetched, filtered and aggregated a batch at a time. Each row contributes at most one row to
+    // the result set, so the batch is capped at the remaining limit to keep the iterator positioned
+    // at the first unread row for the paging state.
+    std::vector<QLTableRow> rows;
+    size_t num_rows = 0;
+    do {
+      const size_t max_rows = std::min<size_t>(
+          FLAGS_ql_scan_batch_size, row_count_limit - resultset->rsrow_count());
+      RETURN_NOT_OK(iter->NextRowBatch(non_static_projection, max_rows, &rows, &num_rows));
+      for (size_t i = 0; i < num_rows; i++) {
+        RETURN_NOT_OK(AddRowToResult(spec, rows[i], row_count_limit, resultset, &match_count));
+      }
+    } while (num_rows > 0 && resultset->rsrow_count() < row_count_limit);
+  }
   while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
     const bool last_read_static = iter->IsNextStaticColumn();
 
@@ -2207,6 +3140,9 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
 
   if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, &response_));
+    if (cache_iterator && !restart_read_ht->is_valid()) {
+      ql_storage.CacheIterator(request_, response_, std::move(iter));
+    }
   }
 
   return Status::OK();
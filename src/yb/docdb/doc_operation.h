@@ -19,6 +19,8 @@
 
 #include "yb/rocksdb/db.h"
 
+#include "yb/common/index.h"
+#include "yb/common/partition.h"
 #include "yb/common/ql_storage_interface.h"
 #include "yb/common/read_hybrid_time.h"
 #include "yb/common/redis_protocol.pb.h"
@@ -30,6 +32,7 @@
 #include "yb/docdb/doc_path.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/doc_expr.h"
+#include "yb/docdb/ql_projection_cache.h"
 
 namespace yb {
 namespace docdb {
@@ -62,6 +65,8 @@ typedef std::vector<std::unique_ptr<DocOperation>> DocOperations;
 struct RedisValue {
   RedisDataType type;
   std::string value;
+  // Remaining TTL of a string value in seconds, -1 if it does not expire.
+  int64_t ttl_seconds = -1;
 };
 
 class RedisWriteOperation : public DocOperation {
@@ -88,7 +93,7 @@ class RedisWriteOperation : public DocOperation {
   CHECKED_STATUS ApplyAppend(const DocOperationApplyData& data);
   CHECKED_STATUS ApplyDel(const DocOperationApplyData& data);
   CHECKED_STATUS ApplySetRange(const DocOperationApplyData& data);
-  CHECKED_STATUS ApplyIncr(const DocOperationApplyData& data, int64_t incr = 1);
+  CHECKED_STATUS ApplyIncr(const DocOperationApplyData& data);
   CHECKED_STATUS ApplyPush(const DocOperationApplyData& data);
   CHECKED_STATUS ApplyInsert(const DocOperationApplyData& data);
   CHECKED_STATUS ApplyPop(const DocOperationApplyData& data);
@@ -103,10 +108,12 @@ class RedisWriteOperation : public DocOperation {
 
 class RedisReadOperation {
  public:
+  // The partition of the tablet is used by SCAN, to continue from the next tablet.
   explicit RedisReadOperation(const yb::RedisReadRequestPB& request,
                               rocksdb::DB* db,
-                              const ReadHybridTime& read_time)
-      : request_(request), db_(db), read_time_(read_time) {}
+                              const ReadHybridTime& read_time,
+                              const Partition* partition = nullptr)
+      : request_(request), db_(db), read_time_(read_time), partition_(partition) {}
 
   CHECKED_STATUS Execute();
 
@@ -127,6 +134,7 @@ class RedisReadOperation {
   CHECKED_STATUS ExecuteExists();
   CHECKED_STATUS ExecuteGetRange();
   CHECKED_STATUS ExecuteCollectionGetRange();
+  CHECKED_STATUS ExecuteScan();
   CHECKED_STATUS ExecuteGetCard(rocksdb::DB *rocksdb, HybridTime hybrid_time);
 
   rocksdb::QueryId redis_query_id() { return reinterpret_cast<rocksdb::QueryId> (&request_); }
@@ -135,13 +143,18 @@ class RedisReadOperation {
   RedisResponsePB response_;
   rocksdb::DB* db_;
   ReadHybridTime read_time_;
+  const Partition* partition_;
 };
 
 class QLWriteOperation : public DocOperation, public DocExprExecutor {
  public:
+  // If index_map is given, the operation also computes the writes to the index tables. The map
+  // must outlive Apply().
   QLWriteOperation(const Schema& schema,
-                   const TransactionOperationContextOpt& txn_op_context)
+                   const TransactionOperationContextOpt& txn_op_context,
+                   const IndexMap* index_map = nullptr)
       : schema_(schema),
+        index_map_(index_map),
         txn_op_context_(txn_op_context)
   {}
 
@@ -160,6 +173,12 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
   // Rowblock to return the "[applied]" status for conditional DML.
   const QLRowBlock* rowblock() const { return rowblock_.get(); }
 
+  // Writes to apply to the index tables to keep them in sync with this write, with the id of the
+  // index table each one is for.
+  typedef std::vector<std::pair<TableId, QLWriteRequestPB>> IndexRequests;
+  const IndexRequests& index_requests() const { return index_requests_; }
+  IndexRequests* mutable_index_requests() { return &index_requests_; }
+
  private:
   // Initialize hashed_doc_key_ and/or pk_doc_key_.
   CHECKED_STATUS InitializeKeys(bool hashed_key, bool primary_key);
@@ -178,7 +197,33 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
   CHECKED_STATUS DeleteRow(DocWriteBatch* doc_write_batch,
                            const DocPath row_path);
 
+  // Returns true if the rows deleted by this range delete are exactly those with encoded DocKeys in
+  // [start, end), so that they could be deleted by a single range tombstone.
+  bool GetRangeDeleteBounds(std::string* start, std::string* end) const;
+
+  // Columns to read before the write: those referenced by the request, plus the non-key columns
+  // covered by the indexes when they are updated.
+  const QLReferencedColumnsPB& read_column_refs() const {
+    return update_indexes_ ? read_column_refs_ : request_.column_refs();
+  }
+
+  // Adds the non-key columns covered by the indexes to read_column_refs_.
+  void AddIndexedColumnRefs();
+
+  // Returns the value of an indexed table column of the row, taking key columns from the request.
+  QLValuePB IndexedColumnValue(const QLTableRow& row, ColumnId column_id) const;
+
+  // Computes index_requests_ given the row before the write and after it ("new_row" is ignored if
+  // the row is deleted).
+  CHECKED_STATUS UpdateIndexes(const QLTableRow& existing_row, bool existing_row_read,
+                               const QLTableRow& new_row, bool row_deleted);
+
   const Schema& schema_;
+  const IndexMap* const index_map_;
+
+  // Whether index_requests_ are computed, and the columns to read for them if so.
+  bool update_indexes_ = false;
+  QLReferencedColumnsPB read_column_refs_;
 
   // Doc key and doc path for hashed key (i.e. without range columns). Present when there is a
   // static column being written.
@@ -194,6 +239,7 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
   QLWriteRequestPB request_;
   QLResponsePB* response_ = nullptr;
   const TransactionOperationContextOpt txn_op_context_;
+  IndexRequests index_requests_;
 
   // The row that is returned to the CQL client for an INSERT/UPDATE/DELETE that has a
   // "... IF <condition> ..." clause. The row contains the "[applied]" status column
@@ -202,8 +248,18 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
 
   // Does this write operation require a read?
   bool require_read_ = false;
+
+  // Whether the referenced columns are read before the write, to evaluate the condition or the
+  // assigned expressions.
+  bool read_for_evaluation_ = false;
 };
 
+// Fills the insert of the index entry of a row of the indexed table, read with the columns covered
+// by the index, e.g. to backfill a new index. Returns false if the row has no index entry because
+// of a null in the index key.
+bool IndexInsertRequestForRow(const IndexInfo& index, const QLTableRow& row,
+                              QLWriteRequestPB* index_request);
+
 class QLReadOperation : public DocExprExecutor {
  public:
   QLReadOperation(
@@ -214,7 +270,7 @@ class QLReadOperation : public DocExprExecutor {
   CHECKED_STATUS Execute(const common::QLStorageIf& ql_storage,
                          const ReadHybridTime& read_time,
                          const Schema& schema,
-                         const Schema& query_schema,
+                         const QLProjections& projections,
                          QLResultSet* result_set,
                          HybridTime* restart_read_ht);
 
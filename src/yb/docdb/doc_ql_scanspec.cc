@@ -11,6 +11,9 @@
 // under the License.
 //
 
+#include <algorithm>
+#include <iterator>
+
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/rocksdb/db/compaction.h"
@@ -57,6 +60,73 @@ DocQLScanSpec::DocQLScanSpec(const Schema& schema,
       upper_doc_key_(bound_key(false)),
       include_static_columns_(include_static_columns),
       query_id_(query_id) {
+  if (condition != nullptr && schema_.num_range_key_columns() > 0) {
+    InitRangeOptions(*condition);
+  }
+}
+
+void DocQLScanSpec::InitRangeOptions(const QLConditionPB& condition) {
+  const auto& operands = condition.operands();
+  if (condition.op() == QL_OP_AND) {
+    for (const auto& operand : operands) {
+      if (operand.expr_case() == QLExpressionPB::ExprCase::kCondition) {
+        InitRangeOptions(operand.condition());
+      }
+    }
+    return;
+  }
+  if ((condition.op() != QL_OP_EQUAL && condition.op() != QL_OP_IN) || operands.size() != 2) {
+    return;
+  }
+
+  const QLExpressionPB* col_expr = &operands.Get(0);
+  const QLExpressionPB* val_expr = &operands.Get(1);
+  if (condition.op() == QL_OP_EQUAL &&
+      col_expr->expr_case() == QLExpressionPB::ExprCase::kValue) {
+    std::swap(col_expr, val_expr);
+  }
+  if (col_expr->expr_case() != QLExpressionPB::ExprCase::kColumnId ||
+      val_expr->expr_case() != QLExpressionPB::ExprCase::kValue) {
+    return;
+  }
+  const ColumnId column_id(col_expr->column_id());
+  if (!schema_.is_range_column(column_id)) {
+    return;
+  }
+  const size_t column_idx = schema_.find_column_by_id(column_id);
+  const auto& column = schema_.column(column_idx);
+
+  std::vector<PrimitiveValue> values;
+  if (condition.op() == QL_OP_EQUAL) {
+    if (!IsNull(val_expr->value())) {
+      values.push_back(PrimitiveValue::FromQLValuePB(val_expr->value(), column.sorting_type()));
+    }
+  } else {
+    const auto& elems = val_expr->value().list_value().elems();
+    values.reserve(elems.size());
+    for (const auto& elem : elems) {
+      if (!IsNull(elem)) {
+        values.push_back(PrimitiveValue::FromQLValuePB(elem, column.sorting_type()));
+      }
+    }
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  if (range_options_.empty()) {
+    range_options_.resize(schema_.num_range_key_columns());
+  }
+  auto& options = range_options_[column_idx - schema_.num_hash_key_columns()];
+  if (options.empty()) {
+    options = std::move(values);
+  } else {
+    // The column is restricted more than once, so only values allowed by all conditions remain.
+    // An empty intersection leaves the column unrestricted here, Match() still filters the rows.
+    std::vector<PrimitiveValue> intersection;
+    std::set_intersection(options.begin(), options.end(), values.begin(), values.end(),
+                          std::back_inserter(intersection));
+    options = std::move(intersection);
+  }
 }
 
 DocKey DocQLScanSpec::bound_key(const bool lower_bound) const {
@@ -58,8 +58,19 @@ class DocQLScanSpec : public common::QLScanSpec {
     return query_id_;
   }
 
+  // For each range column, the sorted values it is restricted to by the equality and IN conditions
+  // in the top-level conjunction of the WHERE clause. An empty list means the column is not
+  // restricted. Empty if no range column is restricted. Used to skip over rows between qualifying
+  // range key prefixes instead of reading and filtering them.
+  const std::vector<std::vector<PrimitiveValue>>& range_options() const {
+    return range_options_;
+  }
+
  private:
 
+  // Collects the range column values allowed by the given condition into range_options_.
+  void InitRangeOptions(const QLConditionPB& condition);
+
   // Return inclusive lower/upper range doc key considering the start_doc_key.
   CHECKED_STATUS GetBoundKey(const bool lower_bound, DocKey* key) const;
 
@@ -104,6 +115,9 @@ class DocQLScanSpec : public common::QLScanSpec {
 
   // Query ID of this scan.
   const rocksdb::QueryId query_id_;
+
+  // Allowed values of the range columns, see range_options().
+  std::vector<std::vector<PrimitiveValue>> range_options_;
 };
 
 }  // namespace docdb
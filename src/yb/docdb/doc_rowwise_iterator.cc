@@ -49,8 +49,9 @@ DocRowwiseIterator::DocRowwiseIterator(
       has_bound_key_(false),
       pending_op_(pending_op_counter),
       done_(false) {
-  projection_subkeys_.reserve(projection.num_columns() + 1);
+  projection_subkeys_.reserve(projection.num_columns() + 2);
   projection_subkeys_.push_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
+  projection_subkeys_.push_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRowColumn));
   for (size_t i = projection_.num_key_columns(); i < projection.num_columns(); i++) {
     projection_subkeys_.emplace_back(projection.column_id(i));
   }
@@ -66,6 +67,7 @@ Status DocRowwiseIterator::Init() {
   db_iter_ = CreateIntentAwareIterator(
       db_, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
       query_id, txn_op_context_, read_time_);
+  RETURN_NOT_OK(InitRangeTombstones());
 
   row_key_ = DocKey();
   db_iter_->Seek(row_key_);
@@ -99,6 +101,7 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   db_iter_ = CreateIntentAwareIterator(
       db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
+  RETURN_NOT_OK(InitRangeTombstones());
 
   db_iter_->SeekWithoutHt(row_key_encoded);
   row_ready_ = false;
@@ -108,6 +111,7 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
     if (has_bound_key_) {
       bound_key_ = upper_doc_key;
     }
+    range_options_ = doc_spec.range_options();
   } else {
     has_bound_key_ = !lower_doc_key.empty();
     if (has_bound_key_) {
@@ -130,6 +134,43 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   return Status::OK();
 }
 
+Status DocRowwiseIterator::InitRangeTombstones() {
+  // Range tombstones within the uncertainty window of the read are loaded too, the read has to be
+  // restarted if one of them covers a row.
+  auto range_tombstones = ReadRangeTombstones(db_, read_time_.global_limit);
+  RETURN_NOT_OK(range_tombstones);
+  range_tombstones_ = std::move(*range_tombstones);
+  return Status::OK();
+}
+
+bool DocRowwiseIterator::MatchRangeOptionsOrSkip() const {
+  const auto& range_group = row_key_.range_group();
+  const size_t num_columns = std::min(range_options_.size(), range_group.size());
+  for (size_t i = 0; i < num_columns; i++) {
+    const auto& options = range_options_[i];
+    if (options.empty()) {
+      continue;
+    }
+    const auto it = std::lower_bound(options.begin(), options.end(), range_group[i]);
+    if (it != options.end() && *it == range_group[i]) {
+      continue;
+    }
+
+    // Jump to the next allowed value of this column under the same prefix, or past the prefix
+    // altogether when the current value is beyond all allowed values.
+    DocKey seek_key = row_key_;
+    seek_key.ClearRangeComponents();
+    for (size_t j = 0; j < i; j++) {
+      seek_key.AddRangeComponent(range_group[j]);
+    }
+    seek_key.AddRangeComponent(it != options.end() ? *it : PrimitiveValue(ValueType::kHighest));
+    VLOG(4) << "Skipping from " << row_key_ << " to " << seek_key;
+    db_iter_->SeekForwardWithoutHt(seek_key.Encode());
+    return false;
+  }
+  return true;
+}
+
 Status DocRowwiseIterator::EnsureIteratorPositionCorrect() const {
   if (!is_forward_scan_) {
     db_iter_->PrevDocKey(row_key_);
@@ -172,12 +213,20 @@ bool DocRowwiseIterator::HasNext() const {
       return false;
     }
 
+    if (!range_options_.empty() && !MatchRangeOptionsOrSkip()) {
+      continue;
+    }
+
     KeyBytes old_key(*fetched_key);
     // The iterator is positioned by the previous GetSubDocument call
     // (which places the iterator outside the previous doc_key).
     SubDocKey sub_doc_key(row_key_);
     GetSubDocumentData data = { &sub_doc_key, &row_, &doc_found };
     data.table_ttl = TableTTL(schema_);
+    if (range_tombstones_) {
+      data.deleted_ht = range_tombstones_->DeletedAt(
+          row_key_.Encode().AsSlice(), read_time_.read, &range_tombstone_seen_ht_);
+    }
     status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
     // After this, the iter should be positioned right after the subdocument.
     if (!status_.ok()) {
@@ -261,6 +310,7 @@ void DocRowwiseIterator::SkipRow() {
 
 HybridTime DocRowwiseIterator::RestartReadHt() {
   auto max_seen_ht = db_iter_->max_seen_ht();
+  max_seen_ht.MakeAtLeast(range_tombstone_seen_ht_);
   if (max_seen_ht.is_valid() && max_seen_ht > db_iter_->read_time().read) {
     return max_seen_ht;
   }
@@ -314,6 +364,30 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   return Status::OK();
 }
 
+Status DocRowwiseIterator::DoNextRowBatch(const Schema& projection,
+                                          size_t max_rows,
+                                          std::vector<QLTableRow>* table_rows,
+                                          size_t* num_rows) {
+  *num_rows = 0;
+  if (table_rows->size() < max_rows) {
+    table_rows->resize(max_rows);
+  }
+  bool batch_is_static = false;
+  while (*num_rows < max_rows && DocRowwiseIterator::HasNext()) {
+    const bool next_is_static = DocRowwiseIterator::IsNextStaticColumn();
+    if (*num_rows == 0) {
+      batch_is_static = next_is_static;
+    } else if (next_is_static != batch_is_static) {
+      break;
+    }
+    QLTableRow& table_row = (*table_rows)[*num_rows];
+    table_row.Clear();
+    RETURN_NOT_OK(DocRowwiseIterator::DoNextRow(projection, &table_row));
+    ++*num_rows;
+  }
+  return Status::OK();
+}
+
 CHECKED_STATUS DocRowwiseIterator::GetNextReadSubDocKey(SubDocKey* sub_doc_key) const {
   if (db_iter_ == nullptr) {
     return STATUS(Corruption, "Iterator not initialized.");
@@ -26,6 +26,7 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/value.h"
 #include "yb/util/status.h"
 #include "yb/util/pending_op_counter.h"
@@ -71,6 +72,12 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
     return projection_;
   }
 
+  // Whether the iterator keeps its own copy of the projection, so it may outlive the projection
+  // that it was created with.
+  bool owns_projection() const {
+    return projection_owner_ != nullptr;
+  }
+
   // Init QL read scan.
   CHECKED_STATUS Init(const common::QLScanSpec& spec) override;
 
@@ -122,6 +129,14 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
                                      const Value& value,
                                      bool* is_valid) const;
 
+  // Checks the range components of row_key_ against range_options_. Returns true if the row may
+  // qualify. Otherwise seeks db_iter_ forward to the smallest key that may qualify after row_key_
+  // and returns false.
+  bool MatchRangeOptionsOrSkip() const;
+
+  // Loads the range tombstones that could cover the rows of the scan.
+  CHECKED_STATUS InitRangeTombstones();
+
   // For reverse scans, moves the iterator to the first kv-pair of the previous row after having
   // constructed the current row. For forward scans nothing is necessary because GetSubDocument
   // ensures that the iterator will be positioned on the first kv-pair of the next row.
@@ -130,6 +145,13 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   // Read next row into a value map using the specified projection.
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
+  // Read a batch of rows using the specified projection. Same as the default implementation, but
+  // avoids the virtual HasNext / IsNextStaticColumn / DoNextRow dispatch for every row.
+  CHECKED_STATUS DoNextRowBatch(const Schema& projection,
+                                size_t max_rows,
+                                std::vector<QLTableRow>* table_rows,
+                                size_t* num_rows) override;
+
   const Schema& projection_;
   // Used to maintain ownership of projection_.
   // Separate field is used since ownership could be optional.
@@ -152,6 +174,13 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   bool has_bound_key_;
   DocKey bound_key_;
 
+  // Allowed values of range columns for skipping non-qualifying rows during forward scans, see
+  // DocQLScanSpec::range_options().
+  std::vector<std::vector<PrimitiveValue>> range_options_;
+
+  // Range tombstones written up to the global limit of the read, nullptr if there are none.
+  RangeTombstonesPtr range_tombstones_;
+
   std::unique_ptr<IntentAwareIterator> db_iter_;
 
   // We keep the "pending operation" counter incremented for the lifetime of this iterator so that
@@ -176,6 +205,9 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
 
   mutable std::vector<PrimitiveValue> projection_subkeys_;
 
+  // The latest range tombstone written after the read time that covers a row found by the scan.
+  mutable HybridTime range_tombstone_seen_ht_;
+
   // Used for keeping track of errors that happen in HasNext. Returned
   mutable Status status_;
 };
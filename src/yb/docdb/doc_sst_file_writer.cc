@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_sst_file_writer.h"
+
+#include <algorithm>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.h"
+#include "yb/rocksdb/immutable_options.h"
+
+namespace yb {
+namespace docdb {
+
+DocSstFileWriter::DocSstFileWriter(const rocksdb::Options& options) : options_(options) {
+}
+
+void DocSstFileWriter::Add(const DocWriteBatch& write_batch, HybridTime hybrid_time) {
+  // Same encoding as in PrepareNonTransactionWriteBatch, the write id is the position of the entry
+  // in its write batch.
+  DocHybridTimeBuffer doc_ht_buffer;
+  std::vector<std::pair<std::string, std::string>> entries;
+  entries.reserve(write_batch.size());
+  IntraTxnWriteId write_id = 0;
+  for (const auto& entry : write_batch.key_value_pairs()) {
+    const Slice encoded_ht = doc_ht_buffer.EncodeWithValueType(hybrid_time, write_id);
+    std::string key;
+    key.reserve(entry.first.size() + encoded_ht.size());
+    key.append(entry.first);
+    key.append(encoded_ht.cdata(), encoded_ht.size());
+    entries.emplace_back(std::move(key), entry.second);
+    ++write_id;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.empty()) {
+    entries_ = std::move(entries);
+  } else {
+    entries_.insert(entries_.end(), std::make_move_iterator(entries.begin()),
+                    std::make_move_iterator(entries.end()));
+  }
+}
+
+size_t DocSstFileWriter::num_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+Status DocSstFileWriter::Finish(const std::string& file_path,
+                                rocksdb::ExternalSstFileInfo* file_info) {
+  std::vector<std::pair<std::string, std::string>> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+  }
+  if (entries.empty()) {
+    return STATUS(InvalidArgument, "No entries to write to SST file", file_path);
+  }
+
+  const rocksdb::Comparator* comparator = options_.comparator;
+  std::sort(entries.begin(), entries.end(),
+            [comparator](const auto& lhs, const auto& rhs) {
+              return comparator->Compare(lhs.first, rhs.first) < 0;
+            });
+
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options_),
+                                comparator);
+  RETURN_NOT_OK(writer.Open(file_path));
+  for (size_t i = 0; i != entries.size(); ++i) {
+    if (i != 0 && comparator->Compare(entries[i - 1].first, entries[i].first) == 0) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Key added more than once at the same hybrid time: $0",
+          BestEffortDocDBKeyToStr(KeyBytes(entries[i].first)));
+    }
+    RETURN_NOT_OK(writer.Add(entries[i].first, entries[i].second));
+  }
+  return writer.Finish(file_info);
+}
+
+}  // namespace docdb
+}  // namespace yb
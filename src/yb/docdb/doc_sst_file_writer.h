@@ -0,0 +1,64 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOC_SST_FILE_WRITER_H_
+#define YB_DOCDB_DOC_SST_FILE_WRITER_H_
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/docdb/doc_write_batch.h"
+#include "yb/rocksdb/options.h"
+#include "yb/rocksdb/sst_file_writer.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// Builds an SST file with DocDB data that could be ingested into the RocksDB instance of a tablet
+// with Tablet::IngestSstFiles, bypassing the memtable and Raft. Entries are encoded exactly as a
+// non-transactional write of the same DocWriteBatch at the given hybrid time would encode them, so
+// rows can be prepared with the usual DocDB operations, e.g. QLWriteOperation, in any order.
+//
+// All keys of the file get sequence number 0, so the key range of the file should not overlap
+// with the data already present in the tablet.
+class DocSstFileWriter {
+ public:
+  // The options should be initialized with InitRocksDBOptions, so the file has the same format as
+  // the files of the tablet RocksDB instance.
+  explicit DocSstFileWriter(const rocksdb::Options& options);
+
+  // Adds the entries of the given write batch at the given hybrid time. Thread-safe.
+  void Add(const DocWriteBatch& write_batch, HybridTime hybrid_time);
+
+  size_t num_entries() const;
+
+  // Sorts the added entries and writes them to a new SST file at the given path. The writer is
+  // empty afterwards and could be used to build the next file.
+  CHECKED_STATUS Finish(const std::string& file_path,
+                        rocksdb::ExternalSstFileInfo* file_info = nullptr);
+
+ private:
+  const rocksdb::Options options_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::pair<std::string, std::string>> entries_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_DOC_SST_FILE_WRITER_H_
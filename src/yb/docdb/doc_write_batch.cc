@@ -16,6 +16,7 @@
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/internal_doc_iterator.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/value_type.h"
 #include "yb/rocksdb/db.h"
 #include "yb/server/hybrid_clock.h"
@@ -274,6 +275,14 @@ Status DocWriteBatch::DeleteSubDoc(
   return SetPrimitive(doc_path, PrimitiveValue::kTombstone, query_id, user_timestamp);
 }
 
+void DocWriteBatch::DeleteRange(const Slice& start, const Slice& end) {
+  KeyBytes key;
+  AppendRangeTombstoneKey(start, &key);
+  put_batch_.emplace_back(key.data(), end.ToBuffer());
+  // Cached init markers and collection values of the covered documents are no longer valid.
+  cache_.Clear();
+}
+
 Status DocWriteBatch::ExtendList(
     const DocPath& doc_path,
     const SubDocument& value,
@@ -377,6 +386,22 @@ Status DocWriteBatch::ReplaceInList(
   }
 }
 
+const std::string* DocWriteBatch::LookupPendingValue(const KeyBytes& encoded_key_prefix) {
+  auto cached_entry = cache_.Get(encoded_key_prefix);
+  if (!cached_entry || cached_entry->doc_hybrid_time.hybrid_time() != HybridTime::kMax) {
+    return nullptr;
+  }
+  // The write id of the entry is the size of the batch when the write started. The write puts
+  // the missing init markers of its parents first, and then the value itself.
+  const auto key = encoded_key_prefix.AsStringRef();
+  for (size_t i = cached_entry->doc_hybrid_time.write_id(); i < put_batch_.size(); ++i) {
+    if (put_batch_[i].first == key) {
+      return &put_batch_[i].second;
+    }
+  }
+  return nullptr;
+}
+
 void DocWriteBatch::Clear() {
   put_batch_.clear();
   cache_.Clear();
@@ -110,6 +110,11 @@ class DocWriteBatch {
       rocksdb::QueryId query_id = rocksdb::kDefaultQueryId,
       UserTimeMicros user_timestamp = Value::kInvalidUserTimestamp);
 
+  // Deletes the documents with encoded DocKeys in [start, end) with a single range tombstone, see
+  // range_tombstone.h. Writes of the same batch that follow still apply to the covered documents.
+  // Not supported in transactions, whose writes are converted to intents of individual keys.
+  void DeleteRange(const Slice& start, const Slice& end);
+
   void Clear();
   bool IsEmpty() const { return put_batch_.empty(); }
 
@@ -135,6 +140,11 @@ class DocWriteBatch {
     return cache_.Get(encoded_key_prefix);
   }
 
+  // Returns the encoded value that the latest write of this batch to the given key prefix put,
+  // or nullptr if this batch does not write the key prefix. Lets read-modify-write operations
+  // observe the earlier operations of the same batch without reading RocksDB.
+  const std::string* LookupPendingValue(const KeyBytes& encoded_key_prefix);
+
  private:
   // This member function performs the necessary operations to set a primitive value for a given
   // docpath assuming the appropriate operations have been taken care of for subkeys with index <
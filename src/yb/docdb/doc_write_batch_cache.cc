@@ -22,8 +22,6 @@
 #include "yb/docdb/primitive_value.h"
 #include "yb/util/bytes_formatter.h"
 
-using std::back_inserter;
-using std::copy;
 using std::endl;
 using std::ostringstream;
 using std::pair;
@@ -47,13 +45,24 @@ void DocWriteBatchCache::Put(const KeyBytes& key_bytes,
       BestEffortDocDBKeyToStr(key_bytes),
       gen_ht.ToString(),
       ToString(value_type));
-  prefix_to_gen_ht_[key_bytes.AsStringRef()] =
-      {gen_ht, value_type, user_timestamp, found_exact_key_prefix};
+  const Entry entry = {gen_ht, value_type, user_timestamp, found_exact_key_prefix};
+  const Slice key = key_bytes.AsSlice();
+  auto iter = prefix_to_gen_ht_.find(key);
+  if (iter != prefix_to_gen_ht_.end()) {
+    iter->second = entry;
+    return;
+  }
+  if (!arena_) {
+    arena_ = std::make_unique<Arena>(kArenaStartBlockSize);
+  }
+  Slice key_copy;
+  CHECK(arena_->RelocateSlice(key, &key_copy));
+  prefix_to_gen_ht_.emplace(key_copy, entry);
 }
 
 boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
-    const KeyBytes& encoded_key_prefix) {
-  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsStringRef());
+    const Slice& encoded_key_prefix) {
+  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix);
 #ifdef DOCDB_DEBUG
   if (iter == prefix_to_gen_ht_.end()) {
     DOCDB_DEBUG_LOG("DocWriteBatchCache contained no entry for $0",
@@ -68,7 +77,9 @@ boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
 
 string DocWriteBatchCache::ToDebugString() {
   vector<pair<string, Entry>> sorted_contents;
-  copy(prefix_to_gen_ht_.begin(), prefix_to_gen_ht_.end(), back_inserter(sorted_contents));
+  for (const auto& prefix_and_entry : prefix_to_gen_ht_) {
+    sorted_contents.emplace_back(prefix_and_entry.first.ToBuffer(), prefix_and_entry.second);
+  }
   sort(sorted_contents.begin(), sorted_contents.end());
   ostringstream ss;
   ss << "DocWriteBatchCache[" << endl;
@@ -95,6 +106,9 @@ string DocWriteBatchCache::EntryToStr(const Entry& entry) {
 
 void DocWriteBatchCache::Clear() {
   prefix_to_gen_ht_.clear();
+  if (arena_) {
+    arena_->Reset();
+  }
 }
 
 }  // namespace docdb
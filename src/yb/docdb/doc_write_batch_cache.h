@@ -14,6 +14,7 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 #define YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 
+#include <memory>
 #include <unordered_map>
 #include <string>
 
@@ -23,6 +24,8 @@
 #include "yb/docdb/key_bytes.h"
 #include "yb/docdb/value_type.h"
 #include "yb/docdb/value.h"
+#include "yb/util/memory/arena.h"
+#include "yb/util/slice.h"
 
 namespace yb {
 namespace docdb {
@@ -57,8 +60,7 @@ class DocWriteBatchCache {
 
   // Returns the latest generation hybrid_time for the document/subdocument identified by the given
   // encoded key prefix.
-  // TODO: switch to taking a slice as an input to avoid making a copy on lookup.
-  boost::optional<Entry> Get(const KeyBytes& encoded_key_prefix);
+  boost::optional<Entry> Get(const Slice& encoded_key_prefix);
 
   std::string ToDebugString();
 
@@ -67,7 +69,12 @@ class DocWriteBatchCache {
   void Clear();
 
  private:
-  std::unordered_map<std::string, Entry> prefix_to_gen_ht_;
+  static constexpr size_t kArenaStartBlockSize = 1024;
+
+  // Keys of the map point to copies of the key prefixes in arena_, so that lookups do not need to
+  // allocate a string. The arena is created by the first Put.
+  std::unordered_map<Slice, Entry, Slice::Hash> prefix_to_gen_ht_;
+  std::unique_ptr<Arena> arena_;
 };
 
 
@@ -30,6 +30,8 @@ KeyType GetKeyType(const Slice& slice) {
     } else {
       return KeyType::kIntentKey;
     }
+  } else if (*slice.data() == static_cast<char>(ValueType::kRangeTombstonePrefix)) {
+    return KeyType::kRangeTombstone;
   } else {
     return KeyType::kValueKey;
   }
@@ -55,7 +55,8 @@ namespace yb {
 namespace docdb {
 
 // Type of keys written by DocDB into RocksDB.
-YB_DEFINE_ENUM(KeyType, (kEmpty)(kIntentKey)(kReverseTxnKey)(kValueKey)(kTransactionMetadata));
+YB_DEFINE_ENUM(KeyType, (kEmpty)(kIntentKey)(kReverseTxnKey)(kValueKey)(kTransactionMetadata)
+                        (kRangeTombstone));
 
 KeyType GetKeyType(const Slice& slice);
 
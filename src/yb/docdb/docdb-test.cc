@@ -17,16 +17,20 @@
 #include <string>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/version_edit.h"
 #include "yb/rocksdb/status.h"
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/doc_sst_file_writer.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/lock_batch.h"
+#include "yb/docdb/shared_lock_manager.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/server/hybrid_clock.h"
@@ -54,6 +58,8 @@ using rocksdb::WriteOptions;
 
 using namespace std::chrono_literals;
 
+DECLARE_bool(docdb_drop_expired_files);
+DECLARE_int32(docdb_prefix_lock_min_keys);
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
 
@@ -64,6 +70,7 @@ CHECKED_STATUS GetPrimitiveValue(const rocksdb::UserBoundaryValues &values,
     size_t index,
     PrimitiveValue *out);
 CHECKED_STATUS GetDocHybridTime(const rocksdb::UserBoundaryValues &values, DocHybridTime *out);
+std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
 
 class DocDBTest: public DocDBTestBase {
  protected:
@@ -410,6 +417,32 @@ SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey1"; HT{ physical: 3000 }]) -
       )#");
 }
 
+TEST_F(DocDBTest, HistoryCleanupOnFlush) {
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  for (int i = 1; i <= 3; ++i) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue("subkey1")),
+        PrimitiveValue(Format("value$0", i)),
+        HybridTime::FromMicros(i * 1000)));
+  }
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue("subkey2")),
+      PrimitiveValue("value4"),
+      HybridTime::FromMicros(1500)));
+  ASSERT_OK(DeleteSubDoc(
+      DocPath(encoded_doc_key, PrimitiveValue("subkey2")), HybridTime::FromMicros(2500)));
+
+  // Overwritten entries are not written to disk, while the delete is kept for the older files.
+  SetHistoryCutoffHybridTime(HybridTime::FromMicros(3500));
+  ASSERT_OK(FlushRocksDB());
+  SetHistoryCutoffHybridTime(HybridTime::kMin);
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey1"; HT{ physical: 3000 }]) -> "value3"
+      SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey2"; HT{ physical: 2500 }]) -> DEL
+      )#");
+}
+
 TEST_F(DocDBTest, SetPrimitiveQL) {
   const DocKey doc_key(PrimitiveValues("mydockey", 123456));
   SetupRocksDBState(doc_key.Encode());
@@ -1309,6 +1342,190 @@ TEST_F(DocDBTest, MultiOperationDocWriteBatch) {
       )#", dwb_str);
 }
 
+TEST_F(DocDBTest, IngestSstFile) {
+  // Add rows in reverse key order, the writer is expected to sort them.
+  DocSstFileWriter writer(options());
+  for (const auto& key_and_time : std::vector<std::pair<std::string, MicrosTime>>{
+      {"c", 2000}, {"b", 1000}}) {
+    const auto encoded_doc_key = DocKey(PrimitiveValues(key_and_time.first)).Encode();
+    auto dwb = MakeDocWriteBatch();
+    ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "x"), PrimitiveValue("v1")));
+    ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "w"), PrimitiveValue("v2")));
+    writer.Add(dwb, HybridTime::FromMicros(key_and_time.second));
+  }
+  ASSERT_EQ(4U, writer.num_entries());
+
+  const auto file_path = GetTestPath("ingested.sst");
+  ASSERT_OK(writer.Finish(file_path));
+  ASSERT_EQ(0U, writer.num_entries());
+  ASSERT_OK(rocksdb()->AddFile(file_path));
+
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["b"]), ["w"; HT{ physical: 1000 w: 1 }]) -> "v2"
+      SubDocKey(DocKey([], ["b"]), ["x"; HT{ physical: 1000 }]) -> "v1"
+      SubDocKey(DocKey([], ["c"]), ["w"; HT{ physical: 2000 w: 1 }]) -> "v2"
+      SubDocKey(DocKey([], ["c"]), ["x"; HT{ physical: 2000 }]) -> "v1"
+      )#");
+
+  // A file whose key range overlaps with the data is rejected.
+  const auto encoded_doc_key = DocKey(PrimitiveValues("b")).Encode();
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "a"), PrimitiveValue("v3")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key, "z"), PrimitiveValue("v4")));
+  writer.Add(dwb, HybridTime::FromMicros(3000));
+  const auto overlapping_file_path = GetTestPath("overlapping.sst");
+  ASSERT_OK(writer.Finish(overlapping_file_path));
+  ASSERT_NOK(rocksdb()->AddFile(overlapping_file_path));
+}
+
+namespace {
+
+// Operation that only locks the given doc path.
+class LockOnlyDocOperation : public DocOperation {
+ public:
+  explicit LockOnlyDocOperation(DocPath doc_path) : doc_path_(std::move(doc_path)) {}
+
+  bool RequireReadSnapshot() const override { return false; }
+
+  void GetDocPathsToLock(std::list<DocPath> *paths, IsolationLevel *level) const override {
+    paths->push_back(doc_path_);
+    *level = IsolationLevel::SNAPSHOT_ISOLATION;
+  }
+
+  CHECKED_STATUS Apply(const DocOperationApplyData& data) override { return Status::OK(); }
+
+ private:
+  DocPath doc_path_;
+};
+
+// Returns operations writing the given number of rows of the same hash partition.
+DocOperations RowsOfPartition(int num_rows) {
+  DocOperations result;
+  for (int i = 0; i != num_rows; ++i) {
+    const DocKey doc_key(0x1234, PrimitiveValues("h"), PrimitiveValues(i));
+    result.emplace_back(new LockOnlyDocOperation(
+        DocPath(doc_key.Encode(), PrimitiveValue(ColumnId(10)))));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_F(DocDBTest, PrefixLocks) {
+  google::FlagSaver flag_saver;
+  FLAGS_docdb_prefix_lock_min_keys = 4;
+  SharedLockManager lock_manager;
+  bool need_read_snapshot = false;
+
+  // Below the threshold every row and column is locked, along with a weak lock on the partition.
+  LockBatch small_batch;
+  PrepareDocWriteOperation(RowsOfPartition(3), nullptr /* write_lock_latency */,
+                           IsolationLevel::NON_TRANSACTIONAL, &lock_manager, &small_batch,
+                           &need_read_snapshot);
+  ASSERT_EQ(7, small_batch.size());
+  small_batch.Reset();
+
+  // A batch writing many rows of the partition only locks the partition.
+  LockBatch large_batch;
+  PrepareDocWriteOperation(RowsOfPartition(10), nullptr /* write_lock_latency */,
+                           IsolationLevel::NON_TRANSACTIONAL, &lock_manager, &large_batch,
+                           &need_read_snapshot);
+  ASSERT_EQ(1, large_batch.size());
+  large_batch.Reset();
+
+  FLAGS_docdb_prefix_lock_min_keys = 0;
+  PrepareDocWriteOperation(RowsOfPartition(10), nullptr /* write_lock_latency */,
+                           IsolationLevel::NON_TRANSACTIONAL, &lock_manager, &large_batch,
+                           &need_read_snapshot);
+  ASSERT_EQ(20, large_batch.size());
+}
+
+TEST_F(DocDBTest, GetSubDocuments) {
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue("a")), PrimitiveValue("v1"),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue("b")), PrimitiveValue("v2"),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue("a")), PrimitiveValue("v3"),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1), PrimitiveValue::kTombstone,
+                         HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue("c")), PrimitiveValue("v4"),
+                         HybridTime::FromMicros(3000)));
+
+  // Subdocuments are requested out of key order, and the row tombstone of the first document
+  // should hide its older columns.
+  const std::vector<SubDocKey> subdoc_keys = {
+      SubDocKey(kDocKey1, PrimitiveValue("c")),
+      SubDocKey(kDocKey2, PrimitiveValue("a")),
+      SubDocKey(kDocKey1, PrimitiveValue("a")),
+      SubDocKey(kDocKey1, PrimitiveValue("d")),
+      SubDocKey(kDocKey1, PrimitiveValue("b")) };
+  std::vector<SubDocument> docs(subdoc_keys.size());
+  bool docs_found[5];
+  std::vector<GetSubDocumentData> data;
+  for (size_t i = 0; i != subdoc_keys.size(); ++i) {
+    data.emplace_back(&subdoc_keys[i], &docs[i], &docs_found[i]);
+  }
+  ASSERT_OK(GetSubDocuments(
+      rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext));
+  ASSERT_TRUE(docs_found[0]);
+  ASSERT_EQ("v4", docs[0].GetString());
+  ASSERT_TRUE(docs_found[1]);
+  ASSERT_EQ("v3", docs[1].GetString());
+  ASSERT_FALSE(docs_found[2]);
+  ASSERT_FALSE(docs_found[3]);
+  ASSERT_FALSE(docs_found[4]);
+
+  // When all subdocuments belong to the same document, the bloom filter is used.
+  data.erase(data.begin() + 1);
+  ASSERT_OK(GetSubDocuments(
+      rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext));
+  ASSERT_TRUE(docs_found[0]);
+  ASSERT_EQ("v4", docs[0].GetString());
+  ASSERT_FALSE(docs_found[2]);
+}
+
+TEST_F(DocDBTest, FilesToDropExpiredData) {
+  // Creates file metadata for a file with a single column of the given document.
+  auto make_file = [](const std::string& doc_key_str, MicrosTime write_micros, MonoDelta ttl) {
+    auto file = std::make_unique<rocksdb::FileMetaData>();
+    const KeyBytes user_key = SubDocKey(DocKey(PrimitiveValues(doc_key_str)), PrimitiveValue("c"),
+                                        HybridTime::FromMicros(write_micros)).Encode();
+    const std::string value = Value(PrimitiveValue("v"), ttl).Encode();
+    for (auto* boundary : {&file->smallest, &file->largest}) {
+      CHECK_OK(DocBoundaryValuesExtractorInstance()->Extract(
+          user_key.AsSlice(), value, &boundary->user_values));
+      boundary->key = rocksdb::InternalKey(user_key.AsSlice(), 0, rocksdb::kTypeValue);
+    }
+    return file;
+  };
+
+  auto expired = make_file("a", 1000000, 1s);
+  auto newer_overlapping = make_file("a", 5000000, Value::kMaxTtl);
+  auto expired_hiding_older = make_file("b", 2000000, 1s);
+  auto older = make_file("b", 1000000, Value::kMaxTtl);
+  auto not_expired = make_file("d", 1000000, 20s);
+  const std::vector<rocksdb::FileMetaData*> files = {
+      expired.get(), newer_overlapping.get(), expired_hiding_older.get(), older.get(),
+      not_expired.get() };
+
+  DocDBCompactionFilterFactory factory(std::make_shared<FixedHybridTimeRetentionPolicy>(
+      HybridTime::FromMicros(10000000), Value::kMaxTtl));
+  google::FlagSaver flag_saver;
+  FLAGS_docdb_drop_expired_files = false;
+  ASSERT_TRUE(factory.FilesToDrop(files).empty());
+
+  FLAGS_docdb_drop_expired_files = true;
+  ASSERT_EQ(std::vector<rocksdb::FileMetaData*>{expired.get()}, factory.FilesToDrop(files));
+
+  // With a table TTL, files without their own TTL expire as well, but are only dropped when they
+  // don't hide older data.
+  DocDBCompactionFilterFactory table_ttl_factory(std::make_shared<FixedHybridTimeRetentionPolicy>(
+      HybridTime::FromMicros(10000000), 2s));
+  ASSERT_EQ((std::vector<rocksdb::FileMetaData*>{expired.get(), older.get()}),
+            table_ttl_factory.FilesToDrop(files));
+}
+
 class DocDBTestBoundaryValues: public DocDBTest {
  protected:
   void TestBoundaryValues(size_t flush_rate) {
@@ -31,6 +31,8 @@
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/internal_doc_iterator.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -62,6 +64,12 @@ using yb::util::FormatBytesAsStr;
 using yb::FormatRocksDBSliceAsStr;
 using strings::Substitute;
 
+DEFINE_int32(docdb_prefix_lock_min_keys, 16,
+             "Minimum number of keys of the same hash partition written by one batch for the batch "
+             "to lock the whole partition with a single prefix lock instead of locking every key. "
+             "When enabled, writes also take a weak lock on the partition of every key they write. "
+             "0 disables prefix locks. It should not be changed while writes are in progress.");
+
 
 namespace yb {
 namespace docdb {
@@ -101,6 +109,19 @@ void ApplyIntent(const string& lock_string,
   }
 }
 
+// Returns the size of the prefix of the encoded doc key that identifies its hash partition, i.e. the
+// hash and the hashed components, or 0 if there is no such prefix.
+size_t HashPartitionPrefixSize(const KeyBytes& encoded_doc_key) {
+  auto size = DocKey::EncodedSize(encoded_doc_key.AsSlice(), DocKeyPart::HASHED_PART_ONLY);
+  return size.ok() ? *size : 0;
+}
+
+// Intents on the hash partition prefix of the doc paths written by the batch.
+struct PrefixIntents {
+  size_t num_paths = 0;
+  IntentTypePair intent_types;
+};
+
 }  // namespace
 
 const SubDocKeyBound& SubDocKeyBound::Empty() {
@@ -121,6 +142,8 @@ void PrepareDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_
                               bool *need_read_snapshot) {
   KeyToIntentTypeMap key_to_lock_type;
   *need_read_snapshot = false;
+  std::vector<std::pair<list<DocPath>, IntentTypePair>> doc_paths_and_intent_types;
+  doc_paths_and_intent_types.reserve(doc_write_ops.size());
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
     list<DocPath> doc_paths;
     IsolationLevel level;
@@ -128,19 +151,66 @@ void PrepareDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_
     if (isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
       level = isolation_level;
     }
-    const IntentTypePair intent_types = GetWriteIntentsForIsolationLevel(level);
+    doc_paths_and_intent_types.emplace_back(
+        std::move(doc_paths), GetWriteIntentsForIsolationLevel(level));
+    if (doc_op->RequireReadSnapshot()) {
+      *need_read_snapshot = true;
+    }
+  }
+
+  // Every write of a key that belongs to a hash partition takes a weak intent on the partition
+  // prefix, so a batch writing many keys of the partition could instead take a single strong
+  // intent on the prefix, which covers all of them.
+  const size_t prefix_lock_min_keys = std::max(FLAGS_docdb_prefix_lock_min_keys, 0);
+  std::unordered_map<string, PrefixIntents> prefix_intents;
+  if (prefix_lock_min_keys != 0) {
+    for (const auto& doc_paths_and_intent_type : doc_paths_and_intent_types) {
+      const IntentTypePair& intent_types = doc_paths_and_intent_type.second;
+      for (const auto& doc_path : doc_paths_and_intent_type.first) {
+        const auto& encoded_doc_key = doc_path.encoded_doc_key();
+        const size_t prefix_size = HashPartitionPrefixSize(encoded_doc_key);
+        if (prefix_size == 0) {
+          continue;
+        }
+        auto& intents = prefix_intents[string(encoded_doc_key.data().data(), prefix_size)];
+        if (intents.num_paths++ == 0) {
+          intents.intent_types = intent_types;
+        } else {
+          intents.intent_types.strong = SharedLockManager::CombineIntents(
+              intents.intent_types.strong, intent_types.strong);
+          intents.intent_types.weak = SharedLockManager::CombineIntents(
+              intents.intent_types.weak, intent_types.weak);
+        }
+      }
+    }
+  }
 
-    for (const auto& doc_path : doc_paths) {
+  for (const auto& doc_paths_and_intent_type : doc_paths_and_intent_types) {
+    const IntentTypePair& intent_types = doc_paths_and_intent_type.second;
+    for (const auto& doc_path : doc_paths_and_intent_type.first) {
       KeyBytes current_prefix = doc_path.encoded_doc_key();
+      if (!prefix_intents.empty()) {
+        const size_t prefix_size = HashPartitionPrefixSize(current_prefix);
+        if (prefix_size != 0 &&
+            prefix_intents[string(current_prefix.data().data(), prefix_size)].num_paths >=
+                prefix_lock_min_keys) {
+          continue;
+        }
+      }
       for (int i = 0; i < doc_path.num_subkeys(); i++) {
         ApplyIntent(current_prefix.AsStringRef(), intent_types.weak, &key_to_lock_type);
         doc_path.subkey(i).AppendToKey(&current_prefix);
       }
       ApplyIntent(current_prefix.AsStringRef(), intent_types.strong, &key_to_lock_type);
     }
-    if (doc_op->RequireReadSnapshot()) {
-      *need_read_snapshot = true;
-    }
+  }
+
+  for (const auto& prefix_and_intents : prefix_intents) {
+    const PrefixIntents& intents = prefix_and_intents.second;
+    ApplyIntent(prefix_and_intents.first,
+                intents.num_paths >= prefix_lock_min_keys ? intents.intent_types.strong
+                                                          : intents.intent_types.weak,
+                &key_to_lock_type);
   }
   const MonoTime start_time = (write_lock_latency != nullptr) ? MonoTime::Now() : MonoTime();
   *keys_locked = LockBatch(lock_manager, std::move(key_to_lock_type));
@@ -179,7 +249,7 @@ void PrepareNonTransactionWriteBatch(
 
 #ifndef NDEBUG
     // Debug-only: ensure all keys we get in Raft replication can be decoded.
-    {
+    if (GetKeyType(kv_pair.key()) != KeyType::kRangeTombstone) {
       docdb::SubDocKey subdoc_key;
       Status s = subdoc_key.FullyDecodeFromKeyWithOptionalHybridTime(kv_pair.key());
       CHECK(s.ok())
@@ -200,9 +270,13 @@ void PrepareNonTransactionWriteBatch(
     // same key (row/column) within a transaction. We set it based on the position of the write
     // operation in its write batch.
 
+    //
+    // Pairs replicated from another cluster keep the hybrid time they were written with there.
+    const HybridTime pair_hybrid_time = kv_pair.has_external_hybrid_time()
+        ? HybridTime(kv_pair.external_hybrid_time()) : hybrid_time;
     std::array<Slice, 2> key_parts = {{
         Slice(kv_pair.key()),
-        doc_ht_buffer.EncodeWithValueType(hybrid_time, write_id),
+        doc_ht_buffer.EncodeWithValueType(pair_hybrid_time, write_id),
     }};
     Slice key_value = kv_pair.value();
     rocksdb_write_batch->Put(key_parts, { &key_value, 1 });
@@ -386,6 +460,12 @@ CHECKED_STATUS BuildSubDocument(
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
   const KeyBytes encoded_key = data.subdocument_key->Encode();
+  // All keys visited here belong to the same document, so the DocKey is taken from
+  // subdocument_key once, and only the subkeys and hybrid time of each found key are decoded.
+  auto doc_key_size = DocKey::EncodedSize(encoded_key.AsSlice(), DocKeyPart::WHOLE_DOC_KEY);
+  RETURN_NOT_OK(doc_key_size);
+  const Slice encoded_doc_key(encoded_key.data().data(), *doc_key_size);
+  SubDocKey found_key(data.subdocument_key->doc_key());
   while (iter->valid()) {
     // Since we modify num_values_observed on recursive calls, we keep a local copy of the value.
     int64 current_values_observed = *num_values_observed;
@@ -397,8 +477,7 @@ CHECKED_STATUS BuildSubDocument(
         << "iter: " << iter_key->ToDebugString()
         << ", key: " << encoded_key.ToString();
 
-    SubDocKey found_key;
-    RETURN_NOT_OK(found_key.FullyDecodeFrom(*iter_key));
+    RETURN_NOT_OK(found_key.FullyDecodeFromWithKnownDocKey(*iter_key, encoded_doc_key));
 
     rocksdb::Slice value = iter->value();
 
@@ -526,16 +605,16 @@ CHECKED_STATUS BuildSubDocument(
     }
 
     // For the purposes of comparison, we strip the found key until it matches the length of both
-    // the low and high subkeys for their respective calculations.
-    SubDocKey found_key_prefix_low = found_key;
-    SubDocKey found_key_prefix_high = found_key;
-    found_key_prefix_low.KeepPrefix(data.low_subkey->num_subkeys());
-    found_key_prefix_high.KeepPrefix(data.high_subkey->num_subkeys());
-
-    if (data.low_subkey->IsValid() && !data.low_subkey->CanInclude(found_key_prefix_low)) {
-      // The value provided is lower than what we are looking for, seek to the lower bound.
-      SeekToLowerBound(*data.low_subkey, iter);
-      continue;
+    // the low and high subkeys for their respective calculations. The prefixes are only built when
+    // the corresponding bound is set, to avoid copying the key for every child of a plain read.
+    if (data.low_subkey->IsValid()) {
+      SubDocKey found_key_prefix_low = found_key;
+      found_key_prefix_low.KeepPrefix(data.low_subkey->num_subkeys());
+      if (!data.low_subkey->CanInclude(found_key_prefix_low)) {
+        // The value provided is lower than what we are looking for, seek to the lower bound.
+        SeekToLowerBound(*data.low_subkey, iter);
+        continue;
+      }
     }
 
     // We use num_values_observed as a conservative figure for lower bound and
@@ -544,12 +623,20 @@ CHECKED_STATUS BuildSubDocument(
       continue;
     }
 
-    if ((data.high_subkey->IsValid() && !data.high_subkey->CanInclude(found_key_prefix_high)) ||
-        !data.high_index->CanInclude(current_values_observed)) {
+    if (!data.high_index->CanInclude(current_values_observed)) {
       // We have encountered a subkey higher than our constraints, we should stop here.
       return Status::OK();
     }
 
+    if (data.high_subkey->IsValid()) {
+      SubDocKey found_key_prefix_high = found_key;
+      found_key_prefix_high.KeepPrefix(data.high_subkey->num_subkeys());
+      if (!data.high_subkey->CanInclude(found_key_prefix_high)) {
+        // We have encountered a subkey higher than our constraints, we should stop here.
+        return Status::OK();
+      }
+    }
+
     if (!IsObjectType(data.result->value_type())) {
       *data.result = SubDocument();
     }
@@ -559,7 +646,7 @@ CHECKED_STATUS BuildSubDocument(
     for (int i = data.subdocument_key->num_subkeys(); i < found_key.num_subkeys() - 1; i++) {
       current = current->GetOrAddChild(found_key.subkeys()[i]).first;
     }
-    current->SetChild(found_key.subkeys().back(), SubDocument(descendant));
+    current->SetChild(found_key.subkeys().back(), std::move(descendant));
   }
 
   return Status::OK();
@@ -580,6 +667,43 @@ yb::Status GetSubDocument(
   return GetSubDocument(iter.get(), data, nullptr /* projection */, false /* is_iter_valid */);
 }
 
+yb::Status GetSubDocuments(
+    rocksdb::DB *db,
+    const vector<GetSubDocumentData>& data,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& txn_op_context,
+    const ReadHybridTime& read_time) {
+  if (data.empty()) {
+    return Status::OK();
+  }
+  vector<std::pair<KeyBytes, const GetSubDocumentData*>> sorted_data;
+  sorted_data.reserve(data.size());
+  for (const auto& entry : data) {
+    sorted_data.emplace_back(entry.subdocument_key->Encode(false /* include_hybrid_time */),
+                             &entry);
+  }
+  std::sort(sorted_data.begin(), sorted_data.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first.CompareTo(rhs.first) < 0;
+  });
+
+  const DocKey& doc_key = data.front().subdocument_key->doc_key();
+  const bool same_document = std::all_of(
+      data.begin(), data.end(), [&doc_key](const GetSubDocumentData& entry) {
+    return entry.subdocument_key->doc_key() == doc_key;
+  });
+  const auto doc_key_encoded = doc_key.Encode();
+  auto iter = CreateIntentAwareIterator(
+      db, same_document ? BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER,
+      doc_key_encoded.AsSlice(), query_id, txn_op_context, read_time);
+  for (const auto& entry : sorted_data) {
+    // Ancestors of a subdocument are checked before its own entries, and the iterator could
+    // already be past them after the previous subdocument, so every lookup starts with a seek.
+    RETURN_NOT_OK(GetSubDocument(
+        iter.get(), *entry.second, nullptr /* projection */, false /* is_iter_valid */));
+  }
+  return Status::OK();
+}
+
 yb::Status GetSubDocument(
     IntentAwareIterator *db_iter,
     const GetSubDocumentData& data,
@@ -597,7 +721,7 @@ yb::Status GetSubDocument(
   *data.doc_found = false;
   DOCDB_DEBUG_LOG("GetSubDocument for key $0 @ $1", data.subdocument_key->ToString(),
                   db_iter->read_time().ToString());
-  DocHybridTime max_deleted_ts(DocHybridTime::kMin);
+  DocHybridTime max_deleted_ts(data.deleted_ht);
 
   VLOG(4) << "GetSubDocument(" << data.subdocument_key->ToString() << ")";
 
@@ -646,6 +770,8 @@ yb::Status GetSubDocument(
       RETURN_NOT_OK(data.result->ConvertToRedisTS());
     } else if (*data.doc_found && doc_value.value_type() == ValueType::kRedisSortedSet) {
       RETURN_NOT_OK(data.result->ConvertToRedisSortedSet());
+    } else if (*data.doc_found && doc_value.value_type() == ValueType::kRedisString) {
+      RETURN_NOT_OK(data.result->ConvertToRedisString());
     }
     // TODO: Also could handle lists here.
 
@@ -653,6 +779,15 @@ yb::Status GetSubDocument(
   }
   // For each subkey in the projection, build subdocument.
   *data.result = SubDocument();
+  // Values of the columns packed by the last INSERT of the row, and the time of that INSERT. The
+  // packed row column goes before all the regular columns in the projection, so these are known
+  // before any of the regular columns is built.
+  PackedColumns packed_columns;
+  auto next_packed_column = packed_columns.end();
+  DocHybridTime packed_row_ts(DocHybridTime::kMin);
+  PrimitiveValue packed_row_attributes;
+  const PrimitiveValue packed_row_column =
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kPackedRowColumn);
   for (const PrimitiveValue& subkey : *projection) {
     SubDocKey projection_subdockey = *data.subdocument_key;
     projection_subdockey.AppendSubKeysAndMaybeHybridTime(subkey);
@@ -660,13 +795,56 @@ yb::Status GetSubDocument(
     auto encoded_projection_subdockey =
         projection_subdockey.Encode(/* include_hybrid_time */ false);
     IntentAwareIteratorPrefixScope prefix_scope(encoded_projection_subdockey, db_iter);
-    db_iter->SeekForwardWithoutHt(encoded_projection_subdockey);
+
+    const bool is_packed_row_column = subkey == packed_row_column;
+    DocHybridTime low_ts = max_deleted_ts;
+    const PrimitiveValue* packed_value = nullptr;
+    if (is_packed_row_column) {
+      RETURN_NOT_OK(db_iter->FindLastWriteTime(
+          encoded_projection_subdockey, &packed_row_ts, nullptr));
+    } else if (subkey.value_type() == ValueType::kColumnId && packed_row_ts > max_deleted_ts) {
+      // A packed row covers all the columns of the row, so any older write of a column has been
+      // overwritten by it, even if the packed row itself has expired since.
+      low_ts = packed_row_ts;
+      while (next_packed_column != packed_columns.end() &&
+             next_packed_column->first < subkey.GetColumnId()) {
+        ++next_packed_column;
+      }
+      if (next_packed_column != packed_columns.end() &&
+          next_packed_column->first == subkey.GetColumnId()) {
+        // The packed value is used unless the column was written again after the packed row.
+        DocHybridTime column_ts = packed_row_ts;
+        RETURN_NOT_OK(db_iter->FindLastWriteTime(
+            encoded_projection_subdockey, &column_ts, nullptr));
+        if (column_ts == packed_row_ts) {
+          packed_value = &next_packed_column->second;
+        }
+      }
+    }
 
     SubDocument descendant(ValueType::kInvalidValueType);
-    int64 num_values_observed = 0;
-    RETURN_NOT_OK(BuildSubDocument(
-        db_iter, data.Adjusted(&projection_subdockey, &descendant),
-        max_deleted_ts, &num_values_observed));
+    if (packed_value != nullptr) {
+      if (packed_value->value_type() != ValueType::kTombstone) {
+        descendant = SubDocument(*packed_value);
+        descendant.SetTtl(packed_row_attributes.GetTtl());
+        descendant.SetWritetime(packed_row_attributes.GetWriteTime());
+      }
+    } else {
+      db_iter->SeekForwardWithoutHt(encoded_projection_subdockey);
+      int64 num_values_observed = 0;
+      RETURN_NOT_OK(BuildSubDocument(
+          db_iter, data.Adjusted(&projection_subdockey, &descendant),
+          low_ts, &num_values_observed));
+    }
+    if (is_packed_row_column && descendant.value_type() == ValueType::kPackedRow) {
+      RETURN_NOT_OK(DecodePackedRow(descendant.GetPackedRow(), &packed_columns));
+      next_packed_column = packed_columns.begin();
+      // Only the TTL and write time of the packed row are kept in the result, the packed values
+      // are returned as the regular columns.
+      packed_row_attributes.SetTtl(descendant.GetTtl());
+      packed_row_attributes.SetWritetime(descendant.GetWriteTime());
+      descendant = SubDocument(packed_row_attributes);
+    }
     if (descendant.value_type() != ValueType::kInvalidValueType) {
       *data.doc_found = true;
     }
@@ -714,6 +892,13 @@ Result<std::string> DocDBKeyToDebugStr(Slice key_slice, KeyType* key_type) {
       RETURN_NOT_OK(transaction_id);
       return Format("TXN META $0", *transaction_id);
     }
+    case KeyType::kRangeTombstone:
+    {
+      RangeTombstone tombstone;
+      RETURN_NOT_OK(DecodeRangeTombstone(key_slice, Slice(), &tombstone));
+      return Format("RANGE TOMBSTONE $0 $1", FormatRocksDBSliceAsStr(tombstone.start),
+                    tombstone.doc_ht);
+    }
     case KeyType::kEmpty: FALLTHROUGH_INTENDED;
     case KeyType::kValueKey:
       RETURN_NOT_OK_PREPEND(
@@ -759,6 +944,8 @@ Result<std::string> DocDBValueToDebugStr(
       KeyType ignore_key_type;
       return DocDBKeyToDebugStr(value, &ignore_key_type);
     }
+    case KeyType::kRangeTombstone:
+      return Format("END $0", FormatRocksDBSliceAsStr(value));
     case KeyType::kEmpty: FALLTHROUGH_INTENDED;
     case KeyType::kIntentKey: FALLTHROUGH_INTENDED;
     case KeyType::kValueKey:
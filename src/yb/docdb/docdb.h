@@ -98,6 +98,10 @@ namespace docdb {
 // for unlocking)
 // TODO(akashnil): If a.b is exclusive, we don't need to lock any sub-paths under it.
 //
+// Keys of a hash partition also take a weak lock on its prefix, i.e. the hash and the hashed
+// components of the doc key. When the operations write at least --docdb_prefix_lock_min_keys keys
+// of the same hash partition, a single strong lock on the prefix is taken instead of locking them.
+//
 // Input: doc_write_ops
 // Context: lock_manager
 // Outputs: write_batch, need_read_snapshot
@@ -274,6 +278,9 @@ struct GetSubDocumentData {
   // Represent bounds on the first and last ranks to be considered.
   const IndexBound* low_index = &IndexBound::Empty();
   const IndexBound* high_index = &IndexBound::Empty();
+  // Entries written before this time are treated as deleted, e.g. when the document is covered by
+  // a range tombstone.
+  DocHybridTime deleted_ht = DocHybridTime::kMin;
 
   GetSubDocumentData Adjusted(
       const SubDocKey* subdoc_key, SubDocument* result_, bool* doc_found_ = nullptr) const {
@@ -284,6 +291,7 @@ struct GetSubDocumentData {
     result.high_subkey = high_subkey;
     result.low_index = low_index;
     result.high_index = high_index;
+    result.deleted_ht = deleted_ht;
     return result;
   }
 
@@ -330,6 +338,17 @@ yb::Status GetSubDocument(
     const TransactionOperationContextOpt& txn_op_context,
     const ReadHybridTime& read_time = ReadHybridTime::Max());
 
+// Batched version of the above GetSubDocument, that looks up several subdocuments using a single
+// iterator. The subdocuments are looked up in the order of their keys, so the iterator only moves
+// forward and reuses the data blocks it has already read. The bloom filter is used only when all
+// the subdocuments belong to the same document, e.g. for Redis HMGET.
+yb::Status GetSubDocuments(
+    rocksdb::DB* db,
+    const std::vector<GetSubDocumentData>& data,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& txn_op_context,
+    const ReadHybridTime& read_time = ReadHybridTime::Max());
+
 YB_STRONGLY_TYPED_BOOL(IncludeBinary);
 
 // Create a debug dump of the document database. Tries to decode all keys/values despite failures.
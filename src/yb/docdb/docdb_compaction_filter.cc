@@ -13,17 +13,23 @@
 
 #include "yb/docdb/docdb_compaction_filter.h"
 
+#include <algorithm>
 #include <memory>
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/db/version_edit.h"
 #include "yb/rocksdb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/value.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
 
 using std::shared_ptr;
 using std::unique_ptr;
@@ -31,21 +37,75 @@ using std::unordered_set;
 using rocksdb::CompactionFilter;
 using rocksdb::VectorToString;
 
+DEFINE_bool(docdb_drop_expired_files, false,
+            "Whether to delete SST files whose data has entirely expired by TTL before the history "
+            "cutoff without compacting them.");
+
+DEFINE_int32(docdb_compaction_time_window_secs, 0,
+             "Length of the hybrid time windows that SST files are grouped into by the largest "
+             "hybrid time of their entries. Files of different windows are never compacted "
+             "together, and each closed window is compacted into a single file. Every window "
+             "counts toward the level 0 slowdown and stop triggers. 0 to disable.");
+TAG_FLAG(docdb_compaction_time_window_secs, advanced);
+
+DEFINE_bool(docdb_filter_memtable_flushes, true,
+            "Whether to drop the entries overwritten or deleted at or before the history cutoff "
+            "within the flushed memtables, instead of writing them to disk for compactions to "
+            "drop.");
+TAG_FLAG(docdb_filter_memtable_flushes, runtime);
+
 namespace yb {
 namespace docdb {
 
+Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
+
+MicrosTime MaxExpirationMicros(const rocksdb::UserBoundaryValues& values, MonoDelta table_ttl);
+
+namespace {
+
+// Returns the encoded DocKey of the given file boundary key. Returns an empty slice if the key
+// does not start with a DocKey, e.g. for intents.
+Slice BoundaryDocKey(const rocksdb::InternalKey& key) {
+  const Slice user_key = key.user_key();
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return Slice();
+  }
+  return Slice(user_key.data(), *doc_key_size);
+}
+
+// Returns true if any document could have keys in both files. A DocDB entry also covers entries
+// with longer keys of the same document, e.g. a row tombstone covers its columns, so file key
+// ranges are compared by DocKey.
+bool MayHaveCommonDocuments(const rocksdb::FileMetaData& lhs, const rocksdb::FileMetaData& rhs) {
+  const Slice lhs_smallest = BoundaryDocKey(lhs.smallest.key);
+  const Slice lhs_largest = BoundaryDocKey(lhs.largest.key);
+  const Slice rhs_smallest = BoundaryDocKey(rhs.smallest.key);
+  const Slice rhs_largest = BoundaryDocKey(rhs.largest.key);
+  if (lhs_largest.empty() || rhs_largest.empty()) {
+    return true;
+  }
+  return lhs_smallest.compare(rhs_largest) <= 0 && rhs_smallest.compare(lhs_largest) <= 0;
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_full_compaction,
-                                             MonoDelta table_ttl)
+                                             MonoDelta table_ttl,
+                                             RangeTombstonesPtr range_tombstones,
+                                             bool is_flush)
     : history_cutoff_(history_cutoff),
       is_full_compaction_(is_full_compaction),
+      is_flush_(is_flush),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
-      deleted_cols_(deleted_cols) {
+      deleted_cols_(deleted_cols),
+      range_tombstones_(std::move(range_tombstones)) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -56,9 +116,9 @@ bool DocDBCompactionFilter::Filter(int level,
                                    const rocksdb::Slice& existing_value,
                                    std::string* new_value,
                                    bool* value_changed) const {
-  if (!is_full_compaction_) {
+  if (!is_full_compaction_ && !is_flush_) {
     // By default, we only perform history garbage collection on full compactions
-    // (or major compactions, in the HBase terminology).
+    // (or major compactions, in the HBase terminology), and on memtable flushes.
     //
     // TODO: Enable history garbage collection on minor (non-full) compactions as well.
     //       This should be similar to the existing workflow, but should be extensively tested.
@@ -67,12 +127,25 @@ bool DocDBCompactionFilter::Filter(int level,
     return false;
   }
 
-  if (!filter_usage_logged_) {
+  if (!filter_usage_logged_ && !is_flush_) {
     // TODO: switch this to VLOG if it becomes too chatty.
     LOG(INFO) << "DocDB compaction filter is being used";
     filter_usage_logged_ = true;
   }
 
+  if (GetKeyType(key) == KeyType::kRangeTombstone) {
+    // A full compaction drops every entry covered by a range tombstone below the history cutoff,
+    // no matter which subcompaction it falls into, so the tombstone is not needed afterwards.
+    DocHybridTime doc_ht;
+    CHECK_OK(doc_ht.DecodeFromEnd(key));
+    return range_tombstones_ != nullptr && doc_ht.hybrid_time() <= history_cutoff_;
+  }
+
+  if (GetKeyType(key) != KeyType::kValueKey) {
+    // Intents and transaction metadata are cleaned up by the transaction participant.
+    return false;
+  }
+
   SubDocKey subdoc_key;
 
   // TODO: Find a better way for handling of data corruption encountered during compactions.
@@ -87,6 +160,16 @@ bool DocDBCompactionFilter::Filter(int level,
     is_first_key_value_ = false;
   }
 
+  if (range_tombstones_) {
+    auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    CHECK_OK(doc_key_size);
+    const Slice doc_key(key.data(), *doc_key_size);
+    if (subdoc_key.doc_hybrid_time() < range_tombstones_->DeletedAt(doc_key, history_cutoff_)) {
+      // The overwrite stack is left as is, any later entry this one would hide is covered too.
+      return true;
+    }
+  }
+
   const size_t num_shared_components = prev_subdoc_key_.NumSharedPrefixComponents(subdoc_key);
 
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
@@ -224,10 +307,78 @@ DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
 
 unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilter(
     const CompactionFilter::Context& context) {
+  const HybridTime history_cutoff = retention_policy_->GetHistoryCutoff();
+  RangeTombstonesPtr range_tombstones;
+  if (context.is_full_compaction) {
+    auto result = retention_policy_->GetRangeTombstones(history_cutoff);
+    if (result.ok()) {
+      range_tombstones = std::move(*result);
+    } else {
+      LOG(WARNING) << "Failed to read range tombstones, keeping them and the data they cover: "
+                   << result.status();
+    }
+  }
   return unique_ptr<DocDBCompactionFilter>(
-      new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
+      new DocDBCompactionFilter(history_cutoff,
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction, retention_policy_->GetTableTTL(),
+                                std::move(range_tombstones), context.is_flush));
+}
+
+std::vector<rocksdb::FileMetaData*> DocDBCompactionFilterFactory::FilesToDrop(
+    const std::vector<rocksdb::FileMetaData*>& files) {
+  std::vector<rocksdb::FileMetaData*> result;
+  if (!FLAGS_docdb_drop_expired_files) {
+    return result;
+  }
+  const HybridTime history_cutoff = retention_policy_->GetHistoryCutoff();
+  const MonoDelta table_ttl = retention_policy_->GetTableTTL();
+  for (auto* file : files) {
+    if (MaxExpirationMicros(file->largest.user_values, table_ttl) >=
+            history_cutoff.GetPhysicalValueMicros()) {
+      continue;
+    }
+    DocHybridTime largest_doc_ht;
+    if (!GetDocHybridTime(file->largest.user_values, &largest_doc_ht).ok()) {
+      continue;
+    }
+    // Expired entries still hide older versions of the same keys, which should not reappear.
+    const bool hides_older_data = std::any_of(
+        files.begin(), files.end(), [file, &largest_doc_ht](rocksdb::FileMetaData* other) {
+      if (other == file || !MayHaveCommonDocuments(*file, *other)) {
+        return false;
+      }
+      DocHybridTime smallest_doc_ht;
+      return !GetDocHybridTime(other->smallest.user_values, &smallest_doc_ht).ok() ||
+             smallest_doc_ht <= largest_doc_ht;
+    });
+    if (!hides_older_data) {
+      result.push_back(file);
+    }
+  }
+  return result;
+}
+
+int64_t DocDBCompactionFilterFactory::TimeWindow(const rocksdb::FileMetaData& file) {
+  const int64_t window_secs = FLAGS_docdb_compaction_time_window_secs;
+  DocHybridTime largest_doc_ht;
+  if (window_secs <= 0 || !GetDocHybridTime(file.largest.user_values, &largest_doc_ht).ok()) {
+    return kNoTimeWindow;
+  }
+  return largest_doc_ht.hybrid_time().GetPhysicalValueMicros() /
+         (window_secs * MonoTime::kMicrosecondsPerSecond);
+}
+
+rocksdb::Slice DocDBCompactionFilterFactory::SubcompactionBoundary(const rocksdb::Slice& user_key) {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return user_key;
+  }
+  return rocksdb::Slice(user_key.data(), *doc_key_size);
+}
+
+bool DocDBCompactionFilterFactory::FilterFlushes() const {
+  return GetAtomicFlag(&FLAGS_docdb_filter_memtable_flushes);
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
@@ -23,6 +23,7 @@
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/range_tombstone.h"
 
 namespace yb {
 namespace docdb {
@@ -32,7 +33,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_full_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        RangeTombstonesPtr range_tombstones = nullptr,
+                        bool is_flush = false);
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -51,6 +54,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const HybridTime history_cutoff_;
   const bool is_full_compaction_;
 
+  // Flushes drop the entries overwritten at or before the history cutoff within the flushed
+  // memtables, and keep the tombstones, the same way minor compactions would.
+  const bool is_flush_;
+
   mutable bool is_first_key_value_;
   mutable SubDocKey prev_subdoc_key_;
 
@@ -100,6 +107,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
 
   ColumnIdsPtr deleted_cols_;
+
+  // Range tombstones at or below the history cutoff. The entries they cover are dropped along with
+  // the tombstones themselves, which are only kept when they could not be read.
+  RangeTombstonesPtr range_tombstones_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -110,6 +121,8 @@ class HistoryRetentionPolicy {
   virtual HybridTime GetHistoryCutoff() = 0;
   virtual ColumnIdsPtr GetDeletedColumns() = 0;
   virtual MonoDelta GetTableTTL() = 0;
+  // Range tombstones written at or before the given history cutoff.
+  virtual Result<RangeTombstonesPtr> GetRangeTombstones(HybridTime history_cutoff) = 0;
 };
 
 // A history retention policy that always returns the same hybrid_time. Useful in tests. This class
@@ -131,10 +144,18 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
   MonoDelta GetTableTTL() override { return table_ttl_; }
   void SetTableTTLForTests(MonoDelta ttl) {  table_ttl_ = ttl; }
 
+  Result<RangeTombstonesPtr> GetRangeTombstones(HybridTime history_cutoff) override {
+    return range_tombstones_;
+  }
+  void SetRangeTombstonesForTests(RangeTombstonesPtr range_tombstones) {
+    range_tombstones_ = std::move(range_tombstones);
+  }
+
  private:
   std::atomic<HybridTime> history_cutoff_;
   ColumnIds deleted_cols_;
   MonoDelta table_ttl_;
+  RangeTombstonesPtr range_tombstones_;
 };
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
@@ -143,6 +164,24 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
+
+  // Returns files whose entries have all expired before the history cutoff, when no other file
+  // could contain older versions of their keys that the expired entries still hide.
+  std::vector<rocksdb::FileMetaData*> FilesToDrop(
+      const std::vector<rocksdb::FileMetaData*>& files) override;
+
+  // Files are grouped into windows of --docdb_compaction_time_window_secs by the largest hybrid
+  // time of their entries.
+  int64_t TimeWindow(const rocksdb::FileMetaData& file) override;
+
+  // Subcompactions start at document boundaries, since the filter tracks overwrites of a whole
+  // document.
+  rocksdb::Slice SubcompactionBoundary(const rocksdb::Slice& user_key) override;
+
+  // Obsolete versions are dropped before they are written to disk, see
+  // --docdb_filter_memtable_flushes.
+  bool FilterFlushes() const override;
+
   const char* Name() const override;
 
  private:
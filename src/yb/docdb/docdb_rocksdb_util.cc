@@ -13,17 +13,22 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "yb/common/transaction.h"
 
+#include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table.h"
 
+#include "yb/docdb/docdb_table_properties_collector.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/cpu_affinity.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
@@ -50,10 +55,22 @@ DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
              "Use to control write rate of flush and compaction.");
+DEFINE_string(rocksdb_compact_flush_rate_limit_sharing_mode, "tserver",
+              "How the rocksdb_compact_flush_rate_limit_bytes_per_sec limit is shared: tserver - "
+              "by the flushes and compactions of all tablets of a tablet server, which also share "
+              "its background thread pools, none - each tablet is limited separately.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_double(rocksdb_garbage_compaction_ratio, 0.5,
+              "Compact an SST file with the older ones when tombstones and entries shadowed within "
+              "the file make up at least this fraction of its entries. 0 to disable.");
+DEFINE_uint64(rocksdb_garbage_compaction_min_entries, 10000,
+              "Minimum number of entries in an SST file to compact it for its garbage.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of threads a single compaction is split into, by key ranges aligned "
+             "to documents. Each of them writes its own output files. 1 - no splitting.");
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -70,8 +87,45 @@ DEFINE_int64(db_min_keys_per_index_block, 100,
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
 
+DEFINE_uint64(db_iterator_max_readahead_size_bytes, 1_MB,
+              "Maximal number of bytes an iterator prefetches ahead of the data blocks it reads "
+              "sequentially from an SST file. 0 - rely on the readahead of the OS.");
+
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Whether the writers of a RocksDB write group insert their batches into the memtable "
+            "in parallel after their sequence numbers are assigned.");
+DEFINE_bool(rocksdb_use_document_memtable, false,
+            "Whether the memtable keeps the entries of each document in a skip list of its own, "
+            "found by the hash of the encoded document key.");
+DEFINE_int32(rocksdb_document_memtable_bucket_count, 64 * 1024,
+             "Number of hash buckets of the document memtable.");
+DEFINE_bool(rocksdb_use_direct_reads, false,
+            "Whether SST files are read with O_DIRECT, bypassing the OS page cache.");
+DEFINE_bool(rocksdb_use_direct_io_for_flush_and_compaction, false,
+            "Whether flushes and compactions read and write SST files with O_DIRECT, so that "
+            "background I/O does not evict the pages of foreground reads from the OS page cache.");
+DEFINE_bool(rocksdb_use_mmap_reads, false,
+            "Whether SST files are memory-mapped for reads. The data blocks of uncompressed SST "
+            "files are then served from the mapping, without copying them into the block cache. "
+            "Meant for read-mostly data that fits in the OS page cache, and not supported together "
+            "with rocksdb_use_direct_reads or rocksdb_use_direct_io_for_flush_and_compaction.");
+DEFINE_bool(rocksdb_skip_stats_update_on_db_open, true,
+            "Whether opening a tablet skips reading the table properties of its SST files to "
+            "initialize deletion statistics. When skipped, SST files are only opened on first "
+            "access, so tablets that are not read from do not open their files on startup.");
+DEFINE_bool(rocksdb_numa_local_memtables, false,
+            "Whether the memtables of a tablet prefer the memory of the NUMA node its prepare "
+            "thread is pinned to by --pin_prepare_threads_to_numa_nodes.");
+TAG_FLAG(rocksdb_numa_local_memtables, advanced);
+TAG_FLAG(rocksdb_numa_local_memtables, experimental);
+
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_bool(use_docdb_split_block_bloom_filter, false,
+            "Whether new bloom filters of the DocDbAwareFilterPolicy set all bits of a key within "
+            "one cache line, so that a lookup checks them at once. Files with either kind of "
+            "filter can be read regardless of this flag.");
+TAG_FLAG(use_docdb_split_block_bloom_filter, advanced);
 DEFINE_int32(max_nexts_to_avoid_seek, 8,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
@@ -79,6 +133,16 @@ DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the do
 // supports multi-level index). Also update other places in tests where it is set to true
 // explicitly.
 DEFINE_bool(use_multi_level_index, false, "Whether to use multi-level data index.");
+DEFINE_bool(db_pin_top_level_index, true,
+            "Whether to keep the top level of multi-level data index of each SST file in memory, "
+            "and load only its lower levels through the block cache.");
+DEFINE_bool(db_cache_index_and_filter_blocks_with_high_priority, true,
+            "Whether to put data index and bloom filter blocks into the multi-touch part of the "
+            "block cache right away, so that scans do not evict them.");
+// Data written with this option could not be read by older versions.
+DEFINE_bool(use_docdb_hybrid_time_delta_encoding, false,
+            "Whether to store the hybrid time of a RocksDB data block key as a delta from the hybrid "
+            "time of the previous key, when the keys only differ in it.");
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
@@ -301,6 +365,7 @@ rocksdb::ReadOptions PrepareReadOptions(
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  read_opts.max_readahead_size = FLAGS_db_iterator_max_readahead_size_bytes;
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
@@ -349,9 +414,29 @@ void InitRocksDBOptions(
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
+  options->table_cache = tablet_options.table_cache;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
+  // Both the default skip list memtable and the document one support concurrent inserts.
+  // Followers spin briefly waiting for the leader to hand them their sequence numbers instead of
+  // blocking right away.
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  if (FLAGS_rocksdb_use_document_memtable) {
+    options->memtable_factory.reset(rocksdb::NewDocumentSkipListRepFactory(
+        std::make_shared<DocKeySliceTransform>(), FLAGS_rocksdb_document_memtable_bucket_count));
+  }
+  // DocDB writes deletes as regular values, so the deletion counts that compensate file sizes
+  // for compactions are close to zero anyway and are not worth opening every file for.
+  options->skip_stats_update_on_db_open = FLAGS_rocksdb_skip_stats_update_on_db_open;
+  if (FLAGS_rocksdb_numa_local_memtables) {
+    options->memtable_numa_node = NumaNodeForKey(tablet_id).id;
+  }
+  options->use_direct_reads = FLAGS_rocksdb_use_direct_reads;
+  options->use_direct_io_for_flush_and_compaction =
+      FLAGS_rocksdb_use_direct_io_for_flush_and_compaction;
+  options->allow_mmap_reads = FLAGS_rocksdb_use_mmap_reads;
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
       tablet_options.listeners.end()); // Append listeners
@@ -362,19 +447,46 @@ void InitRocksDBOptions(
     table_options.block_cache = tablet_options.block_cache;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_top_level_index = FLAGS_db_pin_top_level_index;
+    table_options.cache_index_and_filter_blocks_with_high_priority =
+        FLAGS_db_cache_index_and_filter_blocks_with_high_priority;
+    switch (tablet_options.cache_priority) {
+      case NORMAL_CACHE_PRIORITY:
+        table_options.cache_priority = rocksdb::BlockBasedTableOptions::CachePriority::kNormal;
+        break;
+      case HIGH_CACHE_PRIORITY:
+        table_options.cache_priority = rocksdb::BlockBasedTableOptions::CachePriority::kHigh;
+        // Keep the top level of the index with the table reader, so lookups into a hot table
+        // need at most the lower index levels from the cache.
+        table_options.pin_top_level_index = true;
+        break;
+      case LOW_CACHE_PRIORITY:
+        table_options.cache_priority = rocksdb::BlockBasedTableOptions::CachePriority::kLow;
+        break;
+    }
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
   }
+  if (tablet_options.in_memory) {
+    // The whole SST files stay with their table readers, so reads into them never look up the
+    // block cache, and scans over other tables can't evict them.
+    table_options.pin_data_blocks = true;
+    table_options.cache_index_and_filter_blocks = false;
+  }
+  // Reads with fill_cache unset, such as large scans, are not admitted to either tier.
+  table_options.block_cache_compressed = tablet_options.compressed_block_cache;
   table_options.block_size = FLAGS_db_block_size_bytes;
   table_options.filter_block_size = FLAGS_db_filter_block_size_bytes;
   table_options.index_block_size = FLAGS_db_index_block_size_bytes;
   table_options.min_keys_per_index_block = FLAGS_db_min_keys_per_index_block;
+  table_options.use_hybrid_time_delta_encoding = FLAGS_use_docdb_hybrid_time_delta_encoding;
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(),
+        FLAGS_use_docdb_split_block_bloom_filter));
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -411,7 +523,16 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
+    if (FLAGS_rocksdb_garbage_compaction_ratio > 0) {
+      options->table_properties_collector_factories.push_back(
+          std::make_shared<DocDBTablePropertiesCollectorFactory>(
+              FLAGS_rocksdb_garbage_compaction_ratio,
+              FLAGS_rocksdb_garbage_compaction_min_entries));
+    }
+    if (tablet_options.rate_limiter) {
+      options->rate_limiter = tablet_options.rate_limiter;
+    } else if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
     }
@@ -423,5 +544,19 @@ void InitRocksDBOptions(
   }
 }
 
+std::shared_ptr<rocksdb::RateLimiter> CreateSharedRocksDBRateLimiter() {
+  if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+  if (FLAGS_rocksdb_compact_flush_rate_limit_sharing_mode == "none") {
+    return nullptr;
+  }
+  LOG_IF(DFATAL, FLAGS_rocksdb_compact_flush_rate_limit_sharing_mode != "tserver")
+      << "Unknown rocksdb_compact_flush_rate_limit_sharing_mode: "
+      << FLAGS_rocksdb_compact_flush_rate_limit_sharing_mode;
+  return std::shared_ptr<rocksdb::RateLimiter>(
+      rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+}
+
 }  // namespace docdb
 }  // namespace yb
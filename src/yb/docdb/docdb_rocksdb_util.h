@@ -125,6 +125,10 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Creates the rate limiter of flushes and compactions to be shared by all tablets of a tablet
+// server. Returns nullptr if the writes are not limited, or limited for each tablet separately.
+std::shared_ptr<rocksdb::RateLimiter> CreateSharedRocksDBRateLimiter();
+
 }  // namespace docdb
 }  // namespace yb
 
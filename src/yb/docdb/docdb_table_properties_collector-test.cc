@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/schema.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_table_properties_collector.h"
+#include "yb/docdb/value.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class DocDBTablePropertiesCollectorTest : public YBTest {
+ protected:
+  void AddEntries(DocDBTablePropertiesCollector* collector) {
+    const DocKey row1(PrimitiveValues("row1"));
+    const DocKey row2(PrimitiveValues("row2"));
+    const std::string tombstone = Value(PrimitiveValue::kTombstone).Encode();
+    const std::string value = Value(PrimitiveValue(1)).Encode();
+    // The delete of row1 shadows its older columns, older versions of a column are shadowed too.
+    const std::vector<std::pair<SubDocKey, const std::string*>> entries = {
+      { SubDocKey(row1, HybridTime::FromMicros(30)), &tombstone },
+      { SubDocKey(row1, PrimitiveValue(10_ColId), HybridTime::FromMicros(40)), &value },
+      { SubDocKey(row1, PrimitiveValue(20_ColId), HybridTime::FromMicros(20)), &value },
+      { SubDocKey(row1, PrimitiveValue(20_ColId), HybridTime::FromMicros(10)), &value },
+      { SubDocKey(row2, PrimitiveValue(10_ColId), HybridTime::FromMicros(20)), &value },
+      { SubDocKey(row2, PrimitiveValue(10_ColId), HybridTime::FromMicros(10)), &value },
+    };
+    rocksdb::SequenceNumber seq = 1;
+    for (const auto& entry : entries) {
+      ASSERT_OK(collector->AddUserKey(entry.first.Encode().AsSlice(), *entry.second,
+                                      rocksdb::kEntryPut, seq++, 0 /* file_size */));
+    }
+  }
+};
+
+TEST_F(DocDBTablePropertiesCollectorTest, CountsGarbage) {
+  DocDBTablePropertiesCollector collector(0.5 /* garbage_ratio */, 0 /* min_entries */);
+  AddEntries(&collector);
+  ASSERT_TRUE(collector.NeedCompact());
+  auto readable = collector.GetReadableProperties();
+  ASSERT_EQ("6", readable[kNumEntriesProperty]);
+  ASSERT_EQ("1", readable[kNumTombstonesProperty]);
+  ASSERT_EQ("3", readable[kNumObsoleteVersionsProperty]);
+  rocksdb::UserCollectedProperties properties;
+  ASSERT_OK(collector.Finish(&properties));
+  ASSERT_EQ(3, properties.size());
+}
+
+TEST_F(DocDBTablePropertiesCollectorTest, Thresholds) {
+  {
+    DocDBTablePropertiesCollector collector(0.9 /* garbage_ratio */, 0 /* min_entries */);
+    AddEntries(&collector);
+    ASSERT_FALSE(collector.NeedCompact());
+  }
+  {
+    DocDBTablePropertiesCollector collector(0.5 /* garbage_ratio */, 10 /* min_entries */);
+    AddEntries(&collector);
+    ASSERT_FALSE(collector.NeedCompact());
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,108 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/docdb_table_properties_collector.h"
+
+#include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_type.h"
+#include "yb/rocksdb/util/coding.h"
+
+namespace yb {
+namespace docdb {
+
+const char* const kNumEntriesProperty = "yb.docdb.num.entries";
+const char* const kNumTombstonesProperty = "yb.docdb.num.tombstones";
+const char* const kNumObsoleteVersionsProperty = "yb.docdb.num.obsolete.versions";
+
+rocksdb::Status DocDBTablePropertiesCollector::AddUserKey(
+    const Slice& key, const Slice& value, rocksdb::EntryType type, rocksdb::SequenceNumber seq,
+    uint64_t file_size) {
+  ++num_entries_;
+  if (type == rocksdb::kEntryDelete || type == rocksdb::kEntrySingleDelete) {
+    // E.g. the intents of applied transactions.
+    ++num_tombstones_;
+    return Status::OK();
+  }
+  switch (GetKeyType(key)) {
+    case KeyType::kRangeTombstone:
+      ++num_tombstones_;
+      return Status::OK();
+    case KeyType::kValueKey:
+      break;
+    default:
+      return Status::OK();
+  }
+
+  // Keys that could not be decoded are just not counted as garbage, the compaction filter is the
+  // one to report them.
+  int encoded_ht_size = 0;
+  if (!DocHybridTime::CheckAndGetEncodedSize(key, &encoded_ht_size).ok() ||
+      key.size() <= static_cast<size_t>(encoded_ht_size)) {
+    return Status::OK();
+  }
+  DocHybridTime doc_ht;
+  if (!doc_ht.FullyDecodeFrom(Slice(key.end() - encoded_ht_size, encoded_ht_size)).ok()) {
+    return Status::OK();
+  }
+  const Slice key_without_ht(key.data(), key.size() - encoded_ht_size - 1);
+
+  // Versions of the same key are ordered from the latest one, and subdocuments follow their
+  // parents.
+  const bool shadowed = key_without_ht == prev_key_ ||
+      (!tombstone_key_.empty() && key_without_ht.starts_with(tombstone_key_) &&
+       doc_ht < tombstone_ht_);
+  prev_key_.assign(key_without_ht.cdata(), key_without_ht.size());
+  if (shadowed) {
+    ++num_obsolete_versions_;
+    return Status::OK();
+  }
+
+  ValueType value_type;
+  if (Value::DecodePrimitiveValueType(value, &value_type).ok() &&
+      value_type == ValueType::kTombstone) {
+    ++num_tombstones_;
+    tombstone_key_ = prev_key_;
+    tombstone_ht_ = doc_ht;
+  }
+  return Status::OK();
+}
+
+rocksdb::Status DocDBTablePropertiesCollector::Finish(
+    rocksdb::UserCollectedProperties* properties) {
+  std::string* value = &(*properties)[kNumEntriesProperty];
+  rocksdb::PutVarint64(value, num_entries_);
+  value = &(*properties)[kNumTombstonesProperty];
+  rocksdb::PutVarint64(value, num_tombstones_);
+  value = &(*properties)[kNumObsoleteVersionsProperty];
+  rocksdb::PutVarint64(value, num_obsolete_versions_);
+  return Status::OK();
+}
+
+rocksdb::UserCollectedProperties DocDBTablePropertiesCollector::GetReadableProperties() const {
+  return {
+    { kNumEntriesProperty, std::to_string(num_entries_) },
+    { kNumTombstonesProperty, std::to_string(num_tombstones_) },
+    { kNumObsoleteVersionsProperty, std::to_string(num_obsolete_versions_) },
+  };
+}
+
+bool DocDBTablePropertiesCollector::NeedCompact() const {
+  if (garbage_ratio_ <= 0 || num_entries_ == 0 || num_entries_ < min_entries_) {
+    return false;
+  }
+  return num_tombstones_ + num_obsolete_versions_ >= garbage_ratio_ * num_entries_;
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOCDB_TABLE_PROPERTIES_COLLECTOR_H_
+#define YB_DOCDB_DOCDB_TABLE_PROPERTIES_COLLECTOR_H_
+
+#include <string>
+
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/rocksdb/table_properties.h"
+
+namespace yb {
+namespace docdb {
+
+// Names of the user collected properties of SST files written by DocDB, varint64 encoded.
+extern const char* const kNumEntriesProperty;
+extern const char* const kNumTombstonesProperty;
+extern const char* const kNumObsoleteVersionsProperty;
+
+// Counts the garbage in an SST file: DocDB and RocksDB tombstones, and the entries that are
+// shadowed by a later entry of the same file, i.e. older versions of the same key and entries of
+// a subdocument deleted later. Marks the file for compaction when the garbage makes up at least
+// garbage_ratio of its entries, so that tablets with a lot of deletes and overwrites do not keep
+// scanning through them until the next compaction picked by file sizes.
+class DocDBTablePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  DocDBTablePropertiesCollector(double garbage_ratio, uint64_t min_entries)
+      : garbage_ratio_(garbage_ratio), min_entries_(min_entries) {}
+
+  rocksdb::Status AddUserKey(const Slice& key, const Slice& value, rocksdb::EntryType type,
+                             rocksdb::SequenceNumber seq, uint64_t file_size) override;
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties) override;
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override;
+
+  const char* Name() const override { return "DocDBTablePropertiesCollector"; }
+
+  bool NeedCompact() const override;
+
+ private:
+  const double garbage_ratio_;
+  const uint64_t min_entries_;
+
+  uint64_t num_entries_ = 0;
+  uint64_t num_tombstones_ = 0;
+  uint64_t num_obsolete_versions_ = 0;
+
+  // The previous value key without its hybrid time.
+  std::string prev_key_;
+  // The latest DocDB tombstone that was not shadowed itself, without its hybrid time.
+  std::string tombstone_key_;
+  DocHybridTime tombstone_ht_;
+};
+
+class DocDBTablePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  DocDBTablePropertiesCollectorFactory(double garbage_ratio, uint64_t min_entries)
+      : garbage_ratio_(garbage_ratio), min_entries_(min_entries) {}
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override {
+    return new DocDBTablePropertiesCollector(garbage_ratio_, min_entries_);
+  }
+
+  const char* Name() const override { return "DocDBTablePropertiesCollector"; }
+
+ private:
+  const double garbage_ratio_;
+  const uint64_t min_entries_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_DOCDB_TABLE_PROPERTIES_COLLECTOR_H_
@@ -14,11 +14,13 @@
 #include <memory>
 #include <string>
 
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/range_tombstone.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -888,5 +890,190 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorNextRowBatch) {
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row2_e"), HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  std::vector<QLTableRow> rows;
+  size_t num_rows = 0;
+  QLValue value;
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init());
+
+    ASSERT_OK(iter.NextRowBatch(projection, 10, &rows, &num_rows));
+    ASSERT_EQ(2, num_rows);
+
+    ASSERT_OK(rows[0].GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("row1_c", value.string_value());
+    ASSERT_OK(rows[0].GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(10000, value.int64_value());
+    ASSERT_OK(rows[0].GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    ASSERT_OK(rows[1].GetValue(projection.column_id(0), &value));
+    ASSERT_TRUE(value.IsNull());
+    ASSERT_OK(rows[1].GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(20000, value.int64_value());
+    ASSERT_OK(rows[1].GetValue(projection.column_id(2), &value));
+    ASSERT_EQ("row2_e", value.string_value());
+
+    ASSERT_OK(iter.NextRowBatch(projection, 10, &rows, &num_rows));
+    ASSERT_EQ(0, num_rows);
+    ASSERT_FALSE(iter.HasNext());
+  }
+
+  // A batch smaller than the number of rows leaves the iterator positioned at the next row, and
+  // the reused row from the previous batch does not keep stale column values.
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init());
+
+    ASSERT_OK(iter.NextRowBatch(projection, 1, &rows, &num_rows));
+    ASSERT_EQ(1, num_rows);
+    ASSERT_OK(rows[0].GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("row1_c", value.string_value());
+
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextRowBatch(projection, 1, &rows, &num_rows));
+    ASSERT_EQ(1, num_rows);
+    ASSERT_OK(rows[0].GetValue(projection.column_id(0), &value));
+    ASSERT_TRUE(value.IsNull());
+    ASSERT_OK(rows[0].GetValue(projection.column_id(2), &value));
+    ASSERT_EQ("row2_e", value.string_value());
+
+    ASSERT_FALSE(iter.HasNext());
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorReverseScan) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  for (const auto& encoded_doc_key : {kEncodedDocKey1, kEncodedDocKey2, encoded_doc_key3}) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  }
+  // Older versions and values written after the read time are stepped over as well.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c_t1"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c_t2"), HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c_t4"), HybridTime::FromMicros(4000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  DocQLScanSpec spec(schema, -1, -1, {} /* hashed_components */, nullptr /* req */,
+                     rocksdb::kDefaultQueryId, false /* is_forward_scan */);
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, rocksdb(),
+      ReadHybridTime::FromMicros(3000));
+  ASSERT_OK(iter.Init(spec));
+
+  QLTableRow row;
+  QLValue value;
+  for (const auto* expected_c : {"", "row2_c_t2", ""}) {
+    ASSERT_TRUE(iter.HasNext());
+    row.Clear();
+    ASSERT_OK(iter.NextRow(projection, &row));
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(10000, value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    if (*expected_c) {
+      ASSERT_EQ(expected_c, value.string_value());
+    } else {
+      ASSERT_TRUE(value.IsNull());
+    }
+  }
+  ASSERT_FALSE(iter.HasNext());
+}
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorRangeTombstone) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  for (const auto& encoded_doc_key : {kEncodedDocKey1, kEncodedDocKey2, encoded_doc_key3}) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  }
+
+  // Delete row1 and row2 with a single range tombstone, then write row2 again.
+  {
+    auto dwb = MakeDocWriteBatch();
+    dwb.DeleteRange(kEncodedDocKey1.AsSlice(), encoded_doc_key3.AsSlice());
+    ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(2000), false /* decode_dockey */));
+  }
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(3000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  auto check_rows = [&](HybridTime read_ht, const std::vector<std::string>& expected_rows) {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        ReadHybridTime::SingleTime(read_ht));
+    ASSERT_OK(iter.Init());
+    QLTableRow row;
+    QLValue value;
+    for (const auto& expected_row : expected_rows) {
+      ASSERT_TRUE(iter.HasNext());
+      row.Clear();
+      ASSERT_OK(iter.NextRow(projection, &row));
+      ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+      // Only the column written after the range tombstone is left of row2.
+      if (expected_row == "row2") {
+        ASSERT_EQ("row2_c", value.string_value());
+        ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+        ASSERT_TRUE(value.IsNull());
+      } else {
+        ASSERT_TRUE(value.IsNull());
+        ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+        ASSERT_EQ(10000, value.int64_value());
+      }
+    }
+    ASSERT_FALSE(iter.HasNext());
+  };
+
+  check_rows(HybridTime::FromMicros(1500), {"row1", "old_row2", "row3"});
+  check_rows(HybridTime::FromMicros(2500), {"row3"});
+  check_rows(HybridTime::FromMicros(3500), {"row2", "row3"});
+
+  // Full compactions drop the covered entries along with the range tombstone.
+  auto range_tombstones = ReadRangeTombstones(rocksdb(), HybridTime::kMax);
+  ASSERT_OK(range_tombstones);
+  ASSERT_NE(nullptr, *range_tombstones);
+  retention_policy_->SetRangeTombstonesForTests(*range_tombstones);
+  CompactHistoryBefore(HybridTime::FromMicros(4000));
+  retention_policy_->SetRangeTombstonesForTests(nullptr);
+  check_rows(HybridTime::FromMicros(4500), {"row2", "row3"});
+  range_tombstones = ReadRangeTombstones(rocksdb(), HybridTime::kMax);
+  ASSERT_OK(range_tombstones);
+  ASSERT_EQ(nullptr, *range_tombstones);
+  ASSERT_DOCDB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(30); HT{ physical: 3000 }]) -> "row2_c"
+      SubDocKey(DocKey([], ["row3", 33333]), [ColumnId(40); HT{ physical: 1000 }]) -> 10000
+      )#");
+}
+
 }  // namespace docdb
 }  // namespace yb
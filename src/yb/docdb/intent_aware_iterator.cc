@@ -50,6 +50,11 @@ KeyBytes GetIntentPrefixForKey(const SubDocKey& subdoc_key) {
   return GetIntentPrefixForKeyWithoutHt(subdoc_key.Encode(false /* include_hybrid_time */));
 }
 
+// Range tombstones precede all the documents, so moving backward could reach them.
+bool IsRangeTombstone(const Slice& key) {
+  return !key.empty() && DecodeValueType(key) == ValueType::kRangeTombstonePrefix;
+}
+
 } // namespace
 
 // For locally committed transactions returns commit time if committed at specified time or
@@ -218,6 +223,15 @@ IntentAwareIterator::IntentAwareIterator(
                                                 docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                 boost::none,
                                                 rocksdb::kDefaultQueryId);
+    // The iterator only sees the intents that existed when it was created. When there were none,
+    // e.g. because all transactions of the tablet have been applied, the intent iterator is not
+    // needed, and reads do not pay for seeking it along with the regular iterator.
+    const char intent_prefix_byte = static_cast<char>(ValueType::kIntentPrefix);
+    const Slice intent_prefix(&intent_prefix_byte, 1);
+    ROCKSDB_SEEK(intent_iter_.get(), intent_prefix);
+    if (!intent_iter_->Valid() || !intent_iter_->key().starts_with(intent_prefix)) {
+      intent_iter_.reset();
+    }
   }
   iter_.reset(rocksdb->NewIterator(read_opts));
 }
@@ -307,6 +321,10 @@ void IntentAwareIterator::SeekToLastDocKey() {
   if (!iter_->Valid()) {
     return;
   }
+  if (IsRangeTombstone(iter_->key())) {
+    iter_valid_ = false;
+    return;
+  }
   // Seek to the first rocksdb kv-pair for this row.
   rocksdb::Slice rocksdb_key(iter_->key());
   DocKey doc_key;
@@ -319,16 +337,24 @@ void IntentAwareIterator::SeekToLastDocKey() {
 }
 
 void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
-  Seek(doc_key);
   if (!status_.ok()) {
     return;
   }
-  if (!iter_->Valid()) {
-    SeekToLastDocKey();
-    return;
+  const KeyBytes encoded_doc_key = doc_key.Encode();
+  // Intents are not taken into account when moving backward, see SeekToLastDocKey, so stepping
+  // back is only safe on the regular iterator alone.
+  if (intent_iter_ || !StepBackBefore(encoded_doc_key.AsSlice())) {
+    SeekWithoutHt(encoded_doc_key);
+    if (!status_.ok()) {
+      return;
+    }
+    if (!iter_->Valid()) {
+      SeekToLastDocKey();
+      return;
+    }
+    iter_->Prev();
   }
-  iter_->Prev();
-  if (!iter_->Valid()) {
+  if (!iter_->Valid() || IsRangeTombstone(iter_->key())) {
     iter_valid_ = false; // TODO(dtxn) support reverse scan with read restart
     return;
   }
@@ -341,6 +367,24 @@ void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
   Seek(prev_key);
 }
 
+bool IntentAwareIterator::StepBackBefore(const Slice& encoded_doc_key) {
+  // A row is a handful of entries, one per column and version, so stepping back over it saves a
+  // seek of every memtable and SST file. Rows with more entries are skipped with a seek.
+  constexpr int kMaxSteps = 32;
+  if (!iter_->Valid()) {
+    iter_->SeekToLast();
+  } else if (iter_->key().compare(encoded_doc_key) < 0) {
+    return false;
+  }
+  for (int steps = 0; iter_->Valid() && iter_->key().compare(encoded_doc_key) >= 0; ++steps) {
+    if (steps == kMaxSteps) {
+      return false;
+    }
+    iter_->Prev();
+  }
+  return true;
+}
+
 bool IntentAwareIterator::valid() {
   return !status_.ok() || iter_valid_ || resolved_intent_state_ == ResolvedIntentState::kValid;
 }
@@ -107,7 +107,8 @@ class IntentAwareIterator {
   void SeekToLastDocKey();
 
   // This method positions the iterator at the beginning of the DocKey found before the doc_key
-  // provided
+  // provided. Reverse scans call it right after reading doc_key, so it is cheapest when the
+  // iterator is positioned at or after doc_key.
   void PrevDocKey(const DocKey& doc_key);
 
   // Adds new value to prefix stack. The top value of this stack is used to filter
@@ -141,6 +142,12 @@ class IntentAwareIterator {
       Value* result_value);
 
  private:
+  // Positions the regular iterator at the last entry before encoded_doc_key by stepping back from
+  // its current position, instead of seeking to encoded_doc_key first. Returns false, leaving the
+  // iterator anywhere, when the iterator is before encoded_doc_key or there are too many entries
+  // to step over.
+  bool StepBackBefore(const Slice& encoded_doc_key);
+
   // Seek forward on regular sub-iterator.
   void SeekForwardRegular(const Slice& slice, const Slice& prefix = Slice());
 
@@ -104,7 +104,7 @@ Status InternalDocIterator::SeekToKeyPrefix() {
 
   DOCDB_DEBUG_LOG("key_prefix=$0", BestEffortDocDBKeyToStr(key_prefix_));
   boost::optional<DocWriteBatchCache::Entry> cached_ht_and_type =
-      doc_write_batch_cache_->Get(KeyBytes(key_prefix_.AsStringRef()));
+      doc_write_batch_cache_->Get(key_prefix_.AsSlice());
   if (cached_ht_and_type) {
     subdoc_ht_ = cached_ht_and_type->doc_hybrid_time;
     subdoc_type_ = cached_ht_and_type->value_type;
@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+
+#include "yb/util/bytes_formatter.h"
+#include "yb/util/fast_varint.h"
+
+using yb::util::FastAppendSignedVarIntToStr;
+using yb::util::FastDecodeSignedVarInt;
+using yb::util::FormatSliceAsStr;
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+CHECKED_STATUS ConsumeVarInt(Slice* slice, int64_t* value) {
+  int decoded_size = 0;
+  RETURN_NOT_OK(FastDecodeSignedVarInt(slice->data(), slice->size(), value, &decoded_size));
+  slice->remove_prefix(decoded_size);
+  return Status::OK();
+}
+
+}  // namespace
+
+bool PackedRowEncoder::CanPack(const PrimitiveValue& value) {
+  // A null column value is written as a tombstone, which is packed as is.
+  return value.IsTombstoneOrPrimitive() && value.value_type() != ValueType::kPackedRow;
+}
+
+void PackedRowEncoder::AddColumn(ColumnId column_id, const PrimitiveValue& value) {
+  DCHECK(CanPack(value)) << value.ToString();
+  columns_.emplace_back(column_id, value.ToValue());
+}
+
+std::string PackedRowEncoder::Finish() {
+  // The same column could be set several times by one statement, the last value wins.
+  std::stable_sort(columns_.begin(), columns_.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  std::string result;
+  for (size_t i = 0; i != columns_.size(); ++i) {
+    if (i + 1 != columns_.size() && columns_[i].first == columns_[i + 1].first) {
+      continue;
+    }
+    FastAppendSignedVarIntToStr(columns_[i].first.rep(), &result);
+    FastAppendSignedVarIntToStr(columns_[i].second.size(), &result);
+    result.append(columns_[i].second);
+  }
+  columns_.clear();
+  return result;
+}
+
+Status DecodePackedRow(const Slice& encoded_row, PackedColumns* columns) {
+  columns->clear();
+  Slice slice = encoded_row;
+  while (!slice.empty()) {
+    int64_t column_id_as_int64 = 0;
+    int64_t value_size = 0;
+    RETURN_NOT_OK(ConsumeVarInt(&slice, &column_id_as_int64));
+    RETURN_NOT_OK(ConsumeVarInt(&slice, &value_size));
+    if (value_size < 0 || static_cast<size_t>(value_size) > slice.size()) {
+      return STATUS_FORMAT(Corruption, "Invalid size $0 of packed column $1, $2 bytes left",
+                           value_size, column_id_as_int64, slice.size());
+    }
+    ColumnId column_id;
+    RETURN_NOT_OK(ColumnId::FromInt64(column_id_as_int64, &column_id));
+    if (!columns->empty() && !(columns->back().first < column_id)) {
+      return STATUS_FORMAT(Corruption, "Packed columns out of order: $0 after $1",
+                           column_id, columns->back().first);
+    }
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(Slice(slice.data(), value_size)));
+    slice.remove_prefix(value_size);
+    columns->emplace_back(column_id, std::move(value));
+  }
+  return Status::OK();
+}
+
+std::string PackedRowToString(const Slice& encoded_row) {
+  PackedColumns columns;
+  Status s = DecodePackedRow(encoded_row, &columns);
+  if (!s.ok()) {
+    return "PackedRow(" + FormatSliceAsStr(encoded_row) + ")";
+  }
+  std::string result = "PackedRow(";
+  for (size_t i = 0; i != columns.size(); ++i) {
+    if (i != 0) {
+      result += ", ";
+    }
+    result += columns[i].first.ToString() + ": " + columns[i].second.ToString();
+  }
+  result += ")";
+  return result;
+}
+
+}  // namespace docdb
+}  // namespace yb
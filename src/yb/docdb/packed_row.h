@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H_
+#define YB_DOCDB_PACKED_ROW_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/schema.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// A packed row stores the values of all non-static columns written by a single QL INSERT as one
+// kPackedRow value of the row's packed row system column, instead of one RocksDB key per column.
+// The packed row is only written when the INSERT sets every such column to a scalar value, so it
+// overwrites all older writes of the columns of the row and also serves as its liveness column.
+//
+// The encoding is a sequence of entries sorted by column id, each of them consisting of:
+//   <column id as signed varint><value size as signed varint><value encoded with ToValue()>
+//
+// Every value is tagged with its column id, so a packed row remains readable after columns are
+// added to or dropped from the table schema.
+class PackedRowEncoder {
+ public:
+  // Returns true if the given column value can be stored in a packed row.
+  static bool CanPack(const PrimitiveValue& value);
+
+  void AddColumn(ColumnId column_id, const PrimitiveValue& value);
+
+  bool empty() const { return columns_.empty(); }
+
+  // Returns the encoded packed row. The encoder should not be used afterwards.
+  std::string Finish();
+
+ private:
+  std::vector<std::pair<ColumnId, std::string>> columns_;
+};
+
+// Column values decoded from a packed row, sorted by column id.
+typedef std::vector<std::pair<ColumnId, PrimitiveValue>> PackedColumns;
+
+CHECKED_STATUS DecodePackedRow(const Slice& encoded_row, PackedColumns* columns);
+
+std::string PackedRowToString(const Slice& encoded_row);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H_
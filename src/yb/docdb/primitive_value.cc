@@ -20,6 +20,7 @@
 #include "yb/docdb/doc_kv_util.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -47,11 +48,13 @@ using yb::util::FastDecodeSignedVarInt;
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED; \
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED; \
     case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED; \
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED; \
     case ValueType::kInvalidValueType: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisTS: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED; \
+    case ValueType::kRedisString: FALLTHROUGH_INTENDED; \
     case ValueType::kTtl: FALLTHROUGH_INTENDED; \
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED; \
     case ValueType::kTombstone: \
@@ -104,6 +107,8 @@ string PrimitiveValue::ToString() const {
     case ValueType::kStringDescending:
     case ValueType::kString:
       return FormatBytesAsStr(str_val_);
+    case ValueType::kPackedRow:
+      return PackedRowToString(str_val_);
     case ValueType::kInt32Descending: FALLTHROUGH_INTENDED;
     case ValueType::kInt32:
       return std::to_string(int32_val_);
@@ -179,6 +184,8 @@ string PrimitiveValue::ToString() const {
       return "<>";
     case ValueType::kRedisSortedSet:
       return "(->)";
+    case ValueType::kRedisString:
+      return "[\"\"]";
     case ValueType::kTombstone:
       return "DEL";
     case ValueType::kArray:
@@ -191,7 +198,8 @@ string PrimitiveValue::ToString() const {
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
-    case ValueType::kIntentPrefix:
+    case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kRangeTombstonePrefix:
       break;
     case ValueType::kLowest:
       return "-Inf";
@@ -225,6 +233,10 @@ void PrimitiveValue::AppendToKey(KeyBytes* key_bytes) const {
       key_bytes->AppendDescendingString(str_val_);
       return;
 
+    case ValueType::kPackedRow:
+      LOG(FATAL) << "Packed row cannot be used in a key";
+      return;
+
     case ValueType::kInt64:
       key_bytes->AppendInt64(int64_val_);
       return;
@@ -365,9 +377,11 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kArray: FALLTHROUGH_INTENDED;
     case ValueType::kRedisTS: FALLTHROUGH_INTENDED;
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisString: FALLTHROUGH_INTENDED;
     case ValueType::kRedisSet: return result;
 
     case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kString:
       // No zero encoding necessary when storing the string in a value.
       result.append(str_val_);
@@ -459,6 +473,7 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
     case ValueType::kColumnId: FALLTHROUGH_INTENDED;
@@ -803,6 +818,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       type_ref = value_type;
       return Status::OK();
     }
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kMaxByte:
       break;
 
@@ -841,6 +857,7 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED;
     case ValueType::kRedisTS: FALLTHROUGH_INTENDED;
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisString: FALLTHROUGH_INTENDED;
     case ValueType::kTombstone:
       type_ = value_type;
       complex_data_structure_ = nullptr;
@@ -876,6 +893,11 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
       type_ = ValueType::kString;
       return Status::OK();
 
+    case ValueType::kPackedRow:
+      new(&str_val_) string(slice.cdata(), slice.size());
+      type_ = ValueType::kPackedRow;
+      return Status::OK();
+
     case ValueType::kInt32: FALLTHROUGH_INTENDED;
     case ValueType::kInt32Descending: FALLTHROUGH_INTENDED;
     case ValueType::kFloatDescending: FALLTHROUGH_INTENDED;
@@ -959,6 +981,7 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED;
     case ValueType::kUInt16Hash: FALLTHROUGH_INTENDED;
     case ValueType::kInvalidValueType: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
@@ -1074,6 +1097,13 @@ PrimitiveValue PrimitiveValue::IntentTypeValue(IntentType intent_type) {
 }
 
 
+PrimitiveValue PrimitiveValue::PackedRow(std::string encoded_row) {
+  PrimitiveValue primitive_value;
+  primitive_value.type_ = ValueType::kPackedRow;
+  new(&primitive_value.str_val_) std::string(std::move(encoded_row));
+  return primitive_value;
+}
+
 KeyBytes PrimitiveValue::ToKeyBytes() const {
   KeyBytes kb;
   AppendToKey(&kb);
@@ -1097,6 +1127,7 @@ bool PrimitiveValue::operator==(const PrimitiveValue& other) const {
     case ValueType::kMaxByte: return true;
 
     case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kString: return str_val_ == other.str_val_;
 
     case ValueType::kFrozenDescending: FALLTHROUGH_INTENDED;
@@ -1165,6 +1196,7 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
       return 0;
     case ValueType::kStringDescending:
       return other.str_val_.compare(str_val_);
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kString:
       return str_val_.compare(other.str_val_);
     case ValueType::kInt64Descending:
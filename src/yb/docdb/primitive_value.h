@@ -40,7 +40,8 @@ namespace docdb {
 class SubDocument;
 
 enum class SystemColumnIds : ColumnIdRep {
-  kLivenessColumn = 0  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kLivenessColumn = 0,  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kPackedRowColumn = 1  // Stores the packed values of all columns of a QL row, see packed_row.h.
 };
 
 enum class SortOrder : int8_t {
@@ -60,7 +61,8 @@ class PrimitiveValue {
   explicit PrimitiveValue(ValueType value_type);
 
   PrimitiveValue(const PrimitiveValue& other) {
-    if (other.type_ == ValueType::kString || other.type_ == ValueType::kStringDescending) {
+    if (other.type_ == ValueType::kString || other.type_ == ValueType::kStringDescending ||
+        other.type_ == ValueType::kPackedRow) {
       type_ = other.type_;
       new(&str_val_) std::string(other.str_val_);
     } else if (other.type_ == ValueType::kInetaddress
@@ -199,7 +201,8 @@ class PrimitiveValue {
   std::string ToString() const;
 
   ~PrimitiveValue() {
-    if (type_ == ValueType::kString || type_ == ValueType::kStringDescending) {
+    if (type_ == ValueType::kString || type_ == ValueType::kStringDescending ||
+        type_ == ValueType::kPackedRow) {
       str_val_.~basic_string();
     } else if (type_ == ValueType::kInetaddress || type_ == ValueType::kInetaddressDescending) {
       delete inetaddress_val_;
@@ -235,6 +238,8 @@ class PrimitiveValue {
   static PrimitiveValue Int32(int32_t v, SortOrder sort_order = SortOrder::kAscending);
   static PrimitiveValue TransactionId(Uuid transaction_id);
   static PrimitiveValue IntentTypeValue(IntentType intent_type);
+  // Values of all columns of a QL row packed into a single value, see packed_row.h.
+  static PrimitiveValue PackedRow(std::string encoded_row);
 
   KeyBytes ToKeyBytes() const;
 
@@ -281,6 +286,11 @@ class PrimitiveValue {
     return str_val_;
   }
 
+  const std::string& GetPackedRow() const {
+    DCHECK(ValueType::kPackedRow == type_);
+    return str_val_;
+  }
+
   int32_t GetInt32() const {
     DCHECK(ValueType::kInt32 == type_ || ValueType::kInt32Descending == type_);
     return int32_val_;
@@ -413,7 +423,8 @@ class PrimitiveValue {
 
     ttl_seconds_ = other->ttl_seconds_;
     write_time_ = other->write_time_;
-    if (other->type_ == ValueType::kString || other->type_ == ValueType::kStringDescending) {
+    if (other->type_ == ValueType::kString || other->type_ == ValueType::kStringDescending ||
+        other->type_ == ValueType::kPackedRow) {
       type_ = other->type_;
       new(&str_val_) std::string(std::move(other->str_val_));
       // The moved-from object should now be in a "valid but unspecified" state as per the standard.
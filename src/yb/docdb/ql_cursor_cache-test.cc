@@ -0,0 +1,138 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/docdb/ql_cursor_cache.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+class FakeIterator : public common::QLRowwiseIteratorIf {
+ public:
+  explicit FakeIterator(int id) : id_(id) {}
+
+  int id() const { return id_; }
+
+  CHECKED_STATUS Init() override { return Status::OK(); }
+  CHECKED_STATUS Init(const common::QLScanSpec& spec) override { return Status::OK(); }
+  bool IsNextStaticColumn() const override { return false; }
+  bool HasNext() const override { return false; }
+  void SkipRow() override {}
+  CHECKED_STATUS SetPagingStateIfNecessary(const QLReadRequestPB& request,
+                                           QLResponsePB* response) const override {
+    return Status::OK();
+  }
+  HybridTime RestartReadHt() override { return HybridTime::kInvalid; }
+  std::string ToString() const override { return "FakeIterator"; }
+  const Schema& schema() const override { return schema_; }
+
+ private:
+  CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override {
+    return Status::OK();
+  }
+
+  const int id_;
+  Schema schema_;
+};
+
+QLReadRequestPB NewRequest(uint32_t hash_code) {
+  QLReadRequestPB request;
+  request.set_schema_version(1);
+  request.set_hash_code(hash_code);
+  request.set_limit(10);
+  request.set_return_paging_state(true);
+  return request;
+}
+
+QLResponsePB NewResponse(const std::string& next_row_key) {
+  QLResponsePB response;
+  response.mutable_paging_state()->set_next_row_key(next_row_key);
+  return response;
+}
+
+// The request of the page after the given response.
+QLReadRequestPB NextPage(QLReadRequestPB request, const QLResponsePB& response) {
+  request.set_request_id(request.request_id() + 1);
+  *request.mutable_paging_state() = response.paging_state();
+  return request;
+}
+
+int TakenId(QLCursorCache* cache, const QLReadRequestPB& request) {
+  auto iter = cache->Take(request);
+  return iter ? static_cast<FakeIterator*>(iter.get())->id() : -1;
+}
+
+} // namespace
+
+class QLCursorCacheTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_ql_paging_cursor_cache_size = 2;
+    FLAGS_ql_paging_cursor_ttl_ms = 60000;
+  }
+
+  QLCursorCache cache_;
+};
+
+TEST_F(QLCursorCacheTest, TestTakeNextPage) {
+  const auto request = NewRequest(1);
+  const auto response = NewResponse("key1");
+  cache_.Put(request, response, std::make_unique<FakeIterator>(1));
+  ASSERT_EQ(1, cache_.size());
+
+  // Another scan, or the same scan at another position, does not get the cursor.
+  ASSERT_EQ(-1, TakenId(&cache_, NextPage(NewRequest(2), response)));
+  ASSERT_EQ(-1, TakenId(&cache_, NextPage(request, NewResponse("key2"))));
+  ASSERT_EQ(-1, TakenId(&cache_, request));
+
+  ASSERT_EQ(1, TakenId(&cache_, NextPage(request, response)));
+  ASSERT_EQ(0, cache_.size());
+  ASSERT_EQ(-1, TakenId(&cache_, NextPage(request, response)));
+}
+
+TEST_F(QLCursorCacheTest, TestEviction) {
+  const auto request = NewRequest(1);
+  for (int i = 1; i <= 3; ++i) {
+    cache_.Put(request, NewResponse(Format("key$0", i)), std::make_unique<FakeIterator>(i));
+  }
+  // The oldest cursor is evicted past the size limit.
+  ASSERT_EQ(2, cache_.size());
+  ASSERT_EQ(-1, TakenId(&cache_, NextPage(request, NewResponse("key1"))));
+  ASSERT_EQ(3, TakenId(&cache_, NextPage(request, NewResponse("key3"))));
+
+  // As are expired ones.
+  FLAGS_ql_paging_cursor_ttl_ms = 0;
+  cache_.Put(request, NewResponse("key4"), std::make_unique<FakeIterator>(4));
+  ASSERT_EQ(-1, TakenId(&cache_, NextPage(request, NewResponse("key4"))));
+  ASSERT_EQ(1, cache_.size());
+  cache_.Clear();
+
+  // Nothing is kept while the cache is disabled, or without a paging state.
+  FLAGS_ql_paging_cursor_ttl_ms = 60000;
+  cache_.Put(request, QLResponsePB(), std::make_unique<FakeIterator>(5));
+  FLAGS_ql_paging_cursor_cache_size = 0;
+  cache_.Put(request, NewResponse("key6"), std::make_unique<FakeIterator>(6));
+  ASSERT_EQ(0, cache_.size());
+}
+
+}  // namespace docdb
+}  // namespace yb
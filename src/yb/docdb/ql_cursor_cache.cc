@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_cursor_cache.h"
+
+#include <algorithm>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(ql_paging_cursor_cache_size, 0,
+             "Maximum number of iterators of paged QL scans that a tablet keeps to continue the "
+             "scan with the next page. 0 disables the cache.");
+TAG_FLAG(ql_paging_cursor_cache_size, advanced);
+TAG_FLAG(ql_paging_cursor_cache_size, runtime);
+
+DEFINE_int32(ql_paging_cursor_ttl_ms, 10000,
+             "Time that the iterator of a paged QL scan is kept for the next page.");
+TAG_FLAG(ql_paging_cursor_ttl_ms, advanced);
+TAG_FLAG(ql_paging_cursor_ttl_ms, runtime);
+
+namespace yb {
+namespace docdb {
+
+std::string QLCursorCache::CursorKey(const QLReadRequestPB& request,
+                                     const std::string& next_row_key) {
+  QLReadRequestPB scan = request;
+  scan.clear_client();
+  scan.clear_request_id();
+  scan.clear_limit();
+  scan.clear_paging_state();
+  scan.clear_return_paging_state();
+  scan.clear_remote_endpoint();
+  scan.clear_query_id();
+
+  std::string result;
+  const uint32_t size = next_row_key.size();
+  result.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  result.append(next_row_key);
+  scan.AppendToString(&result);
+  return result;
+}
+
+std::unique_ptr<common::QLRowwiseIteratorIf> QLCursorCache::Take(const QLReadRequestPB& request) {
+  if (!request.has_paging_state() || !request.paging_state().has_next_row_key()) {
+    return nullptr;
+  }
+  const auto key = CursorKey(request, request.paging_state().next_row_key());
+
+  std::deque<Entry> evicted;
+  std::lock_guard<std::mutex> lock(mutex_);
+  EvictExpired(CoarseMonoClock::Now(), &evicted);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->key == key) {
+      auto result = std::move(it->iter);
+      entries_.erase(it);
+      return result;
+    }
+  }
+  return nullptr;
+}
+
+void QLCursorCache::Put(const QLReadRequestPB& request, const QLResponsePB& response,
+                        std::unique_ptr<common::QLRowwiseIteratorIf> iter) {
+  const size_t max_size = std::max(FLAGS_ql_paging_cursor_cache_size, 0);
+  if (max_size == 0 || !response.has_paging_state() ||
+      !response.paging_state().has_next_row_key()) {
+    return;
+  }
+  Entry entry;
+  entry.key = CursorKey(request, response.paging_state().next_row_key());
+  const auto now = CoarseMonoClock::Now();
+  entry.expiration = now + std::chrono::milliseconds(FLAGS_ql_paging_cursor_ttl_ms);
+  entry.iter = std::move(iter);
+
+  std::deque<Entry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EvictExpired(now, &evicted);
+    while (entries_.size() >= max_size) {
+      evicted.push_back(std::move(entries_.front()));
+      entries_.pop_front();
+    }
+    entries_.push_back(std::move(entry));
+  }
+}
+
+void QLCursorCache::Clear() {
+  std::deque<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+  }
+}
+
+size_t QLCursorCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void QLCursorCache::EvictExpired(CoarseMonoClock::TimePoint now, std::deque<Entry>* evicted) {
+  // The TTL is a runtime flag, so entries are not necessarily ordered by expiration.
+  auto it = entries_.begin();
+  while (it != entries_.end()) {
+    if (it->expiration <= now) {
+      evicted->push_back(std::move(*it));
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
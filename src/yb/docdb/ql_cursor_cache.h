@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_QL_CURSOR_CACHE_H
+#define YB_DOCDB_QL_CURSOR_CACHE_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/ql_rowwise_iterator_interface.h"
+
+#include "yb/util/monotime.h"
+
+DECLARE_int32(ql_paging_cursor_cache_size);
+DECLARE_int32(ql_paging_cursor_ttl_ms);
+
+namespace yb {
+namespace docdb {
+
+// Keeps the iterators of QL scans that stopped at a page boundary, so that the read of the next
+// page continues from where the previous one stopped instead of seeking to the paging state again.
+//
+// A cursor is found by the request of the next page: the same query with the paging state returned
+// by the previous page. Cursors are evicted once --ql_paging_cursor_ttl_ms passes, since an idle
+// iterator keeps the memtables and SST files that it reads from alive.
+class QLCursorCache {
+ public:
+  QLCursorCache() = default;
+  QLCursorCache(const QLCursorCache&) = delete;
+  void operator=(const QLCursorCache&) = delete;
+
+  // Removes and returns the iterator left by the read that returned the paging state of the
+  // request, or nullptr when there is none.
+  std::unique_ptr<common::QLRowwiseIteratorIf> Take(const QLReadRequestPB& request);
+
+  // Keeps the iterator of the request, positioned at the row of the paging state in the response.
+  // Does nothing when the response has no paging state or caching is disabled.
+  void Put(const QLReadRequestPB& request, const QLResponsePB& response,
+           std::unique_ptr<common::QLRowwiseIteratorIf> iter);
+
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    CoarseMonoClock::TimePoint expiration;
+    std::unique_ptr<common::QLRowwiseIteratorIf> iter;
+  };
+
+  // Identifies the scan of the request positioned at the given row key. Fields that change from
+  // page to page or don't affect the scan are not part of it.
+  static std::string CursorKey(const QLReadRequestPB& request, const std::string& next_row_key);
+
+  // Moves the expired entries to evicted, so that their iterators, which release RocksDB
+  // resources, are destroyed outside of the lock.
+  void EvictExpired(CoarseMonoClock::TimePoint now, std::deque<Entry>* evicted);
+
+  mutable std::mutex mutex_;
+  // Oldest first.
+  std::deque<Entry> entries_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_QL_CURSOR_CACHE_H
@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/docdb/ql_projection_cache.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+Schema NewSchema() {
+  return Schema({ ColumnSchema("h", INT32, false, true),
+                  ColumnSchema("r", INT32),
+                  ColumnSchema("s", INT32, true, false, true /* is_static */),
+                  ColumnSchema("v1", INT32, true),
+                  ColumnSchema("v2", STRING, true) },
+                { ColumnId(10), ColumnId(11), ColumnId(12), ColumnId(13), ColumnId(14) },
+                2);
+}
+
+QLReferencedColumnsPB NewColumnRefs(std::initializer_list<int32_t> ids,
+                                    std::initializer_list<int32_t> static_ids) {
+  QLReferencedColumnsPB column_refs;
+  for (int32_t id : ids) {
+    column_refs.add_ids(id);
+  }
+  for (int32_t id : static_ids) {
+    column_refs.add_static_ids(id);
+  }
+  return column_refs;
+}
+
+} // namespace
+
+class QLProjectionCacheTest : public YBTest {
+ protected:
+  const Schema schema_ = NewSchema();
+  QLProjectionCache cache_;
+};
+
+TEST_F(QLProjectionCacheTest, TestProjections) {
+  auto projections = cache_.Get(schema_, 0, NewColumnRefs({14, 10, 13}, {12}));
+  ASSERT_OK(projections);
+  // The static columns come first in the query schema, the key columns are not scanned.
+  ASSERT_EQ((std::vector<ColumnId>({ColumnId(12), ColumnId(14), ColumnId(10), ColumnId(13)})),
+            (**projections).query_schema.column_ids());
+  ASSERT_EQ(std::vector<ColumnId>({ColumnId(12)}),
+            (**projections).static_projection.column_ids());
+  ASSERT_EQ((std::vector<ColumnId>({ColumnId(13), ColumnId(14)})),
+            (**projections).non_static_projection.column_ids());
+}
+
+TEST_F(QLProjectionCacheTest, TestReuse) {
+  const auto column_refs = NewColumnRefs({10, 13}, {});
+  auto first = cache_.Get(schema_, 0, column_refs);
+  ASSERT_OK(first);
+  auto second = cache_.Get(schema_, 0, column_refs);
+  ASSERT_OK(second);
+  ASSERT_EQ(first->get(), second->get());
+  ASSERT_EQ(1, cache_.size());
+
+  // Other columns, or the same columns in another schema version, have their own projections.
+  auto other_columns = cache_.Get(schema_, 0, NewColumnRefs({10, 14}, {}));
+  ASSERT_OK(other_columns);
+  ASSERT_NE(first->get(), other_columns->get());
+  auto static_columns = cache_.Get(schema_, 0, NewColumnRefs({10}, {13}));
+  ASSERT_OK(static_columns);
+  ASSERT_NE(first->get(), static_columns->get());
+  auto other_version = cache_.Get(schema_, 1, column_refs);
+  ASSERT_OK(other_version);
+  ASSERT_NE(first->get(), other_version->get());
+  ASSERT_EQ(4, cache_.size());
+
+  cache_.Clear();
+  ASSERT_EQ(0, cache_.size());
+
+  // The cache does not grow past its limit.
+  const size_t kMaxSize = QLProjectionCache::kMaxSize;
+  for (uint32_t i = 0; i <= kMaxSize; ++i) {
+    ASSERT_OK(cache_.Get(schema_, i, column_refs));
+  }
+  ASSERT_LE(cache_.size(), kMaxSize);
+}
+
+}  // namespace docdb
+}  // namespace yb
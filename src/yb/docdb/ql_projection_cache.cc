@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_projection_cache.h"
+
+#include <set>
+#include <vector>
+
+namespace yb {
+namespace docdb {
+
+CHECKED_STATUS CreateProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
+                                 Schema* static_projection, Schema* non_static_projection) {
+  // The projection schemas are used to scan docdb. Keep the columns to fetch in sorted order for
+  // more efficient scan in the iterator.
+  std::set<ColumnId> static_columns, non_static_columns;
+
+  // Add regular columns.
+  for (int32_t id : column_refs.ids()) {
+    const ColumnId column_id(id);
+    if (!schema.is_key_column(column_id)) {
+      non_static_columns.insert(column_id);
+    }
+  }
+
+  // Add static columns.
+  for (int32_t id : column_refs.static_ids()) {
+    const ColumnId column_id(id);
+    static_columns.insert(column_id);
+  }
+
+  RETURN_NOT_OK(
+      schema.CreateProjectionByIdsIgnoreMissing(
+          std::vector<ColumnId>(static_columns.begin(), static_columns.end()),
+          static_projection));
+  RETURN_NOT_OK(
+      schema.CreateProjectionByIdsIgnoreMissing(
+          std::vector<ColumnId>(non_static_columns.begin(), non_static_columns.end()),
+          non_static_projection));
+
+  return Status::OK();
+}
+
+CHECKED_STATUS CreateQLProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
+                                   QLProjections* projections) {
+  std::vector<ColumnId> column_ids;
+  column_ids.reserve(column_refs.static_ids_size() + column_refs.ids_size());
+  for (int32_t id : column_refs.static_ids()) {
+    column_ids.emplace_back(id);
+  }
+  for (int32_t id : column_refs.ids()) {
+    column_ids.emplace_back(id);
+  }
+  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_ids, &projections->query_schema));
+  return CreateProjections(schema, column_refs, &projections->static_projection,
+                           &projections->non_static_projection);
+}
+
+std::string QLProjectionCache::ProjectionsKey(uint32_t schema_version,
+                                              const QLReferencedColumnsPB& column_refs) {
+  std::string result;
+  result.append(reinterpret_cast<const char*>(&schema_version), sizeof(schema_version));
+  const int32_t num_static_ids = column_refs.static_ids_size();
+  result.append(reinterpret_cast<const char*>(&num_static_ids), sizeof(num_static_ids));
+  for (int32_t id : column_refs.static_ids()) {
+    result.append(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+  for (int32_t id : column_refs.ids()) {
+    result.append(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+  return result;
+}
+
+Result<QLProjectionsPtr> QLProjectionCache::Get(const Schema& schema, uint32_t schema_version,
+                                                const QLReferencedColumnsPB& column_refs) {
+  auto key = ProjectionsKey(schema_version, column_refs);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = projections_.find(key);
+    if (it != projections_.end()) {
+      return it->second;
+    }
+  }
+
+  // Built outside of the lock, a concurrent read of the same shape could build them too.
+  auto projections = std::make_shared<QLProjections>();
+  RETURN_NOT_OK(CreateQLProjections(schema, column_refs, projections.get()));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (projections_.size() >= kMaxSize) {
+    projections_.clear();
+  }
+  projections_.emplace(std::move(key), projections);
+  return QLProjectionsPtr(std::move(projections));
+}
+
+void QLProjectionCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  projections_.clear();
+}
+
+size_t QLProjectionCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return projections_.size();
+}
+
+}  // namespace docdb
+}  // namespace yb
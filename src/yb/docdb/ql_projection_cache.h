@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_QL_PROJECTION_CACHE_H
+#define YB_DOCDB_QL_PROJECTION_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/schema.h"
+
+#include "yb/util/result.h"
+
+namespace yb {
+namespace docdb {
+
+// The projections of the table schema that a QL read with the given referenced columns works with.
+struct QLProjections {
+  // The referenced columns, static ones first.
+  Schema query_schema;
+  // The static and the non-key non-static columns, to scan DocDB with.
+  Schema static_projection;
+  Schema non_static_projection;
+};
+
+typedef std::shared_ptr<const QLProjections> QLProjectionsPtr;
+
+// Create projection schemas of static and non-static columns from a rowblock projection schema
+// (for read) and a WHERE / IF condition (for read / write). "schema" is the full table schema
+// and "rowblock_schema" is the selected columns from which we are splitting into static and
+// non-static column portions.
+CHECKED_STATUS CreateProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
+                                 Schema* static_projection, Schema* non_static_projection);
+
+CHECKED_STATUS CreateQLProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
+                                   QLProjections* projections);
+
+// Keeps the projections of the recent QL reads of a tablet, so that reads of the same shape, e.g.
+// the point reads of a prepared statement, don't build them from the schema again. Projections are
+// found by the schema version and the referenced columns. The owner clears the cache when the
+// schema changes.
+class QLProjectionCache {
+ public:
+  QLProjectionCache() = default;
+  QLProjectionCache(const QLProjectionCache&) = delete;
+  void operator=(const QLProjectionCache&) = delete;
+
+  // Returns the projections of schema with the given version for the referenced columns.
+  Result<QLProjectionsPtr> Get(const Schema& schema, uint32_t schema_version,
+                               const QLReferencedColumnsPB& column_refs);
+
+  void Clear();
+
+  size_t size() const;
+
+  // The cache is cleared once it has this many projections, there are few shapes of queries.
+  static constexpr size_t kMaxSize = 256;
+
+ private:
+  static std::string ProjectionsKey(uint32_t schema_version,
+                                    const QLReferencedColumnsPB& column_refs);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, QLProjectionsPtr> projections_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_QL_PROJECTION_CACHE_H
@@ -15,6 +15,7 @@
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/gutil/casts.h"
 
 namespace yb {
 namespace docdb {
@@ -31,10 +32,32 @@ CHECKED_STATUS QLRocksDBStorage::GetIterator(
     const TransactionOperationContextOpt& txn_op_context,
     const ReadHybridTime& read_time,
     std::unique_ptr<common::QLRowwiseIteratorIf> *iter) const {
+  if (FLAGS_ql_paging_cursor_cache_size > 0 && request.return_paging_state() &&
+      !txn_op_context) {
+    // The iterator could be kept for the next page, past the lifetime of the projection.
+    iter->reset(new DocRowwiseIterator(
+        std::make_unique<Schema>(projection), schema, txn_op_context, rocksdb_, read_time));
+    return Status::OK();
+  }
   iter->reset(new DocRowwiseIterator(projection, schema, txn_op_context, rocksdb_, read_time));
   return Status::OK();
 }
 
+std::unique_ptr<common::QLRowwiseIteratorIf> QLRocksDBStorage::TakeCachedIterator(
+    const QLReadRequestPB& request) const {
+  return cursor_cache_.Take(request);
+}
+
+void QLRocksDBStorage::CacheIterator(const QLReadRequestPB& request,
+                                     const QLResponsePB& response,
+                                     std::unique_ptr<common::QLRowwiseIteratorIf> iter) const {
+  // The cache flag could have been turned on after the iterator was created.
+  if (!down_cast<DocRowwiseIterator*>(iter.get())->owns_projection()) {
+    return;
+  }
+  cursor_cache_.Put(request, response, std::move(iter));
+}
+
 CHECKED_STATUS QLRocksDBStorage::BuildQLScanSpec(const QLReadRequestPB& request,
                                                  const ReadHybridTime& read_time,
                                                  const Schema& schema,
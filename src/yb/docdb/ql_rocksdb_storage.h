@@ -20,6 +20,8 @@
 #include "yb/common/ql_rowwise_iterator_interface.h"
 #include "yb/common/ql_storage_interface.h"
 
+#include "yb/docdb/ql_cursor_cache.h"
+
 namespace yb {
 namespace docdb {
 
@@ -43,8 +45,18 @@ class QLRocksDBStorage : public common::QLStorageIf {
                                  std::unique_ptr<common::QLScanSpec>* spec,
                                  std::unique_ptr<common::QLScanSpec>* static_row_spec,
                                  ReadHybridTime* req_read_time) const override;
+
+  std::unique_ptr<common::QLRowwiseIteratorIf> TakeCachedIterator(
+      const QLReadRequestPB& request) const override;
+
+  void CacheIterator(const QLReadRequestPB& request,
+                     const QLResponsePB& response,
+                     std::unique_ptr<common::QLRowwiseIteratorIf> iter) const override;
  private:
   rocksdb::DB *const rocksdb_;
+  // Iterators of paged scans, kept until the read of the next page. Destroyed with the storage,
+  // so they never outlive rocksdb_.
+  mutable QLCursorCache cursor_cache_;
 };
 
 }  // namespace docdb
@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/range_tombstone.h"
+
+#include <algorithm>
+
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/value_type.h"
+#include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/format.h"
+
+namespace yb {
+namespace docdb {
+
+std::string RangeTombstone::ToString() const {
+  return Format("{ start: $0 end: $1 doc_ht: $2 }",
+                FormatRocksDBSliceAsStr(start), FormatRocksDBSliceAsStr(end), doc_ht);
+}
+
+void AppendRangeTombstoneKey(const Slice& start, KeyBytes* out) {
+  out->AppendValueType(ValueType::kRangeTombstonePrefix);
+  out->AppendRawBytes(start);
+}
+
+Status DecodeRangeTombstone(const Slice& key, const Slice& value, RangeTombstone* out) {
+  if (key.empty() || DecodeValueType(key) != ValueType::kRangeTombstonePrefix) {
+    return STATUS_FORMAT(Corruption, "Not a range tombstone: $0", key.ToDebugHexString());
+  }
+  int encoded_ht_size = 0;
+  RETURN_NOT_OK(DocHybridTime::CheckAndGetEncodedSize(key, &encoded_ht_size));
+  // The start key is followed by kHybridTime and the DocHybridTime.
+  const size_t start_end = key.size() - encoded_ht_size - 1;
+  if (start_end < 1 || DecodeValueType(key[start_end]) != ValueType::kHybridTime) {
+    return STATUS_FORMAT(Corruption, "Range tombstone without hybrid time: $0",
+                         key.ToDebugHexString());
+  }
+  RETURN_NOT_OK(out->doc_ht.FullyDecodeFrom(
+      Slice(key.data() + start_end + 1, encoded_ht_size)));
+  out->start.assign(key.cdata() + 1, start_end - 1);
+  out->end = value.ToBuffer();
+  return Status::OK();
+}
+
+RangeTombstones::RangeTombstones(std::vector<RangeTombstone> tombstones)
+    : tombstones_(std::move(tombstones)) {
+  std::sort(tombstones_.begin(), tombstones_.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.start < rhs.start;
+  });
+}
+
+DocHybridTime RangeTombstones::DeletedAt(
+    const Slice& doc_key, HybridTime read_ht, HybridTime* max_seen_ht) const {
+  DocHybridTime result = DocHybridTime::kMin;
+  // Only the tombstones that start at or before the key could cover it.
+  const auto end = std::upper_bound(
+      tombstones_.begin(), tombstones_.end(), doc_key,
+      [](const Slice& key, const RangeTombstone& tombstone) {
+    return key.compare(tombstone.start) < 0;
+  });
+  for (auto it = tombstones_.begin(); it != end; ++it) {
+    if (!it->Covers(doc_key)) {
+      continue;
+    }
+    if (it->doc_ht.hybrid_time() <= read_ht) {
+      result = std::max(result, it->doc_ht);
+    } else if (max_seen_ht != nullptr) {
+      max_seen_ht->MakeAtLeast(it->doc_ht.hybrid_time());
+    }
+  }
+  return result;
+}
+
+Result<RangeTombstonesPtr> ReadRangeTombstones(rocksdb::DB* rocksdb, HybridTime max_ht) {
+  auto iter = CreateRocksDBIterator(rocksdb, BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                    boost::none /* user_key_for_filter */,
+                                    rocksdb::kDefaultQueryId);
+  const char prefix_byte = static_cast<char>(ValueType::kRangeTombstonePrefix);
+  const Slice prefix(&prefix_byte, 1);
+  std::vector<RangeTombstone> tombstones;
+  ROCKSDB_SEEK(iter.get(), prefix);
+  for (; iter->Valid() && iter->key().starts_with(prefix); iter->Next()) {
+    RangeTombstone tombstone;
+    RETURN_NOT_OK(DecodeRangeTombstone(iter->key(), iter->value(), &tombstone));
+    if (tombstone.doc_ht.hybrid_time() <= max_ht) {
+      tombstones.push_back(std::move(tombstone));
+    }
+  }
+  if (tombstones.empty()) {
+    return RangeTombstonesPtr();
+  }
+  return RangeTombstonesPtr(std::make_shared<RangeTombstones>(std::move(tombstones)));
+}
+
+}  // namespace docdb
+}  // namespace yb
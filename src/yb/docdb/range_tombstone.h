@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_RANGE_TOMBSTONE_H_
+#define YB_DOCDB_RANGE_TOMBSTONE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/docdb/key_bytes.h"
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+class DB;
+}
+
+namespace yb {
+namespace docdb {
+
+// A range tombstone deletes all the documents with encoded DocKeys in [start, end) that were
+// written before it, with a single RocksDB entry instead of a tombstone per document:
+//   kRangeTombstonePrefix + start + kHybridTime + DocHybridTime -> end
+//
+// Range tombstones sort before all the documents, so readers load the ones visible to them once
+// and treat every older entry of a covered document as deleted. Full compactions drop the covered
+// entries and the range tombstones themselves once they are below the history cutoff.
+struct RangeTombstone {
+  std::string start;
+  std::string end;
+  DocHybridTime doc_ht;
+
+  bool Covers(const Slice& doc_key) const {
+    return doc_key.compare(start) >= 0 && doc_key.compare(end) < 0;
+  }
+
+  std::string ToString() const;
+};
+
+// Appends the key of a range tombstone starting at the given encoded DocKey to out, without the
+// hybrid time, which is only appended when the write is applied.
+void AppendRangeTombstoneKey(const Slice& start, KeyBytes* out);
+
+CHECKED_STATUS DecodeRangeTombstone(const Slice& key, const Slice& value, RangeTombstone* out);
+
+// The range tombstones of a tablet written at or before some hybrid time, sorted by start key.
+class RangeTombstones {
+ public:
+  explicit RangeTombstones(std::vector<RangeTombstone> tombstones);
+
+  bool empty() const { return tombstones_.empty(); }
+
+  // Returns the time of the latest range tombstone written at or before read_ht that covers the
+  // document with the given encoded DocKey, or DocHybridTime::kMin if there is none. Later covering
+  // tombstones are reported to max_seen_ht when it is not null.
+  DocHybridTime DeletedAt(const Slice& doc_key, HybridTime read_ht,
+                          HybridTime* max_seen_ht = nullptr) const;
+
+ private:
+  std::vector<RangeTombstone> tombstones_;
+};
+
+typedef std::shared_ptr<const RangeTombstones> RangeTombstonesPtr;
+
+// Reads the range tombstones written at or before max_ht. Returns nullptr if there are none, so
+// that readers of tablets without range deletes could skip the lookups altogether.
+Result<RangeTombstonesPtr> ReadRangeTombstones(rocksdb::DB* rocksdb, HybridTime max_ht);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_RANGE_TOMBSTONE_H_
@@ -11,12 +11,14 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <random>
 #include <stack>
 #include <thread>
 
+#include "yb/docdb/lock_batch.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/test_macros.h"
@@ -262,6 +264,42 @@ TEST_F(SharedLockManagerTest, RandomLockUnlockManyThreadsTest) {
   Run(2, 8);
 }
 
+// Measures the throughput of lock batches that rarely conflict, as issued by concurrent writes to
+// different rows of the same tablet: a weak intent on the common prefix and a strong intent on the
+// row.
+TEST_F(SharedLockManagerTest, ContentionBenchmark) {
+  constexpr int kNumRows = 10000;
+  constexpr auto kDuration = std::chrono::seconds(3);
+  const int num_threads = std::max<int>(std::thread::hardware_concurrency(), 4);
+
+  std::atomic<bool> stop(false);
+  std::atomic<size_t> num_batches(0);
+  vector<thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([this, i, &stop, &num_batches]() {
+      std::mt19937 gen(i);
+      std::uniform_int_distribution<> row_dis(0, kNumRows - 1);
+      size_t local_num_batches = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        LockBatch lock_batch(&lm_, {
+            {"table", IntentType::kWeakSnapshotWrite},
+            {"row" + std::to_string(row_dis(gen)), IntentType::kStrongSnapshotWrite}});
+        ++local_num_batches;
+      }
+      num_batches += local_num_batches;
+    });
+  }
+  std::this_thread::sleep_for(kDuration);
+  stop.store(true, std::memory_order_release);
+  for (auto& t : threads) {
+    t.join();
+  }
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(kDuration).count();
+  LOG(INFO) << num_threads << " threads locked " << num_batches.load() / seconds
+            << " batches per second";
+  ASSERT_GT(num_batches.load(), 0U);
+}
+
 namespace {
 
 // Returns true if c1 covers (is superset of) c2.
@@ -383,5 +421,19 @@ TEST_F(SharedLockManagerTest, LockBatchReset) {
   EXPECT_TRUE(lb.empty());
 }
 
+TEST_F(SharedLockManagerTest, IsLocked) {
+  ASSERT_FALSE(lm_.IsLocked("foo"));
+  {
+    LockBatch lb(&lm_, {
+        {"foo", IntentType::kWeakSnapshotWrite},
+        {"bar", IntentType::kStrongSnapshotWrite}});
+    ASSERT_TRUE(lm_.IsLocked("foo"));
+    ASSERT_TRUE(lm_.IsLocked("bar"));
+    ASSERT_FALSE(lm_.IsLocked("baz"));
+  }
+  ASSERT_FALSE(lm_.IsLocked("foo"));
+  ASSERT_FALSE(lm_.IsLocked("bar"));
+}
+
 } // namespace docdb
 } // namespace yb
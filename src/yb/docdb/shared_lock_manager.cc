@@ -13,6 +13,7 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <functional>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
@@ -81,6 +82,39 @@ std::array<LockState, kIntentTypeMapSize> MakeConflicts() {
   return result;
 }
 
+// The number of holders of each intent type on a key is stored in kLockCountBits bits of the lock
+// entry state word.
+constexpr size_t kLockCountBits = 10;
+constexpr size_t kMaxFreeEntriesPerShard = 64;
+
+static_assert(kElementsInIntentType * kLockCountBits <= 64,
+              "Lock counts of all intent types should fit into 64 bits");
+
+// Value of the state word with a single holder of each intent type.
+std::array<uint64_t, kIntentTypeMapSize> MakeLockCountOnes() {
+  std::array<uint64_t, kIntentTypeMapSize> result;
+  result.fill(0);
+  size_t shift = 0;
+  for (auto type : kIntentTypeList) {
+    result[static_cast<size_t>(type)] = 1ULL << shift;
+    shift += kLockCountBits;
+  }
+  return result;
+}
+
+const std::array<uint64_t, kIntentTypeMapSize> kLockCountOnes = MakeLockCountOnes();
+
+// Bits of the state word that hold the number of holders of each intent type.
+std::array<uint64_t, kIntentTypeMapSize> MakeLockCountMasks() {
+  std::array<uint64_t, kIntentTypeMapSize> result;
+  for (size_t i = 0; i != kIntentTypeMapSize; ++i) {
+    result[i] = kLockCountOnes[i] * ((1ULL << kLockCountBits) - 1);
+  }
+  return result;
+}
+
+const std::array<uint64_t, kIntentTypeMapSize> kLockCountMasks = MakeLockCountMasks();
+
 } // namespace
 
 // The conflict matrix. (CONFLICTS[i] & (1 << j)) is one iff LockTypes i and j conflict.
@@ -88,6 +122,27 @@ std::array<LockState, kIntentTypeMapSize> MakeConflicts() {
 // https://docs.google.com/spreadsheets/d/1h8GosY5XnJvrsyjEqyuXdKYlwvfKIaqx_RyDQGd7rSc
 const std::array<LockState, kIntentTypeMapSize> kIntentConflicts = MakeConflicts();
 
+namespace {
+
+// Bits of the state word that should be zero to take a lock of each intent type.
+std::array<uint64_t, kIntentTypeMapSize> MakeConflictingCountsMasks() {
+  std::array<uint64_t, kIntentTypeMapSize> result;
+  result.fill(0);
+  for (size_t i = 0; i != kIntentTypeMapSize; ++i) {
+    for (size_t j = 0; j != kIntentTypeMapSize; ++j) {
+      if (kIntentConflicts[i].test(j)) {
+        result[i] |= kLockCountMasks[j];
+      }
+    }
+  }
+  return result;
+}
+
+const std::array<uint64_t, kIntentTypeMapSize> kConflictingCountsMasks =
+    MakeConflictingCountsMasks();
+
+} // namespace
+
 bool SharedLockManager::VerifyState(const LockState& state) {
   LockState not_allowed;
   for (auto intent : kIntentTypeList) {
@@ -196,38 +251,55 @@ IntentType SharedLockManager::CombineIntents(const IntentType i1, const IntentTy
   FATAL_INVALID_ENUM_VALUE(IntentType, i1);
 }
 
+bool SharedLockManager::LockEntry::TryLock(IntentType lock_type) {
+  const size_t type_idx = static_cast<size_t>(lock_type);
+  const uint64_t count_mask = kLockCountMasks[type_idx];
+  const uint64_t conflict_mask = kConflictingCountsMasks[type_idx];
+  uint64_t old_value = num_holding.load();
+  // Taking the lock also waits when the number of holders of this type has reached the maximum.
+  while ((old_value & conflict_mask) == 0 && (old_value & count_mask) != count_mask) {
+    if (num_holding.compare_exchange_weak(old_value, old_value + kLockCountOnes[type_idx])) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void SharedLockManager::LockEntry::Lock(IntentType lock_type) {
-  // TODO(bojanserafimov): Implement CAS fast path. Only wait when CAS fails.
-  int type_idx = static_cast<size_t>(lock_type);
+  if (TryLock(lock_type)) {
+    return;
+  }
   std::unique_lock<std::mutex> lock(mutex);
-  auto& state = this->state;
-  cond_var.wait(lock, [&state, type_idx]() {
-    return (state & kIntentConflicts[type_idx]).none();
+  // The waiter is counted before checking the state, so a holder releasing its lock after the
+  // check sees the waiter and notifies it.
+  ++num_waiters;
+  cond_var.wait(lock, [this, lock_type]() {
+    return TryLock(lock_type);
   });
-  ++num_holding[type_idx];
-  state.set(type_idx);
+  --num_waiters;
 }
 
 void SharedLockManager::LockEntry::Unlock(IntentType lock_type) {
-  int type_idx = static_cast<int>(lock_type);
-  bool should_notify = false;
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    num_holding[type_idx]--;
-    if (num_holding[type_idx] == 0) {
-      state.reset(type_idx);
-      should_notify = (state == Combine({})
-        || state == Combine({IntentType::kWeakSerializableRead})
-        || state == Combine({IntentType::kWeakSerializableWrite}));
-    }
-  }
-
-  // Notify only if it is possible that a waiting thread can now lock
-  if (should_notify) {
+  const size_t type_idx = static_cast<size_t>(lock_type);
+  const uint64_t count_mask = kLockCountMasks[type_idx];
+  const uint64_t old_value = num_holding.fetch_sub(kLockCountOnes[type_idx]);
+  DCHECK_NE(old_value & count_mask, 0U) << "Unlocking " << docdb::ToString(lock_type)
+                                       << " that is not held";
+  // Notify only if it is possible that a waiting thread can now lock, i.e. this was the last holder
+  // of this type, or the number of holders of this type was at the maximum.
+  const uint64_t old_count = old_value & count_mask;
+  if ((old_count == kLockCountOnes[type_idx] || old_count == count_mask) && num_waiters > 0) {
+    // Waiters check the state while holding the mutex, so taking it guarantees that the waiter
+    // either sees the new state, or already waits and gets notified.
+    { std::lock_guard<std::mutex> lock(mutex); }
     cond_var.notify_all();
   }
 }
 
+SharedLockManager::LockShard& SharedLockManager::ShardFor(const std::string& key) {
+  return shards_[std::hash<std::string>()(key) % kNumShards];
+}
+
 void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type.size());
   std::vector<SharedLockManager::LockEntry*> reserved = Reserve(key_to_intent_type);
@@ -245,26 +317,51 @@ std::vector<SharedLockManager::LockEntry*> SharedLockManager::Reserve(
     const KeyToIntentTypeMap& key_to_intent_type) {
   std::vector<SharedLockManager::LockEntry*> reserved;
   reserved.reserve(key_to_intent_type.size());
-  {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    for (const auto& key_and_intent_type : key_to_intent_type) {
-      auto it = locks_.emplace(key_and_intent_type.first, std::make_unique<LockEntry>()).first;
-      it->second->num_using++;
-      reserved.push_back(&*it->second);
+  for (const auto& key_and_intent_type : key_to_intent_type) {
+    auto& shard = ShardFor(key_and_intent_type.first);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& entry = shard.locks[key_and_intent_type.first];
+    if (!entry) {
+      if (shard.free_entries.empty()) {
+        entry = std::make_unique<LockEntry>();
+      } else {
+        entry = std::move(shard.free_entries.back());
+        shard.free_entries.pop_back();
+      }
     }
+    entry->num_using++;
+    reserved.push_back(entry.get());
   }
   return reserved;
 }
 
 void SharedLockManager::Unlock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Unlocking a batch of $0 keys", key_to_intent_type.size());
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& key_and_intent_type : boost::adaptors::reverse(key_to_intent_type)) {
     VLOG(4) << "Unlocking " << docdb::ToString(key_and_intent_type.second) << ": "
             << util::FormatBytesAsStr(key_and_intent_type.first);
-    locks_[key_and_intent_type.first]->Unlock(key_and_intent_type.second);
+    auto& shard = ShardFor(key_and_intent_type.first);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.locks.find(key_and_intent_type.first);
+    DCHECK(it != shard.locks.end()) << "Unlocking key that is not locked: "
+                                    << util::FormatBytesAsStr(key_and_intent_type.first);
+    it->second->Unlock(key_and_intent_type.second);
+    // Update refcounts and maybe collect garbage.
+    if (--it->second->num_using == 0) {
+      // There are no holders or waiters left, so the entry could be reused for any key.
+      if (shard.free_entries.size() < kMaxFreeEntriesPerShard) {
+        shard.free_entries.push_back(std::move(it->second));
+      }
+      shard.locks.erase(it);
+    }
   }
-  Cleanup(key_to_intent_type);
+}
+
+bool SharedLockManager::IsLocked(const std::string& key) {
+  auto& shard = ShardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  // Entries are kept in the map while they have holders or waiters.
+  return shard.locks.count(key) != 0;
 }
 
 void SharedLockManager::LockInTest(const string& key, IntentType intent_type) {
@@ -275,15 +372,5 @@ void SharedLockManager::UnlockInTest(const string& key, IntentType intent_type)
   Unlock({{key, intent_type}});
 }
 
-void SharedLockManager::Cleanup(const KeyToIntentTypeMap& key_to_intent_type) {
-  for (const auto& item : key_to_intent_type) {
-    auto it = locks_.find(item.first);
-    it->second->num_using--;
-    if (it->second->num_using == 0) {
-      locks_.erase(it);
-    }
-  }
-}
-
 }  // namespace docdb
 }  // namespace yb
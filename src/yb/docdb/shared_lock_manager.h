@@ -14,6 +14,9 @@
 #ifndef YB_DOCDB_SHARED_LOCK_MANAGER_H
 #define YB_DOCDB_SHARED_LOCK_MANAGER_H
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <string>
@@ -45,6 +48,11 @@ class SharedLockManager {
   // Release the batch of locks. Requires that the locks are held.
   void Unlock(const KeyToIntentTypeMap& key_to_intent_type);
 
+  // Returns whether the key is locked by some batch, or some batch is waiting to lock it. The
+  // result could be stale once returned, so it is only useful when the key could not be locked
+  // concurrently with this call in a way the caller cares about.
+  bool IsLocked(const std::string& key);
+
   void LockInTest(const std::string& key, IntentType intent_type);
   void UnlockInTest(const std::string& key, IntentType intent_type);
 
@@ -58,42 +66,56 @@ class SharedLockManager {
  private:
 
   struct LockEntry {
-    // Taken only for short duration, with no blocking wait.
+    // Number of holders for each intent type, packed into a single word, so that a lock that does
+    // not conflict with the current holders is taken and released with a single atomic operation.
+    std::atomic<uint64_t> num_holding{0};
+
+    // Number of threads waiting on cond_var. Holders only notify waiters when there are any.
+    std::atomic<size_t> num_waiters{0};
+
+    // Taken only to wait for a conflicting lock to be released, and to notify such waiters.
     std::mutex mutex;
 
     std::condition_variable cond_var;
 
-    // Refcounting for garbage collection. Can only be used while the global lock is held.
+    // Refcounting for garbage collection. Can only be used while the mutex of the shard that
+    // contains the entry is held.
     size_t num_using = 0;
 
-    // Number of holders for each type
-    std::array<size_t, kIntentTypeMapSize> num_holding;
-    LockState state;
+    // Takes the lock if it does not conflict with the current holders, without blocking.
+    bool TryLock(IntentType lock_type);
 
     void Lock(IntentType lock_type);
 
     void Unlock(IntentType lock_type);
-
-    LockEntry() {
-      num_holding.fill(0);
-    }
   };
 
   typedef std::unordered_map<std::string, std::unique_ptr<LockEntry>> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
-  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
+  // The lock entries are split between shards by key hash, so that batches locking different keys
+  // rarely contend for the same mutex.
+  struct LockShard {
+    // Taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
 
-  // Update refcounts and maybe collect garbage.
-  void Cleanup(const KeyToIntentTypeMap& key_to_intent_type);
+    // Can only be modified if the mutex is held.
+    LockEntryMap locks;
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+    // Entries that are not used by any key, reused to avoid allocating an entry for every newly
+    // locked key. Can only be modified if the mutex is held.
+    std::vector<std::unique_ptr<LockEntry>> free_entries;
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  LockShard& ShardFor(const std::string& key);
+
+  // Make sure the entries exist in the shards and return pointers so we can access them without
+  // holding the shard mutexes. Returns a vector with pointers in the same order as the keys in the
+  // batch.
+  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
 
-  // Can only be modified if the global mutex is held.
-  LockEntryMap locks_;
+  std::array<LockShard, kNumShards> shards_;
 };
 
 extern const std::array<LockState, kIntentTypeMapSize> kIntentConflicts;
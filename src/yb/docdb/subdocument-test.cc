@@ -43,6 +43,24 @@ TEST(SubDocumentTest, TestGetOrAddChild) {
 )#", d.ToString());
 }
 
+TEST(SubDocumentTest, TestSetChild) {
+  SubDocument d;
+  // Children added in key order, out of order, and overwritten must all end up in the same place.
+  d.SetChildPrimitive(PrimitiveValue(10), PrimitiveValue("a"));
+  d.SetChildPrimitive(PrimitiveValue(30), PrimitiveValue("c"));
+  d.SetChildPrimitive(PrimitiveValue(20), PrimitiveValue("b"));
+  d.SetChildPrimitive(PrimitiveValue(30), PrimitiveValue("d"));
+  d.SetChildPrimitive(PrimitiveValue(10), PrimitiveValue("e"));
+  ASSERT_EQ(3, d.object_num_keys());
+  ASSERT_STR_EQ_VERBOSE_TRIMMED(R"#(
+{
+  10: "e",
+  20: "b",
+  30: "d"
+}
+)#", d.ToString());
+}
+
 TEST(SubDocumentTest, TestToString) {
   SubDocument subdoc(ValueType::kObject);
   SubDocument mathematicians;
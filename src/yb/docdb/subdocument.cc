@@ -13,6 +13,7 @@
 
 #include "yb/docdb/subdocument.h"
 
+#include <iterator>
 #include <map>
 #include <sstream>
 #include <vector>
@@ -43,6 +44,7 @@ SubDocument::~SubDocument() {
     case ValueType::kObject: FALLTHROUGH_INTENDED;
     case ValueType::kRedisTS: FALLTHROUGH_INTENDED;
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisString: FALLTHROUGH_INTENDED;
     case ValueType::kSSForward: FALLTHROUGH_INTENDED;
     case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
     case ValueType::kRedisSet:
@@ -161,6 +163,10 @@ Status SubDocument::ConvertToRedisSet() {
   return ConvertToCollection(ValueType::kRedisSet);
 }
 
+Status SubDocument::ConvertToRedisString() {
+  return ConvertToCollection(ValueType::kRedisString);
+}
+
 Status SubDocument::ConvertToRedisSortedSet() {
   type_ = ValueType::kRedisSortedSet;
   return Status::OK();
@@ -196,11 +202,10 @@ pair<SubDocument*, bool> SubDocument::GetOrAddChild(const PrimitiveValue& key) {
   DCHECK(IsObjectType(type_));
   EnsureContainerAllocated();
   auto& obj_container = object_container();
-  auto iter = obj_container.find(key);
-  if (iter == obj_container.end()) {
-    auto ret = obj_container.insert(make_pair(key, SubDocument()));
-    CHECK(ret.second);
-    return make_pair(&ret.first->second, true);  // New subdocument created.
+  auto iter = obj_container.lower_bound(key);
+  if (iter == obj_container.end() || key < iter->first) {
+    iter = obj_container.emplace_hint(iter, key, SubDocument());
+    return make_pair(&iter->second, true);  // New subdocument created.
   } else {
     return make_pair(&iter->second, false);  // No new subdocument created.
   }
@@ -216,13 +221,16 @@ void SubDocument::SetChild(const PrimitiveValue& key, SubDocument&& value) {
   type_ = ValueType::kObject;
   EnsureContainerAllocated();
   auto& obj_container = object_container();
-  auto existing_element = obj_container.find(key);
-  if (existing_element == obj_container.end()) {
-    const bool inserted_value = obj_container.emplace(key, std::move(value)).second;
-    CHECK(inserted_value);
-  } else {
-    existing_element->second = std::move(value);
+  // Children are usually added in key order while a document is read, so try appending first.
+  auto hint = obj_container.end();
+  if (!obj_container.empty() && !(std::prev(hint)->first < key)) {
+    hint = obj_container.lower_bound(key);
+    if (hint != obj_container.end() && !(key < hint->first)) {
+      hint->second = std::move(value);
+      return;
+    }
   }
+  obj_container.emplace_hint(hint, key, std::move(value));
 }
 
 bool SubDocument::DeleteChild(const PrimitiveValue& key) {
@@ -300,6 +308,10 @@ void SubDocumentToStreamInternal(ostream& out,
       SubDocCollectionToStreamInternal(out, subdoc, indent, "<", ">");
       break;
     }
+    case ValueType::kRedisString: {
+      SubDocCollectionToStreamInternal(out, subdoc, indent, "[\"", "\"]");
+      break;
+    }
     default:
       LOG(FATAL) << "Invalid subdocument type: " << ToString(subdoc.value_type());
   }
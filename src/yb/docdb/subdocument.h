@@ -111,6 +111,10 @@ class SubDocument : public PrimitiveValue {
   // Assume current subdocument is of map type (kObject type)
   CHECKED_STATUS ConvertToRedisTS();
 
+  // Interpret the SubDocument as a chunked RedisString.
+  // Assume current subdocument is of map type (kObject type)
+  CHECKED_STATUS ConvertToRedisString();
+
   // Interpret the SubDocument as a RedisSortedSet.
   // Assume current subdocument is of map type (kObject type)
   CHECKED_STATUS ConvertToRedisSortedSet();
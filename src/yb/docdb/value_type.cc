@@ -26,6 +26,7 @@ string ToString(ValueType value_type) {
     case ValueType::kGroupEnd: return "GroupEnd";
     case ValueType::kGroupEndDescending: return "GroupEndDescending";
     case ValueType::kIntentPrefix: return "IntentPrefix";
+    case ValueType::kRangeTombstonePrefix: return "RangeTombstonePrefix";
     case ValueType::kNull: return "Null";
     case ValueType::kCounter: return "Counter";
     case ValueType::kSSForward: return "SSforward";
@@ -41,6 +42,7 @@ string ToString(ValueType value_type) {
     case ValueType::kInt32: return "Int32";
     case ValueType::kVarIntDescending: return "VarIntDescending";
     case ValueType::kVarInt: return "VarInt";
+    case ValueType::kPackedRow: return "PackedRow";
     case ValueType::kDouble: return "Double";
     case ValueType::kDoubleDescending: return "DoubleDescending";
     case ValueType::kFloat: return "Float";
@@ -61,6 +63,7 @@ string ToString(ValueType value_type) {
     case ValueType::kRedisSet: return "RedisSet";
     case ValueType::kRedisTS: return "RedisTimeseries";
     case ValueType::kRedisSortedSet: return "RedisSortedSet";
+    case ValueType::kRedisString: return "RedisString";
     case ValueType::kArray: return "Array";
     case ValueType::kArrayIndex: return "ArrayIndex";
     case ValueType::kTombstone: return "Tombstone";
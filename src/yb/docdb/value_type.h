@@ -37,6 +37,10 @@ enum class ValueType : char {
   // so intents will be written in the same order as original keys for which intents are written.
   kIntentType = 20,
 
+  // Range tombstones are stored in the beginning of the keyspace, before all the documents they
+  // cover, so that they could be read without scanning those documents.
+  kRangeTombstonePrefix = ' ',  // ASCII code 32
+
   // This indicates the end of the "hashed" or "range" group of components of the primary key. This
   // needs to sort before all other value types, so that a DocKey that has a prefix of the sequence
   // of components of another key sorts before the other key.
@@ -67,6 +71,8 @@ enum class ValueType : char {
   kSSReverse = '\'', // ASCII code 39
 
   kRedisSet = '(', // ASCII code 40
+  // A large redis string, stored as a length and chunks of the value.
+  kRedisString = ')', // ASCII code 41
   // This is the redis timeseries type.
   kRedisTS = '+', // ASCII code 43
   kRedisSortedSet = ',', // ASCII code 44
@@ -104,6 +110,10 @@ enum class ValueType : char {
   kInt32Descending = 'e',  // ASCII code 101
   kVarIntDescending = 'f',  // ASCII code 102
 
+  // Values of all columns of a QL row written by a single INSERT, stored as the value of the
+  // packed row system column. Only used in values, never in keys.
+  kPackedRow = 'p',  // ASCII code 112
+
   // Timestamp value in microseconds
   kTimestamp = 's',  // ASCII code 115
   // TTL value in milliseconds, optionally present at the start of a value.
@@ -204,6 +214,7 @@ std::string ToString(ValueType value_type);
 constexpr inline bool IsObjectType(const ValueType value_type) {
   return value_type == ValueType::kRedisTS || value_type == ValueType::kObject ||
       value_type == ValueType::kRedisSet || value_type == ValueType::kRedisSortedSet ||
+      value_type == ValueType::kRedisString ||
       value_type == ValueType::kSSForward || value_type == ValueType::kSSReverse;
 }
 
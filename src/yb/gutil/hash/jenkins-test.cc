@@ -13,6 +13,9 @@
 
 #include "yb/gutil/hash/jenkins.h"
 
+#include <algorithm>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "yb/util/cast.h"
@@ -56,4 +59,23 @@ TEST(Jenkins, TestHash64) {
             Hash64StringWithSeed(yb::util::to_char_ptr(b3), sizeof(b3), seed));
 }
 
+TEST(Jenkins, TestHash64Builder) {
+  const uint64_t seed = 97;
+  std::string bytes;
+  for (int i = 0; i != 100; ++i) {
+    bytes.push_back(static_cast<char>(i * 37 + 11));
+  }
+  // Piece sizes around the block size of the hash.
+  for (size_t len = 0; len <= bytes.size(); ++len) {
+    for (size_t piece : {1, 5, 8, 23, 24, 25, 60}) {
+      Hash64StringWithSeedBuilder builder(seed);
+      for (size_t pos = 0; pos < len; pos += piece) {
+        builder.append(bytes.data() + pos, std::min(piece, len - pos));
+      }
+      ASSERT_EQ(Hash64StringWithSeed(bytes.data(), static_cast<uint32>(len), seed),
+                builder.Finish()) << "len: " << len << ", piece: " << piece;
+    }
+  }
+}
+
 } // namespace yb
@@ -32,6 +32,10 @@
 
 #include "yb/gutil/hash/jenkins.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "yb/gutil/integral_types.h"
 #include <glog/logging.h>
 #include "yb/gutil/logging-inl.h"
@@ -156,6 +160,64 @@ uint32 Hash32StringWithSeed(const char *s, uint32 len, uint32 c) {
   return c;
 }
 
+Hash64StringWithSeedBuilder::Hash64StringWithSeedBuilder(uint64 c)
+    : a_(GG_ULONGLONG(0xe08c1d668b756f82)), b_(a_), c_(c) {
+}
+
+void Hash64StringWithSeedBuilder::MixBlock(const char *s) {
+  a_ += Word64At(s);
+  b_ += Word64At(s + sizeof(a_));
+  c_ += Word64At(s + sizeof(a_) * 2);
+  mix(a_, b_, c_);
+}
+
+void Hash64StringWithSeedBuilder::append(const char *s, size_t len) {
+  len_ += static_cast<uint32>(len);
+  if (buffered_ != 0) {
+    const size_t n = std::min(len, kBlockSize - buffered_);
+    memcpy(buffer_ + buffered_, s, n);
+    buffered_ += n;
+    s += n;
+    len -= n;
+    if (buffered_ < kBlockSize) {
+      return;
+    }
+    MixBlock(buffer_);
+    buffered_ = 0;
+  }
+  for (; len >= kBlockSize; len -= kBlockSize, s += kBlockSize) {
+    MixBlock(s);
+  }
+  memcpy(buffer_, s, len);
+  buffered_ = len;
+}
+
+uint64 Hash64StringWithSeedBuilder::Finish() const {
+  // Same as the end of Hash64StringWithSeed() for the bytes left.
+  uint64 a = a_, b = b_, c = c_ + len_;
+  const char *s = buffer_;
+  size_t i = 0;
+  if (buffered_ >= 16) {
+    b += Word64At(s + 8);
+    a += Word64At(s);
+    // the first byte of c is reserved for the length
+    for (i = 16; i < buffered_; ++i) {
+      c += char2unsigned64(s[i]) << (8 * (i - 15));
+    }
+  } else if (buffered_ >= 8) {
+    a += Word64At(s);
+    for (i = 8; i < buffered_; ++i) {
+      b += char2unsigned64(s[i]) << (8 * (i - 8));
+    }
+  } else {
+    for (i = 0; i < buffered_; ++i) {
+      a += char2unsigned64(s[i]) << (8 * i);
+    }
+  }
+  mix(a, b, c);
+  return c;
+}
+
 uint64 Hash64StringWithSeed(const char *s, uint32 len, uint64 c) {
   uint64 a, b;
   uint32 keylen;
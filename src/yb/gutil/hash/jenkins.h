@@ -24,6 +24,8 @@
 #ifndef UTIL_HASH_JENKINS_H_
 #define UTIL_HASH_JENKINS_H_
 
+#include <stddef.h>
+
 #include "yb/gutil/integral_types.h"
 
 // ----------------------------------------------------------------------
@@ -51,4 +53,26 @@ uint64 Hash64StringWithSeed(const char *s, uint32 len, uint64 c);
 uint32 Hash32StringWithSeedReferenceImplementation(const char *s,
                                                    uint32 len, uint32 c);
 
+// Computes the same value as Hash64StringWithSeed() of the concatenation of
+// the appended pieces, without building the concatenation.
+class Hash64StringWithSeedBuilder {
+ public:
+  explicit Hash64StringWithSeedBuilder(uint64 c);
+
+  void append(const char *s, size_t len);
+
+  uint64 Finish() const;
+
+ private:
+  static const size_t kBlockSize = 3 * sizeof(uint64);
+
+  void MixBlock(const char *s);
+
+  uint64 a_, b_, c_;
+  uint32 len_ = 0;
+  // Bytes appended after the last mixed block.
+  char buffer_[kBlockSize];
+  size_t buffered_ = 0;
+};
+
 #endif  // UTIL_HASH_JENKINS_H_
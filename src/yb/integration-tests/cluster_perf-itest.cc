@@ -0,0 +1,389 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Whole-cluster performance scenarios over an external mini cluster: bulk load, steady mixed
+// load, a tablet server kill followed by re-replication, and compactions under load.
+//
+// Every scenario logs one JSON object with its throughput, client side latency percentiles per
+// operation type, and the change of a few tablet server metrics over the scenario, and appends it
+// to --cluster_perf_report_file if set. Running the same scenarios with the same flags on two
+// releases gives comparable reports, e.g.
+//
+//   cluster_perf-itest --cluster_perf_num_keys=1000000 --cluster_perf_duration_sec=300 \
+//       --cluster_perf_target_ops_per_sec=20000 --cluster_perf_report_file=/tmp/perf.json \
+//       --cluster_perf_metrics_dir=/tmp/perf-metrics
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/integration-tests/external_mini_cluster.h"
+#include "yb/integration-tests/workload_generator.h"
+#include "yb/integration-tests/yb_table_test_base.h"
+#include "yb/master/master.pb.h"
+#include "yb/util/curl_util.h"
+#include "yb/util/env.h"
+#include "yb/util/faststring.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/metrics.h"
+#include "yb/util/path_util.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(cluster_perf_num_keys, 10000,
+             "Number of keys inserted by the bulk load scenario, and loaded before the others.");
+DEFINE_int32(cluster_perf_duration_sec, 15,
+             "Duration of the measured phase of the timed scenarios.");
+DEFINE_int32(cluster_perf_num_threads, 8, "Number of client threads of every scenario.");
+DEFINE_double(cluster_perf_target_ops_per_sec, 0,
+              "Total rate at which the timed scenarios start operations, 0 to run the client "
+              "threads as fast as possible. A fixed rate makes latencies comparable across runs "
+              "with different throughput.");
+DEFINE_string(cluster_perf_report_file, "",
+              "File to append the scenario reports to, one JSON object per line.");
+DEFINE_string(cluster_perf_metrics_dir, "",
+              "Directory to save the full metrics of every tablet server to, before and after "
+              "every scenario.");
+
+METRIC_DECLARE_entity(server);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Write);
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_UpdateConsensus);
+
+namespace yb {
+namespace integration_tests {
+
+using load_generator::kNumWorkloadOpTypes;
+using load_generator::NewYBWorkloadSession;
+using load_generator::Workload;
+using load_generator::WorkloadMix;
+using load_generator::WorkloadOpType;
+using load_generator::WorkloadOpTypeName;
+using load_generator::WorkloadOptions;
+
+namespace {
+
+const MetricPrototype* const kReportedServerMetrics[] = {
+  &METRIC_handler_latency_yb_tserver_TabletServerService_Read,
+  &METRIC_handler_latency_yb_tserver_TabletServerService_Write,
+  &METRIC_handler_latency_yb_consensus_ConsensusService_UpdateConsensus,
+};
+
+constexpr size_t kNumReportedServerMetrics = arraysize(kReportedServerMetrics);
+
+struct ServerMetricValues {
+  int64_t total_count[kNumReportedServerMetrics] = {};
+  int64_t total_sum[kNumReportedServerMetrics] = {};
+};
+
+// Values of the reported server metrics by index of the running tablet servers.
+typedef std::map<int, ServerMetricValues> ServerMetricsSnapshot;
+
+WorkloadMix ParseMix(const std::string& spec) {
+  auto mix = WorkloadMix::Parse(spec);
+  CHECK_OK(mix.status());
+  return *mix;
+}
+
+} // namespace
+
+class ClusterPerfITest : public YBTableTestBase {
+ protected:
+  bool use_external_mini_cluster() override { return true; }
+
+  // One more tablet server than replicas, so that a killed server can be replaced.
+  int num_tablet_servers() override { return 4; }
+
+  int num_replicas() override { return 3; }
+
+  void CustomizeExternalMiniCluster(ExternalMiniClusterOptions* opts) override {
+    opts->extra_tserver_flags.push_back(
+        Format("--follower_unavailable_considered_failed_sec=$0", kFollowerFailedSec));
+  }
+
+  WorkloadOptions MakeOptions(const std::string& mix) {
+    WorkloadOptions options;
+    options.mix = ParseMix(mix);
+    options.num_threads = FLAGS_cluster_perf_num_threads;
+    options.duration = MonoDelta::FromSeconds(FLAGS_cluster_perf_duration_sec);
+    options.target_ops_per_sec = FLAGS_cluster_perf_target_ops_per_sec;
+    options.client_id = "cluster_perf";
+    return options;
+  }
+
+  // Options of a timed scenario over the FLAGS_cluster_perf_num_keys keys written by LoadKeys().
+  WorkloadOptions MakeTimedOptions(const std::string& mix) {
+    auto options = MakeOptions(mix);
+    options.num_initial_keys = FLAGS_cluster_perf_num_keys;
+    return options;
+  }
+
+  // Inserts the keys used by the timed scenarios, outside of any measurement.
+  void LoadKeys() {
+    auto options = MakeOptions("insert=1");
+    options.num_ops = FLAGS_cluster_perf_num_keys;
+    options.target_ops_per_sec = 0;
+    Workload workload(options, SessionCreator());
+    ASSERT_OK(workload.Run());
+    for (size_t i = 0; i != kNumWorkloadOpTypes; ++i) {
+      ASSERT_EQ(0, workload.num_errors(static_cast<WorkloadOpType>(i)));
+    }
+  }
+
+  Workload::SessionCreator SessionCreator() {
+    return [this] { return NewYBWorkloadSession(client_.get(), &table_); };
+  }
+
+  // Runs 'options' as scenario 'name', calling 'action' concurrently if set, and reports it.
+  // 'extra_fields' are added to the report, e.g. the duration of the recovery from a failure.
+  void RunScenario(const std::string& name, const WorkloadOptions& options,
+                   const std::function<void()>& action = nullptr,
+                   const std::vector<std::pair<std::string, int64_t>>* extra_fields = nullptr) {
+    ServerMetricsSnapshot before;
+    ASSERT_OK(SnapshotServerMetrics(name + "-before", &before));
+
+    Workload workload(options, SessionCreator());
+    Status run_status;
+    const MonoTime start = MonoTime::Now();
+    std::thread run_thread([&workload, &run_status] { run_status = workload.Run(); });
+    if (action) {
+      action();
+    }
+    run_thread.join();
+    const MonoDelta elapsed = MonoTime::Now() - start;
+    ASSERT_OK(run_status);
+
+    ServerMetricsSnapshot after;
+    ASSERT_OK(SnapshotServerMetrics(name + "-after", &after));
+    Report(name, workload, elapsed, before, after, extra_fields);
+  }
+
+  // Reads the reported metrics of the running tablet servers, and saves all their metrics to
+  // FLAGS_cluster_perf_metrics_dir if set.
+  CHECKED_STATUS SnapshotServerMetrics(const std::string& snapshot_name,
+                                       ServerMetricsSnapshot* snapshot) {
+    for (int i = 0; i != external_mini_cluster()->num_tablet_servers(); ++i) {
+      ExternalTabletServer* ts = external_mini_cluster()->tablet_server(i);
+      if (ts->IsShutdown()) {
+        continue;
+      }
+      auto& values = (*snapshot)[i];
+      for (size_t m = 0; m != kNumReportedServerMetrics; ++m) {
+        RETURN_NOT_OK(ts->GetInt64Metric(&METRIC_ENTITY_server, "yb.tabletserver",
+                                         kReportedServerMetrics[m], "total_count",
+                                         &values.total_count[m]));
+        RETURN_NOT_OK(ts->GetInt64Metric(&METRIC_ENTITY_server, "yb.tabletserver",
+                                         kReportedServerMetrics[m], "total_sum",
+                                         &values.total_sum[m]));
+      }
+      if (!FLAGS_cluster_perf_metrics_dir.empty()) {
+        EasyCurl curl;
+        faststring metrics;
+        RETURN_NOT_OK(curl.FetchURL(
+            Format("http://$0/jsonmetricz", ts->bound_http_hostport().ToString()), &metrics));
+        RETURN_NOT_OK(WriteStringToFile(
+            Env::Default(), metrics,
+            JoinPathSegments(FLAGS_cluster_perf_metrics_dir,
+                             Format("$0-ts$1.json", snapshot_name, i))));
+      }
+    }
+    return Status::OK();
+  }
+
+  void Report(const std::string& name, const Workload& workload, const MonoDelta& elapsed,
+              const ServerMetricsSnapshot& before, const ServerMetricsSnapshot& after,
+              const std::vector<std::pair<std::string, int64_t>>* extra_fields) {
+    std::stringstream out;
+    JsonWriter writer(&out, JsonWriter::COMPACT);
+    writer.StartObject();
+    writer.String("scenario");
+    writer.String(name);
+    writer.String("elapsed_us");
+    writer.Int64(elapsed.ToMicroseconds());
+
+    int64_t total_ops = 0;
+    int64_t total_errors = 0;
+    writer.String("ops");
+    writer.StartObject();
+    for (size_t i = 0; i != kNumWorkloadOpTypes; ++i) {
+      const auto type = static_cast<WorkloadOpType>(i);
+      const HdrHistogram& latency = workload.latency_histogram(type);
+      const int64_t errors = workload.num_errors(type);
+      if (latency.TotalCount() == 0 && errors == 0) {
+        continue;
+      }
+      total_ops += latency.TotalCount();
+      total_errors += errors;
+      writer.String(WorkloadOpTypeName(type));
+      writer.StartObject();
+      writer.String("count");
+      writer.Int64(latency.TotalCount());
+      writer.String("errors");
+      writer.Int64(errors);
+      writer.String("mean_us");
+      writer.Double(latency.MeanValue());
+      for (const auto& percentile : {std::make_pair("p50_us", 50.0),
+                                     std::make_pair("p99_us", 99.0),
+                                     std::make_pair("p999_us", 99.9)}) {
+        writer.String(percentile.first);
+        writer.Int64(latency.ValueAtPercentile(percentile.second));
+      }
+      writer.String("max_us");
+      writer.Int64(latency.MaxValue());
+      writer.EndObject();
+    }
+    writer.EndObject();
+    writer.String("total_ops");
+    writer.Int64(total_ops);
+    writer.String("total_errors");
+    writer.Int64(total_errors);
+    writer.String("ops_per_sec");
+    writer.Double(total_ops / std::max(elapsed.ToSeconds(), 1e-9));
+
+    // Server side counts and mean latencies over the scenario, of the servers that were running
+    // both before and after it.
+    writer.String("server_metrics");
+    writer.StartObject();
+    for (size_t m = 0; m != kNumReportedServerMetrics; ++m) {
+      int64_t count = 0;
+      int64_t sum = 0;
+      for (const auto& ts_and_values : after) {
+        auto it = before.find(ts_and_values.first);
+        if (it != before.end()) {
+          count += ts_and_values.second.total_count[m] - it->second.total_count[m];
+          sum += ts_and_values.second.total_sum[m] - it->second.total_sum[m];
+        }
+      }
+      writer.String(kReportedServerMetrics[m]->name());
+      writer.StartObject();
+      writer.String("count");
+      writer.Int64(count);
+      writer.String("mean_us");
+      writer.Double(count > 0 ? static_cast<double>(sum) / count : 0);
+      writer.EndObject();
+    }
+    writer.EndObject();
+
+    if (extra_fields) {
+      for (const auto& field : *extra_fields) {
+        writer.String(field.first);
+        writer.Int64(field.second);
+      }
+    }
+    writer.EndObject();
+
+    LOG(INFO) << "Cluster perf report: " << out.str();
+    LOG(INFO) << "Latency distributions of " << name << ":\n" << workload.PercentileDistributions();
+    if (!FLAGS_cluster_perf_report_file.empty()) {
+      std::ofstream report_file(FLAGS_cluster_perf_report_file, std::ios::app);
+      report_file << out.str() << std::endl;
+    }
+  }
+
+  // Returns true once every tablet of the table has num_replicas() replicas outside of the
+  // tablet server with 'dead_uuid'.
+  Result<bool> IsReplicatedWithout(const std::string& dead_uuid) {
+    google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+    RETURN_NOT_OK(client_->GetTablets(table_name(), 0, &tablets));
+    for (const auto& tablet : tablets) {
+      int live_replicas = 0;
+      for (const auto& replica : tablet.replicas()) {
+        if (replica.ts_info().permanent_uuid() != dead_uuid) {
+          ++live_replicas;
+        }
+      }
+      if (live_replicas < num_replicas()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static constexpr int kFollowerFailedSec = 10;
+};
+
+constexpr int ClusterPerfITest::kFollowerFailedSec;
+
+TEST_F(ClusterPerfITest, BulkLoad) {
+  auto options = MakeOptions("insert=1");
+  options.num_ops = FLAGS_cluster_perf_num_keys;
+  // Bulk load is always measured at full speed.
+  options.target_ops_per_sec = 0;
+  ASSERT_NO_FATALS(RunScenario("bulk_load", options));
+}
+
+TEST_F(ClusterPerfITest, SteadyMixedLoad) {
+  ASSERT_NO_FATALS(LoadKeys());
+  ASSERT_NO_FATALS(RunScenario("steady_mixed_load",
+                               MakeTimedOptions("read=50,update=40,insert=5,scan=5")));
+}
+
+TEST_F(ClusterPerfITest, NodeKillAndReReplication) {
+  ASSERT_NO_FATALS(LoadKeys());
+  auto options = MakeTimedOptions("read=50,update=50");
+  // Leave time for the failure to be detected and the replicas to be rebuilt under load.
+  options.duration = MonoDelta::FromSeconds(
+      std::max(FLAGS_cluster_perf_duration_sec, kFollowerFailedSec * 3));
+
+  std::vector<std::pair<std::string, int64_t>> extra_fields;
+  Status recovery_status;
+  auto kill_and_wait = [this, &options, &extra_fields, &recovery_status] {
+    SleepFor(MonoDelta::FromSeconds(options.duration.ToSeconds() / 4));
+    ExternalTabletServer* victim = external_mini_cluster()->tablet_server(0);
+    const std::string victim_uuid = victim->uuid();
+    LOG(INFO) << "Killing tablet server " << victim_uuid;
+    const MonoTime killed_at = MonoTime::Now();
+    victim->Shutdown();
+    recovery_status = WaitFor(
+        std::bind(&ClusterPerfITest::IsReplicatedWithout, this, victim_uuid),
+        options.duration, "Tablets re-replicated");
+    extra_fields.emplace_back("re_replication_us", (MonoTime::Now() - killed_at).ToMicroseconds());
+  };
+  ASSERT_NO_FATALS(RunScenario("node_kill", options, kill_and_wait, &extra_fields));
+  ASSERT_OK(recovery_status);
+}
+
+TEST_F(ClusterPerfITest, CompactionUnderLoad) {
+  // Small memtables and an eager compaction trigger, so that flushes and compactions run
+  // continuously during the scenario.
+  for (int i = 0; i != external_mini_cluster()->num_tablet_servers(); ++i) {
+    ExternalTabletServer* ts = external_mini_cluster()->tablet_server(i);
+    ts->Shutdown();
+    ts->mutable_flags()->push_back("--memstore_size_mb=1");
+    ts->mutable_flags()->push_back("--rocksdb_level0_file_num_compaction_trigger=2");
+    ASSERT_OK(ts->Restart());
+  }
+  ASSERT_OK(external_mini_cluster()->WaitForTabletServerCount(
+      num_tablet_servers(), MonoDelta::FromSeconds(30)));
+  ASSERT_OK(WaitFor([this]() -> Result<bool> {
+    std::string value;
+    auto status = NewYBWorkloadSession(client_.get(), &table_)->Read("cluster_perf_probe", &value);
+    return status.ok() || status.IsNotFound();
+  }, MonoDelta::FromSeconds(60), "Table serves reads"));
+
+  ASSERT_NO_FATALS(LoadKeys());
+  auto options = MakeTimedOptions("read=30,update=60,insert=10");
+  options.value_size = 256;
+  ASSERT_NO_FATALS(RunScenario("compaction_under_load", options));
+}
+
+}  // namespace integration_tests
+}  // namespace yb
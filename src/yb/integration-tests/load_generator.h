@@ -45,6 +45,10 @@ class MultiThreadedWriter;
 
 std::string FormatHexForLoadTestKey(uint64_t x);
 
+// Connects a client to each of the comma separated Redis proxy addresses.
+void ConfigureRedisSessions(
+    const std::string& redis_server_addresses, vector<shared_ptr<RedisClient>>* clients);
+
 class KeyIndexSet {
  public:
   int NumElements() const;
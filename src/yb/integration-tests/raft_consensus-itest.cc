@@ -497,6 +497,26 @@ TEST_F(RaftConsensusITest, TestInsertAndMutateThroughConsensus) {
   ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * num_iters);
 }
 
+// Checks that batched heartbeats keep the leader of an idle tablet and that writes still work.
+TEST_F(RaftConsensusITest, TestBatchedHeartbeats) {
+  ASSERT_NO_FATALS(BuildAndStart({ "--enable_multi_raft_heartbeat_batcher=true" }));
+
+  TServerDetails* leader = nullptr;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+  const string leader_uuid = leader->uuid();
+
+  // Stay idle for several election timeouts, only heartbeats are sent meanwhile.
+  SleepFor(MonoDelta::FromSeconds(5));
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+  ASSERT_EQ(leader_uuid, leader->uuid());
+
+  InsertTestRowsRemoteThread(0,
+                             FLAGS_client_inserts_per_thread,
+                             FLAGS_client_num_batches_per_thread,
+                             vector<CountDownLatch*>());
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread);
+}
+
 TEST_F(RaftConsensusITest, TestFailedOperation) {
   ASSERT_NO_FATALS(BuildAndStart(vector<string>()));
 
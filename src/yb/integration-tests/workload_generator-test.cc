@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/integration-tests/workload_generator.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace load_generator {
+
+class WorkloadGeneratorTest : public YBTest {
+};
+
+TEST_F(WorkloadGeneratorTest, TestParseMix) {
+  auto mix = WorkloadMix::Parse("read=95,update=5");
+  ASSERT_OK(mix.status());
+  ASSERT_EQ(95, mix->weight(WorkloadOpType::kRead));
+  ASSERT_EQ(5, mix->weight(WorkloadOpType::kUpdate));
+  ASSERT_EQ(0, mix->weight(WorkloadOpType::kScan));
+  ASSERT_EQ("read=95,update=5", mix->ToString());
+
+  std::mt19937_64 rng(1);
+  std::map<WorkloadOpType, int> counts;
+  for (int i = 0; i != 10000; ++i) {
+    ++counts[mix->Next(&rng)];
+  }
+  ASSERT_EQ(2U, counts.size());
+  ASSERT_GT(counts[WorkloadOpType::kRead], 9000);
+  ASSERT_GT(counts[WorkloadOpType::kUpdate], 200);
+
+  ASSERT_FALSE(WorkloadMix::Parse("read").ok());
+  ASSERT_FALSE(WorkloadMix::Parse("read=x").ok());
+  ASSERT_FALSE(WorkloadMix::Parse("delete=10").ok());
+  ASSERT_FALSE(WorkloadMix::Parse("read=0").ok());
+}
+
+TEST_F(WorkloadGeneratorTest, TestZipfian) {
+  constexpr int64_t kNumKeys = 1000;
+  constexpr int kNumSamples = 100000;
+  ZipfianGenerator zipfian;
+  std::mt19937_64 rng(1);
+  std::vector<int> counts(kNumKeys);
+  for (int i = 0; i != kNumSamples; ++i) {
+    const int64_t key = zipfian.Next(kNumKeys, &rng);
+    ASSERT_GE(key, 0);
+    ASSERT_LT(key, kNumKeys);
+    ++counts[key];
+  }
+  // With theta 0.99 the hottest key gets about 13% of the accesses over 1000 keys, and the
+  // popularity drops roughly as 1/rank.
+  ASSERT_GT(counts[0], kNumSamples / 10);
+  ASSERT_GT(counts[0], counts[1]);
+  ASSERT_GT(counts[1], counts[10]);
+  ASSERT_GT(counts[10], counts[500]);
+
+  // The key space can grow between samples.
+  for (int64_t n = 1; n != 100; ++n) {
+    ASSERT_LT(zipfian.Next(n, &rng), n);
+  }
+}
+
+TEST_F(WorkloadGeneratorTest, TestLatestDistribution) {
+  auto distribution = KeyDistribution::Create("latest");
+  ASSERT_OK(distribution.status());
+  std::mt19937_64 rng(1);
+  int most_recent = 0;
+  for (int i = 0; i != 10000; ++i) {
+    if ((*distribution)->Next(1000, &rng) == 999) {
+      ++most_recent;
+    }
+  }
+  ASSERT_GT(most_recent, 1000);
+  ASSERT_FALSE(KeyDistribution::Create("gaussian").ok());
+}
+
+}  // namespace load_generator
+}  // namespace yb
@@ -0,0 +1,598 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/integration-tests/workload_generator.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <cpp_redis/cpp_redis>
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
+#include "yb/common/ql_protocol_util.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/substitute.h"
+#include "yb/integration-tests/load_generator.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/enums.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+
+using namespace std::literals;
+
+using strings::Substitute;
+
+namespace yb {
+namespace load_generator {
+
+namespace {
+
+// Latencies above this many microseconds are clamped.
+constexpr uint64_t kMaxLatencyMicros = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+const WorkloadOpType kAllWorkloadOpTypes[] = {
+    WorkloadOpType::kRead,
+    WorkloadOpType::kUpdate,
+    WorkloadOpType::kInsert,
+    WorkloadOpType::kScan,
+    WorkloadOpType::kReadModifyWrite,
+};
+
+uint64_t FnvHash64(uint64_t value) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int i = 0; i != 8; ++i) {
+    hash ^= value & 0xff;
+    hash *= 0x100000001b3ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+class UniformKeyDistribution : public KeyDistribution {
+ public:
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng) override {
+    return std::uniform_int_distribution<int64_t>(0, num_keys - 1)(*rng);
+  }
+};
+
+// The popular keys are scattered over the key space by hashing the Zipfian rank, like the
+// "scrambled Zipfian" distribution of YCSB, so that they don't all land on the same tablet.
+class ZipfianKeyDistribution : public KeyDistribution {
+ public:
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng) override {
+    return FnvHash64(zipfian_.Next(num_keys, rng)) % num_keys;
+  }
+
+ private:
+  ZipfianGenerator zipfian_;
+};
+
+class LatestKeyDistribution : public KeyDistribution {
+ public:
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng) override {
+    return num_keys - 1 - zipfian_.Next(num_keys, rng);
+  }
+
+ private:
+  ZipfianGenerator zipfian_;
+};
+
+class YBWorkloadSession : public WorkloadSession {
+ public:
+  YBWorkloadSession(client::YBClient* client, client::TableHandle* table)
+      : table_(table), session_(client->NewSession()) {
+    CHECK_OK(session_->SetFlushMode(client::YBSession::FlushMode::MANUAL_FLUSH));
+    session_->SetTimeout(60s);
+  }
+
+  ~YBWorkloadSession() {
+    WARN_NOT_OK(session_->Close(), "Failed to close session");
+  }
+
+  CHECKED_STATUS Read(const std::string& key, std::string* value) override {
+    auto op = table_->NewReadOp();
+    QLAddStringHashValue(op->mutable_request(), key);
+    table_->AddColumns({"v"}, op->mutable_request());
+    RETURN_NOT_OK(Execute(op));
+    auto row_block = op->MakeRowBlock();
+    RETURN_NOT_OK(row_block);
+    if (row_block->row_count() == 0) {
+      return STATUS_FORMAT(NotFound, "No row for key $0", key);
+    }
+    *value = row_block->rows()[0].column(0).binary_value();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Write(const std::string& key, const std::string& value) override {
+    auto op = table_->NewInsertOp();
+    QLAddStringHashValue(op->mutable_request(), key);
+    table_->AddStringColumnValue(op->mutable_request(), "v", value);
+    return Execute(op);
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int num_rows) override {
+    // Rows are ordered by the hash of their key, so the scan starts at a hash code derived from
+    // the key rather than at the key itself, like a token range scan in CQL.
+    auto op = table_->NewReadOp();
+    op->mutable_request()->set_hash_code(std::hash<std::string>()(start_key) & 0xffff);
+    op->mutable_request()->set_limit(num_rows);
+    table_->AddColumns({"k", "v"}, op->mutable_request());
+    RETURN_NOT_OK(Execute(op));
+    return op->MakeRowBlock().status();
+  }
+
+ private:
+  template <class Op>
+  CHECKED_STATUS Execute(const std::shared_ptr<Op>& op) {
+    RETURN_NOT_OK(session_->Apply(op));
+    RETURN_NOT_OK(session_->Flush());
+    if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+      return STATUS_FORMAT(RuntimeError, "$0 failed: $1", op->ToString(),
+                           op->response().error_message());
+    }
+    return Status::OK();
+  }
+
+  client::TableHandle* const table_;
+  const std::shared_ptr<client::YBSession> session_;
+};
+
+class RedisWorkloadSession : public WorkloadSession {
+ public:
+  explicit RedisWorkloadSession(const std::string& redis_server_addresses) {
+    ConfigureRedisSessions(redis_server_addresses, &clients_);
+    CHECK(!clients_.empty()) << "No redis server addresses";
+  }
+
+  ~RedisWorkloadSession() {
+    for (const auto& client : clients_) {
+      client->disconnect();
+    }
+  }
+
+  CHECKED_STATUS Read(const std::string& key, std::string* value) override {
+    Status status;
+    auto& client = Client(key);
+    client.get(key, [&status, &key, value](RedisReply& reply) {
+      if (reply.is_error()) {
+        status = STATUS_FORMAT(RuntimeError, "GET $0 failed: $1", key, reply.as_string());
+      } else if (reply.is_null()) {
+        status = STATUS_FORMAT(NotFound, "No value for key $0", key);
+      } else {
+        *value = reply.as_string();
+      }
+    });
+    client.sync_commit();
+    return status;
+  }
+
+  CHECKED_STATUS Write(const std::string& key, const std::string& value) override {
+    Status status;
+    auto& client = Client(key);
+    client.set(key, value, [&status, &key](RedisReply& reply) {
+      if (reply.is_error() || reply.as_string() != "OK") {
+        status = STATUS_FORMAT(RuntimeError, "SET $0 failed: $1", key, reply.as_string());
+      }
+    });
+    client.sync_commit();
+    return status;
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int num_rows) override {
+    return STATUS(NotSupported, "Scans are not supported by the Redis front end");
+  }
+
+ private:
+  RedisClient& Client(const std::string& key) {
+    return *clients_[std::hash<std::string>()(key) % clients_.size()];
+  }
+
+  std::vector<std::shared_ptr<RedisClient>> clients_;
+};
+
+} // namespace
+
+const char* WorkloadOpTypeName(WorkloadOpType type) {
+  switch (type) {
+    case WorkloadOpType::kRead: return "read";
+    case WorkloadOpType::kUpdate: return "update";
+    case WorkloadOpType::kInsert: return "insert";
+    case WorkloadOpType::kScan: return "scan";
+    case WorkloadOpType::kReadModifyWrite: return "rmw";
+  }
+  FATAL_INVALID_ENUM_VALUE(WorkloadOpType, type);
+}
+
+// ------------------------------------------------------------------------------------------------
+// WorkloadMix
+// ------------------------------------------------------------------------------------------------
+
+Result<WorkloadMix> WorkloadMix::Parse(const std::string& spec) {
+  WorkloadMix result;
+  std::vector<std::string> entries;
+  SplitStringUsing(spec, ",", &entries);
+  for (const auto& entry : entries) {
+    std::vector<std::string> name_and_weight = strings::Split(entry, "=");
+    uint64_t weight = 0;
+    if (name_and_weight.size() != 2 || !safe_strtou64(name_and_weight[1], &weight)) {
+      return STATUS_FORMAT(InvalidArgument, "Invalid workload mix entry '$0' in '$1', expected "
+                           "<op>=<weight>", entry, spec);
+    }
+    bool found = false;
+    for (auto type : kAllWorkloadOpTypes) {
+      if (name_and_weight[0] == WorkloadOpTypeName(type)) {
+        result.weights_[static_cast<size_t>(type)] += weight;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return STATUS_FORMAT(InvalidArgument, "Unknown workload op '$0' in '$1', expected one of "
+                           "read, update, insert, scan, rmw", name_and_weight[0], spec);
+    }
+    result.total_weight_ += weight;
+  }
+  if (result.total_weight_ == 0) {
+    return STATUS_FORMAT(InvalidArgument, "Workload mix '$0' has no ops", spec);
+  }
+  return result;
+}
+
+WorkloadOpType WorkloadMix::Next(std::mt19937_64* rng) const {
+  uint64_t value = std::uniform_int_distribution<uint64_t>(0, total_weight_ - 1)(*rng);
+  for (auto type : kAllWorkloadOpTypes) {
+    const uint64_t type_weight = weight(type);
+    if (value < type_weight) {
+      return type;
+    }
+    value -= type_weight;
+  }
+  LOG(FATAL) << "Workload op not found for " << value << " in " << ToString();
+  return WorkloadOpType::kRead;
+}
+
+std::string WorkloadMix::ToString() const {
+  std::vector<std::string> entries;
+  for (auto type : kAllWorkloadOpTypes) {
+    if (weight(type) != 0) {
+      entries.push_back(Substitute("$0=$1", WorkloadOpTypeName(type), weight(type)));
+    }
+  }
+  return JoinStrings(entries, ",");
+}
+
+// ------------------------------------------------------------------------------------------------
+// Key distributions
+// ------------------------------------------------------------------------------------------------
+
+constexpr double ZipfianGenerator::kDefaultTheta;
+
+ZipfianGenerator::ZipfianGenerator(double theta)
+    : theta_(theta), alpha_(1 / (1 - theta)), zeta2_(1 + std::pow(0.5, theta)) {
+}
+
+int64_t ZipfianGenerator::Next(int64_t n, std::mt19937_64* rng) {
+  if (n != n_) {
+    if (n < n_) {
+      n_ = 0;
+      zeta_n_ = 0;
+    }
+    for (int64_t i = n_ + 1; i <= n; ++i) {
+      zeta_n_ += 1 / std::pow(i, theta_);
+    }
+    n_ = n;
+    eta_ = (1 - std::pow(2.0 / n, 1 - theta_)) / (1 - zeta2_ / zeta_n_);
+  }
+
+  const double u = std::uniform_real_distribution<double>()(*rng);
+  const double uz = u * zeta_n_;
+  if (uz < 1) {
+    return 0;
+  }
+  if (uz < zeta2_) {
+    return std::min<int64_t>(1, n - 1);
+  }
+  return std::min<int64_t>(n * std::pow(eta_ * u - eta_ + 1, alpha_), n - 1);
+}
+
+Result<std::unique_ptr<KeyDistribution>> KeyDistribution::Create(const std::string& name) {
+  if (name == "uniform") {
+    return std::unique_ptr<KeyDistribution>(new UniformKeyDistribution());
+  }
+  if (name == "zipfian") {
+    return std::unique_ptr<KeyDistribution>(new ZipfianKeyDistribution());
+  }
+  if (name == "latest") {
+    return std::unique_ptr<KeyDistribution>(new LatestKeyDistribution());
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution '$0', expected one of "
+                       "uniform, zipfian, latest", name);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Front ends
+// ------------------------------------------------------------------------------------------------
+
+std::unique_ptr<WorkloadSession> NewYBWorkloadSession(client::YBClient* client,
+                                                      client::TableHandle* table) {
+  return std::unique_ptr<WorkloadSession>(new YBWorkloadSession(client, table));
+}
+
+std::unique_ptr<WorkloadSession> NewRedisWorkloadSession(
+    const std::string& redis_server_addresses) {
+  return std::unique_ptr<WorkloadSession>(new RedisWorkloadSession(redis_server_addresses));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Workload
+// ------------------------------------------------------------------------------------------------
+
+Workload::Workload(const WorkloadOptions& options, SessionCreator session_creator)
+    : options_(options), session_creator_(std::move(session_creator)) {
+  for (auto& stats : stats_) {
+    stats.latency.reset(new HdrHistogram(kMaxLatencyMicros, kLatencySignificantDigits));
+  }
+}
+
+Workload::~Workload() {
+}
+
+std::string Workload::KeyByIndex(int64_t key_index) const {
+  // The same format as the keys of MultiThreadedAction, so that the workload can run over the
+  // rows written by the writer of the load tester.
+  const std::string key_index_str = Substitute("key$0", key_index);
+  return Substitute(
+      "$0_$1_$2", FormatHexForLoadTestKey(std::hash<std::string>()(key_index_str)),
+      key_index_str, options_.client_id);
+}
+
+std::string Workload::RandomValue(std::mt19937_64* rng) const {
+  static const char kChars[] = "0123456789abcdef";
+  std::string value(options_.value_size, '0');
+  for (auto& c : value) {
+    c = kChars[(*rng)() & 0xf];
+  }
+  return value;
+}
+
+Status Workload::Run() {
+  if (options_.mix.weight(WorkloadOpType::kInsert) == 0 && options_.num_initial_keys == 0) {
+    return STATUS(InvalidArgument, "A workload without inserts needs initial keys");
+  }
+  RETURN_NOT_OK(KeyDistribution::Create(options_.key_distribution).status());
+
+  if (options_.load_initial_keys) {
+    stop_requested_ = false;
+    RunThreads(&Workload::LoadThread, "load");
+    if (num_keys_.load() != options_.num_initial_keys) {
+      return STATUS_FORMAT(IllegalState, "Only loaded $0 of $1 initial keys",
+                           num_keys_.load(), options_.num_initial_keys);
+    }
+  }
+  num_keys_ = options_.num_initial_keys;
+  next_insert_key_ = options_.num_initial_keys;
+
+  LOG(INFO) << "Running workload " << options_.mix.ToString() << " over "
+            << options_.key_distribution << " keys with " << options_.num_threads << " threads"
+            << (options_.target_ops_per_sec > 0
+                    ? Format(" at $0 ops/sec", options_.target_ops_per_sec) : "");
+  stop_requested_ = false;
+  deadline_ = options_.num_ops > 0 ? MonoTime::Max() : MonoTime::Now() + options_.duration;
+  RunThreads(&Workload::RunThread, "run");
+  LOG(INFO) << "Workload done:\n" << Summary();
+  return Status::OK();
+}
+
+void Workload::RunThreads(void (Workload::*thread_function)(int), const char* phase) {
+  ops_started_ = 0;
+  ops_done_ = 0;
+  CountDownLatch running_threads(options_.num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != options_.num_threads; ++i) {
+    threads.emplace_back([this, thread_function, i, &running_threads] {
+      (this->*thread_function)(i);
+      running_threads.CountDown();
+    });
+  }
+
+  int64_t last_ops_done = 0;
+  MonoTime last_report = MonoTime::Now();
+  while (!running_threads.WaitFor(options_.report_interval)) {
+    const MonoTime now = MonoTime::Now();
+    const int64_t ops_done = ops_done_.load();
+    LOG(INFO) << phase << ": " << ops_done << " ops done, "
+              << (ops_done - last_ops_done) / (now - last_report).ToSeconds() << " ops/sec";
+    last_ops_done = ops_done;
+    last_report = now;
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void Workload::AcknowledgeInsert(int64_t key_index) {
+  std::lock_guard<std::mutex> lock(insert_mutex_);
+  acknowledged_inserts_.insert(key_index);
+  int64_t num_keys = num_keys_.load(std::memory_order_relaxed);
+  while (!acknowledged_inserts_.empty() && *acknowledged_inserts_.begin() == num_keys) {
+    acknowledged_inserts_.erase(acknowledged_inserts_.begin());
+    ++num_keys;
+  }
+  num_keys_.store(num_keys, std::memory_order_release);
+}
+
+bool Workload::ShouldStop(int64_t* op_index) {
+  if (stop_requested_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  *op_index = ops_started_.fetch_add(1, std::memory_order_relaxed);
+  if (options_.num_ops > 0) {
+    return *op_index >= options_.num_ops;
+  }
+  return MonoTime::Now() >= deadline_;
+}
+
+void Workload::LoadThread(int thread_index) {
+  auto session = session_creator_();
+  std::mt19937_64 rng(thread_index);
+  for (;;) {
+    const int64_t key_index = next_insert_key_.fetch_add(1, std::memory_order_relaxed);
+    if (key_index >= options_.num_initial_keys || stop_requested_.load()) {
+      break;
+    }
+    Status status = session->Write(KeyByIndex(key_index), RandomValue(&rng));
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to load key #" << key_index << ": " << status;
+      Stop();
+      break;
+    }
+    AcknowledgeInsert(key_index);
+    ops_done_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Workload::RunThread(int thread_index) {
+  auto session = session_creator_();
+  auto key_distribution_result = KeyDistribution::Create(options_.key_distribution);
+  CHECK_OK(key_distribution_result);
+  auto key_distribution = std::move(*key_distribution_result);
+  std::mt19937_64 rng(thread_index + 1);
+
+  // In open loop mode every thread starts its operations on a fixed schedule, staggered with the
+  // other threads, whether or not the previous operation has completed on time.
+  const bool open_loop = options_.target_ops_per_sec > 0;
+  const MonoDelta interval = MonoDelta::FromNanoseconds(
+      open_loop ? options_.num_threads * 1e9 / options_.target_ops_per_sec : 0);
+  MonoTime intended_start = MonoTime::Now() + MonoDelta::FromNanoseconds(
+      interval.ToNanoseconds() * thread_index / options_.num_threads);
+
+  int64_t op_index = 0;
+  while (!ShouldStop(&op_index)) {
+    if (open_loop) {
+      const MonoTime now = MonoTime::Now();
+      if (intended_start > now) {
+        SleepFor(intended_start - now);
+      }
+    } else {
+      intended_start = MonoTime::Now();
+    }
+
+    const WorkloadOpType type = options_.mix.Next(&rng);
+    Status status = RunOp(type, session.get(), key_distribution.get(), &rng);
+    OpStats& stats = stats_[static_cast<size_t>(type)];
+    if (status.ok()) {
+      const int64_t latency_micros = (MonoTime::Now() - intended_start).ToMicroseconds();
+      stats.latency->Increment(
+          std::min<int64_t>(std::max<int64_t>(latency_micros, 0), kMaxLatencyMicros));
+    } else {
+      YB_LOG_EVERY_N_SECS(WARNING, 5) << WorkloadOpTypeName(type) << " failed: " << status;
+      stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    ops_done_.fetch_add(1, std::memory_order_relaxed);
+
+    if (open_loop) {
+      intended_start += interval;
+    }
+  }
+}
+
+Status Workload::RunOp(WorkloadOpType type, WorkloadSession* session,
+                       KeyDistribution* key_distribution, std::mt19937_64* rng) {
+  if (type == WorkloadOpType::kInsert) {
+    const int64_t key_index = next_insert_key_.fetch_add(1, std::memory_order_relaxed);
+    Status status = session->Write(KeyByIndex(key_index), RandomValue(rng));
+    // A failed insert is acknowledged as well, so that later inserts become visible to reads.
+    AcknowledgeInsert(key_index);
+    return status;
+  }
+
+  const int64_t num_keys = num_keys_.load(std::memory_order_acquire);
+  if (num_keys == 0) {
+    return STATUS(IllegalState, "No keys inserted yet");
+  }
+  const std::string key = KeyByIndex(key_distribution->Next(num_keys, rng));
+  std::string value;
+  switch (type) {
+    case WorkloadOpType::kRead:
+      return session->Read(key, &value);
+    case WorkloadOpType::kUpdate:
+      return session->Write(key, RandomValue(rng));
+    case WorkloadOpType::kScan:
+      return session->Scan(key, options_.scan_length);
+    case WorkloadOpType::kReadModifyWrite:
+      RETURN_NOT_OK(session->Read(key, &value));
+      std::reverse(value.begin(), value.end());
+      return session->Write(key, value);
+    case WorkloadOpType::kInsert:
+      break;
+  }
+  FATAL_INVALID_ENUM_VALUE(WorkloadOpType, type);
+}
+
+std::string Workload::Summary() const {
+  std::stringstream out;
+  for (auto type : kAllWorkloadOpTypes) {
+    const HdrHistogram& latency = latency_histogram(type);
+    const int64_t errors = num_errors(type);
+    if (latency.TotalCount() == 0 && errors == 0) {
+      continue;
+    }
+    out << Substitute("$0: count=$1 errors=$2 mean_us=$3 p50_us=$4 p90_us=$5 p99_us=$6 "
+                      "p99.9_us=$7 max_us=$8\n",
+                      WorkloadOpTypeName(type), latency.TotalCount(), errors,
+                      latency.MeanValue(), latency.ValueAtPercentile(50),
+                      latency.ValueAtPercentile(90), latency.ValueAtPercentile(99),
+                      latency.ValueAtPercentile(99.9), latency.MaxValue());
+  }
+  return out.str();
+}
+
+std::string Workload::PercentileDistributions() const {
+  std::stringstream out;
+  for (auto type : kAllWorkloadOpTypes) {
+    const HdrHistogram& latency = latency_histogram(type);
+    if (latency.TotalCount() == 0) {
+      continue;
+    }
+    out << "# " << WorkloadOpTypeName(type) << " latency (us)\n";
+    out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+    PercentileIterator iter(&latency, /* percentile_ticks_per_half_distance = */ 5);
+    HistogramIterationValue value;
+    while (iter.HasNext()) {
+      if (!iter.Next(&value).ok()) {
+        break;
+      }
+      const double fraction = value.percentile_level_iterated_to / 100;
+      out << StringPrintf("%12" PRIu64 " %14.12f %10" PRIu64 " %14.2f\n",
+                          value.value_iterated_to, fraction, value.total_count_to_this_value,
+                          fraction < 1 ? 1 / (1 - fraction) : 0.0);
+    }
+    out << Substitute("#[Mean = $0, Max = $1, Total count = $2]\n\n",
+                      latency.MeanValue(), latency.MaxValue(), latency.TotalCount());
+  }
+  return out.str();
+}
+
+}  // namespace load_generator
+}  // namespace yb
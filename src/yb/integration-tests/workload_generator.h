@@ -0,0 +1,224 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// A YCSB-style workload engine: a mix of reads, updates, inserts, scans and read-modify-writes
+// over keys picked from a configurable distribution, run either as fast as possible (closed loop)
+// or at a target rate (open loop), with latency histograms per operation type.
+
+#ifndef YB_INTEGRATION_TESTS_WORKLOAD_GENERATOR_H
+#define YB_INTEGRATION_TESTS_WORKLOAD_GENERATOR_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+
+#include "yb/client/client_fwd.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace load_generator {
+
+enum class WorkloadOpType {
+  kRead,
+  kUpdate,
+  kInsert,
+  kScan,
+  kReadModifyWrite,
+};
+
+constexpr size_t kNumWorkloadOpTypes = static_cast<size_t>(WorkloadOpType::kReadModifyWrite) + 1;
+
+// The name of the operation type as used in workload mix specifications, e.g. "rmw".
+const char* WorkloadOpTypeName(WorkloadOpType type);
+
+// Relative weights of the operation types of a workload.
+class WorkloadMix {
+ public:
+  // Parses a comma separated list of <op>=<weight>, e.g. "read=95,update=5" for YCSB workload B.
+  // Ops are read, update, insert, scan and rmw.
+  static Result<WorkloadMix> Parse(const std::string& spec);
+
+  // Picks the type of the next operation.
+  WorkloadOpType Next(std::mt19937_64* rng) const;
+
+  uint64_t weight(WorkloadOpType type) const { return weights_[static_cast<size_t>(type)]; }
+
+  std::string ToString() const;
+
+ private:
+  std::array<uint64_t, kNumWorkloadOpTypes> weights_{};
+  uint64_t total_weight_ = 0;
+};
+
+// Picks the index of the key of the next operation among the num_keys keys inserted so far.
+// Not thread safe, every worker thread has its own.
+class KeyDistribution {
+ public:
+  virtual ~KeyDistribution() {}
+
+  // Returns an index in [0, num_keys), num_keys must be positive.
+  virtual int64_t Next(int64_t num_keys, std::mt19937_64* rng) = 0;
+
+  // Creates one of the following distributions:
+  //   uniform - all keys are equally likely.
+  //   zipfian - a few keys are much hotter than others, with the hot keys spread over the key
+  //             space.
+  //   latest  - zipfian, with the most recently inserted keys being the hottest.
+  static Result<std::unique_ptr<KeyDistribution>> Create(const std::string& name);
+};
+
+// Generates a Zipfian distribution over [0, n) with item 0 the most popular, using the algorithm
+// from Gray et al, "Quickly Generating Billion-Record Synthetic Databases", like YCSB. The zeta
+// constant is extended incrementally when n grows, so that n can follow the number of inserted
+// keys.
+class ZipfianGenerator {
+ public:
+  explicit ZipfianGenerator(double theta = kDefaultTheta);
+
+  int64_t Next(int64_t n, std::mt19937_64* rng);
+
+  static constexpr double kDefaultTheta = 0.99;
+
+ private:
+  const double theta_;
+  const double alpha_;
+  const double zeta2_;
+  int64_t n_ = 0;
+  double zeta_n_ = 0;
+  double eta_ = 0;
+};
+
+// The data access primitives of one worker thread, implemented by each front end.
+class WorkloadSession {
+ public:
+  virtual ~WorkloadSession() {}
+
+  // Reads the value of 'key'. Returns NotFound if there is none.
+  virtual CHECKED_STATUS Read(const std::string& key, std::string* value) = 0;
+
+  // Sets the value of 'key', whether it exists or not.
+  virtual CHECKED_STATUS Write(const std::string& key, const std::string& value) = 0;
+
+  // Reads up to 'num_rows' rows, starting at a position derived from 'start_key'.
+  virtual CHECKED_STATUS Scan(const std::string& start_key, int num_rows) = 0;
+};
+
+// Sessions over the YQL table API used by the CQL service. The client and table must outlive the
+// session.
+std::unique_ptr<WorkloadSession> NewYBWorkloadSession(client::YBClient* client,
+                                                      client::TableHandle* table);
+
+// Sessions over the Redis protocol, sent to the comma separated list of proxy addresses. Scans are
+// not supported.
+std::unique_ptr<WorkloadSession> NewRedisWorkloadSession(
+    const std::string& redis_server_addresses);
+
+struct WorkloadOptions {
+  WorkloadMix mix;
+  std::string key_distribution = "uniform";
+  int num_threads = 8;
+  // Keys [0, num_initial_keys) are inserted before the measured phase if load_initial_keys is set,
+  // and are otherwise assumed to exist already.
+  int64_t num_initial_keys = 0;
+  bool load_initial_keys = false;
+  // The measured phase ends after num_ops operations if positive, or after duration otherwise.
+  int64_t num_ops = 0;
+  MonoDelta duration = MonoDelta::FromSeconds(60);
+  // Total rate at which operations are started during the measured phase, 0 to run each thread
+  // as fast as possible.
+  double target_ops_per_sec = 0;
+  int value_size = 16;
+  int scan_length = 100;
+  MonoDelta report_interval = MonoDelta::FromSeconds(10);
+  std::string client_id = "workload";
+};
+
+class Workload {
+ public:
+  typedef std::function<std::unique_ptr<WorkloadSession>()> SessionCreator;
+
+  Workload(const WorkloadOptions& options, SessionCreator session_creator);
+  ~Workload();
+
+  // Runs the optional load phase and the measured phase, blocking until they are over.
+  CHECKED_STATUS Run();
+
+  // Requests the running phase to stop early.
+  void Stop() { stop_requested_.store(true, std::memory_order_release); }
+
+  // Latencies of successful operations of the measured phase, in microseconds. In open loop mode
+  // they are measured from the intended start time of the operation, rather than from the time
+  // it was sent, so that a stall is charged to all the operations it delayed.
+  const HdrHistogram& latency_histogram(WorkloadOpType type) const {
+    return *stats_[static_cast<size_t>(type)].latency;
+  }
+
+  int64_t num_errors(WorkloadOpType type) const {
+    return stats_[static_cast<size_t>(type)].errors.load(std::memory_order_relaxed);
+  }
+
+  // Count, errors and latency percentiles of every operation type that was run.
+  std::string Summary() const;
+
+  // Full latency percentile distribution of every operation type that was run, in the text format
+  // of the HdrHistogram tools.
+  std::string PercentileDistributions() const;
+
+  // The key of the given index, the same for every front end.
+  std::string KeyByIndex(int64_t key_index) const;
+
+ private:
+  struct OpStats {
+    std::unique_ptr<HdrHistogram> latency;
+    std::atomic<int64_t> errors{0};
+  };
+
+  void LoadThread(int thread_index);
+  void RunThread(int thread_index);
+  CHECKED_STATUS RunOp(WorkloadOpType type, WorkloadSession* session,
+                       KeyDistribution* key_distribution, std::mt19937_64* rng);
+  std::string RandomValue(std::mt19937_64* rng) const;
+  bool ShouldStop(int64_t* op_index);
+  void AcknowledgeInsert(int64_t key_index);
+  void RunThreads(void (Workload::*thread_function)(int), const char* phase);
+
+  const WorkloadOptions options_;
+  const SessionCreator session_creator_;
+
+  std::array<OpStats, kNumWorkloadOpTypes> stats_;
+
+  // Keys [0, num_keys_) are considered inserted. It's only advanced once all keys before it were
+  // inserted, so reads don't pick keys that are still being inserted.
+  std::atomic<int64_t> num_keys_{0};
+  std::atomic<int64_t> next_insert_key_{0};
+  std::mutex insert_mutex_;
+  // Inserted keys above num_keys_.
+  std::set<int64_t> acknowledged_inserts_;
+  std::atomic<int64_t> ops_started_{0};
+  std::atomic<int64_t> ops_done_{0};
+  std::atomic<bool> stop_requested_{false};
+  MonoTime deadline_;
+};
+
+}  // namespace load_generator
+}  // namespace yb
+
+#endif  // YB_INTEGRATION_TESTS_WORKLOAD_GENERATOR_H
@@ -108,6 +108,9 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs);
     TestNoPlacement();
 
+    PrepareTestState(ts_descs);
+    TestActivityTieBreak();
+
     PrepareTestState(ts_descs);
     TestWithPlacement();
 
@@ -132,12 +135,18 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs);
     TestBalancingLeaders();
 
+    PrepareTestState(ts_descs);
+    TestBalancingLeadersWithAffinitizedZones();
+
     gflags::SetCommandLineOption("leader_balance_threshold", "2");
     PrepareTestState(ts_descs);
     TestBalancingLeadersWithThreshold();
 
     PrepareTestState(ts_descs);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs);
+    TestWithReadReplicas();
   }
 
  protected:
@@ -334,6 +343,28 @@ class TestLoadBalancerBase {
     TestRemoveLoad(tablets_[0]->tablet_id(), "");
   }
 
+  void TestWithReadReplicas() {
+    LOG(INFO) << "Testing with read replicas";
+    cluster_placement_.set_num_replicas(kNumReplicas);
+
+    // Put a read replica of every tablet on a new TS.
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    for (const auto& tablet : tablets_) {
+      AddRunningReplica(tablet.get(), ts_descs_[3]);
+      AddObserver(tablet.get(), ts_descs_[3]);
+    }
+
+    ASSERT_TRUE(AnalyzeTablets());
+
+    // The read replicas neither make the tablets over-replicated nor count as load, and the TS
+    // hosting them cannot get live replicas of the same tablets.
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+    ASSERT_EQ(total_num_tablets_, cb_->get_total_running_tablets());
+    string placeholder;
+    ASSERT_FALSE(cb_->HandleRemoveReplicas(&placeholder, &placeholder));
+    ASSERT_FALSE(cb_->HandleAddReplicas(&placeholder, &placeholder, &placeholder));
+  }
+
   void TestWithMissingPlacement() {
     LOG(INFO) << "Testing with tablet servers missing placement information";
     // Setup cluster level placement to multiple AZs.
@@ -444,6 +475,25 @@ class TestLoadBalancerBase {
     ASSERT_EQ(0, cb_->get_total_over_replication());
   }
 
+  void TestActivityTieBreak() {
+    LOG(INFO) << "Testing tablet servers with the same load and different activity";
+    cluster_placement_.set_num_replicas(kNumReplicas);
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    ts_descs_.push_back(SetupTS("4444", "a"));
+    // ts0 serves many more operations than ts1 and ts2, which have the same number of tablets,
+    // and ts3 stores more data than ts4, which is empty as well.
+    ts_descs_[0]->set_write_ops_per_sec(5 * FLAGS_load_balancer_activity_ops_per_sec_unit);
+    ts_descs_[3]->set_total_sst_file_size(2 * FLAGS_load_balancer_activity_sst_bytes_unit);
+    AnalyzeTablets();
+
+    string placeholder;
+    // Without the activity, replicas would move from ts2 to ts3.
+    TestAddLoad(placeholder, ts_descs_[0]->permanent_uuid(), ts_descs_[4]->permanent_uuid());
+
+    ts_descs_[0]->ClearMetrics();
+    ts_descs_[3]->ClearMetrics();
+  }
+
   void TestWithMissingTabletServers() {
     LOG(INFO) << "Testing with missing tablet servers";
     SetupClusterConfig(/* multi_az = */ false);
@@ -628,6 +678,45 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
   }
 
+  void TestBalancingLeadersWithAffinitizedZones() {
+    LOG(INFO) << "Testing moving leaders into affinitized zones a and b";
+    for (const auto& zone : {"a", "b"}) {
+      CloudInfoPB ci;
+      ci.set_placement_cloud("aws");
+      ci.set_placement_region("us-west-1");
+      ci.set_placement_zone(zone);
+      affinitized_zones_.insert(ci);
+    }
+    LOG(INFO) << "Leader distribution: 2 1 1";
+
+    AnalyzeTablets();
+
+    // The leader in zone c should be moved to the least loaded affinitized server, ts1.
+    string placeholder;
+    string expected_from_ts = ts_descs_[2]->permanent_uuid();
+    string expected_to_ts = ts_descs_[1]->permanent_uuid();
+    TestMoveLeader(&placeholder, expected_from_ts, expected_to_ts);
+    // The leaders are now balanced across the affinitized zones, so nothing should go to ts2.
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    // Move all leaders to ts2.
+    for (const auto tablet : tablets_) {
+      MoveTabletLeader(tablet.get(), ts_descs_[2]);
+    }
+    LOG(INFO) << "Leader distribution: 0 0 4";
+
+    ResetState();
+    AnalyzeTablets();
+
+    // All leaders should be moved off ts2, alternating between ts0 and ts1.
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TestMoveLeader(&placeholder, expected_from_ts, "");
+    }
+    ASSERT_EQ(2, cb_->state_->GetLeaderLoad(ts_descs_[0]->permanent_uuid()));
+    ASSERT_EQ(2, cb_->state_->GetLeaderLoad(ts_descs_[1]->permanent_uuid()));
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -720,6 +809,9 @@ class TestLoadBalancerBase {
     // Reset the tablet map tablets.
     for (const auto tablet : tablets_) {
       tablet_map_[tablet->tablet_id()] = tablet;
+      auto l = tablet->LockForWrite();
+      l->mutable_data()->pb.clear_committed_consensus_state();
+      l->Commit();
     }
 
     // Prepare the replicas.
@@ -831,6 +923,16 @@ class TestLoadBalancerBase {
     tablet->SetReplicaLocations(replicas);
   }
 
+  // Marks the replica on the given TS as a read replica in the committed config of the tablet.
+  void AddObserver(TabletInfo* tablet, std::shared_ptr<TSDescriptor> ts_desc) {
+    auto l = tablet->LockForWrite();
+    auto* peer = l->mutable_data()->pb.mutable_committed_consensus_state()->mutable_config()
+        ->add_peers();
+    peer->set_permanent_uuid(ts_desc->permanent_uuid());
+    peer->set_member_type(consensus::RaftPeerPB::OBSERVER);
+    l->Commit();
+  }
+
   void RemoveReplica(TabletInfo* tablet, std::shared_ptr<TSDescriptor> ts_desc) {
     TabletInfo::ReplicaMap replicas;
     tablet->GetReplicaLocations(&replicas);
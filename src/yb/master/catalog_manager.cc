@@ -783,6 +783,7 @@ void CatalogManager::LoadSysCatalogDataTask() {
 
   std::lock_guard<simple_spinlock> l(state_lock_);
   leader_ready_term_ = term;
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
   LOG(INFO) << "Completed load of sys catalog in term " << term;
 }
 
@@ -854,39 +855,21 @@ Status CatalogManager::RunLoaders() {
     ts_desc->set_has_tablet_report(false);
   }
 
-  // Visit tables and tablets, load them into memory.
-  LOG(INFO) << __func__ << ": Loading tables into memory.";
-  unique_ptr<TableLoader> table_loader(new TableLoader(this));
+  // Load tables, tablets, namespaces, user-defined types, the cluster configuration and roles into
+  // memory in a single scan of the sys catalog. Tables are visited before their tablets.
+  LOG(INFO) << __func__ << ": Loading sys catalog entries into memory.";
+  TableLoader table_loader(this);
+  TabletLoader tablet_loader(this);
+  NamespaceLoader namespace_loader(this);
+  UDTypeLoader udtype_loader(this);
+  ClusterConfigLoader config_loader(this);
+  RoleLoader role_loader(this);
   RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(table_loader.get()), "Failed while visiting tables in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading tablets into memory.";
-  unique_ptr<TabletLoader> tablet_loader(new TabletLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(tablet_loader.get()), "Failed while visiting tablets in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading namespaces into memory.";
-  unique_ptr<NamespaceLoader> namespace_loader(new NamespaceLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(namespace_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading user-defined types into memory.";
-  unique_ptr<UDTypeLoader> udtype_loader(new UDTypeLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(udtype_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading cluster configuration into memory.";
-  unique_ptr<ClusterConfigLoader> config_loader(new ClusterConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(config_loader.get()), "Failed while visiting config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading roles into memory.";
-  unique_ptr<RoleLoader> role_loader(new RoleLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(role_loader.get()),
-      "Failed while visiting roles in sys catalog");
+      sys_catalog_->Visit({&table_loader, &tablet_loader, &namespace_loader, &udtype_loader,
+                           &config_loader, &role_loader}),
+      "Failed while visiting sys catalog");
+  LOG(INFO) << __func__ << ": Loaded " << table_ids_map_.size() << " tables and "
+            << tablet_map_.size() << " tablets.";
 
   return Status::OK();
 }
@@ -1394,30 +1377,34 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
   PartitionSchema partition_schema;
   std::vector<Partition> partitions;
 
-  std::lock_guard<LockType> l(lock_);
-  TRACE("Acquired catalog manager lock");
-  parent_table_info = FindPtrOrNull(table_ids_map_,
-                                    schema.table_properties().CopartitionTableId());
-  if (parent_table_info == nullptr) {
-    s = STATUS(NotFound, "The table does not exist",
-               schema.table_properties().CopartitionTableId());
-    return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
-  }
-
   scoped_refptr<TableInfo> this_table_info;
   std::vector<TabletInfo *> tablets;
   std::vector<scoped_refptr<TabletInfo>> scoped_ref_tablets;
-  // Verify that the table does not exist.
-  this_table_info = FindPtrOrNull(table_names_map_, {namespace_id, req.name()});
+  {
+    // As in CreateTable, the catalog manager lock is only held while the maps are updated, the
+    // sys catalog writes below are protected by the table and tablet write locks.
+    std::lock_guard<LockType> l(lock_);
+    TRACE("Acquired catalog manager lock");
+    parent_table_info = FindPtrOrNull(table_ids_map_,
+                                      schema.table_properties().CopartitionTableId());
+    if (parent_table_info == nullptr) {
+      s = STATUS(NotFound, "The table does not exist",
+                 schema.table_properties().CopartitionTableId());
+      return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_NOT_FOUND, s);
+    }
 
-  if (this_table_info != nullptr) {
-    s = STATUS(AlreadyPresent, Substitute("Target $0 already exists", object_type),
-               this_table_info->id());
-    return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_ALREADY_PRESENT, s);
-  }
+    // Verify that the table does not exist.
+    this_table_info = FindPtrOrNull(table_names_map_, {namespace_id, req.name()});
 
-  RETURN_NOT_OK(CreateTableInMemory(req, schema, partition_schema, true, namespace_id,
-                                        partitions, nullptr, resp, &this_table_info));
+    if (this_table_info != nullptr) {
+      s = STATUS(AlreadyPresent, Substitute("Target $0 already exists", object_type),
+                 this_table_info->id());
+      return SetupError(resp->mutable_error(), MasterErrorPB::TABLE_ALREADY_PRESENT, s);
+    }
+
+    RETURN_NOT_OK(CreateTableInMemory(req, schema, partition_schema, true, namespace_id,
+                                      partitions, nullptr, resp, &this_table_info));
+  }
 
 
   TRACE("Inserted new table info into CatalogManager maps");
@@ -1459,6 +1446,8 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
   for (TabletInfo *tablet : tablets) {
     tablet->mutable_metadata()->CommitMutation();
   }
+  // The new table is running with the existing tablets.
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
 
   for (const auto& tablet : scoped_ref_tablets) {
     SendCopartitionTabletRequest(tablet, this_table_info);
@@ -1783,7 +1772,12 @@ Status CatalogManager::IsCreateTableDone(const IsCreateTableDoneRequestPB* req,
 
   // 2. Verify if the create is in-progress
   TRACE("Verify if the table creation is in progress for $0", table->ToString());
-  resp->set_done(!table->IsCreateInProgress());
+  int num_tablets = 0;
+  int num_running_tablets = 0;
+  table->GetCreateProgress(&num_tablets, &num_running_tablets);
+  resp->set_num_tablets(num_tablets);
+  resp->set_num_running_tablets(num_running_tablets);
+  resp->set_done(num_running_tablets == num_tablets);
 
   // 3. Set any current errors, if we are experiencing issues creating the table. This will be
   // bubbled up to the MasterService layer. If it is an error, it gets wrapped around in
@@ -1962,8 +1956,11 @@ Status CatalogManager::IsTruncateTableDone(const IsTruncateTableDoneRequestPB* r
 
   // Lookup the truncated table.
   TRACE("Looking up table $0", req->table_id());
-  std::lock_guard<LockType> l_map(lock_);
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table;
+  {
+    boost::shared_lock<LockType> l_map(lock_);
+    table = FindPtrOrNull(table_ids_map_, req->table_id());
+  }
 
   if (table == nullptr) {
     Status s = STATUS(NotFound, "The table does not exist");
@@ -2232,8 +2229,11 @@ Status CatalogManager::IsDeleteTableDone(const IsDeleteTableDoneRequestPB* req,
 
   // Lookup the deleted table.
   TRACE("Looking up table $0", req->table_id());
-  std::lock_guard<LockType> l_map(lock_);
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table;
+  {
+    boost::shared_lock<LockType> l_map(lock_);
+    table = FindPtrOrNull(table_ids_map_, req->table_id());
+  }
 
   if (table == nullptr) {
     LOG(INFO) << "Servicing IsDeleteTableDone request for table id "
@@ -2483,6 +2483,8 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   // Update the in-memory state
   TRACE("Committing in-memory state");
   l->Commit();
+  // The table may have been renamed.
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
 
   SendAlterTableRequest(table);
 
@@ -3031,6 +3033,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     return s;
   }
   tablet_lock->Commit();
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -3529,7 +3532,7 @@ Status CatalogManager::DeleteUDType(const DeleteUDTypeRequestPB* req,
   }
 
   {
-    std::lock_guard<LockType> l(lock_);
+    boost::shared_lock<LockType> l(lock_);
     TRACE("Acquired catalog manager lock");
 
     if (req->type().has_type_id()) {
@@ -4004,6 +4007,7 @@ void CatalogManager::DeleteTabletsAndSendRequests(const scoped_refptr<TableInfo>
     CHECK_OK(sys_catalog_->UpdateItem(tablet.get()));
     tablet_lock->Commit();
   }
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void CatalogManager::SendDeleteTabletRequest(
@@ -4407,7 +4411,7 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
                    tablet->tablet_id()));
   }
 
-  // TODO: update this when we figure out how we want replica selection for async replicas.
+  // The number of voters, the async replicas are selected with their own placement below.
   int nreplicas = table_guard->data().pb.replication_info().live_replicas().num_replicas();
 
   if (ts_descs.size() < nreplicas) {
@@ -4433,84 +4437,144 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
     auto l = cluster_config_->LockForRead();
     replication_info = l->data().pb.replication_info();
   }
-  auto placement_info = replication_info.live_replicas();
 
   // Keep track of servers we've already selected, so that we don't attempt to
   // put two replicas on the same host.
   set<shared_ptr<TSDescriptor>> already_selected_ts;
+  RETURN_NOT_OK(SelectReplicasForPlacement(
+      ts_descs, replication_info.live_replicas(), nreplicas, RaftPeerPB::VOTER, config,
+      &already_selected_ts));
+
+  // Read replicas are added to the raft config as observers: the leader replicates the log to
+  // them asynchronously, they serve the reads that do not need the leader, and they neither vote
+  // nor count toward the majority, so they can be far from the live replicas.
+  PlacementInfoPB async_placement_info = replication_info.async_replicas();
+  if (!replication_info.has_async_replicas()) {
+    auto l = cluster_config_->LockForRead();
+    async_placement_info = l->data().pb.replication_info().async_replicas();
+  }
+  if (async_placement_info.num_replicas() > 0) {
+    RETURN_NOT_OK(SelectReplicasForPlacement(
+        ts_descs, async_placement_info, async_placement_info.num_replicas(),
+        RaftPeerPB::OBSERVER, config, &already_selected_ts));
+  }
+
+  std::ostringstream out;
+  out << Substitute("Initial tserver uuids for tablet $0: ", tablet->tablet_id());
+  for (const RaftPeerPB& peer : config->peers()) {
+    out << peer.permanent_uuid() << " ";
+  }
+  LOG(INFO) << out.str();
+
+  return Status::OK();
+}
+
+Status CatalogManager::SelectReplicasForPlacement(
+    const TSDescriptorVector& ts_descs, const PlacementInfoPB& placement_info, int nreplicas,
+    RaftPeerPB::MemberType member_type, consensus::RaftConfigPB* config,
+    set<shared_ptr<TSDescriptor>>* already_selected_ts) {
+  // Servers that already got a replica of the tablet, e.g. a voter when placing the read
+  // replicas, are not candidates.
+  TSDescriptorVector candidates;
+  for (const auto& ts : ts_descs) {
+    if (!already_selected_ts->count(ts)) {
+      candidates.push_back(ts);
+    }
+  }
+  const size_t num_selected_before = already_selected_ts->size();
+
   if (placement_info.placement_blocks().empty()) {
     // If we don't have placement info, just place the replicas as before, distributed across the
     // whole cluster.
-    SelectReplicas(ts_descs, nreplicas, config, &already_selected_ts);
-  } else {
-    // TODO(bogdan): move to separate function
-    //
-    // If we do have placement info, we'll try to use the same power of two algorithm, but also
-    // match the requested policies. We'll assign the minimum requested replicas in each combination
-    // of cloud.region.zone and then if we still have leftover replicas, we'll assign those
-    // in any of the allowed areas.
-    unordered_map<string, vector<shared_ptr<TSDescriptor>>> allowed_ts_by_pi;
-    vector<shared_ptr<TSDescriptor>> all_allowed_ts;
-
-    // Keep map from ID to PlacementBlockPB, as protos only have repeated, not maps.
-    unordered_map<string, PlacementBlockPB> pb_by_id;
-    for (const auto& pb : placement_info.placement_blocks()) {
-      const auto& cloud_info = pb.cloud_info();
-      string placement_id = TSDescriptor::generate_placement_id(cloud_info);
-      pb_by_id[placement_id] = pb;
+    if (candidates.size() < nreplicas) {
+      return STATUS(InvalidArgument, Substitute(
+          "Not enough tablet servers for $0 $1 replicas, only $2 tablet servers are available",
+          nreplicas, RaftPeerPB::MemberType_Name(member_type), candidates.size()));
     }
+    SelectReplicas(candidates, nreplicas, member_type, config, already_selected_ts);
+    return Status::OK();
+  }
 
-    // Build the sets of allowed TSs.
-    for (const auto& ts : ts_descs) {
-      bool added_to_all = false;
-      for (const auto& pi_entry : pb_by_id) {
-        if (ts->MatchesCloudInfo(pi_entry.second.cloud_info())) {
-          allowed_ts_by_pi[pi_entry.first].push_back(ts);
-
-          if (!added_to_all) {
-            added_to_all = true;
-            all_allowed_ts.push_back(ts);
-          }
+  // If we do have placement info, we'll try to use the same power of two algorithm, but also
+  // match the requested policies. We'll assign the minimum requested replicas in each combination
+  // of cloud.region.zone and then if we still have leftover replicas, we'll assign those
+  // in any of the allowed areas.
+  unordered_map<string, vector<shared_ptr<TSDescriptor>>> allowed_ts_by_pi;
+  vector<shared_ptr<TSDescriptor>> all_allowed_ts;
+  // The allowed TSs for the leftover replicas, which are never witnesses.
+  vector<shared_ptr<TSDescriptor>> leftover_allowed_ts;
+
+  // Keep map from ID to PlacementBlockPB, as protos only have repeated, not maps.
+  unordered_map<string, PlacementBlockPB> pb_by_id;
+  for (const auto& pb : placement_info.placement_blocks()) {
+    const auto& cloud_info = pb.cloud_info();
+    string placement_id = TSDescriptor::generate_placement_id(cloud_info);
+    pb_by_id[placement_id] = pb;
+  }
+
+  // Build the sets of allowed TSs.
+  for (const auto& ts : candidates) {
+    bool added_to_all = false;
+    bool added_to_leftover = false;
+    for (const auto& pi_entry : pb_by_id) {
+      if (ts->MatchesCloudInfo(pi_entry.second.cloud_info())) {
+        allowed_ts_by_pi[pi_entry.first].push_back(ts);
+
+        if (!added_to_all) {
+          added_to_all = true;
+          all_allowed_ts.push_back(ts);
+        }
+        if (!added_to_leftover && !pi_entry.second.witness()) {
+          added_to_leftover = true;
+          leftover_allowed_ts.push_back(ts);
         }
       }
     }
+  }
+
+  // Fail early if we don't have enough tablet servers in the areas requested.
+  if (all_allowed_ts.size() < nreplicas) {
+    return STATUS(InvalidArgument, Substitute(
+        "Not enough tablet servers in the requested placements. Need at least $0, have $1",
+        nreplicas, all_allowed_ts.size()));
+  }
 
-    // Fail early if we don't have enough tablet servers in the areas requested.
-    if (all_allowed_ts.size() < nreplicas) {
+  // Loop through placements and assign to respective available TSs.
+  for (const auto& entry : allowed_ts_by_pi) {
+    const auto& available_ts_descs = entry.second;
+    const auto& num_replicas = pb_by_id[entry.first].min_num_replicas();
+    if (available_ts_descs.size() < num_replicas) {
       return STATUS(InvalidArgument, Substitute(
-          "Not enough tablet servers in the requested placements. Need at least $0, have $1",
-          nreplicas, all_allowed_ts.size()));
-    }
-
-    // Loop through placements and assign to respective available TSs.
-    for (const auto& entry : allowed_ts_by_pi) {
-      const auto& available_ts_descs = entry.second;
-      const auto& num_replicas = pb_by_id[entry.first].min_num_replicas();
-      if (available_ts_descs.size() < num_replicas) {
-        return STATUS(InvalidArgument, Substitute(
-            "Not enough tablet servers in $0. Need at least $1 but only have $2.", entry.first,
-            num_replicas, available_ts_descs.size()));
+          "Not enough tablet servers in $0. Need at least $1 but only have $2.", entry.first,
+          num_replicas, available_ts_descs.size()));
+    }
+    const int first_new_peer = config->peers_size();
+    SelectReplicas(available_ts_descs, num_replicas, member_type, config,
+                   already_selected_ts);
+    if (member_type == RaftPeerPB::VOTER && pb_by_id[entry.first].witness()) {
+      for (int i = first_new_peer; i != config->peers_size(); ++i) {
+        config->mutable_peers(i)->set_is_witness(true);
       }
-      SelectReplicas(available_ts_descs, num_replicas, config, &already_selected_ts);
-    }
-
-    int replicas_left = nreplicas - already_selected_ts.size();
-    DCHECK_GE(replicas_left, 0);
-    if (replicas_left > 0) {
-      // No need to do an extra check here, as we checked early if we have enough to cover all
-      // requested placements and checked individually per placement info, if we could cover the
-      // minimums.
-      SelectReplicas(all_allowed_ts, replicas_left, config, &already_selected_ts);
     }
   }
 
-  std::ostringstream out;
-  out << Substitute("Initial tserver uuids for tablet $0: ", tablet->tablet_id());
-  for (const RaftPeerPB& peer : config->peers()) {
-    out << peer.permanent_uuid() << " ";
+  int replicas_left = nreplicas - (already_selected_ts->size() - num_selected_before);
+  DCHECK_GE(replicas_left, 0);
+  if (replicas_left > 0) {
+    // We checked early if we have enough to cover all requested placements and checked
+    // individually per placement info, if we could cover the minimums. But the leftover replicas
+    // hold data, so they cannot go to the servers that are only allowed for witnesses.
+    size_t leftover_candidates = 0;
+    for (const auto& ts : leftover_allowed_ts) {
+      leftover_candidates += !already_selected_ts->count(ts);
+    }
+    if (leftover_candidates < replicas_left) {
+      return STATUS(InvalidArgument, Substitute(
+          "Not enough tablet servers outside of the witness placements. Need $0 more, have $1",
+          replicas_left, leftover_candidates));
+    }
+    SelectReplicas(leftover_allowed_ts, replicas_left, member_type, config, already_selected_ts);
   }
-  LOG(INFO) << out.str();
-
   return Status::OK();
 }
 
@@ -4608,8 +4672,8 @@ shared_ptr<TSDescriptor> CatalogManager::SelectReplica(
 }
 
 void CatalogManager::SelectReplicas(
-    const TSDescriptorVector& ts_descs, int nreplicas, consensus::RaftConfigPB* config,
-    set<shared_ptr<TSDescriptor>>* already_selected_ts) {
+    const TSDescriptorVector& ts_descs, int nreplicas, RaftPeerPB::MemberType member_type,
+    consensus::RaftConfigPB* config, set<shared_ptr<TSDescriptor>>* already_selected_ts) {
   DCHECK_LE(nreplicas, ts_descs.size());
 
   for (int i = 0; i < nreplicas; ++i) {
@@ -4632,6 +4696,10 @@ void CatalogManager::SelectReplicas(
 
     RaftPeerPB *peer = config->add_peers();
     peer->set_permanent_uuid(ts->permanent_uuid());
+    // Voters are left without a member type, the tablet server sets it when creating the tablet.
+    if (member_type != RaftPeerPB::VOTER) {
+      peer->set_member_type(member_type);
+    }
 
     // TODO: This is temporary, we will use only UUIDs
     for (const HostPortPB& addr : reg.common().rpc_addresses()) {
@@ -5449,6 +5517,18 @@ bool TableInfo::IsCreateInProgress() const {
   return false;
 }
 
+void TableInfo::GetCreateProgress(int* num_tablets, int* num_running_tablets) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  *num_tablets = tablet_map_.size();
+  *num_running_tablets = 0;
+  for (const TableInfo::TabletInfoMap::value_type& e : tablet_map_) {
+    auto tablet_lock = e.second->LockForRead();
+    if (tablet_lock->data().is_running()) {
+      ++*num_running_tablets;
+    }
+  }
+}
+
 void TableInfo::SetCreateTableErrorStatus(const Status& status) {
   std::lock_guard<simple_spinlock> l(lock_);
   create_table_error_ = status;
@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -376,6 +377,9 @@ class TableInfo : public RefCountedThreadSafe<TableInfo>,
   // Returns true if the table creation is in-progress
   bool IsCreateInProgress() const;
 
+  // Returns the number of tablets of the table and how many of them are running.
+  void GetCreateProgress(int* num_tablets, int* num_running_tablets) const;
+
   // Returns true if an "Alter" operation is in-progress
   bool IsAlterInProgress(uint32_t version) const;
 
@@ -796,6 +800,12 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS GetTabletLocations(const TabletId& tablet_id,
                                     TabletLocationsPB* locs_pb);
 
+  // Changes whenever running tablets, their replicas or their tables may have changed, so that
+  // views built from the tablet locations, such as system.partitions, can be cached.
+  int64_t tablet_locations_version() const {
+    return tablet_locations_version_.load(std::memory_order_acquire);
+  }
+
   // Retrieves a SystemTablet instance based on the existing system tablets already created in our
   // syscatalog.
   CHECKED_STATUS RetrieveSystemTablet(const TabletId& tablet_id,
@@ -1181,13 +1191,24 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // This method is called by "ProcessPendingAssignments()".
   CHECKED_STATUS SelectReplicasForTablet(const TSDescriptorVector& ts_descs, TabletInfo* tablet);
 
+  // Select N Replicas of the given member type from the online tablet servers in 'ts_descs' that
+  // have not been selected yet, respecting the minimums of the placement blocks of
+  // 'placement_info'. Returns Status::InvalidArgument if there are not enough of such servers.
+  //
+  // This method is called by "SelectReplicasForTablet", for the live and the async replicas.
+  CHECKED_STATUS SelectReplicasForPlacement(
+      const TSDescriptorVector& ts_descs, const PlacementInfoPB& placement_info, int nreplicas,
+      consensus::RaftPeerPB::MemberType member_type, consensus::RaftConfigPB* config,
+      std::set<std::shared_ptr<TSDescriptor>>* already_selected_ts);
+
   // Select N Replicas from the online tablet servers that have been chosen to respect the
   // placement information provided. Populate the consensus configuration object with choices and
   // also update the set of selected tablet servers, to not place several replicas on the same TS.
   //
-  // This method is called by "SelectReplicasForTablet".
+  // This method is called by "SelectReplicasForPlacement".
   void SelectReplicas(
-      const TSDescriptorVector& ts_descs, int nreplicas, consensus::RaftConfigPB* config,
+      const TSDescriptorVector& ts_descs, int nreplicas,
+      consensus::RaftPeerPB::MemberType member_type, consensus::RaftConfigPB* config,
       std::set<std::shared_ptr<TSDescriptor>>* already_selected_ts);
 
   void HandleAssignPreparingTablet(TabletInfo* tablet,
@@ -1427,6 +1448,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // correctly.
   int64_t leader_ready_term_;
 
+  // See tablet_locations_version().
+  std::atomic<int64_t> tablet_locations_version_{0};
+
   // Lock used to fence operations and leader elections. All logical operations
   // (i.e. create table, alter table, etc.) should acquire this lock for
   // reading. Following an election where this master is elected leader, it
@@ -60,6 +60,17 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_double(load_balancer_activity_ops_per_sec_unit,
+              1000,
+              "Tablet servers with the same number of tablets are ordered by their activity, which "
+              "counts one unit per this many read and write operations per second, and one unit "
+              "per load_balancer_activity_sst_bytes_unit bytes of SST files. Differences within a "
+              "unit are ignored, to avoid moving tablets back and forth on small fluctuations.");
+
+DEFINE_int64(load_balancer_activity_sst_bytes_unit,
+             10LL << 30,
+             "See load_balancer_activity_ops_per_sec_unit.");
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -227,6 +238,9 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
 
+  // Likewise, only the tablet servers in the affinitized zones take part in leader balancing.
+  GetAffinitizedZones(table_uuid, &state_->affinitized_zones_);
+
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
   // assigned any tablets yet).
@@ -560,6 +574,33 @@ bool ClusterLoadBalancer::GetTabletToMove(
   return false;
 }
 
+bool ClusterLoadBalancer::GetLeaderToMoveToAffinitizedZone(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  if (state_->affinitized_zones_.empty()) {
+    return false;
+  }
+
+  for (const auto& entry : state_->per_ts_meta_) {
+    if (state_->IsInAffinitizedZone(*entry.second.descriptor)) {
+      continue;
+    }
+    for (const auto& tablet_id : entry.second.leaders) {
+      const auto& stepdown_failures = state_->per_tablet_meta_[tablet_id].leader_stepdown_failures;
+      // sorted_leader_load_ only has the affinitized tablet servers, least loaded first.
+      for (const auto& to_uuid : state_->sorted_leader_load_) {
+        if (state_->per_ts_meta_[to_uuid].running_tablets.count(tablet_id) &&
+            !stepdown_failures.count(to_uuid)) {
+          *moving_tablet_id = tablet_id;
+          *from_ts = entry.first;
+          *to_ts = to_uuid;
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
 bool ClusterLoadBalancer::GetLeaderToMove(
     TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId *to_ts) {
   if (state_->sorted_leader_load_.empty() ||
@@ -725,7 +766,9 @@ bool ClusterLoadBalancer::HandleRemoveIfWrongPlacement(
 
 bool ClusterLoadBalancer::HandleLeaderMoves(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
-  if (GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts)) {
+  // Moving leaders into the affinitized zones takes priority over balancing them.
+  if (GetLeaderToMoveToAffinitizedZone(out_tablet_id, out_from_ts, out_to_ts) ||
+      GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts)) {
     MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts);
     return true;
   }
@@ -810,6 +853,24 @@ const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
   return l->data().pb.server_blacklist();
 }
 
+void ClusterLoadBalancer::GetAffinitizedZones(const TableId& table_uuid,
+                                              AffinitizedZonesSet* affinitized_zones) const {
+  affinitized_zones->clear();
+  scoped_refptr<TableInfo> table_info = GetTableInfo(table_uuid);
+  if (table_info != nullptr) {
+    auto l = table_info->LockForRead();
+    for (const auto& ci : l->data().pb.replication_info().affinitized_leaders()) {
+      affinitized_zones->insert(ci);
+    }
+  }
+  if (affinitized_zones->empty()) {
+    auto l = catalog_manager_->cluster_config_->LockForRead();
+    for (const auto& ci : l->data().pb.replication_info().affinitized_leaders()) {
+      affinitized_zones->insert(ci);
+    }
+  }
+}
+
 bool ClusterLoadBalancer::SkipLoadBalancing(const TableInfo& table) const {
   // Skip load-balancing of system tables. They are virtual tables not hosted by tservers.
   return catalog_manager_->IsSystemTable(table);
@@ -145,6 +145,11 @@ class ClusterLoadBalancer {
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
 
+  // Get the zones the leaders of the given table should be placed in: the table's own affinitized
+  // leaders if it has any, otherwise those of the cluster configuration.
+  virtual void GetAffinitizedZones(const TableId& table_uuid,
+                                   AffinitizedZonesSet* affinitized_zones) const;
+
   // Should skip load-balancing of this table?
   virtual bool SkipLoadBalancing(const TableInfo& table) const;
 
@@ -237,6 +242,13 @@ class ClusterLoadBalancer {
   // Returns false otherwise.
   bool GetLoadToMove(TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // If the table has affinitized leaders, find a leader on a tablet server outside of the
+  // affinitized zones and the least loaded affinitized tablet server with a running replica of it.
+  //
+  // Returns true if such a leader was found and sets the three output parameters.
+  bool GetLeaderToMoveToAffinitizedZone(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
   bool GetTabletToMove(
       const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id);
 
@@ -36,6 +36,10 @@ DECLARE_int32(leader_balance_threshold);
 
 DECLARE_int32(leader_balance_unresponsive_timeout_ms);
 
+DECLARE_double(load_balancer_activity_ops_per_sec_unit);
+
+DECLARE_int64(load_balancer_activity_sst_bytes_unit);
+
 namespace yb {
 namespace master {
 
@@ -118,6 +122,14 @@ struct CBTabletServerMetadata {
 
   // The set of tablet leader ids that this tablet server is currently running.
   std::set<TabletId> leaders;
+
+  // The set of tablet ids that this tablet server hosts a read replica (an observer) of. These do
+  // not count as load, but the server cannot get another replica of these tablets.
+  std::set<TabletId> read_replica_tablets;
+
+  // The activity of the tablet server reported in its heartbeats, see
+  // FLAGS_load_balancer_activity_ops_per_sec_unit.
+  int64_t activity = 0;
 };
 
 class ClusterLoadState {
@@ -127,11 +139,18 @@ class ClusterLoadState {
         current_time_(MonoTime::Now()) {}
   virtual ~ClusterLoadState() {}
 
-  // Comparators used for sorting by load.
+  // Comparators used for sorting by load. Tablet servers with the same number of tablets are
+  // ordered by activity, so that replicas are added to the least active ones and moved away from
+  // the most active ones.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
     int load_a = GetLoad(a);
     int load_b = GetLoad(b);
     if (load_a == load_b) {
+      int64_t activity_a = per_ts_meta_.at(a).activity;
+      int64_t activity_b = per_ts_meta_.at(b).activity;
+      if (activity_a != activity_b) {
+        return activity_a < activity_b;
+      }
       return a < b;
     } else {
       return load_a < load_b;
@@ -172,6 +191,20 @@ class ClusterLoadState {
     return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
   }
 
+  // Quantizes the operations per second and SST file size reported by the tablet server.
+  static int64_t GetActivity(TSDescriptor* ts_desc) {
+    int64_t activity = 0;
+    if (FLAGS_load_balancer_activity_ops_per_sec_unit > 0) {
+      activity += static_cast<int64_t>(
+          (ts_desc->read_ops_per_sec() + ts_desc->write_ops_per_sec()) /
+          FLAGS_load_balancer_activity_ops_per_sec_unit);
+    }
+    if (FLAGS_load_balancer_activity_sst_bytes_unit > 0) {
+      activity += ts_desc->total_sst_file_size() / FLAGS_load_balancer_activity_sst_bytes_unit;
+    }
+    return activity;
+  }
+
   // Get the load for a certain TS.
   int GetLeaderLoad(const TabletServerId& ts_uuid) const {
     return per_ts_meta_.at(ts_uuid).leaders.size();
@@ -191,6 +224,23 @@ class ClusterLoadState {
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     tablet->GetReplicaLocations(&replica_map);
+    // Read replicas are placed by the async replicas policy, not by the live replicas one that is
+    // balanced here, so leave them out of the replica counts.
+    {
+      auto l = tablet->LockForRead();
+      for (const auto& peer : l->data().pb.committed_consensus_state().config().peers()) {
+        if (peer.member_type() != consensus::RaftPeerPB::OBSERVER &&
+            peer.member_type() != consensus::RaftPeerPB::PRE_OBSERVER) {
+          continue;
+        }
+        if (replica_map.erase(peer.permanent_uuid())) {
+          auto ts_meta_it = per_ts_meta_.find(peer.permanent_uuid());
+          if (ts_meta_it != per_ts_meta_.end()) {
+            ts_meta_it->second.read_replica_tablets.insert(tablet_id);
+          }
+        }
+      }
+    }
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -314,6 +364,7 @@ class ClusterLoadState {
     // tablet servers that happen to not be serving any tablets, so were not in the map yet.
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
+    ts_meta.activity = GetActivity(ts_desc.get());
 
     sorted_load_.push_back(ts_uuid);
 
@@ -327,11 +378,13 @@ class ClusterLoadState {
       }
     }
 
-    // Add this tablet server for leader load-balancing only if it is not blacklisted and it has
-    // heartbeated recently enough to be considered responsive for leader balancing.
+    // Add this tablet server for leader load-balancing only if it is not blacklisted, it has
+    // heartbeated recently enough to be considered responsive for leader balancing and, if the
+    // table has affinitized leaders, it is in one of the affinitized zones.
     if (!is_blacklisted &&
         ts_desc->TimeSinceHeartbeat().ToMilliseconds() <
-        FLAGS_leader_balance_unresponsive_timeout_ms) {
+        FLAGS_leader_balance_unresponsive_timeout_ms &&
+        IsInAffinitizedZone(*ts_desc)) {
       sorted_leader_load_.push_back(ts_uuid);
     }
 
@@ -341,6 +394,19 @@ class ClusterLoadState {
     }
   }
 
+  // Returns true if there are no affinitized zones, or if the tablet server is in one of them.
+  bool IsInAffinitizedZone(const TSDescriptor& ts_desc) const {
+    if (affinitized_zones_.empty()) {
+      return true;
+    }
+    for (const auto& zone : affinitized_zones_) {
+      if (ts_desc.MatchesCloudInfo(zone)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   bool CanAddTabletToTabletServer(
     const TabletId& tablet_id, const TabletServerId& to_ts,
     const PlacementInfoPB* placement_info = nullptr) {
@@ -354,7 +420,8 @@ class ClusterLoadState {
       return false;
     }
     // We cannot add a tablet to a tablet server if it is already serving it.
-    if (ts_meta.running_tablets.count(tablet_id) || ts_meta.starting_tablets.count(tablet_id)) {
+    if (ts_meta.running_tablets.count(tablet_id) || ts_meta.starting_tablets.count(tablet_id) ||
+        ts_meta.read_replica_tablets.count(tablet_id)) {
       return false;
     }
     // If we ask to use placement information, check against it.
@@ -578,6 +645,10 @@ class ClusterLoadState {
   // Number of leaders per each tablet server to balance below.
   int leader_balance_threshold_ = 0;
 
+  // The zones in which the leaders of the current table should be placed, if any. Set before the
+  // tablet servers are added, as it decides which of them take part in leader balancing.
+  AffinitizedZonesSet affinitized_zones_;
+
   // List of table server ids sorted by their leader load.
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
@@ -406,6 +406,30 @@ TEST_F(MasterTest, TestRegisterAndHeartbeat) {
     ASSERT_EQ("my-ts-uuid", resp.servers(0).instance_id().permanent_uuid());
     ASSERT_EQ(1, resp.servers(0).instance_id().instance_seqno());
   }
+
+  // The live tablet servers are only sent when the tablet server doesn't have them yet.
+  uint64_t fingerprint;
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+
+    ASSERT_EQ(1, resp.tservers_size());
+    ASSERT_EQ(kTsUUID, resp.tservers(0).tserver_instance().permanent_uuid());
+    ASSERT_NE(0, resp.tservers_fingerprint());
+    fingerprint = resp.tservers_fingerprint();
+  }
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    req.set_tservers_fingerprint(fingerprint);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+
+    ASSERT_EQ(0, resp.tservers_size());
+    ASSERT_EQ(fingerprint, resp.tservers_fingerprint());
+  }
 }
 
 Status MasterTest::CreateTable(const NamespaceName& namespace_name,
@@ -690,6 +714,8 @@ TEST_F(MasterTest, TestInvalidPlacementInfo) {
     ASSERT_TRUE(s.ok());
     ASSERT_TRUE(is_create_resp.has_done());
     ASSERT_FALSE(is_create_resp.done());
+    ASSERT_GT(is_create_resp.num_tablets(), 0);
+    ASSERT_EQ(0, is_create_resp.num_running_tablets());
     if (is_create_resp.has_error()) {
       ASSERT_EQ(is_create_resp.error().status().code(), AppStatusPB::INVALID_ARGUMENT);
     }
@@ -174,12 +174,8 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     resp->set_needs_full_tablet_report(true);
   }
 
-  // Retrieve all the nodes known by the master.
-  std::vector<std::shared_ptr<TSDescriptor> > descs;
-  server_->ts_manager()->GetAllLiveDescriptors(&descs);
-  for (const auto& desc : descs) {
-    desc->GetTSInformationPB(resp->add_tservers());
-  }
+  // Send the nodes known by the master, unless the tablet server already has them.
+  server_->ts_manager()->FillLiveTSInformation(req->tservers_fingerprint(), resp);
 
   rpc.RespondSuccess();
 }
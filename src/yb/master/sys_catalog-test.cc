@@ -405,6 +405,30 @@ TEST_F(SysCatalogTest, TestSysCatalogTabletsOperations) {
   }
 }
 
+// Test visiting several entry types in a single scan.
+TEST_F(SysCatalogTest, TestSysCatalogVisitMultipleTypes) {
+  SysCatalogTable* sys_catalog = master_->catalog_manager()->sys_catalog();
+
+  scoped_refptr<TableInfo> table(new TableInfo("abc"));
+  scoped_refptr<TabletInfo> tablet(CreateTablet(table.get(), "123", "a", "b"));
+  {
+    auto l = tablet->LockForWrite();
+    ASSERT_OK(sys_catalog->AddItem(tablet.get()));
+    l->Commit();
+  }
+
+  TestTableLoader table_loader;
+  TestTabletLoader tablet_loader;
+  ASSERT_OK(sys_catalog->Visit({&table_loader, &tablet_loader}));
+  ASSERT_EQ(master_->NumSystemTables(), table_loader.tables.size());
+  ASSERT_EQ(1 + master_->NumSystemTables(), tablet_loader.tablets.size());
+  ASSERT_TRUE(MetadatasEqual(tablet.get(), tablet_loader.tablets[tablet->id()]));
+
+  // Two visitors of the same type are not allowed.
+  TestTableLoader other_table_loader;
+  ASSERT_NOK(sys_catalog->Visit({&table_loader, &other_table_loader}));
+}
+
 // Verify that data mutations are not available from metadata() until commit.
 TEST_F(SysCatalogTest, TestTabletInfoCommit) {
   scoped_refptr<TabletInfo> tablet(new TabletInfo(nullptr, "123"));
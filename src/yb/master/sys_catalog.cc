@@ -33,6 +33,7 @@
 #include "yb/master/sys_catalog.h"
 
 #include <cmath>
+#include <map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -482,7 +483,8 @@ Status SysCatalogTable::OpenTablet(const scoped_refptr<tablet::TabletMetadata>&
                                                      master_->messenger(),
                                                      log,
                                                      tablet->GetMetricEntity(),
-                                                     raft_pool()),
+                                                     raft_pool(),
+                                                     nullptr /* multi_raft_manager */),
                         "Failed to Init() TabletPeer");
 
   RETURN_NOT_OK_PREPEND(tablet_peer_->Start(consensus_info),
@@ -585,9 +587,24 @@ void SysCatalogTable::InitLocalRaftPeerPB() {
 }
 
 Status SysCatalogTable::Visit(VisitorBase* visitor) {
+  return Visit(std::vector<VisitorBase*>{visitor});
+}
+
+Status SysCatalogTable::Visit(const std::vector<VisitorBase*>& visitors) {
   TRACE_EVENT0("master", "Visitor::VisitAll");
 
-  const int8_t tables_entry = visitor->entry_type();
+  std::map<int8_t, VisitorBase*> visitor_by_type;
+  for (VisitorBase* visitor : visitors) {
+    auto inserted = visitor_by_type.emplace(visitor->entry_type(), visitor).second;
+    if (!inserted) {
+      return STATUS_FORMAT(InvalidArgument, "Multiple visitors of type $0", visitor->entry_type());
+    }
+  }
+  if (visitor_by_type.empty()) {
+    return Status::OK();
+  }
+  const int8_t max_entry_type = visitor_by_type.rbegin()->first;
+
   const int type_col_idx = schema_.find_column(kSysCatalogTableColType);
   const int entry_id_col_idx = schema_.find_column(kSysCatalogTableColId);
   const int metadata_col_idx = schema_.find_column(kSysCatalogTableColMetadata);
@@ -602,12 +619,17 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
   while ((**iter).HasNext()) {
     RETURN_NOT_OK((**iter).NextRow(&value_map));
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(type_col_idx), &entry_type));
-    if (entry_type.int8_value() != tables_entry) {
+    // Entries are ordered by type, so there is nothing left to visit past the last type.
+    if (entry_type.int8_value() > max_entry_type) {
+      break;
+    }
+    auto it = visitor_by_type.find(entry_type.int8_value());
+    if (it == visitor_by_type.end()) {
       continue;
     }
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(entry_id_col_idx), &entry_id));
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(metadata_col_idx), &metadata));
-    RETURN_NOT_OK(visitor->Visit(entry_id.binary_value(), metadata.binary_value()));
+    RETURN_NOT_OK(it->second->Visit(entry_id.binary_value(), metadata.binary_value()));
   }
   return Status::OK();
 }
@@ -156,6 +156,11 @@ class SysCatalogTable {
 
   CHECKED_STATUS Visit(VisitorBase* visitor);
 
+  // Visits the entries of all the given visitors in a single scan of the sys catalog. Entries are
+  // visited in the order of their types, so visitors of a type may rely on the entries of lower
+  // types, e.g. tablets on tables, having been visited already.
+  CHECKED_STATUS Visit(const std::vector<VisitorBase*>& visitors);
+
  private:
   friend class CatalogManager;
 
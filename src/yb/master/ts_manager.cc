@@ -40,6 +40,7 @@
 #include "yb/master/master.pb.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/hash_util.h"
 
 DEFINE_int32(tserver_unresponsive_timeout_ms, 60 * 1000,
              "The period of time that a Master can go without receiving a heartbeat from a "
@@ -94,6 +95,7 @@ Status TSManager::RegisterTS(const NodeInstancePB& instance,
                              TSDescSharedPtr* desc) {
   std::lock_guard<rw_spinlock> l(lock_);
   const string& uuid = instance.permanent_uuid();
+  ++registration_generation_;
 
   if (!ContainsKey(servers_by_id_, uuid)) {
     // Check if a server with the same host and port already exists.
@@ -185,6 +187,40 @@ const TSDescSharedPtr TSManager::GetTSDescriptor(const HostPortPB& host_port) co
   return nullptr;
 }
 
+void TSManager::FillLiveTSInformation(uint64_t known_fingerprint, TSHeartbeatResponsePB* resp) {
+  uint64_t generation;
+  {
+    boost::shared_lock<rw_spinlock> l(lock_);
+    generation = registration_generation_;
+  }
+  TSDescriptorVector descs;
+  GetAllLiveDescriptors(&descs);
+
+  std::lock_guard<std::mutex> l(live_tservers_mutex_);
+  if (!live_tservers_ || descs != live_tservers_descs_ ||
+      generation != live_tservers_generation_) {
+    live_tservers_.reset(new TSHeartbeatResponsePB);
+    uint64_t fingerprint = 0;
+    for (const auto& desc : descs) {
+      auto* ts_info = live_tservers_->add_tservers();
+      desc->GetTSInformationPB(ts_info);
+      const auto serialized = ts_info->SerializeAsString();
+      fingerprint = HashUtil::MurmurHash2_64(
+          serialized.data(), static_cast<int>(serialized.size()), fingerprint);
+    }
+    // Zero is reserved for the servers that don't know the list yet.
+    live_tservers_->set_tservers_fingerprint(fingerprint == 0 ? 1 : fingerprint);
+    live_tservers_descs_ = std::move(descs);
+    live_tservers_generation_ = generation;
+  }
+
+  if (known_fingerprint == live_tservers_->tservers_fingerprint()) {
+    resp->set_tservers_fingerprint(known_fingerprint);
+  } else {
+    resp->MergeFrom(*live_tservers_);
+  }
+}
+
 int TSManager::GetCount() const {
   boost::shared_lock<rw_spinlock> l(lock_);
   size_t count = 0;
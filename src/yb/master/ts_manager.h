@@ -33,6 +33,7 @@
 #define YB_MASTER_TS_MANAGER_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -50,6 +51,7 @@ class NodeInstancePB;
 namespace master {
 
 class TSDescriptor;
+class TSHeartbeatResponsePB;
 class TSRegistrationPB;
 
 using TSDescSharedPtr = std::shared_ptr<TSDescriptor>;
@@ -103,6 +105,11 @@ class TSManager {
   // full report of their tablets as well.
   void GetAllReportedDescriptors(TSDescriptorVector* descs) const;
 
+  // Adds the information of all live tablet servers to the heartbeat response, unless the
+  // heartbeating server already has it, i.e. 'known_fingerprint' matches the current one.
+  // The current fingerprint is always set in the response.
+  void FillLiveTSInformation(uint64_t known_fingerprint, TSHeartbeatResponsePB* resp);
+
   // Get the TS count.
   int GetCount() const;
 
@@ -121,6 +128,17 @@ class TSManager {
   typedef std::unordered_map<std::string, TSDescSharedPtr> TSDescriptorMap;
   TSDescriptorMap servers_by_id_;
 
+  // Incremented on each registration, so that the cached live tablet server information is
+  // rebuilt when a registration of a tablet server changes. Protected by lock_.
+  uint64_t registration_generation_ = 0;
+
+  // The live tablet server information sent in the heartbeat responses, rebuilt only when the set
+  // of live tablet servers or their registrations change. Protected by live_tservers_mutex_.
+  std::mutex live_tservers_mutex_;
+  TSDescriptorVector live_tservers_descs_;
+  uint64_t live_tservers_generation_ = 0;
+  std::unique_ptr<TSHeartbeatResponsePB> live_tservers_;
+
   DISALLOW_COPY_AND_ASSIGN(TSManager);
 };
 
@@ -11,10 +11,19 @@
 // under the License.
 //
 
+#include <gflags/gflags.h>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/redis_constants_common.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/master/yql_partitions_vtable.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(partitions_vtable_cache_refresh_secs, 60,
+             "Maximum age of the cached contents of system.partitions, which are otherwise only "
+             "rebuilt when tablets, their replicas or their tables change. 0 disables the cache.");
+TAG_FLAG(partitions_vtable_cache_refresh_secs, runtime);
+TAG_FLAG(partitions_vtable_cache_refresh_secs, advanced);
 
 namespace yb {
 namespace master {
@@ -25,7 +34,44 @@ YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
 
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
+  const int refresh_secs = FLAGS_partitions_vtable_cache_refresh_secs;
+  if (refresh_secs <= 0) {
+    vtable->reset(new QLRowBlock(schema_));
+    return BuildRows(vtable->get());
+  }
+
+  // Read the version first, so that changes made while the rows are built invalidate them.
+  const int64_t version = master_->catalog_manager()->tablet_locations_version();
+  const MonoTime now = MonoTime::Now();
+  std::shared_ptr<const QLRowBlock> rows;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache_ && cache_version_ == version &&
+        now.GetDeltaSince(cache_time_).ToSeconds() < refresh_secs) {
+      rows = cache_;
+    }
+  }
+  if (!rows) {
+    auto new_rows = std::make_shared<QLRowBlock>(schema_);
+    RETURN_NOT_OK(BuildRows(new_rows.get()));
+    rows = new_rows;
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_ = rows;
+    cache_version_ = version;
+    cache_time_ = now;
+  }
+
+  // Only copy the rows the request asks for.
   vtable->reset(new QLRowBlock(schema_));
+  for (const QLRow& row : rows->rows()) {
+    if (MatchesHashedColumnValues(request, row)) {
+      RETURN_NOT_OK((*vtable)->AddRow(row));
+    }
+  }
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::BuildRows(QLRowBlock* rows) const {
   std::vector<scoped_refptr<TableInfo> > tables;
   CatalogManager* catalog_manager = master_->catalog_manager();
   catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
@@ -53,7 +99,7 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
         continue;
       }
 
-      QLRow& row = (*vtable)->Extend();
+      QLRow& row = rows->Extend();
       RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
       RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
 
@@ -14,8 +14,11 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
+#include "yb/util/monotime.h"
 
 namespace yb {
 namespace master {
@@ -29,6 +32,16 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
  private:
+  // Builds the rows of all the partitions from the catalog.
+  CHECKED_STATUS BuildRows(QLRowBlock* rows) const;
+
+  // The rows as of tablet locations version cache_version_, built at cache_time_. Drivers poll
+  // this table, so it is only rebuilt when the tablet locations change, or when it gets too old.
+  mutable std::mutex cache_mutex_;
+  mutable std::shared_ptr<const QLRowBlock> cache_;
+  mutable int64_t cache_version_ = -1;
+  mutable MonoTime cache_time_;
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
@@ -39,18 +39,11 @@ CHECKED_STATUS YQLVirtualTable::GetIterator(
 
   // If hashed column values are specified, filter by the hash key.
   if (!request.hashed_column_values().empty()) {
-    const size_t num_hash_key_columns = schema_.num_hash_key_columns();
-    const auto& hashed_column_values = request.hashed_column_values();
     std::vector<QLRow>& rows = vtable->rows();
     auto excluded_rows = std::remove_if(
         rows.begin(), rows.end(),
-        [num_hash_key_columns, &hashed_column_values](const QLRow& row) -> bool {
-          for (size_t i = 0; i < num_hash_key_columns; i++) {
-            if (hashed_column_values.Get(i).value() != row.column(i)) {
-              return true;
-            }
-          }
-          return false;
+        [this, &request](const QLRow& row) -> bool {
+          return !MatchesHashedColumnValues(request, row);
         });
     rows.erase(excluded_rows, rows.end());
   }
@@ -79,6 +72,20 @@ CHECKED_STATUS YQLVirtualTable::BuildQLScanSpec(
   return Status::OK();
 }
 
+bool YQLVirtualTable::MatchesHashedColumnValues(const QLReadRequestPB& request,
+                                                const QLRow& row) const {
+  const auto& hashed_column_values = request.hashed_column_values();
+  if (hashed_column_values.empty()) {
+    return true;
+  }
+  for (size_t i = 0; i < schema_.num_hash_key_columns(); i++) {
+    if (hashed_column_values.Get(i).value() != row.column(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void YQLVirtualTable::GetSortedLiveDescriptors(std::vector<std::shared_ptr<TSDescriptor>>* descs)
     const {
   master_->ts_manager()->GetAllLiveDescriptors(descs);
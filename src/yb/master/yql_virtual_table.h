@@ -74,6 +74,9 @@ class YQLVirtualTable : public common::QLStorageIf {
   // consistent token.
   void GetSortedLiveDescriptors(std::vector<std::shared_ptr<TSDescriptor>>* descs) const;
 
+  // Returns true if the row matches the hashed column values of the request, if any.
+  bool MatchesHashedColumnValues(const QLReadRequestPB& request, const QLRow& row) const;
+
   const Master* const master_;
   TableName table_name_;
   Schema schema_;
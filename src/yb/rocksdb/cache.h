@@ -66,6 +66,13 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache using the CLOCK replacement policy, sharded and sized as the LRU cache above.
+// Lookups and releases do not take the shard lock exclusively, so hot blocks scale with the number
+// of readers. Blocks are promoted by hits from other queries only, which makes it scan resistant.
+extern shared_ptr<Cache> NewClockCache(size_t capacity);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                       bool strict_capacity_limit = false);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
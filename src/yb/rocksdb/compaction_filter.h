@@ -24,6 +24,7 @@
 #ifndef ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_FILTER_H
 #define ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_FILTER_H
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@
 namespace rocksdb {
 
 class SliceTransform;
+struct FileMetaData;
 
 // Context information of a compaction run
 struct CompactionFilterContext {
@@ -57,6 +59,9 @@ class CompactionFilter {
     bool is_manual_compaction;
     // Which column family this compaction is for.
     uint32_t column_family_id;
+    // Whether the filter is applied to the output of a memtable flush instead, see
+    // CompactionFilterFactory::FilterFlushes.
+    bool is_flush = false;
   };
 
   virtual ~CompactionFilter() {}
@@ -144,6 +149,37 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // Returns the files among the given live files of a single level column family whose whole
+  // contents could be dropped without rewriting them, judging by the file metadata only. Called
+  // by the universal compaction picker with the DB mutex held. Files being compacted are not
+  // dropped even if returned.
+  virtual std::vector<FileMetaData*> FilesToDrop(const std::vector<FileMetaData*>& files) {
+    return {};
+  }
+
+  static constexpr int64_t kNoTimeWindow = std::numeric_limits<int64_t>::min();
+
+  // Returns the time window of the given file of a single level column family, or kNoTimeWindow
+  // if the file could be compacted with any other file. Files of different windows are never
+  // compacted together, and the files of each window older than the newest one are compacted into
+  // a single file. Called by the universal compaction picker with the DB mutex held.
+  virtual int64_t TimeWindow(const FileMetaData& file) {
+    return kNoTimeWindow;
+  }
+
+  // Returns the prefix of the given user key at which a subcompaction could start. Each
+  // subcompaction uses its own filter, so keys that a filter should see together, e.g. the keys of
+  // a single document, must not be split across subcompactions.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) {
+    return user_key;
+  }
+
+  // Whether memtable flushes should also be filtered, by a filter created with Context::is_flush
+  // set. Such a filter only sees the entries of the flushed memtables.
+  virtual bool FilterFlushes() const {
+    return false;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
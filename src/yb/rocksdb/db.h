@@ -41,6 +41,8 @@
 #include "yb/rocksdb/types.h"
 #include "yb/rocksdb/version.h"
 
+#include "yb/util/result.h"
+
 #ifdef _WIN32
 // Windows API macro interference
 #undef DeleteFile
@@ -783,6 +785,15 @@ class DB {
   // Returns the total combined size of all the SST Files in the rocksdb instance.
   virtual uint64_t GetTotalSSTFileSize() { return 0; }
 
+  // Returns the number of SST files in the current version of the default column family.
+  virtual int GetCurrentVersionNumSSTFiles() { return 0; }
+
+  // Returns an approximate middle user key of the default column family, picked from its
+  // largest SST file. Could be used as a split point of the DB key range.
+  virtual yb::Result<std::string> GetMiddleKey() {
+    return STATUS(NotSupported, "GetMiddleKey() not supported");
+  }
+
   // Returns a list of all table files with their level, start key
   // and end key
   virtual void GetLiveFilesMetaData(std::vector<LiveFileMetaData>* /*metadata*/) {}
@@ -114,7 +114,8 @@ Status BuildTable(const std::string& dbname,
                   InternalStats* internal_stats,
                   BoundaryValuesExtractor* boundary_values_extractor,
                   const Env::IOPriority io_priority,
-                  TableProperties* table_properties) {
+                  TableProperties* table_properties,
+                  const CompactionFilter* compaction_filter) {
   // Reports the IOStats for flush for every following bytes.
   const size_t kReportFlushIOStatsEvery = 1048576;
   Status s;
@@ -151,7 +152,8 @@ Status BuildTable(const std::string& dbname,
     CompactionIterator c_iter(iter, internal_comparator.user_comparator(),
                               &merge, kMaxSequenceNumber, &snapshots,
                               earliest_write_conflict_snapshot, env,
-                              true /* internal key corruption is not ok */);
+                              true /* internal key corruption is not ok */,
+                              nullptr /* compaction */, compaction_filter);
     c_iter.SeekToFirst();
     for (; c_iter.Valid(); c_iter.Next()) {
       const Slice& key = c_iter.key();
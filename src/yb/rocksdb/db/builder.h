@@ -41,6 +41,7 @@ namespace rocksdb {
 struct Options;
 struct FileMetaData;
 
+class CompactionFilter;
 class Env;
 struct EnvOptions;
 class Iterator;
@@ -94,7 +95,8 @@ extern Status BuildTable(
     InternalStats* internal_stats,
     BoundaryValuesExtractor* boundary_values_extractor,
     const Env::IOPriority io_priority = Env::IO_HIGH,
-    TableProperties* table_properties = nullptr);
+    TableProperties* table_properties = nullptr,
+    const CompactionFilter* compaction_filter = nullptr);
 
 }  // namespace rocksdb
 
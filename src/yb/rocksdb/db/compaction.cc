@@ -504,7 +504,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level, the disjoint output files of the subcompactions are added to level 0
+    // and treated as a single sorted run, see VersionStorageInfo::InSameSortedRun.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
@@ -42,7 +42,6 @@ CompactionIterator::CompactionIterator(
       compaction_filter_(compaction_filter),
       log_buffer_(log_buffer),
       merge_out_iter_(merge_helper_) {
-  assert(compaction_filter_ == nullptr || compaction_ != nullptr);
   bottommost_level_ =
       compaction_ == nullptr ? false : compaction_->bottommost_level();
   if (compaction_ != nullptr) {
@@ -181,7 +180,7 @@ void CompactionIterator::NextFromInput() {
         {
           StopWatchNano timer(env_, true);
           to_delete = compaction_filter_->Filter(
-              compaction_->level(), ikey_.user_key, value_,
+              compaction_ != nullptr ? compaction_->level() : 0, ikey_.user_key, value_,
               &compaction_filter_value_, &value_changed);
           iter_stats_.total_filter_time +=
               env_ != nullptr ? timer.ElapsedNanos() : 0;
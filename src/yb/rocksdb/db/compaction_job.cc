@@ -51,6 +51,7 @@
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/statistics.h"
@@ -439,9 +440,11 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
-  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+  const uint64_t max_file_size = cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl);
+  // Output files of level 0 of universal compaction are not limited in size.
+  uint64_t max_output_files = max_file_size == std::numeric_limits<uint64_t>::max()
+      ? std::numeric_limits<uint64_t>::max()
+      : static_cast<uint64_t>(std::ceil(sum / min_file_fill_percent / max_file_size));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -451,6 +454,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
                                     : std::numeric_limits<double>::max();
 
   if (subcompactions > 1) {
+    auto* filter_factory = cfd->ioptions()->compaction_filter_factory;
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
     sum = 0;
@@ -462,7 +466,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory != nullptr) {
+          boundary = filter_factory->SubcompactionBoundary(boundary);
+        }
+        // Adjusted boundaries could coincide, the range then goes to the next subcompaction.
+        if (boundary.empty() || (!boundaries_.empty() &&
+                                 cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
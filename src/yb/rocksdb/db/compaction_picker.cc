@@ -28,6 +28,7 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <limits>
 #include <queue>
 #include <string>
@@ -1148,7 +1149,8 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  return vstorage->CompactionScore(kLevel0) >= 1 ||
+         !vstorage->FilesMarkedForCompaction().empty();
 }
 
 struct UniversalCompactionPicker::SortedRun {
@@ -1162,6 +1164,18 @@ struct UniversalCompactionPicker::SortedRun {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
     assert((level != 0) != (file != nullptr));
+    if (file != nullptr) {
+      files.push_back(file);
+    }
+  }
+
+  // Adds an output file of the same compaction as the files of this level 0 sorted run.
+  void AddFile(FileMetaData* f) {
+    assert(level == 0);
+    files.push_back(f);
+    size += f->fd.GetTotalFileSize();
+    compensated_file_size += f->compensated_file_size;
+    being_compacted = being_compacted || f->being_compacted;
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1173,14 +1187,18 @@ struct UniversalCompactionPicker::SortedRun {
 
   int level;
   // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
+  // for this file, and `files` also contains the other output files of the
+  // compaction that produced it, if it was split into subcompactions.
   FileMetaData* file;
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
   uint64_t size;
   uint64_t compensated_file_size;
   bool being_compacted;
+  // CompactionFilterFactory::TimeWindow of `file`, kNoTimeWindow for level > 0.
+  int64_t time_window = CompactionFilterFactory::kNoTimeWindow;
 };
 
 void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
@@ -1189,12 +1207,13 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
   if (level == 0) {
     assert(file != nullptr);
     if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+      snprintf(out_buf, out_buf_size, "file %" PRIu64 "(files %" ROCKSDB_PRIszt ")",
+               file->fd.GetNumber(), files.size());
     } else {
       snprintf(out_buf, out_buf_size, "file %" PRIu64
                                       "(path "
-                                      "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+                                      "%" PRIu32 ", files %" ROCKSDB_PRIszt ")",
+               file->fd.GetNumber(), file->fd.GetPathId(), files.size());
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -1208,9 +1227,8 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     snprintf(out_buf, out_buf_size,
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
-             "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             "with size %" PRIu64 " (compensated size %" PRIu64 ", files %" ROCKSDB_PRIszt ")",
+             file->fd.GetNumber(), sorted_run_count, size, compensated_file_size, files.size());
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1225,10 +1243,27 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
+  // Time windows are only defined for a single level column family, see
+  // CompactionFilterFactory::TimeWindow.
+  CompactionFilterFactory* time_window_factory =
+      vstorage.num_levels() == 1 ? ioptions.compaction_filter_factory : nullptr;
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
     if (f->fd.GetTotalFileSize() <= max_file_size) {
+      if (!ret.back().empty() && ret.back().back().level == 0 &&
+          VersionStorageInfo::InSameSortedRun(*ret.back().back().files.back(), *f)) {
+        ret.back().back().AddFile(f);
+        continue;
+      }
+      int64_t time_window = time_window_factory != nullptr
+          ? time_window_factory->TimeWindow(*f) : CompactionFilterFactory::kNoTimeWindow;
+      // Files of different time windows are never compacted together, so each window starts a new
+      // sequence.
+      if (!ret.back().empty() && ret.back().back().time_window != time_window) {
+        ret.emplace_back();
+      }
       ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
+      ret.back().back().time_window = time_window;
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
@@ -1353,13 +1388,34 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  Compaction* files_to_drop = PickFilesToDrop(cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (files_to_drop != nullptr) {
+    return files_to_drop;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
       mutable_cf_options.max_file_size_for_compaction);
 
+  // Files of the newest time window could still be joined by new flushes, so they are compacted
+  // as usual. Older windows are closed, and their files are merged into a single one.
+  const int64_t newest_time_window = sorted_runs.empty()
+      ? CompactionFilterFactory::kNoTimeWindow : sorted_runs.front().front().time_window;
   for (const auto& block : sorted_runs) {
-    Compaction* result = DoPickCompaction(cf_name, mutable_cf_options, vstorage, log_buffer, block);
+    const int64_t time_window = block.front().time_window;
+    Compaction* result;
+    if (time_window != CompactionFilterFactory::kNoTimeWindow &&
+        time_window != newest_time_window) {
+      result = PickCompactionClosedTimeWindow(
+          cf_name, mutable_cf_options, vstorage, log_buffer, block);
+    } else {
+      result = DoPickCompaction(cf_name, mutable_cf_options, vstorage, log_buffer, block);
+      if (result == nullptr) {
+        result = PickCompactionMarkedFiles(
+            cf_name, mutable_cf_options, vstorage, log_buffer, block);
+      }
+    }
     if (result != nullptr) {
       return result;
     }
@@ -1367,6 +1423,140 @@ Compaction* UniversalCompactionPicker::PickCompaction(
   return nullptr;
 }
 
+Compaction* UniversalCompactionPicker::PickCompactionClosedTimeWindow(
+    const std::string& cf_name,
+    const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer,
+    const std::vector<UniversalCompactionPicker::SortedRun>& sorted_runs) {
+  const int kLevel0 = 0;
+  if (sorted_runs.size() < 2) {
+    return nullptr;
+  }
+  for (const SortedRun& sr : sorted_runs) {
+    if (sr.being_compacted) {
+      return nullptr;
+    }
+  }
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  uint64_t estimated_total_size = 0;
+  for (const SortedRun& sr : sorted_runs) {
+    assert(sr.level == 0);
+    inputs[0].files.insert(inputs[0].files.end(), sr.files.begin(), sr.files.end());
+    estimated_total_size += sr.size;
+  }
+  LOG_TO_BUFFER(log_buffer, "[%s] Universal: compacting %" ROCKSDB_PRIszt
+                            " sorted runs of closed time window %" PRId64,
+                cf_name.c_str(), sorted_runs.size(), sorted_runs.front().time_window);
+
+  uint32_t path_id = GetPathId(ioptions_, estimated_total_size);
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), kLevel0,
+      mutable_cf_options.MaxFileSizeForLevel(kLevel0), LLONG_MAX, path_id,
+      GetCompressionType(ioptions_, kLevel0, 1), /* grandparents */ {}, /* is manual */ false,
+      vstorage->CompactionScore(kLevel0), false /* deletion_compaction */,
+      CompactionReason::kUniversalTimeWindow);
+  level0_compactions_in_progress_.insert(c);
+  return c;
+}
+
+Compaction* UniversalCompactionPicker::PickCompactionMarkedFiles(
+    const std::string& cf_name,
+    const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer,
+    const std::vector<UniversalCompactionPicker::SortedRun>& sorted_runs) {
+  const int kLevel0 = 0;
+  if (vstorage->num_levels() != 1 || vstorage->FilesMarkedForCompaction().empty()) {
+    return nullptr;
+  }
+  // The oldest sorted run is not picked on its own: compacting it alone would not drop more than
+  // the compaction that produced it, and its output would just get marked again.
+  size_t start_index = sorted_runs.size();
+  for (size_t i = 0; i + 1 < sorted_runs.size(); ++i) {
+    const auto& files = sorted_runs[i].files;
+    if (std::any_of(files.begin(), files.end(),
+                    [](FileMetaData* f) { return f->marked_for_compaction; })) {
+      start_index = i;
+      break;
+    }
+  }
+  if (start_index == sorted_runs.size()) {
+    return nullptr;
+  }
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  uint64_t estimated_total_size = 0;
+  for (size_t i = start_index; i < sorted_runs.size(); ++i) {
+    const SortedRun& sr = sorted_runs[i];
+    if (sr.being_compacted) {
+      return nullptr;
+    }
+    assert(sr.level == 0);
+    inputs[0].files.insert(inputs[0].files.end(), sr.files.begin(), sr.files.end());
+    estimated_total_size += sr.size;
+  }
+  char file_num_buf[kFormatFileNumberBufSize];
+  sorted_runs[start_index].Dump(file_num_buf, sizeof(file_num_buf));
+  LOG_TO_BUFFER(log_buffer, "[%s] Universal: compacting marked %s with %" ROCKSDB_PRIszt
+                            " older sorted runs",
+                cf_name.c_str(), file_num_buf, sorted_runs.size() - start_index - 1);
+
+  uint32_t path_id = GetPathId(ioptions_, estimated_total_size);
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), kLevel0,
+      mutable_cf_options.MaxFileSizeForLevel(kLevel0), LLONG_MAX, path_id,
+      GetCompressionType(ioptions_, kLevel0, 1), /* grandparents */ {}, /* is manual */ false,
+      vstorage->CompactionScore(kLevel0), false /* deletion_compaction */,
+      CompactionReason::kFilesMarkedForCompaction);
+  level0_compactions_in_progress_.insert(c);
+  return c;
+}
+
+Compaction* UniversalCompactionPicker::PickFilesToDrop(
+    const std::string& cf_name,
+    const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer) {
+  const int kLevel0 = 0;
+  // Deletion compactions only handle level 0 files, and files of other levels would have to be
+  // taken into account by FilesToDrop.
+  if (ioptions_.compaction_filter_factory == nullptr || vstorage->num_levels() != 1) {
+    return nullptr;
+  }
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(kLevel0);
+  if (level_files.empty()) {
+    return nullptr;
+  }
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  for (FileMetaData* f : ioptions_.compaction_filter_factory->FilesToDrop(level_files)) {
+    if (f->being_compacted) {
+      continue;
+    }
+    inputs[0].files.push_back(f);
+    char tmp_fsize[16];
+    AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking file %" PRIu64
+                            " with size %s for deletion",
+                cf_name.c_str(), f->fd.GetNumber(), tmp_fsize);
+  }
+  if (inputs[0].files.empty()) {
+    return nullptr;
+  }
+
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), 0, 0, 0, 0,
+      kNoCompression, {}, /* is manual */ false, vstorage->CompactionScore(kLevel0),
+      /* is deletion compaction */ true, CompactionReason::kFilesToDrop);
+  level0_compactions_in_progress_.insert(c);
+  return c;
+}
+
 Compaction* UniversalCompactionPicker::DoPickCompaction(
     const std::string& cf_name,
     const MutableCFOptions& mutable_cf_options,
@@ -1453,14 +1643,20 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
 
   size_t level_index = 0U;
   if (c->start_level() == 0) {
+    const FileMetaData* prev = nullptr;
     for (auto f : *c->inputs(0)) {
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
+        prev_smallest_seqno = f->smallest.seqno;
+      } else if (VersionStorageInfo::InSameSortedRun(*prev, *f)) {
+        // Outputs of the same compaction share the sequence number range.
+        prev_smallest_seqno = std::min(prev_smallest_seqno, f->smallest.seqno);
       } else {
         DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
+        prev_smallest_seqno = f->smallest.seqno;
       }
-      prev_smallest_seqno = f->smallest.seqno;
+      prev = f;
     }
     level_index = 1U;
   }
@@ -1688,8 +1884,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1814,8 +2010,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
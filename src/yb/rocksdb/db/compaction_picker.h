@@ -266,6 +266,26 @@ class UniversalCompactionPicker : public CompactionPicker {
       LogBuffer* log_buffer,
       const std::vector<SortedRun>& sorted_runs);
 
+  // Pick a deletion compaction of the files returned by CompactionFilterFactory::FilesToDrop.
+  Compaction* PickFilesToDrop(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Pick a compaction of all the sorted runs of a closed time window, see
+  // CompactionFilterFactory::TimeWindow.
+  Compaction* PickCompactionClosedTimeWindow(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer,
+      const std::vector<SortedRun>& sorted_runs);
+
+  // Pick a compaction of the newest sorted run with a file marked for compaction, e.g. by a table
+  // properties collector that found too much garbage in it, and of all the older sorted runs, which
+  // hold the entries its deletes and overwrites shadow.
+  Compaction* PickCompactionMarkedFiles(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer,
+      const std::vector<SortedRun>& sorted_runs);
+
   // Pick Universal compaction to limit read amplification
   Compaction* PickCompactionUniversalReadAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
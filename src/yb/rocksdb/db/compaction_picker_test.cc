@@ -474,6 +474,34 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+TEST_F(CompactionPickerTest, UniversalMarkedForCompaction) {
+  const uint64_t kFileSize = 100000;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+
+  // Too few files for a regular compaction, and the oldest marked file is not compacted alone.
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(0, 3U, "260", "300", kFileSize * 100, 0, 260, 300);
+  vstorage_->LevelFiles(0)[2]->marked_for_compaction = true;
+  UpdateVersionStorageInfo();
+  ASSERT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction == nullptr);
+
+  // A newer marked file is compacted with all the older ones.
+  vstorage_->LevelFiles(0)[1]->marked_for_compaction = true;
+  UpdateVersionStorageInfo();
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  ASSERT_EQ(CompactionReason::kFilesMarkedForCompaction, compaction->compaction_reason());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 1)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
@@ -185,6 +185,33 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   }
 }
 
+TEST_F(DBBlockCacheTest, TestPinDataBlocks) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  InitTable(options);
+
+  std::shared_ptr<Cache> cache = NewLRUCache(1024 * 1024, 0, false);
+  table_options.block_cache = cache;
+  table_options.pin_data_blocks = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_OK(Flush());
+  RecordCacheCounters(options);
+
+  // The data blocks are read with the table and never go through the block cache.
+  const std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(ToString(i)));
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->Seek(ToString(i));
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(value, iter->value().ToString());
+    CheckCacheCounters(options, 0, 0, 0, 0);
+  }
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
@@ -307,6 +307,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(env_->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -317,12 +318,16 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       opened_successfully_(false) {
   env_->GetAbsolutePath(dbname, &db_absolute_path_);
 
-  // Reserve ten files or so for other uses and give the rest to TableCache.
-  // Give a large number for setting of "infinite" open files.
-  const int table_cache_size = (db_options_.max_open_files == -1) ?
-        4194304 : db_options_.max_open_files - 10;
-  table_cache_ =
-      NewLRUCache(table_cache_size, db_options_.table_cache_numshardbits);
+  if (db_options_.table_cache) {
+    table_cache_ = NewSharedTableCacheView(db_options_.table_cache);
+  } else {
+    // Reserve ten files or so for other uses and give the rest to TableCache.
+    // Give a large number for setting of "infinite" open files.
+    const int table_cache_size = (db_options_.max_open_files == -1) ?
+          4194304 : db_options_.max_open_files - 10;
+    table_cache_ =
+        NewLRUCache(table_cache_size, db_options_.table_cache_numshardbits);
+  }
 
   versions_.reset(new VersionSet(dbname_, &db_options_, env_options_,
                                  table_cache_.get(), &write_buffer_,
@@ -1494,7 +1499,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
       s = BuildTable(dbname_,
                      env_,
                      *cfd->ioptions(),
-                     env_options_,
+                     env_options_for_compaction_,
                      cfd->table_cache(),
                      iter.get(),
                      &meta,
@@ -1569,7 +1574,7 @@ Status DBImpl::FlushMemTableToOutputFile(
   }
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options, env_options_for_compaction_,
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, mem_table_flush_filter,
       job_context, log_buffer, directories_.GetDbDir(), directories_.GetDataDir(0U),
@@ -1640,6 +1645,27 @@ uint64_t DBImpl::GetTotalSSTFileSize() {
   return total_sst_file_size;
 }
 
+int DBImpl::GetCurrentVersionNumSSTFiles() {
+  // Uses the super version, so that frequent callers don't contend for the DB mutex.
+  auto cfd = default_cf_handle_->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  const auto* storage_info = sv->current->storage_info();
+  int result = 0;
+  for (int level = 0; level < storage_info->num_levels(); ++level) {
+    result += storage_info->NumLevelFiles(level);
+  }
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  return result;
+}
+
+yb::Result<std::string> DBImpl::GetMiddleKey() {
+  auto cfd = default_cf_handle_->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  auto result = sv->current->GetMiddleKey();
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  return result;
+}
+
 void DBImpl::SetTotalSSTFileSizeTicker() {
   uint64_t total_sst_file_size = GetTotalSSTFileSize();
   SetTickerCount(stats_, TOTAL_SST_FILE_SIZE, total_sst_file_size);
@@ -1954,7 +1980,7 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, table_cache_,
@@ -2600,6 +2626,14 @@ Status DBImpl::EnableAutoCompaction(
   return s;
 }
 
+namespace {
+
+// Added to the priority of the background jobs of a DB with stopped writes, above the priority
+// of any DB without stalls.
+constexpr int kBGWorkStalledWritesPriority = 1000;
+
+} // namespace
+
 void DBImpl::MaybeScheduleFlushOrCompaction() {
   mutex_.AssertHeld();
   if (!opened_successfully_) {
@@ -2618,7 +2652,8 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
          bg_flush_scheduled_ < db_options_.max_background_flushes) {
     unscheduled_flushes_--;
     bg_flush_scheduled_++;
-    env_->Schedule(&DBImpl::BGWorkFlush, this, Env::Priority::HIGH, this);
+    env_->ScheduleWithPriority(&DBImpl::BGWorkFlush, this, Env::Priority::HIGH, this, nullptr,
+                               &DBImpl::BGWorkPriority);
   }
 
   auto bg_compactions_allowed = BGCompactionsAllowed();
@@ -2631,7 +2666,8 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
                bg_compactions_allowed) {
       unscheduled_flushes_--;
       bg_flush_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkFlush, this, Env::Priority::LOW, this);
+      env_->ScheduleWithPriority(&DBImpl::BGWorkFlush, this, Env::Priority::LOW, this, nullptr,
+                                 &DBImpl::BGWorkPriority);
     }
   }
 
@@ -2647,11 +2683,57 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
-    env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                   &DBImpl::UnscheduleCallback);
+    env_->ScheduleWithPriority(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
+                               &DBImpl::UnscheduleCallback, &DBImpl::BGWorkPriority);
   }
 }
 
+int DBImpl::BGWorkPriority(void* db) {
+  return static_cast<DBImpl*>(db)->bg_work_priority_.load(std::memory_order_relaxed);
+}
+
+void DBImpl::UpdateBGWorkPriority() {
+  mutex_.AssertHeld();
+  // Percentage of the way to the slowdown trigger, or to the maximal space amplification for
+  // universal compactions, of the most loaded column family.
+  int priority = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    const auto* vstorage = cfd->current()->storage_info();
+    const auto* mutable_cf_options = cfd->GetLatestMutableCFOptions();
+    const int num_l0_files = vstorage->NumLevelFiles(0);
+    if (mutable_cf_options->level0_slowdown_writes_trigger > 0) {
+      priority = std::max(
+          priority, num_l0_files * 100 / mutable_cf_options->level0_slowdown_writes_trigger);
+    }
+    const auto& universal_options = cfd->ioptions()->compaction_options_universal;
+    if (cfd->ioptions()->compaction_style == kCompactionStyleUniversal &&
+        universal_options.max_size_amplification_percent > 0 && num_l0_files > 1) {
+      // Files are ordered from the newest to the oldest one, which holds most of the data.
+      const auto& files = vstorage->LevelFiles(0);
+      uint64_t newer_files_size = 0;
+      for (size_t i = 0; i + 1 < files.size(); ++i) {
+        newer_files_size += files[i]->fd.GetTotalFileSize();
+      }
+      const uint64_t oldest_file_size = std::max<uint64_t>(files.back()->fd.GetTotalFileSize(), 1);
+      const uint64_t size_amplification_percent = newer_files_size * 100 / oldest_file_size;
+      priority = std::max<int>(priority, static_cast<int>(std::min<uint64_t>(
+          size_amplification_percent * 100 / universal_options.max_size_amplification_percent,
+          kBGWorkStalledWritesPriority)));
+    }
+  }
+  priority = std::min(priority, kBGWorkStalledWritesPriority);
+  // Stalled writes are the most urgent, then delayed ones.
+  if (write_controller_.IsStopped()) {
+    priority += kBGWorkStalledWritesPriority;
+  } else if (write_controller_.NeedsDelay()) {
+    priority += kBGWorkStalledWritesPriority / 2;
+  }
+  bg_work_priority_.store(priority, std::memory_order_relaxed);
+}
+
 int DBImpl::BGCompactionsAllowed() const {
   if (write_controller_.NeedSpeedupCompaction()) {
     return db_options_.max_background_compactions;
@@ -3102,7 +3184,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+           kCompactionStyleFIFO ||
+           c->column_family_data()->ioptions()->compaction_style ==
+           kCompactionStyleUniversal);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3188,7 +3272,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -3478,6 +3562,7 @@ std::unique_ptr<SuperVersion> DBImpl::InstallSuperVersionAndScheduleWork(
   // compactions.
   SchedulePendingFlush(cfd);
   SchedulePendingCompaction(cfd);
+  UpdateBGWorkPriority();
   MaybeScheduleFlushOrCompaction();
 
   // Update max_total_in_memory_state_
@@ -4581,8 +4666,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 3. Deletes or SingleDeletes are not okay if filtering deletes
     //    (controlled by both batch and memtable setting)
     // 4. Merges are not okay
-    // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
-    //    parallel memtable writes.
+    //
+    // User frontiers of the batches are merged into the memtable under its own lock, so they do
+    // not prevent parallel writes.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
@@ -5646,6 +5732,14 @@ Status DB::Open(const DBOptions& db_options, const std::string& dbname,
     return s;
   }
 
+  if (db_options.allow_mmap_reads &&
+      (db_options.use_direct_reads || db_options.use_direct_io_for_flush_and_compaction)) {
+    return STATUS(NotSupported, "Direct I/O reads are not supported together with mmap reads");
+  }
+  if (db_options.allow_mmap_writes && db_options.use_direct_io_for_flush_and_compaction) {
+    return STATUS(NotSupported, "Direct I/O writes are not supported together with mmap writes");
+  }
+
   for (auto& cfd : column_families) {
     s = CheckCompressionSupported(cfd.options);
     if (s.ok() && db_options.allow_concurrent_memtable_write) {
@@ -597,6 +597,10 @@ class DBImpl : public DB {
   static void BGWorkCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void UnscheduleCallback(void* arg);
+  // Priority of the background jobs of the DB in the thread pools shared with other DBs.
+  static int BGWorkPriority(void* db);
+  // Recalculates bg_work_priority_ from the shape of the current versions and the write stalls.
+  void UpdateBGWorkPriority();
   void BackgroundCallCompaction(void* arg);
   void BackgroundCallFlush();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
@@ -612,6 +616,10 @@ class DBImpl : public DB {
 
   uint64_t GetTotalSSTFileSize() override;
 
+  int GetCurrentVersionNumSSTFiles() override;
+
+  yb::Result<std::string> GetMiddleKey() override;
+
   void SetTotalSSTFileSizeTicker();
 
   void PrintStatistics();
@@ -836,6 +844,10 @@ class DBImpl : public DB {
   // number of background memtable flush jobs, submitted to the HIGH pool
   int bg_flush_scheduled_;
 
+  // Pools are shared by all DBs of the Env, so jobs of the DBs that are closer to write stalls
+  // are picked first. Written under mutex_, read by the pools without it.
+  std::atomic<int> bg_work_priority_{0};
+
   // stores the number of flushes are currently running
   int num_running_flushes_;
 
@@ -900,6 +912,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write the table files of flushes and compactions
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
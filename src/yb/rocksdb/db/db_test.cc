@@ -5317,8 +5317,123 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, DocumentSkipListMemtable) {
+  Options options = CurrentOptions();
+  // Keys sharing the first 7 bytes form a document: "key0001" holds Key(100) ... Key(199).
+  options.memtable_factory.reset(NewDocumentSkipListRepFactory(
+      std::shared_ptr<const SliceTransform>(NewCappedPrefixTransform(7)), 16));
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeysPerThread = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      // Keys of different threads interleave, so that they are inserted into the same documents.
+      for (int i = 0; i < kNumKeysPerThread; ++i) {
+        const int key = i * kNumThreads + t;
+        ASSERT_OK(Put(Key(key), ToString(key)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::map<std::string, std::string> expected;
+  for (int key = 0; key < kNumThreads * kNumKeysPerThread; ++key) {
+    expected[Key(key)] = ToString(key);
+  }
+  // Keys that are not longer than the prefix map to themselves.
+  for (const auto& key : {"key", "key0", "key0001"}) {
+    ASSERT_OK(Put(key, key));
+    expected[key] = key;
+  }
+  ASSERT_OK(Put(Key(150), "updated"));
+  expected[Key(150)] = "updated";
+
+  for (int flushed = 0; flushed <= 1; ++flushed) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto it = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_NE(expected.end(), it);
+      ASSERT_EQ(it->first, iter->key().ToString());
+      ASSERT_EQ(it->second, iter->value().ToString());
+    }
+    ASSERT_EQ(expected.end(), it);
+
+    auto rit = expected.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+      ASSERT_NE(expected.rend(), rit);
+      ASSERT_EQ(rit->first, iter->key().ToString());
+    }
+    ASSERT_EQ(expected.rend(), rit);
+
+    // Seek within a document, past the end of a document and into a missing document.
+    iter->Seek(Key(150) + "a");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(151), iter->key().ToString());
+    iter->Seek(Key(199) + "a");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(200), iter->key().ToString());
+    iter->Prev();
+    ASSERT_EQ(Key(199), iter->key().ToString());
+    iter->Seek("key0000");
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(0), iter->key().ToString());
+    iter->Seek(Key(kNumThreads * kNumKeysPerThread));
+    ASSERT_FALSE(iter->Valid());
+
+    for (const auto& entry : expected) {
+      ASSERT_EQ(entry.second, Get(entry.first));
+    }
+    ASSERT_EQ("NOT_FOUND", Get(Key(150) + "a"));
+    ASSERT_EQ("NOT_FOUND", Get("key00"));
+
+    iter.reset();
+    ASSERT_OK(Flush());
+  }
+}
+
 #endif  // ROCKSDB_LITE
 
+TEST_F(DBTest, ConcurrentMemtableWritesWithFrontiers) {
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumBatchesPerThread = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i < kNumBatchesPerThread; ++i) {
+        const uint64_t value = 1 + t * kNumBatchesPerThread + i;
+        test::TestUserFrontiers frontiers(value, value);
+        WriteBatch batch;
+        batch.SetFrontiers(&frontiers);
+        batch.Put(Key(static_cast<int>(value)), ToString(value));
+        batch.Put(Key(static_cast<int>(value)) + "_", ToString(value));
+        ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_OK(Flush());
+  ASSERT_EQ(static_cast<uint64_t>(kNumThreads * kNumBatchesPerThread),
+            down_cast<test::TestUserFrontier&>(*dbfull()->GetFlushedFrontier()).Value());
+  for (int value = 1; value <= kNumThreads * kNumBatchesPerThread; ++value) {
+    ASSERT_EQ(ToString(value), Get(Key(value)));
+    ASSERT_EQ(ToString(value), Get(Key(value) + "_"));
+  }
+}
+
 TEST_F(DBTest, SanitizeNumThreads) {
   for (int attempt = 0; attempt < 2; attempt++) {
     const size_t kTotalTasks = 8;
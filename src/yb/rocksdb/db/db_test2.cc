@@ -72,6 +72,114 @@ TEST_F(DBTest2, IteratorPropertyVersionNumber) {
   delete iter2;
   delete iter3;
 }
+
+TEST_F(DBTest2, IteratorReadahead) {
+  constexpr int kNumKeys = 1000;
+  Options options = CurrentOptions();
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'v')));
+  }
+  ASSERT_OK(Flush());
+
+  // Reopen, so that the table file is opened through the counting file.
+  env_->count_random_reads_ = true;
+  Reopen(options);
+
+  auto scan = [this](size_t max_readahead_size) {
+    env_->random_prefetch_counter_.Reset();
+    ReadOptions read_options;
+    read_options.max_readahead_size = max_readahead_size;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+    }
+    EXPECT_OK(iter->status());
+    EXPECT_EQ(kNumKeys, num_keys);
+    return env_->random_prefetch_counter_.Read();
+  };
+
+  ASSERT_EQ(0, scan(0));
+  // About a hundred data blocks are prefetched by ranges of up to 16 blocks.
+  const int num_prefetches = scan(16 * 1024);
+  ASSERT_GT(num_prefetches, 0);
+  ASSERT_LT(num_prefetches, 30);
+
+  env_->random_prefetch_counter_.Reset();
+  for (int i = 0; i < kNumKeys; i += 10) {
+    ASSERT_EQ(std::string(100, 'v'), Get(Key(i)));
+  }
+  ASSERT_EQ(0, env_->random_prefetch_counter_.Read());
+}
+
+TEST_F(DBTest2, GetMiddleKey) {
+  constexpr int kNumKeys = 1000;
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  ASSERT_TRUE(db_->GetMiddleKey().status().IsIncomplete());
+
+  // The smaller file should not affect the result.
+  for (int i = kNumKeys; i < kNumKeys + 10; ++i) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'v')));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'v')));
+  }
+  ASSERT_OK(Flush());
+
+  auto middle_key = db_->GetMiddleKey();
+  ASSERT_OK(middle_key);
+  ASSERT_GT(*middle_key, Key(kNumKeys * 2 / 5));
+  ASSERT_LT(*middle_key, Key(kNumKeys * 3 / 5));
+}
+
+TEST_F(DBTest2, SharedTableCache) {
+  constexpr int kNumFiles = 3;
+  constexpr size_t kMaxOpenFiles = 4;
+  Options options = CurrentOptions();
+  // Both DBs have more files than fit into the cache together.
+  options.table_cache = NewLRUCache(kMaxOpenFiles, 0 /* num_shard_bits */);
+  Reopen(options);
+
+  // The files of the other DB have the same numbers.
+  const std::string other_dbname = dbname_ + "_other";
+  ASSERT_OK(DestroyDB(other_dbname, options));
+  DB* other_db = nullptr;
+  ASSERT_OK(DB::Open(options, other_dbname, &other_db));
+  std::unique_ptr<DB> other_db_holder(other_db);
+  for (int i = 0; i < kNumFiles; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+    ASSERT_OK(Flush());
+    ASSERT_OK(other_db->Put(WriteOptions(), Key(i), "other_value"));
+    ASSERT_OK(other_db->Flush(FlushOptions()));
+  }
+
+  for (int i = 0; i < kNumFiles; ++i) {
+    ASSERT_EQ("value", Get(Key(i)));
+    std::string value;
+    ASSERT_OK(other_db->Get(ReadOptions(), Key(i), &value));
+    ASSERT_EQ("other_value", value);
+    ASSERT_LE(options.table_cache->GetUsage(), kMaxOpenFiles);
+  }
+
+  // The table readers of a closed DB are erased from the shared cache.
+  ASSERT_GT(options.table_cache->GetUsage(), 0);
+  Close();
+  other_db_holder.reset();
+  ASSERT_EQ(0, options.table_cache->GetUsage());
+  ASSERT_OK(DestroyDB(other_dbname, options));
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -377,23 +377,29 @@ class SpecialEnv : public EnvWrapper {
     class CountingFile : public RandomAccessFile {
      public:
       CountingFile(unique_ptr<RandomAccessFile>&& target,
-                   anon::AtomicCounter* counter)
-          : target_(std::move(target)), counter_(counter) {}
+                   anon::AtomicCounter* counter,
+                   anon::AtomicCounter* prefetch_counter)
+          : target_(std::move(target)), counter_(counter), prefetch_counter_(prefetch_counter) {}
       virtual Status Read(uint64_t offset, size_t n, Slice* result,
                           char* scratch) const override {
         counter_->Increment();
         return target_->Read(offset, n, result, scratch);
       }
+      virtual Status Prefetch(uint64_t offset, size_t n) override {
+        prefetch_counter_->Increment();
+        return target_->Prefetch(offset, n);
+      }
 
      private:
       unique_ptr<RandomAccessFile> target_;
       anon::AtomicCounter* counter_;
+      anon::AtomicCounter* prefetch_counter_;
     };
 
     Status s = target()->NewRandomAccessFile(f, r, soptions);
     random_file_open_counter_++;
     if (s.ok() && count_random_reads_) {
-      r->reset(new CountingFile(std::move(*r), &random_read_counter_));
+      r->reset(new CountingFile(std::move(*r), &random_read_counter_, &random_prefetch_counter_));
     }
     return s;
   }
@@ -483,6 +489,7 @@ class SpecialEnv : public EnvWrapper {
 
   bool count_random_reads_;
   anon::AtomicCounter random_read_counter_;
+  anon::AtomicCounter random_prefetch_counter_;
   std::atomic<int> random_file_open_counter_;
 
   bool count_sequential_reads_;
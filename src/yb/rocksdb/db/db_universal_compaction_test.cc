@@ -21,6 +21,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <mutex>
+
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
 #if !defined(ROCKSDB_LITE)
@@ -128,6 +130,77 @@ class DelayFilterFactory : public CompactionFilterFactory {
  private:
   DBTestBase* db_test;
 };
+
+// Records the key groups seen by each filter, where a group is a key prefix of the given length,
+// to check that subcompactions do not split groups.
+class GroupFilterFactory : public CompactionFilterFactory {
+ public:
+  explicit GroupFilterFactory(size_t group_prefix_size) : group_prefix_size_(group_prefix_size) {}
+
+  class GroupFilter : public CompactionFilter {
+   public:
+    explicit GroupFilter(GroupFilterFactory* factory) : factory_(factory) {}
+
+    ~GroupFilter() {
+      std::lock_guard<std::mutex> lock(factory_->mutex_);
+      for (const auto& group : groups_) {
+        if (!factory_->groups_.insert(group).second) {
+          factory_->split_groups_.insert(group);
+        }
+      }
+    }
+
+    bool Filter(int level, const Slice& key, const Slice& value, std::string* new_value,
+                bool* value_changed) const override {
+      groups_.insert(key.ToBuffer().substr(0, factory_->group_prefix_size_));
+      return false;
+    }
+
+    const char* Name() const override { return "GroupFilter"; }
+
+   private:
+    GroupFilterFactory* factory_;
+    mutable std::set<std::string> groups_;
+  };
+
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return std::make_unique<GroupFilter>(this);
+  }
+
+  Slice SubcompactionBoundary(const Slice& user_key) override {
+    return Slice(user_key.data(), std::min(user_key.size(), group_prefix_size_));
+  }
+
+  const char* Name() const override { return "GroupFilterFactory"; }
+
+  std::set<std::string> split_groups() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return split_groups_;
+  }
+
+ private:
+  const size_t group_prefix_size_;
+  std::mutex mutex_;
+  std::set<std::string> groups_;
+  std::set<std::string> split_groups_;
+};
+
+// Keys are prefixed with a single digit time window, so a file belongs to the window of its
+// smallest key.
+class TimeWindowFilterFactory : public CompactionFilterFactory {
+ public:
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return std::make_unique<KeepFilter>();
+  }
+
+  int64_t TimeWindow(const FileMetaData& file) override {
+    return file.smallest.key.user_key()[0] - '0';
+  }
+
+  const char* Name() const override { return "TimeWindowFilterFactory"; }
+};
 }  // namespace
 
 // Make sure we don't trigger a problem if the trigger conditon is given
@@ -1270,6 +1343,108 @@ TEST_P(DBTestUniversalCompaction, UniversalCompactionSecondPathRatio) {
   Destroy(options);
 }
 
+TEST_P(DBTestUniversalCompaction, UniversalCompactionSubcompactions) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.write_buffer_size = 4 << 20;  // 4MB
+  options.level0_file_num_compaction_trigger = 4;
+  options.max_subcompactions = 4;
+  // Groups of 100 keys, i.e. "key0001" for keys from key000100 to key000199.
+  auto* filter_factory = new GroupFilterFactory(7);
+  options.compaction_filter_factory.reset(filter_factory);
+  DestroyAndReopen(options);
+
+  std::atomic<int> num_subcompactions(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():Inprogress", [&](void* arg) { num_subcompactions.fetch_add(1); });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  std::map<std::string, std::string> values;
+  for (int num = 0; num < options.level0_file_num_compaction_trigger; num++) {
+    // Files overlap partially, so their boundaries split the key space into several ranges.
+    for (int i = num * 250; i < num * 250 + 1000; i++) {
+      values[Key(i)] = RandomString(&rnd, 100);
+      ASSERT_OK(Put(Key(i), values[Key(i)]));
+    }
+    ASSERT_OK(Flush());
+  }
+  dbfull()->TEST_WaitForCompact();
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(num_subcompactions.load(), 1);
+  ASSERT_TRUE(filter_factory->split_groups().empty());
+  // Each subcompaction wrote a single file of disjoint keys. They form one sorted run, so they
+  // were not picked for another compaction.
+  int num_files = 0;
+  for (int level = 0; level < num_levels_; level++) {
+    num_files += NumTableFilesAtLevel(level);
+  }
+  ASSERT_EQ(num_subcompactions.load(), num_files);
+
+  for (const auto& entry : values) {
+    ASSERT_EQ(entry.second, Get(entry.first));
+  }
+  Reopen(options);
+  for (const auto& entry : values) {
+    ASSERT_EQ(entry.second, Get(entry.first));
+  }
+}
+
+TEST_P(DBTestUniversalCompaction, UniversalCompactionTimeWindows) {
+  if (num_levels_ != 1) {
+    return;
+  }
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.write_buffer_size = 4 << 20;  // 4MB
+  options.level0_file_num_compaction_trigger = 4;
+  options.compaction_filter_factory = std::make_shared<TimeWindowFilterFactory>();
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::map<std::string, std::string> values;
+  auto write_file = [&](int window, int num) {
+    for (int i = num * 100; i < num * 100 + 100; i++) {
+      const std::string key = ToString(window) + Key(i);
+      values[key] = RandomString(&rnd, 100);
+      ASSERT_OK(Put(key, values[key]));
+    }
+    ASSERT_OK(Flush());
+    dbfull()->TEST_WaitForCompact();
+  };
+
+  for (int num = 0; num < 3; num++) {
+    write_file(0, num);
+  }
+  ASSERT_EQ(3, NumTableFilesAtLevel(0));
+  // The first flush of a new window closes the previous one, whose files are merged.
+  write_file(1, 0);
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  // Files of the open window are compacted as usual, but never with files of another window.
+  for (int num = 1; num < 8; num++) {
+    write_file(1, num);
+  }
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  int num_window_0_files = 0;
+  for (const auto& file : files) {
+    ASSERT_EQ(file.smallest.key[0], file.largest.key[0]) << file.ToString();
+    if (file.smallest.key[0] == '0') {
+      num_window_0_files++;
+    }
+  }
+  ASSERT_EQ(1, num_window_0_files);
+
+  for (const auto& entry : values) {
+    ASSERT_EQ(entry.second, Get(entry.first));
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(UniversalCompactionNumLevels, DBTestUniversalCompaction,
                         ::testing::Combine(::testing::Values(1, 3, 5),
                                            ::testing::Bool()));
@@ -45,6 +45,7 @@
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/statistics.h"
@@ -248,6 +249,16 @@ Status FlushJob::WriteLevel0Table(const autovector<MemTable*>& mems,
 
     TableFileCreationInfo info;
     {
+      std::unique_ptr<CompactionFilter> compaction_filter;
+      auto* compaction_filter_factory = cfd_->ioptions()->compaction_filter_factory;
+      if (compaction_filter_factory != nullptr && compaction_filter_factory->FilterFlushes()) {
+        CompactionFilter::Context context;
+        context.is_full_compaction = false;
+        context.is_manual_compaction = false;
+        context.column_family_id = cfd_->GetID();
+        context.is_flush = true;
+        compaction_filter = compaction_filter_factory->CreateCompactionFilter(context);
+      }
       ScopedArenaIterator iter(
           NewMergingIterator(&cfd_->internal_comparator(), &memtables[0],
                              static_cast<int>(memtables.size()), &arena));
@@ -275,7 +286,8 @@ Status FlushJob::WriteLevel0Table(const autovector<MemTable*>& mems,
                      cfd_->internal_stats(),
                      db_options_.boundary_extractor.get(),
                      Env::IO_HIGH,
-                     &table_properties_);
+                     &table_properties_,
+                     compaction_filter.get());
       info.table_properties = table_properties_;
       LogFlush(db_options_.info_log);
     }
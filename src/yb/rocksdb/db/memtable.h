@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,7 @@
 #include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/dynamic_bloom.h"
 #include "yb/rocksdb/util/instrumented_mutex.h"
+#include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/mutable_cf_options.h"
 
 namespace rocksdb {
@@ -60,6 +62,7 @@ struct MemTableOptions {
       const MutableCFOptions& mutable_cf_options);
   size_t write_buffer_size;
   size_t arena_block_size;
+  int memtable_numa_node;
   uint32_t memtable_prefix_bloom_bits;
   uint32_t memtable_prefix_bloom_probes;
   size_t memtable_prefix_bloom_huge_page_tlb_size;
@@ -322,7 +325,9 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be called concurrently by writers of a parallel write group.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<SpinMutex> lock(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->Merge(value);
     } else {
@@ -380,6 +385,7 @@ class MemTable {
 
   Env* env_;
 
+  SpinMutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
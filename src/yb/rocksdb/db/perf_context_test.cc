@@ -604,6 +604,29 @@ TEST_F(PerfContextTest, FalseDBMutexWait) {
   }
 }
 
+TEST_F(PerfContextTest, IteratorCounts) {
+  DestroyDB(kDbName, Options());
+  auto db = OpenDb();
+  WriteOptions write_options;
+  ReadOptions read_options;
+
+  for (int i = 0; i < 10; ++i) {
+    db->Put(write_options, "k" + ToString(i), "v" + ToString(i));
+  }
+
+  std::unique_ptr<Iterator> iter(db->NewIterator(read_options));
+  perf_context.Reset();
+  iter->Seek("k2");
+  ASSERT_TRUE(iter->Valid());
+  iter->Next();
+  iter->Next();
+  iter->Prev();
+  iter->SeekToFirst();
+  iter->SeekToLast();
+  ASSERT_EQ(3U, perf_context.iter_seek_count);
+  ASSERT_EQ(3U, perf_context.iter_next_count);
+}
+
 TEST_F(PerfContextTest, ToString) {
   perf_context.Reset();
   perf_context.block_read_count = 12345;
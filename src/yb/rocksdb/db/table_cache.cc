@@ -23,6 +23,9 @@
 
 #include "yb/rocksdb/db/table_cache.h"
 
+#include <mutex>
+#include <unordered_set>
+
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/version_edit.h"
@@ -165,6 +168,14 @@ Status TableCache::GetTableReader(
     }
     (*table_reader)->SetDataFileReader(std::move(data_file_reader));
   }
+  // Readers opened for compactions read each block once, so there is no point in pinning them.
+  if (!sequential_mode) {
+    s = (*table_reader)->PinDataBlocks();
+    if (!s.ok()) {
+      table_reader->reset();
+      return s;
+    }
+  }
   TEST_SYNC_POINT("TableCache::GetTableReader:0");
   return s;
 }
@@ -231,8 +242,10 @@ Status TableCache::DoGetTableReaderForIterator(
     HistogramImpl* file_read_hist,
     bool for_compaction,
     bool skip_filters) {
+  // Cached table readers can not be shared with compactions that read their inputs differently.
   const bool create_new_table_reader =
-      (for_compaction && ioptions_.new_table_reader_for_compaction_inputs);
+      for_compaction && (ioptions_.new_table_reader_for_compaction_inputs ||
+                         env_options.use_direct_reads != env_options_.use_direct_reads);
   if (create_new_table_reader) {
     unique_ptr<TableReader> table_reader_unique_ptr;
     Status s = GetTableReader(
@@ -436,6 +449,25 @@ Status TableCache::GetTableProperties(
   return s;
 }
 
+yb::Result<std::string> TableCache::GetMiddleKey(
+    const EnvOptions& env_options,
+    const InternalKeyComparator& internal_comparator, const FileDescriptor& fd) {
+  auto table_reader = fd.table_reader;
+  // table already been pre-loaded?
+  if (table_reader) {
+    return table_reader->GetMiddleKey();
+  }
+
+  Cache::Handle* table_handle = nullptr;
+  RETURN_NOT_OK(FindTable(
+      env_options, internal_comparator, fd, &table_handle, kDefaultQueryId));
+  assert(table_handle);
+  auto table = GetTableReaderFromHandle(table_handle);
+  auto result = table->GetMiddleKey();
+  ReleaseHandle(table_handle);
+  return result;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const EnvOptions& env_options,
     const InternalKeyComparator& internal_comparator,
@@ -463,4 +495,96 @@ void TableCache::Evict(Cache* cache, uint64_t file_number) {
   cache->Erase(GetSliceForFileNumber(&file_number));
 }
 
+namespace {
+
+// The table readers of a single DB in a cache shared by several DBs. Keys are prefixed with an id
+// of the view, since file numbers are only unique within a DB. The table readers of the DB that
+// are left in the shared cache when the view is destroyed are erased, they refer to the options
+// of the DB.
+class SharedTableCacheView : public Cache {
+ public:
+  explicit SharedTableCacheView(std::shared_ptr<Cache> shared_cache)
+      : shared_cache_(std::move(shared_cache)) {
+    PutVarint64(&prefix_, shared_cache_->NewId());
+  }
+
+  ~SharedTableCacheView() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& key : keys_) {
+      shared_cache_->Erase(key);
+    }
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Handle** handle,
+                Statistics* statistics) override {
+    std::string shared_key = SharedKey(key);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      keys_.insert(shared_key);
+    }
+    return shared_cache_->Insert(
+        shared_key, query_id, value, charge, deleter, handle, statistics);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    return shared_cache_->Lookup(SharedKey(key), query_id, statistics);
+  }
+
+  void Release(Handle* handle) override { shared_cache_->Release(handle); }
+
+  void* Value(Handle* handle) override { return shared_cache_->Value(handle); }
+
+  void Erase(const Slice& key) override {
+    std::string shared_key = SharedKey(key);
+    shared_cache_->Erase(shared_key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    keys_.erase(shared_key);
+  }
+
+  uint64_t NewId() override { return shared_cache_->NewId(); }
+
+  // The capacity is the budget of the shared cache, and is not changed by a single DB.
+  void SetCapacity(size_t capacity) override {}
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {}
+  bool HasStrictCapacityLimit() const override { return shared_cache_->HasStrictCapacityLimit(); }
+  size_t GetCapacity() const override { return shared_cache_->GetCapacity(); }
+  size_t GetUsage() const override { return shared_cache_->GetUsage(); }
+  size_t GetUsage(Handle* handle) const override { return shared_cache_->GetUsage(handle); }
+  size_t GetPinnedUsage() const override { return shared_cache_->GetPinnedUsage(); }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return shared_cache_->GetSubCacheType(e);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    shared_cache_->ApplyToAllCacheEntries(callback, thread_safe);
+  }
+
+  // Metrics are set up by the owner of the shared cache.
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {}
+
+ private:
+  std::string SharedKey(const Slice& key) const {
+    std::string result = prefix_;
+    result.append(key.cdata(), key.size());
+    return result;
+  }
+
+  const std::shared_ptr<Cache> shared_cache_;
+  std::string prefix_;
+
+  // Keys of the table readers inserted by this view and not erased yet. Those evicted by the
+  // shared cache are only removed when their files are deleted, so this is bounded by the number
+  // of files of the DB.
+  std::mutex mutex_;
+  std::unordered_set<std::string> keys_;
+};
+
+} // namespace
+
+std::shared_ptr<Cache> NewSharedTableCacheView(std::shared_ptr<Cache> shared_cache) {
+  return std::make_shared<SharedTableCacheView>(std::move(shared_cache));
+}
+
 }  // namespace rocksdb
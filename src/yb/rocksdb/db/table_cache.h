@@ -28,6 +28,7 @@
 #pragma once
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -132,6 +133,11 @@ class TableCache {
                             std::shared_ptr<const TableProperties>* properties,
                             bool no_io = false);
 
+  // Get the approximate middle key of a given table, see TableReader::GetMiddleKey.
+  yb::Result<std::string> GetMiddleKey(const EnvOptions& toptions,
+                                       const InternalKeyComparator& internal_comparator,
+                                       const FileDescriptor& file_meta);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
@@ -169,6 +175,10 @@ class TableCache {
   std::string row_cache_id_;
 };
 
+// Returns the cache of table readers of a single DB, backed by the given cache shared with other
+// DBs, see DBOptions::table_cache.
+std::shared_ptr<Cache> NewSharedTableCacheView(std::shared_ptr<Cache> shared_cache);
+
 }  // namespace rocksdb
 
 #endif // YB_ROCKSDB_DB_TABLE_CACHE_H
@@ -621,6 +621,28 @@ Status Version::GetTableProperties(std::shared_ptr<const TableProperties>* tp,
   return s;
 }
 
+yb::Result<std::string> Version::GetMiddleKey() {
+  // Largest file is the one that benefits most from a split, and its middle key is good
+  // approximation of the middle key of the whole version.
+  const FileMetaData* largest_file = nullptr;
+  for (int level = 0; level < storage_info_.num_levels_; ++level) {
+    for (const auto* file : storage_info_.LevelFiles(level)) {
+      if (largest_file == nullptr ||
+          file->fd.GetTotalFileSize() > largest_file->fd.GetTotalFileSize()) {
+        largest_file = file;
+      }
+    }
+  }
+  if (largest_file == nullptr) {
+    return STATUS(Incomplete, "Version doesn't have any SST files");
+  }
+
+  auto internal_key = cfd_->table_cache()->GetMiddleKey(
+      vset_->env_options_, cfd_->internal_comparator(), largest_file->fd);
+  RETURN_NOT_OK(internal_key);
+  return ExtractUserKey(*internal_key).ToBuffer();
+}
+
 Status Version::GetPropertiesOfAllTables(TablePropertiesCollection* props) {
   Status s;
   for (int level = 0; level < storage_info_.num_levels_; level++) {
@@ -1236,10 +1258,15 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          if (compaction_style_ != kCompactionStyleUniversal || prev == nullptr ||
+              !InSameSortedRun(*prev, *f)) {
+            num_sorted_runs++;
+          }
+          prev = f;
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
@@ -1873,13 +1900,18 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
   int num_l0_count = 0;
-  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max()) {
+  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max() &&
+      compaction_style_ != kCompactionStyleUniversal) {
     num_l0_count = static_cast<int>(files_[0].size());
   } else {
+    const FileMetaData* prev = nullptr;
     for (const auto& file : files_[0]) {
-      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
+      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction &&
+          (compaction_style_ != kCompactionStyleUniversal || prev == nullptr ||
+           !InSameSortedRun(*prev, *file))) {
         ++num_l0_count;
       }
+      prev = file;
     }
   }
   if (compaction_style_ == kCompactionStyleUniversal) {
@@ -2090,7 +2122,7 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(env_->OptimizeForCompactionTableRead(env_options_, *db_options_)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -212,6 +212,13 @@ class VersionStorageInfo {
 
   int num_levels() const { return num_levels_; }
 
+  // Whether the given consecutive level 0 files, ordered newest first, belong to the same sorted
+  // run. Level 0 files have disjoint sequence number ranges, except for the outputs of a single
+  // compaction split into subcompactions: those cover disjoint key ranges, and form one run.
+  static bool InSameSortedRun(const FileMetaData& newer, const FileMetaData& older) {
+    return older.largest.seqno >= newer.smallest.seqno;
+  }
+
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   int num_non_empty_levels() const {
     assert(finalized_);
@@ -493,6 +500,9 @@ class Version {
                             const FileMetaData* file_meta,
                             const std::string* fname = nullptr) const;
 
+  // Returns the approximate middle user key of the largest SST file of this version.
+  yb::Result<std::string> GetMiddleKey();
+
   // REQUIRES: lock is held
   // On success, *props will be populated with all SSTables' table properties.
   // The keys of `props` are the sst file name, the values of `props` are the
@@ -104,6 +104,12 @@ struct EnvOptions {
   // If true, then use mmap to write data
   bool use_mmap_writes = true;
 
+  // If true, then read data with direct I/O, bypassing the OS page cache
+  bool use_direct_reads = false;
+
+  // If true, then write data with direct I/O, bypassing the OS page cache
+  bool use_direct_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -303,6 +309,18 @@ class Env {
                         Priority pri = LOW, void* tag = nullptr,
                         void (*unschedFunction)(void* arg) = 0) = 0;
 
+  // Same as Schedule, but once a thread of the pool becomes free, the queued job whose
+  // priority(tag) is the highest runs first, ties are broken in FIFO order. The priority is
+  // evaluated while the job waits, under the lock of the pool, so it should be cheap and must not
+  // block. Jobs scheduled without a priority function have priority 0.
+  //
+  // Environments without prioritized pools run the jobs in FIFO order.
+  virtual void ScheduleWithPriority(void (*function)(void* arg), void* arg, Priority pri,
+                                    void* tag, void (*unschedFunction)(void* arg),
+                                    int (*priority)(void* tag)) {
+    Schedule(function, arg, pri, tag, unschedFunction);
+  }
+
   // Arrange to remove jobs for given arg from the queue_ if they are not
   // already scheduled. Caller is expected to have exclusive lock on arg.
   virtual int UnSchedule(void* arg, Priority pri) { return 0; }
@@ -384,6 +402,16 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for writing the table files of flushes and
+  // compactions.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
+  // OptimizeForCompactionTableRead will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for reading the table files of compaction
+  // inputs.
+  virtual EnvOptions OptimizeForCompactionTableRead(const EnvOptions& env_options,
+                                                    const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -487,6 +515,12 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Start reading n bytes from the file starting at "offset" in the background, so that the
+  // following reads of this range do not wait for the device. Does not wait for the data.
+  virtual Status Prefetch(uint64_t offset, size_t n) {
+    return STATUS(NotSupported, "Prefetch not supported.");
+  }
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -929,6 +963,11 @@ class EnvWrapper : public Env {
     return target_->Schedule(f, a, pri, tag, u);
   }
 
+  void ScheduleWithPriority(void (*f)(void* arg), void* a, Priority pri, void* tag,
+                            void (*u)(void* arg), int (*priority)(void* tag)) override {
+    return target_->ScheduleWithPriority(f, a, pri, tag, u, priority);
+  }
+
   int UnSchedule(void* tag, Priority pri) override {
     return target_->UnSchedule(tag, pri);
   }
@@ -198,12 +198,15 @@ extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 // some metadata added.
 // error_rate: expected false positive error rate to calculate maximum number of keys to store in
 // each filter block. This is used to determine whether a filter block is full.
+// split_block: set all bits of a key within a handful of words of one cache line, so that a lookup
+// tests them with a few vector instructions. The reader recognizes both layouts.
 //
 // Callers must delete the result after any database that is using the filter policy has been
 // closed.
 extern const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                                     double error_rate,
-                                                    Logger* logger);
+                                                    Logger* logger,
+                                                    bool split_block = false);
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_FILTER_POLICY_H
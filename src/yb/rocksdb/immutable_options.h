@@ -57,6 +57,8 @@ struct ImmutableCFOptions {
                                    Slice delta_value,
                                    std::string* merged_value);
 
+  int memtable_numa_node;
+
   Logger* info_log;
 
   Statistics* statistics;
@@ -72,8 +72,12 @@ enum class CompactionReason {
   kFIFOMaxSize,
   // Manual compaction
   kManualCompaction,
-  // DB::SuggestCompactRange() marked files for compaction
+  // DB::SuggestCompactRange() or a table properties collector marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] CompactionFilterFactory::FilesToDrop() returned files that could be dropped
+  kFilesToDrop,
+  // [Universal] CompactionFilterFactory::TimeWindow() of the files is older than the newest one
+  kUniversalTimeWindow,
 };
 
 #ifndef ROCKSDB_LITE
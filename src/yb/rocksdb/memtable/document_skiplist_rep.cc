@@ -0,0 +1,325 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef ROCKSDB_LITE
+#include "yb/rocksdb/memtable/document_skiplist_rep.h"
+
+#include <atomic>
+#include <mutex>
+
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/util/arena.h"
+#include "yb/util/slice.h"
+#include "yb/rocksdb/slice_transform.h"
+#include "yb/rocksdb/util/murmurhash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/db/skiplist.h"
+
+namespace rocksdb {
+namespace {
+
+// Keeps the entries of each document, i.e. of all keys sharing the same document transform, in
+// a small skip list of its own. Documents are found by hash for point operations, and are also
+// kept in a skip list ordered by their prefixes, so that the rep provides a full ordered iterator.
+//
+// Scans within a document only touch that document's entries, and inserts into different
+// documents only contend while a new document is being published.
+class DocumentSkipListRep : public MemTableRep {
+ public:
+  DocumentSkipListRep(const MemTableRep::KeyComparator& compare,
+                      MemTableAllocator* allocator, const SliceTransform* transform,
+                      size_t bucket_size, int32_t skiplist_height,
+                      int32_t skiplist_branching_factor);
+
+  void Insert(KeyHandle handle) override;
+
+  void InsertConcurrently(KeyHandle handle) override {
+    Insert(handle);
+  }
+
+  bool Contains(const char* key) const override;
+
+  size_t ApproximateMemoryUsage() override;
+
+  virtual void Get(const LookupKey& k, void* callback_args,
+                   bool (*callback_func)(void* arg,
+                                         const char* entry)) override;
+
+  virtual ~DocumentSkipListRep();
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override;
+
+ private:
+  typedef SkipList<const char*, const MemTableRep::KeyComparator&> Entries;
+
+  struct Document {
+    explicit Document(Slice prefix_, Entries* entries_ = nullptr)
+        : prefix(prefix_), entries(entries_), next_in_bucket(nullptr) {}
+
+    // Points into the key of the first entry inserted into the document.
+    const Slice prefix;
+    Entries* const entries;
+    // Serializes writers of entries, readers don't take it.
+    SpinMutex mutex;
+    std::atomic<Document*> next_in_bucket;
+  };
+
+  struct DocumentComparator {
+    int operator()(const Document* lhs, const Document* rhs) const {
+      return lhs->prefix.compare(rhs->prefix);
+    }
+  };
+
+  typedef SkipList<const Document*, DocumentComparator> Documents;
+
+  size_t bucket_size_;
+
+  const int32_t skiplist_height_;
+  const int32_t skiplist_branching_factor_;
+
+  // Each bucket is a linked list of documents with the same prefix hash.
+  std::atomic<Document*>* buckets_;
+
+  // All documents ordered by prefix. Modified only under documents_mutex_.
+  Documents documents_;
+  SpinMutex documents_mutex_;
+
+  // Maps user keys to the prefixes of their documents.
+  const SliceTransform* transform_;
+
+  const MemTableRep::KeyComparator& compare_;
+  // immutable after construction
+  MemTableAllocator* const allocator_;
+
+  inline size_t GetHash(const Slice& slice) const {
+    return MurmurHash(slice.data(), static_cast<int>(slice.size()), 0) %
+           bucket_size_;
+  }
+
+  Document* FindDocument(const Slice& prefix, size_t hash) const {
+    auto document = buckets_[hash].load(std::memory_order_acquire);
+    while (document != nullptr && document->prefix != prefix) {
+      document = document->next_in_bucket.load(std::memory_order_acquire);
+    }
+    return document;
+  }
+
+  Document* FindDocument(const Slice& prefix) const {
+    return FindDocument(prefix, GetHash(prefix));
+  }
+
+  // Iterates over all entries, moving to the adjacent document when the current one is exhausted.
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    Iterator(const Documents* documents, const SliceTransform* transform)
+        : documents_iter_(documents), entries_iter_(nullptr), transform_(transform) {}
+
+    // Returns true iff the iterator is positioned at a valid node.
+    bool Valid() const override {
+      return entries_iter_.Valid();
+    }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const override {
+      assert(Valid());
+      return entries_iter_.key();
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next() override {
+      assert(Valid());
+      entries_iter_.Next();
+      if (!entries_iter_.Valid()) {
+        documents_iter_.Next();
+        SeekToFirstInDocument();
+      }
+    }
+
+    // Advances to the previous position.
+    // REQUIRES: Valid()
+    void Prev() override {
+      assert(Valid());
+      entries_iter_.Prev();
+      if (!entries_iter_.Valid()) {
+        documents_iter_.Prev();
+        SeekToLastInDocument();
+      }
+    }
+
+    // Advance to the first entry with a key >= target
+    virtual void Seek(const Slice& internal_key,
+                      const char* memtable_key) override {
+      Document probe(transform_->Transform(ExtractUserKey(internal_key)));
+      documents_iter_.Seek(&probe);
+      if (documents_iter_.Valid() && documents_iter_.key()->prefix == probe.prefix) {
+        const char* encoded_key =
+            (memtable_key != nullptr) ?
+                memtable_key : EncodeKey(&tmp_, internal_key);
+        entries_iter_.SetList(documents_iter_.key()->entries);
+        entries_iter_.Seek(encoded_key);
+        if (entries_iter_.Valid()) {
+          return;
+        }
+        documents_iter_.Next();
+      }
+      SeekToFirstInDocument();
+    }
+
+    // Position at the first entry in collection.
+    // Final state of iterator is Valid() iff collection is not empty.
+    void SeekToFirst() override {
+      documents_iter_.SeekToFirst();
+      SeekToFirstInDocument();
+    }
+
+    // Position at the last entry in collection.
+    // Final state of iterator is Valid() iff collection is not empty.
+    void SeekToLast() override {
+      documents_iter_.SeekToLast();
+      SeekToLastInDocument();
+    }
+
+   private:
+    // Documents are published with their first entry, so they are never empty.
+    void SeekToFirstInDocument() {
+      if (documents_iter_.Valid()) {
+        entries_iter_.SetList(documents_iter_.key()->entries);
+        entries_iter_.SeekToFirst();
+      } else {
+        entries_iter_.SetList(nullptr);
+      }
+    }
+
+    void SeekToLastInDocument() {
+      if (documents_iter_.Valid()) {
+        entries_iter_.SetList(documents_iter_.key()->entries);
+        entries_iter_.SeekToLast();
+      } else {
+        entries_iter_.SetList(nullptr);
+      }
+    }
+
+    Documents::Iterator documents_iter_;
+    // Invalid with nullptr list when documents_iter_ is not valid.
+    Entries::Iterator entries_iter_;
+    const SliceTransform* const transform_;
+    std::string tmp_;       // For passing to EncodeKey
+  };
+};
+
+DocumentSkipListRep::DocumentSkipListRep(const MemTableRep::KeyComparator& compare,
+                                         MemTableAllocator* allocator,
+                                         const SliceTransform* transform,
+                                         size_t bucket_size, int32_t skiplist_height,
+                                         int32_t skiplist_branching_factor)
+    : MemTableRep(allocator),
+      bucket_size_(bucket_size),
+      skiplist_height_(skiplist_height),
+      skiplist_branching_factor_(skiplist_branching_factor),
+      documents_(DocumentComparator(), allocator),
+      transform_(transform),
+      compare_(compare),
+      allocator_(allocator) {
+  auto mem = allocator->AllocateAligned(
+               sizeof(std::atomic<void*>) * bucket_size);
+  buckets_ = new (mem) std::atomic<Document*>[bucket_size];
+
+  for (size_t i = 0; i < bucket_size_; ++i) {
+    buckets_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+DocumentSkipListRep::~DocumentSkipListRep() {
+}
+
+void DocumentSkipListRep::Insert(KeyHandle handle) {
+  auto* key = static_cast<char*>(handle);
+  auto prefix = transform_->Transform(UserKey(key));
+  size_t hash = GetHash(prefix);
+  auto document = FindDocument(prefix, hash);
+  if (document == nullptr) {
+    std::lock_guard<SpinMutex> documents_lock(documents_mutex_);
+    document = FindDocument(prefix, hash);
+    if (document == nullptr) {
+      // The first entry goes in before the document becomes visible to readers.
+      auto entries = new (allocator_->AllocateAligned(sizeof(Entries))) Entries(
+          compare_, allocator_, skiplist_height_, skiplist_branching_factor_);
+      entries->Insert(key);
+      document = new (allocator_->AllocateAligned(sizeof(Document))) Document(prefix, entries);
+      document->next_in_bucket.store(
+          buckets_[hash].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      documents_.Insert(document);
+      buckets_[hash].store(document, std::memory_order_release);
+      return;
+    }
+  }
+  std::lock_guard<SpinMutex> document_lock(document->mutex);
+  assert(!document->entries->Contains(key));
+  document->entries->Insert(key);
+}
+
+bool DocumentSkipListRep::Contains(const char* key) const {
+  auto document = FindDocument(transform_->Transform(UserKey(key)));
+  if (document == nullptr) {
+    return false;
+  }
+  return document->entries->Contains(key);
+}
+
+size_t DocumentSkipListRep::ApproximateMemoryUsage() {
+  return 0;
+}
+
+void DocumentSkipListRep::Get(const LookupKey& k, void* callback_args,
+                              bool (*callback_func)(void* arg, const char* entry)) {
+  // All entries of the user key are in the same document.
+  auto document = FindDocument(transform_->Transform(k.user_key()));
+  if (document != nullptr) {
+    Entries::Iterator iter(document->entries);
+    for (iter.Seek(k.memtable_key().cdata());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+}
+
+MemTableRep::Iterator* DocumentSkipListRep::GetIterator(Arena* arena) {
+  if (arena == nullptr) {
+    return new Iterator(&documents_, transform_);
+  } else {
+    auto mem = arena->AllocateAligned(sizeof(Iterator));
+    return new (mem) Iterator(&documents_, transform_);
+  }
+}
+
+} // anon namespace
+
+MemTableRep* DocumentSkipListRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+    const SliceTransform* transform, Logger* logger) {
+  return new DocumentSkipListRep(compare, allocator, document_transform_.get(), bucket_count_,
+                                 document_skiplist_height_, document_skiplist_branching_factor_);
+}
+
+MemTableRepFactory* NewDocumentSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> document_transform, size_t bucket_count,
+    int32_t document_skiplist_height, int32_t document_skiplist_branching_factor) {
+  return new DocumentSkipListRepFactory(std::move(document_transform), bucket_count,
+      document_skiplist_height, document_skiplist_branching_factor);
+}
+
+} // namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,56 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+#ifndef ROCKSDB_LITE
+#include <memory>
+
+#include "yb/rocksdb/slice_transform.h"
+#include "yb/rocksdb/memtablerep.h"
+
+namespace rocksdb {
+
+class DocumentSkipListRepFactory : public MemTableRepFactory {
+ public:
+  DocumentSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> document_transform,
+    size_t bucket_count,
+    int32_t document_skiplist_height,
+    int32_t document_skiplist_branching_factor)
+      : document_transform_(std::move(document_transform)),
+        bucket_count_(bucket_count),
+        document_skiplist_height_(document_skiplist_height),
+        document_skiplist_branching_factor_(document_skiplist_branching_factor) { }
+
+  virtual ~DocumentSkipListRepFactory() {}
+
+  // The transform passed here is the column family prefix extractor, it is not used by this rep.
+  virtual MemTableRep* CreateMemTableRep(
+      const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+      const SliceTransform* transform, Logger* logger) override;
+
+  virtual const char* Name() const override {
+    return "DocumentSkipListRepFactory";
+  }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+ private:
+  const std::shared_ptr<const SliceTransform> document_transform_;
+  const size_t bucket_count_;
+  const int32_t document_skiplist_height_;
+  const int32_t document_skiplist_branching_factor_;
+};
+
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -287,6 +287,25 @@ extern MemTableRepFactory* NewHashSkipListRepFactory(
     int32_t skiplist_branching_factor = 4
 );
 
+// This factory groups the entries of a memtable into documents, i.e. runs of keys sharing the same
+// document_transform of their user keys. Each document is a small skip list found by hash for point
+// operations, and documents are also ordered by prefix, so total order iteration is supported.
+// Writers of different documents do not contend with each other, so concurrent inserts are
+// supported.
+//
+// document_transform must map a key to its own prefix, and no result may be a proper prefix of
+// another one, unless the shorter result is the whole user key. A self-delimiting key encoding,
+// whose keys map to the whole user key when they can not be decoded, satisfies this. User keys must
+// be ordered bytewise.
+// bucket_count: number of fixed array buckets
+// document_skiplist_height: the max height of the skip list of each document
+// document_skiplist_branching_factor: probabilistic size ratio between adjacent
+//                                     link lists in the skip list of each document
+extern MemTableRepFactory* NewDocumentSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> document_transform,
+    size_t bucket_count = 1000000, int32_t document_skiplist_height = 4,
+    int32_t document_skiplist_branching_factor = 4);
+
 // The factory is to create memtables based on a hash table:
 // it contains a fixed array of buckets, each pointing to either a linked list
 // or a skip list if number of entries inside the bucket exceeds
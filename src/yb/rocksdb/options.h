@@ -155,9 +155,15 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary that the data blocks of an SST file are compressed with. The
+  // dictionary is sampled from the first data blocks of the file, and stored in a meta block of
+  // it. Only used by the compression types that support a dictionary: zlib and ZSTD. With zlib,
+  // only the last 2^window_bits bytes of the dictionary matter.
+  // Default: 0, no dictionary.
+  uint32_t max_dict_bytes;
+  CompressionOptions() : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -689,6 +695,12 @@ struct ColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t inplace_update_num_locks;
 
+  // NUMA node preferred for the memory of the memtables, so that it is local to the threads
+  // writing and reading them when those are bound to the same node. The preference only applies
+  // to the arena blocks of a size of at least one page.
+  // Default: -1, i.e. the default memory policy of the process.
+  int memtable_numa_node;
+
   // existing_value - pointer to previous value (from both memtable and sst).
   //                  nullptr if key doesn't exist
   // existing_value_size - pointer to size of existing_value).
@@ -1085,6 +1097,18 @@ struct DBOptions {
   // If false, fallocate() calls are bypassed
   bool allow_fallocate;
 
+  // Read SST files with direct I/O, bypassing the OS page cache. Reads of compaction inputs
+  // are done with direct I/O when either this or use_direct_io_for_flush_and_compaction is set.
+  // Not supported together with allow_mmap_reads.
+  // Default: false
+  bool use_direct_reads;
+
+  // Write the SST files produced by flushes and compactions, and read compaction inputs, with
+  // direct I/O. This keeps background I/O from evicting the pages that serve foreground reads
+  // out of the OS page cache. Not supported together with allow_mmap_reads or allow_mmap_writes.
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction;
+
   // Disable child process inherit open files. Default: true
   bool is_fd_close_on_exec;
 
@@ -1313,6 +1337,12 @@ struct DBOptions {
 
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
+
+  // A cache of open table readers, with a charge of 1 per file, shared by the DBs it is set for,
+  // so that they keep at most its capacity of SST files open together. max_open_files only sizes
+  // the own cache of a DB, and should not be -1 with a shared one, since that pins every file.
+  // Default: nullptr (each DB has its own cache of max_open_files table readers)
+  std::shared_ptr<Cache> table_cache;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1469,6 +1499,12 @@ struct ReadOptions {
   // Default: false
   bool pin_data;
 
+  // If non-zero, an iterator that reads the data blocks of a table file one after another starts
+  // prefetching the blocks that follow, doubling the prefetched range up to this many bytes.
+  // Prefetches are hints to the file and do not block the iterator.
+  // Default: 0, i.e. rely on the readahead of the OS.
+  size_t max_readahead_size = 0;
+
   // Query id designated for the read.
   QueryId query_id = kDefaultQueryId;
 
@@ -106,6 +106,10 @@ struct PerfContext {
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
   uint64_t bloom_sst_miss_count;
+  // number of seeks, including SeekToFirst and SeekToLast, issued on DB iterators
+  uint64_t iter_seek_count;
+  // number of Next and Prev calls issued on DB iterators
+  uint64_t iter_next_count;
 };
 
 #if defined(NPERF_CONTEXT) || defined(IOS_CROSS_COMPILE)
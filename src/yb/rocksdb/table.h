@@ -97,6 +97,35 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If cache_index_and_filter_blocks is set, the top level of kMultiLevelBinarySearch data index is
+  // still kept by the table reader, so that only the lower level index blocks are loaded through
+  // the block cache. The index of fixed-size bloom filter blocks is always kept by the table
+  // reader.
+  bool pin_top_level_index = false;
+
+  // Insert index and filter blocks that are loaded through the block cache into its multi-touch
+  // part, so they are not evicted by scans over data blocks.
+  bool cache_index_and_filter_blocks_with_high_priority = false;
+
+  enum class CachePriority {
+    kNormal,
+    // Data blocks go straight to the multi-touch part of the block cache, as do index and filter
+    // blocks, so scans over other tables don't evict them.
+    kHigh,
+    // Data blocks stay in the single-touch part of the block cache regardless of how many queries
+    // read them, so they never displace blocks of other tables.
+    kLow,
+  };
+
+  // Priority of the blocks of this table in a block cache shared with other tables.
+  CachePriority cache_priority = CachePriority::kNormal;
+
+  // Read all the data blocks of a file when it is opened for reads and keep them with the table
+  // reader, outside of the block cache, so they are never evicted and a read finds its block by
+  // a hash lookup of the block offset, without block cache lookups or I/O. Meant for small, hot
+  // tables, the memory is taken for as long as the file is open.
+  bool pin_data_blocks = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -163,6 +192,13 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // Store the DocHybridTime at the end of the user key of a data block entry as a delta from the
+  // DocHybridTime of the previous key, when the keys only differ in it. Blocks written with this
+  // option are marked as such and can be read regardless of its value, but not by older versions.
+  //
+  // Default: false
+  bool use_hybrid_time_delta_encoding = false;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
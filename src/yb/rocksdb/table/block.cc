@@ -32,6 +32,7 @@
 
 #include "yb/rocksdb/comparator.h"
 #include "yb/rocksdb/table/format.h"
+#include "yb/rocksdb/table/block_builder.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/util/coding.h"
@@ -163,11 +164,21 @@ bool BlockIter::ParseNextKey() {
   // Decode next entry
   uint32_t shared, non_shared, value_length;
   p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
+  bool is_hybrid_time_delta = false;
+  if (p != nullptr && hybrid_time_delta_encoded_) {
+    is_hybrid_time_delta = (shared & 1) != 0;
+    shared >>= 1;
+  }
   if (p == nullptr || key_.Size() < shared) {
     CorruptionError();
     return false;
   } else {
-    if (shared == 0) {
+    if (is_hybrid_time_delta) {
+      if (!ParseHybridTimeDeltaKey(shared, p, non_shared)) {
+        CorruptionError();
+        return false;
+      }
+    } else if (shared == 0) {
       // If this key dont share any bytes with prev key then we dont need
       // to decode it and can use it's address in the block directly.
       key_.SetKey(Slice(p, non_shared), false /* copy */);
@@ -184,6 +195,38 @@ bool BlockIter::ParseNextKey() {
   }
 }
 
+bool BlockIter::ParseHybridTimeDeltaKey(
+    uint32_t prefix_size, const char* key_delta, uint32_t size) {
+  size_t last_prefix_size = 0;
+  yb::DocHybridTime last_doc_ht;
+  if (!DecodeHybridTimeSuffix(key_.GetKey(), &last_prefix_size, &last_doc_ht) ||
+      last_prefix_size != prefix_size) {
+    return false;
+  }
+  const char* p = key_delta;
+  const char* limit = key_delta + size;
+  uint64_t encoded_micros_delta = 0;
+  uint32_t logical = 0;
+  uint32_t write_id = 0;
+  if ((p = GetVarint64Ptr(p, limit, &encoded_micros_delta)) == nullptr ||
+      (p = GetVarint32Ptr(p, limit, &logical)) == nullptr ||
+      (p = GetVarint32Ptr(p, limit, &write_id)) == nullptr ||
+      static_cast<size_t>(limit - p) != kInternalKeyTrailerSize) {
+    return false;
+  }
+  const int64_t micros_delta = static_cast<int64_t>(encoded_micros_delta >> 1) ^
+                               -static_cast<int64_t>(encoded_micros_delta & 1);
+  const yb::DocHybridTime doc_ht(
+      last_doc_ht.hybrid_time().GetPhysicalValueMicros() - micros_delta, logical, write_id);
+
+  char buf[yb::kMaxBytesPerEncodedHybridTime + kInternalKeyTrailerSize];
+  char* end = doc_ht.EncodedInDocDbFormat(buf);
+  memcpy(end, p, kInternalKeyTrailerSize);
+  end += kInternalKeyTrailerSize;
+  key_.TrimAppend(prefix_size, buf, end - buf);
+  return true;
+}
+
 // Binary search in restart array to find the first restart point
 // with a key >= target (TODO: this comment is inaccurate)
 bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
@@ -317,7 +360,12 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
 
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2*sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kHybridTimeDeltaEncodedBlockFlag;
+}
+
+bool Block::IsHybridTimeDeltaEncoded() const {
+  assert(size_ >= 2*sizeof(uint32_t));
+  return (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & kHybridTimeDeltaEncodedBlockFlag) != 0;
 }
 
 Block::Block(BlockContents&& contents)
@@ -363,10 +411,10 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, IsHybridTimeDeltaEncoded());
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, IsHybridTimeDeltaEncoded());
     }
   }
 
@@ -65,6 +65,8 @@ class Block {
     return size_;
   }
   uint32_t NumRestarts() const;
+  // Returns true if the block was built with use_hybrid_time_delta_encoding.
+  bool IsHybridTimeDeltaEncoded() const;
   CompressionType compression_type() const {
     return contents_.compression_type;
   }
@@ -115,19 +117,20 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        hybrid_time_delta_encoded_(false) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index, bool hybrid_time_delta_encoded = false)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, hybrid_time_delta_encoded);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index) {
+      BlockPrefixIndex* prefix_index, bool hybrid_time_delta_encoded = false) {
     assert(data_ == nullptr);           // Ensure it is called only once
     assert(num_restarts > 0);           // Ensure the param is valid
 
@@ -139,6 +142,7 @@ class BlockIter : public InternalIterator {
     restart_index_ = num_restarts_;
     hash_index_ = hash_index;
     prefix_index_ = prefix_index;
+    hybrid_time_delta_encoded_ = hybrid_time_delta_encoded;
   }
 
   void SetStatus(Status s) {
@@ -192,6 +196,7 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  bool hybrid_time_delta_encoded_;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -222,6 +227,9 @@ class BlockIter : public InternalIterator {
 
   bool ParseNextKey();
 
+  // Reconstructs key_ of an entry storing the DocHybridTime as a delta from the previous key.
+  bool ParseHybridTimeDeltaKey(uint32_t prefix_size, const char* key_delta, uint32_t size);
+
   bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                   uint32_t* index);
 
@@ -105,10 +105,12 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 }
 
 // format_version is the block format as defined in include/rocksdb/table.h
+// compression_dict is only used by the compression types that support a dictionary.
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    std::string* compressed_output) {
+                    std::string* compressed_output,
+                    const Slice& compression_dict) {
   if (*type == kNoCompression) {
     return raw;
   }
@@ -127,7 +129,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -161,7 +163,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -299,6 +301,16 @@ struct BlockBasedTableBuilder::Rep {
 
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
+  // Whether the data blocks are compressed with a dictionary, see
+  // CompressionOptions::max_dict_bytes.
+  const bool use_compression_dict;
+  // The dictionary, empty until enough data blocks are sampled for it.
+  std::string compression_dict;
+  // The raw data blocks written before the dictionary was complete.
+  std::string compression_dict_samples;
+  // Offset of the first data block compressed with the dictionary.
+  uint64_t compression_dict_start_offset = 0;
+
   Rep(const ImmutableCFOptions& _ioptions,
       const BlockBasedTableOptions& table_opt,
       const InternalKeyComparator& icomparator,
@@ -311,8 +323,28 @@ struct BlockBasedTableBuilder::Rep {
       const bool skip_filters);
 
   bool is_split_sst() const { return data_writer != metadata_writer; }
+
+  // Samples the raw contents of a data block that was just written for the dictionary.
+  void SampleCompressionDict(const Slice& raw_block_contents);
 };
 
+void BlockBasedTableBuilder::Rep::SampleCompressionDict(const Slice& raw_block_contents) {
+  if (!use_compression_dict || !compression_dict.empty()) {
+    return;
+  }
+  compression_dict_samples.append(raw_block_contents.cdata(), raw_block_contents.size());
+  const size_t max_dict_bytes = compression_opts.max_dict_bytes;
+  if (compression_dict_samples.size() < max_dict_bytes) {
+    return;
+  }
+  // Both zlib and ZSTD find matches in the end of the dictionary more cheaply, so the dictionary
+  // ends with the last block, which is the closest to the blocks that follow.
+  compression_dict.assign(
+      compression_dict_samples, compression_dict_samples.size() - max_dict_bytes, max_dict_bytes);
+  std::string().swap(compression_dict_samples);
+  compression_dict_start_offset = data_writer->offset;
+}
+
 Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
     UserCollectedProperties* properties) {
   std::string val;
@@ -348,7 +380,8 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.use_hybrid_time_delta_encoding),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -366,7 +399,9 @@ BlockBasedTableBuilder::Rep::Rep(
       compression_opts(_compression_opts),
       flush_block_policy(
           table_options.flush_block_policy_factory->NewFlushBlockPolicy(
-              table_options, data_block_builder)) {
+              table_options, data_block_builder)),
+      use_compression_dict(_compression_opts.max_dict_bytes > 0 &&
+                           CompressionTypeSupportsDictionary(_compression_type)) {
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
   if (data_file != nullptr) {
@@ -480,8 +515,13 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   size_t data_block_size = 0;
 
   if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+    const Slice raw_block_contents = r->data_block_builder.Finish();
+    data_block_size = WriteBlock(raw_block_contents, &r->data_pending_handle,
+        r->data_writer.get(), r->compression_dict);
+    if (ok()) {
+      r->SampleCompressionDict(raw_block_contents);
+    }
+    r->data_block_builder.Reset();
   }
   if (!ok()) return;
 
@@ -562,7 +602,8 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -575,7 +616,8 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, &r->compressed_output,
+                      compression_dict);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -756,6 +798,17 @@ Status BlockBasedTableBuilder::Finish() {
       }
     }
 
+    if (!r->compression_dict.empty()) {
+      std::string compression_dict_block;
+      PutVarint64(&compression_dict_block, r->compression_dict_start_offset);
+      compression_dict_block.append(r->compression_dict);
+      BlockHandle compression_dict_block_handle;
+      WriteRawBlock(compression_dict_block, kNoCompression, &compression_dict_block_handle,
+          r->metadata_writer.get());
+      meta_index_builder.Add(block_based_table::kCompressionDictBlock,
+          compression_dict_block_handle);
+    }
+
     // Write properties block.
     {
       PropertyBlockBuilder property_block_builder;
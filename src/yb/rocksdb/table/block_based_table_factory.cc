@@ -136,6 +136,12 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  pin_top_level_index: %d\n",
+           table_options_.pin_top_level_index);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks_with_high_priority: %d\n",
+           table_options_.cache_index_and_filter_blocks_with_high_priority);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::util::to_underlying(table_options_.index_type));
   ret.append(buffer);
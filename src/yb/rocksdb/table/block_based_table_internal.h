@@ -25,6 +25,9 @@ namespace block_based_table {
 constexpr char kFilterBlockPrefix[] = "filter.";
 constexpr char kFullFilterBlockPrefix[] = "fullfilter.";
 constexpr char kFixedSizeFilterBlockPrefix[] = "fixedsizefilter.";
+// The meta block with the dictionary that the data blocks are compressed with: the offset of the
+// first data block compressed with it as a varint64, followed by the dictionary.
+constexpr char kCompressionDictBlock[] = "rocksdb.compression_dict";
 
 // Read the block identified by "handle" from "file".
 // The only relevant option is options.verify_checksums for now.
@@ -33,10 +36,10 @@ constexpr char kFixedSizeFilterBlockPrefix[] = "fixedsizefilter.";
 inline CHECKED_STATUS ReadBlockFromFile(
     RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
     const BlockHandle& handle, std::unique_ptr<Block>* result, Env* env,
-    bool do_uncompress = true) {
+    bool do_uncompress = true, const Slice& compression_dict = Slice()) {
   BlockContents contents;
   Status s = ReadBlockContents(file, footer, options, handle, &contents, env,
-                               do_uncompress);
+                               do_uncompress, compression_dict);
   if (s.ok()) {
     result->reset(new Block(std::move(contents)));
   }
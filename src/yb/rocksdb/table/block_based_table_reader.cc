@@ -23,7 +23,10 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <cinttypes>
 
@@ -228,6 +231,21 @@ struct BlockBasedTable::Rep {
   // block to extract prefix without knowing if a key is internal or not.
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
+  // Whether the data index reader is kept here even if cache_index_and_filter_blocks is set, see
+  // BlockBasedTableOptions::pin_top_level_index.
+  bool pin_data_index = false;
+  // All the data blocks by offset, see BlockBasedTableOptions::pin_data_blocks. Only filled before
+  // the table reader is shared, read without synchronization afterwards.
+  std::unordered_map<uint64_t, std::unique_ptr<Block>> pinned_data_blocks;
+  size_t pinned_data_blocks_usage = 0;
+  // Whether the data blocks are read straight from the mapped file, without copying them into the
+  // block cache or looking them up there. Only for uncompressed tables, whose blocks read from a
+  // mapping are never cached anyway.
+  bool read_data_blocks_from_mmap = false;
+  // The dictionary that the data blocks starting at compression_dict_start_offset are compressed
+  // with, see CompressionOptions::max_dict_bytes.
+  std::string compression_dict;
+  uint64_t compression_dict_start_offset = 0;
 };
 
 class BlockBasedTable::IndexIteratorHolder {
@@ -274,6 +292,30 @@ BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(Bloc
   FATAL_INVALID_ENUM_VALUE(BlockType, block_type);
 }
 
+Slice BlockBasedTable::GetCompressionDict(BlockType block_type, const BlockHandle& handle) const {
+  if (block_type != BlockType::kData || handle.offset() < rep_->compression_dict_start_offset) {
+    return Slice();
+  }
+  return rep_->compression_dict;
+}
+
+Status BlockBasedTable::ReadCompressionDict(Rep* rep, InternalIterator* meta_iter) {
+  BlockHandle handle;
+  if (!FindMetaBlock(meta_iter, block_based_table::kCompressionDictBlock, &handle).ok()) {
+    return Status::OK();
+  }
+  BlockContents contents;
+  RETURN_NOT_OK(ReadBlockContents(
+      rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+      handle, &contents, rep->ioptions.env, false /* do_uncompress */));
+  Slice input = contents.data;
+  if (!GetVarint64(&input, &rep->compression_dict_start_offset)) {
+    return STATUS(Corruption, "Bad compression dictionary block");
+  }
+  rep->compression_dict = input.ToBuffer();
+  return Status::OK();
+}
+
 BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
     const ReadOptions& read_options, const Slice& user_key)
     : read_options_(read_options), user_key_(user_key) {}
@@ -319,6 +361,19 @@ bool IsFeatureSupported(const TableProperties& table_properties,
   }
   return true;
 }
+
+// Some old version of block-based tables don't have index type present in
+// table properties. If that's the case we can safely use the kBinarySearch.
+IndexType IndexTypeOnFile(const TableProperties* table_properties) {
+  if (table_properties) {
+    auto& props = table_properties->user_collected_properties;
+    auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
+    if (pos != props.end()) {
+      return static_cast<IndexType>(DecodeFixed32(pos->second.c_str()));
+    }
+  }
+  return IndexType::kBinarySearch;
+}
 }  // namespace
 
 Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
@@ -366,6 +421,11 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     return s;
   }
 
+  s = ReadCompressionDict(rep, meta_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
+
   // Find filter handle and filter type.
   if (rep->filter_policy) {
     for (const auto& prefix : {block_based_table::kFullFilterBlockPrefix,
@@ -432,9 +492,17 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
   }
 
+  rep->read_data_blocks_from_mmap = env_options.use_mmap_reads &&
+      ioptions.compression == kNoCompression && ioptions.compression_per_level.empty() &&
+      table_options.block_cache_compressed == nullptr;
+
+  // Only the top level of a multi-level index is kept by its reader, so it is small enough to pin.
+  rep->pin_data_index = table_options.pin_top_level_index &&
+      IndexTypeOnFile(rep->table_properties.get()) == IndexType::kMultiLevelBinarySearch;
+
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
-    if (table_options.cache_index_and_filter_blocks) {
+    if (table_options.cache_index_and_filter_blocks && !rep->pin_data_index) {
       DCHECK_ONLY_NOTNULL(table_options.block_cache.get());
       // Hack: Call NewIndexIterator() to implicitly add index to the
       // block_cache
@@ -526,6 +594,35 @@ void BlockBasedTable::SetDataFileReader(unique_ptr<RandomAccessFileReader> &&dat
   SetupCacheKeyPrefix(rep_, rep_->data_reader_with_cache_prefix.get());
 }
 
+Status BlockBasedTable::PinDataBlocks() {
+  if (!rep_->table_options.pin_data_blocks || !rep_->pinned_data_blocks.empty()) {
+    return Status::OK();
+  }
+  FileReaderWithCachePrefix* reader = GetBlockReader(BlockType::kData);
+  std::unordered_map<uint64_t, std::unique_ptr<Block>> blocks;
+  size_t usage = 0;
+  {
+    IndexIteratorHolder iiter_holder(this, ReadOptions::kDefault);
+    InternalIterator& iiter = *iiter_holder.iter();
+    for (iiter.SeekToFirst(); iiter.Valid(); iiter.Next()) {
+      BlockHandle handle;
+      Slice input = iiter.value();
+      RETURN_NOT_OK(handle.DecodeFrom(&input));
+      std::unique_ptr<Block> block;
+      RETURN_NOT_OK(block_based_table::ReadBlockFromFile(
+          reader->reader.get(), rep_->footer, ReadOptions::kDefault, handle, &block,
+          rep_->ioptions.env, true /* do_uncompress */,
+          GetCompressionDict(BlockType::kData, handle)));
+      usage += block->usable_size();
+      blocks.emplace(handle.offset(), std::move(block));
+    }
+    RETURN_NOT_OK(iiter.status());
+  }
+  rep_->pinned_data_blocks = std::move(blocks);
+  rep_->pinned_data_blocks_usage = usage;
+  return Status::OK();
+}
+
 namespace {
 void SetupFileReaderForCompaction(const Options::AccessHint &access_hint,
     RandomAccessFileReader *reader) {
@@ -574,6 +671,7 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (data_index_reader) {
     usage += data_index_reader->ApproximateMemoryUsage();
   }
+  usage += rep_->pinned_data_blocks_usage;
   return usage;
 }
 
@@ -635,7 +733,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-    uint32_t format_version, BlockType block_type) {
+    uint32_t format_version, BlockType block_type, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -680,7 +778,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(),
                               compressed_block->size(), &contents,
-                              format_version);
+                              format_version, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -707,7 +805,8 @@ Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
-    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version) {
+    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+    const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -716,7 +815,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version);
+                                format_version, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -844,6 +943,31 @@ Slice BlockBasedTable::GetFilterKeyFromUserKey(const Slice &user_key) const {
       rep_->filter_key_transformer->Transform(user_key) : user_key;
 }
 
+QueryId BlockBasedTable::IndexAndFilterCacheQueryId(const QueryId query_id) const {
+  if (query_id == kNoCacheQueryId ||
+      (!rep_->table_options.cache_index_and_filter_blocks_with_high_priority &&
+       rep_->table_options.cache_priority != BlockBasedTableOptions::CachePriority::kHigh)) {
+    return query_id;
+  }
+  return kInMultiTouchId;
+}
+
+QueryId BlockBasedTable::DataBlockCacheQueryId(const QueryId query_id) const {
+  if (query_id == kNoCacheQueryId) {
+    return query_id;
+  }
+  switch (rep_->table_options.cache_priority) {
+    case BlockBasedTableOptions::CachePriority::kNormal:
+      return query_id;
+    case BlockBasedTableOptions::CachePriority::kHigh:
+      return kInMultiTouchId;
+    case BlockBasedTableOptions::CachePriority::kLow:
+      // Entries are only promoted when looked up by a query other than the one that inserted them.
+      return kDefaultQueryId;
+  }
+  return query_id;
+}
+
 BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     const QueryId query_id,
     bool no_io,
@@ -922,7 +1046,7 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      Status s = block_cache->Insert(filter_block_cache_key, IndexAndFilterCacheQueryId(query_id),
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -966,7 +1090,7 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
   Cache* const block_cache = rep_->table_options.block_cache.get();
 
   if (block_cache && (rep_->data_index_load_mode == DataIndexLoadMode::USE_CACHE ||
-      rep_->table_options.cache_index_and_filter_blocks)) {
+      (rep_->table_options.cache_index_and_filter_blocks && !rep_->pin_data_index))) {
     char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
@@ -986,8 +1110,8 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     std::unique_ptr<IndexReader> index_reader_unique;
     Status s = CreateDataBlockIndexReader(&index_reader_unique);
     if (s.ok()) {
-      s = block_cache->Insert(key, read_options.query_id, index_reader_unique.get(),
-                              index_reader_unique->usable_size(),
+      s = block_cache->Insert(key, IndexAndFilterCacheQueryId(read_options.query_id),
+                              index_reader_unique.get(), index_reader_unique->usable_size(),
                               &DeleteCachedEntry<IndexReader>, &cache_handle, statistics);
     }
 
@@ -1038,10 +1162,20 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
 // into an iterator over the contents of the corresponding block.
 // If input_iter is null, new a iterator
 // If input_iter is not null, update this iter and return it
-InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
+InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& read_options,
     const Slice& index_value, BlockType block_type, BlockIter* input_iter) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
+  const ReadOptions* ro_ptr = &read_options;
+  ReadOptions prioritized_read_options;
+  const QueryId query_id = DataBlockCacheQueryId(read_options.query_id);
+  if (block_type == BlockType::kData && query_id != read_options.query_id) {
+    prioritized_read_options = read_options;
+    prioritized_read_options.query_id = query_id;
+    ro_ptr = &prioritized_read_options;
+  }
+  const ReadOptions& ro = *ro_ptr;
+
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   Cache* block_cache = rep_->table_options.block_cache.get();
   Cache* block_cache_compressed =
@@ -1063,10 +1197,21 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     }
   }
 
+  if (block_type == BlockType::kData && !rep_->pinned_data_blocks.empty()) {
+    auto it = rep_->pinned_data_blocks.find(handle.offset());
+    if (it != rep_->pinned_data_blocks.end()) {
+      // Owned by the table reader, which outlives its iterators.
+      return it->second->NewIterator(&rep_->internal_comparator, input_iter);
+    }
+  }
+
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  const Slice compression_dict = GetCompressionDict(block_type, handle);
 
   // If either block cache is enabled, we'll try to read from it.
-  if (block_cache != nullptr || block_cache_compressed != nullptr) {
+  const bool use_cache = (block_cache != nullptr || block_cache_compressed != nullptr) &&
+      !(block_type == BlockType::kData && rep_->read_data_blocks_from_mmap);
+  if (use_cache) {
     Statistics* statistics = rep_->ioptions.statistics;
     char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
     char compressed_cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
@@ -1084,7 +1229,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type);
+        rep_->table_options.format_version, block_type, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1092,13 +1237,13 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            block_cache_compressed == nullptr);
+            block_cache_compressed == nullptr, compression_dict);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version);
+                                rep_->table_options.format_version, compression_dict);
       }
     }
   }
@@ -1116,7 +1261,8 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     }
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
-        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env);
+        reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
+        true /* do_uncompress */, compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1154,6 +1300,9 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         block_type_(block_type) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (read_options_.max_readahead_size != 0 && read_options_.read_tier != kBlockCacheTier) {
+      ReadaheadIfSequential(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -1165,11 +1314,59 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Number of blocks read one after another, after which the iterator starts to prefetch.
+  static constexpr int kMinSequentialReadsForReadahead = 2;
+  // The first prefetch covers this many blocks of the size of the current one.
+  static constexpr size_t kInitialReadaheadBlocks = 4;
+
+  // Index iterator yields data blocks in file order, so the next block starts right after the
+  // trailer of the current one. Once blocks are read in this order, prefetches the range that
+  // follows the current block, doubling it each time it is extended, before the iterator gets there.
+  void ReadaheadIfSequential(const Slice& index_value) {
+    BlockHandle handle;
+    Slice input = index_value;
+    // NewDataBlockIterator reports a broken handle.
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+    if (handle.offset() == next_block_offset_) {
+      ++num_sequential_reads_;
+    } else {
+      num_sequential_reads_ = 0;
+      readahead_size_ = 0;
+      readahead_limit_ = 0;
+    }
+    next_block_offset_ = block_end;
+    if (num_sequential_reads_ < kMinSequentialReadsForReadahead ||
+        block_end + readahead_size_ / 2 < readahead_limit_) {
+      return;
+    }
+    const size_t max_readahead_size = read_options_.max_readahead_size;
+    readahead_size_ = readahead_size_ == 0
+        ? std::min<size_t>(kInitialReadaheadBlocks * (block_end - handle.offset()),
+                           max_readahead_size)
+        : std::min(readahead_size_ * 2, max_readahead_size);
+    const uint64_t prefetch_start = std::max(block_end, readahead_limit_);
+    readahead_limit_ = block_end + readahead_size_;
+    if (prefetch_start < readahead_limit_) {
+      // This is only a hint, when it fails or is not supported the iterator just reads the blocks.
+      table_->GetBlockReader(block_type_)->reader->Prefetch(
+          prefetch_start, readahead_limit_ - prefetch_start);
+    }
+  }
+
   // Don't own table_
   BlockBasedTable* const table_;
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  // State of the readahead of data blocks, only used with read_options_.max_readahead_size.
+  uint64_t next_block_offset_ = std::numeric_limits<uint64_t>::max();
+  int num_sequential_reads_ = 0;
+  size_t readahead_size_ = 0;
+  uint64_t readahead_limit_ = 0;
 };
 
 // This will be broken if the user specifies an unusual implementation
@@ -1470,17 +1667,7 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
 //  5. index_type
 Status BlockBasedTable::CreateDataBlockIndexReader(
     std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter) {
-  // Some old version of block-based tables don't have index type present in
-  // table properties. If that's the case we can safely use the kBinarySearch.
-  auto index_type_on_file = IndexType::kBinarySearch;
-  if (rep_->table_properties) {
-    auto& props = rep_->table_properties->user_collected_properties;
-    auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
-    if (pos != props.end()) {
-      index_type_on_file = static_cast<IndexType>(
-          DecodeFixed32(pos->second.c_str()));
-    }
-  }
+  auto index_type_on_file = IndexTypeOnFile(rep_->table_properties.get());
 
   auto file = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
@@ -1539,8 +1726,10 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
       int num_levels = DecodeFixed32(pos->second.c_str());
       // Filters are already checked before seeking the index.
       const bool skip_filters = true;
+      ReadOptions index_read_options;
+      index_read_options.query_id = IndexAndFilterCacheQueryId(kDefaultQueryId);
       auto state = std::make_unique<BlockEntryIteratorState>(
-          this, ReadOptions::kDefault, skip_filters, BlockType::kIndex);
+          this, index_read_options, skip_filters, BlockType::kIndex);
       auto result = MultiLevelIndexReader::Create(
           this, file, footer, num_levels, footer.index_handle(), env, comparator, std::move(state));
       RETURN_NOT_OK(result);
@@ -1588,6 +1777,29 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+
+  size_t num_entries = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    ++num_entries;
+  }
+  RETURN_NOT_OK(index_iter->status());
+  if (num_entries == 0) {
+    return STATUS(Incomplete, "Empty SST file");
+  }
+
+  index_iter->SeekToFirst();
+  for (size_t i = 0; i < num_entries / 2; ++i) {
+    index_iter->Next();
+  }
+  RETURN_NOT_OK(index_iter->status());
+  if (!index_iter->Valid()) {
+    return STATUS(Corruption, "Index entries changed while looking for the middle key");
+  }
+  return index_iter->key().ToString();
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
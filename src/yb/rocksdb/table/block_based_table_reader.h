@@ -137,6 +137,9 @@ class BlockBasedTable : public TableReader {
 
   void SetDataFileReader(unique_ptr<RandomAccessFileReader>&& data_file) override;
 
+  // See BlockBasedTableOptions::pin_data_blocks.
+  Status PinDataBlocks() override;
+
   bool PrefixMayMatch(const Slice& internal_key);
 
   // Returns a new iterator over the table contents.
@@ -179,6 +182,9 @@ class BlockBasedTable : public TableReader {
   // convert SST file to a human readable form
   Status DumpTable(WritableFile* out_file) override;
 
+  // Returns the key of the middle data index entry, i.e. the middle block of the table.
+  yb::Result<std::string> GetMiddleKey() override;
+
   // input_iter: if it is not null, update this one and return it as Iterator
   InternalIterator* NewDataBlockIterator(
       const ReadOptions& ro, const Slice& index_value, BlockType block_type,
@@ -207,6 +213,14 @@ class BlockBasedTable : public TableReader {
   Status GetFixedSizeFilterBlockHandle(const Slice& filter_key,
       BlockHandle* filter_block_handle) const;
 
+  // Returns the query id to insert an index or filter block loaded by the given query into the
+  // block cache with.
+  QueryId IndexAndFilterCacheQueryId(const QueryId query_id) const;
+
+  // Returns the query id to look up and insert a data block read by the given query with,
+  // according to the cache priority of the table.
+  QueryId DataBlockCacheQueryId(const QueryId query_id) const;
+
   // Returns key to be added to filter or verified against filter based on internal_key.
   Slice GetFilterKeyFromInternalKey(const Slice &internal_key) const;
 
@@ -247,7 +261,8 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
-      uint32_t format_version, BlockType block_type);
+      uint32_t format_version, BlockType block_type,
+      const Slice& compression_dict = Slice());
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -261,7 +276,8 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
-      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version);
+      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+      const Slice& compression_dict = Slice());
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -299,6 +315,12 @@ class BlockBasedTable : public TableReader {
 
   FileReaderWithCachePrefix* GetBlockReader(BlockType block_type);
 
+  // Returns the dictionary that the block was compressed with, or an empty slice.
+  Slice GetCompressionDict(BlockType block_type, const BlockHandle& handle) const;
+
+  // Reads the dictionary that the data blocks are compressed with, if the file has one.
+  static Status ReadCompressionDict(Rep* rep, InternalIterator* meta_iter);
+
   explicit BlockBasedTable(Rep* rep) : rep_(rep) {}
 
   // Helper functions for DumpTable()
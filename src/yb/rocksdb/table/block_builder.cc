@@ -44,10 +44,21 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// With use_hybrid_time_delta_encoding, kHybridTimeDeltaEncodedBlockFlag is set in num_restarts
+// and shared_bytes is stored as (shared_bytes << 1) | is_hybrid_time_delta. For an entry with
+// is_hybrid_time_delta set, the key only differs from the previous key in the DocHybridTime at
+// the end of the user key and in the internal key trailer, shared_bytes is the size of the user
+// key before the DocHybridTime, and key_delta has the form:
+//     physical_micros_delta: zigzag varint64 (previous minus current)
+//     logical: varint32
+//     write_id: varint32
+//     trailer: char[8]
 
 #include "yb/rocksdb/table/block_builder.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include <algorithm>
 
@@ -57,9 +68,25 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+bool DecodeHybridTimeSuffix(const Slice& internal_key, size_t* prefix_size,
+                            yb::DocHybridTime* doc_ht) {
+  if (internal_key.size() <= kInternalKeyTrailerSize) {
+    return false;
+  }
+  const Slice user_key = ExtractUserKey(internal_key);
+  int encoded_size = 0;
+  if (!yb::DocHybridTime::CheckAndGetEncodedSize(user_key, &encoded_size).ok()) {
+    return false;
+  }
+  *prefix_size = user_key.size() - encoded_size;
+  return doc_ht->FullyDecodeFrom(Slice(user_key.data() + *prefix_size, encoded_size)).ok();
+}
+
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           bool use_hybrid_time_delta_encoding)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      use_hybrid_time_delta_encoding_(use_hybrid_time_delta_encoding),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -110,7 +137,11 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (use_hybrid_time_delta_encoding_) {
+    num_restarts |= kHybridTimeDeltaEncodedBlockFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
@@ -133,8 +164,15 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   }
   const size_t non_shared = key.size() - shared;
 
+  if (use_hybrid_time_delta_encoding_ && counter_ != 0 &&
+      AddHybridTimeDelta(key, value, non_shared)) {
+    counter_++;
+    return;
+  }
+
   // Add "<shared><non_shared><value_size>" to buffer_
-  PutVarint32(&buffer_, static_cast<uint32_t>(shared));
+  PutVarint32(&buffer_, static_cast<uint32_t>(
+      use_hybrid_time_delta_encoding_ ? shared << 1 : shared));
   PutVarint32(&buffer_, static_cast<uint32_t>(non_shared));
   PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
 
@@ -149,4 +187,51 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   counter_++;
 }
 
+bool BlockBuilder::AddHybridTimeDelta(const Slice& key, const Slice& value, size_t non_shared) {
+  size_t prefix_size = 0;
+  size_t last_prefix_size = 0;
+  yb::DocHybridTime doc_ht;
+  yb::DocHybridTime last_doc_ht;
+  if (!DecodeHybridTimeSuffix(key, &prefix_size, &doc_ht) ||
+      !doc_ht.hybrid_time().is_valid() ||
+      !DecodeHybridTimeSuffix(last_key_, &last_prefix_size, &last_doc_ht) ||
+      prefix_size != last_prefix_size ||
+      memcmp(key.data(), last_key_.data(), prefix_size) != 0) {
+    return false;
+  }
+
+  // The reader re-encodes the DocHybridTime, so it should be in the canonical encoding.
+  char encoded_ht[yb::kMaxBytesPerEncodedHybridTime];
+  const size_t encoded_ht_size = doc_ht.EncodedInDocDbFormat(encoded_ht) - encoded_ht;
+  if (prefix_size + encoded_ht_size + kInternalKeyTrailerSize != key.size() ||
+      memcmp(encoded_ht, key.data() + prefix_size, encoded_ht_size) != 0) {
+    return false;
+  }
+
+  // Versions of the same key are sorted by descending hybrid time, so the delta is non-negative
+  // for DocDB data. Zigzag encoding keeps any other input correct.
+  const int64_t micros_delta = static_cast<int64_t>(
+      last_doc_ht.hybrid_time().GetPhysicalValueMicros() -
+      doc_ht.hybrid_time().GetPhysicalValueMicros());
+  hybrid_time_delta_.clear();
+  PutVarint64(&hybrid_time_delta_, (static_cast<uint64_t>(micros_delta) << 1) ^
+                                   static_cast<uint64_t>(micros_delta >> 63));
+  PutVarint32(&hybrid_time_delta_, doc_ht.hybrid_time().GetLogicalValue());
+  PutVarint32(&hybrid_time_delta_, doc_ht.write_id());
+  hybrid_time_delta_.append(key.cdata() + key.size() - kInternalKeyTrailerSize,
+                            kInternalKeyTrailerSize);
+  if (hybrid_time_delta_.size() >= non_shared) {
+    return false;
+  }
+
+  PutVarint32(&buffer_, static_cast<uint32_t>((prefix_size << 1) | 1));
+  PutVarint32(&buffer_, static_cast<uint32_t>(hybrid_time_delta_.size()));
+  PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+  buffer_.append(hybrid_time_delta_);
+  buffer_.append(value.cdata(), value.size());
+
+  last_key_.assign(key.cdata(), key.size());
+  return true;
+}
+
 }  // namespace rocksdb
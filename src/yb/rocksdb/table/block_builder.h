@@ -26,17 +26,34 @@
 
 #include <stdint.h>
 #include <vector>
+
+#include "yb/common/doc_hybrid_time.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
 
+// If set in the num_restarts field of the block trailer, the block was built with
+// use_hybrid_time_delta_encoding and the lowest bit of the shared bytes of every entry tells
+// whether the entry stores the DocHybridTime of its key as a delta from the previous key.
+constexpr uint32_t kHybridTimeDeltaEncodedBlockFlag = 1u << 31;
+
+// Size of the sequence number and value type trailer of an internal key.
+constexpr size_t kInternalKeyTrailerSize = sizeof(uint64_t);
+
+// Decodes the DocHybridTime at the end of the user key part of the given internal key and stores
+// the size of the user key preceding it in *prefix_size. Returns false if the key does not end
+// with a DocHybridTime.
+bool DecodeHybridTimeSuffix(const Slice& internal_key, size_t* prefix_size,
+                            yb::DocHybridTime* doc_ht);
+
 class BlockBuilder {
  public:
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        bool use_hybrid_time_delta_encoding = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -65,14 +82,21 @@ class BlockBuilder {
   }
 
  private:
+  // Tries to add an entry whose key only differs from the previous key in the DocHybridTime and
+  // the internal key trailer, storing the DocHybridTime as a delta from the one of the previous
+  // key. Returns false if that is not possible or not smaller than sharing non_shared bytes.
+  bool AddHybridTimeDelta(const Slice& key, const Slice& value, size_t non_shared);
+
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const bool         use_hybrid_time_delta_encoding_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
   int                   counter_;   // Number of entries emitted since restart
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
+  std::string           hybrid_time_delta_;  // Buffer for the key delta of AddHybridTimeDelta
 };
 
 }  // namespace rocksdb
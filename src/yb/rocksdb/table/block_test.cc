@@ -18,6 +18,8 @@
 // under the License.
 //
 #include <stdio.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -37,6 +39,9 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/util/logging.h"
+
 namespace rocksdb {
 
 std::string GenerateKey(int primary_key, int secondary_key, int padding_size,
@@ -135,6 +140,94 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+namespace {
+
+// Reads the block built by the given builder and checks that it contains exactly given entries.
+void CheckBlockEntries(BlockBuilder* builder, const std::vector<std::string>& keys,
+                       const std::vector<std::string>& values) {
+  BlockContents contents;
+  contents.data = builder->Finish();
+  contents.cachable = false;
+  Block reader(std::move(contents));
+
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(BytewiseComparator()));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); ++count, iter->Next()) {
+    ASSERT_LT(count, keys.size());
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(keys.size(), count);
+
+  for (size_t i = keys.size(); i-- > 0;) {
+    iter->Seek(keys[i]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[i], iter->key().ToString());
+    ASSERT_EQ(values[i], iter->value().ToString());
+    if (i > 0) {
+      iter->Prev();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys[i - 1], iter->key().ToString());
+    }
+  }
+}
+
+} // namespace
+
+TEST_F(BlockTest, HybridTimeDeltaEncoding) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int row = 0; row < 1000; ++row) {
+    char prefix[20];
+    snprintf(prefix, sizeof(prefix), "row%06dH", row);
+    // Versions of a DocDB key are sorted by descending hybrid time.
+    for (int version = 10; version-- > 0;) {
+      const yb::DocHybridTime doc_ht(
+          yb::kYugaByteMicrosecondEpoch + version * 1000 + rnd.Uniform(1000),
+          rnd.OneIn(4) ? rnd.Uniform(3) : 0, rnd.OneIn(2) ? rnd.Uniform(5) : 0);
+      std::string key = prefix;
+      doc_ht.AppendEncodedInDocDbFormat(&key);
+      PutFixed64(&key, PackSequenceAndType(row * 10 + version, kTypeValue));
+      keys.push_back(key);
+      values.push_back(RandomString(&rnd, 10));
+    }
+  }
+  // Also mix in keys that do not end with a DocHybridTime.
+  for (int i = 0; i < 100; ++i) {
+    keys.push_back("row" + RandomString(&rnd, 10));
+    values.push_back(RandomString(&rnd, 10));
+  }
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i != order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+  std::vector<std::string> sorted_keys;
+  std::vector<std::string> sorted_values;
+  for (size_t i : order) {
+    sorted_keys.push_back(keys[i]);
+    sorted_values.push_back(values[i]);
+  }
+
+  BlockBuilder builder(16);
+  BlockBuilder hybrid_time_delta_builder(16, true /* use_delta_encoding */,
+                                         true /* use_hybrid_time_delta_encoding */);
+  for (size_t i = 0; i != sorted_keys.size(); ++i) {
+    builder.Add(sorted_keys[i], sorted_values[i]);
+    hybrid_time_delta_builder.Add(sorted_keys[i], sorted_values[i]);
+  }
+  const size_t plain_size = builder.Finish().size();
+  const size_t hybrid_time_delta_size = hybrid_time_delta_builder.CurrentSizeEstimate();
+  LOG(INFO) << "Block size: " << plain_size << ", with hybrid time delta encoding: "
+            << hybrid_time_delta_size;
+  ASSERT_LT(hybrid_time_delta_size, plain_size);
+
+  CheckBlockEntries(&hybrid_time_delta_builder, sorted_keys, sorted_values);
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
@@ -26,6 +26,7 @@
 
 #include <memory>
 
+#include "yb/util/result.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -51,6 +52,10 @@ class TableReader {
   // Set data file reader for SST split into data and metadata files.
   virtual void SetDataFileReader(unique_ptr<RandomAccessFileReader>&& data_file) = 0;
 
+  // Reads all the data blocks into memory owned by the reader if the table options ask for it.
+  // Called once the reader is fully set up, before it is shared.
+  virtual Status PinDataBlocks() { return Status::OK(); }
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -114,6 +119,11 @@ class TableReader {
   virtual Status DumpTable(WritableFile* out_file) {
     return STATUS(NotSupported, "DumpTable() not supported");
   }
+
+  // Returns an internal key that approximately splits the table data in two halves.
+  virtual yb::Result<std::string> GetMiddleKey() {
+    return STATUS(NotSupported, "GetMiddleKey() not supported");
+  }
 };
 
 }  // namespace rocksdb
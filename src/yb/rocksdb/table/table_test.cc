@@ -298,7 +298,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            ioptions.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -1856,6 +1856,122 @@ void ValidateBlockSizeDeviation(int value, int expected) {
   delete factory;
 }
 
+TEST_F(BlockBasedTableTest, PinnedTopLevelIndex) {
+  Options options;
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+  options.compression = kNoCompression;
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1024 * 1024);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.pin_top_level_index = true;
+  table_options.cache_index_and_filter_blocks_with_high_priority = true;
+  table_options.index_type = IndexType::kMultiLevelBinarySearch;
+  table_options.block_size = 256;
+  table_options.index_block_size = 128;
+  table_options.min_keys_per_index_block = 2;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i < 200; ++i) {
+    c.Add(ToString(1000 + i), RandomString(&rnd, 100));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  {
+    auto props = c.GetTableProperties().user_collected_properties;
+    auto pos = props.find(BlockBasedTablePropertyNames::kNumIndexLevels);
+    ASSERT_TRUE(pos != props.end());
+    ASSERT_GT(static_cast<int>(DecodeFixed32(pos->second.c_str())), 1);
+  }
+  auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+
+  auto scan = [&c] {
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(200, num_keys);
+  };
+
+  // The top level index is loaded by the table reader, and the lower levels through the cache.
+  scan();
+  ASSERT_TRUE(reader->TEST_index_reader_loaded());
+  Statistics* statistics = options.statistics.get();
+  ASSERT_GT(statistics->getTickerCount(BLOCK_CACHE_INDEX_MISS), 0);
+  ASSERT_EQ(0, statistics->getTickerCount(BLOCK_CACHE_INDEX_HIT));
+
+  // Lower level index blocks are in the multi-touch part of the cache right away, while data blocks
+  // read by the same query stay in the single-touch part.
+  scan();
+  ASSERT_GT(statistics->getTickerCount(BLOCK_CACHE_INDEX_HIT), 0);
+  ASSERT_GT(statistics->getTickerCount(BLOCK_CACHE_DATA_HIT), 0);
+  ASSERT_EQ(statistics->getTickerCount(BLOCK_CACHE_INDEX_HIT),
+            statistics->getTickerCount(BLOCK_CACHE_MULTI_TOUCH_HIT));
+}
+
+TEST_F(BlockBasedTableTest, CompressionDictionary) {
+  if (!Zlib_Supported()) {
+    LOG(INFO) << "Skipping the test, zlib is not supported";
+    return;
+  }
+
+  // Each value shares most of its contents with the values of other blocks, but little with the
+  // values of its own block.
+  Random rnd(301);
+  std::vector<std::string> patterns;
+  for (int i = 0; i < 8; ++i) {
+    patterns.push_back(RandomString(&rnd, 200));
+  }
+  auto build = [&patterns](uint32_t max_dict_bytes, std::shared_ptr<Cache> block_cache_compressed,
+                           TableConstructor* c) {
+    Options options;
+    options.compression = kZlibCompression;
+    options.compression_opts.max_dict_bytes = max_dict_bytes;
+    BlockBasedTableOptions table_options;
+    table_options.block_size = 1024;
+    table_options.block_cache = NewLRUCache(1024 * 1024);
+    table_options.block_cache_compressed = std::move(block_cache_compressed);
+    table_options.cache_index_and_filter_blocks = false;
+    options.table_factory.reset(new BlockBasedTableFactory(table_options));
+    for (int i = 0; i < 500; ++i) {
+      c->Add(ToString(10000 + i), patterns[i % patterns.size()] + ToString(i));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableCFOptions ioptions(options);
+    c->Finish(options, ioptions, table_options,
+              GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+    return c->GetTableProperties().data_size;
+  };
+
+  TableConstructor without_dict(BytewiseComparator());
+  const uint64_t size_without_dict = build(0, nullptr, &without_dict);
+  TableConstructor with_dict(BytewiseComparator());
+  const uint64_t size_with_dict = build(4096, NewLRUCache(1024 * 1024), &with_dict);
+  ASSERT_LT(size_with_dict, size_without_dict);
+
+  // The blocks decompress with the dictionary, whether read from the file or from the compressed
+  // block cache that the builder filled.
+  for (int pass = 0; pass < 2; ++pass) {
+    unique_ptr<InternalIterator> iter(with_dict.NewIterator());
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+      ASSERT_EQ(ToString(10000 + i), iter->key().ToString());
+      ASSERT_EQ(patterns[i % patterns.size()] + ToString(i), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(500, i);
+  }
+}
+
 void ValidateBlockRestartInterval(int value, int expected) {
   BlockBasedTableOptions table_options;
   table_options.block_restart_interval = value;
@@ -32,6 +32,9 @@
 #include <algorithm>
 #include "yb/rocksdb/env.h"
 
+#include "yb/util/cpu_affinity.h"
+#include "yb/util/logging.h"
+
 namespace rocksdb {
 
 // MSVC complains that it is already defined since it is static in the header.
@@ -56,8 +59,8 @@ size_t OptimizeBlockSize(size_t block_size) {
   return block_size;
 }
 
-Arena::Arena(size_t block_size, size_t huge_page_size)
-    : kBlockSize(OptimizeBlockSize(block_size)) {
+Arena::Arena(size_t block_size, size_t huge_page_size, int numa_node)
+    : kBlockSize(OptimizeBlockSize(block_size)), numa_node_(numa_node) {
   assert(kBlockSize >= kMinBlockSize && kBlockSize <= kMaxBlockSize &&
          kBlockSize % kAlignUnit == 0);
   alloc_bytes_remaining_ = sizeof(inline_block_);
@@ -196,6 +199,15 @@ char* Arena::AllocateNewBlock(size_t block_bytes) {
   blocks_.reserve(blocks_.size() + 1);
 
   char* block = new char[block_bytes];
+  if (numa_node_ >= 0) {
+    // Done before the block is touched, its pages are not allocated yet. A
+    // failure only means the memory may be remote.
+    auto status = yb::PreferNumaNodeForMemory(block, block_bytes, numa_node_);
+    if (!status.ok()) {
+      YB_LOG_FIRST_N(WARNING, 1)
+          << "Failed to place arena block on NUMA node " << numa_node_ << ": " << status;
+    }
+  }
 
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
   blocks_memory_ += malloc_usable_size(block);
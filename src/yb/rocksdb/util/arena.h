@@ -52,7 +52,10 @@ class Arena : public Allocator {
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
   // page TLB first. If allocation fails, will fall back to normal case.
-  explicit Arena(size_t block_size = kMinBlockSize, size_t huge_page_size = 0);
+  // numa_node: if >= 0, the kernel is asked to place the pages of the new
+  // blocks on that NUMA node, when possible.
+  explicit Arena(size_t block_size = kMinBlockSize, size_t huge_page_size = 0,
+                 int numa_node = -1);
   ~Arena();
 
   char* Allocate(size_t bytes) override;
@@ -94,6 +97,8 @@ class Arena : public Allocator {
   char inline_block_[kInlineSize] __attribute__((__aligned__(sizeof(void*))));
   // Number of bytes allocated in one block
   const size_t kBlockSize;
+  // Preferred NUMA node of the blocks, -1 if none.
+  const int numa_node_;
   // Array of new[] allocated memory blocks
   typedef std::vector<char*> Blocks;
   Blocks blocks_;
@@ -21,6 +21,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <string.h>
+
 #include "yb/rocksdb/util/arena.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testharness.h"
@@ -203,6 +205,16 @@ TEST_F(ArenaTest, Simple) {
   SimpleTest(0);
   SimpleTest(kHugePageSize);
 }
+
+TEST_F(ArenaTest, NumaNode) {
+  // Blocks are usable whether or not the machine has the node.
+  Arena arena(Arena::kMinBlockSize * 4, 0, 0 /* numa_node */);
+  for (size_t size : {Arena::kMinBlockSize, Arena::kMinBlockSize * 8}) {
+    char* bytes = arena.Allocate(size);
+    memset(bytes, 0xab, size);
+  }
+  ASSERT_GE(arena.MemoryAllocatedBytes(), Arena::kMinBlockSize * 9);
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
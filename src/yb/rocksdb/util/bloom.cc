@@ -21,8 +21,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <cmath>
 #include <cstdlib>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "yb/rocksdb/filter_policy.h"
 
 #include "yb/rocksdb/table/block_based_filter_block.h"
@@ -63,6 +68,97 @@ inline void AddHash(uint32_t h, char* data, uint32_t num_lines, uint32_t total_b
   }
 }
 
+// Split block layout: every key sets one bit in each of the kSplitBlockWords 64-bit words of a
+// single line, the bit being picked by multiplying the key hash with a per-word odd constant.
+// Unlike the chained probes of AddHash, the probes don't depend on each other, so they are all
+// evaluated at once, with AVX2 when available.
+constexpr size_t kSplitBlockWords = 8;
+constexpr size_t kSplitBlockBytes = kSplitBlockWords * sizeof(uint64_t);
+
+// Stored in place of the number of probes. Readers that don't know the layout take the filter for
+// a broken one and treat every key as a possible match.
+constexpr char kSplitBlockMarker = 0;
+
+alignas(32) constexpr uint32_t kSplitBlockSalts[kSplitBlockWords] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+inline const char* SplitBlockLine(uint32_t h, const char* data, uint32_t num_lines) {
+  return data + ((static_cast<uint64_t>(h) * num_lines) >> 32) * kSplitBlockBytes;
+}
+
+inline uint32_t SplitBlockBit(uint32_t h, size_t word) {
+  return (h * kSplitBlockSalts[word]) >> 26;
+}
+
+inline void SplitBlockAddHash(uint32_t h, char* data, uint32_t num_lines) {
+  DCHECK_GT(num_lines, 0);
+  char* line = const_cast<char*>(SplitBlockLine(h, data, num_lines));
+  for (size_t i = 0; i != kSplitBlockWords; ++i) {
+    const uint32_t bit = SplitBlockBit(h, i);
+    line[i * sizeof(uint64_t) + bit / 8] |= 1 << (bit % 8);
+  }
+}
+
+inline bool SplitBlockHashMayMatch(uint32_t h, const char* data, uint32_t num_lines) {
+  const char* line = SplitBlockLine(h, data, num_lines);
+#ifdef __AVX2__
+  // Bits of all words at once: the words are little endian, so bit i of word w is the bit
+  // i % 8 of byte w * 8 + i / 8, as set by SplitBlockAddHash.
+  const __m256i salts = _mm256_load_si256(reinterpret_cast<const __m256i*>(kSplitBlockSalts));
+  const __m256i bits = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salts), 26);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i low_masks = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+  const __m256i high_masks = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+  const __m256i low_words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line));
+  const __m256i high_words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + 32));
+  // testc returns 1 when every bit of the mask is set in the words.
+  return _mm256_testc_si256(low_words, low_masks) && _mm256_testc_si256(high_words, high_masks);
+#else
+  for (size_t i = 0; i != kSplitBlockWords; ++i) {
+    const uint32_t bit = SplitBlockBit(h, i);
+    if ((line[i * sizeof(uint64_t) + bit / 8] & (1 << (bit % 8))) == 0) {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+// Expected false positive rate of a split block line, when keys_per_line keys land on a line on
+// average. The number of keys of a particular line follows a Poisson distribution.
+double SplitBlockFalsePositiveRate(double keys_per_line) {
+  constexpr double kBitsPerWord = sizeof(uint64_t) * 8;
+  double result = 0;
+  double probability = exp(-keys_per_line);
+  for (int keys = 0; keys < 4 * keys_per_line + 100; ++keys) {
+    if (keys > 0) {
+      probability *= keys_per_line / keys;
+    }
+    const double word_false_positive_rate = 1 - pow(1 - 1 / kBitsPerWord, keys);
+    result += probability * pow(word_false_positive_rate, kSplitBlockWords);
+  }
+  return result;
+}
+
+// Average number of keys per split block line that keeps the false positive rate at error_rate.
+double SplitBlockKeysPerLine(double error_rate) {
+  double low = 0;
+  double high = kSplitBlockBytes * 8;
+  for (int i = 0; i != 50; ++i) {
+    const double middle = (low + high) / 2;
+    if (SplitBlockFalsePositiveRate(middle) <= error_rate) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
 class FullFilterBitsBuilder : public FilterBitsBuilder {
  public:
   explicit FullFilterBitsBuilder(const size_t bits_per_key,
@@ -184,8 +280,11 @@ class FullFilterBitsReader : public FilterBitsReader {
         num_lines_(0) {
     assert(data_);
     GetFilterMeta(contents, &num_probes_, &num_lines_);
+    split_block_ = num_probes_ == static_cast<size_t>(kSplitBlockMarker) && num_lines_ != 0 &&
+                   data_len_ == num_lines_ * kSplitBlockBytes +
+                                FullFilterBitsBuilder::kMetaDataSize;
     // Sanitize broken parameters
-    if (num_lines_ != 0 && data_len_ != num_lines_ * CACHE_LINE_SIZE +
+    if (!split_block_ && num_lines_ != 0 && data_len_ != num_lines_ * CACHE_LINE_SIZE +
         FullFilterBitsBuilder::kMetaDataSize) {
       RLOG(InfoLogLevel::ERROR_LEVEL, logger, "Bloom filter data is broken, won't be used.");
       FAIL_IF_NOT_PRODUCTION();
@@ -200,6 +299,9 @@ class FullFilterBitsReader : public FilterBitsReader {
     if (data_len_ <= FullFilterBitsBuilder::kMetaDataSize) { // remain same with original filter
       return false;
     }
+    if (split_block_) {
+      return SplitBlockHashMayMatch(BloomHash(entry), data_, num_lines_);
+    }
     // Other Error params, including a broken filter, regarded as match
     if (num_probes_ == 0 || num_lines_ == 0) return true;
     uint32_t hash = BloomHash(entry);
@@ -214,6 +316,8 @@ class FullFilterBitsReader : public FilterBitsReader {
   uint32_t data_len_;
   size_t num_probes_;
   uint32_t num_lines_;
+  // Whether the filter has the split block layout of SplitBlockAddHash.
+  bool split_block_ = false;
 
   // Get num_probes, and num_lines from filter
   // If filter format broken, set both to 0.
@@ -416,10 +520,23 @@ class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
   FixedSizeFilterBitsBuilder(const FixedSizeFilterBitsBuilder&) = delete;
   void operator=(const FixedSizeFilterBitsBuilder&) = delete;
 
-  FixedSizeFilterBitsBuilder(uint32_t total_bits, double error_rate)
+  // With a positive split_block_keys_per_line the filter has the split block layout, and is full
+  // when it has that many keys per line.
+  FixedSizeFilterBitsBuilder(uint32_t total_bits, double error_rate,
+                             double split_block_keys_per_line)
       : error_rate_(error_rate) {
     DCHECK_GT(error_rate, 0);
     DCHECK_GT(total_bits, 0);
+    if (split_block_keys_per_line > 0) {
+      num_lines_ = yb::ceil_div<uint32_t>(total_bits, kSplitBlockBytes * 8);
+      total_bits_ = num_lines_ * kSplitBlockBytes * 8;
+      num_probes_ = 0;
+      max_keys_ = static_cast<size_t>(num_lines_ * split_block_keys_per_line);
+      keys_added_ = 0;
+      data_.reset(new char[FilterSize()]);
+      memset(data_.get(), 0, FilterSize());
+      return;
+    }
     num_lines_ = yb::ceil_div(total_bits, CACHE_LINE_SIZE * 8);
     // AddHash implementation gives much higher false positive rate when num_lines_ is even, so
     // make sure it is odd.
@@ -453,12 +570,17 @@ class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
   virtual void AddKey(const Slice& key) override {
     ++keys_added_;
     uint32_t hash = BloomHash(key);
+    if (num_probes_ == 0) {
+      SplitBlockAddHash(hash, data_.get(), num_lines_);
+      return;
+    }
     AddHash(hash, data_.get(), num_lines_, total_bits_, num_probes_);
   }
 
   virtual bool IsFull() const override { return keys_added_ >= max_keys_; }
 
   virtual Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    // For the split block layout num_probes_ is 0, i.e. kSplitBlockMarker.
     data_[total_bits_ / 8] = static_cast<char>(num_probes_);
     EncodeFixed32(data_.get() + total_bits_ / 8 + 1, static_cast<uint32_t>(num_lines_));
     buf->reset(data_.release());
@@ -478,7 +600,7 @@ class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
   uint32_t total_bits_; // total number of bits used for filter (excluding metadata)
   uint32_t num_lines_;
   double error_rate_;
-  size_t num_probes_; // number of hash functions
+  size_t num_probes_; // number of hash functions, 0 for the split block layout
 };
 
 class FixedSizeFilterBitsReader : public FullFilterBitsReader {
@@ -492,9 +614,10 @@ class FixedSizeFilterBitsReader : public FullFilterBitsReader {
 
 class FixedSizeFilterPolicy : public FilterPolicy {
  public:
-  explicit FixedSizeFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger)
+  FixedSizeFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger, bool split_block)
       : total_bits_(total_bits),
         error_rate_(error_rate),
+        split_block_keys_per_line_(split_block ? SplitBlockKeysPerLine(error_rate) : 0),
         logger_(logger) {
     DCHECK_GT(error_rate, 0);
     // Make sure num_probes > 0.
@@ -519,7 +642,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   }
 
   virtual FilterBitsBuilder* GetFilterBitsBuilder() const override {
-    return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_);
+    return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_, split_block_keys_per_line_);
   }
 
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
@@ -531,6 +654,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
 
   uint32_t total_bits_;
   double error_rate_;
+  double split_block_keys_per_line_;
   Logger* logger_;
 };
 
@@ -544,8 +668,9 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 
 const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                              double error_rate,
-                                             Logger* logger) {
-  return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
+                                             Logger* logger,
+                                             bool split_block) {
+  return new FixedSizeFilterPolicy(total_bits, error_rate, logger, split_block);
 }
 
 }  // namespace rocksdb
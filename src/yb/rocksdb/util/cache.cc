@@ -663,6 +663,9 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       subcache_type = MULTI_TOUCH;
     } else if (FLAGS_cache_single_touch_ratio == 1) {
       // If there is no multi touch cache, default to single cache.
+      if (e->query_id == kInMultiTouchId) {
+        e->query_id = kDefaultQueryId;
+      }
       subcache_type = SINGLE_TOUCH;
     } else {
       subcache_type = table_.GetSubCacheTypeCandidate(e);
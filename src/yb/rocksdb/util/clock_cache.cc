@@ -0,0 +1,677 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <assert.h>
+
+#include <atomic>
+#include <new>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/metrics.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/autovector.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation
+//
+// Entries of a shard are kept in a hash table and on a circular list, that the clock hand
+// sweeps when space is needed. Each entry has a hotness, which the hand decrements, and an entry
+// is evicted when the hand finds it cold and not referenced externally.
+//
+// Unlike the LRU cache, a hit does not move the entry between lists, so Lookup only takes the
+// shard lock in shared mode and Release does not take it at all: both adjust the atomic
+// reference count and hotness of the entry. The lock is taken exclusively only to add and
+// remove entries.
+//
+// Scan resistance follows the same query id rules as the LRU cache. An entry is inserted cold
+// and single touch. Hits from the query that inserted it do not make it hotter, so a scan
+// reading a block many times does not protect it from eviction. A hit from another query
+// moves the entry to multi touch, and every such hit makes it hotter, up to kMaxHotness.
+// While single touch entries use more than FLAGS_cache_single_touch_ratio of the capacity, the
+// hand only evicts them and passes multi touch entries untouched, so a large scan could not
+// flush the blocks shared by other queries.
+//
+// The cache owns one reference to each entry in its table. An entry removed from the table
+// while referenced externally is detached, and it is freed by the last Release.
+
+constexpr uint8_t kMaxHotness = 3;
+
+struct ClockHandle {
+  void* value;
+  void (*deleter)(const Slice&, void* value);
+  // Circular list of the entries in the table, protected by the exclusive shard lock.
+  ClockHandle* next;
+  ClockHandle* prev;
+  size_t charge;
+  size_t key_length;
+  std::atomic<uint32_t> refs;
+  std::atomic<uint8_t> hotness;
+  std::atomic<QueryId> query_id;
+  // Whether the entry was removed from the table while referenced externally.
+  bool detached;
+  uint32_t hash;
+  char key_data[1];   // Beginning of key
+
+  Slice key() const {
+    return Slice(key_data, key_length);
+  }
+
+  SubCacheType GetSubCacheType() const {
+    return query_id.load(std::memory_order_relaxed) == kInMultiTouchId ? MULTI_TOUCH
+                                                                        : SINGLE_TOUCH;
+  }
+};
+
+ClockHandle* NewClockHandle(const Slice& key) {
+  auto* memory = new char[sizeof(ClockHandle) - 1 + key.size()];
+  auto* e = new (memory) ClockHandle;
+  e->key_length = key.size();
+  memcpy(e->key_data, key.data(), key.size());
+  return e;
+}
+
+void DeleteClockHandle(ClockHandle* e) {
+  e->~ClockHandle();
+  delete[] reinterpret_cast<char*>(e);
+}
+
+// A single shard of sharded cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard() {}
+  ~ClockCacheShard();
+
+  void SetCapacity(size_t capacity);
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = metrics;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) {
+    WriteLock l(&mutex_);
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::Handle** handle, Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                        Statistics* statistics);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const;
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe);
+
+ private:
+  // Makes the entry hotter after a hit from the given query.
+  void Touch(ClockHandle* e, QueryId query_id);
+
+  // Adds the entry to the clock, just behind the hand, so it is visited last.
+  void Link(ClockHandle* e);
+  void Unlink(ClockHandle* e);
+
+  // Drops the reference of the cache to an entry removed from the table. Returns true if it was
+  // the last reference.
+  bool Detach(ClockHandle* e);
+
+  // Sweeps the clock until an entry is evicted. Returns false if there are no evictable entries.
+  // Requires the exclusive lock.
+  bool EvictOne(autovector<ClockHandle*>* deleted);
+  bool EvictOne(autovector<ClockHandle*>* deleted, bool single_touch_only);
+
+  // Calls the deleter and frees the entry. Should be called without the lock.
+  void Free(ClockHandle* e);
+
+  size_t capacity_ = 0;
+  bool strict_capacity_limit_ = false;
+
+  std::atomic<size_t> usage_{0};
+  std::atomic<size_t> detached_usage_{0};
+  // Updated by lookups promoting entries to multi touch, so it is atomic as well.
+  std::atomic<size_t> single_touch_usage_{0};
+
+  // mutex_ protects the table and the clock.
+  mutable port::RWMutex mutex_;
+  std::unordered_map<Slice, ClockHandle*, Slice::Hash> table_;
+  ClockHandle* hand_ = nullptr;
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+ClockCacheShard::~ClockCacheShard() {
+  for (const auto& p : table_) {
+    ClockHandle* e = p.second;
+    if (e->refs.load(std::memory_order_acquire) == 1) {
+      Free(e);
+    }
+  }
+}
+
+void ClockCacheShard::Touch(ClockHandle* e, QueryId query_id) {
+  auto entry_query_id = e->query_id.load(std::memory_order_relaxed);
+  if (entry_query_id != kInMultiTouchId) {
+    if (entry_query_id == query_id || FLAGS_cache_single_touch_ratio == 1) {
+      return;
+    }
+    if (!e->query_id.compare_exchange_strong(entry_query_id, kInMultiTouchId)) {
+      // Promoted by a concurrent lookup.
+      return;
+    }
+    single_touch_usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+    if (metrics_) {
+      metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
+      metrics_->single_touch_cache_usage->DecrementBy(e->charge);
+    }
+  }
+  // Races between concurrent hits could lose an increment, which is fine for a hint.
+  const auto hotness = e->hotness.load(std::memory_order_relaxed);
+  if (hotness < kMaxHotness) {
+    e->hotness.store(hotness + 1, std::memory_order_relaxed);
+  }
+}
+
+void ClockCacheShard::Link(ClockHandle* e) {
+  if (hand_ == nullptr) {
+    e->next = e->prev = e;
+    hand_ = e;
+    return;
+  }
+  e->next = hand_;
+  e->prev = hand_->prev;
+  e->prev->next = e;
+  hand_->prev = e;
+}
+
+void ClockCacheShard::Unlink(ClockHandle* e) {
+  if (e->next == e) {
+    hand_ = nullptr;
+  } else {
+    if (hand_ == e) {
+      hand_ = e->next;
+    }
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+  }
+  e->next = e->prev = nullptr;
+}
+
+bool ClockCacheShard::Detach(ClockHandle* e) {
+  // Marked before dropping the reference, so the last Release accounts for it.
+  e->detached = true;
+  detached_usage_.fetch_add(e->charge, std::memory_order_relaxed);
+  return e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+bool ClockCacheShard::EvictOne(autovector<ClockHandle*>* deleted) {
+  const bool single_touch_only = single_touch_usage_.load(std::memory_order_relaxed) >
+                                 capacity_ * FLAGS_cache_single_touch_ratio;
+  // Fall back to a full sweep when all single touch entries are pinned.
+  return (single_touch_only && EvictOne(deleted, true)) || EvictOne(deleted, false);
+}
+
+bool ClockCacheShard::EvictOne(autovector<ClockHandle*>* deleted, bool single_touch_only) {
+  // Each entry could be visited kMaxHotness times before it becomes cold.
+  size_t steps_left = (kMaxHotness + 1) * table_.size();
+  while (hand_ != nullptr && steps_left-- > 0) {
+    ClockHandle* e = hand_;
+    hand_ = e->next;
+    // Lookups are blocked by the exclusive lock, so an entry referenced only by the cache could
+    // not become referenced while we evict it.
+    if (e->refs.load(std::memory_order_acquire) > 1) {
+      continue;
+    }
+    if (single_touch_only && e->GetSubCacheType() == MULTI_TOUCH) {
+      continue;
+    }
+    const auto hotness = e->hotness.load(std::memory_order_relaxed);
+    if (hotness > 0) {
+      e->hotness.store(hotness - 1, std::memory_order_relaxed);
+      continue;
+    }
+    table_.erase(e->key());
+    Unlink(e);
+    e->refs.store(0, std::memory_order_relaxed);
+    deleted->push_back(e);
+    if (metrics_) {
+      metrics_->evictions->Increment();
+    }
+    return true;
+  }
+  return false;
+}
+
+void ClockCacheShard::Free(ClockHandle* e) {
+  (*e->deleter)(e->key(), e->value);
+  usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+  if (e->detached) {
+    detached_usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+  }
+  if (e->GetSubCacheType() == SINGLE_TOUCH) {
+    single_touch_usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+  }
+  if (metrics_) {
+    if (e->GetSubCacheType() == MULTI_TOUCH) {
+      metrics_->multi_touch_cache_usage->DecrementBy(e->charge);
+    } else {
+      metrics_->single_touch_cache_usage->DecrementBy(e->charge);
+    }
+    metrics_->cache_usage->DecrementBy(e->charge);
+  }
+  DeleteClockHandle(e);
+}
+
+size_t ClockCacheShard::GetPinnedUsage() const {
+  ReadLock l(&mutex_);
+  size_t result = detached_usage_.load(std::memory_order_relaxed);
+  for (const auto& p : table_) {
+    if (p.second->refs.load(std::memory_order_relaxed) > 1) {
+      result += p.second->charge;
+    }
+  }
+  return result;
+}
+
+void ClockCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
+                                             bool thread_safe) {
+  if (thread_safe) {
+    mutex_.ReadLock();
+  }
+  for (const auto& p : table_) {
+    callback(p.second->value, p.second->charge);
+  }
+  if (thread_safe) {
+    mutex_.ReadUnlock();
+  }
+}
+
+void ClockCacheShard::SetCapacity(size_t capacity) {
+  autovector<ClockHandle*> deleted;
+  {
+    WriteLock l(&mutex_);
+    capacity_ = capacity;
+    while (usage_.load(std::memory_order_relaxed) > capacity_ && EvictOne(&deleted)) {}
+  }
+  for (auto entry : deleted) {
+    Free(entry);
+  }
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                       Statistics* statistics) {
+  ClockHandle* e = nullptr;
+  {
+    ReadLock l(&mutex_);
+    auto it = table_.find(key);
+    if (it != table_.end()) {
+      e = it->second;
+      // The reference of the cache keeps the entry alive while we hold the lock.
+      e->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (e != nullptr) {
+    Touch(e, query_id);
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+      if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      }
+    }
+  } else if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_MISS);
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  ClockHandle* e = reinterpret_cast<ClockHandle*>(handle);
+  // Only detached entries could lose their last reference here.
+  if (e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Free(e);
+  }
+}
+
+Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                               void* value, size_t charge,
+                               void (*deleter)(const Slice& key, void* value),
+                               Cache::Handle** handle, Statistics* statistics) {
+  ClockHandle* e = NewClockHandle(key);
+  e->value = value;
+  e->deleter = deleter;
+  e->next = e->prev = nullptr;
+  e->charge = charge;
+  // One from the cache, one for the returned handle.
+  e->refs.store(handle == nullptr ? 1 : 2, std::memory_order_relaxed);
+  e->hotness.store(0, std::memory_order_relaxed);
+  e->query_id.store(FLAGS_cache_single_touch_ratio == 0 ? kInMultiTouchId : query_id,
+                    std::memory_order_relaxed);
+  e->detached = false;
+  e->hash = hash;
+
+  Status s;
+  autovector<ClockHandle*> deleted;
+  ClockHandle* rejected = nullptr;
+  {
+    WriteLock l(&mutex_);
+    auto it = table_.find(key);
+    ClockHandle* old = it == table_.end() ? nullptr : it->second;
+    // A block read again by another query after it was replaced stays multi touch.
+    if (old != nullptr && FLAGS_cache_single_touch_ratio != 1 &&
+        (old->GetSubCacheType() == MULTI_TOUCH ||
+         old->query_id.load(std::memory_order_relaxed) != query_id)) {
+      e->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+      e->hotness.store(old->hotness.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+    }
+
+    while (usage_.load(std::memory_order_relaxed) + charge > capacity_ && EvictOne(&deleted)) {
+      // The old entry could have been evicted.
+      if (old != nullptr && table_.count(key) == 0) {
+        old = nullptr;
+      }
+    }
+
+    if (strict_capacity_limit_ && usage_.load(std::memory_order_relaxed) + charge > capacity_) {
+      if (handle == nullptr) {
+        // Nobody else knows about the value, so it is deleted as if it was evicted.
+        rejected = e;
+      } else {
+        DeleteClockHandle(e);
+        *handle = nullptr;
+      }
+      e = nullptr;
+      s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+    } else {
+      if (old != nullptr) {
+        table_.erase(old->key());
+        Unlink(old);
+        if (Detach(old)) {
+          deleted.push_back(old);
+        }
+      }
+      table_.emplace(e->key(), e);
+      Link(e);
+      usage_.fetch_add(charge, std::memory_order_relaxed);
+      if (e->GetSubCacheType() == SINGLE_TOUCH) {
+        single_touch_usage_.fetch_add(charge, std::memory_order_relaxed);
+      }
+      if (handle != nullptr) {
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+    }
+    // Lookups are blocked, so the type of the new entry could not change yet.
+    const SubCacheType subcache_type = e != nullptr ? e->GetSubCacheType() : SINGLE_TOUCH;
+
+    if (statistics != nullptr) {
+      if (s.ok()) {
+        RecordTick(statistics, BLOCK_CACHE_ADD);
+        RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+        if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+          RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+          RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+        } else {
+          RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+          RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+        }
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+      }
+    }
+    if (metrics_ != nullptr && s.ok()) {
+      metrics_->inserts->Increment();
+      if (subcache_type == MULTI_TOUCH) {
+        metrics_->multi_touch_cache_usage->IncrementBy(charge);
+      } else {
+        metrics_->single_touch_cache_usage->IncrementBy(charge);
+      }
+      metrics_->cache_usage->IncrementBy(charge);
+    }
+  }
+
+  // Free the entries outside of the lock for performance reasons.
+  for (auto entry : deleted) {
+    Free(entry);
+  }
+  if (rejected != nullptr) {
+    // The rejected entry was never accounted in the usage.
+    (*rejected->deleter)(rejected->key(), rejected->value);
+    DeleteClockHandle(rejected);
+  }
+
+  return s;
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  ClockHandle* e = nullptr;
+  bool last_reference = false;
+  {
+    WriteLock l(&mutex_);
+    auto it = table_.find(key);
+    if (it != table_.end()) {
+      e = it->second;
+      table_.erase(it);
+      Unlink(e);
+      last_reference = Detach(e);
+    }
+  }
+  if (last_reference) {
+    Free(e);
+  }
+}
+
+static int kNumShardBits = 4;          // default values, can be overridden
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit) {
+    int num_shards = 1 << num_shard_bits_;
+    shards_ = new ClockCacheShard[num_shards];
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    MutexLock l(&capacity_mutex_);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    ClockHandle* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash)].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return reinterpret_cast<ClockHandle*>(e)->GetSubCacheType();
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback, thread_safe);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    int num_shards = 1 << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  bool IsValidQueryId(const QueryId query_id) {
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+  }
+
+  ClockCacheShard* shards_;
+  port::Mutex capacity_mutex_;
+  std::atomic<uint64_t> last_id_{0};
+  int num_shard_bits_;
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // end anonymous namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kNumShardBits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                bool strict_capacity_limit) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits, strict_capacity_limit);
+}
+
+}  // namespace rocksdb
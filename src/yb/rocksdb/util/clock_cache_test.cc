@@ -0,0 +1,318 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/cache.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/string_util.h"
+#include "yb/rocksdb/util/testharness.h"
+
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+static std::string EncodeKey(int k) {
+  std::string result;
+  PutFixed32(&result, k);
+  return result;
+}
+static int DecodeKey(const Slice& k) {
+  assert(k.size() == 4);
+  return DecodeFixed32(k.data());
+}
+static void* EncodeValue(uintptr_t v) { return reinterpret_cast<void*>(v); }
+static int DecodeValue(void* v) {
+  return static_cast<int>(reinterpret_cast<uintptr_t>(v));
+}
+
+class ClockCacheTest : public testing::Test {
+ public:
+  static ClockCacheTest* current_;
+
+  static void Deleter(const Slice& key, void* v) {
+    current_->deleted_keys_.push_back(DecodeKey(key));
+    current_->deleted_values_.push_back(DecodeValue(v));
+  }
+
+  static const int kCacheSize = 100;
+  static const QueryId kTestQueryId = 1;
+
+  std::vector<int> deleted_keys_;
+  std::vector<int> deleted_values_;
+  // A single shard, so the eviction order is deterministic.
+  shared_ptr<Cache> cache_;
+
+  ClockCacheTest() : cache_(NewClockCache(kCacheSize, 0)) {
+    current_ = this;
+  }
+
+  int Lookup(int key, QueryId query_id = kTestQueryId) {
+    Cache::Handle* handle = cache_->Lookup(EncodeKey(key), query_id);
+    const int r = (handle == nullptr) ? -1 : DecodeValue(cache_->Value(handle));
+    if (handle != nullptr) {
+      cache_->Release(handle);
+    }
+    return r;
+  }
+
+  Status Insert(int key, int value, int charge = 1, QueryId query_id = kTestQueryId) {
+    return cache_->Insert(EncodeKey(key), query_id, EncodeValue(value), charge,
+                          &ClockCacheTest::Deleter);
+  }
+
+  void Erase(int key) {
+    cache_->Erase(EncodeKey(key));
+  }
+};
+ClockCacheTest* ClockCacheTest::current_;
+
+TEST_F(ClockCacheTest, HitAndMiss) {
+  ASSERT_EQ(-1, Lookup(100));
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(-1,  Lookup(200));
+
+  ASSERT_OK(Insert(200, 201));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+
+  ASSERT_OK(Insert(100, 102));
+  ASSERT_EQ(102, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+}
+
+TEST_F(ClockCacheTest, Erase) {
+  Erase(200);
+  ASSERT_EQ(0U, deleted_keys_.size());
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_OK(Insert(200, 201));
+  Erase(100);
+  ASSERT_EQ(-1,  Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(100);
+  ASSERT_EQ(1U, deleted_keys_.size());
+}
+
+TEST_F(ClockCacheTest, EntriesArePinned) {
+  ASSERT_OK(Insert(100, 101));
+  Cache::Handle* h1 = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache_->Value(h1)));
+
+  ASSERT_OK(Insert(100, 102));
+  Cache::Handle* h2 = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(102, DecodeValue(cache_->Value(h2)));
+  ASSERT_EQ(0U, deleted_keys_.size());
+  // The replaced entry is still accounted while referenced.
+  ASSERT_EQ(2U, cache_->GetUsage());
+  ASSERT_EQ(2U, cache_->GetPinnedUsage());
+
+  cache_->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(100);
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+
+  cache_->Release(h2);
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(102, deleted_values_[1]);
+  ASSERT_EQ(0U, cache_->GetUsage());
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+}
+
+TEST_F(ClockCacheTest, PinnedEntriesAreNotEvicted) {
+  ASSERT_OK(Insert(100, 101));
+  Cache::Handle* h = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(1U, cache_->GetPinnedUsage());
+
+  for (int i = 0; i < kCacheSize * 2; i++) {
+    ASSERT_OK(Insert(1000 + i, 2000 + i));
+  }
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(static_cast<size_t>(kCacheSize), cache_->GetUsage());
+  ASSERT_EQ(1U, cache_->GetPinnedUsage());
+
+  cache_->Release(h);
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+}
+
+TEST_F(ClockCacheTest, ScanResistance) {
+  // Blocks read by different queries are shared, and should survive a large scan.
+  const int kNumHot = kCacheSize / 2;
+  for (int i = 0; i < kNumHot; i++) {
+    ASSERT_OK(Insert(i, i + 1));
+    ASSERT_EQ(i + 1, Lookup(i, kTestQueryId + 1));
+  }
+
+  // The scan reads each of its blocks several times, which should not make them hot.
+  const QueryId kScanQueryId = kTestQueryId + 2;
+  for (int i = 0; i < kCacheSize * 10; i++) {
+    ASSERT_OK(Insert(1000 + i, 2000 + i, 1, kScanQueryId));
+    ASSERT_EQ(2000 + i, Lookup(1000 + i, kScanQueryId));
+    ASSERT_EQ(2000 + i, Lookup(1000 + i, kScanQueryId));
+  }
+
+  for (int i = 0; i < kNumHot; i++) {
+    ASSERT_EQ(i + 1, Lookup(i)) << "Hot block " << i << " was evicted by the scan";
+  }
+  ASSERT_LE(cache_->GetUsage(), static_cast<size_t>(kCacheSize));
+}
+
+TEST_F(ClockCacheTest, EvictionPolicyAllSingleTouch) {
+  FLAGS_cache_single_touch_ratio = 1;
+  cache_ = NewClockCache(2, 0);
+  ASSERT_OK(Insert(1, 101));
+  ASSERT_OK(Insert(2, 102));
+  // Hits do not promote entries, so they are evicted in clock order.
+  ASSERT_EQ(101, Lookup(1, kTestQueryId + 1));
+  ASSERT_OK(Insert(3, 103));
+  ASSERT_EQ(-1, Lookup(1));
+  ASSERT_EQ(102, Lookup(2));
+  ASSERT_EQ(103, Lookup(3));
+
+  // Returning the flag back.
+  FLAGS_cache_single_touch_ratio = 0.2;
+}
+
+TEST_F(ClockCacheTest, EvictionPolicyNoSingleTouch) {
+  FLAGS_cache_single_touch_ratio = 0;
+  cache_ = NewClockCache(2, 0);
+  ASSERT_OK(Insert(1, 101));
+  ASSERT_OK(Insert(2, 102));
+  // Every hit makes an entry hotter, so the hand passes the entry that was read.
+  ASSERT_EQ(101, Lookup(1));
+  ASSERT_OK(Insert(3, 103));
+  ASSERT_EQ(101, Lookup(1));
+  ASSERT_EQ(-1, Lookup(2));
+  ASSERT_EQ(103, Lookup(3));
+
+  // Returning the flag back.
+  FLAGS_cache_single_touch_ratio = 0.2;
+}
+
+TEST_F(ClockCacheTest, NoCacheQueryId) {
+  ASSERT_OK(Insert(100, 101, 1, kNoCacheQueryId));
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(0U, cache_->GetUsage());
+}
+
+TEST_F(ClockCacheTest, SetCapacity) {
+  for (int i = 0; i < kCacheSize; i++) {
+    ASSERT_OK(Insert(i, i + 1));
+  }
+  ASSERT_EQ(static_cast<size_t>(kCacheSize), cache_->GetUsage());
+  cache_->SetCapacity(kCacheSize / 2);
+  ASSERT_EQ(static_cast<size_t>(kCacheSize / 2), cache_->GetCapacity());
+  ASSERT_EQ(static_cast<size_t>(kCacheSize / 2), cache_->GetUsage());
+  ASSERT_EQ(static_cast<size_t>(kCacheSize / 2), deleted_keys_.size());
+}
+
+TEST_F(ClockCacheTest, SetStrictCapacityLimit) {
+  cache_ = NewClockCache(5, 0, true);
+  ASSERT_TRUE(cache_->HasStrictCapacityLimit());
+  std::vector<Cache::Handle*> handles(5);
+  for (int i = 0; i < 5; i++) {
+    ASSERT_OK(cache_->Insert(EncodeKey(i), kTestQueryId, EncodeValue(i + 1), 1,
+                             &ClockCacheTest::Deleter, &handles[i]));
+    ASSERT_NE(nullptr, handles[i]);
+  }
+
+  // All entries are pinned, so nothing could be evicted.
+  Cache::Handle* handle;
+  Status s = cache_->Insert(EncodeKey(100), kTestQueryId, EncodeValue(101), 1,
+                            &ClockCacheTest::Deleter, &handle);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+  ASSERT_EQ(0U, deleted_keys_.size());
+
+  // Without a handle the value is owned by the cache, and is deleted right away.
+  s = Insert(100, 101);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(5U, cache_->GetUsage());
+
+  for (auto* h : handles) {
+    cache_->Release(h);
+  }
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(5U, cache_->GetUsage());
+}
+
+TEST_F(ClockCacheTest, ApplyToAllCacheEntries) {
+  static std::atomic<size_t> total_charge{0};
+  total_charge = 0;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Insert(i, i + 1, i + 1));
+  }
+  cache_->ApplyToAllCacheEntries([](void*, size_t charge) { total_charge += charge; }, true);
+  ASSERT_EQ(55U, total_charge);
+}
+
+TEST_F(ClockCacheTest, ConcurrentLookups) {
+  static void (*noop_deleter)(const Slice&, void*) = [](const Slice&, void*) {};
+  auto cache = NewClockCache(1000, 2);
+  constexpr int kNumKeys = 2000;
+  constexpr int kNumThreads = 8;
+  std::atomic<int> hits{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&cache, &hits, t] {
+      for (int i = 0; i < kNumKeys * 10; i++) {
+        const int key = (i * 7 + t) % kNumKeys;
+        Cache::Handle* handle = cache->Lookup(EncodeKey(key), t + 1);
+        if (handle != nullptr) {
+          ASSERT_EQ(key, DecodeValue(cache->Value(handle)));
+          cache->Release(handle);
+          hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          ASSERT_OK(cache->Insert(EncodeKey(key), t + 1, EncodeValue(key), 1, noop_deleter));
+          if (i % 3 == 0) {
+            cache->Erase(EncodeKey(key));
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_GT(hits.load(), 0);
+  ASSERT_LE(cache->GetUsage(), 1000U);
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -29,6 +29,7 @@
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/util/slice.h"
 
 #ifdef SNAPPY
 #include <snappy.h>
@@ -110,6 +111,12 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
   }
 }
 
+// Whether the blocks compressed with the type can share a dictionary, see
+// CompressionOptions::max_dict_bytes.
+inline bool CompressionTypeSupportsDictionary(CompressionType compression_type) {
+  return compression_type == kZlibCompression || compression_type == kZSTDNotFinalCompression;
+}
+
 inline std::string CompressionTypeToString(CompressionType compression_type) {
   switch (compression_type) {
     case kNoCompression:
@@ -195,10 +202,14 @@ inline bool GetDecompressedSizeInfo(const char** input_data,
 // block header
 // compress_format_version == 2 -- decompressed size is included in the block
 // header in varint32 format
+// A non-empty compression_dict is used as the preset dictionary of the stream, so that data that
+// repeats the dictionary compresses well even in small blocks. The same dictionary has to be
+// passed to Zlib_Uncompress.
 inline bool Zlib_Compress(const CompressionOptions& opts,
                           uint32_t compress_format_version,
                           const char* input, size_t length,
-                          ::std::string* output) {
+                          ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZLIB
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -228,6 +239,16 @@ inline bool Zlib_Compress(const CompressionOptions& opts,
     return false;
   }
 
+  if (!compression_dict.empty()) {
+    st = deflateSetDictionary(
+        &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+        static_cast<unsigned int>(compression_dict.size()));
+    if (st != Z_OK) {
+      deflateEnd(&_stream);
+      return false;
+    }
+  }
+
   // Compress the input, and put compressed data in output.
   _stream.next_in = (Bytef *)input;
   _stream.avail_in = static_cast<unsigned int>(length);
@@ -268,7 +289,8 @@ inline bool Zlib_Compress(const CompressionOptions& opts,
 inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
                              int* decompress_size,
                              uint32_t compress_format_version,
-                             int windowBits = -14) {
+                             int windowBits = -14,
+                             const Slice& compression_dict = Slice()) {
 #ifdef ZLIB
   uint32_t output_len = 0;
   if (compress_format_version == 2) {
@@ -297,6 +319,17 @@ inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
+  // A raw stream takes the dictionary upfront, a stream with a header asks for it, see below.
+  if (!compression_dict.empty() && windowBits < 0) {
+    st = inflateSetDictionary(
+        &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+        static_cast<unsigned int>(compression_dict.size()));
+    if (st != Z_OK) {
+      inflateEnd(&_stream);
+      return nullptr;
+    }
+  }
+
   _stream.next_in = (Bytef *)input_data;
   _stream.avail_in = static_cast<unsigned int>(input_length);
 
@@ -330,6 +363,16 @@ inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
         _stream.avail_out = static_cast<unsigned int>(output_len - old_sz);
         break;
       }
+      case Z_NEED_DICT:
+        if (!compression_dict.empty() &&
+            inflateSetDictionary(
+                &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+                static_cast<unsigned int>(compression_dict.size())) == Z_OK) {
+          break;
+        }
+        delete[] output;
+        inflateEnd(&_stream);
+        return nullptr;
       case Z_BUF_ERROR:
       default:
         delete[] output;
@@ -621,7 +664,8 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
 }
 
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +677,18 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen = 0;
+  if (compression_dict.empty()) {
+    outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
+                           input, length, opts.level);
+  } else {
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    outlen = ZSTD_compress_usingDict(
+        context, &(*output)[output_header_len], compressBound, input, length,
+        compression_dict.data(), compression_dict.size(), opts.level);
+    ZSTD_freeCCtx(context);
+  }
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -645,7 +698,8 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -654,8 +708,20 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   }
 
   char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
+  size_t actual_output_length = 0;
+  if (compression_dict.empty()) {
+    actual_output_length = ZSTD_decompress(output, output_len, input_data, input_length);
+  } else {
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    actual_output_length = ZSTD_decompress_usingDict(
+        context, output, output_len, input_data, input_length, compression_dict.data(),
+        compression_dict.size());
+    ZSTD_freeDCtx(context);
+  }
+  if (ZSTD_isError(actual_output_length)) {
+    delete[] output;
+    return nullptr;
+  }
   assert(actual_output_length == output_len);
   *decompress_size = static_cast<int>(actual_output_length);
   return output;
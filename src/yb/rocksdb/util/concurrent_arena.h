@@ -57,7 +57,7 @@ class ConcurrentArena : public Allocator {
   // shards compute their shard_block_size as a fraction of block_size
   // that varies according to the hardware concurrency level.
   explicit ConcurrentArena(size_t block_size = Arena::kMinBlockSize,
-                           size_t huge_page_size = 0);
+                           size_t huge_page_size = 0, int numa_node = -1);
 
   char* Allocate(size_t bytes) override {
     return AllocateImpl(bytes, false /*force_arena*/,
@@ -27,6 +27,8 @@
 #include "yb/rocksdb/util/crc32c.h"
 
 #include <stdint.h>
+#include <string.h>
+
 #ifdef __SSE4_2__
 #include <nmmintrin.h>
 #endif
@@ -388,6 +390,130 @@ uint32_t ExtendImpl(uint32_t crc, const char* buf, size_t size) {
   return static_cast<uint32_t>(l ^ 0xffffffffu);
 }
 
+#if defined(__SSE4_2__) && defined(__LP64__)
+
+// The crc32 instruction has a latency of three cycles but a throughput of one per cycle, so a
+// single chain of instructions leaves the unit idle most of the time. Large buffers are split into
+// three lanes that are checksummed together and then combined: the checksum of a lane followed by
+// another is the checksum of the first one shifted over the length of the second, xor the checksum
+// of the second. Shifting over a given length is a linear operator on the 32 bits of the checksum
+// and is applied with a table per byte, precomputed for the two lane lengths used.
+constexpr size_t kLongLane = 8192;
+constexpr size_t kShortLane = 256;
+
+// Reflected CRC32C polynomial.
+constexpr uint32_t kCrc32cPoly = 0x82f63b78;
+
+// Multiplies the 32x32 matrix over GF(2) by vec.
+static uint32_t GF2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+    vec >>= 1;
+    ++mat;
+  }
+  return sum;
+}
+
+static void GF2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = GF2MatrixTimes(mat, mat[n]);
+  }
+}
+
+// Builds the operator that appends len zero bytes to a checksum, len being a power of two.
+static void ZerosOperator(size_t len, uint32_t* even) {
+  uint32_t odd[32];
+  // The operator for one zero bit.
+  odd[0] = kCrc32cPoly;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; ++n) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  // Two zero bits, then four.
+  GF2MatrixSquare(even, odd);
+  GF2MatrixSquare(odd, even);
+  // Every square doubles the number of zero bits, starting with one zero byte.
+  for (;;) {
+    GF2MatrixSquare(even, odd);
+    len >>= 1;
+    if (len == 0) {
+      return;
+    }
+    GF2MatrixSquare(odd, even);
+    len >>= 1;
+    if (len == 0) {
+      break;
+    }
+  }
+  memcpy(even, odd, sizeof(odd));
+}
+
+class ShiftTable {
+ public:
+  explicit ShiftTable(size_t len) {
+    uint32_t op[32];
+    ZerosOperator(len, op);
+    for (uint32_t n = 0; n < 256; ++n) {
+      for (int byte = 0; byte < 4; ++byte) {
+        table_[byte][n] = GF2MatrixTimes(op, n << (8 * byte));
+      }
+    }
+  }
+
+  uint32_t Shift(uint32_t crc) const {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^
+           table_[2][(crc >> 16) & 0xff] ^ table_[3][crc >> 24];
+  }
+
+ private:
+  uint32_t table_[4][256];
+};
+
+// Checksums three consecutive lanes of lane_size bytes each, starting at *p, into *crc.
+static inline void Crc32ThreeLanes(
+    const ShiftTable& shift, size_t lane_size, uint64_t* crc, const uint8_t** p) {
+  uint64_t crc0 = *crc;
+  uint64_t crc1 = 0;
+  uint64_t crc2 = 0;
+  const uint8_t* lane = *p;
+  const uint8_t* const end = lane + lane_size;
+  do {
+    crc0 = _mm_crc32_u64(crc0, LE_LOAD64(lane));
+    crc1 = _mm_crc32_u64(crc1, LE_LOAD64(lane + lane_size));
+    crc2 = _mm_crc32_u64(crc2, LE_LOAD64(lane + 2 * lane_size));
+    lane += 8;
+  } while (lane != end);
+  crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+  *crc = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+  *p += 3 * lane_size;
+}
+
+static uint32_t ExtendParallel(uint32_t crc, const char* buf, size_t size) {
+  if (size < 3 * kShortLane) {
+    return ExtendImpl<Fast_CRC32>(crc, buf, size);
+  }
+  static const ShiftTable long_shift(kLongLane);
+  static const ShiftTable short_shift(kShortLane);
+
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(buf);
+  const uint8_t* const e = p + size;
+  uint64_t l = crc ^ 0xffffffffu;
+  while (static_cast<size_t>(e - p) >= 3 * kLongLane) {
+    Crc32ThreeLanes(long_shift, kLongLane, &l, &p);
+  }
+  while (static_cast<size_t>(e - p) >= 3 * kShortLane) {
+    Crc32ThreeLanes(short_shift, kShortLane, &l, &p);
+  }
+  return ExtendImpl<Fast_CRC32>(
+      static_cast<uint32_t>(l ^ 0xffffffffu), reinterpret_cast<const char*>(p), e - p);
+}
+
+#endif
+
 // Detect if SS42 or not.
 static bool isSSE42() {
 #if defined(__GNUC__) && defined(__x86_64__) && !defined(IOS_CROSS_COMPILE)
@@ -403,7 +529,11 @@ static bool isSSE42() {
 typedef uint32_t (*Function)(uint32_t, const char*, size_t);
 
 static inline Function Choose_Extend() {
+#if defined(__SSE4_2__) && defined(__LP64__)
+  return isSSE42() ? ExtendParallel : ExtendImpl<Slow_CRC32>;
+#else
   return isSSE42() ? ExtendImpl<Fast_CRC32> : ExtendImpl<Slow_CRC32>;
+#endif
 }
 
 bool IsFastCrc32Supported() {
@@ -21,6 +21,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
+#include <string>
+
 #include "yb/rocksdb/util/crc32c.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -75,6 +78,24 @@ TEST(CRC, Extend) {
             Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, ExtendLarge) {
+  // Large buffers are checksummed in parallel lanes, that must give the same result as extending
+  // the checksum a few bytes at a time.
+  std::string data(100000, 0);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * 7 + (i >> 8));
+  }
+  for (size_t size : {767, 768, 769, 24575, 24576, 24577, 30000, 100000}) {
+    uint32_t expected = 0;
+    for (size_t offset = 0; offset < size; offset += 5) {
+      expected = Extend(expected, data.data() + offset, std::min<size_t>(5, size - offset));
+    }
+    ASSERT_EQ(expected, Value(data.data(), size)) << size;
+    ASSERT_EQ(Extend(Value(data.data(), 3), data.data() + 3, size - 3),
+              Value(data.data(), size)) << size;
+  }
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
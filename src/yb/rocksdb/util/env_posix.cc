@@ -180,9 +180,13 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd;
+    int flags = O_RDONLY;
+    if (UseDirectIO(options.use_direct_reads)) {
+      flags |= O_DIRECT;
+    }
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = open(fname.c_str(), flags);
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
@@ -215,9 +219,13 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd = -1;
+    int flags = O_CREAT | O_RDWR | O_TRUNC;
+    if (UseDirectIO(options.use_direct_writes)) {
+      flags |= O_DIRECT;
+    }
     do {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+      fd = open(fname.c_str(), flags, 0644);
     } while (fd < 0 && errno == EINTR);
     if (fd < 0) {
       s = IOError(fname, errno);
@@ -233,7 +241,8 @@ class PosixEnv : public Env {
           checkedDiskForMmap_ = true;
         }
       }
-      if (options.use_mmap_writes && !forceMmapOff) {
+      // Direct writes go through PosixWritableFile, mmap writes could not bypass the page cache.
+      if (options.use_mmap_writes && !options.use_direct_writes && !forceMmapOff) {
         result->reset(new PosixMmapFile(fname, fd, page_size_, options));
       } else {
         // disable mmap writes
@@ -461,6 +470,10 @@ class PosixEnv : public Env {
                         Priority pri = LOW, void* tag = nullptr,
                         void (*unschedFunction)(void* arg) = 0) override;
 
+  void ScheduleWithPriority(void (*function)(void* arg1), void* arg, Priority pri, void* tag,
+                            void (*unschedFunction)(void* arg),
+                            int (*priority)(void* tag)) override;
+
   int UnSchedule(void* arg, Priority pri) override;
 
   void StartThread(void (*function)(void* arg), void* arg) override;
@@ -710,6 +723,13 @@ void PosixEnv::Schedule(void (*function)(void* arg1), void* arg, Priority pri,
   thread_pools_[pri].Schedule(function, arg, tag, unschedFunction);
 }
 
+void PosixEnv::ScheduleWithPriority(void (*function)(void* arg1), void* arg, Priority pri,
+                                    void* tag, void (*unschedFunction)(void* arg),
+                                    int (*priority)(void* tag)) {
+  assert(pri >= Priority::LOW && pri <= Priority::HIGH);
+  thread_pools_[pri].Schedule(function, arg, tag, unschedFunction, priority);
+}
+
 int PosixEnv::UnSchedule(void* arg, Priority pri) {
   return thread_pools_[pri].UnSchedule(arg);
 }
@@ -46,6 +46,7 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/string_util.h"
@@ -156,6 +157,53 @@ TEST_F(EnvPosixTest, RunMany) {
   ASSERT_EQ(4, cur);
 }
 
+TEST_F(EnvPosixTest, ScheduleWithPriority) {
+  struct Job {
+    std::atomic<int> priority{0};
+    std::vector<int>* order;
+    int id;
+
+    static void Run(void* v) {
+      auto job = static_cast<Job*>(v);
+      job->order->push_back(job->id);
+    }
+
+    static int Priority(void* tag) {
+      return static_cast<Job*>(tag)->priority.load();
+    }
+  };
+
+  env_->SetBackgroundThreads(1, Env::Priority::LOW);
+  // Keep the only thread busy, so the jobs are queued.
+  test::SleepingBackgroundTask sleeping_task;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task, Env::Priority::LOW);
+  sleeping_task.WaitUntilSleeping();
+
+  std::vector<int> order;
+  std::vector<std::unique_ptr<Job>> jobs;
+  for (int i = 0; i != 4; ++i) {
+    jobs.emplace_back(new Job);
+    jobs.back()->order = &order;
+    jobs.back()->id = i;
+    jobs.back()->priority = i % 2;
+    env_->ScheduleWithPriority(&Job::Run, jobs.back().get(), Env::Priority::LOW,
+                               jobs.back().get(), nullptr, &Job::Priority);
+  }
+  // Priorities are evaluated when the jobs are picked, not when they are scheduled.
+  jobs[2]->priority = 10;
+
+  sleeping_task.WakeUp();
+  sleeping_task.WaitUntilDone();
+  // The last job is picked after the thread is done with the previous ones.
+  test::SleepingBackgroundTask done_task;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &done_task, Env::Priority::LOW);
+  done_task.WaitUntilSleeping();
+  done_task.WakeUp();
+  done_task.WaitUntilDone();
+
+  ASSERT_EQ(std::vector<int>({2, 1, 3, 0}), order);
+}
+
 struct State {
   port::Mutex mu;
   int val;
@@ -809,6 +857,96 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   ASSERT_OK(env_->DeleteFile(fname));
 }
 #endif  // not TRAVIS
+
+TEST_F(EnvPosixTest, MmapReads) {
+  if (sizeof(void*) < 8) {
+    return;
+  }
+  std::string fname = test::TmpDir() + "/" + "testfile";
+  const std::string data(3 * 4096 + 100, 'x');
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, EnvOptions()));
+    ASSERT_OK(wfile->Append(Slice(data)));
+    ASSERT_OK(wfile->Close());
+  }
+
+  EnvOptions soptions;
+  soptions.use_mmap_reads = true;
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  char scratch[100];
+  Slice result;
+  ASSERT_OK(file->Read(4096 + 10, 50, &result, scratch));
+  // The result points into the mapping, not into the scratch buffer.
+  ASSERT_NE(scratch, result.cdata());
+  ASSERT_EQ(data.substr(4096 + 10, 50), result.ToString());
+
+  // The hints and prefetches of unaligned ranges, or ranges past the end, apply to the mapping.
+  file->Hint(RandomAccessFile::RANDOM);
+  file->Hint(RandomAccessFile::SEQUENTIAL);
+  ASSERT_OK(file->Prefetch(4096 + 10, 8192));
+  ASSERT_OK(file->Prefetch(data.size() + 10, 100));
+  ASSERT_OK(file->InvalidateCache(10, 4096));
+  ASSERT_OK(file->InvalidateCache(0, 0));
+  file->Hint(RandomAccessFile::NORMAL);
+
+  ASSERT_OK(file->Read(data.size() - 50, 50, &result, scratch));
+  ASSERT_EQ(data.substr(data.size() - 50), result.ToString());
+  file.reset();
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
+TEST_F(EnvPosixTest, DirectIO) {
+  EnvOptions soptions;
+  soptions.use_direct_reads = true;
+  soptions.use_direct_writes = true;
+  std::string fname = test::TmpDir() + "/" + "direct_io_testfile";
+
+  // Not a multiple of the direct I/O alignment, so the last page is padded and truncated.
+  Random rnd(301);
+  const std::string data = RandomString(&rnd, 3 * 4096 + 1234);
+  {
+    unique_ptr<WritableFile> wfile;
+    Status s = env_->NewWritableFile(fname, &wfile, soptions);
+    if (!s.ok()) {
+      // Some file systems, e.g. tmpfs, don't support O_DIRECT.
+      LOG(INFO) << "Skipping test, failed to open file with O_DIRECT: " << s.ToString();
+      return;
+    }
+    ASSERT_FALSE(wfile->UseOSBuffer());
+    WritableFileWriter writer(std::move(wfile), soptions);
+    for (size_t pos = 0; pos < data.size(); pos += 1000) {
+      ASSERT_OK(writer.Append(Slice(data.data() + pos, std::min<size_t>(1000, data.size() - pos))));
+    }
+    ASSERT_OK(writer.Flush());
+    ASSERT_OK(writer.Sync(false));
+    ASSERT_OK(writer.Close());
+  }
+
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  {
+    unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+    std::string scratch(data.size(), 0);
+    Slice result;
+    // Unaligned offsets and lengths, including reads crossing and past the end of the file.
+    for (auto range : std::vector<std::pair<uint64_t, size_t>>{
+             {0, data.size()}, {1, 10}, {4000, 200}, {5000, 9000}, {data.size() - 10, 100},
+             {data.size() + 10, 100}}) {
+      ASSERT_OK(file->Read(range.first, range.second, &result, &scratch[0]));
+      const size_t expected_size =
+          range.first >= data.size() ? 0 : std::min(range.second, data.size() - range.first);
+      ASSERT_EQ(expected_size, result.size());
+      ASSERT_EQ(data.substr(std::min<size_t>(range.first, data.size()), expected_size),
+                result.ToBuffer());
+    }
+  }
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // OS_LINUX
 
 class TestLogger : public Logger {
@@ -464,6 +464,8 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { file_->Hint(pattern); }
 
+  Status Prefetch(uint64_t offset, size_t n) override { return file_->Prefetch(offset, n); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return file_->InvalidateCache(offset, length);
   }
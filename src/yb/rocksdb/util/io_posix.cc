@@ -25,6 +25,7 @@
 
 #include "yb/rocksdb/util/io_posix.h"
 #include <errno.h>
+#include <algorithm>
 #include <fcntl.h>
 #if defined(OS_LINUX)
 #include <linux/fs.h>
@@ -42,6 +43,7 @@
 #endif
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/posix_logger.h"
@@ -155,7 +157,8 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const EnvOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
+    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer),
+      use_direct_io_(UseDirectIO(options.use_direct_reads)) {
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
 }
 
@@ -163,6 +166,9 @@ PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 
 Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
                                    char* scratch) const {
+  if (use_direct_io_) {
+    return ReadAligned(offset, n, result, scratch);
+  }
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -194,6 +200,46 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+// O_DIRECT requires the offset, the size and the buffer of a read to be aligned, so the pages
+// covering the requested range are read into an aligned buffer first.
+Status PosixRandomAccessFile::ReadAligned(uint64_t offset, size_t n, Slice* result,
+                                          char* scratch) const {
+  const size_t alignment = kDirectIOAlignment;
+  const uint64_t aligned_offset = TruncateToPageBoundary(alignment, static_cast<size_t>(offset));
+  const size_t offset_in_buffer = static_cast<size_t>(offset - aligned_offset);
+  AlignedBuffer buffer;
+  buffer.Alignment(alignment);
+  buffer.AllocateNewBuffer(offset_in_buffer + n);
+
+  ssize_t r = -1;
+  size_t left = buffer.Capacity();
+  char* ptr = buffer.Destination();
+  uint64_t read_offset = aligned_offset;
+  while (left > 0) {
+    r = pread(fd_, ptr, left, static_cast<off_t>(read_offset));
+    if (r <= 0) {
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    ptr += r;
+    read_offset += r;
+    left -= r;
+  }
+
+  if (r < 0) {
+    *result = Slice(scratch, 0);
+    return IOError(filename_, errno);
+  }
+  // The end of the file may be reached before the end of the last page.
+  const size_t read = buffer.Capacity() - left;
+  const size_t available = read > offset_in_buffer ? std::min(read - offset_in_buffer, n) : 0;
+  memcpy(scratch, buffer.BufferStart() + offset_in_buffer, available);
+  *result = Slice(scratch, available);
+  return Status::OK();
+}
+
 #ifdef OS_LINUX
 size_t PosixRandomAccessFile::GetUniqueId(char* id, size_t max_size) const {
   return GetUniqueIdFromFile(fd_, id, max_size);
@@ -223,6 +269,19 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
+#ifndef OS_LINUX
+  return Status::OK();
+#else
+  // Linux starts the readahead of the range and returns without waiting for it.
+  int ret = Fadvise(fd_, offset, n, POSIX_FADV_WILLNEED);
+  if (ret == 0) {
+    return Status::OK();
+  }
+  return IOError(filename_, errno);
+#endif
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
@@ -273,17 +332,53 @@ Status PosixMmapReadableFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+void PosixMmapReadableFile::Hint(AccessPattern pattern) {
+  switch (pattern) {
+    case NORMAL:
+      Madvise(0, length_, MADV_NORMAL);
+      break;
+    case RANDOM:
+      Madvise(0, length_, MADV_RANDOM);
+      break;
+    case SEQUENTIAL:
+      Madvise(0, length_, MADV_SEQUENTIAL);
+      break;
+    case WILLNEED:
+      Madvise(0, length_, MADV_WILLNEED);
+      break;
+    case DONTNEED:
+      Madvise(0, length_, MADV_DONTNEED);
+      break;
+    default:
+      assert(false);
+      break;
+  }
+}
+
+Status PosixMmapReadableFile::Prefetch(uint64_t offset, size_t n) {
+  // Starts the readahead of the range and returns without waiting for it.
+  return Madvise(offset, n, MADV_WILLNEED);
+}
+
 Status PosixMmapReadableFile::InvalidateCache(size_t offset, size_t length) {
-#ifndef OS_LINUX
-  return Status::OK();
-#else
-  // free OS pages
-  int ret = Fadvise(fd_, offset, length, POSIX_FADV_DONTNEED);
-  if (ret == 0) {
+  // Only drops the pages of this mapping, the page cache keeps them unless they are not mapped
+  // elsewhere.
+  return Madvise(offset, length, MADV_DONTNEED);
+}
+
+Status PosixMmapReadableFile::Madvise(size_t offset, size_t length, int advice) {
+  if (offset >= length_) {
     return Status::OK();
   }
-  return IOError(filename_, errno);
-#endif
+  length = std::min(length == 0 ? length_ : length, length_ - offset);
+  // The advised range has to start at a page boundary, the mapping itself does.
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t aligned_offset = offset / page_size * page_size;
+  length += offset - aligned_offset;
+  if (madvise(static_cast<char*>(mmapped_region_) + aligned_offset, length, advice) != 0) {
+    return IOError(filename_, errno);
+  }
+  return Status::OK();
 }
 
 /*
@@ -517,7 +612,8 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
                                      const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+    : filename_(fname), fd_(fd), filesize_(0),
+      use_direct_io_(UseDirectIO(options.use_direct_writes)) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +645,38 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  assert(use_direct_io_);
+  assert(offset % GetRequiredBufferAlignment() == 0);
+  const char* src = data.cdata();
+  size_t left = data.size();
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOError(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    offset += done;
+  }
+  filesize_ = std::max(filesize_, offset);
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!use_direct_io_) {
+    return Status::OK();
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+    return IOError(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
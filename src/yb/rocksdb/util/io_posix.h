@@ -43,6 +43,18 @@ static Status IOError(const std::string& context, int err_number) {
   return STATUS(IOError, context, strerror(err_number));
 }
 
+// Alignment of the offsets, sizes and buffers of direct I/O.
+constexpr size_t kDirectIOAlignment = 4 * 1024;
+
+// Files are only opened with O_DIRECT on Linux, other platforms use buffered I/O instead.
+inline bool UseDirectIO(bool requested) {
+#ifdef OS_LINUX
+  return requested;
+#else
+  return false;
+#endif
+}
+
 class PosixSequentialFile : public SequentialFile {
  private:
   std::string filename_;
@@ -65,6 +77,10 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  // The file was opened with O_DIRECT, so reads must be aligned.
+  bool use_direct_io_;
+
+  Status ReadAligned(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -77,6 +93,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual Status Prefetch(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -85,6 +102,9 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // The file was opened with O_DIRECT. WritableFileWriter then writes whole aligned pages with
+  // PositionedAppend. Sync is still needed, O_DIRECT does not make writes durable by itself.
+  const bool use_direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -95,11 +115,13 @@ class PosixWritableFile : public WritableFile {
                     const EnvOptions& options);
   ~PosixWritableFile();
 
-  // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  // Buffered writes leave Close() to trim the preallocated space. Direct writes are padded to
+  // whole pages, so the file is trimmed to the data size here.
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
   virtual Status Append(const Slice& data) override;
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
@@ -126,7 +148,13 @@ class PosixMmapReadableFile : public RandomAccessFile {
   virtual ~PosixMmapReadableFile();
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const override;
+  // The file descriptor is closed once the file is mapped, so the hints go to the mapping.
+  virtual void Hint(AccessPattern pattern) override;
+  virtual Status Prefetch(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
+
+ private:
+  Status Madvise(size_t offset, size_t length, int advice);
 };
 
 class PosixMmapFile : public WritableFile {
@@ -66,6 +66,7 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       compaction_filter_factory(options.compaction_filter_factory.get()),
       inplace_update_support(options.inplace_update_support),
       inplace_callback(options.inplace_callback),
+      memtable_numa_node(options.memtable_numa_node),
       info_log(options.info_log.get()),
       statistics(options.statistics.get()),
       env(options.env),
@@ -139,6 +140,7 @@ ColumnFamilyOptions::ColumnFamilyOptions()
           std::shared_ptr<TableFactory>(new BlockBasedTableFactory())),
       inplace_update_support(false),
       inplace_update_num_locks(10000),
+      memtable_numa_node(-1),
       inplace_callback(nullptr),
       memtable_prefix_bloom_bits(0),
       memtable_prefix_bloom_probes(6),
@@ -207,6 +209,7 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
           options.table_properties_collector_factories),
       inplace_update_support(options.inplace_update_support),
       inplace_update_num_locks(options.inplace_update_num_locks),
+      memtable_numa_node(options.memtable_numa_node),
       inplace_callback(options.inplace_callback),
       memtable_prefix_bloom_bits(options.memtable_prefix_bloom_bits),
       memtable_prefix_bloom_probes(options.memtable_prefix_bloom_probes),
@@ -267,6 +270,8 @@ DBOptions::DBOptions()
       allow_mmap_reads(false),
       allow_mmap_writes(false),
       allow_fallocate(true),
+      use_direct_reads(false),
+      use_direct_io_for_flush_and_compaction(false),
       is_fd_close_on_exec(true),
       skip_log_error_on_recovery(false),
       stats_dump_period_sec(600),
@@ -358,6 +363,10 @@ void DBOptions::Dump(Logger* log) const {
       allow_mmap_reads);
   RHEADER(log, "                       Options.allow_mmap_writes: %d",
       allow_mmap_writes);
+  RHEADER(log, "                        Options.use_direct_reads: %d",
+      use_direct_reads);
+  RHEADER(log, "  Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(log, "                     Options.is_fd_close_on_exec: %d",
       is_fd_close_on_exec);
   RHEADER(log, "                   Options.stats_dump_period_sec: %u",
@@ -458,6 +467,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -536,6 +547,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "                Options.inplace_update_num_locks: %" ROCKSDB_PRIszt,
          inplace_update_num_locks);
+  RHEADER(log, "                      Options.memtable_numa_node: %d",
+      memtable_numa_node);
   RHEADER(log, "              Options.min_partial_merge_operands: %u",
       min_partial_merge_operands);
     // TODO: easier config for bloom (maybe based on avg key/value size)
@@ -188,6 +188,12 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"allow_os_buffer",
      {offsetof(struct DBOptions, allow_os_buffer), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
+    {"use_direct_reads",
+     {offsetof(struct DBOptions, use_direct_reads), OptionType::kBoolean,
+      OptionVerificationType::kNormal}},
+    {"use_direct_io_for_flush_and_compaction",
+     {offsetof(struct DBOptions, use_direct_io_for_flush_and_compaction), OptionType::kBoolean,
+      OptionVerificationType::kNormal}},
     {"create_if_missing",
      {offsetof(struct DBOptions, create_if_missing), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
@@ -372,6 +378,9 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
     {"inplace_update_support",
      {offsetof(struct ColumnFamilyOptions, inplace_update_support),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"memtable_numa_node",
+     {offsetof(struct ColumnFamilyOptions, memtable_numa_node),
+      OptionType::kInt, OptionVerificationType::kNormal}},
     {"level_compaction_dynamic_level_bytes",
      {offsetof(struct ColumnFamilyOptions,
                level_compaction_dynamic_level_bytes),
@@ -522,6 +531,12 @@ static std::unordered_map<std::string,
     {"cache_index_and_filter_blocks",
      {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"pin_top_level_index",
+     {offsetof(struct BlockBasedTableOptions, pin_top_level_index),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"cache_index_and_filter_blocks_with_high_priority",
+     {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks_with_high_priority),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"index_type",
      {offsetof(struct BlockBasedTableOptions, index_type),
       OptionType::kBlockBasedTableIndexType, OptionVerificationType::kNormal}},
@@ -1684,6 +1684,8 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "stats_dump_period_sec=70127;"
       "allow_fallocate=true;"
       "allow_mmap_reads=true;"
+      "use_direct_reads=false;"
+      "use_direct_io_for_flush_and_compaction=false;"
       "max_log_file_size=4607;"
       "random_access_max_buffer_size=1048576;"
       "advise_random_on_open=true;"
@@ -1753,6 +1755,7 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
       "optimize_filters_for_hits=false;"
       "level_compaction_dynamic_level_bytes=false;"
       "inplace_update_support=false;"
+      "memtable_numa_node=1;"
       "compaction_style=kCompactionStyleFIFO;"
       "memtable_prefix_bloom_probes=2511;"
       "purge_redundant_kvs_while_flush=true;"
@@ -99,9 +99,24 @@ void ThreadPool::BGThread(size_t thread_id) {
       PthreadCall("unlock", pthread_mutex_unlock(&mu_));
       break;
     }
-    void (*function)(void*) = queue_.front().function;
-    void* arg = queue_.front().arg;
-    queue_.pop_front();
+    auto item = queue_.begin();
+    if (num_prioritized_items_ != 0) {
+      // Priorities change while the items wait, so they are compared when an item is picked.
+      int best_priority = item->GetPriority();
+      for (auto it = std::next(item); it != queue_.end(); ++it) {
+        int priority = it->GetPriority();
+        if (priority > best_priority) {
+          best_priority = priority;
+          item = it;
+        }
+      }
+      if (item->priority) {
+        --num_prioritized_items_;
+      }
+    }
+    void (*function)(void*) = item->function;
+    void* arg = item->arg;
+    queue_.erase(item);
     queue_len_.store(static_cast<unsigned int>(queue_.size()),
                      std::memory_order_relaxed);
 
@@ -212,7 +227,7 @@ void ThreadPool::StartBGThreads() {
 }
 
 void ThreadPool::Schedule(void (*function)(void* arg1), void* arg, void* tag,
-                          void (*unschedFunction)(void* arg)) {
+                          void (*unschedFunction)(void* arg), int (*priority)(void* tag)) {
   PthreadCall("lock", pthread_mutex_lock(&mu_));
 
   if (exit_all_threads_) {
@@ -228,6 +243,10 @@ void ThreadPool::Schedule(void (*function)(void* arg1), void* arg, void* tag,
   queue_.back().arg = arg;
   queue_.back().tag = tag;
   queue_.back().unschedFunction = unschedFunction;
+  queue_.back().priority = priority;
+  if (priority) {
+    ++num_prioritized_items_;
+  }
   queue_len_.store(static_cast<unsigned int>(queue_.size()),
                    std::memory_order_relaxed);
 
@@ -256,6 +275,9 @@ int ThreadPool::UnSchedule(void* arg) {
       if (unschedFunction != nullptr) {
         (*unschedFunction)(arg1);
       }
+      if (it->priority) {
+        --num_prioritized_items_;
+      }
       it = queue_.erase(it);
       count++;
     } else {
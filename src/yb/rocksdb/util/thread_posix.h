@@ -38,8 +38,9 @@ class ThreadPool {
   void IncBackgroundThreadsIfNeeded(int num);
   void SetBackgroundThreads(int num);
   void StartBGThreads();
+  // When 'priority' is set, the item runs ahead of the queued items with a lower priority(tag).
   void Schedule(void (*function)(void* arg1), void* arg, void* tag,
-                void (*unschedFunction)(void* arg));
+                void (*unschedFunction)(void* arg), int (*priority)(void* tag) = nullptr);
   int UnSchedule(void* arg);
 
   unsigned int GetQueueLen() const {
@@ -82,6 +83,11 @@ class ThreadPool {
     void (*function)(void*);
     void* tag;
     void (*unschedFunction)(void*);
+    int (*priority)(void*);
+
+    int GetPriority() const {
+      return priority ? priority(tag) : 0;
+    }
   };
   typedef std::deque<BGItem> BGQueue;
 
@@ -91,6 +97,8 @@ class ThreadPool {
   std::vector<pthread_t> bgthreads_;
   BGQueue queue_;
   std::atomic_uint queue_len_;  // Queue length. Used for stats reporting
+  // Number of queued items scheduled with a priority function.
+  size_t num_prioritized_items_ = 0;
   bool exit_all_threads_;
   bool low_io_priority_;
   Env::Priority priority_;
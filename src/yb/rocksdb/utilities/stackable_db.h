@@ -265,6 +265,10 @@ class StackableDB : public DB {
     db_->GetLiveFilesMetaData(metadata);
   }
 
+  yb::Result<std::string> GetMiddleKey() override {
+    return db_->GetMiddleKey();
+  }
+
   UserFrontierPtr GetFlushedFrontier() override {
     return db_->GetFlushedFrontier();
   }
@@ -63,6 +63,10 @@ METRIC_DEFINE_histogram(
     yb::MetricUnit::kMicroseconds, "Microseconds spent to queue and write the response to the wire",
     60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    server, rpc_frames_per_write, "Frames per socket write", yb::MetricUnit::kRequests,
+    "Number of calls or responses whose transfer completed with a single socket write", 1024, 2);
+
 namespace yb {
 namespace rpc {
 
@@ -79,11 +83,13 @@ Connection::Connection(Reactor* reactor,
       remote_(remote),
       direction_(direction),
       last_activity_time_(CoarseMonoClock::Now()),
-      read_buffer_(FLAGS_rpc_initial_buffer_size, context->BufferLimit()),
+      read_buffer_(reactor->read_buffer_allocator(), context->BufferLimit()),
       context_(std::move(context)) {
   const auto metric_entity = reactor->messenger()->metric_entity();
   handler_latency_outbound_transfer_ = metric_entity ?
       METRIC_handler_latency_outbound_transfer.Instantiate(metric_entity) : nullptr;
+  frames_per_write_ = metric_entity ?
+      METRIC_rpc_frames_per_write.Instantiate(metric_entity) : nullptr;
 }
 
 Connection::~Connection() {
@@ -284,6 +290,8 @@ void Connection::Handler(ev::io& watcher, int revents) {  // NOLINT
 
   if (status.ok() && (revents & EV_READ)) {
     status = ReadHandler();
+    // Connections that have no partially received calls do not hold memory for reading.
+    read_buffer_.ReleaseIfEmpty();
   }
 
   if (status.ok() && (revents & EV_WRITE)) {
@@ -312,7 +320,8 @@ Status Connection::ReadHandler() {
   last_activity_time_ = reactor_->cur_time();
 
   for (;;) {
-    auto received = Receive();
+    bool drained = false;
+    auto received = Receive(&drained);
     if (PREDICT_FALSE(!received.ok())) {
       if (received.status().error_code() == ESHUTDOWN) {
         VLOG(1) << ToString() << " shut down by remote end.";
@@ -331,13 +340,15 @@ Status Connection::ReadHandler() {
     if (!continue_receiving.ok()) {
       return continue_receiving.status();
     }
-    if (!continue_receiving.get()) {
+    // The watcher is level triggered, so there is no need to spend a syscall just to find out
+    // that the socket is empty. If more data arrives, we will be notified again.
+    if (!continue_receiving.get() || drained) {
       return Status::OK();
     }
   }
 }
 
-Result<bool> Connection::Receive() {
+Result<bool> Connection::Receive(bool* drained) {
   RETURN_NOT_OK(read_buffer_.PrepareRead());
 
   size_t max_receive = context_->MaxReceive(Slice(read_buffer_.begin(), read_buffer_.size()));
@@ -363,6 +374,7 @@ Result<bool> Connection::Receive() {
   }
 
   read_buffer_.DataAppended(nread);
+  *drained = nread < remaining_buf_capacity;
   return nread != 0;
 }
 
@@ -428,7 +440,9 @@ Status Connection::DoWrite() {
     return Status::OK();
   }
   while (!sending_.empty()) {
-    const size_t kMaxIov = 16;
+    // Responses to many calls are usually queued at once, so write as many of them as possible
+    // with a single syscall.
+    const size_t kMaxIov = 64;
     iovec iov[kMaxIov];
     const int iov_len = static_cast<int>(std::min(kMaxIov, sending_.size()));
     size_t offset = send_position_;
@@ -454,6 +468,7 @@ Status Connection::DoWrite() {
     }
 
     send_position_ += written;
+    size_t frames = 0;
     while (!sending_.empty() && send_position_ >= sending_.front().size()) {
       auto call = sending_outbound_datas_.front();
       send_position_ -= sending_.front().size();
@@ -461,8 +476,12 @@ Status Connection::DoWrite() {
       sending_outbound_datas_.pop_front();
       if (call) {
         call->Transferred(Status::OK(), this);
+        ++frames;
       }
     }
+    if (frames_per_write_ && frames != 0) {
+      frames_per_write_->Increment(frames);
+    }
   }
 
   return Status::OK();
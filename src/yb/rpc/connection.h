@@ -197,7 +197,10 @@ class Connection final : public std::enable_shared_from_this<Connection> {
 
   void ClearSending(const Status& status);
 
-  Result<bool> Receive();
+  // Receives data into read_buffer_, returns whether anything was received.
+  // `drained` is set when the socket had less data than we asked for, so the next receive would
+  // most likely fail with EAGAIN.
+  Result<bool> Receive(bool* drained);
 
   // Try to parse received data into calls and process them.
   Result<bool> TryProcessCalls();
@@ -243,6 +246,8 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   // it involves spin lock and search in a metrics map. Therefore we prepare metric instances
   // at connection level.
   scoped_refptr<Histogram> handler_latency_outbound_transfer_;
+  // Number of calls or responses completed by each socket write.
+  scoped_refptr<Histogram> frames_per_write_;
 
   struct CompareExpiration {
     template<class Pair>
@@ -17,19 +17,24 @@
 
 #include "yb/rpc/growable_buffer.h"
 
+#include "yb/util/mem_tracker.h"
 #include "yb/util/test_util.h"
 
 namespace yb {
 namespace rpc {
 
-class GrowableBufferTest : public YBTest {
-};
-
 const size_t kInitialSize = 0x100;
 const size_t kSizeLimit = 0x1000;
 
+class GrowableBufferTest : public YBTest {
+ protected:
+  std::shared_ptr<MemTracker> mem_tracker_ = MemTracker::CreateTracker(-1, "growable_buffer");
+  std::shared_ptr<GrowableBufferAllocator> allocator_ =
+      std::make_shared<GrowableBufferAllocator>(kInitialSize, mem_tracker_);
+};
+
 TEST_F(GrowableBufferTest, TestLimit) {
-  GrowableBuffer buffer(kInitialSize, kSizeLimit);
+  GrowableBuffer buffer(allocator_, kSizeLimit);
 
   ASSERT_EQ(buffer.capacity_left(), kInitialSize);
   unsigned int seed = SeedRandom();
@@ -44,7 +49,7 @@ TEST_F(GrowableBufferTest, TestLimit) {
 }
 
 TEST_F(GrowableBufferTest, TestPrepareRead) {
-  GrowableBuffer buffer(kInitialSize, kSizeLimit);
+  GrowableBuffer buffer(allocator_, kSizeLimit);
 
   unsigned int seed = SeedRandom();
 
@@ -59,7 +64,7 @@ TEST_F(GrowableBufferTest, TestPrepareRead) {
 }
 
 TEST_F(GrowableBufferTest, TestConsume) {
-  GrowableBuffer buffer(kInitialSize, kSizeLimit);
+  GrowableBuffer buffer(allocator_, kSizeLimit);
 
   int counter = 0;
 
@@ -83,5 +88,35 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestReleaseIfEmpty) {
+  const int64_t kBlockSize = kInitialSize;
+  {
+    GrowableBuffer buffer(allocator_, kSizeLimit);
+    ASSERT_EQ(kBlockSize, mem_tracker_->consumption());
+
+    ASSERT_OK(buffer.EnsureFreeSpace(kInitialSize * 2));
+    // The initial block is pooled after the buffer has grown.
+    ASSERT_EQ(kBlockSize * 3, mem_tracker_->consumption());
+    buffer.DataAppended(1);
+    // Buffers with data are not released.
+    buffer.ReleaseIfEmpty();
+    ASSERT_EQ(kBlockSize * 3, mem_tracker_->consumption());
+
+    buffer.Consume(1);
+    buffer.ReleaseIfEmpty();
+    ASSERT_EQ(0, buffer.capacity_left());
+    ASSERT_EQ(kBlockSize, mem_tracker_->consumption());
+
+    // The pooled block is reused.
+    ASSERT_OK(buffer.PrepareRead());
+    ASSERT_EQ(kInitialSize, buffer.capacity_left());
+    ASSERT_EQ(kBlockSize, mem_tracker_->consumption());
+  }
+  // The block of the destroyed buffer stays in the pool.
+  ASSERT_EQ(kBlockSize, mem_tracker_->consumption());
+  allocator_.reset();
+  ASSERT_EQ(0, mem_tracker_->consumption());
+}
+
 } // namespace rpc
 } // namespace yb
@@ -15,7 +15,9 @@
 
 #include "yb/rpc/growable_buffer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 
 #include "yb/gutil/strings/substitute.h"
 
@@ -24,13 +26,82 @@ using strings::Substitute;
 namespace yb {
 namespace rpc {
 
-GrowableBuffer::GrowableBuffer(size_t initial, size_t limit)
-    : buffer_(static_cast<uint8_t*>(malloc(initial))),
+namespace {
+
+// Freed blocks above this number are returned to malloc.
+constexpr size_t kMaxFreeBlocks = 1024;
+
+} // namespace
+
+GrowableBufferAllocator::GrowableBufferAllocator(
+    size_t block_size, const std::shared_ptr<MemTracker>& mem_tracker)
+    : block_size_(block_size),
+      mem_tracker_(mem_tracker) {
+  DCHECK_GT(block_size, 0);
+}
+
+GrowableBufferAllocator::~GrowableBufferAllocator() {
+  for (auto* block : free_blocks_) {
+    free(block);
+  }
+  if (mem_tracker_) {
+    mem_tracker_->Release(free_blocks_.size() * block_size_);
+  }
+}
+
+uint8_t* GrowableBufferAllocator::Allocate(size_t size) {
+  if (size == block_size_) {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (!free_blocks_.empty()) {
+      auto* result = free_blocks_.back();
+      free_blocks_.pop_back();
+      return result;
+    }
+  }
+  auto* result = static_cast<uint8_t*>(malloc(size));
+  if (result && mem_tracker_) {
+    mem_tracker_->Consume(size);
+  }
+  return result;
+}
+
+void GrowableBufferAllocator::Free(uint8_t* buffer, size_t size) {
+  if (!buffer) {
+    return;
+  }
+  if (size == block_size_) {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (free_blocks_.size() < kMaxFreeBlocks) {
+      free_blocks_.push_back(buffer);
+      return;
+    }
+  }
+  free(buffer);
+  if (mem_tracker_) {
+    mem_tracker_->Release(size);
+  }
+}
+
+GrowableBuffer::GrowableBuffer(std::shared_ptr<GrowableBufferAllocator> allocator, size_t limit)
+    : allocator_(std::move(allocator)),
+      buffer_(allocator_->Allocate(allocator_->block_size())),
       limit_(limit),
-      capacity_(initial),
+      capacity_(buffer_ ? allocator_->block_size() : 0),
       size_(0) {
 }
 
+GrowableBuffer::~GrowableBuffer() {
+  allocator_->Free(buffer_, capacity_);
+}
+
+void GrowableBuffer::ReleaseIfEmpty() {
+  if (size_ == 0 && buffer_) {
+    allocator_->Free(buffer_, capacity_);
+    buffer_ = nullptr;
+    capacity_ = 0;
+  }
+}
+
 void GrowableBuffer::DumpTo(std::ostream& out) const {
   out << "size: " << size_ << ", capacity: " << capacity_ << ", limit: " << limit_;
 }
@@ -42,7 +113,7 @@ void GrowableBuffer::Consume(size_t count) {
   if (count) {
     size_t left = size_ - count;
     if (left) {
-      memmove(buffer_.get(), buffer_.get() + count, left);
+      memmove(buffer_, buffer_ + count, left);
     }
     size_ = left;
   }
@@ -50,8 +121,9 @@ void GrowableBuffer::Consume(size_t count) {
 
 void GrowableBuffer::Swap(GrowableBuffer* rhs) {
   DCHECK_EQ(limit_, rhs->limit_);
+  DCHECK_EQ(allocator_, rhs->allocator_);
 
-  buffer_.swap(rhs->buffer_);
+  std::swap(buffer_, rhs->buffer_);
   std::swap(capacity_, rhs->capacity_);
   std::swap(size_, rhs->size_);
 }
@@ -59,19 +131,26 @@ void GrowableBuffer::Swap(GrowableBuffer* rhs) {
 Status GrowableBuffer::Reshape(size_t new_capacity) {
   DCHECK_LE(new_capacity, limit_);
   if (new_capacity != capacity_) {
-    auto new_buffer = static_cast<uint8_t *>(realloc(buffer_.get(), new_capacity));
+    // Blocks could be pooled by the allocator, so we could not just realloc them.
+    auto new_buffer = allocator_->Allocate(new_capacity);
     if (!new_buffer) {
       return STATUS(RuntimeError,
           Substitute("Failed to change buffer size from $0 to $1 bytes", capacity_, new_capacity));
     }
-    buffer_.release();
-    buffer_.reset(new_buffer);
+    if (size_) {
+      memcpy(new_buffer, buffer_, size_);
+    }
+    allocator_->Free(buffer_, capacity_);
+    buffer_ = new_buffer;
     capacity_ = new_capacity;
   }
   return Status::OK();
 }
 
 Status GrowableBuffer::PrepareRead() {
+  if (capacity_ == 0) {
+    return Reshape(std::min(limit_, allocator_->block_size()));
+  }
   if (size_ * 2 > capacity_) {
     const size_t new_capacity = std::min(limit_, capacity_ * 2);
     if (size_ == new_capacity) {
@@ -94,7 +173,7 @@ Status GrowableBuffer::EnsureFreeSpace(size_t len) {
             limit_));
   }
   if (expected > capacity_) {
-    size_t new_capacity = capacity_ * 2;
+    size_t new_capacity = std::max(capacity_ * 2, allocator_->block_size());
     while (new_capacity < expected) {
       new_capacity *= 2;
     }
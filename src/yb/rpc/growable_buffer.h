@@ -17,9 +17,13 @@
 
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/gutil/macros.h"
 
+#include "yb/util/locks.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/status.h"
 
 #include "yb/util/net/socket.h"
@@ -27,26 +31,63 @@
 namespace yb {
 namespace rpc {
 
+// Allocates memory for growable buffers. Blocks of block_size bytes, that every buffer starts
+// with, are kept in a pool when freed, so buffers of idle connections could release their memory
+// and get it back cheaply when data arrives. Larger allocations are served by malloc.
+// All allocated and pooled memory is consumed from the mem tracker, if specified.
+class GrowableBufferAllocator {
+ public:
+  GrowableBufferAllocator(size_t block_size, const std::shared_ptr<MemTracker>& mem_tracker);
+
+  ~GrowableBufferAllocator();
+
+  size_t block_size() const { return block_size_; }
+
+  // Returns nullptr if memory could not be allocated.
+  uint8_t* Allocate(size_t size);
+
+  // `size` should be equal to the size passed to the Allocate call that returned `buffer`.
+  void Free(uint8_t* buffer, size_t size);
+
+ private:
+  const size_t block_size_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+
+  simple_spinlock mutex_;
+  std::vector<uint8_t*> free_blocks_;
+
+  DISALLOW_COPY_AND_ASSIGN(GrowableBufferAllocator);
+};
+
 // Convenience buffer for receiving bytes.
 // Major features:
 //   Limit allocated bytes.
 //   Resize depending on used size.
 //   Consume read data.
+//   Release memory when empty.
 class GrowableBuffer {
  public:
-  explicit GrowableBuffer(size_t initial, size_t limit);
+  // The buffer starts with a block of the allocator.
+  GrowableBuffer(std::shared_ptr<GrowableBufferAllocator> allocator, size_t limit);
+
+  ~GrowableBuffer();
 
   inline bool empty() const { return size_ == 0; }
   inline size_t size() const { return size_; }
-  inline const uint8_t* begin() const { return buffer_.get(); }
-  inline const uint8_t* end() const { return buffer_.get() + size_; }
+  inline const uint8_t* begin() const { return buffer_; }
+  inline const uint8_t* end() const { return buffer_ + size_; }
   inline size_t capacity_left() const { return capacity_ - size_; }
-  inline uint8_t* write_position() { return buffer_.get() + size_; }
+  inline uint8_t* write_position() { return buffer_ + size_; }
   inline size_t limit() const { return limit_; }
 
   void Swap(GrowableBuffer* rhs);
   // Reset buffer size to zero. Like with std::vector Clean does not deallocate any memory.
   void Clear() { size_ = 0; }
+
+  // Returns the memory of an empty buffer to the allocator. Memory is allocated again by the
+  // next PrepareRead or EnsureFreeSpace.
+  void ReleaseIfEmpty();
+
   void DumpTo(std::ostream& out) const;
 
   // Removes first `count` bytes from buffer, moves remaining bytes to the beginning of the buffer.
@@ -79,8 +120,11 @@ class GrowableBuffer {
  private:
   CHECKED_STATUS Reshape(size_t new_capacity);
 
-  // Contained data
-  std::unique_ptr<uint8_t, FreeDeleter> buffer_;
+  // Connections could outlive their reactor, so the buffer shares ownership of the allocator.
+  const std::shared_ptr<GrowableBufferAllocator> allocator_;
+
+  // Contained data, allocated by allocator_. Null while the capacity is zero.
+  uint8_t* buffer_ = nullptr;
 
   // Max capacity for this buffer
   const size_t limit_;
@@ -90,6 +134,8 @@ class GrowableBuffer {
 
   // Currently used bytes
   size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(GrowableBuffer);
 };
 
 std::ostream& operator<<(std::ostream& out, const GrowableBuffer& receiver);
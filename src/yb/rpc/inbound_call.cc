@@ -83,6 +83,7 @@ InboundCall::InboundCall(ConnectionPtr conn, CallProcessedListener call_processe
     : trace_(new Trace),
       conn_(std::move(conn)),
       call_processed_listener_(std::move(call_processed_listener)) {
+  trace_->MaybeSample();
   TRACE_TO(trace_, "Created InboundCall");
   RecordCallReceived();
 }
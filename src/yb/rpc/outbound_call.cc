@@ -38,6 +38,7 @@
 #include <boost/functional/hash.hpp>
 
 #include <gflags/gflags.h>
+#include <snappy.h>
 
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
@@ -228,33 +229,15 @@ void OutboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
 }
 
 Status OutboundCall::SetRequestParam(const Message& message) {
-  using serialization::SerializeHeader;
-  using serialization::SerializeMessage;
-
-  size_t message_size = 0;
-  auto status = SerializeMessage(message,
-                                 /* param_buf */ nullptr,
-                                 /* additional_size */ 0,
-                                 /* use_cached_size */ false,
-                                 /* offset */ 0,
-                                 &message_size);
-  if (!status.ok()) {
-    return status;
-  }
-  size_t header_size = 0;
+  using serialization::SerializeHeaderAndMessage;
 
+  const size_t message_size = message.ByteSize();
   RequestHeader header;
   InitHeader(&header);
-  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
+  auto status = SerializeHeaderAndMessage(
+      header, message, message_size, /* additional_size */ 0, &buffer_);
   remote_method_pool_->Release(header.release_remote_method());
-  if (!status.ok()) {
-    return status;
-  }
-  return SerializeMessage(message,
-                          &buffer_,
-                          /* additional_size */ 0,
-                          /* use_cached_size */ true,
-                          header_size);
+  return status;
 }
 
 Status OutboundCall::status() const {
@@ -488,7 +471,11 @@ void OutboundCall::InitHeader(RequestHeader* header) {
   if (timeout.Initialized()) {
     header->set_timeout_millis(timeout.ToMilliseconds());
   }
+  header->set_accepts_compressed_response(true);
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  if (trace_->sampled()) {
+    header->set_trace_id(trace_->trace_id());
+  }
 }
 
 ///
@@ -547,6 +534,25 @@ Status CallResponse::GetSidecar(int idx, Slice* sidecar) const {
   return Status::OK();
 }
 
+Status CallResponse::Decompress(Slice* entire_message) {
+  size_t uncompressed_size = 0;
+  if (!snappy::GetUncompressedLength(
+          entire_message->cdata(), entire_message->size(), &uncompressed_size) ||
+      uncompressed_size != header_.uncompressed_size()) {
+    return STATUS_FORMAT(Corruption, "Invalid compressed response, expected $0 bytes",
+                         header_.uncompressed_size());
+  }
+  std::vector<uint8_t> uncompressed(uncompressed_size);
+  if (!snappy::RawUncompress(entire_message->cdata(), entire_message->size(),
+                             reinterpret_cast<char*>(uncompressed.data()))) {
+    return STATUS(Corruption, "Failed to decompress response");
+  }
+  // The header is already parsed, so the received data is not needed anymore.
+  response_data_.swap(uncompressed);
+  *entire_message = Slice(response_data_.data(), response_data_.size());
+  return Status::OK();
+}
+
 Status CallResponse::ParseFrom(Slice source) {
   CHECK(!parsed_);
   Slice entire_message;
@@ -555,6 +561,10 @@ Status CallResponse::ParseFrom(Slice source) {
   source = Slice(response_data_.data(), response_data_.size());
   RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
 
+  if (header_.has_uncompressed_size()) {
+    RETURN_NOT_OK(Decompress(&entire_message));
+  }
+
   // Use information from header to extract the payload slices.
   const size_t sidecars = header_.sidecar_offsets_size();
 
@@ -158,6 +158,10 @@ class CallResponse {
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
  private:
+  // Replaces the received data with the decompressed main message, which 'entire_message' is
+  // updated to refer to.
+  CHECKED_STATUS Decompress(Slice* entire_message);
+
   // True once ParseFrom() is called.
   bool parsed_;
 
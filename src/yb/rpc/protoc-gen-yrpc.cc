@@ -470,7 +470,7 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         const MethodDescriptor *method = service->method(method_idx);
         subs->PushMethod(method);
         Print(printer, *subs,
-          "METRIC_DEFINE_histogram(server, handler_latency_$rpc_full_name_plainchars$,\n"
+          "METRIC_DEFINE_striped_histogram(server, handler_latency_$rpc_full_name_plainchars$,\n"
           "  \"$rpc_full_name$ RPC Time\",\n"
           "  yb::MetricUnit::kMicroseconds,\n"
           "  \"Microseconds spent handling $rpc_full_name$() RPC requests\",\n"
@@ -509,14 +509,15 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
 
         Print(printer, *subs,
         "  if (call->method_name() == \"$rpc_name$\") {\n"
+        "    std::shared_ptr<::google::protobuf::Arena> arena;\n"
         "    auto rpc_context = yb_call->IsLocalCall() ?\n"
         "        ::yb::rpc::RpcContext(\n"
         "            std::static_pointer_cast<::yb::rpc::LocalYBInboundCall>(yb_call), \n"
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::MakeSharedMessage<$request$>(&arena),\n"
+        "            ::yb::rpc::MakeSharedMessage<$response$>(&arena),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
@@ -60,6 +60,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
 #include "yb/util/thread.h"
@@ -72,8 +73,16 @@
 using std::string;
 using std::shared_ptr;
 
+DEFINE_int32(rpc_outbound_coalescing_window_us, 0,
+             "For how long outbound calls are collected in the reactor queue before being sent, "
+             "so that small calls to the same server are written to the socket together. "
+             "0 sends the queued calls as soon as the reactor picks them up.");
+TAG_FLAG(rpc_outbound_coalescing_window_us, advanced);
+TAG_FLAG(rpc_outbound_coalescing_window_us, runtime);
+
 DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
+DECLARE_uint64(rpc_initial_buffer_size);
 
 namespace yb {
 namespace rpc {
@@ -109,6 +118,10 @@ Reactor::Reactor(const shared_ptr<Messenger>& messenger,
                  const MessengerBuilder &bld)
   : messenger_(messenger),
     name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
+    read_buffer_allocator_(std::make_shared<GrowableBufferAllocator>(
+        FLAGS_rpc_initial_buffer_size,
+        MemTracker::FindOrCreateTracker(
+            -1, name_, MemTracker::FindOrCreateTracker(-1, "Read Buffer")))),
     loop_(kDefaultLibEvFlags),
     cur_time_(CoarseMonoClock::Now()),
     last_unused_tcp_scan_(cur_time_),
@@ -140,6 +153,9 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  outbound_queue_timer_.set(loop_);
+  outbound_queue_timer_.set<Reactor, &Reactor::OutboundQueueTimerHandler>(this);
+
   // Create Reactor thread.
   const std::string group_name = messenger_->name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -162,6 +178,7 @@ void Reactor::ShutdownInternal() {
   DCHECK(IsCurrentThread());
 
   stopping_ = true;
+  outbound_queue_timer_.stop();
 
   // Tear down any outbound TCP connections.
   Status service_unavailable = ShutdownError(false);
@@ -576,6 +593,23 @@ void Reactor::DestroyConnection(Connection *conn, const Status &conn_status) {
 }
 
 void Reactor::ProcessOutboundQueue() {
+  // Calls queued while the timer is active are picked up when it fires, since the queue is not
+  // empty and no new task is scheduled for them.
+  const auto window_us = FLAGS_rpc_outbound_coalescing_window_us;
+  if (window_us > 0 && !stopping_) {
+    outbound_queue_timer_.start(window_us * 1e-6, 0);
+    return;
+  }
+  FlushOutboundQueue();
+}
+
+void Reactor::OutboundQueueTimerHandler(ev::timer& watcher, int revents) {  // NOLINT
+  DCHECK(IsCurrentThread());
+
+  FlushOutboundQueue();
+}
+
+void Reactor::FlushOutboundQueue() {
   {
     std::lock_guard<simple_spinlock> lock(outbound_queue_lock_);
     outbound_queue_.swap(processing_outbound_queue_);
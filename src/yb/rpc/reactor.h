@@ -48,6 +48,7 @@
 
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/outbound_call.h"
 
 #include "yb/util/thread.h"
@@ -248,6 +249,11 @@ class Reactor {
 
   Messenger *messenger() const { return messenger_.get(); }
 
+  // Allocator for the read buffers of the connections of this reactor.
+  const std::shared_ptr<GrowableBufferAllocator>& read_buffer_allocator() const {
+    return read_buffer_allocator_;
+  }
+
   CoarseMonoClock::TimePoint cur_time() const { return cur_time_; }
 
   // Drop all connections with remote address. Used in tests with broken connectivity.
@@ -335,8 +341,15 @@ class Reactor {
   // etc. This is called from within the thread.
   void ShutdownInternal();
 
+  // Sends the queued outbound calls, after FLAGS_rpc_outbound_coalescing_window_us if it is set.
   void ProcessOutboundQueue();
 
+  void OutboundQueueTimerHandler(ev::timer& watcher, int revents); // NOLINT
+
+  // Assigns the queued outbound calls to their connections, and starts writing each connection
+  // once, after all its calls are queued.
+  void FlushOutboundQueue();
+
   void CheckReadyToStop();
 
   // If the Reactor is closing, returns false.
@@ -353,6 +366,8 @@ class Reactor {
 
   const std::string name_;
 
+  std::shared_ptr<GrowableBufferAllocator> read_buffer_allocator_;
+
   mutable simple_spinlock pending_tasks_lock_;
 
   // Whether the reactor is shutting down.
@@ -411,6 +426,8 @@ class Reactor {
   std::vector<OutboundCallPtr> processing_outbound_queue_;
   std::vector<ConnectionPtr> processing_connections_;
   std::shared_ptr<ReactorTask> process_outbound_queue_task_;
+  // Delays processing of the outbound queue when coalescing is enabled.
+  ev::timer outbound_queue_timer_;
 };
 
 }  // namespace rpc
@@ -51,6 +51,9 @@
 
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
+METRIC_DECLARE_histogram(rpc_frames_per_write);
+
+DECLARE_int32(rpc_outbound_coalescing_window_us);
 
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
@@ -526,6 +529,44 @@ TEST_F(TestRpc, TestRpcHandlerLatencyMetric) {
   YB_ASSERT_TRUE(FindOrDie(metric_map, &METRIC_rpc_incoming_queue_time));
 }
 
+// Test that calls queued within the coalescing window are sent with shared socket writes.
+TEST_F(TestRpc, TestOutboundCoalescing) {
+  FLAGS_rpc_outbound_coalescing_window_us = 10000;
+
+  Endpoint server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr, GenericCalculatorService::static_service_name());
+
+  constexpr size_t kCalls = 100;
+  std::vector<rpc_test::AddRequestPB> requests(kCalls);
+  std::vector<rpc_test::AddResponsePB> responses(kCalls);
+  std::vector<RpcController> controllers(kCalls);
+  CountDownLatch latch(kCalls);
+  for (size_t i = 0; i != kCalls; ++i) {
+    requests[i].set_x(i);
+    requests[i].set_y(1);
+    controllers[i].set_timeout(MonoDelta::FromMilliseconds(10000));
+    p.AsyncRequest(GenericCalculatorService::AddMethod(), requests[i], &responses[i],
+                   &controllers[i], [&latch]() { latch.CountDown(); });
+  }
+  latch.Wait();
+
+  for (size_t i = 0; i != kCalls; ++i) {
+    ASSERT_OK(controllers[i].status());
+    ASSERT_EQ(i + 1, responses[i].result());
+  }
+
+  const unordered_map<const MetricPrototype*, scoped_refptr<Metric> > metric_map =
+    metric_entity()->UnsafeMetricsMapForTests();
+  scoped_refptr<Histogram> frames_per_write = down_cast<Histogram *>(
+      FindOrDie(metric_map, &METRIC_rpc_frames_per_write).get());
+  LOG(INFO) << "Frames per write, mean: " << frames_per_write->MeanValueForTests()
+            << ", max: " << frames_per_write->MaxValueForTests();
+  ASSERT_GT(frames_per_write->MaxValueForTests(), 1);
+}
+
 TEST_F(TestRpc, TestRpcCallbackDestroysMessenger) {
   shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
   Endpoint bad_addr;
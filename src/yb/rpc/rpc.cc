@@ -76,7 +76,8 @@ bool RpcRetrier::HandleResponse(RpcCommand* rpc, Status* out_status) {
   return false;
 }
 
-Status RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
+Status RpcRetrier::DelayedRetry(
+    RpcCommand* rpc, const Status& why_status, MonoDelta add_delay) {
   if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
     last_error_ = why_status;
   }
@@ -84,7 +85,10 @@ Status RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
   //
   // If the delay causes us to miss our deadline, RetryCb will fail the
   // RPC on our behalf.
-  int num_ms = ++attempt_num_ + RandomUniformInt(0, 4);
+  MonoDelta delay = MonoDelta::FromMilliseconds(++attempt_num_ + RandomUniformInt(0, 4));
+  if (add_delay.Initialized()) {
+    delay += add_delay;
+  }
 
   RpcRetrierState expected_state = RpcRetrierState::kIdle;
   while (!state_.compare_exchange_strong(expected_state, RpcRetrierState::kWaiting)) {
@@ -100,7 +104,7 @@ Status RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
     }
   }
   task_id_ = messenger_->ScheduleOnReactor(
-      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), MonoDelta::FromMilliseconds(num_ms));
+      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), delay);
   return Status::OK();
 }
 
@@ -113,7 +113,10 @@ class RpcRetrier {
   // deadline has already expired at the time that Retry() was called.
   //
   // Callers should ensure that 'rpc' remains alive.
-  CHECKED_STATUS DelayedRetry(RpcCommand* rpc, const Status& why_status);
+  //
+  // 'add_delay' is added to the delay of the retry, e.g. the backoff requested by the server.
+  CHECKED_STATUS DelayedRetry(
+      RpcCommand* rpc, const Status& why_status, MonoDelta add_delay = MonoDelta::kZero);
 
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
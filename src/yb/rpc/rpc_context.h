@@ -32,7 +32,11 @@
 #ifndef YB_RPC_RPC_CONTEXT_H
 #define YB_RPC_RPC_CONTEXT_H
 
+#include <memory>
 #include <string>
+#include <type_traits>
+
+#include <google/protobuf/arena.h>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/rpc/local_call.h"
@@ -61,6 +65,27 @@ namespace rpc {
 
 class YBInboundCall;
 
+// Creates a message for an inbound call. When the message type supports arenas, i.e. it is
+// defined in a proto file with the cc_enable_arenas option, the message and all its sub-messages
+// are allocated on the shared arena, created on the first use. The returned pointer keeps the
+// arena alive, so all messages of a call are freed at once when the last of them is released.
+template <class T>
+typename std::enable_if<google::protobuf::Arena::is_arena_constructable<T>::value,
+                        std::shared_ptr<T>>::type
+MakeSharedMessage(std::shared_ptr<google::protobuf::Arena>* arena) {
+  if (!*arena) {
+    *arena = std::make_shared<google::protobuf::Arena>();
+  }
+  return std::shared_ptr<T>(*arena, google::protobuf::Arena::CreateMessage<T>(arena->get()));
+}
+
+template <class T>
+typename std::enable_if<!google::protobuf::Arena::is_arena_constructable<T>::value,
+                        std::shared_ptr<T>>::type
+MakeSharedMessage(std::shared_ptr<google::protobuf::Arena>* /* arena */) {
+  return std::make_shared<T>();
+}
+
 // The context provided to a generated ServiceIf. This provides
 // methods to respond to the RPC. In the future, this will also
 // include methods to access information about the caller: e.g
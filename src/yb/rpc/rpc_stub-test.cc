@@ -37,6 +37,7 @@
 
 #include <gtest/gtest.h>
 
+#include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/rtest.proxy.h"
@@ -55,6 +56,10 @@
 DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
+DECLARE_int32(rpc_compress_responses_min_bytes);
+
+METRIC_DECLARE_counter(rpc_response_uncompressed_bytes);
+METRIC_DECLARE_counter(rpc_response_compressed_bytes);
 
 using namespace std::chrono_literals;
 
@@ -232,6 +237,38 @@ TEST_F(RpcStubTest, TestBigCallData) {
   }
 }
 
+// Test that large responses are compressed when the compression is enabled.
+TEST_F(RpcStubTest, TestCompressedResponse) {
+  FLAGS_rpc_compress_responses_min_bytes = 1_KB;
+
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+
+  // Short responses are sent as is.
+  EchoRequestPB req;
+  req.set_data("hello");
+  EchoResponsePB resp;
+  RpcController controller;
+  ASSERT_OK(p.Echo(req, &resp, &controller));
+  ASSERT_EQ(req.data(), resp.data());
+
+  const auto metric_map = metric_entity()->UnsafeMetricsMapForTests();
+  auto uncompressed_bytes = down_cast<Counter*>(
+      FindOrDie(metric_map, &METRIC_rpc_response_uncompressed_bytes).get());
+  auto compressed_bytes = down_cast<Counter*>(
+      FindOrDie(metric_map, &METRIC_rpc_response_compressed_bytes).get());
+  ASSERT_EQ(0, uncompressed_bytes->value());
+
+  req.set_data(std::string(1_MB, 'x'));
+  controller.Reset();
+  ASSERT_OK(p.Echo(req, &resp, &controller));
+  ASSERT_EQ(req.data(), resp.data());
+
+  LOG(INFO) << "Compressed " << uncompressed_bytes->value() << " bytes to "
+            << compressed_bytes->value();
+  ASSERT_GT(uncompressed_bytes->value(), static_cast<int64_t>(1_MB));
+  ASSERT_LT(compressed_bytes->value(), uncompressed_bytes->value() / 10);
+}
+
 TEST_F(RpcStubTest, TestRespondDeferred) {
   CalculatorServiceProxy p(client_messenger_, server_endpoint_);
 
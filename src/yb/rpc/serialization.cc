@@ -54,46 +54,6 @@ namespace yb {
 namespace rpc {
 namespace serialization {
 
-Status SerializeMessage(const MessageLite& message,
-                        RefCntBuffer* param_buf,
-                        int additional_size,
-                        bool use_cached_size,
-                        size_t offset,
-                        size_t* size) {
-
-  if (PREDICT_FALSE(!message.IsInitialized())) {
-    return STATUS(InvalidArgument, "RPC argument missing required fields",
-        message.InitializationErrorString());
-  }
-  int pb_size = use_cached_size ? message.GetCachedSize() : message.ByteSize();
-  DCHECK_EQ(message.ByteSize(), pb_size);
-  int recorded_size = pb_size + additional_size;
-  int size_with_delim = pb_size + CodedOutputStream::VarintSize32(recorded_size);
-  int total_size = size_with_delim + additional_size;
-
-  if (total_size > FLAGS_rpc_max_message_size) {
-    LOG(DFATAL) << "Sending too long of an RPC message (" << total_size
-                << " bytes)";
-  }
-
-  if (size != nullptr) {
-    *size = offset + size_with_delim;
-  }
-  if (param_buf != nullptr) {
-    if (!*param_buf) {
-      *param_buf = RefCntBuffer(offset + size_with_delim);
-    } else {
-      CHECK_EQ(param_buf->size(), offset + size_with_delim) << "offset = " << offset;
-    }
-    uint8_t *dst = param_buf->udata() + offset;
-    dst = CodedOutputStream::WriteVarint32ToArray(recorded_size, dst);
-    dst = message.SerializeWithCachedSizesToArray(dst);
-    CHECK_EQ(dst, param_buf->udata() + param_buf->size());
-  }
-
-  return Status::OK();
-}
-
 Status SerializeHeader(const MessageLite& header,
                        size_t param_len,
                        RefCntBuffer* header_buf,
@@ -134,6 +94,46 @@ Status SerializeHeader(const MessageLite& header,
   return Status::OK();
 }
 
+Status SerializeHeaderAndMessage(const MessageLite& header,
+                                 const MessageLite& message,
+                                 size_t message_size,
+                                 size_t additional_size,
+                                 RefCntBuffer* buf) {
+  if (PREDICT_FALSE(!header.IsInitialized())) {
+    LOG(DFATAL) << "Uninitialized RPC header";
+    return STATUS(InvalidArgument, "RPC header missing required fields",
+                                  header.InitializationErrorString());
+  }
+  if (PREDICT_FALSE(!message.IsInitialized())) {
+    return STATUS(InvalidArgument, "RPC argument missing required fields",
+        message.InitializationErrorString());
+  }
+  DCHECK_EQ(message.GetCachedSize(), message_size);
+
+  const size_t header_pb_len = header.ByteSize();
+  const size_t recorded_size = message_size + additional_size;
+  const size_t buf_size = kMsgLengthPrefixLength
+      + CodedOutputStream::VarintSize32(header_pb_len) + header_pb_len
+      + CodedOutputStream::VarintSize32(recorded_size) + message_size;
+  const size_t total_size = buf_size + additional_size;
+  if (total_size > FLAGS_rpc_max_message_size) {
+    LOG(DFATAL) << "Sending too long of an RPC message (" << total_size << " bytes)";
+  }
+
+  *buf = RefCntBuffer(buf_size);
+  uint8_t* dst = buf->udata();
+  // The length of the whole frame, not including the 4-byte length prefix.
+  NetworkByteOrder::Store32(dst, total_size - kMsgLengthPrefixLength);
+  dst += sizeof(uint32_t);
+  dst = CodedOutputStream::WriteVarint32ToArray(header_pb_len, dst);
+  dst = header.SerializeWithCachedSizesToArray(dst);
+  dst = CodedOutputStream::WriteVarint32ToArray(recorded_size, dst);
+  dst = message.SerializeWithCachedSizesToArray(dst);
+  CHECK_EQ(dst, buf->udata() + buf_size);
+
+  return Status::OK();
+}
+
 Status ParseYBMessage(const Slice& buf,
                       MessageLite* parsed_header,
                       Slice* parsed_main_message) {
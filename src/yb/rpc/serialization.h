@@ -52,28 +52,6 @@ class Status;
 namespace rpc {
 namespace serialization {
 
-// Serialize the request param into a buffer which is allocated by this function.
-// Uses the message's cached size by calling MessageLite::GetCachedSize().
-// In : 'message' Protobuf Message to serialize
-//      'additional_size' Optional argument which increases the recorded size
-//        within param_buf. This argument is necessary if there will be
-//        additional sidecars appended onto the message (that aren't part of
-//        the protobuf itself).
-//      'use_cached_size' Additional optional argument whether to use the cached
-//        or explicit byte size by calling MessageLite::GetCachedSize() or
-//        MessageLite::ByteSize(), respectively.
-// Out: The faststring 'param_buf' to be populated with the serialized bytes.
-//        The faststring's length is only determined by the amount that
-//        needs to be serialized for the protobuf (i.e., no additional space
-//        is reserved for 'additional_size', which only affects the
-//        size indicator prefix in 'param_buf').
-Status SerializeMessage(const google::protobuf::MessageLite& message,
-                        RefCntBuffer* param_buf,
-                        int additional_size = 0,
-                        bool use_cached_size = false,
-                        size_t offset = 0,
-                        size_t* size = nullptr);
-
 // Serialize the request or response header into a buffer which is allocated
 // by this function.
 // Includes leading 32-bit length of the buffer.
@@ -86,6 +64,16 @@ Status SerializeHeader(const google::protobuf::MessageLite& header,
                        size_t reserve_for_param = 0,
                        size_t* header_size = nullptr);
 
+// Serializes the header and the message into a single buffer allocated by this function, in one
+// pass: the whole frame, except for the additional_size bytes of sidecars that follow the message.
+// 'message_size' should be the cached size of the message, i.e. the result of a ByteSize() call
+// made after the message was last modified, so that it is not computed again.
+Status SerializeHeaderAndMessage(const google::protobuf::MessageLite& header,
+                                 const google::protobuf::MessageLite& message,
+                                 size_t message_size,
+                                 size_t additional_size,
+                                 RefCntBuffer* buf);
+
 // Deserialize the request.
 // In: data buffer Slice.
 // Out: parsed_header PB initialized,
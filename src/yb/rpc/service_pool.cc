@@ -32,8 +32,12 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <glog/logging.h>
@@ -46,8 +50,11 @@
 #include "yb/rpc/service_if.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
+#include "yb/util/profiling_context.h"
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
 #include "yb/util/trace.h"
@@ -55,11 +62,12 @@
 using std::shared_ptr;
 using strings::Substitute;
 
-METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
-                        "RPC Queue Time",
-                        yb::MetricUnit::kMicroseconds,
-                        "Number of microseconds incoming RPC requests spend in the worker queue",
-                        60000000LU, 3);
+METRIC_DEFINE_striped_histogram(server, rpc_incoming_queue_time,
+                                "RPC Queue Time",
+                                yb::MetricUnit::kMicroseconds,
+                                "Number of microseconds incoming RPC requests spend in the worker "
+                                "queue",
+                                60000000LU, 3);
 
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
@@ -73,15 +81,22 @@ METRIC_DEFINE_counter(server, rpcs_queue_overflow,
                       "Number of RPCs dropped because the service queue "
                       "was full.");
 
+DEFINE_string(rpc_low_priority_methods, "FetchData,BeginRemoteBootstrapSession",
+              "Comma separated list of RPC methods, whose calls are handled only when there are "
+              "no other calls queued for the same service.");
+TAG_FLAG(rpc_low_priority_methods, advanced);
+
 namespace yb {
 namespace rpc {
 
 namespace {
 
+// Does not carry the call it was queued for. When a worker runs the task, it handles the most
+// urgent call queued to the service pool.
 class InboundCallTask final {
  public:
-  InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call)
-      : pool_(pool), call_(std::move(call)) {
+  explicit InboundCallTask(ServicePoolImpl* pool)
+      : pool_(pool) {
   }
 
   void Run();
@@ -89,7 +104,6 @@ class InboundCallTask final {
 
  private:
   ServicePoolImpl* pool_;
-  InboundCallPtr call_;
 };
 
 } // namespace
@@ -106,6 +120,10 @@ class ServicePoolImpl {
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
         tasks_pool_(max_tasks) {
+    for (const auto& method : strings::Split(
+             FLAGS_rpc_low_priority_methods, ",", strings::SkipEmpty())) {
+      low_priority_methods_.insert(method.ToString());
+    }
   }
 
   ~ServicePoolImpl() {
@@ -122,11 +140,42 @@ class ServicePoolImpl {
   void Enqueue(InboundCallPtr call) {
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
-    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
-      Overflow(call, "service", tasks_pool_.size());
+    // There is no point to queue a call that could not be completed in time.
+    if (PREDICT_FALSE(call->ClientTimedOut())) {
+      TimedOutInQueue(call);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued_calls_.insert(QueuedCall{
+          low_priority_methods_.count(call->method_name()) == 0, call->GetClientDeadline(),
+          next_sequence_no_++, std::move(call)});
+    }
+
+    // Every task handles one queued call, so when there are no free tasks, the least urgent call
+    // is rejected instead of the new one.
+    if (!tasks_pool_.Enqueue(thread_pool_, this)) {
+      auto rejected = PopCall(/* most_urgent */ false);
+      if (rejected) {
+        Overflow(rejected, "service", tasks_pool_.size());
+      }
     }
   }
 
+  // Returns the most or the least urgent of the queued calls.
+  InboundCallPtr PopCall(bool most_urgent) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queued_calls_.empty()) {
+      LOG(DFATAL) << "No calls queued to " << service_->service_name();
+      return nullptr;
+    }
+    auto it = most_urgent ? queued_calls_.begin() : std::prev(queued_calls_.end());
+    auto result = std::move(it->call);
+    queued_calls_.erase(it);
+    return result;
+  }
+
   const Counter* RpcsTimedOutInQueueMetricForTests() const {
     return rpcs_timed_out_in_queue_.get();
   }
@@ -169,20 +218,25 @@ class ServicePoolImpl {
     call->RespondFailure(ErrorStatusPB::FATAL_SERVER_SHUTTING_DOWN, response_status);
   }
 
+  void TimedOutInQueue(const InboundCallPtr& call) {
+    TRACE_TO(call->trace(), "Skipping call since client already timed out");
+    rpcs_timed_out_in_queue_->Increment();
+
+    // Respond as a failure, even though the client will probably ignore
+    // the response anyway.
+    call->RespondFailure(
+        ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
+        STATUS(TimedOut, "Call waited in the queue past client deadline"));
+  }
+
   void Handle(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
     ADOPT_TRACE(incoming->trace());
+    // The tablet is set by the service once it has looked it up.
+    ScopedProfilingContext profiling_context(incoming->method_name().c_str());
 
     if (PREDICT_FALSE(incoming->ClientTimedOut())) {
-      TRACE_TO(incoming->trace(), "Skipping call since client already timed out");
-      rpcs_timed_out_in_queue_->Increment();
-
-      // Respond as a failure, even though the client will probably ignore
-      // the response anyway.
-      incoming->RespondFailure(
-          ErrorStatusPB::ERROR_SERVER_TOO_BUSY,
-          STATUS(TimedOut, "Call waited in the queue past client deadline"));
-
+      TimedOutInQueue(incoming);
       return;
     }
 
@@ -198,17 +252,53 @@ class ServicePoolImpl {
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
 
+  // Calls of the normal priority go first, then calls with earlier deadline, then calls that were
+  // queued earlier.
+  struct QueuedCall {
+    bool high_priority;
+    MonoTime deadline;
+    uint64_t sequence_no;
+    // Moved out while the call is being removed from the queue.
+    mutable InboundCallPtr call;
+
+    bool operator<(const QueuedCall& rhs) const {
+      if (high_priority != rhs.high_priority) {
+        return high_priority;
+      }
+      if (!deadline.Equals(rhs.deadline)) {
+        return deadline.ComesBefore(rhs.deadline);
+      }
+      return sequence_no < rhs.sequence_no;
+    }
+  };
+
   std::atomic<bool> closing_ = {false};
+  std::unordered_set<std::string> low_priority_methods_;
+
+  std::mutex mutex_;
+  // Calls waiting for a worker, protected by mutex_.
+  std::set<QueuedCall> queued_calls_;
+  uint64_t next_sequence_no_ = 0;
+
   TasksPool<InboundCallTask> tasks_pool_;
 };
 
 void InboundCallTask::Run() {
-  pool_->Handle(call_);
+  auto call = pool_->PopCall(/* most_urgent */ true);
+  if (call) {
+    pool_->Handle(std::move(call));
+  }
 }
 
 void InboundCallTask::Done(const Status& status) {
-  InboundCallPtr call = call_;
-  pool_->Processed(call, status);
+  // If the task was not run, fail the least urgent call instead of the one the task was queued
+  // for.
+  if (!status.ok()) {
+    auto call = pool_->PopCall(/* most_urgent */ false);
+    if (call) {
+      pool_->Processed(call, status);
+    }
+  }
 }
 
 ServicePool::ServicePool(size_t max_tasks,
@@ -141,6 +141,36 @@ TEST_F(ThreadPoolTest, TestMultiProducers) {
   }
 }
 
+// Producers prefer different queues, so the single worker has to take tasks from all of them.
+TEST_F(ThreadPoolTest, TestMultiProducersSingleWorker) {
+  constexpr size_t kTotalTasks = 10000;
+  constexpr size_t kTotalWorkers = 1;
+  constexpr size_t kProducers = 4;
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers);
+
+  CountDownLatch latch(kTotalTasks);
+  std::vector<TestTask> tasks(kTotalTasks);
+  std::vector<std::thread> threads;
+  size_t begin = 0;
+  for (size_t i = 0; i != kProducers; ++i) {
+    size_t end = kTotalTasks * (i + 1) / kProducers;
+    threads.emplace_back([&pool, &latch, &tasks, begin, end] {
+      for (size_t i = begin; i != end; ++i) {
+        tasks[i].SetLatch(&latch);
+        ASSERT_TRUE(pool.Enqueue(&tasks[i]));
+      }
+    });
+    begin = end;
+  }
+  latch.Wait();
+  for (auto& task : tasks) {
+    ASSERT_TRUE(task.IsCompleted());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST_F(ThreadPoolTest, TestQueueOverflow) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
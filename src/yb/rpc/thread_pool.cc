@@ -15,15 +15,25 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include <algorithm>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include <boost/lockfree/queue.hpp>
 #include <boost/scope_exit.hpp>
 
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
 #include "yb/util/thread.h"
 
+DEFINE_int32(rpc_thread_pool_num_queues, 4,
+             "Number of task queues of an RPC thread pool. Tasks queued by the same thread go to "
+             "the same queue, and workers take tasks from other queues when their own is empty.");
+TAG_FLAG(rpc_thread_pool_num_queues, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -34,15 +44,66 @@ class Worker;
 typedef boost::lockfree::queue<ThreadPoolTask*> TaskQueue;
 typedef boost::lockfree::queue<Worker*> WaitingWorkers;
 
+// Returns the queue that tasks queued by the current thread prefer. Threads that queue tasks,
+// i.e. reactors, are spread between queues, so they do not contend for the same queue, and
+// calls parsed by a reactor tend to be handled by the same workers.
+size_t PreferredQueueOfCurrentThread(size_t num_queues) {
+  static std::atomic<size_t> next_index = {0};
+  // Zero means that the index was not assigned yet.
+  static __thread size_t index_plus_one = 0;
+  if (index_plus_one == 0) {
+    index_plus_one = next_index++ + 1;
+  }
+  return (index_plus_one - 1) % num_queues;
+}
+
 struct ThreadPoolShare {
   ThreadPoolOptions options;
-  TaskQueue task_queue;
+  std::vector<std::unique_ptr<TaskQueue>> task_queues;
   WaitingWorkers waiting_workers;
 
   explicit ThreadPoolShare(ThreadPoolOptions o)
       : options(std::move(o)),
-        task_queue(options.queue_limit),
         waiting_workers(options.max_workers) {
+    const size_t num_queues = std::max(FLAGS_rpc_thread_pool_num_queues, 1);
+    // The limit is split between queues, but a task goes to another queue when its preferred
+    // queue is full, so the pool still accepts queue_limit tasks.
+    const size_t queue_limit = std::max<size_t>((options.queue_limit + num_queues - 1) / num_queues,
+                                                1);
+    task_queues.reserve(num_queues);
+    for (size_t i = 0; i != num_queues; ++i) {
+      task_queues.emplace_back(std::make_unique<TaskQueue>(queue_limit));
+    }
+  }
+
+  // Tries the queues starting from the given one.
+  bool PushTask(size_t first_queue, ThreadPoolTask* task) {
+    for (size_t i = 0; i != task_queues.size(); ++i) {
+      if (task_queues[(first_queue + i) % task_queues.size()]->bounded_push(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Tries the queues starting from the given one, so a worker steals tasks from other queues only
+  // when its own queue is empty.
+  bool PopTask(size_t first_queue, ThreadPoolTask** task) {
+    for (size_t i = 0; i != task_queues.size(); ++i) {
+      if (task_queues[(first_queue + i) % task_queues.size()]->pop(*task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Empty() const {
+    for (const auto& queue : task_queues) {
+      if (!queue->empty()) {
+        return false;
+      }
+    }
+    return true;
   }
 };
 
@@ -53,7 +114,7 @@ const std::string kRpcThreadCategory = "rpc_thread_pool";
 class Worker {
  public:
   explicit Worker(ThreadPoolShare* share, size_t index)
-      : share_(share) {
+      : share_(share), queue_(index % share->task_queues.size()) {
     auto name = strings::Substitute("rpc_tp_$0_$1", share_->options.name, index);
     CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_));
   }
@@ -87,9 +148,9 @@ class Worker {
   }
 
  private:
-  // Our main invariant is empty task queue or empty worker queue.
-  // In other words, one of those queues should be empty.
-  // Meaning that we does not have work (task queue empty) or
+  // Our main invariant is empty task queues or empty worker queue.
+  // In other words, all task queues or the worker queue should be empty.
+  // Meaning that we does not have work (task queues empty) or
   // does not have free hands (worker queue empty)
   void Execute() {
     while (!stop_requested_) {
@@ -104,7 +165,7 @@ class Worker {
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (share_->PopTask(queue_, task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -120,7 +181,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(queue_, task)) {
         return true;
       }
 
@@ -128,7 +189,7 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(queue_, task)) {
         return true;
       }
     }
@@ -144,6 +205,8 @@ class Worker {
   }
 
   ThreadPoolShare* share_;
+  // The queue this worker takes tasks from first.
+  const size_t queue_;
   scoped_refptr<yb::Thread> thread_;
   std::mutex mutex_;
   std::condition_variable cond_;
@@ -178,7 +241,8 @@ class ThreadPool::Impl {
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    bool added = share_.PushTask(
+        PreferredQueueOfCurrentThread(share_.task_queues.size()), task);
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
@@ -212,7 +276,7 @@ class ThreadPool::Impl {
     {
       std::lock_guard<std::mutex> lock(mutex_);
       if (closing_) {
-        CHECK(share_.task_queue.empty());
+        CHECK(share_.Empty());
         CHECK(workers_.empty());
         return;
       }
@@ -231,7 +295,7 @@ class ThreadPool::Impl {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     ThreadPoolTask* task = nullptr;
-    while (share_.task_queue.pop(task)) {
+    while (share_.PopTask(0, &task)) {
       task->Done(shutdown_status_);
     }
   }
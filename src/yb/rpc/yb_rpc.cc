@@ -16,6 +16,7 @@
 #include "yb/rpc/yb_rpc.h"
 
 #include <google/protobuf/io/coded_stream.h>
+#include <snappy.h>
 
 #include "yb/gutil/endian.h"
 
@@ -43,6 +44,23 @@ DECLARE_bool(rpc_dump_all_traces);
 DEFINE_int32(rpc_max_message_size, 255_MB,
              "The maximum size of a message of any RPC that the server will accept.");
 
+DEFINE_int32(rpc_compress_responses_min_bytes, 0,
+             "Responses whose message and sidecars take at least this many bytes are compressed "
+             "with Snappy, when the client is able to decompress them. 0 disables compression.");
+TAG_FLAG(rpc_compress_responses_min_bytes, advanced);
+TAG_FLAG(rpc_compress_responses_min_bytes, runtime);
+
+METRIC_DEFINE_counter(
+    server, rpc_response_uncompressed_bytes, "Compressed responses size before compression",
+    yb::MetricUnit::kBytes, "Number of bytes of RPC responses that were compressed");
+METRIC_DEFINE_counter(
+    server, rpc_response_compressed_bytes, "Compressed responses size after compression",
+    yb::MetricUnit::kBytes, "Number of bytes RPC responses were compressed to");
+METRIC_DEFINE_histogram(
+    server, rpc_response_compression_time, "Time taken to compress the response",
+    yb::MetricUnit::kMicroseconds, "Microseconds spent to compress an RPC response",
+    60000000LU, 2);
+
 using std::placeholders::_1;
 DECLARE_int32(rpc_slow_query_threshold_ms);
 
@@ -202,6 +220,15 @@ void YBConnectionContext::Connected(const ConnectionPtr& connection) {
 }
 
 void YBConnectionContext::AssignConnection(const ConnectionPtr& connection) {
+  const auto& metric_entity = connection->reactor()->messenger()->metric_entity();
+  if (metric_entity) {
+    compression_metrics_.uncompressed_bytes =
+        METRIC_rpc_response_uncompressed_bytes.Instantiate(metric_entity);
+    compression_metrics_.compressed_bytes =
+        METRIC_rpc_response_compressed_bytes.Instantiate(metric_entity);
+    compression_metrics_.compression_time =
+        METRIC_rpc_response_compression_time.Instantiate(metric_entity);
+  }
   if (connection->direction() == ConnectionDirection::CLIENT) {
     connection->QueueOutboundData(ConnectionHeader::Instance());
   }
@@ -243,6 +270,8 @@ Status YBInboundCall::ParseFrom(Slice source) {
         header_.remote_method().InitializationErrorString());
   }
   remote_method_.FromPB(header_.remote_method());
+  // Continue the trace of the caller, if it is sampled.
+  trace_->set_trace_id(header_.trace_id());
 
   return Status::OK();
 }
@@ -264,9 +293,9 @@ void YBInboundCall::ResetRpcSidecars() {
 
 Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                               bool is_success) {
-  using serialization::SerializeMessage;
-  using serialization::SerializeHeader;
+  using serialization::SerializeHeaderAndMessage;
 
+  // Caches the sizes of the response and its submessages, used by the serialization below.
   uint32_t protobuf_msg_size = response.ByteSize();
 
   ResponseHeader resp_hdr;
@@ -278,32 +307,69 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
     absolute_sidecar_offset += car.size();
   }
 
-  int additional_size = absolute_sidecar_offset - protobuf_msg_size;
-
-  size_t message_size = 0;
-  auto status = SerializeMessage(response,
-                                 /* param_buf */ nullptr,
-                                 additional_size,
-                                 /* use_cached_size */ true,
-                                 /* offset */ 0,
-                                 &message_size);
-  if (!status.ok()) {
-    return status;
+  size_t additional_size = absolute_sidecar_offset - protobuf_msg_size;
+
+  response_compressed_ = false;
+  const auto compress_min_bytes = FLAGS_rpc_compress_responses_min_bytes;
+  if (header_.accepts_compressed_response() && compress_min_bytes > 0 &&
+      absolute_sidecar_offset >= static_cast<uint32_t>(compress_min_bytes)) {
+    auto status = SerializeCompressedResponse(response, absolute_sidecar_offset, &resp_hdr);
+    if (!status.ok() || response_compressed_) {
+      return status;
+    }
   }
+
+  return SerializeHeaderAndMessage(
+      resp_hdr, response, protobuf_msg_size, additional_size, &response_buf_);
+}
+
+Status YBInboundCall::SerializeCompressedResponse(const google::protobuf::MessageLite& response,
+                                                  size_t uncompressed_size,
+                                                  ResponseHeader* resp_hdr) {
+  using serialization::SerializeHeader;
+
+  if (PREDICT_FALSE(!response.IsInitialized())) {
+    return STATUS(InvalidArgument, "RPC argument missing required fields",
+        response.InitializationErrorString());
+  }
+
+  const auto start = MonoTime::Now();
+  std::unique_ptr<char[]> uncompressed(new char[uncompressed_size]);
+  auto* pos = reinterpret_cast<char*>(response.SerializeWithCachedSizesToArray(
+      reinterpret_cast<uint8_t*>(uncompressed.get())));
+  for (const auto& car : sidecars_) {
+    memcpy(pos, car.data(), car.size());
+    pos += car.size();
+  }
+  CHECK_EQ(pos, uncompressed.get() + uncompressed_size);
+
+  std::unique_ptr<char[]> compressed(new char[snappy::MaxCompressedLength(uncompressed_size)]);
+  size_t compressed_size = 0;
+  snappy::RawCompress(uncompressed.get(), uncompressed_size, compressed.get(), &compressed_size);
+  if (compressed_size >= uncompressed_size) {
+    // Not worth it, send the response as is.
+    return Status::OK();
+  }
+
+  resp_hdr->set_uncompressed_size(uncompressed_size);
+  const size_t main_message_size =
+      CodedOutputStream::VarintSize32(compressed_size) + compressed_size;
   size_t header_size = 0;
-  status = SerializeHeader(resp_hdr,
-                           message_size + additional_size,
-                           &response_buf_,
-                           message_size,
-                           &header_size);
-  if (!status.ok()) {
-    return status;
+  RETURN_NOT_OK(SerializeHeader(
+      *resp_hdr, main_message_size, &response_buf_, main_message_size, &header_size));
+  uint8_t* dst = response_buf_.udata() + header_size;
+  dst = CodedOutputStream::WriteVarint32ToArray(compressed_size, dst);
+  memcpy(dst, compressed.get(), compressed_size);
+  response_compressed_ = true;
+
+  const auto& metrics =
+      down_cast<YBConnectionContext&>(connection()->context()).compression_metrics();
+  if (metrics.compression_time) {
+    metrics.uncompressed_bytes->IncrementBy(uncompressed_size);
+    metrics.compressed_bytes->IncrementBy(compressed_size);
+    metrics.compression_time->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
   }
-  return SerializeMessage(response,
-                          &response_buf_,
-                          additional_size,
-                          /* use_cached_size */ true,
-                          header_size);
+  return Status::OK();
 }
 
 string YBInboundCall::ToString() const {
@@ -346,7 +412,8 @@ void YBInboundCall::LogTrace() const {
 
   if (PREDICT_FALSE(
           FLAGS_rpc_dump_all_traces ||
-          total_time > FLAGS_rpc_slow_query_threshold_ms)) {
+          total_time > FLAGS_rpc_slow_query_threshold_ms ||
+          trace_->sampled())) {
     LOG(INFO) << ToString() << " took " << total_time << "ms. Trace:";
     trace_->Dump(&LOG(INFO), true);
   }
@@ -356,8 +423,10 @@ void YBInboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
   TRACE_EVENT0("rpc", "YBInboundCall::Serialize");
   CHECK_GT(response_buf_.size(), 0);
   output->push_back(response_buf_);
-  for (auto& car : sidecars_) {
-    output->push_back(car);
+  if (!response_compressed_) {
+    for (auto& car : sidecars_) {
+      output->push_back(car);
+    }
   }
 }
 
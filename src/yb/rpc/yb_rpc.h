@@ -19,14 +19,26 @@
 #include "yb/rpc/connection_context.h"
 #include "yb/rpc/rpc_with_call_id.h"
 
+#include "yb/util/metrics.h"
+
 namespace yb {
 namespace rpc {
 
+// Metrics of the responses compressed before being sent over a connection.
+struct ResponseCompressionMetrics {
+  scoped_refptr<Counter> uncompressed_bytes;
+  scoped_refptr<Counter> compressed_bytes;
+  scoped_refptr<Histogram> compression_time;
+};
+
 class YBConnectionContext : public ConnectionContextWithCallId {
  public:
   YBConnectionContext();
   ~YBConnectionContext();
 
+  // Metrics are not available when the messenger has no metric entity.
+  const ResponseCompressionMetrics& compression_metrics() const { return compression_metrics_; }
+
  private:
   uint64_t ExtractCallId(InboundCall* call) override;
 
@@ -46,6 +58,8 @@ class YBConnectionContext : public ConnectionContextWithCallId {
   RpcConnectionPB::StateType State() override { return state_; }
 
   RpcConnectionPB::StateType state_ = RpcConnectionPB::UNKNOWN;
+
+  ResponseCompressionMetrics compression_metrics_;
 };
 
 class YBInboundCall : public InboundCall {
@@ -142,12 +156,21 @@ class YBInboundCall : public InboundCall {
   CHECKED_STATUS SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                          bool is_success);
 
+  // Tries to serialize the response message and the sidecars as a single compressed main
+  // message. Sets response_compressed_ if compression made the response smaller.
+  CHECKED_STATUS SerializeCompressedResponse(const google::protobuf::MessageLite& response,
+                                             size_t uncompressed_size,
+                                             ResponseHeader* resp_hdr);
+
   // The header of the incoming call. Set by ParseFrom()
   RequestHeader header_;
 
   // The buffers for serialized response. Set by SerializeResponseBuffer().
   RefCntBuffer response_buf_;
 
+  // Whether the sidecars are compressed into response_buf_, so they should not be sent.
+  bool response_compressed_ = false;
+
   // Proto service this calls belongs to. Used for routing.
   // This field is filled in when the inbound request header is parsed.
   RemoteMethod remote_method_;
@@ -47,7 +47,9 @@
 
 #include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -67,13 +69,22 @@
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/profiling_context.h"
+#include "yb/util/url-coding.h"
 
 DEFINE_int64(web_log_bytes, 1024 * 1024,
     "The maximum number of bytes to display on the debug webserver's log page");
 TAG_FLAG(web_log_bytes, advanced);
 TAG_FLAG(web_log_bytes, runtime);
 
+DEFINE_int32(prometheus_metrics_cache_ms, 1000,
+    "The Prometheus metrics page is served from the output of a previous scrape with the same "
+    "arguments if it is not older than this. 0 to always collect the metrics anew.");
+TAG_FLAG(prometheus_metrics_cache_ms, advanced);
+TAG_FLAG(prometheus_metrics_cache_ms, runtime);
+
 namespace yb {
 
 using boost::replace_all;
@@ -188,12 +199,32 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
   *output << "</table>\n";
 }
 
+// Registered to handle "/cpu-attribution", and prints the estimated CPU and spinlock wait time
+// by tablet and activity over the rolling window.
+static void CpuAttributionHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  *output << "<h1>CPU usage by tablet</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Tablet</th><th>Activity</th><th>Count</th><th>CPU time</th>"
+      "<th>Spinlock wait time</th></tr>\n";
+  for (const ProfilingAttribution& entry : GetProfilingAttribution()) {
+    (*output) << Substitute("  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+                            entry.tablet_id.empty() ? "none" : entry.tablet_id,
+                            EscapeForHtmlToString(entry.activity), entry.count,
+                            HumanReadableElapsedTime::ToShortString(entry.cpu_micros / 1e6),
+                            HumanReadableElapsedTime::ToShortString(
+                                entry.lock_wait_micros / 1e6));
+  }
+  *output << "</table>\n";
+}
+
 void AddDefaultPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/logs", "Logs", LogsHandler, true, false);
   webserver->RegisterPathHandler("/varz", "Flags", FlagsHandler, true, false);
   webserver->RegisterPathHandler("/memz", "Memory (total)", MemUsageHandler, true, false);
   webserver->RegisterPathHandler("/mem-trackers", "Memory (detail)",
                                  MemTrackersHandler, true, false);
+  webserver->RegisterPathHandler("/cpu-attribution", "CPU (by tablet)",
+                                 CpuAttributionHandler, true, false);
 
   AddPprofPathHandlers(webserver);
 }
@@ -233,16 +264,84 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
               "Couldn't write JSON metrics over HTTP");
 }
 
+namespace {
+
+// The output of the recent Prometheus scrapes, so that several scrapers polling the same server,
+// e.g. a pair of Prometheus servers, do not walk all the metrics of all the tablets each.
+class PrometheusMetricsCache {
+ public:
+  // Returns false if there is no fresh enough output for the query.
+  bool Get(const std::string& query, std::stringstream* output) {
+    const auto max_age = MonoDelta::FromMilliseconds(FLAGS_prometheus_metrics_cache_ms);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(query);
+    if (it == entries_.end() || MonoTime::Now().GetDeltaSince(it->second.time) > max_age) {
+      return false;
+    }
+    *output << it->second.text;
+    return true;
+  }
+
+  void Put(const std::string& query, std::string text) {
+    static constexpr size_t kMaxEntries = 16;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= kMaxEntries && entries_.count(query) == 0) {
+      entries_.clear();
+    }
+    entries_[query] = Entry{MonoTime::Now(), std::move(text)};
+  }
+
+ private:
+  struct Entry {
+    MonoTime time;
+    std::string text;
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, Entry> entries_;
+};
+
+} // namespace
+
 static void WriteForPrometheus(const MetricRegistry* const metrics,
+                               PrometheusMetricsCache* cache,
                                const Webserver::WebRequest& req, std::stringstream* output) {
-  PrometheusWriter writer(output);
+  const bool use_cache = FLAGS_prometheus_metrics_cache_ms > 0;
+  if (use_cache && cache->Get(req.query_string, output)) {
+    return;
+  }
+
+  MetricPrometheusOptions opts;
+  const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
+  if (requested_metrics_param != nullptr) {
+    opts.requested_metrics.clear();
+    SplitStringUsing(*requested_metrics_param, ",", &opts.requested_metrics);
+  }
+  const string* entity_types_param = FindOrNull(req.parsed_args, "metric_type");
+  if (entity_types_param != nullptr) {
+    SplitStringUsing(*entity_types_param, ",", &opts.entity_types);
+  }
+  if (FindWithDefault(req.parsed_args, "tablet_aggregation", "table") == "server") {
+    opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kServer;
+  }
+
+  std::stringstream text;
+  PrometheusWriter writer(&text, std::move(opts));
   WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
+  std::string result = text.str();
+  *output << result;
+  if (use_cache) {
+    cache->Put(req.query_string, std::move(result));
+  }
 }
 
 void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* const metrics) {
   Webserver::PathHandlerCallback callback = std::bind(WriteMetricsAsJson, metrics, _1, _2);
-  Webserver::PathHandlerCallback prometheus_callback = std::bind(
-      WriteForPrometheus, metrics, _1, _2);
+  auto prometheus_cache = std::make_shared<PrometheusMetricsCache>();
+  Webserver::PathHandlerCallback prometheus_callback =
+      [metrics, prometheus_cache](const Webserver::WebRequest& req, std::stringstream* output) {
+    WriteForPrometheus(metrics, prometheus_cache.get(), req, output);
+  };
   bool not_styled = false;
   bool not_on_nav_bar = false;
   webserver->RegisterPathHandler("/metrics", "Metrics", callback, not_styled, not_on_nav_bar);
@@ -31,6 +31,9 @@
 //
 
 #include <algorithm>
+#include <thread>
+#include <vector>
+
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -44,6 +47,7 @@
 DECLARE_bool(use_mock_wall_clock);
 DECLARE_uint64(max_clock_sync_error_usec);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(clock_error_refresh_interval_ms);
 
 namespace yb {
 namespace server {
@@ -258,6 +262,33 @@ TEST_F(HybridClockTest, TestClockDoesntGoBackwardsWithUpdates) {
   }
 }
 
+// Concurrent readers must never be handed out the same hybrid time.
+TEST_F(HybridClockTest, TestNow_UniqueAcrossThreads) {
+  constexpr int kNumThreads = 8;
+  constexpr int kReadsPerThread = 100000;
+  std::vector<std::vector<uint64_t>> values(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([this, &values, i] {
+      values[i].reserve(kReadsPerThread);
+      for (int j = 0; j != kReadsPerThread; ++j) {
+        values[i].push_back(clock_->Now().ToUint64());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<uint64_t> all_values;
+  for (const auto& thread_values : values) {
+    ASSERT_TRUE(std::is_sorted(thread_values.begin(), thread_values.end()));
+    all_values.insert(all_values.end(), thread_values.begin(), thread_values.end());
+  }
+  std::sort(all_values.begin(), all_values.end());
+  ASSERT_TRUE(std::adjacent_find(all_values.begin(), all_values.end()) == all_values.end());
+}
+
 TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
   EXPECT_EQ(1, HybridClock::CompareHybridClocksToDelta(
       HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 10),
@@ -357,6 +388,43 @@ TEST_F(HybridClockTest, TestNtpErrorsIgnored) {
   timex timex;
   EXPECT_OK(mock_clock->GetClockModes(&timex));
 }
+
+// The error bound is only read from NTP once per refresh interval, and grows in between.
+TEST_F(HybridClockTest, TestCachedClockError) {
+  using ::testing::Invoke;
+  using ::testing::_;
+
+  google::FlagSaver saver;
+  FLAGS_clock_error_refresh_interval_ms = 60 * 60 * 1000;
+  scoped_refptr<MockHybridClock> mock_clock(new MockHybridClock());
+  EXPECT_CALL(*mock_clock, NtpAdjtime(_)).WillRepeatedly(Invoke(&ntp_adjtime));
+  // Once in Init() and once when the first clock read fills the cache.
+  EXPECT_CALL(*mock_clock, NtpGettime(_)).Times(2).WillRepeatedly(Invoke(&ntp_gettime));
+  ASSERT_OK(mock_clock->Init());
+
+  HybridTime prev = HybridTime::kMin;
+  uint64_t prev_physical_error = 0;
+  for (int i = 0; i != 1000; ++i) {
+    HybridTime now;
+    uint64_t error = 0;
+    mock_clock->NowWithError(&now, &error);
+    ASSERT_GT(now.ToUint64(), prev.ToUint64());
+    // Reads handing out the physical time report the cached error plus the drift since then.
+    if (HybridClock::GetLogicalValue(now) == 0) {
+      ASSERT_GE(error, prev_physical_error);
+      prev_physical_error = error;
+    }
+    prev = now;
+  }
+  ::testing::Mock::VerifyAndClearExpectations(mock_clock.get());
+
+  // Without caching, every read goes to NTP.
+  FLAGS_clock_error_refresh_interval_ms = 0;
+  EXPECT_CALL(*mock_clock, NtpGettime(_)).Times(10).WillRepeatedly(Invoke(&ntp_gettime));
+  for (int i = 0; i != 10; ++i) {
+    mock_clock->Now();
+  }
+}
 #endif // !defined(__APPLE__)
 
 }  // namespace server
@@ -33,7 +33,7 @@
 #include "yb/server/hybrid_clock.h"
 
 #include <algorithm>
-#include <mutex>
+#include <cmath>
 
 #include <glog/logging.h>
 #include "yb/gutil/bind.h"
@@ -66,6 +66,12 @@ DEFINE_bool(use_mock_wall_clock, false,
             "instead of reading time from the system clock, for tests.");
 TAG_FLAG(use_mock_wall_clock, hidden);
 
+DEFINE_int32(clock_error_refresh_interval_ms, 100,
+             "How often the clock error bound is re-read from NTP. In between, the last bound read "
+             "is extended by the maximum clock drift. Zero or less reads it on every clock read.");
+TAG_FLAG(clock_error_refresh_interval_ms, advanced);
+TAG_FLAG(clock_error_refresh_interval_ms, runtime);
+
 METRIC_DEFINE_gauge_uint64(server, hybrid_clock_hybrid_time,
                            "Hybrid Clock HybridTime",
                            yb::MetricUnit::kMicroseconds,
@@ -115,8 +121,10 @@ HybridClock::HybridClock()
       divisor_(1),
 #endif
       tolerance_adjustment_(1),
-      last_usec_(0),
-      next_logical_(0),
+      next_hybrid_time_(0),
+      cached_error_usec_(0),
+      cached_error_time_usec_(0),
+      refreshing_error_(false),
       state_(kNotInitialized) {
 }
 
@@ -214,20 +222,14 @@ Status HybridClock::Init() {
 HybridTime HybridClock::Now() {
   HybridTime now;
   uint64_t error;
-
-  std::lock_guard<simple_spinlock> lock(lock_);
-  NowWithErrorUnlocked(&now, &error);
+  NowWithError(&now, &error);
   return now;
 }
 
 HybridTime HybridClock::NowLatest() {
   HybridTime now;
   uint64_t error;
-
-  {
-    std::lock_guard<simple_spinlock> lock(lock_);
-    NowWithErrorUnlocked(&now, &error);
-  }
+  NowWithError(&now, &error);
 
   uint64_t now_latest = GetPhysicalValueMicros(now) + error;
   uint64_t now_logical = GetLogicalValue(now);
@@ -244,32 +246,32 @@ Status HybridClock::GetGlobalLatest(HybridTime* t) {
 }
 
 void HybridClock::NowWithError(HybridTime *hybrid_time, uint64_t *max_error_usec) {
-  std::lock_guard<simple_spinlock> lock(lock_);
-  NowWithErrorUnlocked(hybrid_time, max_error_usec);
-}
-
-void HybridClock::NowWithErrorUnlocked(HybridTime *hybrid_time, uint64_t *max_error_usec) {
-
-  DCHECK(lock_.is_locked());
   DCHECK_EQ(state_, kInitialized) << "Clock not initialized. Must call Init() first.";
 
   uint64_t now_usec;
   uint64_t error_usec;
-  Status s = WalltimeWithError(&now_usec, &error_usec);
+  Status s = WalltimeWithCachedError(&now_usec, &error_usec);
   if (PREDICT_FALSE(!s.ok())) {
     LOG(FATAL) << Substitute("Couldn't get the current time: Clock unsynchronized. "
         "Status: $0", s.ToString());
   }
 
-  // If the current time surpasses the last update just return it
-  if (PREDICT_TRUE(now_usec > last_usec_)) {
-    last_usec_ = now_usec;
-    next_logical_ = 1;
-    *hybrid_time = HybridTimeFromMicroseconds(last_usec_);
+  // Hand out the current time if it surpasses the last one handed out, and the next logical tick
+  // after the last one otherwise.
+  const uint64_t now_value = HybridTimeFromMicroseconds(now_usec).ToUint64();
+  uint64_t next_value = next_hybrid_time_.load(std::memory_order_acquire);
+  uint64_t new_value;
+  do {
+    new_value = std::max(now_value, next_value);
+  } while (!next_hybrid_time_.compare_exchange_weak(
+      next_value, new_value + 1, std::memory_order_acq_rel));
+  *hybrid_time = HybridTime(new_value);
+
+  if (PREDICT_TRUE(new_value == now_value)) {
     *max_error_usec = error_usec;
     if (PREDICT_FALSE(VLOG_IS_ON(2))) {
       VLOG(2) << "Current clock is higher than the last one. Resetting logical values."
-          << " Time: " << HybridTime(now_usec, 0) << ", Error: " << error_usec;
+          << " Time: " << *hybrid_time << ", Error: " << error_usec;
     }
     return;
   }
@@ -292,14 +294,12 @@ void HybridClock::NowWithErrorUnlocked(HybridTime *hybrid_time, uint64_t *max_er
   // This broadens the error interval for both cases but always returns
   // a correct error interval.
 
-  *max_error_usec = last_usec_ - (now_usec - error_usec);
-  *hybrid_time = HybridTimeFromMicrosecondsAndLogicalValue(last_usec_, next_logical_);
+  *max_error_usec = GetPhysicalValueMicros(*hybrid_time) - (now_usec - error_usec);
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
     VLOG(2) << "Current clock is lower than the last one. Returning last read and incrementing"
         " logical values. Physical Value: " << now_usec << " usec Logical Value: "
-        << next_logical_ << " Error: " << *max_error_usec;
+        << GetLogicalValue(*hybrid_time) << " Error: " << *max_error_usec;
   }
-  next_logical_++;
 }
 
 void HybridClock::Update(const HybridTime& to_update) {
@@ -307,17 +307,14 @@ void HybridClock::Update(const HybridTime& to_update) {
     return;
   }
 
-  std::lock_guard<simple_spinlock> lock(lock_);
-  HybridTime now;
-  uint64_t error_ignored;
-  NowWithErrorUnlocked(&now, &error_ignored);
-
-  if (PREDICT_TRUE(now.CompareTo(to_update) > 0)) {
-    return;
+  // Now() never hands out values below the next one, so it's enough to raise it. There is no need
+  // to read the current time, which overtakes a lower next value anyway.
+  const uint64_t update_value = to_update.ToUint64() + 1;
+  uint64_t next_value = next_hybrid_time_.load(std::memory_order_acquire);
+  while (next_value < update_value &&
+         !next_hybrid_time_.compare_exchange_weak(
+             next_value, update_value, std::memory_order_acq_rel)) {
   }
-
-  last_usec_ = GetPhysicalValueMicros(to_update);
-  next_logical_ = GetLogicalValue(to_update) + 1;
 }
 
 Status HybridClock::WaitUntilAfter(const HybridTime& then_latest,
@@ -325,10 +322,7 @@ Status HybridClock::WaitUntilAfter(const HybridTime& then_latest,
   TRACE_EVENT0("clock", "HybridClock::WaitUntilAfter");
   HybridTime now;
   uint64_t error;
-  {
-    std::lock_guard<simple_spinlock> lock(lock_);
-    NowWithErrorUnlocked(&now, &error);
-  }
+  NowWithError(&now, &error);
 
   // "unshift" the hybrid_times so that we can measure actual time
   uint64_t now_usec = GetPhysicalValueMicros(now);
@@ -369,10 +363,7 @@ Status HybridClock::WaitUntilAfterLocally(const HybridTime& then,
   while (true) {
     HybridTime now;
     uint64_t error;
-    {
-      std::lock_guard<simple_spinlock> lock(lock_);
-      NowWithErrorUnlocked(&now, &error);
-    }
+    NowWithError(&now, &error);
     if (now.CompareTo(then) > 0) {
       return Status::OK();
     }
@@ -388,21 +379,12 @@ bool HybridClock::IsAfter(HybridTime t) {
   // a time update.
   uint64_t now_usec;
   uint64_t error_usec;
-  CHECK_OK(WalltimeWithError(&now_usec, &error_usec));
-
-  std::lock_guard<simple_spinlock> lock(lock_);
-  now_usec = std::max(now_usec, last_usec_);
-
-  HybridTime now;
-  if (now_usec > last_usec_) {
-    now = HybridTimeFromMicroseconds(now_usec);
-  } else {
-    // last_usec_ may be in the future if we were updated from a remote
-    // node.
-    now = HybridTimeFromMicrosecondsAndLogicalValue(last_usec_, next_logical_);
-  }
+  CHECK_OK(WalltimeWithCachedError(&now_usec, &error_usec));
 
-  return t.value() < now.value();
+  // The next hybrid time may be in the future if we were updated from a remote node.
+  const uint64_t now_value = HybridTimeFromMicroseconds(now_usec).ToUint64();
+  const uint64_t next_value = next_hybrid_time_.load(std::memory_order_acquire);
+  return t.value() < std::max(now_value, next_value);
 }
 
 yb::Status HybridClock::CheckClockSyncError(uint64_t error_usec) {
@@ -416,11 +398,11 @@ yb::Status HybridClock::CheckClockSyncError(uint64_t error_usec) {
 
 yb::Status HybridClock::WalltimeWithError(uint64_t* now_usec, uint64_t* error_usec) {
   if (PREDICT_FALSE(FLAGS_use_mock_wall_clock)) {
-    VLOG(1) << "Current clock time: " << mock_clock_time_usec_ << " error: "
-            << mock_clock_max_error_usec_ << ". Updating to time: " << now_usec
+    VLOG(1) << "Current clock time: " << mock_clock_time_usec_.load() << " error: "
+            << mock_clock_max_error_usec_.load() << ". Updating to time: " << now_usec
             << " and error: " << error_usec;
-    *now_usec = mock_clock_time_usec_;
-    *error_usec = mock_clock_max_error_usec_;
+    *now_usec = mock_clock_time_usec_.load(std::memory_order_acquire);
+    *error_usec = mock_clock_max_error_usec_.load(std::memory_order_acquire);
   } else {
 #if defined(__APPLE__)
     *now_usec = GetCurrentTimeMicros();
@@ -442,17 +424,57 @@ yb::Status HybridClock::WalltimeWithError(uint64_t* now_usec, uint64_t* error_us
   return yb::Status::OK();
 }
 
+Status HybridClock::WalltimeWithCachedError(uint64_t* now_usec, uint64_t* error_usec) {
+#if defined(__APPLE__)
+  return WalltimeWithError(now_usec, error_usec);
+#else
+  const int refresh_interval_ms = FLAGS_clock_error_refresh_interval_ms;
+  if (PREDICT_FALSE(FLAGS_use_mock_wall_clock) || refresh_interval_ms <= 0) {
+    return WalltimeWithError(now_usec, error_usec);
+  }
+
+  const uint64_t cached_time_usec = cached_error_time_usec_.load(std::memory_order_acquire);
+  const uint64_t cached_error_usec = cached_error_usec_.load(std::memory_order_relaxed);
+  *now_usec = GetCurrentTimeMicros();
+  const bool stale = cached_time_usec == 0 ||
+                     *now_usec >= cached_time_usec + refresh_interval_ms * 1000ULL;
+  // Only one reader re-reads a stale bound, the others keep extending the cached one meanwhile,
+  // unless there is none yet.
+  if (PREDICT_FALSE(stale) &&
+      (cached_time_usec == 0 || !refreshing_error_.exchange(true, std::memory_order_acquire))) {
+    Status s = WalltimeWithError(now_usec, error_usec);
+    if (s.ok()) {
+      CacheError(*now_usec, *error_usec);
+    }
+    if (cached_time_usec != 0) {
+      refreshing_error_.store(false, std::memory_order_release);
+    }
+    return s;
+  }
+
+  // The kernel grows the max error by the clock tolerance between NTP adjustments, so growing the
+  // cached bound the same way keeps it an upper bound of what ntp_gettime() would return now.
+  const uint64_t elapsed_usec = *now_usec > cached_time_usec ? *now_usec - cached_time_usec : 0;
+  *error_usec = cached_error_usec +
+                static_cast<uint64_t>(std::ceil(elapsed_usec * (tolerance_adjustment_ - 1)));
+  return CheckClockSyncError(*error_usec);
+#endif // defined(__APPLE__)
+}
+
+void HybridClock::CacheError(uint64_t now_usec, uint64_t error_usec) {
+  cached_error_usec_.store(error_usec, std::memory_order_relaxed);
+  cached_error_time_usec_.store(now_usec, std::memory_order_release);
+}
+
 void HybridClock::SetMockClockWallTimeForTests(uint64_t now_usec) {
   CHECK(FLAGS_use_mock_wall_clock);
-  std::lock_guard<simple_spinlock> lock(lock_);
-  CHECK_GE(now_usec, mock_clock_time_usec_);
-  mock_clock_time_usec_ = now_usec;
+  CHECK_GE(now_usec, mock_clock_time_usec_.load(std::memory_order_acquire));
+  mock_clock_time_usec_.store(now_usec, std::memory_order_release);
 }
 
 void HybridClock::SetMockMaxClockErrorForTests(uint64_t max_error_usec) {
   CHECK(FLAGS_use_mock_wall_clock);
-  std::lock_guard<simple_spinlock> lock(lock_);
-  mock_clock_max_error_usec_ = max_error_usec;
+  mock_clock_max_error_usec_.store(max_error_usec, std::memory_order_release);
 }
 
 // Used to get the hybrid_time for metrics.
@@ -464,9 +486,7 @@ uint64_t HybridClock::NowForMetrics() {
 uint64_t HybridClock::ErrorForMetrics() {
   HybridTime now;
   uint64_t error;
-
-  std::lock_guard<simple_spinlock> lock(lock_);
-  NowWithErrorUnlocked(&now, &error);
+  NowWithError(&now, &error);
   return error;
 }
 
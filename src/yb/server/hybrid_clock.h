@@ -33,6 +33,7 @@
 #ifndef YB_SERVER_HYBRID_CLOCK_H_
 #define YB_SERVER_HYBRID_CLOCK_H_
 
+#include <atomic>
 #include <string>
 #if !defined(__APPLE__)
 #include <sys/timex.h>
@@ -51,6 +52,10 @@ namespace server {
 //
 // HybridTime should not be used on a distributed cluster running on OS X hosts,
 // since NTP clock error is not available.
+//
+// Reading and updating the clock is lock free: the next hybrid time to hand out is a single atomic
+// value advanced by CAS, and the NTP error bound is cached and only re-read from the kernel every
+// clock_error_refresh_interval_ms, by whichever reader finds it stale.
 class HybridClock : public Clock {
  public:
   HybridClock();
@@ -130,9 +135,6 @@ class HybridClock : public Clock {
   // error in micros. This may fail if the clock is unsynchronized or synchronized
   // but the error is too high and, since we can't do anything about it,
   // LOG(FATAL)'s in that case.
-  void NowWithErrorUnlocked(HybridTime* hybrid_time, uint64_t* max_error_usec);
-
-  // Variation of above method with locking.
   void NowWithError(HybridTime* hybrid_time, uint64_t* max_error_usec);
 
   virtual std::string Stringify(HybridTime hybrid_time) override;
@@ -198,6 +200,7 @@ class HybridClock : public Clock {
   FRIEND_TEST(HybridClockTest, TestCheckClockSyncError);
   FRIEND_TEST(HybridClockTest, TestNtpErrorsNotIgnored);
   FRIEND_TEST(HybridClockTest, TestNtpErrorsIgnored);
+  FRIEND_TEST(HybridClockTest, TestCachedClockError);
 
   // Obtains the current wallclock time and maximum error in microseconds,
   // and checks if the clock is synchronized.
@@ -205,6 +208,13 @@ class HybridClock : public Clock {
   // On OS X, the error will always be 0.
   CHECKED_STATUS WalltimeWithError(uint64_t* now_usec, uint64_t* error_usec);
 
+  // Same as WalltimeWithError(), but only reads the system clock and extends the cached error
+  // bound by the maximum drift since it was read, unless the cached bound is stale.
+  CHECKED_STATUS WalltimeWithCachedError(uint64_t* now_usec, uint64_t* error_usec);
+
+  // Caches the error bound read at 'now_usec'.
+  void CacheError(uint64_t now_usec, uint64_t error_usec);
+
   // Returns Status::OK if the clock error_usec provided is within acceptable limits, otherwise
   // it returns a not OK status if disable_clock_sync_error is not true.
   static CHECKED_STATUS CheckClockSyncError(uint64_t error_usec);
@@ -217,11 +227,11 @@ class HybridClock : public Clock {
 
   // Set by calls to SetMockClockWallTimeForTests().
   // For testing purposes only.
-  uint64_t mock_clock_time_usec_;
+  std::atomic<uint64_t> mock_clock_time_usec_;
 
   // Set by calls to SetMockClockErrorForTests().
   // For testing purposes only.
-  uint64_t mock_clock_max_error_usec_;
+  std::atomic<uint64_t> mock_clock_max_error_usec_;
 
 #if !defined(__APPLE__)
   uint64_t divisor_;
@@ -229,12 +239,17 @@ class HybridClock : public Clock {
 
   double tolerance_adjustment_;
 
-  mutable simple_spinlock lock_;
-
-  // the last clock read/update, in microseconds.
-  uint64_t last_usec_;
-  // the next logical value to be assigned to a hybrid_time
-  uint64_t next_logical_;
+  // One above the last hybrid time handed out by Now() or received by Update(). Now() hands out
+  // the current physical time if it's higher, or this value otherwise.
+  std::atomic<uint64_t> next_hybrid_time_;
+
+  // The NTP error bound, and the wall clock time in microseconds at which it was read, 0 if it
+  // was never read. The error is stored before the time, and loaded after it, so that the error
+  // loaded is never older than the time.
+  std::atomic<uint64_t> cached_error_usec_;
+  std::atomic<uint64_t> cached_error_time_usec_;
+  // Set while a reader re-reads the error bound, so that others keep using the cached one.
+  std::atomic<bool> refreshing_error_;
 
   // How many bits to left shift a microseconds clock read. The remainder
   // of the hybrid_time will be reserved for logical values.
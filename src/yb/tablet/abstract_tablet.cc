@@ -27,24 +27,17 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
   // TODO(Robert): verify that all key column values are provided
   docdb::QLReadOperation doc_op(ql_read_request, txn_op_context);
 
-  // Form a schema of columns that are referenced by this query.
+  // Form the schemas of columns that are referenced by this query.
   const Schema &schema = SchemaRef();
-  Schema query_schema;
-  const QLReferencedColumnsPB& column_pbs = ql_read_request.column_refs();
-  vector<ColumnId> column_refs;
-  for (int32_t id : column_pbs.static_ids()) {
-    column_refs.emplace_back(id);
-  }
-  for (int32_t id : column_pbs.ids()) {
-    column_refs.emplace_back(id);
-  }
-  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_refs, &query_schema));
+  auto projections = projection_cache_.Get(
+      schema, ql_read_request.schema_version(), ql_read_request.column_refs());
+  RETURN_NOT_OK(projections);
 
   QLRSRowDesc rsrow_desc(ql_read_request.rsrow_desc());
   QLResultSet resultset;
   TRACE("Start Execute");
   const Status s = doc_op.Execute(
-      QLStorage(), read_time, schema, query_schema, &resultset, &result->restart_read_ht);
+      QLStorage(), read_time, schema, **projections, &resultset, &result->restart_read_ht);
   TRACE("Done Execute");
   if (!s.ok()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_RUNTIME_ERROR);
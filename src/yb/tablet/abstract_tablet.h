@@ -18,6 +18,8 @@
 #include "yb/common/schema.h"
 #include "yb/common/ql_storage_interface.h"
 
+#include "yb/docdb/ql_projection_cache.h"
+
 #include "yb/tablet/tablet_fwd.h"
 
 namespace yb {
@@ -72,6 +74,17 @@ class AbstractTablet {
     return DoGetSafeTime(require_lease, min_allowed, deadline);
   }
 
+  // Returns `read_ht` if the rows read by `ql_batch` could be read at it on the leader without
+  // waiting for the pending write operations, i.e. none of them locks those rows and `read_ht` is
+  // covered by the leader lease. Otherwise returns invalid hybrid time and the read should wait
+  // for SafeTime.
+  virtual HybridTime SafeTimeForUnlockedRead(
+      const google::protobuf::RepeatedPtrField<QLReadRequestPB>& ql_batch,
+      HybridTime read_ht,
+      MonoTime deadline) {
+    return HybridTime::kInvalid;
+  }
+
  protected:
   CHECKED_STATUS HandleQLReadRequest(
       const ReadHybridTime& read_time,
@@ -79,6 +92,9 @@ class AbstractTablet {
       const TransactionOperationContextOpt& txn_op_context,
       QLReadRequestResult* result);
 
+  // Projections of the schema used by the recent reads. Cleared when the schema changes.
+  docdb::QLProjectionCache projection_cache_;
+
  private:
   virtual HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const = 0;
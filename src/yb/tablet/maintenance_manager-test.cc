@@ -39,6 +39,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.pb.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/test_macros.h"
@@ -128,6 +129,9 @@ class TestMaintenanceOp : public MaintenanceOp {
 
   void Perform() override {
     DLOG(INFO) << "Performing op " << name();
+    if (perform_latch_) {
+      perform_latch_->Wait();
+    }
     std::lock_guard<Mutex> guard(lock_);
     CHECK_EQ(OP_RUNNING, state_);
     state_ = OP_FINISHED;
@@ -187,6 +191,11 @@ class TestMaintenanceOp : public MaintenanceOp {
     perf_improvement_ = perf_improvement;
   }
 
+  // Makes Perform() wait for the latch, to keep the op running.
+  void set_perform_latch(CountDownLatch* latch) {
+    perform_latch_ = latch;
+  }
+
   scoped_refptr<Histogram> DurationHistogram() const override {
     return maintenance_op_duration_;
   }
@@ -202,6 +211,7 @@ class TestMaintenanceOp : public MaintenanceOp {
   ScopedTrackedConsumption consumption_;
   uint64_t logs_retained_bytes_;
   uint64_t perf_improvement_;
+  CountDownLatch* perform_latch_ = nullptr;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   scoped_refptr<Histogram> maintenance_op_duration_;
@@ -279,6 +289,38 @@ TEST_F(MaintenanceManagerTest, TestLogRetentionPrioritization) {
   manager_->UnregisterOp(&op2);
 }
 
+// Test that a long running high IO op uses up the high IO budget, but does not keep a low IO op
+// from running on the other thread.
+TEST_F(MaintenanceManagerTest, TestHighIOBudget) {
+  CountDownLatch perform_latch(1);
+  TestMaintenanceOp high_io_op1("high_io_op1", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE,
+                                test_tracker_);
+  high_io_op1.set_perf_improvement(1);
+  high_io_op1.set_perform_latch(&perform_latch);
+  manager_->RegisterOp(&high_io_op1);
+  high_io_op1.WaitForState(OP_RUNNING);
+
+  TestMaintenanceOp high_io_op2("high_io_op2", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE,
+                                test_tracker_);
+  high_io_op2.set_perf_improvement(1);
+  TestMaintenanceOp low_io_op("low_io_op", MaintenanceOp::LOW_IO_USAGE, OP_RUNNABLE,
+                              test_tracker_);
+  low_io_op.set_logs_retained_bytes(100);
+  manager_->RegisterOp(&high_io_op2);
+  manager_->RegisterOp(&low_io_op);
+
+  ASSERT_TRUE(low_io_op.WaitForStateWithTimeout(OP_FINISHED, 1000));
+  ASSERT_FALSE(high_io_op2.WaitForStateWithTimeout(OP_RUNNING, 50));
+
+  perform_latch.CountDown();
+  high_io_op1.WaitForState(OP_FINISHED);
+  high_io_op2.WaitForState(OP_FINISHED);
+
+  manager_->UnregisterOp(&low_io_op);
+  manager_->UnregisterOp(&high_io_op2);
+  manager_->UnregisterOp(&high_io_op1);
+}
+
 // Test adding operations and make sure that the history of recently completed operations
 // is correct in that it wraps around and doesn't grow.
 TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
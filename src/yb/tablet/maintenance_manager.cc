@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -54,12 +55,17 @@ using std::pair;
 using std::shared_ptr;
 using strings::Substitute;
 
-DEFINE_int32(maintenance_manager_num_threads, 1,
+DEFINE_int32(maintenance_manager_num_threads, 2,
        "Size of the maintenance manager thread pool. Beyond a value of '1', one thread is "
-       "reserved for emergency flushes. For spinning disks, the number of threads should "
-       "not be above the number of devices.");
+       "reserved for low IO operations, such as log GC, by default. For spinning disks, the "
+       "number of threads should not be above the number of devices.");
 TAG_FLAG(maintenance_manager_num_threads, stable);
 
+DEFINE_int32(maintenance_manager_max_high_io_ops, 0,
+       "Maximum number of high IO maintenance operations that run at the same time. 0 means one "
+       "less than --maintenance_manager_num_threads, or 1 if there is a single thread.");
+TAG_FLAG(maintenance_manager_max_high_io_ops, advanced);
+
 DEFINE_int32(maintenance_manager_polling_interval_ms, 250,
        "Polling interval for the maintenance manager scheduler, "
        "in milliseconds.");
@@ -79,6 +85,17 @@ using yb::tablet::MaintenanceManagerStatusPB;
 using yb::tablet::MaintenanceManagerStatusPB_CompletedOpPB;
 using yb::tablet::MaintenanceManagerStatusPB_MaintenanceOpPB;
 
+namespace {
+
+int32_t MaxHighIOOps(int32_t num_threads) {
+  if (FLAGS_maintenance_manager_max_high_io_ops > 0) {
+    return std::min(FLAGS_maintenance_manager_max_high_io_ops, num_threads);
+  }
+  return std::max(num_threads - 1, 1);
+}
+
+} // namespace
+
 MaintenanceOpStats::MaintenanceOpStats() {
   Clear();
 }
@@ -116,6 +133,7 @@ MaintenanceManager::MaintenanceManager(const Options& options)
       FLAGS_maintenance_manager_num_threads : options.num_threads),
     cond_(&lock_),
     shutdown_(false),
+    max_high_io_ops_(MaxHighIOOps(num_threads_)),
     running_ops_(0),
     polling_interval_ms_(options.polling_interval_ms <= 0 ?
           FLAGS_maintenance_manager_polling_interval_ms :
@@ -204,9 +222,14 @@ void MaintenanceManager::RunSchedulerThread() {
   MonoDelta polling_interval = MonoDelta::FromMilliseconds(polling_interval_ms_);
 
   std::unique_lock<Mutex> guard(lock_);
+  bool launched = false;
   while (true) {
-    // Loop until we are shutting down or it is time to run another op.
-    cond_.TimedWait(polling_interval);
+    // Loop until we are shutting down or it is time to run another op. Right after launching an
+    // op, look for another one to fill the remaining threads. Ops signal cond_ when they finish.
+    if (!launched) {
+      cond_.TimedWait(polling_interval);
+    }
+    launched = false;
     if (shutdown_) {
       VLOG_AND_TRACE("maintenance", 1) << "Shutting down maintenance manager.";
       return;
@@ -220,8 +243,10 @@ void MaintenanceManager::RunSchedulerThread() {
     }
 
     // Prepare the maintenance operation.
+    const bool high_io = op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE;
     op->running_++;
     running_ops_++;
+    running_high_io_ops_ += high_io;
     guard.unlock();
     bool ready = op->Prepare();
     guard.lock();
@@ -229,6 +254,8 @@ void MaintenanceManager::RunSchedulerThread() {
       LOG(INFO) << "Prepare failed for " << op->name()
                 << ".  Re-running scheduler.";
       op->running_--;
+      running_ops_--;
+      running_high_io_ops_ -= high_io;
       op->cond_->Signal();
       continue;
     }
@@ -236,6 +263,7 @@ void MaintenanceManager::RunSchedulerThread() {
     // Run the maintenance operation.
     Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
     CHECK(s.ok());
+    launched = true;
   }
 }
 
@@ -254,6 +282,9 @@ void MaintenanceManager::RunSchedulerThread() {
 //
 // In the third priority we're at a point where nothing's urgent and there's nothing we can run
 // quickly.
+//
+// Ops that are already running are not considered, and neither are high IO ops while the high
+// IO budget is used up, so the free threads go to the best op among the others.
 // TODO We currently optimize for freeing log retention but we could consider having some sort of
 // sliding priority between log retention and RAM usage. For example, is an Op that frees
 // 128MB of log retention and 12MB of RAM always better than an op that frees 12MB of log retention
@@ -269,6 +300,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     VLOG_AND_TRACE("maintenance", 1) << "there are no free threads, so we can't run anything.";
     return nullptr;
   }
+  const bool high_io_allowed = running_high_io_ops_ < max_high_io_ops_;
 
   int64_t low_io_most_logs_retained_bytes = 0;
   MaintenanceOp* low_io_most_logs_retained_bytes_op = nullptr;
@@ -291,6 +323,10 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     if (!stats.valid() || !stats.runnable()) {
       continue;
     }
+    if (op->running_ > 0 ||
+        (!high_io_allowed && op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE)) {
+      continue;
+    }
     if (stats.logs_retained_bytes() > low_io_most_logs_retained_bytes &&
         op->io_usage_ == MaintenanceOp::LOW_IO_USAGE) {
       low_io_most_logs_retained_bytes_op = op;
@@ -388,8 +424,11 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
 
   running_ops_--;
+  running_high_io_ops_ -= op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE;
   op->running_--;
   op->cond_->Signal();
+  // A thread is free, let the scheduler pick the next op right away.
+  cond_.Signal();
 }
 
 void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatusPB* out_pb) {
@@ -232,6 +232,10 @@ struct CompletedOp {
 // as flushes or compactions.  It runs these operations in the background, in a
 // thread pool.  It uses information provided in MaintenanceOpStats objects to
 // decide which operations, if any, to run.
+//
+// Several operations run at the same time when there are several threads, but at most
+// --maintenance_manager_max_high_io_ops of them are high IO, so that a long compaction-like
+// operation does not hold back low IO operations such as log GC.
 class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManager> {
  public:
   struct Options {
@@ -272,6 +276,8 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   void LaunchOp(MaintenanceOp* op);
 
   const int32_t num_threads_;
+  // Maximum number of high IO ops running at the same time.
+  const int32_t max_high_io_ops_;
   OpMapTy ops_; // registered operations
   Mutex lock_;
   scoped_refptr<yb::Thread> monitor_thread_;
@@ -279,6 +285,7 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   ConditionVariable cond_;
   bool shutdown_;
   uint64_t running_ops_;
+  int32_t running_high_io_ops_ = 0;
   int32_t polling_interval_ms_;
   // Vector used as a circular buffer for recently completed ops. Elements need to be added at
   // the completed_ops_count_ % the vector's size and then the count needs to be incremented.
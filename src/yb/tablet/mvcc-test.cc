@@ -237,5 +237,34 @@ TEST_F(MvccTest, WaitSafeTimestampToReadAt) {
   ASSERT_FALSE(manager_.SafeTime(ht3, MonoTime::Now() + 100ms, HybridTime::kMax));
 }
 
+TEST_F(MvccTest, ConcurrentSafeTime) {
+  constexpr size_t kTotalOperations = 100000;
+  constexpr size_t kReaders = 4;
+
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i != kReaders; ++i) {
+    readers.emplace_back([this, &stop] {
+      HybridTime last_safe_time = HybridTime::kMin;
+      while (!stop.load(std::memory_order_acquire)) {
+        // AddPending checks that it does not add operation before returned safe time.
+        auto safe_time = manager_.SafeTime();
+        ASSERT_GE(safe_time, last_safe_time);
+        last_safe_time = safe_time;
+      }
+    });
+  }
+
+  for (size_t i = 0; i != kTotalOperations; ++i) {
+    HybridTime ht;
+    manager_.AddPending(&ht);
+    manager_.Replicated(ht);
+  }
+  stop.store(true, std::memory_order_release);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
 } // namespace tablet
 } // namespace yb
@@ -38,6 +38,25 @@
 namespace yb {
 namespace tablet {
 
+namespace {
+
+// Marks modification of MvccManager state that is read by lock-free SafeTime.
+class StateChange {
+ public:
+  explicit StateChange(std::atomic<uint64_t>* seq_no) : seq_no_(*seq_no) {
+    seq_no_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  ~StateChange() {
+    seq_no_.fetch_add(1, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<uint64_t>& seq_no_;
+};
+
+} // namespace
+
 MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
     : prefix_(std::move(prefix)), clock_(std::move(clock)) {}
 
@@ -48,8 +67,9 @@ void MvccManager::Replicated(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty());
     CHECK_EQ(queue_.front(), ht);
+    StateChange state_change(&seq_no_);
     PopFront(&lock);
-    last_replicated_ = ht;
+    last_replicated_.store(ht, std::memory_order_release);
   }
   cond_.notify_all();
 }
@@ -61,6 +81,7 @@ void MvccManager::Aborted(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty());
     if (queue_.front() == ht) {
+      StateChange state_change(&seq_no_);
       PopFront(&lock);
     } else {
       aborted_.push(ht);
@@ -81,10 +102,15 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
     queue_.pop_front();
     aborted_.pop();
   }
+  queue_front_.store(queue_.empty() ? HybridTime::kInvalid : queue_.front(),
+                     std::memory_order_release);
 }
 
 void MvccManager::AddPending(HybridTime* ht) {
   std::lock_guard<std::mutex> lock(mutex_);
+  // Clock should be read after start of state change, so lock-free SafeTime that did not notice
+  // this change has read clock before us.
+  StateChange state_change(&seq_no_);
   if (!ht->is_valid()) {
     // ... otherwise this is a new transaction and we must assign a new hybrid_time. We assign
     // one in the present.
@@ -93,12 +119,14 @@ void MvccManager::AddPending(HybridTime* ht) {
   } else {
     VLOG_WITH_PREFIX(1) << "AddPending(" << *ht << ")";
   }
-  CHECK_GT(*ht, max_safe_time_returned_) << LogPrefix();
+  CHECK_GT(*ht, max_safe_time_returned_.load(std::memory_order_acquire)) << LogPrefix();
   CHECK_GT(*ht, max_safe_time_returned_for_follower_) << LogPrefix();
   if (!queue_.empty()) {
     CHECK_GT(*ht, queue_.back());
+  } else {
+    queue_front_.store(*ht, std::memory_order_release);
   }
-  CHECK_GT(*ht, last_replicated_);
+  CHECK_GT(*ht, last_replicated_.load(std::memory_order_relaxed));
   queue_.push_back(*ht);
 }
 
@@ -107,7 +135,8 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    last_replicated_ = ht;
+    StateChange state_change(&seq_no_);
+    last_replicated_.store(ht, std::memory_order_release);
   }
   cond_.notify_all();
 }
@@ -139,7 +168,7 @@ HybridTime MvccManager::SafeTimeForFollower(
   auto predicate = [this, &result, min_allowed] {
     // last_replicated_ is updated earlier than propagated_safe_time_, so because of
     // concurrency it could be greater than propagated_safe_time_.
-    result = std::max(propagated_safe_time_, last_replicated_);
+    result = std::max(propagated_safe_time_, last_replicated_.load(std::memory_order_relaxed));
     return result >= min_allowed;
   };
   if (deadline == MonoTime::kMax) {
@@ -157,10 +186,44 @@ HybridTime MvccManager::SafeTimeForFollower(
 HybridTime MvccManager::SafeTime(HybridTime min_allowed,
                                  MonoTime deadline,
                                  HybridTime max_allowed) const {
+  CHECK_LE(min_allowed, max_allowed);
+  // Readers don't need to wait for writers, unless safe time is less than min_allowed.
+  auto result = LockFreeSafeTime(max_allowed);
+  if (result.is_valid() && result >= min_allowed) {
+    VLOG_WITH_PREFIX(1) << "LockFreeSafeTime(" << min_allowed << ", "
+                        << max_allowed << "), result = " << result;
+    SafeTimeReturned(result);
+    return result;
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
   return DoGetSafeTime(min_allowed, deadline, max_allowed, &lock);
 }
 
+HybridTime MvccManager::LockFreeSafeTime(HybridTime max_allowed) const {
+  auto seq_no = seq_no_.load(std::memory_order_acquire);
+  if (seq_no & 1) {
+    return HybridTime::kInvalid;
+  }
+  auto front = queue_front_.load(std::memory_order_acquire);
+  auto last_replicated = last_replicated_.load(std::memory_order_acquire);
+  HybridTime result = front.is_valid() ? front.Decremented() : clock_->Now();
+  result = std::max(std::min(result, max_allowed), last_replicated);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (seq_no_.load(std::memory_order_relaxed) != seq_no) {
+    return HybridTime::kInvalid;
+  }
+  return result;
+}
+
+void MvccManager::SafeTimeReturned(HybridTime ht) const {
+  // Concurrent lock-free readers could return safe times in arbitrary order, so just track max.
+  auto max_returned = max_safe_time_returned_.load(std::memory_order_acquire);
+  while (max_returned < ht &&
+         !max_safe_time_returned_.compare_exchange_weak(max_returned, ht)) {
+  }
+}
+
 HybridTime MvccManager::DoGetSafeTime(HybridTime min_allowed,
                                       MonoTime deadline,
                                       HybridTime max_allowed,
@@ -181,7 +244,7 @@ HybridTime MvccManager::DoGetSafeTime(HybridTime min_allowed,
     result = std::min(result, max_allowed);
     // This function could be invoked at a follower, so it has a very old max_allowed.
     // In this case it is safe to read at last_replicated_ at least.
-    result = std::max(result, last_replicated_);
+    result = std::max(result, last_replicated_.load(std::memory_order_relaxed));
     return result >= min_allowed;
   };
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
@@ -193,15 +256,15 @@ HybridTime MvccManager::DoGetSafeTime(HybridTime min_allowed,
   }
   VLOG_WITH_PREFIX(1) << "DoGetSafeTime(" << min_allowed << ", "
                       << max_allowed << "), result = " << result;
-  CHECK_GE(result, max_safe_time_returned_) << LogPrefix();
-  max_safe_time_returned_ = result;
+  SafeTimeReturned(result);
   return result;
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
   std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << "LastReplicatedHybridTime(), result = " << last_replicated_;
-  return last_replicated_;
+  auto result = last_replicated_.load(std::memory_order_acquire);
+  VLOG_WITH_PREFIX(1) << "LastReplicatedHybridTime(), result = " << result;
+  return result;
 }
 
 }  // namespace tablet
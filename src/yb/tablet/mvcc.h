@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -114,6 +115,12 @@ class MvccManager {
                            HybridTime max_allowed,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Calculates safe time without acquiring mutex. Returns invalid hybrid time if state was
+  // concurrently modified.
+  HybridTime LockFreeSafeTime(HybridTime max_allowed) const;
+
+  void SafeTimeReturned(HybridTime ht) const;
+
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
 
@@ -126,9 +133,16 @@ class MvccManager {
   // Priority queue of aborted operations. Required because we could abort operations from the
   // middle of the queue.
   std::priority_queue<HybridTime, std::vector<HybridTime>, std::greater<>> aborted_;
-  HybridTime last_replicated_ = HybridTime::kMin;
   HybridTime propagated_safe_time_ = HybridTime::kMin;
-  mutable HybridTime max_safe_time_returned_ = HybridTime::kMin;
+
+  // State used by SafeTime is modified under mutex_, but also read without it. seq_no_ is odd
+  // while such modification is in progress, so lock-free reader could detect it and retry.
+  std::atomic<uint64_t> seq_no_{0};
+  // Front of queue_ or invalid hybrid time if queue_ is empty.
+  std::atomic<HybridTime> queue_front_{HybridTime::kInvalid};
+  std::atomic<HybridTime> last_replicated_{HybridTime::kMin};
+
+  mutable std::atomic<HybridTime> max_safe_time_returned_{HybridTime::kMin};
   mutable HybridTime max_safe_time_returned_for_follower_ = HybridTime::kMin;
 };
 
@@ -38,11 +38,13 @@
 #include "yb/consensus/consensus.h"
 #include "yb/gutil/strings/strcat.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_tracker.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/logging.h"
+#include "yb/util/profiling_context.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 
@@ -58,6 +60,16 @@ using consensus::DriverType;
 using log::Log;
 using server::Clock;
 
+namespace {
+
+// Returns the tablet to attribute the work on an operation to, empty if it has no tablet.
+const std::string& ProfilingTabletId(const OperationState* state) {
+  static const std::string kNoTablet;
+  return state->tablet() != nullptr ? state->tablet()->tablet_id() : kNoTablet;
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////////
 // OperationDriver
 ////////////////////////////////////////////////////////////
@@ -185,6 +197,7 @@ void OperationDriver::PrepareAndStartTask() {
 
 Status OperationDriver::PrepareAndStart() {
   ADOPT_TRACE(trace());
+  ScopedProfilingContext profiling_context("PrepareOperation", ProfilingTabletId(state()));
   TRACE_EVENT1("operation", "PrepareAndStart", "operation", this);
   VLOG_WITH_PREFIX(4) << "PrepareAndStart()";
   // Actually prepare and start the operation.
@@ -232,6 +245,7 @@ Status OperationDriver::PrepareAndStart() {
         std::lock_guard<simple_spinlock> lock(lock_);
         replication_state_ = REPLICATING;
       }
+      replication_start_time_ = MonoTime::Now();
 
       // After the batching changes from 07/2017, It is the caller's responsibility to call
       // Consensus::Replicate. See PrepareThread for details.
@@ -329,6 +343,13 @@ void OperationDriver::ReplicationFinished(const Status& status) {
     prepare_state_copy = prepare_state_;
   }
 
+  if (status.ok() && replication_start_time_.Initialized() &&
+      operation_type() == Operation::WRITE_TXN && state()->tablet() &&
+      state()->tablet()->metrics()) {
+    state()->tablet()->metrics()->write_replication_latency->Increment(
+        MonoTime::Now().GetDeltaSince(replication_start_time_).ToMicroseconds());
+  }
+
   // If we have prepared and replicated, we're ready to move ahead and apply this operation.
   // Note that if we set the state to REPLICATION_FAILED above, ApplyAsync() will actually abort the
   // operation, i.e. ApplyTask() will never be called and the operation will never be applied to
@@ -379,7 +400,9 @@ Status OperationDriver::ApplyAsync() {
 
   TRACE_EVENT_FLOW_BEGIN0("operation", "ApplyTask", this);
   // Key-value tables backed by RocksDB require that we apply changes synchronously to enforce
-  // the order.
+  // the order. Operations of different tablets are already applied concurrently, because each
+  // tablet has its own Raft update path, and on followers the prepares of incoming operations are
+  // enqueued before the WAL append, so they overlap with it.
   ApplyTask();
   return Status::OK();
 }
@@ -387,6 +410,7 @@ Status OperationDriver::ApplyAsync() {
 void OperationDriver::ApplyTask() {
   TRACE_EVENT_FLOW_END0("operation", "ApplyTask", this);
   ADOPT_TRACE(trace());
+  ScopedProfilingContext profiling_context("ApplyOperation", ProfilingTabletId(state()));
 
 #ifndef NDEBUG
   {
@@ -39,6 +39,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/walltime.h"
 #include "yb/tablet/operations/operation.h"
+#include "yb/tablet/operations/operation_tracker.h"
 #include "yb/util/status.h"
 #include "yb/util/trace.h"
 
@@ -201,6 +202,7 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
 
  private:
   friend class RefCountedThreadSafe<OperationDriver>;
+  friend class OperationTracker;
   enum ReplicationState {
     // The operation has not yet been sent to consensus for replication
     NOT_REPLICATING,
@@ -284,8 +286,14 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // This is used for debugging only, not any actual operation ordering.
   MicrosecondsInt64 prepare_physical_hybrid_time_;
 
+  // When the leader handed the operation over to be replicated, uninitialized on followers.
+  MonoTime replication_start_time_;
+
   TableType table_type_;
 
+  // Links the driver into operation_tracker_ while it is pending. Protected by the tracker.
+  OperationTrackerEntry tracker_entry_;
+
   DISALLOW_COPY_AND_ASSIGN(OperationDriver);
 };
 
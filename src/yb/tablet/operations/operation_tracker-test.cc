@@ -31,6 +31,7 @@
 //
 
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -203,6 +204,41 @@ static void CheckMetrics(const scoped_refptr<MetricEntity>& entity,
       entity->FindOrNull(METRIC_operation_memory_pressure_rejections).get())->value());
 }
 
+// Operations are added and released from many threads, so they land in and leave different shards.
+TEST_F(OperationTrackerTest, TestConcurrentAddAndRelease) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumOperations = 200;
+  std::vector<std::thread> threads;
+  std::vector<vector<scoped_refptr<OperationDriver>>> drivers(kNumThreads);
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([this, &drivers, i] {
+      ASSERT_OK(AddDrivers(kNumOperations, &drivers[i]));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(kNumThreads * kNumOperations, tracker_.GetNumPendingForTests());
+  ASSERT_EQ(kNumThreads * kNumOperations, tracker_.GetPendingOperations().size());
+  ASSERT_NO_FATALS(CheckMetrics(entity_, kNumThreads * kNumOperations, 0, 0));
+
+  threads.clear();
+  for (int i = 0; i != kNumThreads; ++i) {
+    // Release the operations added by another thread.
+    threads.emplace_back([&drivers, i] {
+      for (const auto& driver : drivers[(i + 1) % kNumThreads]) {
+        driver->Abort(STATUS(Aborted, ""));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, tracker_.GetNumPendingForTests());
+  ASSERT_TRUE(tracker_.GetPendingOperations().empty());
+  ASSERT_NO_FATALS(CheckMetrics(entity_, 0, 0, 0));
+}
+
 // Basic testing for metrics. Note that the NoOpOperations we use in this
 // test are all write operations.
 TEST_F(OperationTrackerTest, TestMetrics) {
@@ -211,6 +247,8 @@ TEST_F(OperationTrackerTest, TestMetrics) {
   vector<scoped_refptr<OperationDriver> > drivers;
   ASSERT_OK(AddDrivers(3, &drivers));
   ASSERT_NO_FATALS(CheckMetrics(entity_, 3, 0, 0));
+  ASSERT_EQ(3, tracker_.GetNumPending(Operation::WRITE_TXN));
+  ASSERT_EQ(0, tracker_.GetNumPending(Operation::ALTER_SCHEMA_TXN));
 
   drivers[0]->Abort(STATUS(Aborted, ""));
   ASSERT_NO_FATALS(CheckMetrics(entity_, 2, 0, 0));
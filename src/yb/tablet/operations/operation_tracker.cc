@@ -34,11 +34,12 @@
 
 #include <algorithm>
 #include <limits>
+#include <thread>
 #include <vector>
 
 
-#include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_driver.h"
@@ -115,16 +116,13 @@ OperationTracker::Metrics::Metrics(const scoped_refptr<MetricEntity>& entity)
 #undef GINIT
 #undef MINIT
 
-OperationTracker::State::State()
-  : memory_footprint(0) {
-}
-
-OperationTracker::OperationTracker() {
+OperationTracker::OperationTracker()
+    : num_shards_(base::MaxCPUIndex() + 1),
+      shards_(new Shard[num_shards_]) {
 }
 
 OperationTracker::~OperationTracker() {
-  std::lock_guard<simple_spinlock> l(lock_);
-  CHECK_EQ(pending_operations_.size(), 0);
+  CHECK_EQ(GetNumPending(), 0);
   if (mem_tracker_) {
     mem_tracker_->UnregisterFromParent();
   }
@@ -153,15 +151,30 @@ Status OperationTracker::Add(OperationDriver* driver) {
 
   IncrementCounters(*driver);
 
-  // Cache the operation memory footprint so we needn't refer to the request
-  // again, as it may disappear between now and then.
-  State st;
-  st.memory_footprint = driver_mem_footprint;
-  std::lock_guard<simple_spinlock> l(lock_);
-  CHECK(pending_operations_.emplace(driver, st).second);
+  auto& entry = driver->tracker_entry_;
+  auto& shard = ShardForCurrentCpu();
+  entry.driver = driver;
+  entry.shard = &shard - shards_.get();
+  entry.memory_footprint = driver_mem_footprint;
+  // Released in Release().
+  driver->AddRef();
+  std::lock_guard<simple_spinlock> l(shard.lock);
+  CHECK(!entry.is_linked()) << "Operation added twice: " << driver->ToStringUnlocked();
+  shard.operations.push_back(entry);
+  num_pending_[driver->operation_type()].fetch_add(1, std::memory_order_acq_rel);
   return Status::OK();
 }
 
+OperationTracker::Shard& OperationTracker::ShardForCurrentCpu() {
+#if defined(__APPLE__)
+  // OSX doesn't have a way to get the CPU, so we'll pick a shard by thread.
+  size_t cpu = std::hash<std::thread::id>()(std::this_thread::get_id());
+#else
+  size_t cpu = sched_getcpu();
+#endif // defined(__APPLE__)
+  return shards_[cpu % num_shards_];
+}
+
 void OperationTracker::IncrementCounters(const OperationDriver& driver) const {
   if (!metrics_) {
     return;
@@ -185,38 +198,46 @@ void OperationTracker::DecrementCounters(const OperationDriver& driver) const {
 void OperationTracker::Release(OperationDriver* driver) {
   DecrementCounters(*driver);
 
-  State st;
+  auto& entry = driver->tracker_entry_;
   {
-    // Remove the operation from the map, retaining the state for use
-    // below.
-    std::lock_guard<simple_spinlock> l(lock_);
-    st = FindOrDie(pending_operations_, driver);
-    if (PREDICT_FALSE(pending_operations_.erase(driver) != 1)) {
-      LOG(FATAL) << "Could not remove pending operation from map: "
-          << driver->ToStringUnlocked();
+    auto& shard = shards_[entry.shard];
+    std::lock_guard<simple_spinlock> l(shard.lock);
+    if (PREDICT_FALSE(!entry.is_linked())) {
+      LOG(FATAL) << "Could not remove pending operation: " << driver->ToStringUnlocked();
     }
+    shard.operations.erase(shard.operations.iterator_to(entry));
+    num_pending_[driver->operation_type()].fetch_sub(1, std::memory_order_acq_rel);
   }
 
   if (mem_tracker_) {
-    mem_tracker_->Release(st.memory_footprint);
+    mem_tracker_->Release(entry.memory_footprint);
   }
+  // The reference taken in Add(), the driver could be deleted now.
+  driver->Release();
 }
 
 std::vector<scoped_refptr<OperationDriver>> OperationTracker::GetPendingOperations() const {
   std::vector<scoped_refptr<OperationDriver>> result;
-  {
-    std::lock_guard<simple_spinlock> l(lock_);
-    result.reserve(pending_operations_.size());
-    for (const auto& e : pending_operations_) {
-      result.push_back(e.first);
+  for (size_t i = 0; i != num_shards_; ++i) {
+    auto& shard = shards_[i];
+    std::lock_guard<simple_spinlock> l(shard.lock);
+    for (const auto& entry : shard.operations) {
+      result.emplace_back(entry.driver);
     }
   }
   return result;
 }
 
-int OperationTracker::GetNumPendingForTests() const {
-  std::lock_guard<simple_spinlock> l(lock_);
-  return pending_operations_.size();
+int OperationTracker::GetNumPending() const {
+  int result = 0;
+  for (const auto& num_pending : num_pending_) {
+    result += num_pending.load(std::memory_order_acquire);
+  }
+  return result;
+}
+
+int OperationTracker::GetNumPending(Operation::OperationType type) const {
+  return num_pending_[type].load(std::memory_order_acquire);
 }
 
 void OperationTracker::WaitForAllToFinish() const {
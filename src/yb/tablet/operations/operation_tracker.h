@@ -33,12 +33,16 @@
 #ifndef YB_TABLET_OPERATIONS_OPERATION_TRACKER_H
 #define YB_TABLET_OPERATIONS_OPERATION_TRACKER_H
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include <boost/intrusive/list.hpp>
+
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/gutil/port.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/tablet/operations/operation.h"
 #include "yb/util/locks.h"
@@ -54,9 +58,23 @@ class MetricEntity;
 namespace tablet {
 class OperationDriver;
 
+// What the tracker keeps about a tracked operation. It is embedded in the driver, so that tracking
+// an operation does not allocate.
+struct OperationTrackerEntry : public boost::intrusive::list_base_hook<> {
+  OperationDriver* driver = nullptr;
+  // The shard of the tracker the operation is linked into.
+  size_t shard = 0;
+  // Approximate memory footprint of the operation, cached as the request may be gone by the time
+  // the operation is released.
+  int64_t memory_footprint = 0;
+};
+
 // Each TabletPeer has a OperationTracker which keeps track of pending operations.
 // Each "LeaderOperation" will register itself by calling Add().
 // It will remove itself by calling Release().
+//
+// Operations are linked into per-CPU shards, so that concurrent Add() and Release() calls rarely
+// touch the same lock or cache line.
 class OperationTracker {
  public:
   OperationTracker();
@@ -76,7 +94,14 @@ class OperationTracker {
   std::vector<scoped_refptr<OperationDriver>> GetPendingOperations() const;
 
   // Returns number of pending operations.
-  int GetNumPendingForTests() const;
+  int GetNumPending() const;
+
+  // Returns number of pending operations of the given type.
+  int GetNumPending(Operation::OperationType type) const;
+
+  int GetNumPendingForTests() const {
+    return GetNumPending();
+  }
 
   void WaitForAllToFinish() const;
   CHECKED_STATUS WaitForAllToFinish(const MonoDelta& timeout) const;
@@ -100,23 +125,22 @@ class OperationTracker {
   // Decrements relevant metric counters.
   void DecrementCounters(const OperationDriver& driver) const;
 
-  mutable simple_spinlock lock_;
+  typedef boost::intrusive::list<
+      OperationTrackerEntry, boost::intrusive::constant_time_size<false>> OperationList;
 
-  // Per-operation state that is tracked along with the operation itself.
-  struct State {
-    State();
+  struct Shard {
+    simple_spinlock lock;
+    // The tracker holds a reference to each of these drivers. Protected by 'lock'.
+    OperationList operations;
+  } CACHELINE_ALIGNED;
 
-    // Approximate memory footprint of the operation.
-    int64_t memory_footprint;
-  };
+  Shard& ShardForCurrentCpu();
+
+  const size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
 
-  // Protected by 'lock_'.
-  typedef std::unordered_map<
-      scoped_refptr<OperationDriver>,
-      State,
-      ScopedRefPtrHashFunctor,
-      ScopedRefPtrEqualsFunctor> OperationMap;
-  OperationMap pending_operations_;
+  // Number of pending operations of each type, so that counting does not need the shard locks.
+  std::array<std::atomic<int>, Operation::kOperationTypes> num_pending_{};
 
   gscoped_ptr<Metrics> metrics_;
 
@@ -183,6 +183,7 @@ void WriteOperationState::Commit() {
 void WriteOperationState::ReleaseDocDbLocks(Tablet* tablet) {
   // Free DocDB multi-level locks.
   docdb_locks_.Reset();
+  merged_docdb_locks_.clear();
 }
 
 WriteOperationState::~WriteOperationState() {
@@ -138,6 +138,20 @@ class WriteOperationState : public OperationState {
     docdb_locks_ = std::move(docdb_locks);
   }
 
+  // Moves the DocDB locks out of this object, for them to be released by the operation that
+  // replicates this write merged with others.
+  LockBatch TakeDocDBLocks() {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    return std::move(docdb_locks_);
+  }
+
+  // Adds the locks of a write merged into this operation, they are released along with the own
+  // locks of this operation.
+  void AddDocDBLocks(LockBatch&& docdb_locks) {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    merged_docdb_locks_.push_back(std::move(docdb_locks));
+  }
+
   // Releases all the DocDB locks acquired by this transaction.
   void ReleaseDocDbLocks(Tablet* tablet);
 
@@ -169,6 +183,9 @@ class WriteOperationState : public OperationState {
   // or if an error happens.
   LockBatch docdb_locks_;
 
+  // The locks of the writes merged into this operation.
+  std::vector<LockBatch> merged_docdb_locks_;
+
   DISALLOW_COPY_AND_ASSIGN(WriteOperationState);
 };
 
@@ -21,6 +21,8 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/util/cpu_affinity.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/tablet/prepare_thread.h"
 #include "yb/tablet/operations/operation_driver.h"
@@ -39,6 +41,12 @@ DEFINE_int32(max_group_replicate_batch_size, 16,
 DEFINE_int32(prepare_queue_max_size, 100000,
              "Maximum number of operations waiting in the per-tablet prepare queue.");
 
+DEFINE_bool(pin_prepare_threads_to_numa_nodes, false,
+            "Run the prepare thread of each tablet on the CPUs of a single NUMA node, picked by "
+            "tablet id, to avoid moving the data of an operation across nodes.");
+TAG_FLAG(pin_prepare_threads_to_numa_nodes, advanced);
+TAG_FLAG(pin_prepare_threads_to_numa_nodes, experimental);
+
 using std::vector;
 
 namespace yb {
@@ -49,7 +57,7 @@ namespace tablet {
 
 class PrepareThreadImpl {
  public:
-  explicit PrepareThreadImpl(consensus::Consensus* consensus);
+  PrepareThreadImpl(consensus::Consensus* consensus, std::string affinity_key);
   ~PrepareThreadImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -63,6 +71,8 @@ class PrepareThreadImpl {
 
   consensus::Consensus* const consensus_;
 
+  const std::string affinity_key_;
+
   // We set this to true to to tell the thread to shut down. No new tasks will be accepted, but
   // existing tasks will still be processed.
   std::atomic<bool> stop_requested_{false};
@@ -115,8 +125,9 @@ class PrepareThreadImpl {
                          std::unique_lock<std::mutex>* lock);
 };
 
-PrepareThreadImpl::PrepareThreadImpl(consensus::Consensus* consensus)
+PrepareThreadImpl::PrepareThreadImpl(consensus::Consensus* consensus, std::string affinity_key)
     : consensus_(consensus),
+      affinity_key_(std::move(affinity_key)),
       queue_(FLAGS_prepare_queue_max_size) {
 }
 
@@ -196,6 +207,10 @@ Status PrepareThreadImpl::Submit(OperationDriver* operation_driver) {
 }
 
 void PrepareThreadImpl::Run() {
+  if (FLAGS_pin_prepare_threads_to_numa_nodes && !affinity_key_.empty()) {
+    WARN_NOT_OK(SetCurrentThreadCpuAffinity(NumaNodeForKey(affinity_key_).cpus),
+                "Failed to pin the prepare thread");
+  }
   for (;;) {
     {
       // Logic for waiting (most common) and stopping (happens once on tablet shutdown).
@@ -358,8 +373,8 @@ void PrepareThreadImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // PrepareThread
 
-PrepareThread::PrepareThread(consensus::Consensus* consensus)
-    : impl_(std::make_unique<PrepareThreadImpl>(consensus)) {
+PrepareThread::PrepareThread(consensus::Consensus* consensus, std::string affinity_key)
+    : impl_(std::make_unique<PrepareThreadImpl>(consensus, std::move(affinity_key))) {
 }
 
 PrepareThread::~PrepareThread() = default;
@@ -14,6 +14,8 @@
 #ifndef YB_TABLET_PREPARE_THREAD_H
 #define YB_TABLET_PREPARE_THREAD_H
 
+#include <string>
+
 #include <gflags/gflags.h>
 
 #include "yb/util/status.h"
@@ -36,9 +38,14 @@ class PrepareThreadImpl;
 // This is a thread that invokes the "prepare" step on single-shard transactions and, for
 // leader-side transactions, submits them for replication to the consensus in batches. This is
 // useful because we have a "fat lock" in the consensus.
+//
+// With --pin_prepare_threads_to_numa_nodes, the thread only runs on the CPUs of a NUMA node picked
+// by affinity_key, so that the operations of a tablet are prepared on the same node, close to the
+// memory they were allocated in.
 class PrepareThread {
  public:
-  explicit PrepareThread(consensus::Consensus* consensus);
+  explicit PrepareThread(consensus::Consensus* consensus,
+                         std::string affinity_key = std::string());
   ~PrepareThread();
 
   CHECKED_STATUS Start();
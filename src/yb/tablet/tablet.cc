@@ -60,11 +60,14 @@
 
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_util.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/lock_batch.h"
@@ -74,6 +77,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/walltime.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
@@ -118,6 +122,25 @@ DEFINE_double(tablet_bloom_target_fp_rate, 0.01f,
               "required for bloom filters.");
 TAG_FLAG(tablet_bloom_target_fp_rate, advanced);
 
+DEFINE_int32(txn_max_apply_batch_records, 100000,
+             "Max number of records written in one RocksDB write batch while applying intents of "
+             "a transaction. Bigger transactions are applied in several batches.");
+TAG_FLAG(txn_max_apply_batch_records, advanced);
+
+DEFINE_int32(hot_key_sample_1_in_n, 16,
+             "Record the keys of one in this many reads and writes of each thread to find the "
+             "hottest hash partition keys of tablets. 0 disables it.");
+TAG_FLAG(hot_key_sample_1_in_n, advanced);
+TAG_FLAG(hot_key_sample_1_in_n, runtime);
+
+DEFINE_int32(hot_key_decay_sec, 60,
+             "How often the access counts of tablet keys are halved, so that the hot keys "
+             "reported follow the recent workload.");
+TAG_FLAG(hot_key_decay_sec, advanced);
+TAG_FLAG(hot_key_decay_sec, runtime);
+
+DECLARE_int32(docdb_prefix_lock_min_keys);
+
 METRIC_DEFINE_entity(tablet);
 
 using namespace std::placeholders;
@@ -335,6 +358,9 @@ Tablet::Tablet(
 
   flush_stats_ = make_shared<TabletFlushStats>();
   tablet_options_.listeners.emplace_back(flush_stats_);
+  // Taken when the tablet is opened, so altering the priority applies to tablets opened later.
+  tablet_options_.cache_priority = schema()->table_properties().cache_priority();
+  tablet_options_.in_memory = schema()->table_properties().in_memory();
 }
 
 Tablet::~Tablet() {
@@ -439,7 +465,9 @@ void Tablet::Shutdown() {
   }
 
   std::lock_guard<rw_spinlock> lock(component_lock_);
-  // Shutdown the RocksDB instance for this table, if present.
+  // Shutdown the RocksDB instance for this table, if present. Iterators cached by the QL storage
+  // must go first.
+  ql_storage_.reset();
   rocksdb_.reset();
   state_ = kShutdown;
 }
@@ -471,6 +499,94 @@ Result<std::unique_ptr<common::QLRowwiseIteratorIf>> Tablet::NewRowIterator(
   return std::move(result);
 }
 
+Result<std::unique_ptr<common::QLRowwiseIteratorIf>> Tablet::NewRowIterator(
+    const Schema &projection, const ReadHybridTime& read_time, int32_t min_hash_code,
+    int32_t max_hash_code) const {
+  if (state_ != kOpen) {
+    return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
+  }
+
+  if (table_type_ != TableType::YQL_TABLE_TYPE) {
+    return STATUS_FORMAT(NotSupported, "Invalid table type: $0", table_type_);
+  }
+
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  auto mapped_projection = std::make_unique<Schema>();
+  RETURN_NOT_OK(schema()->GetMappedReadProjection(projection, mapped_projection.get()));
+
+  // Without hashed components, the hash codes bound the scan as in a scan by token.
+  const std::vector<PrimitiveValue> hashed_components;
+  const docdb::DocQLScanSpec spec(
+      *schema(), min_hash_code, max_hash_code, hashed_components, nullptr /* req */,
+      rocksdb::kDefaultQueryId);
+  auto result = std::make_unique<DocRowwiseIterator>(
+      std::move(mapped_projection), *schema(), CreateTransactionOperationContext(boost::none),
+      rocksdb_.get(), read_time, &pending_op_counter_);
+  RETURN_NOT_OK(result->Init(spec));
+  return std::move(result);
+}
+
+Status Tablet::BackfillIndex(const IndexInfo& index, const HybridTime read_ht,
+                             const std::string& start_key, const size_t max_rows,
+                             std::vector<QLWriteRequestPB>* index_requests,
+                             std::string* next_key) {
+  if (table_type_ != TableType::YQL_TABLE_TYPE) {
+    return STATUS_FORMAT(NotSupported, "Invalid table type: $0", table_type_);
+  }
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+  // Keeps the history at read_ht from being garbage collected while it is read.
+  ScopedReadOperation read_operation(
+      this, RequireLease::kFalse, ReadHybridTime::SingleTime(read_ht));
+
+  // The key columns are read from the DocKeys, so only the others are projected.
+  const Schema& schema = *this->schema();
+  std::vector<ColumnId> column_ids;
+  for (const auto& index_column : index.columns()) {
+    const int column_idx = schema.find_column_by_id(index_column.indexed_column_id);
+    if (column_idx != Schema::kColumnNotFound && !schema.is_key_column(column_idx)) {
+      column_ids.push_back(index_column.indexed_column_id);
+    }
+  }
+  Schema projection;
+  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_ids, &projection));
+  auto mapped_projection = std::make_unique<Schema>();
+  RETURN_NOT_OK(schema.GetMappedReadProjection(projection, mapped_projection.get()));
+
+  DocKey start_doc_key;
+  if (!start_key.empty()) {
+    RETURN_NOT_OK(start_doc_key.FullyDecodeFrom(start_key));
+  }
+  const docdb::DocQLScanSpec spec(
+      schema, -1 /* hash_code */, -1 /* max_hash_code */, {} /* hashed_components */,
+      nullptr /* req */, rocksdb::kDefaultQueryId, true /* is_forward_scan */,
+      false /* include_static_columns */, start_doc_key);
+  DocRowwiseIterator iter(
+      std::move(mapped_projection), schema, CreateTransactionOperationContext(boost::none),
+      rocksdb_.get(), read_operation.read_time(), &pending_op_counter_);
+  RETURN_NOT_OK(iter.Init(spec));
+
+  size_t num_rows = 0;
+  for (; num_rows < max_rows && iter.HasNext(); ++num_rows) {
+    QLTableRow row;
+    RETURN_NOT_OK(iter.NextRow(&row));
+    QLWriteRequestPB index_request;
+    if (docdb::IndexInsertRequestForRow(index, row, &index_request)) {
+      index_request.set_backfill_hybrid_time(read_ht.ToUint64());
+      index_requests->push_back(std::move(index_request));
+    }
+  }
+  next_key->clear();
+  if (iter.HasNext()) {
+    *next_key = iter.row_key().Encode().data();
+  }
+  VLOG(1) << "Backfilled " << num_rows << " rows of tablet " << tablet_id() << " into index "
+          << index.table_id() << " at " << read_ht;
+  return Status::OK();
+}
+
 void Tablet::StartOperation(WriteOperationState* operation_state) {
   // If the state already has a hybrid_time then we're replaying a transaction that occurred
   // before a crash or at another node...
@@ -483,6 +599,11 @@ void Tablet::StartOperation(WriteOperationState* operation_state) {
 }
 
 void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
+  if (witness_) {
+    // The data replicas have the write. Leaving last_committed_write_index_ alone lets the log be
+    // garbage collected up to the committed op id, as nothing will ever be flushed here.
+    return;
+  }
   last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
   const KeyValueWriteBatchPB& put_batch =
       operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
@@ -581,8 +702,14 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
 
+  MarkAccessed();
   flush_stats_->AboutToWriteToDb(hybrid_time);
+  const MonoTime write_start_time = metrics_ ? MonoTime::Now() : MonoTime();
   auto rocksdb_write_status = rocksdb_->Write(write_options, rocksdb_write_batch);
+  if (metrics_) {
+    metrics_->write_apply_latency->Increment(
+        MonoTime::Now().GetDeltaSince(write_start_time).ToMicroseconds());
+  }
   if (!rocksdb_write_status.ok()) {
     LOG(FATAL) << "Failed to write a batch with " << rocksdb_write_batch->Count() << " operations"
                << " into RocksDB: " << rocksdb_write_status.ToString();
@@ -634,6 +761,39 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data)
   return Status::OK();
 }
 
+namespace {
+
+// Returns the weight to record the keys of the current request with, 0 if they shouldn't be.
+int HotKeySampleWeight() {
+  static __thread uint32_t requests_since_sampled = 0;
+  const int sample_1_in_n = FLAGS_hot_key_sample_1_in_n;
+  if (sample_1_in_n <= 0 || ++requests_since_sampled < static_cast<uint32_t>(sample_1_in_n)) {
+    return 0;
+  }
+  requests_since_sampled = 0;
+  return sample_1_in_n;
+}
+
+} // namespace
+
+void Tablet::RecordHotKey(const Slice& encoded_doc_key, int weight) {
+  auto hashed_part_size = docdb::DocKey::EncodedSize(
+      encoded_doc_key, docdb::DocKeyPart::HASHED_PART_ONLY);
+  const size_t key_size = hashed_part_size.ok() && *hashed_part_size != 0
+      ? *hashed_part_size : encoded_doc_key.size();
+
+  const MicrosecondsInt64 now = GetMonoTimeMicros();
+  int64_t next_decay = hot_keys_next_decay_.load(std::memory_order_relaxed);
+  if (now >= next_decay && hot_keys_next_decay_.compare_exchange_strong(
+          next_decay, now + std::max(FLAGS_hot_key_decay_sec, 1) * 1000000LL)) {
+    if (metrics_) {
+      metrics_->hottest_key_ops->set_value(hot_keys_.MaxCount());
+    }
+    hot_keys_.Decay();
+  }
+  hot_keys_.Add(Slice(encoded_doc_key.data(), key_size), weight);
+}
+
 Status Tablet::HandleRedisReadRequest(const ReadHybridTime& read_time,
                                       const RedisReadRequestPB& redis_read_request,
                                       RedisResponsePB* response) {
@@ -641,8 +801,19 @@ Status Tablet::HandleRedisReadRequest(const ReadHybridTime& read_time,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  ScopedReadStatsTracker read_stats_tracker(metrics_.get());
+  MarkAccessed();
+
+  const int hot_key_weight = HotKeySampleWeight();
+  if (hot_key_weight != 0 && redis_read_request.key_value().has_key()) {
+    const auto& key_value = redis_read_request.key_value();
+    RecordHotKey(
+        docdb::DocKey::FromRedisKey(key_value.hash_code(), key_value.key()).Encode().AsSlice(),
+        hot_key_weight);
+  }
 
-  docdb::RedisReadOperation doc_op(redis_read_request, rocksdb_.get(), read_time);
+  docdb::RedisReadOperation doc_op(
+      redis_read_request, rocksdb_.get(), read_time, &metadata()->partition());
   RETURN_NOT_OK(doc_op.Execute());
   *response = std::move(doc_op.response());
   return Status::OK();
@@ -656,12 +827,27 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  ScopedReadStatsTracker read_stats_tracker(metrics_.get());
+  MarkAccessed();
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     return Status::OK();
   }
 
+  const int hot_key_weight = HotKeySampleWeight();
+  if (hot_key_weight != 0 && ql_read_request.hashed_column_values_size() != 0) {
+    const Schema& schema = metadata_->schema();
+    vector<docdb::PrimitiveValue> hashed_components;
+    if (docdb::QLKeyColumnValuesToPrimitiveValues(
+            ql_read_request.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
+            &hashed_components).ok()) {
+      RecordHotKey(
+          docdb::DocKey(ql_read_request.hash_code(), hashed_components).Encode().AsSlice(),
+          hot_key_weight);
+    }
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
@@ -726,14 +912,20 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(data.write_request()->write_batch().transaction());
   RETURN_NOT_OK(txn_op_ctx);
+  // The write ops compute the index updates while being applied below.
+  const IndexMap index_map = metadata_->index_map();
+  HybridTime backfill_ht;
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
+    if (req->has_backfill_hybrid_time() || backfill_ht.is_valid()) {
+      RETURN_NOT_OK(CheckBackfillWrite(*req, i == 0, data, &backfill_ht));
+    }
     QLResponsePB* resp = data.operation_state->response()->add_ql_response_batch();
     if (metadata_->schema_version() != req->schema_version()) {
       resp->set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     } else {
       const auto& schema = metadata_->schema();
-      auto write_op = std::make_unique<QLWriteOperation>(schema, *txn_op_ctx);
+      auto write_op = std::make_unique<QLWriteOperation>(schema, *txn_op_ctx, &index_map);
       RETURN_NOT_OK(write_op->Init(req, resp));
       doc_ops.emplace_back(std::move(write_op));
     }
@@ -742,11 +934,18 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   if (data.restart_read_ht->is_valid()) {
     return Status::OK();
   }
+  if (backfill_ht.is_valid()) {
+    // Applied like the pairs of an external write batch, each with its own hybrid time.
+    for (auto& kv_pair : *data.write_request()->mutable_write_batch()->mutable_kv_pairs()) {
+      kv_pair.set_external_hybrid_time(backfill_ht.ToUint64());
+    }
+  }
   for (size_t i = 0; i < doc_ops.size(); i++) {
     QLWriteOperation* ql_write_op = down_cast<QLWriteOperation*>(doc_ops[i].get());
     // If the QL write op returns a rowblock, move the op to the transaction state to return the
-    // rows data as a sidecar after the transaction completes.
-    if (ql_write_op->rowblock() != nullptr) {
+    // rows data as a sidecar after the transaction completes. Likewise for the index updates that
+    // are written once the transaction completes.
+    if (ql_write_op->rowblock() != nullptr || !ql_write_op->index_requests().empty()) {
       doc_ops[i].release();
       data.operation_state->ql_write_ops()->emplace_back(unique_ptr<QLWriteOperation>(ql_write_op));
     }
@@ -755,11 +954,37 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   return Status::OK();
 }
 
+Status Tablet::CheckBackfillWrite(const QLWriteRequestPB& req, const bool first,
+                                  const WriteOperationData& data, HybridTime* backfill_ht) {
+  if (first) {
+    *backfill_ht = HybridTime(req.backfill_hybrid_time());
+  }
+  if (!req.has_backfill_hybrid_time() || req.backfill_hybrid_time() != backfill_ht->ToUint64()) {
+    return STATUS(InvalidArgument, "All the writes of an index backfill batch should have the "
+                                   "same backfill hybrid time");
+  }
+  if (req.type() != QLWriteRequestPB::QL_STMT_INSERT || req.has_if_expr() ||
+      data.write_request()->write_batch().has_transaction()) {
+    return STATUS(InvalidArgument, "Index backfill writes should be non-transactional inserts");
+  }
+  if (*backfill_ht > clock_->Now()) {
+    return STATUS_FORMAT(InvalidArgument, "Backfill hybrid time $0 is in the future",
+                         *backfill_ht);
+  }
+  return Status::OK();
+}
+
 Status Tablet::AcquireLocksAndPerformDocOperations(
     WriteOperationState *state, HybridTime* restart_read_ht) {
   LockBatch locks_held;
   WriteRequestPB* key_value_write_request = state->mutable_request();
 
+  if (key_value_write_request->write_batch().kv_pairs_size() != 0) {
+    // A batch shipped by CDC from another cluster. Its pairs are final and carry their own hybrid
+    // times, so there is nothing to read and no lock to take.
+    return Status::OK();
+  }
+
   bool invalid_table_type = true;
   WriteOperationData data = {
     state,
@@ -815,10 +1040,51 @@ Status Tablet::FlushUnlocked(FlushMode mode) {
   return Status::OK();
 }
 
+void Tablet::MarkAccessed() {
+  last_access_us_.store(GetMonoTimeMicros(), std::memory_order_relaxed);
+  if (PREDICT_FALSE(dormant_.load(std::memory_order_relaxed)) &&
+      dormant_.exchange(false, std::memory_order_acq_rel)) {
+    VLOG(1) << "Tablet " << tablet_id() << " is active again";
+  }
+}
+
+MonoDelta Tablet::IdleTime() const {
+  return MonoDelta::FromMicroseconds(
+      GetMonoTimeMicros() - last_access_us_.load(std::memory_order_relaxed));
+}
+
+Status Tablet::MakeDormant() {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  if (dormant_.exchange(true, std::memory_order_acq_rel)) {
+    return Status::OK();
+  }
+  VLOG(1) << "Tablet " << tablet_id() << " is dormant after being idle for " << IdleTime();
+  // Nothing to release if there were no writes since the last flush.
+  if (flush_stats_->oldest_write_in_memstore() != HybridTime::kMax) {
+    RETURN_NOT_OK(FlushUnlocked(FlushMode::kAsync));
+  }
+  return Status::OK();
+}
+
 Status Tablet::ImportData(const std::string& source_dir) {
   return rocksdb_->Import(source_dir);
 }
 
+Status Tablet::IngestSstFiles(const std::vector<std::string>& file_paths) {
+  // RocksDB requires that no other writes happen while a file is added.
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  for (const auto& file_path : file_paths) {
+    RETURN_NOT_OK_PREPEND(rocksdb_->AddFile(file_path, true /* move_file */),
+                          Format("Failed to ingest $0 into tablet $1", file_path, tablet_id()));
+    LOG(INFO) << "Ingested " << file_path << " into tablet " << tablet_id();
+  }
+  return Status::OK();
+}
+
 #define INTENT_VALUE_SCHECK(lhs, op, rhs, msg) \
   BOOST_PP_CAT(SCHECK_, op)(lhs, \
                             rhs, \
@@ -831,9 +1097,38 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+//
+// A transaction that does not fit into FLAGS_txn_max_apply_batch_records records is applied in
+// several write batches. First all regular records are written, then intents are removed. Only the
+// last batch has the frontiers of the apply operation, so if the tablet restarts in the middle, the
+// operation is replayed and the apply just continues. Regular records are written again with the
+// same keys while no intents are removed yet. After that the replay writes copies of records with
+// smaller write ids, so the latest write to each key of the transaction still wins.
 // TODO(dtxn) use separate thread for applying intents.
-// TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
+  WriteBatch rocksdb_write_batch;
+  auto complete = DoApplyIntents(data, ApplyIntentsPass::kPutAndRemove, &rocksdb_write_batch);
+  RETURN_NOT_OK(complete);
+  if (!*complete) {
+    rocksdb_write_batch.Clear();
+    LOG(INFO) << "Tablet " << tablet_id() << ": applying big transaction " << data.transaction_id;
+    RETURN_NOT_OK(DoApplyIntents(data, ApplyIntentsPass::kPut, &rocksdb_write_batch));
+    RETURN_NOT_OK(DoApplyIntents(data, ApplyIntentsPass::kRemove, &rocksdb_write_batch));
+  }
+
+  // data.hybrid_time contains transaction commit time.
+  // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
+  docdb::ConsensusFrontiers frontiers;
+  set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
+  set_hybrid_time(data.log_ht, &frontiers);
+  ApplyKeyValueRowOperations(
+      KeyValueWriteBatchPB(), &frontiers, data.commit_ht, &rocksdb_write_batch);
+  return Status::OK();
+}
+
+Result<bool> Tablet::DoApplyIntents(const TransactionApplyData& data,
+                                    ApplyIntentsPass pass,
+                                    rocksdb::WriteBatch* rocksdb_write_batch) {
   auto reverse_index_iter = docdb::CreateRocksDBIterator(
       rocksdb_.get(),
       docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
@@ -851,18 +1146,30 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
 
   reverse_index_iter->Seek(txn_reverse_index_prefix.data());
 
-  WriteBatch rocksdb_write_batch;
+  const bool put = pass != ApplyIntentsPass::kRemove;
+  const bool remove = pass != ApplyIntentsPass::kPut;
+  const size_t max_records = std::max(FLAGS_txn_max_apply_batch_records, 1);
 
   docdb::DocHybridTimeBuffer doc_ht_buffer;
 
   IntraTxnWriteId write_id = 0;
-  while (reverse_index_iter->Valid()) {
+  for (; reverse_index_iter->Valid(); reverse_index_iter->Next()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
 
     if (!key_slice.starts_with(txn_reverse_index_prefix.data())) {
       break;
     }
 
+    if (static_cast<size_t>(rocksdb_write_batch->Count()) >= max_records) {
+      if (pass == ApplyIntentsPass::kPutAndRemove) {
+        return false;
+      }
+      // Intermediate batches don't have frontiers, so they don't mark the operation as applied.
+      ApplyKeyValueRowOperations(
+          KeyValueWriteBatchPB(), nullptr /* frontiers */, data.commit_ht, rocksdb_write_batch);
+      rocksdb_write_batch->Clear();
+    }
+
     // If the key ends at the transaction id then it is transaction metadata (status tablet,
     // isolation level etc.).
     if (key_slice.size() > txn_reverse_index_prefix.size()) {
@@ -876,7 +1183,7 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
       auto intent = docdb::ParseIntentKey(intent_iter->key(), transaction_id_slice);
       RETURN_NOT_OK(intent);
 
-      if (IsStrongIntent(intent->type)) {
+      if (put && IsStrongIntent(intent->type)) {
         Slice intent_value(intent_iter->value());
         INTENT_VALUE_SCHECK(intent_value[0], EQ, static_cast<uint8_t>(ValueType::kTransactionId),
                             "prefix expected");
@@ -895,26 +1202,21 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
             intent->doc_ht,
             intent_value,
         }};
-        rocksdb_write_batch.Put(key_parts, value_parts);
+        rocksdb_write_batch->Put(key_parts, value_parts);
         ++write_id;
       }
 
-      rocksdb_write_batch.Delete(intent_iter->key());
+      if (remove) {
+        rocksdb_write_batch->Delete(intent_iter->key());
+      }
     }
 
-    rocksdb_write_batch.Delete(reverse_index_iter->key());
-
-    reverse_index_iter->Next();
+    if (remove) {
+      rocksdb_write_batch->Delete(reverse_index_iter->key());
+    }
   }
 
-  // data.hybrid_time contains transaction commit time.
-  // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
-  docdb::ConsensusFrontiers frontiers;
-  set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
-  set_hybrid_time(data.log_ht, &frontiers);
-  ApplyKeyValueRowOperations(
-      KeyValueWriteBatchPB(), &frontiers, data.commit_ht, &rocksdb_write_batch);
-  return Status::OK();
+  return true;
 }
 
 Status Tablet::CreatePreparedAlterSchema(AlterSchemaOperationState *operation_state,
@@ -973,6 +1275,7 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
     }
 
     metadata_->SetSchema(*operation_state->schema(), operation_state->schema_version());
+    projection_cache_.Clear();
     if (operation_state->has_new_table_name()) {
       metadata_->SetTableName(operation_state->new_table_name());
       if (metric_entity_) {
@@ -1023,6 +1326,7 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const rocksdb::SequenceNumber sequence_number = rocksdb_->GetLatestSequenceNumber();
   const string db_dir = rocksdb_->GetName();
 
+  ql_storage_.reset();
   rocksdb_ = nullptr;
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
@@ -1134,6 +1438,19 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
       doc_ops, metrics_->write_lock_latency, *isolation_level, &shared_lock_manager_,
       data.keys_locked, &need_read_snapshot);
 
+  const int hot_key_weight = HotKeySampleWeight();
+  if (hot_key_weight != 0) {
+    for (const auto& doc_op : doc_ops) {
+      std::list<docdb::DocPath> doc_paths;
+      IsolationLevel ignored_level;
+      doc_op->GetDocPathsToLock(&doc_paths, &ignored_level);
+      for (const auto& doc_path : doc_paths) {
+        RecordHotKey(doc_path.encoded_doc_key().AsSlice(), hot_key_weight);
+      }
+    }
+  }
+
+  const MonoTime doc_ops_start_time = metrics_ ? MonoTime::Now() : MonoTime();
   auto read_op = need_read_snapshot
       ? ScopedReadOperation(this, RequireLease::kTrue, data.read_time())
       : ScopedReadOperation();
@@ -1166,7 +1483,7 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
 
   if (*isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
     auto result = docdb::ResolveTransactionConflicts(*write_batch,
-                                                     clock_->Now(),
+                                                     clock_.get(),
                                                      rocksdb_.get(),
                                                      transaction_participant_.get());
     if (!result.ok()) {
@@ -1175,6 +1492,10 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
     }
   }
 
+  if (metrics_) {
+    metrics_->write_doc_ops_latency->Increment(
+        MonoTime::Now().GetDeltaSince(doc_ops_start_time).ToMicroseconds());
+  }
   return Status::OK();
 }
 
@@ -1185,13 +1506,7 @@ HybridTime Tablet::DoGetSafeTime(
     return mvcc_.SafeTimeForFollower(min_allowed, deadline);
   }
   if (require_lease && ht_lease_provider_) {
-    // min_allowed could contain non zero logical part, so we add one microsecond to be sure that
-    // max_allowed >= min_allowed.
-    auto min_allowed_lease = min_allowed.GetPhysicalValueMicros();
-    if (min_allowed.GetLogicalValue()) {
-      ++min_allowed_lease;
-    }
-    max_allowed = ht_lease_provider_(min_allowed_lease, deadline);
+    max_allowed = LeaseCovering(min_allowed, deadline);
     if (!max_allowed) {
       return HybridTime::kInvalid;
     }
@@ -1206,6 +1521,74 @@ HybridTime Tablet::DoGetSafeTime(
   return mvcc_.SafeTime(min_allowed, deadline, max_allowed);
 }
 
+HybridTime Tablet::LeaseCovering(HybridTime min_allowed, MonoTime deadline) const {
+  // min_allowed could contain non zero logical part, so we add one microsecond to be sure that
+  // the lease >= min_allowed.
+  auto min_allowed_lease = min_allowed.GetPhysicalValueMicros();
+  if (min_allowed.GetLogicalValue()) {
+    ++min_allowed_lease;
+  }
+  return ht_lease_provider_(min_allowed_lease, deadline);
+}
+
+HybridTime Tablet::SafeTimeForUnlockedRead(
+    const google::protobuf::RepeatedPtrField<QLReadRequestPB>& ql_batch,
+    HybridTime read_ht,
+    MonoTime deadline) {
+  // Writes lock the hash partition of every key they write only when prefix locks are enabled.
+  // Intents of committed transactions are applied without locks, so transactional tables always
+  // wait for the safe time.
+  if (FLAGS_docdb_prefix_lock_min_keys <= 0 || !ht_lease_provider_ || transaction_participant_ ||
+      ql_batch.empty()) {
+    return HybridTime::kInvalid;
+  }
+
+  // Writes that are not pending yet will get hybrid time from the clock, so after this check they
+  // are ordered after the read, no matter what they lock. The clock is read before the locks are
+  // checked, so a write that locks the rows after the check gets a later hybrid time.
+  if (read_ht > clock_->Now()) {
+    return HybridTime::kInvalid;
+  }
+
+  // Writes keep their locks until they are applied, so when the rows are not locked, every write
+  // that could change them at or before read_ht is already visible.
+  for (const auto& ql_read_request : ql_batch) {
+    if (HashPartitionLocked(ql_read_request)) {
+      return HybridTime::kInvalid;
+    }
+  }
+
+  auto lease = LeaseCovering(read_ht, deadline);
+  if (!lease || read_ht > lease) {
+    return HybridTime::kInvalid;
+  }
+  return read_ht;
+}
+
+bool Tablet::HashPartitionLocked(const QLReadRequestPB& ql_read_request) {
+  const auto& schema = *this->schema();
+  if (!ql_read_request.has_hash_code() || ql_read_request.has_max_hash_code() ||
+      schema.num_hash_key_columns() == 0 ||
+      ql_read_request.hashed_column_values_size() != schema.num_hash_key_columns()) {
+    return true;
+  }
+
+  vector<docdb::PrimitiveValue> hashed_components;
+  if (!docdb::QLKeyColumnValuesToPrimitiveValues(
+          ql_read_request.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
+          &hashed_components).ok()) {
+    return true;
+  }
+  docdb::KeyBytes encoded_doc_key = docdb::DocKey(
+      static_cast<docdb::DocKeyHash>(ql_read_request.hash_code()), hashed_components).Encode();
+  auto prefix_size = docdb::DocKey::EncodedSize(
+      encoded_doc_key.AsSlice(), docdb::DocKeyPart::HASHED_PART_ONLY);
+  if (!prefix_size.ok()) {
+    return true;
+  }
+  return shared_lock_manager_.IsLocked(string(encoded_doc_key.data().data(), *prefix_size));
+}
+
 HybridTime Tablet::OldestReadPoint() const {
   std::lock_guard<std::mutex> lock(active_readers_mutex_);
   if (active_readers_cnt_.empty()) {
@@ -1214,6 +1597,10 @@ HybridTime Tablet::OldestReadPoint() const {
   return active_readers_cnt_.begin()->first;
 }
 
+Result<docdb::RangeTombstonesPtr> Tablet::ReadRangeTombstones(HybridTime max_ht) const {
+  return docdb::ReadRangeTombstones(rocksdb_.get(), max_ht);
+}
+
 void Tablet::RegisterReaderTimestamp(HybridTime read_point) {
   std::lock_guard<std::mutex> lock(active_readers_mutex_);
   active_readers_cnt_[read_point]++;
@@ -1266,6 +1653,16 @@ uint64_t Tablet::GetTotalSSTFileSizes() const {
   return rocksdb_->GetTotalSSTFileSize();
 }
 
+int Tablet::GetCurrentVersionNumSSTFiles() const {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+
+  if (!pending_op_counter_.IsReady() || !rocksdb_) {
+    return 0;
+  }
+  return rocksdb_->GetCurrentVersionNumSSTFiles();
+}
+
 Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext(
     const TransactionMetadataPB& transaction_metadata) const {
   if (metadata_->schema().table_properties().is_transactional()) {
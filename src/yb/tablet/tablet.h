@@ -61,6 +61,7 @@
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
+#include "yb/gutil/walltime.h"
 
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/tablet/lock_manager.h"
@@ -69,6 +70,7 @@
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/transaction_participant.h"
 
+#include "yb/util/hot_keys.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/pending_op_counter.h"
@@ -197,6 +199,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
+  // Adds the given SST files, e.g. built with docdb::DocSstFileWriter, to the RocksDB instance of
+  // the tablet. The key range of every file should not overlap with the data of the tablet. Files
+  // are hard linked if possible, so they should not be modified afterwards.
+  CHECKED_STATUS IngestSstFiles(const std::vector<std::string>& file_paths);
+
   CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) override;
 
   // Finish the Prepare phase of a write transaction.
@@ -278,9 +285,40 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const Schema &projection,
       const boost::optional<TransactionId>& transaction_id) const;
 
+  // Create a new row iterator which yields the rows with hash codes in
+  // [min_hash_code, max_hash_code], as of read_time. The caller keeps the history at read_time,
+  // see ScopedReadOperation. The returned iterator is initialized.
+  Result<std::unique_ptr<common::QLRowwiseIteratorIf>> NewRowIterator(
+      const Schema &projection, const ReadHybridTime& read_time, int32_t min_hash_code,
+      int32_t max_hash_code) const;
+
+  // Computes the inserts of the index entries of the rows visible at read_ht, to backfill a new
+  // index, starting from the row with the given encoded DocKey, or from the first row when it is
+  // empty. Stops after max_rows rows, with next_key set to the DocKey of the row to continue from,
+  // or to empty when there are no more rows. The inserts are written with read_ht as their hybrid
+  // time, see QLWriteRequestPB::backfill_hybrid_time.
+  CHECKED_STATUS BackfillIndex(const IndexInfo& index, HybridTime read_ht,
+                               const std::string& start_key, size_t max_rows,
+                               std::vector<QLWriteRequestPB>* index_requests,
+                               std::string* next_key);
+
   // Makes RocksDB Flush.
   CHECKED_STATUS Flush(FlushMode mode);
 
+  // Records a read or a write of the tablet, reactivating it if it was dormant.
+  void MarkAccessed();
+
+  // Time since the last read or write of the tablet, or since it was created.
+  MonoDelta IdleTime() const;
+
+  // Releases the memory held by an idle tablet: its memtable is flushed, so that it is not kept
+  // in memory until the next write. The tablet stays dormant until the next read or write.
+  CHECKED_STATUS MakeDormant();
+
+  bool dormant() const {
+    return dormant_.load(std::memory_order_acquire);
+  }
+
   // Prepares the transaction context for the alter schema operation.
   // An error will be returned if the specified schema is invalid (e.g.
   // key mismatch, or missing IDs)
@@ -328,6 +366,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
+  // The most accessed hash partition keys of the tablet, encoded.
+  const HotKeySketch& hot_keys() const { return hot_keys_; }
+
   // Returns a reference to this tablet's memory tracker.
   const std::shared_ptr<MemTracker>& mem_tracker() const { return mem_tracker_; }
 
@@ -354,6 +395,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // This is used to figure out what can be garbage collected during a compaction.
   HybridTime OldestReadPoint() const;
 
+  // Returns the range tombstones written at or before the given hybrid time, see
+  // docdb/range_tombstone.h.
+  Result<docdb::RangeTombstonesPtr> ReadRangeTombstones(HybridTime max_ht) const;
+
   // The HybridTime of the oldest write that is still not scheduled to be flushed in RocksDB.
   TabletFlushStats* flush_stats() const { return flush_stats_.get(); }
 
@@ -395,8 +440,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void LostLeadership();
 
+  // A witness replica keeps the log of the tablet but does not apply writes to its RocksDB, see
+  // RaftPeerPB::is_witness. Set while bootstrapping, before any operation is applied.
+  void SetWitness(bool witness) {
+    witness_ = witness;
+  }
+
+  bool witness() const {
+    return witness_;
+  }
+
   uint64_t GetTotalSSTFileSizes() const;
 
+  // Returns the number of SST files of the tablet, 0 while the tablet is not ready.
+  int GetCurrentVersionNumSSTFiles() const;
+
   void SetHybridTimeLeaseProvider(std::function<HybridTime(MicrosTime, MonoTime)> provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -421,10 +479,24 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const docdb::DocOperations &doc_ops,
       const WriteOperationData& data);
 
+  // Checks a write of an index backfill batch, taking the backfill hybrid time of the batch from
+  // its first write.
+  CHECKED_STATUS CheckBackfillWrite(const QLWriteRequestPB& req, bool first,
+                                    const WriteOperationData& data, HybridTime* backfill_ht);
+
+  // Records an access to the hash partition key of the given encoded doc key in hot_keys_, with
+  // the weight returned by the sampling decision.
+  void RecordHotKey(const Slice& encoded_doc_key, int weight);
+
   CHECKED_STATUS OpenKeyValueTablet();
 
   void DocDBDebugDump(std::vector<std::string> *lines);
 
+  HybridTime SafeTimeForUnlockedRead(
+      const google::protobuf::RepeatedPtrField<QLReadRequestPB>& ql_batch,
+      HybridTime read_ht,
+      MonoTime deadline) override;
+
   // Register/Unregister a read operation, with an associated timestamp, for the purpose of
   // tracking the oldest read point.
   void RegisterReaderTimestamp(HybridTime read_point) override;
@@ -435,6 +507,20 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       HybridTime hybrid_time,
       rocksdb::WriteBatch* rocksdb_write_batch);
 
+  // Pass over the transaction reverse index performed by ApplyIntents.
+  enum class ApplyIntentsPass {
+    kPutAndRemove,
+    kPut,
+    kRemove,
+  };
+
+  // Adds operations of the specified pass of the transaction apply to rocksdb_write_batch.
+  // Passes other than kPutAndRemove write the batch each time it reaches
+  // FLAGS_txn_max_apply_batch_records records. kPutAndRemove returns false in this case instead.
+  Result<bool> DoApplyIntents(const TransactionApplyData& data,
+                              ApplyIntentsPass pass,
+                              rocksdb::WriteBatch* rocksdb_write_batch);
+
   Result<TransactionOperationContextOpt> CreateTransactionOperationContext(
       const TransactionMetadataPB& transaction_metadata) const;
 
@@ -520,6 +606,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Lock used to serialize the creation of RocksDB checkpoints.
   mutable std::mutex create_checkpoint_lock_;
 
+  // Sampled reads and writes by hash partition key, decayed every --hot_key_decay_sec.
+  HotKeySketch hot_keys_;
+  std::atomic<int64_t> hot_keys_next_decay_{0};
+
+  // Monotonic time of the last read or write, see MarkAccessed.
+  std::atomic<MicrosecondsInt64> last_access_us_{GetMonoTimeMicros()};
+  std::atomic<bool> dormant_{false};
+
   enum State {
     kInitialized,
     kBootstrapping,
@@ -574,6 +668,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::atomic<int64_t> last_committed_write_index_{0};
 
+  bool witness_ = false;
+
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
   std::shared_ptr<TabletFlushStats> flush_stats_;
@@ -584,6 +680,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const override;
 
+  // Returns the hybrid time leader lease, waiting until it covers `min_allowed`, or invalid hybrid
+  // time if it did not before the deadline.
+  HybridTime LeaseCovering(HybridTime min_allowed, MonoTime deadline) const;
+
+  // Returns whether a pending write operation has locked the hash partition read by the request.
+  // Returns true as well if the request could read more than one partition.
+  bool HashPartitionLocked(const QLReadRequestPB& ql_read_request);
+
   std::function<rocksdb::MemTableFilter()> mem_table_flush_filter_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Tablet);
@@ -31,9 +31,12 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <thread>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
@@ -55,6 +58,11 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
+DEFINE_bool(bootstrap_read_ahead_log_segments, true,
+            "Read the next log segment in background while replaying the current one during "
+            "tablet bootstrap. Up to two segments are kept in memory at the same time.");
+TAG_FLAG(bootstrap_read_ahead_log_segments, advanced);
+
 DECLARE_uint64(max_clock_sync_error_usec);
 
 namespace yb {
@@ -101,6 +109,53 @@ static string DebugInfo(const string& tablet_id,
                     segment_path, debug_str);
 }
 
+namespace {
+
+// Reads entries of the log segment, optionally in a background thread.
+class SegmentEntriesReader {
+ public:
+  SegmentEntriesReader(scoped_refptr<ReadableLogSegment> segment, bool background)
+      : segment_(std::move(segment)) {
+    if (background) {
+      thread_ = std::thread(&SegmentEntriesReader::Read, this);
+    } else {
+      Read();
+    }
+  }
+
+  SegmentEntriesReader(const SegmentEntriesReader&) = delete;
+  void operator=(const SegmentEntriesReader&) = delete;
+
+  ~SegmentEntriesReader() {
+    Wait();
+  }
+
+  // Waits until the segment is read and returns the status of the reading.
+  // Even when reading failed, entries contains all entries that were read successfully.
+  Status Wait() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    return status_;
+  }
+
+  log::LogEntries* entries() { return &entries_; }
+
+  const scoped_refptr<ReadableLogSegment>& segment() const { return segment_; }
+
+ private:
+  void Read() {
+    status_ = segment_->ReadEntries(&entries_);
+  }
+
+  scoped_refptr<ReadableLogSegment> segment_;
+  log::LogEntries entries_;
+  Status status_;
+  std::thread thread_;
+};
+
+} // namespace
+
 // ============================================================================
 //  Class ReplayState.
 // ============================================================================
@@ -344,6 +399,8 @@ Status TabletBootstrap::OpenTablet(bool* has_blocks) {
   auto tablet = std::make_unique<TabletClass>(
       meta_, data_.clock, mem_tracker_, metric_registry_, log_anchor_registry_, tablet_options_,
       data_.transaction_participant_context, data_.transaction_coordinator_context);
+  tablet->SetWitness(
+      consensus::IsRaftConfigWitness(meta_->fs_manager()->uuid(), cmeta_->committed_config()));
   // Doing nothing for now except opening a tablet locally.
   LOG_TIMING_PREFIX(INFO, LogPrefix(), "opening tablet") {
     RETURN_NOT_OK(tablet->Open());
@@ -692,10 +749,20 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
   int segment_count = 0;
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    log::LogEntries entries;
-    // TODO: Optimize this to not read the whole thing into memory?
-    Status read_status = segment->ReadEntries(&entries);
+  std::unique_ptr<SegmentEntriesReader> next_reader;
+  if (!segments.empty()) {
+    next_reader = std::make_unique<SegmentEntriesReader>(segments.front(), false /* background */);
+  }
+  for (size_t segment_idx = 0; segment_idx != segments.size(); ++segment_idx) {
+    auto reader = std::move(next_reader);
+    Status read_status = reader->Wait();
+    // Read the next segment while replaying this one, since replaying does not touch it.
+    if (segment_idx + 1 != segments.size()) {
+      next_reader = std::make_unique<SegmentEntriesReader>(
+          segments[segment_idx + 1], FLAGS_bootstrap_read_ahead_log_segments);
+    }
+    const auto& segment = reader->segment();
+    auto& entries = *reader->entries();
     for (int entry_idx = 0; entry_idx < entries.size(); ++entry_idx) {
       Status s = HandleEntry(&state, &entries[entry_idx]);
       if (!s.ok()) {
@@ -557,6 +557,11 @@ void TabletMetadata::SetIndexMap(IndexMap&& index_map) {
   index_map_ = std::move(index_map);
 }
 
+IndexMap TabletMetadata::index_map() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return index_map_;
+}
+
 void TabletMetadata::SetSchemaUnlocked(gscoped_ptr<Schema> new_schema, uint32_t version) {
   DCHECK(new_schema->has_column_ids());
 
@@ -155,6 +155,9 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   void SetIndexMap(IndexMap&& index_map);
 
+  // Return a copy of the indexes of the table.
+  IndexMap index_map() const;
+
   void SetTableName(const std::string& table_name);
 
   // Return a reference to the current schema.
@@ -32,6 +32,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/perf_context.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 
@@ -74,6 +75,56 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, write_doc_ops_latency, "Write read-for-write latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to execute the doc operations of a write operation after its locks are acquired, "
+    "including the reads they need and conflict resolution", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_replication_latency, "Write replication latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken by the leader from submitting a write operation to Raft until it is replicated "
+    "to a majority, including the local log append", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_apply_latency, "Write apply latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to write the batch of a replicated write operation into RocksDB", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_coalesced_group_size, "Write requests per write operation",
+    yb::MetricUnit::kRequests,
+    "Number of write requests merged into a single replicated write operation", 1000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_iter_seeks_per_request, "RocksDB seeks per read", yb::MetricUnit::kOperations,
+    "Number of RocksDB iterator seeks done to handle a read request", 1000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_iter_nexts_per_request, "RocksDB nexts per read", yb::MetricUnit::kOperations,
+    "Number of RocksDB iterator Next and Prev calls done to handle a read request",
+    1000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_block_cache_hits_per_request, "Block cache hits per read",
+    yb::MetricUnit::kBlocks,
+    "Number of block cache hits while handling a read request", 1000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_block_reads_per_request, "Block reads per read", yb::MetricUnit::kBlocks,
+    "Number of blocks read from SST files, i.e. block cache misses, while handling a read "
+    "request", 1000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, read_bloom_filter_useful_per_request, "Useful bloom filter checks per read",
+    yb::MetricUnit::kProbes,
+    "Number of SST files skipped by bloom filter checks while handling a read request",
+    1000000LU, 2);
+
+METRIC_DEFINE_gauge_uint64(tablet, hottest_key_ops, "Hottest key operations",
+  yb::MetricUnit::kOperations,
+  "Estimated number of reads and writes of the most accessed hash partition key of this "
+  "tablet, over about the last --hot_key_decay_sec seconds.");
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -109,6 +160,12 @@ METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, leader_overload_rejections,
+  "Leader Overload Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of write RPC requests rejected while LEADER because the tablet could not keep up "
+  "with its writes.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -120,8 +177,19 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
+    MINIT(write_doc_ops_latency),
+    MINIT(write_replication_latency),
+    MINIT(write_apply_latency),
+    MINIT(write_coalesced_group_size),
     MINIT(write_op_duration_client_propagated_consistency),
-    MINIT(leader_memory_pressure_rejections) {
+    MINIT(read_iter_seeks_per_request),
+    MINIT(read_iter_nexts_per_request),
+    MINIT(read_block_cache_hits_per_request),
+    MINIT(read_block_reads_per_request),
+    MINIT(read_bloom_filter_useful_per_request),
+    MINIT(leader_memory_pressure_rejections),
+    MINIT(leader_overload_rejections),
+    hottest_key_ops(METRIC_hottest_key_ops.Instantiate(entity, 0)) {
 }
 #undef MINIT
 
@@ -131,5 +199,34 @@ ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram>
 ScopedTabletMetricsTracker::~ScopedTabletMetricsTracker() {
   latency_->Increment(MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds());
 }
+
+ScopedReadStatsTracker::ScopedReadStatsTracker(TabletMetrics* metrics)
+    : metrics_(metrics), start_(Current()) {}
+
+ScopedReadStatsTracker::~ScopedReadStatsTracker() {
+  const Stats end = Current();
+  const uint64_t seeks = end.seeks - start_.seeks;
+  const uint64_t nexts = end.nexts - start_.nexts;
+  const uint64_t block_cache_hits = end.block_cache_hits - start_.block_cache_hits;
+  const uint64_t block_reads = end.block_reads - start_.block_reads;
+  const uint64_t bloom_filter_useful = end.bloom_filter_useful - start_.bloom_filter_useful;
+  if (metrics_ != nullptr) {
+    metrics_->read_iter_seeks_per_request->Increment(seeks);
+    metrics_->read_iter_nexts_per_request->Increment(nexts);
+    metrics_->read_block_cache_hits_per_request->Increment(block_cache_hits);
+    metrics_->read_block_reads_per_request->Increment(block_reads);
+    metrics_->read_bloom_filter_useful_per_request->Increment(bloom_filter_useful);
+  }
+  TRACE("Read stats: seeks: $0, nexts: $1, block cache hits: $2, block reads: $3, "
+        "bloom filter useful: $4", seeks, nexts, block_cache_hits, block_reads,
+        bloom_filter_useful);
+}
+
+ScopedReadStatsTracker::Stats ScopedReadStatsTracker::Current() {
+  const auto& context = rocksdb::perf_context;
+  return Stats{context.iter_seek_count, context.iter_next_count, context.block_cache_hit_count,
+               context.block_read_count, context.bloom_sst_miss_count};
+}
+
 } // namespace tablet
 } // namespace yb
@@ -57,10 +57,24 @@ struct TabletMetrics {
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
+  scoped_refptr<Histogram> write_doc_ops_latency;
+  scoped_refptr<Histogram> write_replication_latency;
+  scoped_refptr<Histogram> write_apply_latency;
+  scoped_refptr<Histogram> write_coalesced_group_size;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
+  // Read path work done per read request.
+  scoped_refptr<Histogram> read_iter_seeks_per_request;
+  scoped_refptr<Histogram> read_iter_nexts_per_request;
+  scoped_refptr<Histogram> read_block_cache_hits_per_request;
+  scoped_refptr<Histogram> read_block_reads_per_request;
+  scoped_refptr<Histogram> read_bloom_filter_useful_per_request;
+
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+  scoped_refptr<Counter> leader_overload_rejections;
+
+  scoped_refptr<AtomicGauge<uint64_t>> hottest_key_ops;
 };
 
 class ScopedTabletMetricsTracker {
@@ -73,6 +87,32 @@ class ScopedTabletMetricsTracker {
   MonoTime start_time_;
 };
 
+// Collects the RocksDB work done by the current thread while in scope, i.e. while handling a
+// single read request, from the thread-local perf context. On exit, adds it to the read path
+// histograms of the tablet and to the trace of the request, so that reads that end up scanning
+// much more than they return can be found.
+class ScopedReadStatsTracker {
+ public:
+  explicit ScopedReadStatsTracker(TabletMetrics* metrics);
+  ~ScopedReadStatsTracker();
+
+ private:
+  struct Stats {
+    uint64_t seeks;
+    uint64_t nexts;
+    uint64_t block_cache_hits;
+    uint64_t block_reads;
+    uint64_t bloom_filter_useful;
+  };
+
+  static Stats Current();
+
+  TabletMetrics* const metrics_;
+  const Stats start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedReadStatsTracker);
+};
+
 } // namespace tablet
 } // namespace yb
 #endif /* YB_TABLET_TABLET_METRICS_H */
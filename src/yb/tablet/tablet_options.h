@@ -13,10 +13,16 @@
 #ifndef YB_TABLET_TABLET_OPTIONS_H
 #define YB_TABLET_TABLET_OPTIONS_H
 
+#include <memory>
+#include <vector>
+
+#include "yb/common/common.pb.h"
+
 namespace rocksdb {
 class Cache;
 class EventListener;
 class MemoryMonitor;
+class RateLimiter;
 }
 
 namespace yb {
@@ -24,8 +30,18 @@ namespace tablet {
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Second tier below block_cache, holding blocks as they are stored in SST files, when set.
+  std::shared_ptr<rocksdb::Cache> compressed_block_cache;
+  // Open SST files of all tablets, when set.
+  std::shared_ptr<rocksdb::Cache> table_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
+  // Shared by the flushes and compactions of all tablets, when set.
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Priority of the tablet's blocks in block_cache, taken from the properties of its table.
+  CachePriority cache_priority = NORMAL_CACHE_PRIORITY;
+  // Whether the data blocks of the tablet are kept in memory, see TablePropertiesPB::in_memory.
+  bool in_memory = false;
 };
 
 } // namespace tablet
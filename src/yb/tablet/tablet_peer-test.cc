@@ -162,7 +162,8 @@ class TabletPeerTest : public YBTabletTest,
                                            messenger_,
                                            log,
                                            metric_entity_,
-                                           raft_pool_.get()));
+                                           raft_pool_.get(),
+                                           nullptr /* multi_raft_manager */));
   }
 
   Status StartPeer(const ConsensusBootstrapInfo& info) {
@@ -444,6 +445,28 @@ TEST_P(TabletPeerTest, TestGCEmptyLog) {
   ASSERT_OK(tablet_peer_->RunLogGC());
 }
 
+TEST_P(TabletPeerTest, TestDormantTablet) {
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  ASSERT_OK(ExecuteInsertsAndRollLogs(1));
+  Tablet* tablet = tablet_peer_->tablet();
+  ASSERT_FALSE(tablet->dormant());
+  ASSERT_NE(HybridTime::kMax, tablet->flush_stats()->oldest_write_in_memstore());
+
+  // The memtable is flushed when the tablet becomes dormant.
+  const size_t num_flushes = tablet->flush_stats()->num_flushes();
+  ASSERT_OK(tablet_peer_->MakeDormant());
+  ASSERT_TRUE(tablet->dormant());
+  ASSERT_EQ(num_flushes + 1, tablet->flush_stats()->num_flushes());
+  ASSERT_EQ(HybridTime::kMax, tablet->flush_stats()->oldest_write_in_memstore());
+
+  // And the next write reactivates it.
+  ASSERT_OK(ExecuteInsertsAndRollLogs(1));
+  ASSERT_FALSE(tablet->dormant());
+  ASSERT_LT(tablet->IdleTime().ToSeconds(), 60);
+}
+
 INSTANTIATE_TEST_CASE_P(Rocks, TabletPeerTest, ::testing::Values(YQL_TABLE_TYPE));
 
 } // namespace tablet
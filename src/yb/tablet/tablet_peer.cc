@@ -157,7 +157,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
                                   const shared_ptr<Messenger> &messenger,
                                   const scoped_refptr<Log> &log,
                                   const scoped_refptr<MetricEntity> &metric_entity,
-                                  ThreadPool* raft_pool) {
+                                  ThreadPool* raft_pool,
+                                  consensus::MultiRaftManager* multi_raft_manager) {
 
   DCHECK(tablet) << "A TabletPeer must be provided with a Tablet";
   DCHECK(log) << "A TabletPeer must be provided with a Log";
@@ -202,7 +203,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
         mark_dirty_clbk_,
         tablet_->table_type(),
         std::bind(&Tablet::LostLeadership, tablet.get()),
-        raft_pool);
+        raft_pool,
+        multi_raft_manager);
 
     auto ht_lease_provider = [this](MicrosTime min_allowed, MonoTime deadline) {
       auto lease = consensus_->MajorityReplicatedHtLeaseExpiration(min_allowed, deadline);
@@ -225,7 +227,14 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       }
     });
 
-    prepare_thread_ = std::make_unique<PrepareThread>(consensus_.get());
+    prepare_thread_ = std::make_unique<PrepareThread>(consensus_.get(), tablet_id_);
+    write_coalescer_ = std::make_unique<WriteCoalescer>(
+        tablet_.get(),
+        [this](std::unique_ptr<WriteOperationState> state) {
+          return SubmitWriteOperation(std::move(state));
+        },
+        tablet_->metrics() ? tablet_->metrics()->write_coalesced_group_size
+                            : scoped_refptr<Histogram>());
   }
 
   RETURN_NOT_OK(prepare_thread_->Start());
@@ -404,22 +413,33 @@ Status TabletPeer::WaitUntilConsensusRunning(const MonoDelta& timeout) {
 }
 
 Status TabletPeer::SubmitWrite(std::unique_ptr<WriteOperationState> state) {
-  auto operation = std::make_unique<WriteOperation>(std::move(state), consensus::LEADER);
   RETURN_NOT_OK(CheckRunning());
 
   HybridTime restart_read_ht;
-  RETURN_NOT_OK(tablet_->AcquireLocksAndPerformDocOperations(operation->state(), &restart_read_ht));
+  RETURN_NOT_OK(tablet_->AcquireLocksAndPerformDocOperations(state.get(), &restart_read_ht));
   // If a restart read is required, then we return this fact to caller and don't perform the write
   // operation.
   if (restart_read_ht.is_valid()) {
-    auto restart_time = operation->state()->response()->mutable_restart_read_time();
+    auto restart_time = state->response()->mutable_restart_read_time();
     restart_time->set_read_ht(restart_read_ht.ToUint64());
     restart_time->set_local_limit_ht(
         tablet_->SafeTime(RequireLease::kTrue).ToUint64());
     // Global limit is ignored by caller, so we don't set it.
-    operation->state()->completion_callback()->OperationCompleted();
+    state->completion_callback()->OperationCompleted();
+    return Status::OK();
+  }
+  if (WriteCoalescer::CanCoalesce(*state)) {
+    write_coalescer_->Submit(std::move(state));
     return Status::OK();
   }
+  return SubmitWriteOperation(std::move(state));
+}
+
+Status TabletPeer::SubmitWriteOperation(std::unique_ptr<WriteOperationState> state) {
+  // Writes that waited to be merged are submitted when another write completes, which could be
+  // after shutdown started.
+  RETURN_NOT_OK(CheckRunning());
+  auto operation = std::make_unique<WriteOperation>(std::move(state), consensus::LEADER);
   scoped_refptr<OperationDriver> driver;
   RETURN_NOT_OK(NewLeaderOperationDriver(std::move(operation), &driver));
   driver->ExecuteAsync();
@@ -775,6 +795,23 @@ uint64_t TabletPeer::OnDiskSize() const {
   return ret;
 }
 
+Status TabletPeer::MakeDormant() {
+  scoped_refptr<consensus::RaftConsensus> consensus;
+  std::shared_ptr<TabletClass> tablet;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    if (state_ != RUNNING) {
+      return STATUS(IllegalState, Substitute("The tablet is not in a running state: $0",
+                                             TabletStatePB_Name(state_)));
+    }
+    consensus = consensus_;
+    tablet = tablet_;
+  }
+  RETURN_NOT_OK(tablet->MakeDormant());
+  consensus->EvictLogCache();
+  return Status::OK();
+}
+
 scoped_refptr<OperationDriver> TabletPeer::CreateOperationDriver() {
   return scoped_refptr<OperationDriver>(new OperationDriver(
       &operation_tracker_,
@@ -54,6 +54,7 @@
 #include "yb/tablet/prepare_thread.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/tablet_fwd.h"
+#include "yb/tablet/write_coalescer.h"
 
 #include "yb/util/metrics.h"
 #include "yb/util/semaphore.h"
@@ -63,6 +64,7 @@ using yb::consensus::StateChangeContext;
 namespace yb {
 
 namespace consensus {
+class MultiRaftManager;
 class RaftConsensus;
 }
 
@@ -113,7 +115,8 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
                                 const std::shared_ptr<rpc::Messenger> &messenger,
                                 const scoped_refptr<log::Log> &log,
                                 const scoped_refptr<MetricEntity> &metric_entity,
-                                ThreadPool* raft_pool);
+                                ThreadPool* raft_pool,
+                                consensus::MultiRaftManager* multi_raft_manager);
 
   // Starts the TabletPeer, making it available for Write()s. If this
   // TabletPeer is part of a consensus configuration this will connect it to other peers
@@ -273,6 +276,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
     return NewOperationDriver(std::move(operation), consensus::LEADER, driver);
   }
 
+  // Starts replication of a write whose doc operations were already performed.
+  CHECKED_STATUS SubmitWriteOperation(std::unique_ptr<WriteOperationState> state);
+
   CHECKED_STATUS NewReplicaOperationDriver(std::unique_ptr<Operation> operation,
                                            scoped_refptr<OperationDriver>* driver) {
     return NewOperationDriver(std::move(operation), consensus::REPLICA, driver);
@@ -302,6 +308,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // Caller should hold the lock_.
   uint64_t OnDiskSize() const;
 
+  // Releases the memory of an idle tablet replica, see Tablet::MakeDormant, and its log cache.
+  CHECKED_STATUS MakeDormant();
+
  protected:
   friend class RefCountedThreadSafe<TabletPeer>;
   friend class TabletPeerTest;
@@ -354,6 +363,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
 
   std::unique_ptr<PrepareThread> prepare_thread_;
 
+  // Merges concurrent non-transactional writes into shared write operations.
+  std::unique_ptr<WriteCoalescer> write_coalescer_;
+
   // Pool that executes apply tasks for transactions. This is a multi-threaded
   // pool, constructor-injected by either the Master (for system tables) or
   // the Tablet server.
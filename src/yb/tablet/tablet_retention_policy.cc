@@ -55,5 +55,10 @@ MonoDelta TabletRetentionPolicy::GetTableTTL() {
   return TableTTL(tablet_->metadata()->schema());
 }
 
+Result<docdb::RangeTombstonesPtr> TabletRetentionPolicy::GetRangeTombstones(
+    HybridTime history_cutoff) {
+  return tablet_->ReadRangeTombstones(history_cutoff);
+}
+
 }  // namespace tablet
 }  // namespace yb
@@ -30,6 +30,7 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
   HybridTime GetHistoryCutoff() override;
   ColumnIdsPtr GetDeletedColumns() override;
   MonoDelta GetTableTTL() override;
+  Result<docdb::RangeTombstonesPtr> GetRangeTombstones(HybridTime history_cutoff) override;
 
  private:
   const Tablet* tablet_;
@@ -57,6 +57,11 @@
 DECLARE_uint64(transaction_heartbeat_usec);
 DEFINE_uint64(transaction_timeout_usec, 1500000, "Transaction expiration timeout in usec.");
 DEFINE_uint64(transaction_check_interval_usec, 500000, "Transaction check interval in usec.");
+DEFINE_uint64(transaction_heartbeat_replication_interval_usec, 600000,
+              "Heartbeat received by leader within this interval after the last replicated "
+              "update of the transaction only refreshes transaction in memory, w/o RAFT round. "
+              "Should be less than transaction_timeout_usec - transaction_heartbeat_usec. "
+              "0 to replicate every heartbeat.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
 
@@ -121,7 +126,7 @@ class TransactionState {
   }
 
   // Time when we last heard from transaction. I.e. hybrid time of replicated raft log entry
-  // that updates status of this transaction.
+  // that updates status of this transaction, or time of heartbeat that was not replicated.
   HybridTime last_touch() const {
     return last_touch_;
   }
@@ -209,13 +214,14 @@ class TransactionState {
 
   CHECKED_STATUS GetStatus(tserver::GetTransactionStatusResponsePB* response) const {
     if (status_ == TransactionStatus::COMMITTED) {
-      response->set_status(TransactionStatus::COMMITTED);
-      response->set_status_hybrid_time(commit_time_.ToUint64());
+      response->add_status(TransactionStatus::COMMITTED);
+      response->add_status_hybrid_time(commit_time_.ToUint64());
     } else if (status_ == TransactionStatus::ABORTED) {
-      response->set_status(TransactionStatus::ABORTED);
+      response->add_status(TransactionStatus::ABORTED);
+      response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
     } else {
       CHECK_EQ(TransactionStatus::PENDING, status_);
-      response->set_status(TransactionStatus::PENDING);
+      response->add_status(TransactionStatus::PENDING);
       HybridTime status_ht = context_.coordinator_context().clock().Now();
       if (replicating_) {
         auto replicating_status = replicating_->request()->status();
@@ -228,7 +234,7 @@ class TransactionState {
         }
       }
       status_ht = std::min(status_ht, context_.coordinator_context().HtLeaseExpiration());
-      response->set_status_hybrid_time(status_ht.Decremented().ToUint64());
+      response->add_status_hybrid_time(status_ht.Decremented().ToUint64());
     }
     return Status::OK();
   }
@@ -356,6 +362,13 @@ class TransactionState {
             "Transaction in wrong state during heartbeat: $0",
             TransactionStatus_Name(status_));
       } else {
+        auto now = context_.coordinator_context().clock().Now();
+        if (!HeartbeatShouldBeReplicated(now)) {
+          VLOG_WITH_PREFIX(4) << "Heartbeat w/o replication at " << now;
+          last_touch_ = now;
+          request->completion_callback()->CompleteWithStatus(Status::OK());
+          return;
+        }
         status = Status::OK();
       }
     } else {
@@ -372,6 +385,16 @@ class TransactionState {
     CHECK(submitted);
   }
 
+  // Followers know only replicated updates of transaction. So heartbeat is replicated when last
+  // replicated update is old enough, otherwise new leader could expire transaction after failover.
+  bool HeartbeatShouldBeReplicated(HybridTime now) const {
+    if (!replicated_touch_.is_valid()) {
+      return true;
+    }
+    auto passed = now.GetPhysicalValueMicros() - replicated_touch_.GetPhysicalValueMicros();
+    return passed >= FLAGS_transaction_heartbeat_replication_interval_usec;
+  }
+
   CHECKED_STATUS HandleCommit() {
     auto hybrid_time = context_.coordinator_context().clock().Now();
     if (ExpiredAt(hybrid_time)) {
@@ -462,7 +485,8 @@ class TransactionState {
       return Status::OK();
     }
     CHECK_EQ(status_, TransactionStatus::PENDING) << "Transaction id: " << id_;
-    last_touch_ = data.hybrid_time;
+    last_touch_ = std::max(last_touch_, data.hybrid_time);
+    replicated_touch_ = data.hybrid_time;
     first_entry_raft_index_ = data.op_id.index();
     return Status::OK();
   }
@@ -482,6 +506,8 @@ class TransactionState {
   const std::string log_prefix_;
   TransactionStatus status_ = TransactionStatus::PENDING;
   HybridTime last_touch_;
+  // Hybrid time of last replicated raft log entry that updates status of this transaction.
+  HybridTime replicated_touch_ = HybridTime::kInvalid;
   // It should match last_touch_, but it is possible that because of some code errors it
   // would not be so. To add stability we introduce a separate field for it.
   HybridTime commit_time_;
@@ -547,20 +573,29 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     rpcs_.Shutdown();
   }
 
-  CHECKED_STATUS GetStatus(const std::string& transaction_id,
+  CHECKED_STATUS GetStatus(const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
                            tserver::GetTransactionStatusResponsePB* response) {
-    auto id = FullyDecodeTransactionId(transaction_id);
-    if (!id.ok()) {
-      return std::move(id.status());
+    std::vector<TransactionId> ids;
+    ids.reserve(transaction_ids.size());
+    for (const auto& transaction_id : transaction_ids) {
+      auto id = FullyDecodeTransactionId(transaction_id);
+      if (!id.ok()) {
+        return std::move(id.status());
+      }
+      ids.push_back(*id);
     }
 
     std::lock_guard<std::mutex> lock(managed_mutex_);
-    auto it = managed_transactions_.find(*id);
-    if (it == managed_transactions_.end()) {
-      response->set_status(TransactionStatus::ABORTED);
-      return Status::OK();
+    for (const auto& id : ids) {
+      auto it = managed_transactions_.find(id);
+      if (it == managed_transactions_.end()) {
+        response->add_status(TransactionStatus::ABORTED);
+        response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
+        continue;
+      }
+      RETURN_NOT_OK(it->GetStatus(response));
     }
-    return it->GetStatus(response);
+    return Status::OK();
   }
 
   void Abort(const std::string& transaction_id, TransactionAbortCallback callback) {
@@ -945,9 +980,10 @@ void TransactionCoordinator::Shutdown() {
   impl_->Shutdown();
 }
 
-Status TransactionCoordinator::GetStatus(const std::string& transaction_id,
-                                         tserver::GetTransactionStatusResponsePB* response) {
-  return impl_->GetStatus(transaction_id, response);
+Status TransactionCoordinator::GetStatus(
+    const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
+    tserver::GetTransactionStatusResponsePB* response) {
+  return impl_->GetStatus(transaction_ids, response);
 }
 
 void TransactionCoordinator::Abort(const std::string& transaction_id,
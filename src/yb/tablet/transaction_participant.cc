@@ -16,6 +16,7 @@
 #include "yb/tablet/transaction_participant.h"
 
 #include <mutex>
+#include <unordered_map>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -116,22 +117,32 @@ class Delayer {
   std::deque<std::pair<MonoTime, std::function<void()>>> queue_;
 };
 
+// Sends status requests of running transactions to their status tablets.
+class StatusRequestSender {
+ public:
+  // Requests status of specified transaction, should be called without participant mutex held.
+  // Result is delivered via RunningTransaction::StatusReceived.
+  virtual void RequestStatus(const TransactionMetadata& metadata) = 0;
+
+ protected:
+  ~StatusRequestSender() {}
+};
+
 class RunningTransaction {
  public:
   RunningTransaction(TransactionMetadata metadata,
                      rpc::Rpcs* rpcs,
                      TransactionParticipantContext* context,
-                     std::atomic<int64_t>* request_serial)
+                     StatusRequestSender* status_request_sender)
       : metadata_(std::move(metadata)),
         rpcs_(*rpcs),
         context_(*context),
-        request_serial_(request_serial),
-        get_status_handle_(rpcs->InvalidHandle()),
+        status_request_sender_(*status_request_sender),
         abort_handle_(rpcs->InvalidHandle()) {
   }
 
   ~RunningTransaction() {
-    rpcs_.Abort({&get_status_handle_, &abort_handle_});
+    rpcs_.Abort({&abort_handle_});
   }
 
   const TransactionId& id() const {
@@ -150,9 +161,7 @@ class RunningTransaction {
     local_commit_time_ = time;
   }
 
-  void RequestStatusAt(client::YBClient* client,
-                       const StatusRequest& request,
-                       std::unique_lock<std::mutex>* lock) const {
+  void RequestStatusAt(const StatusRequest& request, std::unique_lock<std::mutex>* lock) const {
     if (last_known_status_hybrid_time_ > HybridTime::kMin) {
       auto transaction_status =
           GetStatusAt(request.global_limit_ht, last_known_status_hybrid_time_, last_known_status_);
@@ -170,7 +179,24 @@ class RunningTransaction {
       return;
     }
     lock->unlock();
-    SendStatusRequest(client, lock->mutex());
+    status_request_sender_.RequestStatus(metadata_);
+  }
+
+  // Handles status received from status tablet for request sent with specified serial no.
+  void StatusReceived(const Status& status,
+                      TransactionStatus transaction_status,
+                      HybridTime time,
+                      int64_t serial_no,
+                      std::mutex* mutex) const {
+    auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
+    if (delay_usec > 0) {
+      delayer_.Delay(
+          MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
+          std::bind(&RunningTransaction::DoStatusReceived, this, status, transaction_status, time,
+                    serial_no, mutex));
+    } else {
+      DoStatusReceived(status, transaction_status, time, serial_no, mutex);
+    }
   }
 
   void Abort(client::YBClient* client,
@@ -218,64 +244,21 @@ class RunningTransaction {
     }
   }
 
-  void SendStatusRequest(client::YBClient* client, std::mutex* mutex) const {
-    tserver::GetTransactionStatusRequestPB req;
-    req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
-    req.set_propagated_hybrid_time(context_.Now().ToUint64());
-    int64_t serial_no = ++*request_serial_;
-    rpcs_.RegisterAndStart(
-        client::GetTransactionStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client,
-            &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no, mutex)),
-        &get_status_handle_);
-  }
-
-  void StatusReceived(client::YBClient* client,
-                      const Status& status,
-                      const tserver::GetTransactionStatusResponsePB& response,
-                      int64_t serial_no,
-                      std::mutex* mutex) const {
-    auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
-    if (delay_usec > 0) {
-      delayer_.Delay(
-          MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
-          std::bind(&RunningTransaction::DoStatusReceived, this, client, status, response,
-                    serial_no, mutex));
-    } else {
-      DoStatusReceived(client, status, response, serial_no, mutex);
-    }
-  }
-
-  void DoStatusReceived(client::YBClient* client,
-                        const Status& status,
-                        const tserver::GetTransactionStatusResponsePB& response,
+  void DoStatusReceived(const Status& status,
+                        TransactionStatus received_status,
+                        HybridTime time,
                         int64_t serial_no,
                         std::mutex* mutex) const {
-    if (response.has_propagated_hybrid_time()) {
-      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
-    }
-
-    rpcs_.Unregister(&get_status_handle_);
     decltype(status_waiters_) status_waiters;
-    HybridTime time;
     TransactionStatus transaction_status;
     const bool ok = status.ok();
     bool send_new_request;
     {
       std::unique_lock<std::mutex> lock(*mutex);
       if (ok) {
-        DCHECK(response.has_status_hybrid_time() ||
-               response.status() == TransactionStatus::ABORTED);
-        time = response.has_status_hybrid_time()
-            ? HybridTime(response.status_hybrid_time())
-            : HybridTime::kMax;
         if (last_known_status_hybrid_time_ <= time) {
           last_known_status_hybrid_time_ = time;
-          last_known_status_ = response.status();
+          last_known_status_ = received_status;
         }
         time = last_known_status_hybrid_time_;
         transaction_status = last_known_status_;
@@ -301,7 +284,7 @@ class RunningTransaction {
       send_new_request = !status_waiters_.empty();
     }
     if (send_new_request) {
-      SendStatusRequest(client, mutex);
+      status_request_sender_.RequestStatus(metadata_);
     }
     if (!ok) {
       for (const auto& waiter : status_waiters) {
@@ -368,13 +351,12 @@ class RunningTransaction {
   TransactionMetadata metadata_;
   rpc::Rpcs& rpcs_;
   TransactionParticipantContext& context_;
-  std::atomic<int64_t>* request_serial_;
+  StatusRequestSender& status_request_sender_;
   HybridTime local_commit_time_ = HybridTime::kInvalid;
 
   mutable TransactionStatus last_known_status_;
   mutable HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   mutable std::vector<StatusRequest> status_waiters_;
-  mutable rpc::Rpcs::Handle get_status_handle_;
   mutable rpc::Rpcs::Handle abort_handle_;
   mutable std::vector<TransactionStatusCallback> abort_waiters_;
 
@@ -384,14 +366,16 @@ class RunningTransaction {
 
 } // namespace
 
-class TransactionParticipant::Impl {
+class TransactionParticipant::Impl : public StatusRequestSender {
  public:
   explicit Impl(TransactionParticipantContext* context)
       : context_(*context), log_prefix_(context->tablet_id() + ": ") {}
 
   ~Impl() {
-    transactions_.clear();
+    // Status requests are shared by transactions, so should be completed while transactions are
+    // still alive.
     rpcs_.Shutdown();
+    transactions_.clear();
   }
 
   // Adds new running transaction.
@@ -406,7 +390,7 @@ class TransactionParticipant::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       auto it = transactions_.find(metadata->transaction_id);
       if (it == transactions_.end()) {
-        transactions_.emplace(*metadata, &rpcs_, &context_, &request_serial_);
+        transactions_.emplace(*metadata, &rpcs_, &context_, this);
         store = true;
       } else {
         DCHECK_EQ(it->metadata(), *metadata);
@@ -447,7 +431,7 @@ class TransactionParticipant::Impl {
           STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
       return;
     }
-    return it->RequestStatusAt(client(), request, &lock);
+    return it->RequestStatusAt(request, &lock);
   }
 
   int64_t RegisterRequest() {
@@ -522,7 +506,111 @@ class TransactionParticipant::Impl {
     db_ = db;
   }
 
+  // Status requests are batched per status tablet. While there is a request to status tablet in
+  // flight, status requests of other transactions managed by this tablet are accumulated and then
+  // sent together in a single RPC.
+  void RequestStatus(const TransactionMetadata& metadata) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& requests = status_requests_[metadata.status_tablet];
+      requests.pending.push_back(metadata.transaction_id);
+      if (requests.in_flight) {
+        return;
+      }
+      requests.in_flight = true;
+    }
+    SendStatusRequest(metadata.status_tablet);
+  }
+
  private:
+  struct StatusTabletRequests {
+    // Whether there is status request to this status tablet in flight.
+    bool in_flight = false;
+    // Transactions that should be queried when request in flight completes.
+    std::vector<TransactionId> pending;
+  };
+
+  void SendStatusRequest(const TabletId& status_tablet) {
+    std::vector<TransactionId> ids;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = status_requests_.find(status_tablet);
+      DCHECK(it != status_requests_.end()) << "No status requests to " << status_tablet;
+      if (it == status_requests_.end()) {
+        return;
+      }
+      ids.swap(it->second.pending);
+      if (ids.empty()) {
+        status_requests_.erase(it);
+        return;
+      }
+    }
+
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(status_tablet);
+    for (const auto& id : ids) {
+      req.add_transaction_id(id.begin(), id.size());
+    }
+    req.set_propagated_hybrid_time(context_.Now().ToUint64());
+    int64_t serial_no = ++request_serial_;
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      StatusesReceived(status_tablet, ids, STATUS(Aborted, "Transaction participant shutdown"),
+                       tserver::GetTransactionStatusResponsePB(), serial_no);
+      return;
+    }
+    *handle = client::GetTransactionStatus(
+        TransactionRpcDeadline(),
+        nullptr /* tablet */,
+        client(),
+        &req,
+        [this, handle, status_tablet, ids = std::move(ids), serial_no](
+            const Status& status, const tserver::GetTransactionStatusResponsePB& response) {
+          rpcs_.Unregister(handle);
+          StatusesReceived(status_tablet, ids, status, response, serial_no);
+        });
+    (**handle).SendRpc();
+  }
+
+  void StatusesReceived(const TabletId& status_tablet,
+                        const std::vector<TransactionId>& ids,
+                        Status status,
+                        const tserver::GetTransactionStatusResponsePB& response,
+                        int64_t serial_no) {
+    if (response.has_propagated_hybrid_time()) {
+      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+    }
+    if (status.ok() && (static_cast<size_t>(response.status_size()) != ids.size() ||
+                        static_cast<size_t>(response.status_hybrid_time_size()) != ids.size())) {
+      status = STATUS_FORMAT(
+          IllegalState, "Wrong number of statuses received for $0 transactions: $1",
+          ids.size(), response.ShortDebugString());
+    }
+
+    for (size_t i = 0; i != ids.size(); ++i) {
+      const RunningTransaction* transaction;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = transactions_.find(ids[i]);
+        if (it == transactions_.end()) {
+          continue;
+        }
+        transaction = &*it;
+      }
+      if (status.ok()) {
+        transaction->StatusReceived(
+            status, response.status(i), HybridTime(response.status_hybrid_time(i)), serial_no,
+            &mutex_);
+      } else {
+        transaction->StatusReceived(
+            status, TransactionStatus::PENDING, HybridTime::kInvalid, serial_no, &mutex_);
+      }
+    }
+
+    // Send requests accumulated while this one was in flight.
+    SendStatusRequest(status_tablet);
+  }
+
   typedef boost::multi_index_container<RunningTransaction,
       boost::multi_index::indexed_by <
           boost::multi_index::hashed_unique <
@@ -565,7 +653,7 @@ class TransactionParticipant::Impl {
       return it;
     }
 
-    it = transactions_.emplace(std::move(*metadata), &rpcs_, &context_, &request_serial_).first;
+    it = transactions_.emplace(std::move(*metadata), &rpcs_, &context_, this).first;
 
     return it;
   }
@@ -586,6 +674,7 @@ class TransactionParticipant::Impl {
   rpc::Rpcs rpcs_;
   Transactions transactions_;
   std::atomic<int64_t> request_serial_{0};
+  std::unordered_map<TabletId, StatusTabletRequests> status_requests_;
 };
 
 TransactionParticipant::TransactionParticipant(TransactionParticipantContext* context)
@@ -0,0 +1,159 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/write_coalescer.h"
+#include "yb/tablet/operations/write_operation.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+class RecordingCallback : public OperationCompletionCallback {
+ public:
+  explicit RecordingCallback(std::vector<Status>* statuses) : statuses_(statuses) {}
+
+  void OperationCompleted() override {
+    statuses_->push_back(status_);
+  }
+
+ private:
+  std::vector<Status>* statuses_;
+};
+
+} // namespace
+
+class WriteCoalescerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_write_coalescing_max_batch_size = 3;
+    FLAGS_write_coalescing_max_inflight_groups = 2;
+    coalescer_ = std::make_unique<WriteCoalescer>(
+        nullptr /* tablet */,
+        [this](std::unique_ptr<WriteOperationState> state) -> Status {
+          RETURN_NOT_OK(submit_status_);
+          submitted_.push_back(std::move(state));
+          return Status::OK();
+        },
+        scoped_refptr<Histogram>());
+  }
+
+  void TearDown() override {
+    // Complete whatever is still replicating, so that no write is left pending.
+    while (!submitted_.empty()) {
+      auto state = std::move(submitted_.front());
+      submitted_.erase(submitted_.begin());
+      state->completion_callback()->OperationCompleted();
+    }
+    coalescer_.reset();
+    YBTest::TearDown();
+  }
+
+  std::unique_ptr<WriteOperationState> NewWrite(int key) {
+    tserver::WriteRequestPB request;
+    request.set_tablet_id("tablet");
+    auto* kv_pair = request.mutable_write_batch()->add_kv_pairs();
+    kv_pair->set_key(Format("key$0", key));
+    kv_pair->set_value(Format("value$0", key));
+    auto state = std::make_unique<WriteOperationState>(nullptr /* tablet */, &request);
+    state->set_completion_callback(std::make_unique<RecordingCallback>(&completed_));
+    return state;
+  }
+
+  std::vector<std::string> SubmittedKeys(size_t index) {
+    std::vector<std::string> result;
+    for (const auto& kv_pair : submitted_[index]->request()->write_batch().kv_pairs()) {
+      result.push_back(kv_pair.key());
+    }
+    return result;
+  }
+
+  std::unique_ptr<WriteCoalescer> coalescer_;
+  std::vector<std::unique_ptr<WriteOperationState>> submitted_;
+  std::vector<Status> completed_;
+  Status submit_status_;
+};
+
+TEST_F(WriteCoalescerTest, TestMergesWhileGroupsAreInflight) {
+  // Below the limit on inflight groups, writes are submitted right away.
+  coalescer_->Submit(NewWrite(0));
+  coalescer_->Submit(NewWrite(1));
+  ASSERT_EQ(2, submitted_.size());
+  ASSERT_EQ(std::vector<std::string>({"key0"}), SubmittedKeys(0));
+
+  // Then they wait for a group to complete.
+  coalescer_->Submit(NewWrite(2));
+  coalescer_->Submit(NewWrite(3));
+  ASSERT_EQ(2, submitted_.size());
+
+  submitted_[0]->completion_callback()->OperationCompleted();
+  ASSERT_EQ(1, completed_.size());
+  ASSERT_OK(completed_[0]);
+  ASSERT_EQ(3, submitted_.size());
+  ASSERT_EQ(std::vector<std::string>({"key2", "key3"}), SubmittedKeys(2));
+
+  // A full batch does not wait.
+  coalescer_->Submit(NewWrite(4));
+  coalescer_->Submit(NewWrite(5));
+  ASSERT_EQ(3, submitted_.size());
+  coalescer_->Submit(NewWrite(6));
+  ASSERT_EQ(4, submitted_.size());
+  ASSERT_EQ(std::vector<std::string>({"key4", "key5", "key6"}), SubmittedKeys(3));
+
+  // An error of the merged operation is reported to every write of the group.
+  auto* callback = submitted_[3]->completion_callback();
+  callback->set_error(STATUS(IllegalState, "Not the leader"));
+  callback->OperationCompleted();
+  ASSERT_EQ(4, completed_.size());
+  for (size_t i = 1; i != completed_.size(); ++i) {
+    ASSERT_TRUE(completed_[i].IsIllegalState()) << completed_[i];
+  }
+}
+
+TEST_F(WriteCoalescerTest, TestSubmitFailure) {
+  submit_status_ = STATUS(ServiceUnavailable, "Shutting down");
+  coalescer_->Submit(NewWrite(0));
+  ASSERT_EQ(1, completed_.size());
+  ASSERT_TRUE(completed_[0].IsServiceUnavailable()) << completed_[0];
+
+  // The failed group does not hold an inflight slot.
+  submit_status_ = Status::OK();
+  coalescer_->Submit(NewWrite(1));
+  coalescer_->Submit(NewWrite(2));
+  ASSERT_EQ(2, submitted_.size());
+}
+
+TEST_F(WriteCoalescerTest, TestCanCoalesce) {
+  auto write = NewWrite(0);
+  ASSERT_TRUE(WriteCoalescer::CanCoalesce(*write));
+
+  write->mutable_request()->mutable_transaction_meta()->set_transaction_id("txn");
+  ASSERT_FALSE(WriteCoalescer::CanCoalesce(*write));
+
+  FLAGS_write_coalescing_max_batch_size = 1;
+  ASSERT_FALSE(WriteCoalescer::CanCoalesce(*NewWrite(1)));
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,162 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/write_coalescer.h"
+
+#include <atomic>
+
+#include "yb/tablet/operations/write_operation.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_int32(write_coalescing_max_batch_size, 32,
+             "Maximum number of concurrent write requests to a tablet that are merged into a "
+             "single replicated write operation. 1 disables merging.");
+TAG_FLAG(write_coalescing_max_batch_size, advanced);
+TAG_FLAG(write_coalescing_max_batch_size, runtime);
+
+DEFINE_int32(write_coalescing_max_inflight_groups, 4,
+             "Number of write operations of a tablet that are replicated at the same time before "
+             "concurrent write requests are held back to be merged into the next one.");
+TAG_FLAG(write_coalescing_max_inflight_groups, advanced);
+TAG_FLAG(write_coalescing_max_inflight_groups, runtime);
+
+namespace yb {
+namespace tablet {
+
+using tserver::TabletServerErrorPB;
+
+// The writes merged into one operation. Shared by the completion callback of the operation and
+// the coalescer, which completes the writes itself when the operation could not be submitted.
+class WriteCoalescer::Group {
+ public:
+  Group(WriteCoalescer* coalescer, Writes writes)
+      : coalescer_(coalescer), writes_(std::move(writes)) {}
+
+  void Complete(const Status& status, TabletServerErrorPB::Code code) {
+    if (completed_.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    for (const auto& write : writes_) {
+      auto* callback = write->completion_callback();
+      if (!status.ok()) {
+        callback->set_error(status, code);
+      }
+      callback->OperationCompleted();
+    }
+    writes_.clear();
+    coalescer_->GroupCompleted();
+  }
+
+ private:
+  WriteCoalescer* const coalescer_;
+  Writes writes_;
+  std::atomic<bool> completed_{false};
+};
+
+class WriteCoalescer::GroupCompletionCallback : public OperationCompletionCallback {
+ public:
+  explicit GroupCompletionCallback(std::shared_ptr<WriteCoalescer::Group> group)
+      : group_(std::move(group)) {}
+
+  void OperationCompleted() override {
+    group_->Complete(status_, code_);
+  }
+
+ private:
+  std::shared_ptr<WriteCoalescer::Group> group_;
+};
+
+WriteCoalescer::WriteCoalescer(Tablet* tablet, Submitter submitter,
+                               scoped_refptr<Histogram> group_size_histogram)
+    : tablet_(tablet), submitter_(std::move(submitter)),
+      group_size_histogram_(std::move(group_size_histogram)) {
+}
+
+WriteCoalescer::~WriteCoalescer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DCHECK(pending_.empty()) << "Writes pending at shutdown: " << pending_.size();
+}
+
+bool WriteCoalescer::CanCoalesce(const WriteOperationState& state) {
+  if (FLAGS_write_coalescing_max_batch_size <= 1) {
+    return false;
+  }
+  const auto& request = *state.request();
+  return !request.has_transaction_meta() && !request.write_batch().has_transaction();
+}
+
+void WriteCoalescer::Submit(std::unique_ptr<WriteOperationState> state) {
+  Writes writes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (inflight_groups_ < FLAGS_write_coalescing_max_inflight_groups) {
+      writes.push_back(std::move(state));
+    } else {
+      pending_.push_back(std::move(state));
+      if (pending_.size() < static_cast<size_t>(FLAGS_write_coalescing_max_batch_size)) {
+        return;
+      }
+      // Don't let a burst grow a group without bound, it would only delay all of its writes.
+      writes.swap(pending_);
+    }
+    ++inflight_groups_;
+  }
+  SubmitGroup(std::move(writes));
+}
+
+void WriteCoalescer::SubmitGroup(Writes writes) {
+  if (group_size_histogram_) {
+    group_size_histogram_->Increment(writes.size());
+  }
+
+  tserver::WriteRequestPB request;
+  request.set_tablet_id(writes.front()->request()->tablet_id());
+  auto group_state = std::make_unique<WriteOperationState>(tablet_, &request);
+  auto* kv_pairs = group_state->mutable_request()->mutable_write_batch()->mutable_kv_pairs();
+  for (const auto& write : writes) {
+    // Write ids of the pairs are their indexes in the batch, so they stay unique after merging.
+    for (auto& kv_pair : *write->mutable_request()->mutable_write_batch()->mutable_kv_pairs()) {
+      kv_pairs->Add()->Swap(&kv_pair);
+    }
+    // Released right after the merged batch is applied, as for a single write.
+    group_state->AddDocDBLocks(write->TakeDocDBLocks());
+  }
+
+  auto group = std::make_shared<Group>(this, std::move(writes));
+  group_state->set_completion_callback(std::make_unique<GroupCompletionCallback>(group));
+  auto status = submitter_(std::move(group_state));
+  if (!status.ok()) {
+    group->Complete(status, TabletServerErrorPB::UNKNOWN_ERROR);
+  }
+}
+
+void WriteCoalescer::GroupCompleted() {
+  Writes writes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty()) {
+      --inflight_groups_;
+      return;
+    }
+    // The writes that waited take over the slot of the completed group.
+    writes.swap(pending_);
+  }
+  SubmitGroup(std::move(writes));
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_WRITE_COALESCER_H
+#define YB_TABLET_WRITE_COALESCER_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/status.h"
+
+DECLARE_int32(write_coalescing_max_batch_size);
+DECLARE_int32(write_coalescing_max_inflight_groups);
+
+namespace yb {
+
+class Histogram;
+
+namespace tablet {
+
+class Tablet;
+class WriteOperationState;
+
+// Merges concurrent write RPCs to a tablet into a single write operation, i.e. a single
+// replicate message, WAL entry and RocksDB write batch, and fans the result out to the
+// original requests when the merged operation completes.
+//
+// This is group commit: a write is submitted right away while fewer than
+// --write_coalescing_max_inflight_groups merged operations are being replicated, so a lightly
+// loaded tablet sees no extra latency. Otherwise it waits for one of them to complete, together
+// with the other writes that arrived meanwhile.
+//
+// Only writes that already had their doc operations performed, and thus hold the locks on the
+// keys they write, are submitted here. So the writes of a group never conflict with each other.
+class WriteCoalescer {
+ public:
+  // Starts replication of the write operation with the given state. When an error is returned,
+  // the completion callback of the state is not invoked.
+  typedef std::function<Status(std::unique_ptr<WriteOperationState>)> Submitter;
+
+  WriteCoalescer(Tablet* tablet, Submitter submitter,
+                 scoped_refptr<Histogram> group_size_histogram);
+  ~WriteCoalescer();
+
+  // Whether the write can be replicated as part of a group. Writes of distributed transactions
+  // are not, their intents are tied to the transaction of their own request. No write is when
+  // merging is disabled.
+  static bool CanCoalesce(const WriteOperationState& state);
+
+  // Submits the write for replication, possibly together with other writes. The completion
+  // callback of the state is always invoked, with an error if the write could not be replicated.
+  void Submit(std::unique_ptr<WriteOperationState> state);
+
+ private:
+  class Group;
+  class GroupCompletionCallback;
+  typedef std::vector<std::unique_ptr<WriteOperationState>> Writes;
+
+  void SubmitGroup(Writes writes);
+  void GroupCompleted();
+
+  Tablet* const tablet_;
+  const Submitter submitter_;
+  scoped_refptr<Histogram> group_size_histogram_;
+
+  std::mutex mutex_;
+  // Number of merged operations that were submitted and did not complete yet.
+  int inflight_groups_ = 0;
+  // Writes waiting for a merged operation to complete.
+  Writes pending_;
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_WRITE_COALESCER_H
@@ -0,0 +1,146 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <set>
+#include <vector>
+
+#include "yb/consensus/log.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/tserver/cdc_producer.h"
+#include "yb/tserver/tablet_server-test-base.h"
+
+namespace yb {
+namespace tserver {
+
+class CDCProducerTest : public TabletServerTestBase {
+ protected:
+  void SetUp() override {
+    TabletServerTestBase::SetUp();
+    StartTabletServer();
+  }
+
+  std::unique_ptr<CDCProducer> NewProducer(int64_t checkpoint_index) {
+    return std::make_unique<CDCProducer>(
+        tablet_peer_, "stream", checkpoint_index, [this](WriteRequestPB* batch) -> Status {
+          RETURN_NOT_OK(sink_status_);
+          shipped_.push_back(*batch);
+          return Status::OK();
+        });
+  }
+
+  std::vector<WriteRequestPB> shipped_;
+  Status sink_status_;
+};
+
+TEST_F(CDCProducerTest, TestShipsCommittedWrites) {
+  const int kNumRows = 10;
+  InsertTestRowsRemote(0 /* tid */, 0 /* first_row */, kNumRows);
+  const int64_t last_index = tablet_peer_->log()->GetLatestEntryOpId().index;
+
+  auto producer = NewProducer(0);
+
+  // A failed batch is shipped again by the next poll.
+  sink_status_ = STATUS(NetworkError, "Target unreachable");
+  ASSERT_NOK(producer->Poll());
+  ASSERT_EQ(0, producer->checkpoint_index());
+
+  sink_status_ = Status::OK();
+  auto consumed = producer->Poll();
+  ASSERT_OK(consumed);
+  ASSERT_EQ(last_index, static_cast<int64_t>(*consumed));
+  ASSERT_EQ(last_index, producer->checkpoint_index());
+  ASSERT_EQ(1, shipped_.size());
+  ASSERT_GE(shipped_[0].write_batch().kv_pairs_size(), kNumRows);
+  for (const auto& kv_pair : shipped_[0].write_batch().kv_pairs()) {
+    ASSERT_TRUE(kv_pair.has_external_hybrid_time());
+  }
+
+  // Nothing new to ship.
+  consumed = producer->Poll();
+  ASSERT_OK(consumed);
+  ASSERT_EQ(0, *consumed);
+
+  // The shipped batch is accepted as an external write.
+  {
+    WriteResponsePB resp;
+    rpc::RpcController controller;
+    ASSERT_OK(proxy_->Write(shipped_[0], &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  }
+
+  // While raw pairs without their hybrid times are still rejected.
+  {
+    auto batch = shipped_[0];
+    batch.mutable_write_batch()->mutable_kv_pairs(0)->clear_external_hybrid_time();
+    WriteResponsePB resp;
+    rpc::RpcController controller;
+    ASSERT_OK(proxy_->Write(batch, &resp, &controller));
+    ASSERT_TRUE(resp.has_error());
+  }
+}
+
+TEST_F(CDCProducerTest, TestGetChanges) {
+  const int kNumRows = 10;
+  InsertTestRowsRemote(0 /* tid */, 0 /* first_row */, kNumRows);
+  const int64_t last_index = tablet_peer_->log()->GetLatestEntryOpId().index;
+
+  GetChangesRequestPB req;
+  req.set_tablet_id(kTabletId);
+  req.set_consumer_id("consumer");
+  GetChangesResponsePB resp;
+  {
+    rpc::RpcController controller;
+    ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  }
+  ASSERT_EQ(last_index, resp.checkpoint_op_index());
+  ASSERT_EQ(kNumRows, resp.records_size());
+  std::set<int32_t> keys;
+  for (const auto& record : resp.records()) {
+    ASSERT_GT(record.changes_size(), 0);
+    for (const auto& change : record.changes()) {
+      ASSERT_EQ(1, change.key_size());
+      keys.insert(change.key(0).int32_value());
+      ASSERT_FALSE(change.deleted());
+      ASSERT_EQ(change.has_column_id(), change.has_value()) << change.ShortDebugString();
+    }
+  }
+  ASSERT_EQ(kNumRows, keys.size());
+
+  // Nothing new after the returned checkpoint, even when waiting for it.
+  req.set_from_op_index(resp.checkpoint_op_index());
+  req.set_wait_ms(100);
+  {
+    rpc::RpcController controller;
+    ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  }
+  ASSERT_EQ(0, resp.records_size());
+  ASSERT_EQ(last_index, resp.checkpoint_op_index());
+
+  // The checkpoint of the consumer was stored, so it resumes after the new write only.
+  InsertTestRowsRemote(0 /* tid */, kNumRows /* first_row */, 1);
+  req.clear_from_op_index();
+  {
+    rpc::RpcController controller;
+    ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  }
+  ASSERT_EQ(1, resp.records_size());
+  ASSERT_EQ(kNumRows, resp.records(0).changes(0).key(0).int32_value());
+}
+
+}  // namespace tserver
+}  // namespace yb
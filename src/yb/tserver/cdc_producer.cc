@@ -0,0 +1,338 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/cdc_producer.h"
+
+#include <algorithm>
+
+#include "yb/common/schema.h"
+#include "yb/common/wire_protocol.h"
+
+#include "yb/consensus/consensus.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/tserver/tserver.pb.h"
+#include "yb/tserver/tserver_service.proxy.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/thread.h"
+#include "yb/util/threadpool.h"
+
+DEFINE_int32(cdc_max_batch_bytes, 4 * 1024 * 1024,
+             "Maximum size of the log entries that a CDC producer reads and ships at a time.");
+TAG_FLAG(cdc_max_batch_bytes, advanced);
+TAG_FLAG(cdc_max_batch_bytes, runtime);
+
+DEFINE_int32(cdc_poll_interval_ms, 100,
+             "How often the CDC producers of a tablet server check their tablets for new writes.");
+TAG_FLAG(cdc_poll_interval_ms, advanced);
+TAG_FLAG(cdc_poll_interval_ms, runtime);
+
+DEFINE_int32(cdc_max_parallel_tablets, 8,
+             "Maximum number of tablets whose writes are shipped by CDC at the same time.");
+TAG_FLAG(cdc_max_parallel_tablets, advanced);
+
+namespace yb {
+namespace tserver {
+
+CDCProducer::CDCProducer(tablet::TabletPeerPtr tablet_peer, std::string stream_id,
+                         int64_t checkpoint_index, Sink sink)
+    : tablet_peer_(std::move(tablet_peer)), stream_id_(std::move(stream_id)),
+      sink_(std::move(sink)), checkpoint_index_(checkpoint_index) {
+  tablet_peer_->log_anchor_registry()->Register(checkpoint_index + 1, stream_id_, &log_anchor_);
+}
+
+CDCProducer::~CDCProducer() {
+  WARN_NOT_OK(tablet_peer_->log_anchor_registry()->UnregisterIfAnchored(&log_anchor_),
+              "Failed to unregister CDC log anchor");
+}
+
+Result<size_t> CDCProducer::Poll() {
+  consensus::ReplicateMsgs replicates;
+  RETURN_NOT_OK(tablet_peer_->consensus()->ReadCommittedReplicates(
+      checkpoint_index(), FLAGS_cdc_max_batch_bytes, &replicates));
+  if (replicates.empty()) {
+    return 0;
+  }
+
+  WriteRequestPB batch;
+  batch.set_tablet_id(tablet_id());
+  auto* kv_pairs = batch.mutable_write_batch()->mutable_kv_pairs();
+  for (const auto& replicate : replicates) {
+    if (replicate->op_type() != consensus::WRITE_OP ||
+        replicate->write_request().write_batch().has_transaction()) {
+      continue;
+    }
+    for (const auto& kv_pair : replicate->write_request().write_batch().kv_pairs()) {
+      auto* external_pair = kv_pairs->Add();
+      *external_pair = kv_pair;
+      external_pair->set_external_hybrid_time(replicate->hybrid_time());
+    }
+  }
+  if (!kv_pairs->empty()) {
+    RETURN_NOT_OK(sink_(&batch));
+  }
+
+  const int64_t new_checkpoint_index = replicates.back()->id().index();
+  RETURN_NOT_OK(tablet_peer_->log_anchor_registry()->UpdateRegistration(
+      new_checkpoint_index + 1, stream_id_, &log_anchor_));
+  checkpoint_index_.store(new_checkpoint_index, std::memory_order_release);
+  return replicates.size();
+}
+
+CDCProducer::Sink RemoteTabletSink(std::shared_ptr<TabletServerServiceProxy> proxy,
+                                   std::string target_tablet_id, MonoDelta timeout) {
+  return [proxy = std::move(proxy), target_tablet_id = std::move(target_tablet_id), timeout](
+      WriteRequestPB* batch) -> Status {
+    batch->set_tablet_id(target_tablet_id);
+    WriteResponsePB resp;
+    rpc::RpcController controller;
+    controller.set_timeout(timeout);
+    RETURN_NOT_OK(proxy->Write(*batch, &resp, &controller));
+    if (resp.has_error()) {
+      return StatusFromPB(resp.error().status());
+    }
+    return Status::OK();
+  };
+}
+
+namespace {
+
+CHECKED_STATUS DecodeKeyColumns(const Schema& schema, const docdb::DocKey& doc_key,
+                                CDCRowChangePB* change) {
+  size_t key_column = 0;
+  for (const auto* group : {&doc_key.hashed_group(), &doc_key.range_group()}) {
+    for (const auto& component : *group) {
+      if (key_column == schema.num_key_columns()) {
+        return STATUS_FORMAT(Corruption, "Too many key components: $0", doc_key);
+      }
+      docdb::PrimitiveValue::ToQLValuePB(
+          component, schema.column(key_column).type(), change->add_key());
+      ++key_column;
+    }
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS DecodeRangeDelete(const Schema& schema, const docdb::KeyValuePairPB& kv_pair,
+                                 CDCRowChangePB* change) {
+  // The range starts with the hashed part of the DocKeys of the partition.
+  Slice start(kv_pair.key());
+  start.consume_byte();
+  change->set_range_start(start.ToBuffer());
+  change->set_range_end(kv_pair.value());
+  change->set_deleted(true);
+  docdb::DocKey doc_key;
+  RETURN_NOT_OK(doc_key.DecodeFrom(&start, docdb::DocKeyPart::HASHED_PART_ONLY));
+  return DecodeKeyColumns(schema, doc_key, change);
+}
+
+CHECKED_STATUS DecodeRowChange(const Schema& schema, const docdb::KeyValuePairPB& kv_pair,
+                               CDCRowChangePB* change) {
+  if (!kv_pair.key().empty() &&
+      kv_pair.key()[0] == static_cast<char>(docdb::ValueType::kRangeTombstonePrefix)) {
+    return DecodeRangeDelete(schema, kv_pair, change);
+  }
+  docdb::SubDocKey sub_doc_key;
+  // Hybrid times are only added to the keys when the batch is applied.
+  RETURN_NOT_OK(sub_doc_key.FullyDecodeFrom(kv_pair.key(), docdb::HybridTimeRequired::kFalse));
+  RETURN_NOT_OK(DecodeKeyColumns(schema, sub_doc_key.doc_key(), change));
+
+  if (sub_doc_key.num_subkeys() > 0 &&
+      sub_doc_key.subkeys()[0].value_type() == docdb::ValueType::kColumnId) {
+    change->set_column_id(sub_doc_key.subkeys()[0].GetColumnId().rep());
+  }
+
+  docdb::Value value;
+  RETURN_NOT_OK(value.Decode(kv_pair.value()));
+  if (value.value_type() == docdb::ValueType::kTombstone) {
+    change->set_deleted(true);
+  } else if (change->has_column_id() && sub_doc_key.num_subkeys() == 1) {
+    auto column = schema.column_by_id(ColumnId(change->column_id()));
+    RETURN_NOT_OK(column);
+    docdb::PrimitiveValue::ToQLValuePB(
+        value.primitive_value(), column->type(), change->mutable_value());
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+Status DecodeCDCRecord(const Schema& schema, const consensus::ReplicateMsg& replicate,
+                       CDCRecordPB* record) {
+  record->set_op_index(replicate.id().index());
+  record->set_hybrid_time(replicate.hybrid_time());
+  const auto& write_batch = replicate.write_request().write_batch();
+  if (write_batch.has_transaction()) {
+    return Status::OK();
+  }
+  for (const auto& kv_pair : write_batch.kv_pairs()) {
+    RETURN_NOT_OK(DecodeRowChange(schema, kv_pair, record->add_changes()));
+  }
+  return Status::OK();
+}
+
+struct CDCCheckpoints::Checkpoint {
+  int64_t op_index = 0;
+  scoped_refptr<log::LogAnchorRegistry> log_anchor_registry;
+  log::LogAnchor log_anchor;
+
+  ~Checkpoint() {
+    WARN_NOT_OK(log_anchor_registry->UnregisterIfAnchored(&log_anchor),
+                "Failed to unregister CDC log anchor");
+  }
+};
+
+CDCCheckpoints::CDCCheckpoints() {
+}
+
+CDCCheckpoints::~CDCCheckpoints() {
+}
+
+int64_t CDCCheckpoints::Get(const std::string& consumer_id, const std::string& tablet_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = checkpoints_.find(std::make_pair(consumer_id, tablet_id));
+  return it != checkpoints_.end() ? it->second->op_index : 0;
+}
+
+Status CDCCheckpoints::Update(const tablet::TabletPeerPtr& tablet_peer,
+                              const std::string& consumer_id,
+                              int64_t op_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& checkpoint = checkpoints_[std::make_pair(consumer_id, tablet_peer->tablet_id())];
+  if (!checkpoint) {
+    checkpoint = std::make_unique<Checkpoint>();
+    checkpoint->log_anchor_registry = tablet_peer->log_anchor_registry();
+    checkpoint->log_anchor_registry->Register(op_index + 1, consumer_id, &checkpoint->log_anchor);
+  } else if (checkpoint->op_index != op_index) {
+    RETURN_NOT_OK(checkpoint->log_anchor_registry->UpdateRegistration(
+        op_index + 1, consumer_id, &checkpoint->log_anchor));
+  }
+  checkpoint->op_index = op_index;
+  return Status::OK();
+}
+
+struct CDCProducerManager::ProducerEntry {
+  std::unique_ptr<CDCProducer> producer;
+  // Serial, so that a producer is polled by one thread at a time.
+  std::unique_ptr<ThreadPoolToken> token;
+  std::atomic<bool> polling{false};
+};
+
+CDCProducerManager::CDCProducerManager() : shutdown_latch_(1) {
+}
+
+CDCProducerManager::~CDCProducerManager() {
+  Shutdown();
+}
+
+Status CDCProducerManager::Start() {
+  RETURN_NOT_OK(ThreadPoolBuilder("cdc")
+      .set_max_threads(FLAGS_cdc_max_parallel_tablets)
+      .Build(&pool_));
+  return Thread::Create("cdc", "cdc-poll", &CDCProducerManager::RunThread, this, &thread_);
+}
+
+void CDCProducerManager::Shutdown() {
+  if (shutdown_latch_.count() == 0) {
+    return;
+  }
+  shutdown_latch_.CountDown();
+  if (thread_) {
+    thread_->Join();
+  }
+  std::vector<std::shared_ptr<ProducerEntry>> producers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    producers.swap(producers_);
+  }
+  // Tokens have to be destroyed before their pool.
+  for (const auto& entry : producers) {
+    entry->token->Shutdown();
+  }
+  producers.clear();
+  if (pool_) {
+    pool_->Shutdown();
+  }
+}
+
+void CDCProducerManager::AddProducer(std::unique_ptr<CDCProducer> producer) {
+  DCHECK(pool_) << "Producer added before start";
+  auto entry = std::make_shared<ProducerEntry>();
+  entry->producer = std::move(producer);
+  entry->token = pool_->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  std::lock_guard<std::mutex> lock(mutex_);
+  producers_.push_back(std::move(entry));
+}
+
+bool CDCProducerManager::RemoveProducer(const std::string& tablet_id) {
+  std::shared_ptr<ProducerEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(
+        producers_.begin(), producers_.end(),
+        [&tablet_id](const auto& entry) { return entry->producer->tablet_id() == tablet_id; });
+    if (it == producers_.end()) {
+      return false;
+    }
+    entry = std::move(*it);
+    producers_.erase(it);
+  }
+  // Waits for the poll in progress, if any.
+  entry->token->Shutdown();
+  return true;
+}
+
+void CDCProducerManager::RunThread() {
+  do {
+    std::vector<std::shared_ptr<ProducerEntry>> producers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      producers = producers_;
+    }
+    for (const auto& entry : producers) {
+      if (entry->polling.exchange(true, std::memory_order_acq_rel)) {
+        continue;
+      }
+      auto status = entry->token->SubmitFunc([this, entry] { PollProducer(entry); });
+      if (!status.ok()) {
+        entry->polling.store(false, std::memory_order_release);
+      }
+    }
+  } while (!shutdown_latch_.WaitFor(MonoDelta::FromMilliseconds(FLAGS_cdc_poll_interval_ms)));
+}
+
+void CDCProducerManager::PollProducer(const std::shared_ptr<ProducerEntry>& entry) {
+  // Keep shipping while the producer is behind, instead of waiting for the next period.
+  while (shutdown_latch_.count() != 0) {
+    auto consumed = entry->producer->Poll();
+    if (!consumed.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 10)
+          << "CDC of tablet " << entry->producer->tablet_id() << " failed: " << consumed.status();
+      break;
+    }
+    if (*consumed == 0) {
+      break;
+    }
+  }
+  entry->polling.store(false, std::memory_order_release);
+}
+
+}  // namespace tserver
+}  // namespace yb
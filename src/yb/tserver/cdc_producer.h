@@ -0,0 +1,170 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_CDC_PRODUCER_H
+#define YB_TSERVER_CDC_PRODUCER_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/consensus/log_anchor_registry.h"
+
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+DECLARE_int32(cdc_max_batch_bytes);
+
+namespace yb {
+
+class Schema;
+class Thread;
+class ThreadPool;
+class ThreadPoolToken;
+
+namespace consensus {
+class ReplicateMsg;
+}
+
+namespace tserver {
+
+class CDCRecordPB;
+class TabletServerServiceProxy;
+class WriteRequestPB;
+
+// Change data capture of a tablet: ships the writes committed to the tablet, read back from the
+// log cache or from its WAL, to a sink, e.g. the matching tablet of another cluster. Works off the
+// log only, so the write path of the tablet is not affected, except that the log segments that
+// were not shipped yet are retained.
+//
+// Each write is shipped with the hybrid time it was committed at, so that the other cluster
+// applies it with the same one. Writes of distributed transactions are not shipped, the log only
+// has their intents.
+class CDCProducer {
+ public:
+  // Receives the pairs written to the source tablet, in log order, as a write request for the
+  // target tablet with every pair carrying its external_hybrid_time. When an error is returned,
+  // the same writes are shipped again by the next poll.
+  typedef std::function<Status(WriteRequestPB* batch)> Sink;
+
+  // Ships the writes that follow the op with index 'checkpoint_index'.
+  CDCProducer(tablet::TabletPeerPtr tablet_peer, std::string stream_id, int64_t checkpoint_index,
+              Sink sink);
+  ~CDCProducer();
+
+  // Ships the writes committed since the previous poll, reading at most --cdc_max_batch_bytes of
+  // log entries. Returns the number of log entries that were consumed.
+  Result<size_t> Poll();
+
+  // Index of the last op that was shipped, or skipped as not a write.
+  int64_t checkpoint_index() const {
+    return checkpoint_index_.load(std::memory_order_acquire);
+  }
+
+  const std::string& tablet_id() const {
+    return tablet_peer_->tablet_id();
+  }
+
+ private:
+  const tablet::TabletPeerPtr tablet_peer_;
+  const std::string stream_id_;
+  const Sink sink_;
+
+  std::atomic<int64_t> checkpoint_index_;
+
+  // Anchors the log right after the checkpoint, so that the segments not shipped yet are not
+  // garbage collected.
+  log::LogAnchor log_anchor_;
+
+  DISALLOW_COPY_AND_ASSIGN(CDCProducer);
+};
+
+// Returns a sink that writes the batches to the tablet with the given id through the given
+// proxy, e.g. to the leader of the matching tablet of another cluster.
+CDCProducer::Sink RemoteTabletSink(std::shared_ptr<TabletServerServiceProxy> proxy,
+                                   std::string target_tablet_id, MonoDelta timeout);
+
+// Decodes the row changes of a committed write, of a table with the given schema. Writes of
+// distributed transactions are left without changes.
+CHECKED_STATUS DecodeCDCRecord(const Schema& schema, const consensus::ReplicateMsg& replicate,
+                               CDCRecordPB* record);
+
+// Checkpoints of the consumers of the GetChanges API, per tablet. The log of a tablet is retained
+// from the op that follows the checkpoint of each of its consumers.
+class CDCCheckpoints {
+ public:
+  CDCCheckpoints();
+  ~CDCCheckpoints();
+
+  // Index of the last op processed by the consumer, 0 when it has no checkpoint yet.
+  int64_t Get(const std::string& consumer_id, const std::string& tablet_id);
+
+  CHECKED_STATUS Update(const tablet::TabletPeerPtr& tablet_peer, const std::string& consumer_id,
+                        int64_t op_index);
+
+ private:
+  struct Checkpoint;
+
+  std::mutex mutex_;
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<Checkpoint>> checkpoints_;
+
+  DISALLOW_COPY_AND_ASSIGN(CDCCheckpoints);
+};
+
+// Polls CDC producers in the background, every --cdc_poll_interval_ms. A producer is never polled
+// by two threads at a time, so its batches reach the sink in order, while the producers of
+// different tablets ship in parallel, on up to --cdc_max_parallel_tablets threads.
+class CDCProducerManager {
+ public:
+  CDCProducerManager();
+  ~CDCProducerManager();
+
+  CHECKED_STATUS Start();
+  void Shutdown();
+
+  void AddProducer(std::unique_ptr<CDCProducer> producer);
+
+  // Stops shipping the writes of the tablet, returns false if it had no producer.
+  bool RemoveProducer(const std::string& tablet_id);
+
+ private:
+  struct ProducerEntry;
+
+  void RunThread();
+  void PollProducer(const std::shared_ptr<ProducerEntry>& entry);
+
+  std::unique_ptr<ThreadPool> pool_;
+  scoped_refptr<Thread> thread_;
+  CountDownLatch shutdown_latch_;
+
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ProducerEntry>> producers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CDCProducerManager);
+};
+
+}  // namespace tserver
+}  // namespace yb
+
+#endif  // YB_TSERVER_CDC_PRODUCER_H
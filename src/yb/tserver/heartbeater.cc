@@ -197,6 +197,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Fingerprint of the live tserver list received from the master, 0 if none was received.
+  uint64_t tservers_fingerprint_;
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -234,7 +237,8 @@ Heartbeater::Thread::Thread(const TabletServerOptions& opts, TabletServer* serve
     tserver_metrics_interval_sec_(5),
     prev_tserver_metrics_submission_(MonoTime::Now()),
     prev_reads_(0),
-    prev_writes_(0) {
+    prev_writes_(0),
+    tservers_fingerprint_(0) {
   CHECK_NOTNULL(master_addresses_.get());
   CHECK(!master_addresses_->empty());
   VLOG(1) << "Initializing heartbeater thread with master addresses: "
@@ -446,6 +450,7 @@ Status Heartbeater::Thread::TryHeartbeat() {
   rpc.set_timeout(MonoDelta::FromSeconds(10));
 
   req.set_config_index(server_->GetCurrentMasterIndex());
+  req.set_tservers_fingerprint(tservers_fingerprint_);
 
   VLOG(2) << "Sending heartbeat:\n" << req.DebugString();
   master::TSHeartbeatResponsePB resp;
@@ -477,21 +482,27 @@ Status Heartbeater::Thread::TryHeartbeat() {
     return STATUS(TryAgain, "");
   }
 
-  if (resp.has_cluster_uuid() && !resp.cluster_uuid().empty()) {
-    server_->set_cluster_uuid(resp.cluster_uuid());
+  if (last_hb_response_.has_cluster_uuid() && !last_hb_response_.cluster_uuid().empty()) {
+    server_->set_cluster_uuid(last_hb_response_.cluster_uuid());
   }
 
-  if (resp.has_master_config()) {
-    LOG(INFO) << "Received heartbeat response with config " << resp.DebugString();
+  if (last_hb_response_.has_master_config()) {
+    LOG(INFO) << "Received heartbeat response with config " << last_hb_response_.DebugString();
 
-    RETURN_NOT_OK(server_->UpdateMasterAddresses(resp.master_config()));
+    RETURN_NOT_OK(server_->UpdateMasterAddresses(last_hb_response_.master_config()));
   }
 
   // TODO: Handle TSHeartbeatResponsePB (e.g. deleted tablets and schema changes)
   server_->tablet_manager()->MarkTabletReportAcknowledged(req.tablet_report());
 
-  // Update the live tserver list.
-  return server_->PopulateLiveTServers(resp);
+  // Update the live tserver list, unless the master omitted it because it has not changed.
+  if (last_hb_response_.has_tservers_fingerprint() &&
+      last_hb_response_.tservers_fingerprint() == tservers_fingerprint_) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(server_->PopulateLiveTServers(last_hb_response_));
+  tservers_fingerprint_ = last_hb_response_.tservers_fingerprint();
+  return Status::OK();
 }
 
 Status Heartbeater::Thread::DoHeartbeat() {
@@ -32,6 +32,8 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <atomic>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -52,6 +54,7 @@
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/remote_bootstrap.pb.h"
 #include "yb/tserver/remote_bootstrap.proxy.h"
+#include "yb/tserver/remote_bootstrap_rate_limiter.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/util/crc.h"
@@ -61,6 +64,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_int32(remote_bootstrap_begin_session_timeout_ms, 3000,
              "Tablet server RPC client timeout for BeginRemoteBootstrapSession calls.");
@@ -79,6 +83,11 @@ TAG_FLAG(remote_bootstrap_save_downloaded_metadata, advanced);
 TAG_FLAG(remote_bootstrap_save_downloaded_metadata, hidden);
 TAG_FLAG(remote_bootstrap_save_downloaded_metadata, runtime);
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of RocksDB files downloaded concurrently by a single remote "
+             "bootstrap session. Values of 1 or less download the files one at a time.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+
 DEFINE_int32(committed_config_change_role_timeout_sec, 30,
              "Number of seconds to wait for the CHANGE_ROLE to be in the committed config before "
              "timing out. ");
@@ -549,26 +558,73 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    rocksdb_dir));
 
-  for (auto const& file_pb : new_sb->rocksdb_files()) {
-    WritableFileOptions opts;
-    opts.sync_on_close = true;
-    gscoped_ptr<WritableFile> rocksdb_file;
-    auto file_path = JoinPathSegments(rocksdb_dir, file_pb.name());
-    RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &rocksdb_file));
-
-    DataIdPB data_id;
-    data_id.set_type(DataIdPB::ROCKSDB_FILE);
-    data_id.set_file_name(file_pb.name());
-    RETURN_NOT_OK_PREPEND(DownloadFile(data_id, rocksdb_file.get()),
-                          Substitute("Unable to download rocksdb file $0",
-                                     file_path));
-    VLOG(2) << "Downloading file " << file_path;
+  const int num_files = new_sb->rocksdb_files_size();
+  const int max_concurrency = std::min(FLAGS_remote_bootstrap_max_concurrent_file_downloads,
+                                       num_files);
+  if (max_concurrency <= 1) {
+    for (auto const& file_pb : new_sb->rocksdb_files()) {
+      RETURN_NOT_OK(DownloadRocksDBFile(rocksdb_dir, file_pb.name()));
+    }
+  } else {
+    // Each file is fetched with its own sequence of FetchData calls, so the files are independent
+    // of each other. Once one of them fails, the files that were not started yet are skipped.
+    std::unique_ptr<ThreadPool> pool;
+    RETURN_NOT_OK(ThreadPoolBuilder("rb-download")
+                      .set_min_threads(0)
+                      .set_max_threads(max_concurrency)
+                      .Build(&pool));
+    std::vector<Status> statuses(num_files);
+    std::atomic<bool> failed(false);
+    Status submit_status;
+    for (int i = 0; i < num_files && submit_status.ok(); ++i) {
+      const std::string& file_name = new_sb->rocksdb_files(i).name();
+      Status* status = &statuses[i];
+      submit_status = pool->SubmitFunc([this, &rocksdb_dir, &file_name, &failed, status] {
+        if (failed.load(std::memory_order_acquire)) {
+          *status = STATUS(Aborted, "Download of another RocksDB file failed");
+          return;
+        }
+        *status = DownloadRocksDBFile(rocksdb_dir, file_name);
+        if (!status->ok()) {
+          failed.store(true, std::memory_order_release);
+        }
+      });
+    }
+    pool->Wait();
+    pool->Shutdown();
+    RETURN_NOT_OK(submit_status);
+    // Report the original failure rather than one of the aborts it caused.
+    for (const auto& status : statuses) {
+      if (!status.ok() && !status.IsAborted()) {
+        return status;
+      }
+    }
+    for (const auto& status : statuses) {
+      RETURN_NOT_OK(status);
+    }
   }
   new_superblock_.swap(new_sb);
   downloaded_rocksdb_files_ = true;
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::DownloadRocksDBFile(const std::string& rocksdb_dir,
+                                                  const std::string& file_name) {
+  WritableFileOptions opts;
+  opts.sync_on_close = true;
+  gscoped_ptr<WritableFile> rocksdb_file;
+  auto file_path = JoinPathSegments(rocksdb_dir, file_name);
+  VLOG_WITH_PREFIX(2) << "Downloading file " << file_path;
+  RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &rocksdb_file));
+
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  data_id.set_file_name(file_name);
+  RETURN_NOT_OK_PREPEND(DownloadFile(data_id, rocksdb_file.get()),
+                        Substitute("Unable to download rocksdb file $0", file_path));
+  return Status::OK();
+}
+
 Status RemoteBootstrapClient::DownloadWAL(uint64_t wal_segment_seqno) {
   VLOG_WITH_PREFIX(1) << "Downloading WAL segment with seqno " << wal_segment_seqno;
   DataIdPB data_id;
@@ -650,28 +706,37 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
     req.mutable_data_id()->CopyFrom(data_id);
     req.set_offset(offset);
     req.set_max_length(max_length);
+    req.set_data_in_sidecar(true);
 
     FetchDataResponsePB resp;
     RETURN_NOT_OK_UNWIND_PREPEND(proxy_->FetchData(req, &resp, &controller),
                                 controller,
                                 "Unable to fetch data from remote");
+    // Servers that don't support sidecars return the data in the response itself.
+    Slice data(resp.chunk().data());
+    if (resp.chunk().has_data_sidecar_idx()) {
+      RETURN_NOT_OK_PREPEND(controller.GetSidecar(resp.chunk().data_sidecar_idx(), &data),
+                            "Unable to get data sidecar");
+    }
     // Sanity-check for corruption.
-    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
+    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk(), data),
                           Substitute("Error validating data item $0", data_id.ShortDebugString()));
 
     // Write the data.
-    RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    RETURN_NOT_OK(appendable->Append(data));
+    RemoteBootstrapRateLimiter::Incoming().Request(data.size());
 
-    if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
+    if (offset + data.size() == resp.chunk().total_data_length()) {
       done = true;
     }
-    offset += resp.chunk().data().size();
+    offset += data.size();
   }
 
   return Status::OK();
 }
 
-Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chunk) {
+Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chunk,
+                                         const Slice& data) {
   // Verify the offset is what we expected.
   if (offset != chunk.offset()) {
     return STATUS(InvalidArgument, "Offset did not match what was asked for",
@@ -679,11 +744,11 @@ Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chu
   }
 
   // Verify the checksum.
-  uint32_t crc32 = crc::Crc32c(chunk.data().data(), chunk.data().length());
+  uint32_t crc32 = crc::Crc32c(data.data(), data.size());
   if (PREDICT_FALSE(crc32 != chunk.crc32())) {
     return STATUS(Corruption,
         Substitute("CRC32 does not match at offset $0 size $1: $2 vs $3",
-          offset, chunk.data().size(), crc32, chunk.crc32()));
+          offset, data.size(), crc32, chunk.crc32()));
   }
   return Status::OK();
 }
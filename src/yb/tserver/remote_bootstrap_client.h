@@ -175,9 +175,16 @@ class RemoteBootstrapClient {
   template<class Appendable>
   CHECKED_STATUS DownloadFile(const DataIdPB& data_id, Appendable* appendable);
 
+  // Download all RocksDB files, up to FLAGS_remote_bootstrap_max_concurrent_file_downloads of
+  // them at a time.
   CHECKED_STATUS DownloadRocksDBFiles();
 
-  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
+  // Download a single RocksDB file into 'rocksdb_dir'. Safe to call concurrently for different
+  // files.
+  CHECKED_STATUS DownloadRocksDBFile(const std::string& rocksdb_dir, const std::string& file_name);
+
+  // Verifies 'data', the payload of 'chunk', which may have been received in a sidecar.
+  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& chunk, const Slice& data);
 
   // Return standard log prefix.
   std::string LogPrefix();
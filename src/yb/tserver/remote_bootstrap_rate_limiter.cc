@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/remote_bootstrap_rate_limiter.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/rocksdb/rate_limiter.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 0,
+             "Maximum number of bytes per second a tablet server sends, and separately receives, "
+             "for remote bootstraps, across all of its sessions. 0 means no limit.");
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, runtime);
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, advanced);
+
+namespace yb {
+namespace tserver {
+
+RemoteBootstrapRateLimiter::RemoteBootstrapRateLimiter() {}
+
+RemoteBootstrapRateLimiter::~RemoteBootstrapRateLimiter() {}
+
+std::shared_ptr<rocksdb::RateLimiter> RemoteBootstrapRateLimiter::GetLimiter() {
+  const int64_t bytes_per_sec = FLAGS_remote_bootstrap_rate_limit_bytes_per_sec;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (bytes_per_sec != bytes_per_sec_) {
+    if (bytes_per_sec <= 0) {
+      limiter_.reset();
+    } else if (limiter_) {
+      limiter_->SetBytesPerSecond(bytes_per_sec);
+    } else {
+      limiter_.reset(rocksdb::NewGenericRateLimiter(bytes_per_sec));
+    }
+    bytes_per_sec_ = bytes_per_sec;
+  }
+  return limiter_;
+}
+
+void RemoteBootstrapRateLimiter::Request(int64_t bytes) {
+  auto limiter = GetLimiter();
+  if (!limiter) {
+    return;
+  }
+  // A single request can't be larger than the burst size, which is the number of bytes refilled
+  // per period, so split large chunks.
+  while (bytes > 0) {
+    const int64_t burst = std::max<int64_t>(limiter->GetSingleBurstBytes(), 1);
+    const int64_t request = std::min(bytes, burst);
+    limiter->Request(request, rocksdb::Env::IO_LOW);
+    bytes -= request;
+  }
+}
+
+RemoteBootstrapRateLimiter& RemoteBootstrapRateLimiter::Incoming() {
+  static RemoteBootstrapRateLimiter limiter;
+  return limiter;
+}
+
+RemoteBootstrapRateLimiter& RemoteBootstrapRateLimiter::Outgoing() {
+  static RemoteBootstrapRateLimiter limiter;
+  return limiter;
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,57 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_REMOTE_BOOTSTRAP_RATE_LIMITER_H_
+#define YB_TSERVER_REMOTE_BOOTSTRAP_RATE_LIMITER_H_
+
+#include <memory>
+#include <mutex>
+
+#include "yb/gutil/macros.h"
+
+namespace rocksdb {
+class RateLimiter;
+} // namespace rocksdb
+
+namespace yb {
+namespace tserver {
+
+// Limits the bandwidth used by remote bootstrap in one direction, shared by all the sessions of
+// the tablet server. The limit is FLAGS_remote_bootstrap_rate_limit_bytes_per_sec, and is picked
+// up at runtime when the flag changes. 0 means no limit.
+class RemoteBootstrapRateLimiter {
+ public:
+  RemoteBootstrapRateLimiter();
+  ~RemoteBootstrapRateLimiter();
+
+  // Blocks until 'bytes' more bytes may be transferred under the current limit.
+  void Request(int64_t bytes);
+
+  // The limiters for the data received and sent by this tablet server.
+  static RemoteBootstrapRateLimiter& Incoming();
+  static RemoteBootstrapRateLimiter& Outgoing();
+
+ private:
+  std::shared_ptr<rocksdb::RateLimiter> GetLimiter();
+
+  std::mutex mutex_;
+  int64_t bytes_per_sec_ = 0;
+  std::shared_ptr<rocksdb::RateLimiter> limiter_;
+
+  DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapRateLimiter);
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_REMOTE_BOOTSTRAP_RATE_LIMITER_H_
@@ -129,11 +129,13 @@ class RemoteBootstrapServiceTest : public RemoteBootstrapTest {
   Status DoFetchData(const string& session_id, const DataIdPB& data_id,
                      uint64_t* offset, int64_t* max_length,
                      FetchDataResponsePB* resp,
-                     RpcController* controller) {
+                     RpcController* controller,
+                     bool data_in_sidecar = false) {
     controller->set_timeout(MonoDelta::FromSeconds(1.0));
     FetchDataRequestPB req;
     req.set_session_id(session_id);
     req.mutable_data_id()->CopyFrom(data_id);
+    req.set_data_in_sidecar(data_in_sidecar);
     if (offset) {
       req.set_offset(*offset);
     }
@@ -407,6 +409,18 @@ TEST_F(RemoteBootstrapServiceTest, TestFetchLog) {
   ASSERT_OK(ReadFully(segment->readable_file().get(), 0, size, &slice, scratch.data()));
 
   AssertDataEqual(slice.data(), slice.size(), resp.chunk());
+
+  // The same data is returned in a sidecar when the client asks for it.
+  FetchDataResponsePB sidecar_resp;
+  RpcController sidecar_controller;
+  ASSERT_OK(DoFetchData(session_id, data_id, nullptr, nullptr, &sidecar_resp,
+                        &sidecar_controller, true /* data_in_sidecar */));
+  ASSERT_TRUE(sidecar_resp.chunk().has_data_sidecar_idx());
+  ASSERT_TRUE(sidecar_resp.chunk().data().empty());
+  Slice sidecar;
+  ASSERT_OK(sidecar_controller.GetSidecar(sidecar_resp.chunk().data_sidecar_idx(), &sidecar));
+  ASSERT_EQ(slice.ToBuffer(), sidecar.ToBuffer());
+  ASSERT_EQ(resp.chunk().crc32(), sidecar_resp.chunk().crc32());
 }
 
 // Test that the remote bootstrap session timeout works properly.
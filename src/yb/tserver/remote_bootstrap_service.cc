@@ -46,6 +46,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/map-util.h"
 #include "yb/rpc/rpc_context.h"
+#include "yb/tserver/remote_bootstrap_rate_limiter.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/util/crc.h"
@@ -222,7 +223,7 @@ Status RemoteBootstrapServiceImpl::GetDataFilePiece(
     const scoped_refptr<RemoteBootstrapSessionClass>& session,
     uint64_t offset,
     int64_t client_maxlen,
-    string* data,
+    RefCntBuffer* data,
     int64_t* total_data_length,
     RemoteBootstrapErrorPB::Code* error_code) {
   switch (data_id.type()) {
@@ -286,19 +287,31 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Invalid DataId");
 
   DataChunkPB* data_chunk = resp->mutable_chunk();
-  string* data = data_chunk->mutable_data();
+  RefCntBuffer data;
   int64_t total_data_length = 0;
-  RPC_RETURN_NOT_OK(GetDataFilePiece(data_id, session, offset, client_maxlen, data,
+  RPC_RETURN_NOT_OK(GetDataFilePiece(data_id, session, offset, client_maxlen, &data,
                                      &total_data_length, &error_code),
                     error_code, "Unable to get piece of data file");
+  RemoteBootstrapRateLimiter::Outgoing().Request(data.size());
 
   data_chunk->set_total_data_length(total_data_length);
   data_chunk->set_offset(offset);
 
   // Calculate checksum.
-  uint32_t crc32 = Crc32c(data->data(), data->length());
+  uint32_t crc32 = Crc32c(data.data(), data.size());
   data_chunk->set_crc32(crc32);
 
+  if (req->data_in_sidecar()) {
+    // The sidecar is written to the socket straight from the buffer the data was read into.
+    int sidecar_idx = 0;
+    RPC_RETURN_NOT_OK(context.AddRpcSidecar(std::move(data), &sidecar_idx),
+                      RemoteBootstrapErrorPB::UNKNOWN_ERROR, "Unable to add data sidecar");
+    data_chunk->set_data("");
+    data_chunk->set_data_sidecar_idx(sidecar_idx);
+  } else {
+    data_chunk->set_data(data.data(), data.size());
+  }
+
   context.RespondSuccess();
 }
 
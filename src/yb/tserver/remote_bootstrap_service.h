@@ -87,7 +87,7 @@ class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
   virtual CHECKED_STATUS GetDataFilePiece(
       const DataIdPB& data_id, const scoped_refptr<RemoteBootstrapSessionClass>& session,
       uint64_t offset, int64_t client_maxlen,
-      std::string* data, int64_t* total_data_length, RemoteBootstrapErrorPB::Code* error_code);
+      RefCntBuffer* data, int64_t* total_data_length, RemoteBootstrapErrorPB::Code* error_code);
 
   virtual CHECKED_STATUS ValidateSnapshotFetchRequestDataId(const DataIdPB& data_id) const;
 
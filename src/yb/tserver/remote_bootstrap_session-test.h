@@ -156,7 +156,8 @@ class RemoteBootstrapTest : public YBTabletTest {
                                           *messenger,
                                           log,
                                           metric_entity,
-                                          raft_pool_.get()));
+                                          raft_pool_.get(),
+                                          nullptr /* multi_raft_manager */));
     consensus::ConsensusBootstrapInfo boot_info;
     CHECK_OK(tablet_peer_->Start(boot_info));
 
@@ -204,7 +205,7 @@ class RemoteBootstrapTest : public YBTabletTest {
   void FetchBlockToFile(const BlockId& block_id,
                         string* path,
                         gscoped_ptr<SequentialFile>* file) {
-    string data;
+    RefCntBuffer data;
     int64_t block_file_size = 0;
     RemoteBootstrapErrorPB::Code error_code;
     CHECK_OK(session_->GetBlockPiece(block_id, 0, 0, &data, &block_file_size, &error_code));
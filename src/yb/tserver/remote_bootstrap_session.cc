@@ -311,7 +311,7 @@ template <class Info>
 static Status ReadFileChunkToBuf(const Info* info,
                                  uint64_t offset, int64_t client_maxlen,
                                  const string& data_name,
-                                 string* data, int64_t* file_size,
+                                 RefCntBuffer* data, int64_t* file_size,
                                  RemoteBootstrapErrorPB::Code* error_code) {
   int64_t response_data_size = 0;
   RETURN_NOT_OK_PREPEND(GetResponseDataSize(info->size, offset, client_maxlen, error_code,
@@ -321,11 +321,8 @@ static Status ReadFileChunkToBuf(const Info* info,
   Stopwatch chunk_timer(Stopwatch::THIS_THREAD);
   chunk_timer.start();
 
-  // Writing into a std::string buffer is basically guaranteed to work on C++11,
-  // however any modern compiler should be compatible with it.
-  // Violates the API contract, but avoids excessive copies.
-  data->resize(response_data_size);
-  uint8_t* buf = reinterpret_cast<uint8_t*>(const_cast<char*>(data->data()));
+  *data = RefCntBuffer(response_data_size);
+  uint8_t* buf = data->udata();
   Slice slice;
   Status s = info->ReadFully(offset, response_data_size, &slice, buf);
   if (PREDICT_FALSE(!s.ok())) {
@@ -350,7 +347,7 @@ static Status ReadFileChunkToBuf(const Info* info,
 
 Status RemoteBootstrapSession::GetBlockPiece(const BlockId& block_id,
                                              uint64_t offset, int64_t client_maxlen,
-                                             string* data, int64_t* block_file_size,
+                                             RefCntBuffer* data, int64_t* block_file_size,
                                              RemoteBootstrapErrorPB::Code* error_code) {
   ImmutableReadableBlockInfo* block_info;
   RETURN_NOT_OK(FindBlock(block_id, &block_info, error_code));
@@ -369,7 +366,7 @@ Status RemoteBootstrapSession::GetBlockPiece(const BlockId& block_id,
 
 Status RemoteBootstrapSession::GetLogSegmentPiece(uint64_t segment_seqno,
                                                   uint64_t offset, int64_t client_maxlen,
-                                                  std::string* data, int64_t* block_file_size,
+                                                  RefCntBuffer* data, int64_t* block_file_size,
                                                   RemoteBootstrapErrorPB::Code* error_code) {
   ImmutableRandomAccessFileInfo* file_info;
   RETURN_NOT_OK(FindLogSegment(segment_seqno, &file_info, error_code));
@@ -385,7 +382,7 @@ Status RemoteBootstrapSession::GetLogSegmentPiece(uint64_t segment_seqno,
 
 Status RemoteBootstrapSession::GetRocksDBFilePiece(const std::string file_name,
                                                    uint64_t offset, int64_t client_maxlen,
-                                                   std::string* data, int64_t* log_file_size,
+                                                   RefCntBuffer* data, int64_t* log_file_size,
                                                    RemoteBootstrapErrorPB::Code* error_code) {
   return GetFilePiece(
       checkpoint_dir_, file_name, offset, client_maxlen, data, log_file_size, error_code);
@@ -394,7 +391,7 @@ Status RemoteBootstrapSession::GetRocksDBFilePiece(const std::string file_name,
 Status RemoteBootstrapSession::GetFilePiece(const std::string path,
                                             const std::string file_name,
                                             uint64_t offset, int64_t client_maxlen,
-                                            std::string* data, int64_t* block_file_size,
+                                            RefCntBuffer* data, int64_t* block_file_size,
                                             RemoteBootstrapErrorPB::Code* error_code) {
   auto file_path = JoinPathSegments(path, file_name);
   if (!fs_manager_->env()->FileExists(file_path)) {
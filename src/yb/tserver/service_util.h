@@ -22,6 +22,7 @@
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/util/logging.h"
+#include "yb/util/profiling_context.h"
 
 namespace yb {
 namespace tserver {
@@ -103,6 +104,7 @@ bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
                                rpc::RpcContext* context,
                                scoped_refptr<tablet::TabletPeer>* peer) {
   Status status = tablet_manager->GetTabletPeer(tablet_id, peer);
+  ScopedProfilingContext::SetTabletId(tablet_id);
   if (PREDICT_FALSE(!status.ok())) {
     TabletServerErrorPB::Code code = status.IsServiceUnavailable() ?
                                      TabletServerErrorPB::UNKNOWN_ERROR :
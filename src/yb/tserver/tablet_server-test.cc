@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include "yb/common/wire_protocol.h"
+
 #include "yb/consensus/log-test-base.h"
 
 #include "yb/gutil/strings/escaping.h"
@@ -79,6 +81,9 @@ DECLARE_int32(metrics_retirement_age_ms);
 DECLARE_string(block_manager);
 DECLARE_string(rpc_bind_addresses);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(sst_files_soft_limit);
+DECLARE_int32(sst_files_hard_limit);
+DECLARE_int32(max_write_rejection_backoff_ms);
 
 // Declare these metrics prototypes for simpler unit testing of their behavior.
 METRIC_DECLARE_counter(rows_inserted);
@@ -812,6 +817,32 @@ TEST_F(TabletServerTest, TestWriteOutOfBounds) {
   }
 }
 
+TEST_F(TabletServerTest, TestRejectWritesWhenOverloaded) {
+  WriteRequestPB req;
+  WriteResponsePB resp;
+  RpcController controller;
+  req.set_tablet_id(kTabletId);
+  AddTestRowInsert(1, 1, "overloaded", &req);
+
+  // Any number of SST files is beyond the hard limit.
+  FLAGS_sst_files_soft_limit = -1;
+  FLAGS_sst_files_hard_limit = 0;
+  ASSERT_OK(proxy_->Write(req, &resp, &controller));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_TRUE(resp.has_error());
+  ASSERT_EQ(TabletServerErrorPB::SERVER_BUSY, resp.error().code());
+  ASSERT_TRUE(StatusFromPB(resp.error().status()).IsServiceUnavailable());
+  ASSERT_EQ(FLAGS_max_write_rejection_backoff_ms, resp.error().backoff_ms());
+
+  FLAGS_sst_files_soft_limit = 16;
+  FLAGS_sst_files_hard_limit = 24;
+  controller.Reset();
+  resp.Clear();
+  ASSERT_OK(proxy_->Write(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  VerifyRows(schema_, { KeyValue(1, 1) });
+}
+
 namespace {
 
 void CalcTestRowChecksum(uint64_t *out, int32_t key, uint8_t string_field_defined = true) {
@@ -885,6 +916,48 @@ TEST_F(TabletServerTest, TestChecksumScan) {
   ASSERT_EQ(first_crc, resp.checksum());
 }
 
+TEST_F(TabletServerTest, TestChecksumHashBuckets) {
+  InsertTestRowsRemote(0, 1, 20);
+
+  ChecksumRequestPB req;
+  req.set_tablet_id(kTabletId);
+  req.set_num_hash_buckets(4);
+  ChecksumResponsePB resp;
+  RpcController controller;
+  ASSERT_OK(proxy_->Checksum(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.error().DebugString();
+  ASSERT_EQ(4, resp.hash_bucket_checksums_size());
+  ASSERT_TRUE(resp.has_read_hybrid_time());
+  const auto bucket_checksums = resp.hash_bucket_checksums();
+  const uint64_t read_ht = resp.read_hybrid_time();
+
+  // Rows written after the read time do not change the checksums at that time.
+  InsertTestRowsRemote(0, 100, 1);
+  req.set_read_hybrid_time(read_ht);
+  controller.Reset();
+  ASSERT_OK(proxy_->Checksum(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.error().DebugString();
+  ASSERT_EQ(read_ht, resp.read_hybrid_time());
+  for (int i = 0; i != 4; ++i) {
+    ASSERT_EQ(bucket_checksums.Get(i), resp.hash_bucket_checksums(i));
+  }
+
+  // A bucket checksummed on its own matches its checksum among all the buckets.
+  req.set_num_hash_buckets(0);
+  req.set_hash_code_start(0x4000);
+  req.set_hash_code_end(0x7FFF);
+  controller.Reset();
+  ASSERT_OK(proxy_->Checksum(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.error().DebugString();
+  ASSERT_EQ(0, resp.hash_bucket_checksums_size());
+  ASSERT_EQ(bucket_checksums.Get(1), resp.checksum());
+
+  req.set_hash_code_start(0x8000);
+  controller.Reset();
+  ASSERT_OK(proxy_->Checksum(req, &resp, &controller));
+  ASSERT_TRUE(resp.has_error());
+}
+
 class DelayFsyncLogHook : public log::Log::LogFaultHooks {
  public:
   DelayFsyncLogHook() : log_latch1_(1), test_latch1_(1) {}
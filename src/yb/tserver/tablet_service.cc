@@ -33,18 +33,23 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/scope_exit.hpp>
 
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/leader_lease.h"
 
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 
 #include "yb/gutil/bind.h"
@@ -52,6 +57,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/rocksdb/memory_monitor.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tserver/remote_bootstrap_service.h"
@@ -75,6 +81,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/status_callback.h"
@@ -107,17 +114,81 @@ DEFINE_int32(scanner_inject_latency_on_each_batch_ms, 0,
              "Used for tests.");
 TAG_FLAG(scanner_inject_latency_on_each_batch_ms, unsafe);
 
+DEFINE_int32(ql_read_ahead_max_pages, 8,
+             "Max number of pages that are read ahead and returned with a QL read response, when "
+             "the client asks for it.");
+TAG_FLAG(ql_read_ahead_max_pages, advanced);
+TAG_FLAG(ql_read_ahead_max_pages, runtime);
+
+DEFINE_int32(ql_read_ahead_max_bytes, 8 * 1024 * 1024,
+             "Pages are no longer read ahead once a QL read response holds this many bytes of "
+             "rows.");
+TAG_FLAG(ql_read_ahead_max_bytes, advanced);
+TAG_FLAG(ql_read_ahead_max_bytes, runtime);
+
 DECLARE_int32(memory_limit_warn_threshold_percentage);
 
 DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_bool(enable_unlocked_leader_reads, true,
+            "Whether strong reads on the leader of rows that are not locked by pending writes are "
+            "served at the requested read time without waiting for the pending writes.");
+TAG_FLAG(enable_unlocked_leader_reads, advanced);
+TAG_FLAG(enable_unlocked_leader_reads, runtime);
+
 DEFINE_bool(tserver_noop_read_write, false, "Respond NOOP to read/write.");
 TAG_FLAG(tserver_noop_read_write, unsafe);
 TAG_FLAG(tserver_noop_read_write, hidden);
 
+DEFINE_int32(sst_files_soft_limit, 16,
+             "When the number of SST files of a tablet exceeds this limit, part of the writes to "
+             "it are rejected, the more files the higher the probability of rejection. Should be "
+             "below rocksdb_level0_slowdown_writes_trigger, so that RocksDB does not stall the "
+             "apply of replicated writes.");
+TAG_FLAG(sst_files_soft_limit, runtime);
+DEFINE_int32(sst_files_hard_limit, 24,
+             "When the number of SST files of a tablet reaches this limit, all writes to it are "
+             "rejected.");
+TAG_FLAG(sst_files_hard_limit, runtime);
+DEFINE_int32(memstore_size_hard_limit_percentage, 150,
+             "Percentage of the total memstore size limit at which all writes are rejected. Part "
+             "of the writes are rejected as soon as the memstores exceed the limit and flushes "
+             "fall behind.");
+TAG_FLAG(memstore_size_hard_limit_percentage, runtime);
+DEFINE_int32(pending_operations_soft_limit, 1000,
+             "When the number of operations of a tablet that are replicating or waiting to be "
+             "applied exceeds this limit, part of the new writes to it are rejected.");
+TAG_FLAG(pending_operations_soft_limit, runtime);
+DEFINE_int32(pending_operations_hard_limit, 2000,
+             "When the number of operations of a tablet that are replicating or waiting to be "
+             "applied reaches this limit, all new writes to it are rejected.");
+TAG_FLAG(pending_operations_hard_limit, runtime);
+DEFINE_int32(min_write_rejection_backoff_ms, 10,
+             "Delay the client waits before retrying a write rejected by a slightly overloaded "
+             "tablet.");
+TAG_FLAG(min_write_rejection_backoff_ms, runtime);
+DEFINE_int32(max_write_rejection_backoff_ms, 1000,
+             "Delay the client waits before retrying a write rejected by a fully overloaded "
+             "tablet.");
+TAG_FLAG(max_write_rejection_backoff_ms, runtime);
+DEFINE_int32(index_write_timeout_ms, 60000,
+             "Timeout for writing the index updates of a write to the indexed table.");
+TAG_FLAG(index_write_timeout_ms, advanced);
+TAG_FLAG(index_write_timeout_ms, runtime);
+DEFINE_int32(backfill_index_write_batch_size, 10000,
+             "Number of rows whose index entries are written together by an index backfill.");
+TAG_FLAG(backfill_index_write_batch_size, advanced);
+TAG_FLAG(backfill_index_write_batch_size, runtime);
+DEFINE_int32(backfill_index_rpc_max_ms, 30000,
+             "How long a BackfillIndex call writes index entries before it returns the row to "
+             "continue from.");
+TAG_FLAG(backfill_index_rpc_max_ms, advanced);
+TAG_FLAG(backfill_index_rpc_max_ms, runtime);
+
 DECLARE_uint64(max_clock_skew_usec);
+DECLARE_int32(cdc_poll_interval_ms);
 
 namespace yb {
 namespace tserver {
@@ -130,6 +201,8 @@ using consensus::Consensus;
 using consensus::ConsensusConfigType;
 using consensus::ConsensusRequestPB;
 using consensus::ConsensusResponsePB;
+using consensus::MultiRaftConsensusRequestPB;
+using consensus::MultiRaftConsensusResponsePB;
 using consensus::GetLastOpIdRequestPB;
 using consensus::GetNodeInstanceRequestPB;
 using consensus::GetNodeInstanceResponsePB;
@@ -234,6 +307,91 @@ bool TabletServiceImpl::PrepareModify(
   return true;
 }
 
+namespace {
+
+// Returns 0 when the value is below the soft limit, 1 when it reaches the hard limit, and grows
+// linearly in between.
+double LimitScore(double value, double soft_limit, double hard_limit) {
+  if (value <= soft_limit) {
+    return 0;
+  }
+  if (value >= hard_limit) {
+    return 1;
+  }
+  return (value - soft_limit) / (hard_limit - soft_limit);
+}
+
+// Returns how much the tablet is overloaded by writes, 0 - not overloaded, 1 - every new write
+// should be rejected. Accepting writes beyond that would only queue them behind RocksDB write
+// stalls on the apply path, delaying Raft and causing leader elections.
+double WriteOverloadScore(const TabletPeer& tablet_peer, const Tablet& tablet,
+                          const rocksdb::MemoryMonitor* memory_monitor) {
+  double score = LimitScore(
+      tablet.GetCurrentVersionNumSSTFiles(), FLAGS_sst_files_soft_limit,
+      FLAGS_sst_files_hard_limit);
+  if (memory_monitor && memory_monitor->limit() > 0) {
+    score = std::max(score, LimitScore(
+        memory_monitor->memory_usage(), memory_monitor->limit(),
+        memory_monitor->limit() * FLAGS_memstore_size_hard_limit_percentage / 100.0));
+  }
+  score = std::max(score, LimitScore(
+      tablet_peer.operation_tracker()->GetNumPending(), FLAGS_pending_operations_soft_limit,
+      FLAGS_pending_operations_hard_limit));
+  return score;
+}
+
+// Tells the client which replica is the leader, so that it could go there directly instead of
+// trying the other replicas or asking the master.
+void SetupLeaderHint(const TabletPeer& tablet_peer, TabletServerErrorPB* error) {
+  scoped_refptr<consensus::Consensus> consensus = tablet_peer.shared_consensus();
+  if (!consensus) {
+    return;
+  }
+  auto cstate = consensus->ConsensusState(consensus::CONSENSUS_CONFIG_COMMITTED);
+  if (cstate.has_leader_uuid() && cstate.leader_uuid() != tablet_peer.permanent_uuid()) {
+    error->set_leader_uuid(cstate.leader_uuid());
+  }
+}
+
+// Whether the write batch was shipped by CDC from another cluster: its pairs are final, each
+// with the hybrid time it was written with there. Not allowed for distributed transactions,
+// which replicate intents.
+bool IsExternalWriteBatch(const docdb::KeyValueWriteBatchPB& write_batch) {
+  if (write_batch.has_transaction()) {
+    return false;
+  }
+  for (const auto& kv_pair : write_batch.kv_pairs()) {
+    if (!kv_pair.has_external_hybrid_time()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+bool TabletServiceImpl::CheckWriteThrottlingOrRespond(
+    const TabletPeer& tablet_peer, Tablet* tablet, WriteResponsePB* resp,
+    rpc::RpcContext* context) {
+  const double score = WriteOverloadScore(
+      tablet_peer, *tablet, server_->tablet_manager()->memory_monitor());
+  if (score < 1 && !RandomActWithProbability(score)) {
+    return true;
+  }
+
+  tablet->metrics()->leader_overload_rejections->Increment();
+  const auto backoff_ms = FLAGS_min_write_rejection_backoff_ms +
+      static_cast<int>(score * (FLAGS_max_write_rejection_backoff_ms -
+                                FLAGS_min_write_rejection_backoff_ms));
+  auto status = STATUS_FORMAT(
+      ServiceUnavailable, "Tablet $0 is overloaded, score: $1, retry after $2ms",
+      tablet_peer.tablet_id(), score, backoff_ms);
+  YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Write request: " << status << THROTTLE_MSG;
+  resp->mutable_error()->set_backoff_ms(std::max(backoff_ms, 0));
+  SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::SERVER_BUSY, context);
+  return false;
+}
+
 typedef ListTabletsResponsePB::StatusAndSchemaPB StatusAndSchemaPB;
 
 void SetupErrorAndRespond(TabletServerErrorPB* error,
@@ -257,16 +415,21 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
 class WriteOperationCompletionCallback : public OperationCompletionCallback {
  public:
   WriteOperationCompletionCallback(
+      TabletServiceImpl* service,
+      tablet::TabletPeerPtr tablet_peer,
       std::shared_ptr<rpc::RpcContext> context,
       WriteResponsePB* response,
       tablet::WriteOperationState* state,
       const server::ClockPtr& clock,
       bool trace = false)
-      : context_(std::move(context)), response_(response), state_(state), clock_(clock),
-        include_trace_(trace) {}
+      : service_(service), tablet_peer_(std::move(tablet_peer)), context_(std::move(context)),
+        response_(response), state_(state), clock_(clock), include_trace_(trace) {}
 
   void OperationCompleted() override {
     if (!status_.ok()) {
+      if (status_.IsIllegalState()) {
+        SetupLeaderHint(*tablet_peer_, get_error());
+      }
       SetupErrorAndRespond(get_error(), status_, code_, context_.get());
     } else {
       // Retrieve the rowblocks returned from the QL write operations and return them as RPC
@@ -275,6 +438,10 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
         const auto& ql_write_req = ql_write_op->request();
         auto* ql_write_resp = ql_write_op->response();
         const QLRowBlock* rowblock = ql_write_op->rowblock();
+        if (rowblock == nullptr) {
+          // The op has index updates only.
+          continue;
+        }
         RETURN_UNKNOWN_ERROR_IF_NOT_OK(
             SchemaToColumnPBs(rowblock->schema(), ql_write_resp->mutable_column_schemas()),
             response_, context_.get());
@@ -290,8 +457,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       if (include_trace_ && Trace::CurrentTrace() != nullptr) {
         response_->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
       }
-      response_->set_propagated_hybrid_time(clock_->Now().ToUint64());
-      context_->RespondSuccess();
+      WriteIndexesAndRespond();
     }
   }
 
@@ -301,6 +467,62 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
     return response_->mutable_error();
   }
 
+  // Writes the index updates of the QL write ops, and responds once they are done so that the
+  // client gets a single response for the write and its index updates. The callback is gone by
+  // then, so the flush callback captures what it needs.
+  void WriteIndexesAndRespond() {
+    client::YBSessionPtr session;
+    std::vector<client::YBqlWriteOpPtr> index_ops;
+    for (const auto& ql_write_op : *state_->ql_write_ops()) {
+      for (auto& index_request : *ql_write_op->mutable_index_requests()) {
+        const auto& client = tablet_peer_->client_future().get();
+        if (session == nullptr) {
+          session = client->NewSession();
+          session->SetTimeout(MonoDelta::FromMilliseconds(FLAGS_index_write_timeout_ms));
+          RETURN_UNKNOWN_ERROR_IF_NOT_OK(
+              session->SetFlushMode(client::YBSession::MANUAL_FLUSH), response_, context_.get());
+        }
+        auto index_table = service_->GetIndexTable(client, index_request.first);
+        RETURN_UNKNOWN_ERROR_IF_NOT_OK(index_table.status(), response_, context_.get());
+        auto index_op = std::make_shared<client::YBqlWriteOp>(*index_table);
+        index_op->mutable_request()->Swap(&index_request.second);
+        RETURN_UNKNOWN_ERROR_IF_NOT_OK(session->Apply(index_op), response_, context_.get());
+        index_ops.push_back(std::move(index_op));
+      }
+    }
+
+    if (session == nullptr) {
+      response_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+      context_->RespondSuccess();
+      return;
+    }
+
+    auto context = context_;
+    auto response = response_;
+    auto clock = clock_;
+    session->FlushAsync([session, index_ops, context, response, clock](const Status& status) {
+      Status s = status;
+      for (const auto& index_op : index_ops) {
+        if (!s.ok()) {
+          break;
+        }
+        if (index_op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+          s = STATUS_FORMAT(RuntimeError, "Index write failed: $0",
+                            index_op->response().ShortDebugString());
+        }
+      }
+      if (!s.ok()) {
+        SetupErrorAndRespond(
+            response->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR, context.get());
+        return;
+      }
+      response->set_propagated_hybrid_time(clock->Now().ToUint64());
+      context->RespondSuccess();
+    });
+  }
+
+  TabletServiceImpl* const service_;
+  const tablet::TabletPeerPtr tablet_peer_;
   const std::shared_ptr<rpc::RpcContext> context_;
   WriteResponsePB* const response_;
   tablet::WriteOperationState* const state_;
@@ -333,14 +555,21 @@ class ScanResultChecksummer {
       }
     }
     crc_->Compute(buffer_.c_str(), buffer_.size(), &agg_checksum_, nullptr);
+    crc_->Compute(buffer_.c_str(), buffer_.size(), &bucket_checksum_, nullptr);
   }
 
   // Accessors for initializing / setting the checksum.
   uint64_t agg_checksum() const { return agg_checksum_; }
 
+  // Returns the checksum of the rows handled since the previous call.
+  uint64_t TakeBucketChecksum() {
+    return std::exchange(bucket_checksum_, 0);
+  }
+
  private:
   crc::Crc* const crc_ = crc::GetCrc32cInstance();
   uint64_t agg_checksum_ = 0;
+  uint64_t bucket_checksum_ = 0;
   std::string buffer_;
 };
 
@@ -349,6 +578,18 @@ TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
       server_(server) {
 }
 
+Result<client::YBTablePtr> TabletServiceImpl::GetIndexTable(const client::YBClientPtr& client,
+                                                            const TableId& table_id) {
+  std::lock_guard<std::mutex> lock(index_table_cache_mutex_);
+  if (index_table_cache_ == nullptr) {
+    index_table_cache_ = std::make_shared<client::YBMetaDataCache>(client);
+  }
+  client::YBTablePtr table;
+  bool cache_used = false;
+  RETURN_NOT_OK(index_table_cache_->GetTable(table_id, &table, &cache_used));
+  return table;
+}
+
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
     : TabletServerAdminServiceIf(server->MetricEnt()),
       server_(server) {
@@ -439,6 +680,9 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
   TabletServerErrorPB::Code error_code;
   auto status = CheckPeerIsLeader(*tablet_peer, &error_code);
   if (!status.ok()) {
+    if (error_code == TabletServerErrorPB::NOT_THE_LEADER) {
+      SetupLeaderHint(*tablet_peer, resp->mutable_error());
+    }
     SetupErrorAndRespond(resp->mutable_error(), status, error_code, &context);
     return;
   }
@@ -540,6 +784,181 @@ void TabletServiceImpl::Truncate(const TruncateRequestPB* req,
       std::make_unique<tablet::TruncateOperation>(std::move(tx_state), consensus::LEADER));
 }
 
+void TabletServiceImpl::GetChanges(const GetChangesRequestPB* req,
+                                   GetChangesResponsePB* resp,
+                                   rpc::RpcContext context) {
+  TRACE("GetChanges");
+
+  tablet::TabletPeerPtr tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+  TabletServerErrorPB::Code error_code;
+  Status s = CheckPeerIsReady(*tablet_peer, &error_code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, &context);
+    return;
+  }
+  auto tablet = tablet_peer->shared_tablet();
+  if (tablet->table_type() != TableType::YQL_TABLE_TYPE) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS(NotSupported, "Changes are only decoded for YQL tables"),
+                         TabletServerErrorPB::OPERATION_NOT_SUPPORTED, &context);
+    return;
+  }
+
+  int64_t from_op_index = req->from_op_index();
+  if (req->has_consumer_id()) {
+    if (req->has_from_op_index()) {
+      s = cdc_checkpoints_.Update(tablet_peer, req->consumer_id(), from_op_index);
+    } else {
+      from_op_index = cdc_checkpoints_.Get(req->consumer_id(), req->tablet_id());
+    }
+  }
+
+  // Long poll: wait for changes to be committed, but not past the deadline of the client.
+  const auto deadline = std::min(
+      context.GetClientDeadline(), MonoTime::Now() + MonoDelta::FromMilliseconds(req->wait_ms()));
+  const int max_bytes = req->has_max_bytes() ? req->max_bytes() : FLAGS_cdc_max_batch_bytes;
+  consensus::ReplicateMsgs replicates;
+  while (s.ok()) {
+    s = tablet_peer->consensus()->ReadCommittedReplicates(from_op_index, max_bytes, &replicates);
+    if (!replicates.empty() || MonoTime::Now() >= deadline) {
+      break;
+    }
+    SleepFor(MonoDelta::FromMilliseconds(FLAGS_cdc_poll_interval_ms));
+  }
+
+  const Schema& schema = *tablet->schema();
+  for (const auto& replicate : replicates) {
+    if (!s.ok()) {
+      break;
+    }
+    if (replicate->op_type() == consensus::WRITE_OP) {
+      s = DecodeCDCRecord(schema, *replicate, resp->add_records());
+    }
+  }
+  if (PREDICT_FALSE(!s.ok())) {
+    resp->clear_records();
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  resp->set_checkpoint_op_index(
+      replicates.empty() ? from_op_index : replicates.back()->id().index());
+  context.RespondSuccess();
+}
+
+namespace {
+
+// Writes the index entries of a batch of an index backfill with a single flush, so that the client
+// sends them to each index tablet in one write request.
+Status WriteIndexBackfillBatch(const client::YBClientPtr& client,
+                               const client::YBTablePtr& index_table,
+                               std::vector<QLWriteRequestPB>* index_requests) {
+  if (index_requests->empty()) {
+    return Status::OK();
+  }
+  auto session = client->NewSession();
+  session->SetTimeout(MonoDelta::FromMilliseconds(FLAGS_index_write_timeout_ms));
+  RETURN_NOT_OK(session->SetFlushMode(client::YBSession::MANUAL_FLUSH));
+  std::vector<client::YBqlWriteOpPtr> index_ops;
+  index_ops.reserve(index_requests->size());
+  for (auto& index_request : *index_requests) {
+    auto index_op = std::make_shared<client::YBqlWriteOp>(index_table);
+    index_op->mutable_request()->Swap(&index_request);
+    RETURN_NOT_OK(session->Apply(index_op));
+    index_ops.push_back(std::move(index_op));
+  }
+  RETURN_NOT_OK(session->Flush());
+  for (const auto& index_op : index_ops) {
+    if (index_op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+      return STATUS_FORMAT(RuntimeError, "Index backfill write failed: $0",
+                           index_op->response().ShortDebugString());
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+void TabletServiceImpl::BackfillIndex(const BackfillIndexRequestPB* req,
+                                      BackfillIndexResponsePB* resp,
+                                      rpc::RpcContext context) {
+  TRACE("BackfillIndex");
+
+  tablet::TabletPeerPtr tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+  TabletServerErrorPB::Code error_code;
+  Status s = CheckPeerIsLeaderAndReady(*tablet_peer, &error_code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, &context);
+    return;
+  }
+  auto tablet = tablet_peer->shared_tablet();
+  auto index = tablet->metadata()->FindIndex(req->index_id());
+  if (!index.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), index.status(),
+                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  const auto& client = tablet_peer->client_future().get();
+  auto index_table = GetIndexTable(client, req->index_id());
+  if (!index_table.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), index_table.status(),
+                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  // Returns before the client gives up, with the row to continue from.
+  const auto deadline = std::min(
+      context.GetClientDeadline(),
+      MonoTime::Now() + MonoDelta::FromMilliseconds(FLAGS_backfill_index_rpc_max_ms));
+  HybridTime read_ht = tablet->SafeTime();
+  if (req->has_read_hybrid_time()) {
+    // The read time of the backfill could have been picked by another tablet.
+    read_ht = HybridTime(req->read_hybrid_time());
+    if (!tablet->SafeTime(tablet::RequireLease::kTrue, read_ht, deadline).is_valid()) {
+      SetupErrorAndRespond(resp->mutable_error(),
+                           STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_ht),
+                           TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
+  }
+  std::string start_key = req->start_key();
+  std::string next_key;
+  uint64_t num_index_entries = 0;
+  std::vector<QLWriteRequestPB> index_requests;
+  do {
+    index_requests.clear();
+    s = tablet->BackfillIndex(*index, read_ht, start_key, FLAGS_backfill_index_write_batch_size,
+                              &index_requests, &next_key);
+    const size_t batch_size = index_requests.size();
+    if (s.ok()) {
+      s = WriteIndexBackfillBatch(client, *index_table, &index_requests);
+    }
+    if (!s.ok()) {
+      break;
+    }
+    num_index_entries += batch_size;
+    start_key.swap(next_key);
+  } while (!start_key.empty() && MonoTime::Now() < deadline);
+
+  // The caller retries from the same start key. Entries that are written again get the same
+  // hybrid time, so they do not change the index.
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  resp->set_read_hybrid_time(read_ht.ToUint64());
+  resp->set_next_key(start_key);
+  resp->set_num_index_entries(num_index_entries);
+  context.RespondSuccess();
+}
+
 void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
                                           CreateTabletResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -657,11 +1076,16 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  if (!CheckWriteThrottlingOrRespond(*tablet_peer, tablet.get(), resp, &context)) {
+    return;
+  }
+
   if (req->has_write_batch() && req->write_batch().has_transaction()) {
     VLOG(1) << "Write with transaction: " << req->write_batch().transaction().ShortDebugString();
   }
 
-  if (PREDICT_FALSE(req->has_write_batch() && !req->write_batch().kv_pairs().empty())) {
+  if (PREDICT_FALSE(req->has_write_batch() && !req->write_batch().kv_pairs().empty() &&
+                    !IsExternalWriteBatch(req->write_batch()))) {
     Status s = STATUS(NotSupported, "Write Request contains write batch. This field should be "
         "used only for post-processed write requests during "
         "Raft replication.");
@@ -671,7 +1095,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
-  bool has_operations = req->ql_write_batch_size() != 0 || req->redis_write_batch_size() != 0;
+  bool has_operations = req->ql_write_batch_size() != 0 || req->redis_write_batch_size() != 0 ||
+                        req->write_batch().kv_pairs_size() != 0;
   if (!has_operations && tablet->table_type() != TableType::REDIS_TABLE_TYPE) {
     // An empty request. This is fine, can just exit early with ok status instead of working hard.
     // This doesn't need to go to Raft log.
@@ -686,7 +1111,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
   auto context_ptr = std::make_shared<RpcContext>(std::move(context));
   operation_state->set_completion_callback(
       std::make_unique<WriteOperationCompletionCallback>(
-          context_ptr, resp, operation_state.get(), server_->Clock(), req->include_trace()));
+          this, tablet_peer, context_ptr, resp, operation_state.get(), server_->Clock(),
+          req->include_trace()));
 
   auto status = tablet_peer->SubmitWrite(std::move(operation_state));
 
@@ -770,6 +1196,9 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
   if (req->consistency_level() == YBConsistencyLevel::STRONG) {
     s = CheckPeerIsLeader(*tablet_peer.get(), &error_code);
     if (PREDICT_FALSE(!s.ok())) {
+      if (error_code == TabletServerErrorPB::NOT_THE_LEADER) {
+        SetupLeaderHint(*tablet_peer, resp->mutable_error());
+      }
       SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
       return false;
     }
@@ -781,6 +1210,13 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
     SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
     return false;
   }
+  // IllegalState makes the client fail over to another replica.
+  if (PREDICT_FALSE(ptr->witness())) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), STATUS(IllegalState, "Witness replica does not have the data"),
+        TabletServerErrorPB::UNKNOWN_ERROR, context);
+    return false;
+  }
   *tablet = ptr;
   return true;
 }
@@ -809,14 +1245,33 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   bool allow_retry = !read_time;
   tablet::RequireLease require_lease(req->consistency_level() == YBConsistencyLevel::STRONG);
   bool transactional = tablet->SchemaRef().table_properties().is_transactional();
-  if (!read_time) {
+  if (!read_time && req->consistency_level() == YBConsistencyLevel::BOUNDED_STALENESS) {
+    // Read at the safe time of this replica, once it is recent enough.
+    auto now_micros = server_->Clock()->Now().GetPhysicalValueMicros();
+    auto max_staleness_micros = std::min<MicrosTime>(req->max_staleness_ms() * 1000, now_micros);
+    auto min_allowed = HybridTime::FromMicros(now_micros - max_staleness_micros);
+    safe_ht_to_read = tablet->SafeTime(require_lease, min_allowed, context.GetClientDeadline());
+    if (!safe_ht_to_read.is_valid()) { // Timed out
+      SetupErrorAndRespond(
+          resp->mutable_error(),
+          STATUS_FORMAT(TimedOut, "Safe time did not reach $0 within the deadline", min_allowed),
+          TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
+    // The read is explicitly stale, so it does not need to be restarted because of the writes
+    // that happened after the read time.
+    read_time = ReadHybridTime::SingleTime(safe_ht_to_read);
+  } else if (!read_time) {
     safe_ht_to_read = tablet->SafeTime(require_lease);
     // If the read time is not specified, then it is non transactional read.
     // So we should restart it in server in case of failure.
     read_time.read = safe_ht_to_read;
     if (transactional) {
-      read_time.local_limit = server_->Clock()->Now().AddMicroseconds(FLAGS_max_clock_skew_usec);
-      read_time.global_limit = read_time.local_limit;
+      // Every write to this tablet that committed before the read arrived has a hybrid time not
+      // above the safe time, which is the read time here. So only the records of other tablets,
+      // i.e. the commit times of transactions, need the clock skew window.
+      read_time.global_limit = server_->Clock()->Now().AddMicroseconds(FLAGS_max_clock_skew_usec);
+      read_time.local_limit = require_lease ? read_time.read : read_time.global_limit;
 
       VLOG(1) << "Read time: " << read_time.ToString();
     } else {
@@ -824,12 +1279,24 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       read_time.global_limit = read_time.read;
     }
   } else {
-    safe_ht_to_read = tablet->SafeTime(require_lease, read_time.read, context.GetClientDeadline());
+    if (FLAGS_enable_unlocked_leader_reads && require_lease && req->redis_batch_size() == 0) {
+      safe_ht_to_read = tablet->SafeTimeForUnlockedRead(
+          req->ql_batch(), read_time.read, context.GetClientDeadline());
+    }
+    if (!safe_ht_to_read.is_valid()) {
+      safe_ht_to_read = tablet->SafeTime(
+          require_lease, read_time.read, context.GetClientDeadline());
+    }
     if (!safe_ht_to_read.is_valid()) { // Timed out
       SetupErrorAndRespond(resp->mutable_error(), STATUS(TimedOut, ""),
                            TabletServerErrorPB::UNKNOWN_ERROR, &context);
       return;
     }
+    if (transactional && require_lease) {
+      // Same for the read time picked by the client: the records of this tablet above its safe
+      // time were written after the read started, so they need no restart, whatever the skew.
+      read_time.local_limit = std::min(read_time.local_limit, safe_ht_to_read);
+    }
   }
 
   if (transactional) {
@@ -902,11 +1369,13 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
     }
     case TableType::YQL_TABLE_TYPE: {
       ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(req);
+      uint32_t ql_batch_index = 0;
       for (QLReadRequestPB& ql_read_req : *mutable_req->mutable_ql_batch()) {
-        // Update the remote endpoint.
-        ql_read_req.set_allocated_remote_endpoint(host_port_pb);
+        // Update the remote endpoint. The request may be allocated on an arena, so use the unsafe
+        // arena accessors to avoid passing ownership of the endpoint to it.
+        ql_read_req.unsafe_arena_set_allocated_remote_endpoint(host_port_pb);
         BOOST_SCOPE_EXIT(&ql_read_req) {
-          ql_read_req.release_remote_endpoint();
+          ql_read_req.unsafe_arena_release_remote_endpoint();
         } BOOST_SCOPE_EXIT_END;
 
         tablet::QLReadRequestResult result;
@@ -925,6 +1394,9 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
             RefCntBuffer(result.rows_data), &rows_data_sidecar_idx));
         result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
         resp->add_ql_batch()->Swap(&result.response);
+        ReadAhead(tablet, read_tx.read_time(), req, ql_read_req, ql_batch_index,
+                  result.rows_data.size(), resp, context);
+        ++ql_batch_index;
       }
       return ReadHybridTime();
     }
@@ -932,6 +1404,52 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
   FATAL_INVALID_ENUM_VALUE(TableType, tablet->table_type());
 }
 
+void TabletServiceImpl::ReadAhead(tablet::AbstractTablet* tablet,
+                                  const ReadHybridTime& read_time,
+                                  const ReadRequestPB* req,
+                                  const QLReadRequestPB& ql_read_req,
+                                  uint32_t ql_batch_index,
+                                  size_t rows_data_size,
+                                  ReadResponsePB* resp,
+                                  rpc::RpcContext* context) {
+  if (!ql_read_req.return_paging_state() || ql_read_req.is_aggregate()) {
+    return;
+  }
+  const auto max_pages = std::min<uint32_t>(
+      ql_read_req.read_ahead_pages(), std::max(FLAGS_ql_read_ahead_max_pages, 0));
+  const QLPagingStatePB* paging_state = &resp->ql_batch(ql_batch_index).paging_state();
+  QLReadRequestPB next_req;
+  // Pages are read at the same read time as the requested page, so that they could be used as if
+  // they were fetched one by one. Errors are left to the next regular fetch.
+  for (uint32_t page = 0; page != max_pages; ++page) {
+    if (paging_state->next_row_key().empty() ||
+        rows_data_size >= static_cast<size_t>(FLAGS_ql_read_ahead_max_bytes)) {
+      return;
+    }
+    if (page == 0) {
+      next_req = ql_read_req;
+    }
+    *next_req.mutable_paging_state() = *paging_state;
+
+    tablet::QLReadRequestResult result;
+    auto status = tablet->HandleQLReadRequest(read_time, next_req, req->transaction(), &result);
+    if (!status.ok() || result.restart_read_ht.is_valid() ||
+        result.response.status() != QLResponsePB::YQL_STATUS_OK) {
+      return;
+    }
+    int rows_data_sidecar_idx = 0;
+    if (!context->AddRpcSidecar(RefCntBuffer(result.rows_data), &rows_data_sidecar_idx).ok()) {
+      return;
+    }
+    rows_data_size += result.rows_data.size();
+    result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
+    auto* read_ahead_page = resp->add_ql_read_ahead_pages();
+    read_ahead_page->set_ql_batch_index(ql_batch_index);
+    read_ahead_page->mutable_response()->Swap(&result.response);
+    paging_state = &read_ahead_page->response().paging_state();
+  }
+}
+
 ConsensusServiceImpl::ConsensusServiceImpl(const scoped_refptr<MetricEntity>& metric_entity,
                                            TabletPeerLookupIf* tablet_manager)
     : ConsensusServiceIf(metric_entity),
@@ -975,6 +1493,57 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(const MultiRaftConsensusRequestPB* req,
+                                                    MultiRaftConsensusResponsePB* resp,
+                                                    rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Raft Consensus Update RPC with " << req->consensus_request_size()
+           << " requests";
+  // Every request is processed as a separate UpdateConsensus call, the errors are reported in
+  // the responses to the individual requests.
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  for (const auto& consensus_req : req->consensus_request()) {
+    ConsensusResponsePB* consensus_resp = resp->add_consensus_response();
+    TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+    Status s;
+    scoped_refptr<TabletPeer> tablet_peer;
+    scoped_refptr<Consensus> consensus;
+    if (consensus_req.dest_uuid() != local_uuid) {
+      s = STATUS_SUBSTITUTE(InvalidArgument,
+          "MultiRaftUpdateConsensus: Wrong destination UUID requested. Local UUID: $0. "
+          "Requested UUID: $1", local_uuid, consensus_req.dest_uuid());
+      error_code = TabletServerErrorPB::WRONG_SERVER_UUID;
+    } else {
+      s = tablet_manager_->GetTabletPeer(consensus_req.tablet_id(), &tablet_peer);
+      if (!s.ok()) {
+        error_code = s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                              : TabletServerErrorPB::TABLET_NOT_FOUND;
+      } else if (tablet_peer->state() != tablet::RUNNING) {
+        s = STATUS(IllegalState, "Tablet not RUNNING",
+                   tablet::TabletStatePB_Name(tablet_peer->state()));
+        error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+      } else {
+        consensus = tablet_peer->shared_consensus();
+        if (!consensus) {
+          s = STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+          error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+        }
+      }
+    }
+    if (s.ok()) {
+      // See UpdateConsensus for why the request is const_cast.
+      s = consensus->Update(const_cast<ConsensusRequestPB*>(&consensus_req), consensus_resp);
+      if (PREDICT_FALSE(!s.ok())) {
+        consensus_resp->Clear();
+      }
+    }
+    if (PREDICT_FALSE(!s.ok())) {
+      StatusToPB(s, consensus_resp->mutable_error()->mutable_status());
+      consensus_resp->mutable_error()->set_code(error_code);
+    }
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1255,21 +1824,54 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+constexpr uint32_t kMaxChecksumHashBuckets = 4096;
+
+// Checksums the rows in the requested hash code range as of read_time, one hash bucket at a time.
+Status CalcChecksum(tablet::Tablet* tablet, const ChecksumRequestPB& req,
+                    const ReadHybridTime& read_time, ChecksumResponsePB* resp) {
   const Schema& schema = tablet->metadata()->schema();
-  auto client_schema = schema.CopyWithoutColumnIds();
-  auto iter = tablet->NewRowIterator(client_schema, boost::none);
-  RETURN_NOT_OK(iter);
+  const uint32_t start = req.hash_code_start();
+  const uint32_t end = req.hash_code_end();
+  const uint32_t num_buckets = req.num_hash_buckets();
+  if (start > end || end > std::numeric_limits<docdb::DocKeyHash>::max()) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid hash code range: [$0, $1]", start, end);
+  }
+  if (num_buckets > kMaxChecksumHashBuckets || num_buckets > end - start + 1) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid number of hash buckets $0 for range [$1, $2]",
+                         num_buckets, start, end);
+  }
+  const bool whole_tablet =
+      num_buckets == 0 && start == 0 && end == std::numeric_limits<docdb::DocKeyHash>::max();
+  if (!whole_tablet && schema.num_hash_key_columns() == 0) {
+    return STATUS(InvalidArgument, "Hash buckets requested for a table without hash columns");
+  }
 
+  auto client_schema = schema.CopyWithoutColumnIds();
   QLTableRow value_map;
   ScanResultChecksummer collector;
-
-  while ((**iter).HasNext()) {
-    RETURN_NOT_OK((**iter).NextRow(&value_map));
-    collector.HandleRow(schema, value_map);
+  const uint64_t size = end - start + 1;
+  const uint32_t num_scans = std::max(num_buckets, 1U);
+  for (uint32_t i = 0; i != num_scans; ++i) {
+    int32_t min_hash_code = docdb::DocQLScanSpec::kUnspecifiedHashCode_;
+    int32_t max_hash_code = docdb::DocQLScanSpec::kUnspecifiedHashCode_;
+    if (!whole_tablet) {
+      min_hash_code = start + size * i / num_scans;
+      max_hash_code = start + size * (i + 1) / num_scans - 1;
+    }
+    auto iter = tablet->NewRowIterator(client_schema, read_time, min_hash_code, max_hash_code);
+    RETURN_NOT_OK(iter);
+    while ((**iter).HasNext()) {
+      RETURN_NOT_OK((**iter).NextRow(&value_map));
+      collector.HandleRow(schema, value_map);
+    }
+    const uint64_t bucket_checksum = collector.TakeBucketChecksum();
+    if (num_buckets != 0) {
+      resp->add_hash_bucket_checksums(bucket_checksum);
+    }
   }
 
-  return collector.agg_checksum();
+  resp->set_checksum(collector.agg_checksum());
+  return Status::OK();
 }
 
 } // namespace
@@ -1283,14 +1885,31 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
-  if (!checksum.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
-                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
-    return;
+
+  // Replicas checksummed at the same hybrid time are expected to match.
+  HybridTime read_ht = abstract_tablet->SafeTime(tablet::RequireLease::kFalse);
+  if (req->has_read_hybrid_time()) {
+    read_ht = HybridTime(req->read_hybrid_time());
+    if (!abstract_tablet->SafeTime(tablet::RequireLease::kFalse, read_ht,
+                                   context.GetClientDeadline()).is_valid()) {
+      SetupErrorAndRespond(resp->mutable_error(),
+                           STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_ht),
+                           TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
   }
 
-  resp->set_checksum(*checksum);
+  // Keeps the history at read_ht from being garbage collected while it is checksummed.
+  tablet::ScopedReadOperation read_operation(
+      abstract_tablet.get(), tablet::RequireLease::kFalse, ReadHybridTime::SingleTime(read_ht));
+  auto status = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()), *req,
+                             read_operation.read_time(), resp);
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR,
+                         &context);
+    return;
+  }
+  resp->set_read_hybrid_time(read_ht.ToUint64());
 
   context.RespondSuccess();
 }
@@ -1314,6 +1933,26 @@ void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::IngestSstFiles(const IngestSstFilesRequestPB* req,
+                                       IngestSstFilesResponsePB* resp,
+                                       rpc::RpcContext context) {
+  tablet::TabletPeerPtr peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &peer)) {
+    return;
+  }
+  std::vector<std::string> file_paths(req->file_paths().begin(), req->file_paths().end());
+  auto status = peer->tablet()->IngestSstFiles(file_paths);
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         status,
+                         TabletServerErrorPB::UNKNOWN_ERROR,
+                         &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::Shutdown() {
 }
 
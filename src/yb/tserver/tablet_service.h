@@ -33,9 +33,12 @@
 #define YB_TSERVER_TABLET_SERVICE_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "yb/client/client_fwd.h"
+#include "yb/common/entity_ids.h"
 #include "yb/common/read_hybrid_time.h"
 #include "yb/consensus/consensus.service.h"
 #include "yb/gutil/ref_counted.h"
@@ -43,6 +46,8 @@
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/tablet_peer.h"
 
+#include "yb/tserver/cdc_producer.h"
+
 #include "yb/tserver/tablet_server_interface.h"
 #include "yb/tserver/tserver_admin.service.h"
 #include "yb/tserver/tserver_service.service.h"
@@ -88,6 +93,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                   ImportDataResponsePB* resp,
                   rpc::RpcContext context) override;
 
+  void IngestSstFiles(const IngestSstFilesRequestPB* req,
+                      IngestSstFilesResponsePB* resp,
+                      rpc::RpcContext context) override;
+
   void UpdateTransaction(const UpdateTransactionRequestPB* req,
                          UpdateTransactionResponsePB* resp,
                          rpc::RpcContext context) override;
@@ -104,8 +113,21 @@ class TabletServiceImpl : public TabletServerServiceIf {
                 TruncateResponsePB* resp,
                 rpc::RpcContext context) override;
 
+  void GetChanges(const GetChangesRequestPB* req,
+                  GetChangesResponsePB* resp,
+                  rpc::RpcContext context) override;
+
+  void BackfillIndex(const BackfillIndexRequestPB* req,
+                     BackfillIndexResponsePB* resp,
+                     rpc::RpcContext context) override;
+
   void Shutdown() override;
 
+  // Returns the index table with the given id, opening it on first use. The index updates of the
+  // writes to the indexed tables are written to the index tables through the client.
+  Result<client::YBTablePtr> GetIndexTable(const client::YBClientPtr& client,
+                                           const TableId& table_id);
+
  private:
   // Check if the tablet peer is the leader and is in ready state for servicing IOs.
   CHECKED_STATUS CheckPeerIsLeaderAndReady(const tablet::TabletPeer& tablet_peer,
@@ -133,6 +155,13 @@ class TabletServiceImpl : public TabletServerServiceIf {
                      tablet::TabletPeerPtr* tablet_peer,
                      tablet::TabletPtr* tablet);
 
+  // Rejects the write with SERVER_BUSY and a backoff hint when the tablet is overloaded, so that
+  // the client slows down instead of the writes stalling in RocksDB. Returns false if responded.
+  bool CheckWriteThrottlingOrRespond(const tablet::TabletPeer& tablet_peer,
+                                     tablet::Tablet* tablet,
+                                     WriteResponsePB* resp,
+                                     rpc::RpcContext* context);
+
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
   Result<ReadHybridTime> DoRead(tablet::AbstractTablet* tablet,
@@ -144,7 +173,22 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                 ReadResponsePB* resp,
                                 rpc::RpcContext* context);
 
+  // Reads the pages that follow the response to ql_batch_index, if the request asks for it.
+  void ReadAhead(tablet::AbstractTablet* tablet,
+                 const ReadHybridTime& read_time,
+                 const ReadRequestPB* req,
+                 const QLReadRequestPB& ql_read_req,
+                 uint32_t ql_batch_index,
+                 size_t rows_data_size,
+                 ReadResponsePB* resp,
+                 rpc::RpcContext* context);
+
   TabletServerIf *const server_;
+
+  std::mutex index_table_cache_mutex_;
+  std::shared_ptr<client::YBMetaDataCache> index_table_cache_;
+
+  CDCCheckpoints cdc_checkpoints_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -181,6 +225,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB* req,
+                                        consensus::MultiRaftConsensusResponsePB* resp,
+                                        rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
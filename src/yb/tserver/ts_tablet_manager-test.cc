@@ -32,6 +32,7 @@
 
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include <set>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -150,6 +151,35 @@ TEST_F(TsTabletManagerTest, TestCreateTablet) {
   ASSERT_EQ(kTabletId, peer->tablet()->tablet_id());
 }
 
+TEST_F(TsTabletManagerTest, TestDirAssignmentAcrossTables) {
+  const int kNumDirs = 3;
+  FsManagerOpts opts;
+  opts.server_type = "tserver";
+  for (int i = 0; i < kNumDirs; ++i) {
+    opts.data_paths.push_back(GetTestPath(Format("data-$0", i)));
+    opts.wal_paths.push_back(GetTestPath(Format("wal-$0", i)));
+  }
+  FsManager fs_manager(env_.get(), opts);
+  ASSERT_OK(fs_manager.CreateInitialFileSystemLayout());
+  ASSERT_OK(fs_manager.Open());
+
+  // Each table has a single tablet, so the tablets are spread over the directories only because
+  // ties between a table's directories are broken by the tablets of the other tables.
+  std::set<string> data_dirs;
+  std::set<string> wal_dirs;
+  for (int i = 0; i < kNumDirs; ++i) {
+    string data_dir;
+    string wal_dir;
+    tablet_manager_->GetAndRegisterDataAndWalDir(
+        &fs_manager, Format("table-$0", i), Format("tablet-$0", i), TableType::DEFAULT_TABLE_TYPE,
+        &data_dir, &wal_dir);
+    data_dirs.insert(data_dir);
+    wal_dirs.insert(wal_dir);
+  }
+  ASSERT_EQ(kNumDirs, data_dirs.size());
+  ASSERT_EQ(kNumDirs, wal_dirs.size());
+}
+
 TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   FlagSaver flag_saver;
   FLAGS_pretend_memory_exceeded_enforce_flush = true;
@@ -33,6 +33,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -49,9 +50,12 @@
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/fs/fs_manager.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -76,6 +80,7 @@
 #include "yb/tserver/remote_bootstrap_client.h"
 #include "yb/tserver/tablet_server.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/background_task.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env.h"
@@ -155,6 +160,43 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_string(db_block_cache_type, "lru",
+              "Replacement policy of the shared RocksDB block cache: lru or clock. The clock cache "
+              "does not take an exclusive lock on cache hits.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+DEFINE_int64(db_compressed_block_cache_size_bytes, 0,
+             "Size of the cross-tablet shared RocksDB cache of compressed blocks (in bytes). "
+             "Blocks missing from the block cache are looked up there before reading the SST "
+             "file, and since they are kept compressed, it holds several times more data per byte "
+             "than the block cache. Value of 0 disables it.");
+TAG_FLAG(db_compressed_block_cache_size_bytes, advanced);
+
+DEFINE_int32(db_compressed_block_cache_size_percentage, 0,
+             "Percentage of the block cache size to use for the compressed block cache instead, "
+             "if not asking for a raw number through FLAGS_db_compressed_block_cache_size_bytes. "
+             "The total memory used by both caches stays the same.");
+TAG_FLAG(db_compressed_block_cache_size_percentage, advanced);
+
+DEFINE_int32(db_max_open_files, 20000,
+             "Maximum number of SST files kept open by all the tablets of the tablet server "
+             "together. The least recently used ones are closed first, instead of each tablet "
+             "keeping up to 5000 of its files open. Each open SST takes two file descriptors, for "
+             "its metadata and data files. Value of 0 disables the shared limit.");
+TAG_FLAG(db_max_open_files, advanced);
+
+DEFINE_int32(tablet_dormant_after_idle_sec, 0,
+             "Tablets without reads or writes for this long become dormant: their memtables are "
+             "flushed and their log caches are emptied, so that idle tablets take little memory. "
+             "The next read or write reactivates the tablet. Value of 0 disables it.");
+TAG_FLAG(tablet_dormant_after_idle_sec, advanced);
+TAG_FLAG(tablet_dormant_after_idle_sec, runtime);
+
+DEFINE_int32(tablet_dormant_check_interval_ms, 60000,
+             "How often the tablet server looks for idle tablets to make dormant, see "
+             "tablet_dormant_after_idle_sec.");
+TAG_FLAG(tablet_dormant_check_interval_ms, advanced);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -230,6 +272,35 @@ void TSTabletManager::MaybeFlushTablet() {
   }
 }
 
+// Only called from the dormant tablets background task.
+void TSTabletManager::MakeIdleTabletsDormant() {
+  const int32_t idle_sec = GetAtomicFlag(&FLAGS_tablet_dormant_after_idle_sec);
+  if (idle_sec <= 0) {
+    return;
+  }
+  const MonoDelta max_idle_time = MonoDelta::FromSeconds(idle_sec);
+
+  vector<scoped_refptr<TabletPeer>> peers;
+  GetTabletPeers(&peers);
+  size_t num_made_dormant = 0;
+  for (const auto& peer : peers) {
+    const auto tablet = peer->shared_tablet();
+    if (!tablet || tablet->dormant() || tablet->IdleTime() < max_idle_time) {
+      continue;
+    }
+    Status s = peer->MakeDormant();
+    if (s.ok()) {
+      ++num_made_dormant;
+    } else {
+      VLOG(1) << "Failed to make tablet " << peer->tablet_id() << " dormant: " << s;
+    }
+  }
+  if (num_made_dormant != 0) {
+    LOG(INFO) << "Made " << num_made_dormant << " tablets dormant after being idle for "
+              << max_idle_time;
+  }
+}
+
 // Return the tablet with the oldest write in memstore, or nullptr if all
 // tablet memstores are empty or about to flush.
 scoped_refptr<TabletPeer> TSTabletManager::TabletToFlush() {
@@ -295,10 +366,36 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
 
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
+  int64_t compressed_block_cache_size_bytes = FLAGS_db_compressed_block_cache_size_bytes;
+  if (compressed_block_cache_size_bytes == 0 &&
+      FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
+    CHECK(FLAGS_db_compressed_block_cache_size_percentage >= 0 &&
+          FLAGS_db_compressed_block_cache_size_percentage < 100)
+        << "Flag db_compressed_block_cache_size_percentage must be between 0 and 99. Current "
+        << "value: " << FLAGS_db_compressed_block_cache_size_percentage;
+    // Compressed blocks take a fraction of the memory of the same blocks uncompressed, so a part
+    // of the budget moved to the compressed tier caches more data.
+    compressed_block_cache_size_bytes =
+        block_cache_size_bytes * FLAGS_db_compressed_block_cache_size_percentage / 100;
+    block_cache_size_bytes -= compressed_block_cache_size_bytes;
+  }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes);
+    if (FLAGS_db_block_cache_type == "clock") {
+      tablet_options_.block_cache = rocksdb::NewClockCache(block_cache_size_bytes);
+    } else {
+      CHECK_EQ(FLAGS_db_block_cache_type, "lru") << "Invalid db_block_cache_type";
+      tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes);
+    }
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
+  // Hits and misses of this tier are tracked by the rocksdb_block_cachecompressed_* tickers.
+  if (compressed_block_cache_size_bytes > 0) {
+    tablet_options_.compressed_block_cache =
+        rocksdb::NewLRUCache(compressed_block_cache_size_bytes);
+  }
+  if (FLAGS_db_max_open_files > 0) {
+    tablet_options_.table_cache = rocksdb::NewLRUCache(FLAGS_db_max_open_files);
+  }
 
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
@@ -326,6 +423,18 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
   }
+
+  if (FLAGS_tablet_dormant_check_interval_ms > 0) {
+    dormant_tablets_task_.reset(new BackgroundTask(
+      std::function<void()>([this](){ MakeIdleTabletsDormant(); }),
+      "tablet manager",
+      "dormant tablets bgtask",
+      std::chrono::milliseconds(FLAGS_tablet_dormant_check_interval_ms)));
+  }
+
+  // Flushes and compactions of all tablets share the background thread pools of the default Env,
+  // which pick the jobs of the tablets closest to write stalls first, and the disk write budget.
+  tablet_options_.rate_limiter = docdb::CreateSharedRocksDBRateLimiter();
 }
 
 TSTabletManager::~TSTabletManager() {
@@ -334,6 +443,9 @@ TSTabletManager::~TSTabletManager() {
 Status TSTabletManager::Init() {
   CHECK_EQ(state(), MANAGER_INITIALIZING);
 
+  // The messenger is not created until the server is initialized.
+  multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(server_->messenger());
+
   // Start the threadpool we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
   // FsManager isn't initialized until this point.
@@ -398,6 +510,10 @@ Status TSTabletManager::Init() {
     RETURN_NOT_OK(background_task_->Init());
   }
 
+  if (dormant_tablets_task_) {
+    RETURN_NOT_OK(dormant_tablets_task_->Init());
+  }
+
   return Status::OK();
 }
 
@@ -435,8 +551,12 @@ Status TSTabletManager::CreateNewTablet(
   for (int i = 0; i < config.peers_size(); ++i) {
     auto config_peer = config.mutable_peers(i);
     if (config_peer->has_member_type()) {
-      return STATUS(IllegalState, Substitute("member_type shouldn't be set for config: { $0 }",
-                                             config.ShortDebugString()));
+      // The master only marks the read replicas, which are created as observers.
+      if (config_peer->member_type() != RaftPeerPB::OBSERVER) {
+        return STATUS(IllegalState, Substitute("member_type shouldn't be set for config: { $0 }",
+                                               config.ShortDebugString()));
+      }
+      continue;
     }
     config_peer->set_member_type(RaftPeerPB::VOTER);
   }
@@ -596,6 +716,22 @@ Status TSTabletManager::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB
         Substitute("remote bootstrapping tablet from peer $0", bootstrap_peer_uuid), &deleter));
   }
 
+  if (replacing_tablet && req.replace_lagging_replica() &&
+      meta->tablet_data_state() == TABLET_DATA_READY && tablet_id != master::kSysCatalogTabletId) {
+    // The leader no longer has the logs this replica needs to catch up, so it is tombstoned and
+    // replaced by a copy of the leader's.
+    yb::OpId last_logged_opid;
+    if (old_tablet_peer->log()) {
+      last_logged_opid = old_tablet_peer->log()->GetLatestEntryOpId();
+    }
+    RETURN_NOT_OK(CheckLeaderTermNotLower(tablet_id, fs_manager_->uuid(), leader_term,
+                                          last_logged_opid.term));
+    LOG(INFO) << kLogPrefix << "Tombstoning replica that lags behind the logs of the leader";
+    old_tablet_peer->Shutdown();
+    RETURN_NOT_OK(DeleteTabletData(meta, TABLET_DATA_TOMBSTONED, fs_manager_->uuid(),
+                                   last_logged_opid, this));
+  }
+
   if (replacing_tablet) {
     // Make sure the existing tablet peer is shut down and tombstoned.
     RETURN_NOT_OK(HandleReplacingStaleTablet(meta,
@@ -886,7 +1022,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
                                     server_->messenger(),
                                     log,
                                     tablet->GetMetricEntity(),
-                                    raft_pool());
+                                    raft_pool(),
+                                    multi_raft_manager_.get());
 
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to init: "
@@ -924,6 +1061,10 @@ void TSTabletManager::Shutdown() {
     background_task_->Shutdown();
   }
 
+  if (dormant_tablets_task_) {
+    dormant_tablets_task_->Shutdown();
+  }
+
   {
     std::lock_guard<rw_spinlock> lock(lock_);
     switch (state_) {
@@ -1229,24 +1370,13 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
     }
   }
   // Find the data directory with the least count of tablets for this table.
-  table_data_assignment_iter = table_data_assignment_map_.find(table_id);
-  auto data_assignment_value_map = table_data_assignment_iter->second;
-  string min_dir;
-  uint64_t min_dir_count = kuint64max;
-  for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  string min_dir = GetLeastLoadedDir(table_data_assignment_map_, table_id);
   *data_root_dir = min_dir;
   // Increment the count for min_dir.
   auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
   data_assignment_value_iter->second.insert(tablet_id);
 
   // Find the wal directory with the least count of tablets for this table.
-  min_dir = "";
-  min_dir_count = kuint64max;
   auto wal_root_dirs = fs_manager->GetWalRootDirs();
   CHECK(!wal_root_dirs.empty()) << "No wal root directories found";
   auto table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
@@ -1256,19 +1386,40 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_wal_assignment_map_[table_id][wal_root_iter] = tablet_id_set;
     }
   }
-  table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
-  auto wal_assignment_value_map = table_wal_assignment_iter->second;
-  for (auto it = wal_assignment_value_map.begin(); it != wal_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  min_dir = GetLeastLoadedDir(table_wal_assignment_map_, table_id);
   *wal_root_dir = min_dir;
   auto wal_assignment_value_iter = table_wal_assignment_map_[table_id].find(min_dir);
   wal_assignment_value_iter->second.insert(tablet_id);
 }
 
+string TSTabletManager::GetLeastLoadedDir(const TableDiskAssignmentMap& assignment_map,
+                                          const string& table_id) {
+  const auto& table_dirs = assignment_map.at(table_id);
+  string min_dir;
+  size_t min_dir_count = std::numeric_limits<size_t>::max();
+  size_t min_dir_total_count = std::numeric_limits<size_t>::max();
+  for (const auto& dir_and_tablets : table_dirs) {
+    const string& dir = dir_and_tablets.first;
+    const size_t count = dir_and_tablets.second.size();
+    if (count > min_dir_count) {
+      continue;
+    }
+    size_t total_count = 0;
+    for (const auto& table_and_dirs : assignment_map) {
+      auto it = table_and_dirs.second.find(dir);
+      if (it != table_and_dirs.second.end()) {
+        total_count += it->second.size();
+      }
+    }
+    if (count < min_dir_count || total_count < min_dir_total_count) {
+      min_dir = dir;
+      min_dir_count = count;
+      min_dir_total_count = total_count;
+    }
+  }
+  return min_dir;
+}
+
 void TSTabletManager::RegisterDataAndWalDir(FsManager* fs_manager,
                                             const string& table_id,
                                             const string& tablet_id,
@@ -70,6 +70,7 @@ class Schema;
 class BackgroundTask;
 
 namespace consensus {
+class MultiRaftManager;
 class RaftConfigPB;
 } // namespace consensus
 
@@ -272,6 +273,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
+  // Makes the tablets idle for --tablet_dormant_after_idle_sec dormant, see
+  // TabletPeer::MakeDormant.
+  void MakeIdleTabletsDormant();
+
  private:
   FRIEND_TEST(TsTabletManagerTest, TestPersistBlocks);
 
@@ -389,6 +394,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                              std::unordered_map<std::string, std::unordered_set<std::string>>>
     TableDiskAssignmentMap;
 
+  // Returns the directory assigned the fewest tablets of 'table_id' in 'assignment_map', breaking
+  // ties by the number of tablets of all tables in the directory. Without the tie break, tables
+  // with fewer tablets than directories would all be placed on the same directory.
+  static std::string GetLeastLoadedDir(const TableDiskAssignmentMap& assignment_map,
+                                       const std::string& table_id);
+
   // Lock protecting tablet_map_, dirty_tablets_, state_, and
   // transition_in_progress_.
   mutable rw_spinlock lock_;
@@ -426,9 +437,15 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for Raft-related operations, shared between all tablets.
   std::unique_ptr<ThreadPool> raft_pool_;
 
+  // Batches the heartbeats of the tablets led by this server to the same remote server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Looks for idle tablets every --tablet_dormant_check_interval_ms.
+  std::unique_ptr<BackgroundTask> dormant_tablets_task_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
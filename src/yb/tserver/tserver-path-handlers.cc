@@ -41,6 +41,7 @@
 
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
@@ -112,6 +113,9 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/hot-keys", "", std::bind(&TabletServerPathHandlers::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -474,5 +478,49 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "</table>\n";
 }
 
+namespace {
+
+string HotKeyToString(const string& encoded_key) {
+  docdb::DocKey doc_key;
+  Slice slice(encoded_key);
+  if (doc_key.DecodeFrom(&slice, docdb::DocKeyPart::HASHED_PART_ONLY).ok()) {
+    return doc_key.ToString();
+  }
+  return Slice(encoded_key).ToDebugString();
+}
+
+}  // anonymous namespace
+
+void TabletServerPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  vector<scoped_refptr<TabletPeer> > peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+  std::sort(peers.begin(), peers.end(), &CompareByTabletId);
+
+  *output << "<h1>Hot Keys</h1>\n";
+  *output << "<p>Estimated reads and writes of the hottest hash partition keys of each tablet, "
+          << "sampled and halved every --hot_key_decay_sec.</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Key</th><th>Accesses</th>"
+          << "<th>Share of tablet accesses</th></tr>\n";
+  for (const scoped_refptr<TabletPeer>& peer : peers) {
+    std::shared_ptr<Tablet> tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    const uint64_t total = tablet->hot_keys().TotalCount();
+    for (const auto& hot_key : tablet->hot_keys().TopKeys()) {
+      *output << Substitute(
+          "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4%</td></tr>\n",
+          EscapeForHtmlToString(peer->tablet_metadata()->table_name()),
+          TabletLink(peer->tablet_id()),
+          EscapeForHtmlToString(HotKeyToString(hot_key.key)),
+          hot_key.count,
+          total == 0 ? 0 : std::min<uint64_t>(hot_key.count * 100 / total, 100));
+    }
+  }
+  *output << "</table>\n";
+}
+
 }  // namespace tserver
 }  // namespace yb
@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/async_logger.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+// Records the messages, optionally blocking the writes until unblocked, like a stalled disk.
+class FakeLogger : public google::base::Logger {
+ public:
+  void Write(bool force_flush, time_t timestamp, const char* message, int message_len) override {
+    unblocked_.Wait();
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_.emplace_back(message, message_len);
+  }
+
+  void Flush() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++flushes_;
+  }
+
+  google::uint32 LogSize() override {
+    return 0;
+  }
+
+  void Block() { unblocked_.Reset(1); }
+  void Unblock() { unblocked_.CountDown(); }
+
+  std::vector<std::string> messages() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messages_;
+  }
+
+  int flushes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flushes_;
+  }
+
+ private:
+  CountDownLatch unblocked_{0};
+  std::mutex mutex_;
+  std::vector<std::string> messages_;
+  int flushes_ = 0;
+};
+
+void Log(google::base::Logger* logger, const std::string& message) {
+  logger->Write(false /* force_flush */, 0 /* timestamp */, message.data(), message.size());
+}
+
+} // namespace
+
+class AsyncLoggerTest : public YBTest {
+};
+
+TEST_F(AsyncLoggerTest, TestWritesInOrder) {
+  FakeLogger fake;
+  AsyncLogger logger(&fake, 1024 * 1024);
+  logger.Start();
+
+  const int kNumMessages = 1000;
+  for (int i = 0; i < kNumMessages; ++i) {
+    Log(&logger, std::to_string(i));
+  }
+  logger.Flush();
+
+  auto messages = fake.messages();
+  ASSERT_EQ(kNumMessages, messages.size());
+  for (int i = 0; i < kNumMessages; ++i) {
+    ASSERT_EQ(std::to_string(i), messages[i]);
+  }
+  ASSERT_GE(fake.flushes(), 1);
+  ASSERT_EQ(0, logger.dropped_messages());
+
+  // Once stopped, the messages are written synchronously.
+  logger.Stop();
+  Log(&logger, "after stop");
+  ASSERT_EQ(kNumMessages + 1, fake.messages().size());
+}
+
+TEST_F(AsyncLoggerTest, TestDropsWhenWriterFallsBehind) {
+  FakeLogger fake;
+  const std::string kMessage(100, 'x');
+  AsyncLogger logger(&fake, 10 * kMessage.size());
+  logger.Start();
+
+  // The writer is stuck on the buffer it took, so at most 10 messages fit in it and 10 more in the
+  // active buffer, while the rest are dropped without blocking the caller.
+  fake.Block();
+  const int kNumMessages = 100;
+  for (int i = 0; i < kNumMessages; ++i) {
+    Log(&logger, kMessage);
+  }
+  ASSERT_GE(logger.dropped_messages(), kNumMessages - 20);
+  fake.Unblock();
+  logger.Flush();
+
+  auto messages = fake.messages();
+  ASSERT_FALSE(messages.empty());
+  ASSERT_NE(std::string::npos, messages.back().find("Dropped")) << messages.back();
+  ASSERT_NE(std::string::npos, messages.back().find("log writer fell behind"));
+  logger.Stop();
+}
+
+} // namespace yb
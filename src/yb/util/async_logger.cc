@@ -0,0 +1,143 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/async_logger.h"
+
+#include <time.h>
+
+#include "yb/gutil/strings/substitute.h"
+
+namespace yb {
+
+void AsyncLogger::Buffer::Clear() {
+  messages.clear();
+  bytes = 0;
+  dropped = 0;
+  flush = false;
+}
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped, size_t max_buffer_bytes)
+    : wrapped_(DCHECK_NOTNULL(wrapped)),
+      max_buffer_bytes_(max_buffer_bytes),
+      active_(new Buffer),
+      writing_(new Buffer) {
+}
+
+AsyncLogger::~AsyncLogger() {
+  Stop();
+}
+
+void AsyncLogger::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK(state_ == State::kInitialized);
+  state_ = State::kRunning;
+  thread_ = std::thread(&AsyncLogger::RunThread, this);
+}
+
+void AsyncLogger::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::kRunning) {
+      state_ = State::kStopped;
+      return;
+    }
+    state_ = State::kStopped;
+  }
+  wake_writer_.notify_one();
+  thread_.join();
+  wrapped_->Flush();
+}
+
+void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message, int message_len) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (state_ != State::kRunning) {
+      lock.unlock();
+      wrapped_->Write(force_flush, timestamp, message, message_len);
+      return;
+    }
+    if (active_->bytes + message_len > max_buffer_bytes_) {
+      ++active_->dropped;
+      dropped_messages_.fetch_add(1, std::memory_order_acq_rel);
+    } else {
+      active_->messages.push_back(Message{timestamp, std::string(message, message_len)});
+      active_->bytes += message_len;
+    }
+    active_->flush = active_->flush || force_flush;
+  }
+  wake_writer_.notify_one();
+}
+
+void AsyncLogger::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (state_ != State::kRunning) {
+    lock.unlock();
+    wrapped_->Flush();
+    return;
+  }
+  // The buffer the writer takes next has all the messages logged so far, that are not being
+  // written already.
+  const uint64_t target = buffers_taken_ + 1;
+  flush_requested_ = true;
+  wake_writer_.notify_one();
+  buffer_written_.wait(lock, [this, target] {
+    return buffers_written_ >= target || state_ != State::kRunning;
+  });
+}
+
+google::uint32 AsyncLogger::LogSize() {
+  return wrapped_->LogSize();
+}
+
+void AsyncLogger::RunThread() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_writer_.wait(lock, [this] {
+      return !active_->empty() || flush_requested_ || state_ != State::kRunning;
+    });
+    if (active_->empty() && !flush_requested_) {
+      // Stopped, with all the messages written.
+      break;
+    }
+    const bool flush = flush_requested_ || active_->flush;
+    flush_requested_ = false;
+    std::swap(active_, writing_);
+    ++buffers_taken_;
+    lock.unlock();
+
+    WriteBuffer(*writing_);
+    if (flush) {
+      wrapped_->Flush();
+    }
+    writing_->Clear();
+
+    lock.lock();
+    ++buffers_written_;
+    buffer_written_.notify_all();
+  }
+}
+
+void AsyncLogger::WriteBuffer(const Buffer& buffer) {
+  for (const auto& message : buffer.messages) {
+    wrapped_->Write(false /* force_flush */, message.timestamp, message.text.data(),
+                    message.text.size());
+  }
+  if (buffer.dropped != 0) {
+    const std::string text = strings::Substitute(
+        "Dropped $0 log messages, the log writer fell behind (total dropped: $1)\n",
+        buffer.dropped, dropped_messages());
+    wrapped_->Write(false /* force_flush */, time(nullptr), text.data(), text.size());
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,113 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ASYNC_LOGGER_H
+#define YB_UTIL_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+// A glog logger that hands the messages over to a dedicated writer thread, which writes them to
+// the wrapped logger, e.g. the log file of a severity. So the threads that log never wait for the
+// disk, only for a memcpy into a buffer.
+//
+// The buffer holds at most max_buffer_bytes of messages. When the writer falls behind, e.g. on a
+// stalled log disk, the messages that do not fit are dropped instead of blocking the caller, and
+// the writer reports how many were dropped in the log itself.
+class AsyncLogger : public google::base::Logger {
+ public:
+  AsyncLogger(google::base::Logger* wrapped, size_t max_buffer_bytes);
+  ~AsyncLogger();
+
+  void Start();
+
+  // Writes the buffered messages and stops the writer thread. Messages logged after that are
+  // written synchronously.
+  void Stop();
+
+  void Write(bool force_flush, time_t timestamp, const char* message, int message_len) override;
+
+  // Waits until the messages logged before the call are written, then flushes the wrapped logger.
+  void Flush() override;
+
+  google::uint32 LogSize() override;
+
+  google::base::Logger* wrapped() const { return wrapped_; }
+
+  // Total number of messages that were dropped because the buffer was full.
+  size_t dropped_messages() const {
+    return dropped_messages_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Message {
+    time_t timestamp;
+    std::string text;
+  };
+
+  struct Buffer {
+    std::vector<Message> messages;
+    size_t bytes = 0;
+    size_t dropped = 0;
+    bool flush = false;
+
+    bool empty() const { return messages.empty() && dropped == 0; }
+    void Clear();
+  };
+
+  void RunThread();
+
+  void WriteBuffer(const Buffer& buffer);
+
+  google::base::Logger* const wrapped_;
+  const size_t max_buffer_bytes_;
+
+  // Not a yb::Thread, which logs itself and depends on the logging being initialized.
+  std::thread thread_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_writer_;
+  std::condition_variable buffer_written_;
+
+  enum class State { kInitialized, kRunning, kStopped };
+  State state_ = State::kInitialized;
+
+  // Messages logged since the writer took the previous buffer.
+  std::unique_ptr<Buffer> active_;
+  // Messages being written by the writer thread.
+  std::unique_ptr<Buffer> writing_;
+
+  bool flush_requested_ = false;
+  // Number of buffers taken and written by the writer thread.
+  uint64_t buffers_taken_ = 0;
+  uint64_t buffers_written_ = 0;
+
+  std::atomic<size_t> dropped_messages_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogger);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_ASYNC_LOGGER_H
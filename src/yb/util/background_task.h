@@ -81,9 +81,11 @@ class BackgroundTask {
         return true;
       }
 
-      // Wait
+      // Wait, the task also runs every interval when it is set.
       if (interval_ != std::chrono::milliseconds::zero()) {
-        cond_.wait_for(lock, interval_);
+        if (cond_.wait_for(lock, interval_) == std::cv_status::timeout && !closing_) {
+          return true;
+        }
       } else {
         cond_.wait(lock);
       }
@@ -232,12 +232,13 @@ const vector<BFDecl> kBFDirectory = {
   { "ServerOperator", "sum", DECIMAL, {DECIMAL}, TSOpcode::kSum, false },
 
   // Cassandra behavior: AVG() has exactly the same datatype as the input argument's type.
-  { "ServerOperator", "avg", INT8, {INT8}, TSOpcode::kAvg, false },
-  { "ServerOperator", "avg", INT16, {INT16}, TSOpcode::kAvg, false },
-  { "ServerOperator", "avg", INT32, {INT32}, TSOpcode::kAvg, false },
-  { "ServerOperator", "avg", INT64, {INT64}, TSOpcode::kAvg, false },
-  { "ServerOperator", "avg", FLOAT, {FLOAT}, TSOpcode::kAvg, false },
-  { "ServerOperator", "avg", DOUBLE, {DOUBLE}, TSOpcode::kAvg, false },
+  // AVG() is executed as SUM() and COUNT() partials that are merged by the QL executor.
+  { "ServerOperator", "avg", INT8, {INT8}, TSOpcode::kAvg },
+  { "ServerOperator", "avg", INT16, {INT16}, TSOpcode::kAvg },
+  { "ServerOperator", "avg", INT32, {INT32}, TSOpcode::kAvg },
+  { "ServerOperator", "avg", INT64, {INT64}, TSOpcode::kAvg },
+  { "ServerOperator", "avg", FLOAT, {FLOAT}, TSOpcode::kAvg },
+  { "ServerOperator", "avg", DOUBLE, {DOUBLE}, TSOpcode::kAvg },
   { "ServerOperator", "avg", VARINT, {VARINT}, TSOpcode::kAvg, false },
   { "ServerOperator", "avg", DECIMAL, {DECIMAL}, TSOpcode::kAvg, false },
 
@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <sched.h>
+
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/gutil/sysinfo.h"
+#include "yb/util/cpu_affinity.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class CpuAffinityTest : public YBTest {
+};
+
+TEST_F(CpuAffinityTest, TestParseCpuList) {
+  auto cpus = ParseCpuList("0-3,8,10-11\n");
+  ASSERT_OK(cpus.status());
+  ASSERT_EQ(CpuSet({0, 1, 2, 3, 8, 10, 11}), *cpus);
+
+  cpus = ParseCpuList("\n");
+  ASSERT_OK(cpus.status());
+  ASSERT_TRUE(cpus->empty());
+
+  ASSERT_FALSE(ParseCpuList("3-1").ok());
+  ASSERT_FALSE(ParseCpuList("1-2-3").ok());
+  ASSERT_FALSE(ParseCpuList("a").ok());
+}
+
+TEST_F(CpuAffinityTest, TestNumaNodes) {
+  const auto& nodes = NumaNodes();
+  ASSERT_FALSE(nodes.empty());
+  for (const auto& node : nodes) {
+    ASSERT_FALSE(node.cpus.empty());
+    for (int cpu : node.cpus) {
+      ASSERT_LE(cpu, base::MaxCPUIndex());
+    }
+  }
+  ASSERT_EQ(&NumaNodeForKey("tablet"), &NumaNodeForKey("tablet"));
+}
+
+#if !defined(__APPLE__)
+TEST_F(CpuAffinityTest, TestPreferNumaNodeForMemory) {
+  const size_t kSize = 1024 * 1024;
+  std::unique_ptr<char[]> buffer(new char[kSize]);
+  ASSERT_OK(PreferNumaNodeForMemory(buffer.get(), kSize, kNoNumaNode));
+  // A range smaller than a page does not contain a whole page.
+  ASSERT_OK(PreferNumaNodeForMemory(buffer.get() + 1, 16, 0));
+  const int node = NumaNodeForKey("tablet").id;
+  if (node != kNoNumaNode) {
+    ASSERT_OK(PreferNumaNodeForMemory(buffer.get(), kSize, node));
+  }
+}
+#endif // !defined(__APPLE__)
+
+#if !defined(__APPLE__)
+TEST_F(CpuAffinityTest, TestSetCurrentThreadCpuAffinity) {
+  std::thread thread([] {
+    // The CPU the thread is running on is always allowed.
+    const int cpu = sched_getcpu();
+    ASSERT_OK(SetCurrentThreadCpuAffinity({cpu}));
+    for (int i = 0; i != 100; ++i) {
+      std::this_thread::yield();
+      ASSERT_EQ(cpu, sched_getcpu());
+    }
+  });
+  thread.join();
+}
+#endif // !defined(__APPLE__)
+
+} // namespace yb
@@ -0,0 +1,161 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/cpu_affinity.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#if !defined(__APPLE__)
+#include <sys/syscall.h>
+#endif
+
+#include <vector>
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/sysinfo.h"
+#include "yb/util/env.h"
+#include "yb/util/errno.h"
+#include "yb/util/faststring.h"
+#include "yb/util/format.h"
+#include "yb/util/hash_util.h"
+
+namespace yb {
+
+namespace {
+
+// Memory policy of the mbind system call, from linux/mempolicy.h.
+constexpr int kMemoryPolicyPreferred = 1;
+
+std::vector<NumaNode> ReadNumaNodes() {
+  std::vector<NumaNode> result;
+#if !defined(__APPLE__)
+  Env* env = Env::Default();
+  for (int node = 0;; ++node) {
+    const auto path = Format("/sys/devices/system/node/node$0/cpulist", node);
+    if (!env->FileExists(path)) {
+      break;
+    }
+    faststring contents;
+    auto status = ReadFileToString(env, path, &contents);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to read the CPUs of NUMA node " << node << ": " << status;
+      result.clear();
+      break;
+    }
+    auto cpus = ParseCpuList(contents.ToString());
+    if (!cpus.ok()) {
+      LOG(WARNING) << "Failed to parse the CPUs of NUMA node " << node << ": " << cpus.status();
+      result.clear();
+      break;
+    }
+    // Nodes without CPUs, e.g. memory only ones, can't run threads.
+    if (!cpus->empty()) {
+      result.push_back(NumaNode{node, std::move(*cpus)});
+    }
+  }
+#endif // !defined(__APPLE__)
+  if (result.empty()) {
+    CpuSet all_cpus;
+    for (int cpu = 0; cpu <= base::MaxCPUIndex(); ++cpu) {
+      all_cpus.push_back(cpu);
+    }
+    result.push_back(NumaNode{kNoNumaNode, std::move(all_cpus)});
+  }
+  return result;
+}
+
+} // namespace
+
+Result<CpuSet> ParseCpuList(const std::string& cpu_list) {
+  CpuSet result;
+  const std::string trimmed = boost::algorithm::trim_copy(cpu_list);
+  if (trimmed.empty()) {
+    return result;
+  }
+  std::vector<std::string> ranges = strings::Split(trimmed, ",");
+  for (const auto& range : ranges) {
+    std::vector<std::string> bounds = strings::Split(range, "-");
+    int32_t first = 0;
+    int32_t last = 0;
+    if (bounds.size() > 2 || !safe_strto32(bounds[0], &first) ||
+        !safe_strto32(bounds.back(), &last) || first < 0 || last < first) {
+      return STATUS_FORMAT(InvalidArgument, "Bad CPU list: $0", cpu_list);
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+const std::vector<NumaNode>& NumaNodes() {
+  static const std::vector<NumaNode> result = ReadNumaNodes();
+  return result;
+}
+
+const NumaNode& NumaNodeForKey(const Slice& key) {
+  const auto& nodes = NumaNodes();
+  const uint64_t hash = HashUtil::MurmurHash2_64(key.data(), static_cast<int>(key.size()), 0);
+  return nodes[hash % nodes.size()];
+}
+
+Status SetCurrentThreadCpuAffinity(const CpuSet& cpus) {
+#if defined(__APPLE__)
+  return STATUS(NotSupported, "Thread CPU affinity is not supported on OSX");
+#else
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (err != 0) {
+    return STATUS(RuntimeError, "pthread_setaffinity_np failed", ErrnoToString(err), err);
+  }
+  return Status::OK();
+#endif // defined(__APPLE__)
+}
+
+Status PreferNumaNodeForMemory(void* addr, size_t length, int node) {
+  if (node == kNoNumaNode) {
+    return Status::OK();
+  }
+#if defined(__APPLE__)
+  return STATUS(NotSupported, "NUMA memory policy is not supported on OSX");
+#else
+  constexpr int kBitsPerMask = sizeof(unsigned long) * 8; // NOLINT(runtime/int)
+  if (node < 0 || node >= kBitsPerMask) {
+    return STATUS_FORMAT(InvalidArgument, "Bad NUMA node: $0", node);
+  }
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+  const uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + length) & ~(page_size - 1);
+  if (begin >= end) {
+    return Status::OK();
+  }
+  const unsigned long node_mask = 1UL << node; // NOLINT(runtime/int)
+  if (syscall(SYS_mbind, begin, end - begin, kMemoryPolicyPreferred, &node_mask,
+              kBitsPerMask, 0) != 0) {
+    return STATUS(RuntimeError, "mbind failed", ErrnoToString(errno), errno);
+  }
+  return Status::OK();
+#endif // defined(__APPLE__)
+}
+
+} // namespace yb
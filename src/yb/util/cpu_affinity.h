@@ -0,0 +1,57 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CPU_AFFINITY_H
+#define YB_UTIL_CPU_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+typedef std::vector<int> CpuSet;
+
+// Parses a CPU list in the format of the Linux sysfs, e.g. "0-3,8-11".
+Result<CpuSet> ParseCpuList(const std::string& cpu_list);
+
+struct NumaNode {
+  // Id of the node in the kernel, kNoNumaNode when the NUMA topology is not known.
+  int id;
+  CpuSet cpus;
+};
+
+constexpr int kNoNumaNode = -1;
+
+// Returns the NUMA nodes of this machine that have CPUs. When the NUMA topology is not available,
+// all the CPUs are reported as a single node with id kNoNumaNode.
+const std::vector<NumaNode>& NumaNodes();
+
+// Picks one NUMA node for the given key, the same for a given key as long as the process runs.
+// Used to keep the threads and the memory working on the same data on the same node.
+const NumaNode& NumaNodeForKey(const Slice& key);
+
+// Restricts the calling thread to run on the given CPUs.
+CHECKED_STATUS SetCurrentThreadCpuAffinity(const CpuSet& cpus);
+
+// Makes the kernel prefer the given NUMA node for the pages of the given memory range that are
+// not touched yet. Only the pages that are entirely within the range are affected. Does nothing
+// for kNoNumaNode.
+CHECKED_STATUS PreferNumaNodeForMemory(void* addr, size_t length, int node);
+
+} // namespace yb
+
+#endif // YB_UTIL_CPU_AFFINITY_H
@@ -323,6 +323,33 @@ TEST(FastVarIntTest, TestDecodeIncorrectValues) {
   }
 }
 
+TEST(FastVarIntTest, TestDecodeDescendingVarInts) {
+  std::mt19937_64 rng(654321);
+  for (int i = 0; i != 10000; ++i) {
+    int64_t values[4];
+    std::string encoded;
+    for (auto& value : values) {
+      // Values of all encoded sizes, followed by a byte that is not part of them.
+      value = static_cast<int64_t>(rng()) >> (rng() % 64);
+      FastEncodeDescendingSignedVarInt(value, &encoded);
+    }
+    encoded.push_back('\x01');
+
+    Slice slice(encoded);
+    int64_t decoded[arraysize(values)];
+    ASSERT_OK(FastDecodeDescendingSignedVarInts(&slice, decoded, arraysize(decoded)));
+    ASSERT_EQ(1, slice.size());
+    for (size_t j = 0; j != arraysize(values); ++j) {
+      ASSERT_EQ(values[j], decoded[j]);
+    }
+
+    // A truncated encoding is an error, and leaves the slice unchanged.
+    slice = Slice(encoded.data(), encoded.size() - 2);
+    ASSERT_NOK(FastDecodeDescendingSignedVarInts(&slice, decoded, arraysize(decoded)));
+    ASSERT_EQ(encoded.size() - 2, slice.size());
+  }
+}
+
 void CheckUnsignedEncoding(uint64_t value) {
   uint8_t buf[kMaxVarIntBufferSize];
   size_t size = 0;
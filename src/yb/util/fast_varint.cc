@@ -13,6 +13,8 @@
 
 #include "yb/util/fast_varint.h"
 
+#include "yb/gutil/endian.h"
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
@@ -50,6 +52,104 @@ inline Status NotEnoughEncodedBytes(int decoded_varint_size, int bytes_provided)
       decoded_varint_size, bytes_provided);
 }
 
+// Decodes any VarInt byte by byte. Used for the 9 and 10 byte encodings, that the fast path below
+// does not cover.
+Status SlowDecodeSignedVarInt(const uint8_t* src, int src_size, int64_t* v, int* decoded_size) {
+  uint8_t buf[16];
+  if (src_size == 0) {
+    return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
+  }
+
+  const uint8_t* const orig_src = src;
+
+  bool negative;
+  int n_bytes;
+  uint8_t first_byte = static_cast<uint8_t>(src[0]);
+  if (first_byte & 0x80) {
+    negative = false;
+
+    n_bytes = kVarIntSizeTable.varint_size[first_byte];
+    if (src_size < n_bytes) {
+      return NotEnoughEncodedBytes(n_bytes, src_size);
+    }
+    if (n_bytes == 1) {
+      // Fast path for single-byte decoding.
+      *v = first_byte & 0x3f;
+      *decoded_size = 1;
+      return Status::OK();
+    }
+  } else {
+    negative = true;
+    first_byte = ~first_byte;
+    n_bytes = kVarIntSizeTable.varint_size[first_byte];
+    if (src_size < n_bytes) {
+      return NotEnoughEncodedBytes(n_bytes, src_size);
+    }
+    if (n_bytes == 1) {
+      // Fast path for one byte: take 6 lower bits of the inverted byte, that will give us the
+      // decoded positive value, then negate it to get the result.
+      *v = -(first_byte & 0x3f);
+      *decoded_size = 1;
+      return Status::OK();
+    }
+
+    // We know we have at least two bytes now. Copy them to the negated buffer. We'll copy the rest
+    // later as we figure out the real encoded size (could be 9 or 10 bytes, but the value of n
+    // is min(8, encoded_size) at this point).
+    buf[0] = first_byte;
+    buf[1] = ~orig_src[1];
+    src = buf;
+  }
+
+  uint64_t result = 0;
+  int i = 0;
+  if (n_bytes == 8) {
+    if (src[1] & 0x80) {
+      if (src[1] & 0x40) {
+        n_bytes = 10;
+        result = src[1] & 0x1f;
+        i = 2;
+      } else {
+        n_bytes = 9;
+        result = src[1] & 0x3f;
+        i = 2;
+      }
+      // For encoded size of 9 and 10 we have to do the length check again, because the previously
+      // we only checked that we have at least 8 bytes.
+      if (src_size < n_bytes) {
+        return NotEnoughEncodedBytes(n_bytes, src_size);
+      }
+    } else {
+      i = 1;
+    }
+  } else {
+    result = src[0] & ((1 << (7 - n_bytes)) - 1);
+    i = 1;
+  }
+
+  if (negative) {
+    // In this case src is already pointing to the local buffer. Copy negated bytes into our local
+    // buffer so we can decode them using the same logic as for positive VarInts.
+    memcpy(buf, orig_src, n_bytes);
+    for (int i = 0; i < n_bytes; ++i) {
+      buf[i] = ~buf[i];
+    }
+  }
+
+  for (; i < n_bytes; ++i) {
+    result = (result << 8) | static_cast<uint8_t>(src[i]);
+  }
+
+  int64_t signed_result = static_cast<int64_t>(result);
+  if (negative && signed_result != std::numeric_limits<int64_t>::min()) {
+    signed_result = -signed_result;
+  }
+
+  *v = signed_result;
+  *decoded_size = n_bytes;
+  return Status::OK();
+}
+
 }  // anonymous namespace
 
 int SignedPositiveVarIntLength(uint64_t v) {
@@ -157,97 +257,44 @@ std::string FastEncodeSignedVarIntToStr(int64_t v) {
 }
 
 Status FastDecodeSignedVarInt(const uint8_t* src, int src_size, int64_t* v, int* decoded_size) {
-  uint8_t buf[16];
-  if (src_size == 0) {
+  if (src_size <= 0) {
     return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
   }
 
-  const uint8_t* const orig_src = src;
-
-  bool negative;
-  int n_bytes;
-  uint8_t first_byte = static_cast<uint8_t>(src[0]);
-  if (first_byte & 0x80) {
-    negative = false;
-
-    n_bytes = kVarIntSizeTable.varint_size[first_byte];
-    if (src_size < n_bytes) {
-      return NotEnoughEncodedBytes(n_bytes, src_size);
-    }
-    if (n_bytes == 1) {
-      // Fast path for single-byte decoding.
-      *v = first_byte & 0x3f;
-      *decoded_size = 1;
-      return Status::OK();
-    }
-  } else {
-    negative = true;
-    first_byte = ~first_byte;
-    n_bytes = kVarIntSizeTable.varint_size[first_byte];
-    if (src_size < n_bytes) {
-      return NotEnoughEncodedBytes(n_bytes, src_size);
-    }
-    if (n_bytes == 1) {
-      // Fast path for one byte: take 6 lower bits of the inverted byte, that will give us the
-      // decoded positive value, then negate it to get the result.
-      *v = -(first_byte & 0x3f);
-      *decoded_size = 1;
-      return Status::OK();
-    }
-
-    // We know we have at least two bytes now. Copy them to the negated buffer. We'll copy the rest
-    // later as we figure out the real encoded size (could be 9 or 10 bytes, but the value of n
-    // is min(8, encoded_size) at this point).
-    buf[0] = first_byte;
-    buf[1] = ~orig_src[1];
-    src = buf;
-  }
-
-  uint64_t result = 0;
-  int i = 0;
-  if (n_bytes == 8) {
-    if (src[1] & 0x80) {
-      if (src[1] & 0x40) {
-        n_bytes = 10;
-        result = src[1] & 0x1f;
-        i = 2;
-      } else {
-        n_bytes = 9;
-        result = src[1] & 0x3f;
-        i = 2;
-      }
-      // For encoded size of 9 and 10 we have to do the length check again, because the previously
-      // we only checked that we have at least 8 bytes.
-      if (src_size < n_bytes) {
-        return NotEnoughEncodedBytes(n_bytes, src_size);
-      }
-    } else {
-      i = 1;
-    }
-  } else {
-    result = src[0] & ((1 << (7 - n_bytes)) - 1);
-    i = 1;
+  // All bits of a negative VarInt are complemented, xor with the sign mask undoes that.
+  const uint8_t sign_mask = (src[0] & 0x80) ? 0 : 0xff;
+  const uint8_t first_byte = src[0] ^ sign_mask;
+  // Now the highest bit is set, and the number of leading ones is the encoded size, up to 8.
+  const int n_bytes = __builtin_clz(~(static_cast<uint32_t>(first_byte) << 24));
+  if (src_size < n_bytes) {
+    return NotEnoughEncodedBytes(n_bytes, src_size);
   }
-
-  if (negative) {
-    // In this case src is already pointing to the local buffer. Copy negated bytes into our local
-    // buffer so we can decode them using the same logic as for positive VarInts.
-    memcpy(buf, orig_src, n_bytes);
-    for (int i = 0; i < n_bytes; ++i) {
-      buf[i] = ~buf[i];
-    }
+  if (n_bytes == 1) {
+    // Fast path for single-byte decoding.
+    const int64_t result = first_byte & 0x3f;
+    *v = sign_mask ? -result : result;
+    *decoded_size = 1;
+    return Status::OK();
   }
-
-  for (; i < n_bytes; ++i) {
-    result = (result << 8) | static_cast<uint8_t>(src[i]);
+  if (n_bytes == 8 && ((src[1] ^ sign_mask) & 0x80)) {
+    return SlowDecodeSignedVarInt(src, src_size, v, decoded_size);
   }
 
-  int64_t signed_result = static_cast<int64_t>(result);
-  if (negative && signed_result != std::numeric_limits<int64_t>::min()) {
-    signed_result = -signed_result;
+  // An encoding of n bytes is a big endian number, with the sign and size in its highest n + 1
+  // bits and the magnitude in the remaining 7 * n - 1 bits. Load it with a single unaligned read.
+  uint64_t word;
+  if (src_size >= 8) {
+    word = BigEndian::Load64(src);
+  } else {
+    uint8_t buf[8] = {0};
+    memcpy(buf, src, src_size);
+    word = BigEndian::Load64(buf);
   }
+  word ^= sign_mask * 0x0101010101010101ULL;
+  const uint64_t result =
+      (word >> (64 - 8 * n_bytes)) & ((static_cast<uint64_t>(1) << (7 * n_bytes - 1)) - 1);
 
-  *v = signed_result;
+  *v = sign_mask ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
   *decoded_size = n_bytes;
   return Status::OK();
 }
@@ -264,6 +311,20 @@ Status FastDecodeDescendingSignedVarInt(yb::Slice *slice, int64_t *dest) {
   return Status::OK();
 }
 
+Status FastDecodeDescendingSignedVarInts(yb::Slice *slice, int64_t *dest, size_t count) {
+  const uint8_t* src = slice->data();
+  int src_size = slice->size();
+  for (size_t i = 0; i != count; ++i) {
+    int decoded_size = 0;
+    RETURN_NOT_OK(FastDecodeSignedVarInt(src, src_size, dest + i, &decoded_size));
+    dest[i] = -dest[i];
+    src += decoded_size;
+    src_size -= decoded_size;
+  }
+  slice->remove_prefix(src - slice->data());
+  return Status::OK();
+}
+
 size_t UnsignedVarIntLength(uint64_t v) {
   size_t result = 1;
   v >>= 7;
@@ -62,6 +62,10 @@ inline void FastEncodeDescendingSignedVarInt(int64_t v, std::string *dest) {
 // Decode a "descending VarInt" encoded by FastEncodeDescendingVarInt.
 CHECKED_STATUS FastDecodeDescendingSignedVarInt(yb::Slice *slice, int64_t *dest);
 
+// Decodes count consecutive "descending VarInts" into dest, e.g. the components of an encoded
+// DocHybridTime, and removes them from the slice. The slice is not changed in case of an error.
+CHECKED_STATUS FastDecodeDescendingSignedVarInts(yb::Slice *slice, int64_t *dest, size_t count);
+
 size_t UnsignedVarIntLength(uint64_t v);
 void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size);
 CHECKED_STATUS FastDecodeUnsignedVarInt(
@@ -38,6 +38,7 @@
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/bits.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/status.h"
 
 using base::subtle::Atomic64;
@@ -192,6 +193,32 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   }
 }
 
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  DCHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  DCHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  // Same order as in the copy constructor, so the total count matches the merged counts.
+  NoBarrier_AtomicIncrement(&total_sum_, NoBarrier_Load(&other.total_sum_));
+  const Atomic64 other_min = NoBarrier_Load(&other.min_value_);
+  if (other_min < NoBarrier_Load(&min_value_)) {
+    NoBarrier_Store(&min_value_, other_min);
+  }
+
+  uint64_t total_merged_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count != 0) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      total_merged_count += count;
+    }
+  }
+  const Atomic64 other_max = NoBarrier_Load(&other.max_value_);
+  if (other_max > NoBarrier_Load(&max_value_)) {
+    NoBarrier_Store(&max_value_, other_max);
+  }
+  NoBarrier_AtomicIncrement(&total_count_, total_merged_count);
+}
+
 void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
                                                  int64_t expected_interval_between_samples) {
   Increment(value);
@@ -328,6 +355,72 @@ uint64_t HdrHistogram::ValueAtPercentile(double percentile) const {
   return 0;
 }
 
+///////////////////////////////////////////////////////////////////////
+// StripedHdrHistogram
+///////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Returns the index of the calling thread, assigned round robin so that threads are spread evenly
+// over the stripes.
+size_t ThreadIndex() {
+  static std::atomic<size_t> next_thread_index{0};
+  static thread_local size_t thread_index = next_thread_index.fetch_add(
+      1, std::memory_order_relaxed);
+  return thread_index;
+}
+
+} // namespace
+
+StripedHdrHistogram::StripedHdrHistogram(uint64_t highest_trackable_value,
+                                         int num_significant_digits)
+    : highest_trackable_value_(highest_trackable_value),
+      num_significant_digits_(num_significant_digits),
+      num_stripes_(1) {
+  while (num_stripes_ < static_cast<size_t>(base::NumCPUs())) {
+    num_stripes_ <<= 1;
+  }
+  stripes_.reset(new std::atomic<HdrHistogram*>[num_stripes_]);
+  stripes_[0].store(new HdrHistogram(highest_trackable_value_, num_significant_digits_),
+                    std::memory_order_relaxed);
+  for (size_t i = 1; i != num_stripes_; ++i) {
+    stripes_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+StripedHdrHistogram::~StripedHdrHistogram() {
+  for (size_t i = 0; i != num_stripes_; ++i) {
+    delete stripes_[i].load(std::memory_order_relaxed);
+  }
+}
+
+HdrHistogram* StripedHdrHistogram::Stripe() {
+  auto& stripe = stripes_[ThreadIndex() & (num_stripes_ - 1)];
+  HdrHistogram* result = stripe.load(std::memory_order_acquire);
+  if (PREDICT_TRUE(result != nullptr)) {
+    return result;
+  }
+  std::unique_ptr<HdrHistogram> created(
+      new HdrHistogram(highest_trackable_value_, num_significant_digits_));
+  if (stripe.compare_exchange_strong(result, created.get(), std::memory_order_acq_rel)) {
+    result = created.release();
+  }
+  return result;
+}
+
+void StripedHdrHistogram::IncrementBy(int64_t value, int64_t count) {
+  Stripe()->IncrementBy(value, count);
+}
+
+void StripedHdrHistogram::MergeTo(HdrHistogram* out) const {
+  for (size_t i = 0; i != num_stripes_; ++i) {
+    const HdrHistogram* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      out->MergeFrom(*stripe);
+    }
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////
 // AbstractHistogramIterator
 ///////////////////////////////////////////////////////////////////////
@@ -58,6 +58,9 @@
 
 #include <stdint.h>
 
+#include <atomic>
+#include <memory>
+
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/util/status.h"
@@ -97,6 +100,11 @@ class HdrHistogram {
   void Increment(int64_t value);
   void IncrementBy(int64_t value, int64_t count);
 
+  // Add the values recorded in other, which must have the same highest trackable value and
+  // number of significant digits, to this histogram. Like copying, this is not a consistent
+  // snapshot of other when it is being updated concurrently.
+  void MergeFrom(const HdrHistogram& other);
+
   // Record new data, correcting for "coordinated omission".
   //
   // See https://groups.google.com/d/msg/mechanical-sympathy/icNZJejUHfE/BfDekfBEs_sJ
@@ -207,6 +215,45 @@ class HdrHistogram {
   HdrHistogram& operator=(const HdrHistogram& other); // Disable assignment operator.
 };
 
+// Records values into one of several HdrHistograms picked by the calling thread, so that threads
+// recording concurrently mostly update different counters instead of bouncing the cache lines of
+// shared ones. This is similar to what LongAdder does for a single counter.
+//
+// There is a stripe per CPU, but only the first one is allocated upfront, the others are
+// allocated when a thread first records into them. So a histogram that is rarely updated
+// concurrently costs about as much memory as an HdrHistogram.
+//
+// Reading requires merging all the stripes with MergeTo, so it is meant for values that are
+// recorded much more often than they are read, like per RPC latencies.
+class StripedHdrHistogram {
+ public:
+  StripedHdrHistogram(uint64_t highest_trackable_value, int num_significant_digits);
+  ~StripedHdrHistogram();
+
+  // Record new data.
+  void Increment(int64_t value) { IncrementBy(value, 1); }
+  void IncrementBy(int64_t value, int64_t count);
+
+  // Add the values recorded in all stripes to out, which must have the same highest trackable
+  // value and number of significant digits.
+  void MergeTo(HdrHistogram* out) const;
+
+  uint64_t highest_trackable_value() const { return highest_trackable_value_; }
+  int num_significant_digits() const { return num_significant_digits_; }
+
+ private:
+  HdrHistogram* Stripe();
+
+  const uint64_t highest_trackable_value_;
+  const int num_significant_digits_;
+
+  // Power of 2, so that the stripe of a thread can be picked with a mask.
+  size_t num_stripes_;
+  std::unique_ptr<std::atomic<HdrHistogram*>[]> stripes_;
+
+  DISALLOW_COPY_AND_ASSIGN(StripedHdrHistogram);
+};
+
 // Value returned from iterators.
 struct HistogramIterationValue {
   HistogramIterationValue()
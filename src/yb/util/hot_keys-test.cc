@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/hot_keys.h"
+#include "yb/util/random.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class HotKeySketchTest : public YBTest {
+};
+
+TEST_F(HotKeySketchTest, TestSkewedWorkload) {
+  HotKeySketch sketch(3);
+  Random rng(SeedRandom());
+  // Two hot keys among many cold ones.
+  for (int i = 0; i != 100000; ++i) {
+    const uint32_t choice = rng.Uniform(10);
+    std::string key;
+    if (choice < 3) {
+      key = "hot";
+    } else if (choice < 5) {
+      key = "warm";
+    } else {
+      key = "cold-" + std::to_string(rng.Uniform(10000));
+    }
+    sketch.Add(key);
+  }
+
+  auto top_keys = sketch.TopKeys();
+  ASSERT_EQ(3U, top_keys.size());
+  ASSERT_EQ("hot", top_keys[0].key);
+  ASSERT_EQ("warm", top_keys[1].key);
+  // Estimates are never below the real counts, and those are about 30000 and 20000.
+  ASSERT_GT(top_keys[0].count, 25000U);
+  ASSERT_GT(top_keys[1].count, 15000U);
+  ASSERT_LT(top_keys[2].count, top_keys[1].count);
+  ASSERT_EQ(top_keys[0].count, sketch.MaxCount());
+  ASSERT_EQ(100000U, sketch.TotalCount());
+}
+
+TEST_F(HotKeySketchTest, TestDecay) {
+  HotKeySketch sketch;
+  sketch.Add("a", 100);
+  sketch.Add("b", 1);
+  ASSERT_EQ(100U, sketch.MaxCount());
+
+  sketch.Decay();
+  auto top_keys = sketch.TopKeys();
+  // "b" was halved down to 0 and dropped.
+  ASSERT_EQ(1U, top_keys.size());
+  ASSERT_EQ("a", top_keys[0].key);
+  ASSERT_EQ(50U, top_keys[0].count);
+  ASSERT_EQ(50U, sketch.TotalCount());
+
+  // A new key can take the place of the decayed ones.
+  sketch.Add("c", 200);
+  top_keys = sketch.TopKeys();
+  ASSERT_EQ(2U, top_keys.size());
+  ASSERT_EQ("c", top_keys[0].key);
+  ASSERT_EQ(200U, top_keys[0].count);
+}
+
+} // namespace yb
@@ -0,0 +1,130 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/hot_keys.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "yb/util/hash_util.h"
+
+namespace yb {
+
+constexpr size_t HotKeySketch::kDefaultTopK;
+constexpr size_t HotKeySketch::kDepth;
+constexpr size_t HotKeySketch::kWidth;
+
+HotKeySketch::HotKeySketch(size_t top_k)
+    : top_k_(top_k), counters_(new std::atomic<uint32_t>[kDepth * kWidth]) {
+  for (size_t i = 0; i != kDepth * kWidth; ++i) {
+    counters_[i].store(0, std::memory_order_relaxed);
+  }
+  top_.reserve(top_k_);
+}
+
+HotKeySketch::~HotKeySketch() {
+}
+
+void HotKeySketch::Add(const Slice& key, uint64_t weight) {
+  const uint64_t hash = HashUtil::MurmurHash2_64(key.data(), static_cast<int>(key.size()), 0);
+  // Derive the row hashes from two halves of one hash, see Kirsch and Mitzenmacher, "Less
+  // Hashing, Same Performance: Building a Better Bloom Filter".
+  const uint32_t hash1 = static_cast<uint32_t>(hash);
+  const uint32_t hash2 = static_cast<uint32_t>(hash >> 32) | 1;
+  const uint32_t increment = static_cast<uint32_t>(
+      std::min<uint64_t>(weight, std::numeric_limits<uint32_t>::max()));
+  uint64_t estimate = std::numeric_limits<uint64_t>::max();
+  for (size_t row = 0; row != kDepth; ++row) {
+    auto& counter = counters_[row * kWidth + (hash1 + row * hash2) % kWidth];
+    const uint64_t value = counter.fetch_add(increment, std::memory_order_relaxed) + increment;
+    estimate = std::min(estimate, value);
+  }
+  total_count_.fetch_add(weight, std::memory_order_relaxed);
+
+  if (estimate < min_top_count_.load(std::memory_order_relaxed) || top_k_ == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(top_.begin(), top_.end(), [hash, &key](const Entry& entry) {
+    return entry.hash == hash && Slice(entry.key) == key;
+  });
+  if (it != top_.end()) {
+    it->count = std::max(it->count, estimate);
+  } else if (top_.size() < top_k_) {
+    top_.push_back(Entry{key.ToBuffer(), hash, estimate});
+  } else {
+    auto coldest = std::min_element(top_.begin(), top_.end(), [](const Entry& lhs,
+                                                                  const Entry& rhs) {
+      return lhs.count < rhs.count;
+    });
+    if (coldest->count >= estimate) {
+      return;
+    }
+    *coldest = Entry{key.ToBuffer(), hash, estimate};
+  }
+
+  uint64_t min_top_count = 0;
+  if (top_.size() == top_k_) {
+    min_top_count = std::numeric_limits<uint64_t>::max();
+    for (const auto& entry : top_) {
+      min_top_count = std::min(min_top_count, entry.count);
+    }
+  }
+  min_top_count_.store(min_top_count, std::memory_order_relaxed);
+}
+
+std::vector<HotKeySketch::HotKey> HotKeySketch::TopKeys() const {
+  std::vector<HotKey> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(top_.size());
+    for (const auto& entry : top_) {
+      result.push_back(HotKey{entry.key, entry.count});
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const HotKey& lhs, const HotKey& rhs) {
+    return lhs.count > rhs.count;
+  });
+  return result;
+}
+
+uint64_t HotKeySketch::MaxCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t result = 0;
+  for (const auto& entry : top_) {
+    result = std::max(result, entry.count);
+  }
+  return result;
+}
+
+void HotKeySketch::Decay() {
+  for (size_t i = 0; i != kDepth * kWidth; ++i) {
+    counters_[i].store(counters_[i].load(std::memory_order_relaxed) >> 1,
+                       std::memory_order_relaxed);
+  }
+  total_count_.store(total_count_.load(std::memory_order_relaxed) >> 1,
+                     std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : top_) {
+    entry.count >>= 1;
+  }
+  top_.erase(std::remove_if(top_.begin(), top_.end(), [](const Entry& entry) {
+    return entry.count == 0;
+  }), top_.end());
+  // Let any key in again until the list is refilled, their estimates were halved as well.
+  min_top_count_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace yb
@@ -0,0 +1,93 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_HOT_KEYS_H
+#define YB_UTIL_HOT_KEYS_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Finds the most frequently accessed keys with a fixed amount of memory.
+//
+// Access counts are estimated with a Count-Min sketch: each key increments one counter in each of
+// a few rows, picked by independent hashes of the key, and its estimate is the smallest of those
+// counters. Estimates are never lower than the real counts, and are only off by much for keys
+// that are rare compared to the total. The keys with the highest estimates are kept in a small
+// top-K list along with a copy of their bytes.
+//
+// Counts are halved by Decay(), so that the sketch follows the recent workload.
+//
+// Thread safe. Updating the counters is lock free, the top-K list is only locked when a key is
+// hot enough to enter or move within it.
+class HotKeySketch {
+ public:
+  struct HotKey {
+    std::string key;
+    uint64_t count;
+  };
+
+  explicit HotKeySketch(size_t top_k = kDefaultTopK);
+  ~HotKeySketch();
+
+  // Records 'weight' accesses to 'key'.
+  void Add(const Slice& key, uint64_t weight = 1);
+
+  // Returns the hottest keys, hottest first.
+  std::vector<HotKey> TopKeys() const;
+
+  // Returns the estimated count of the hottest key.
+  uint64_t MaxCount() const;
+
+  // Returns the total number of accesses recorded.
+  uint64_t TotalCount() const { return total_count_.load(std::memory_order_relaxed); }
+
+  // Halves all counts. Concurrent updates may be halved or not.
+  void Decay();
+
+  static constexpr size_t kDefaultTopK = 10;
+
+ private:
+  static constexpr size_t kDepth = 4;
+  static constexpr size_t kWidth = 512;
+
+  struct Entry {
+    std::string key;
+    uint64_t hash;
+    uint64_t count;
+  };
+
+  const size_t top_k_;
+  std::unique_ptr<std::atomic<uint32_t>[]> counters_;
+  std::atomic<uint64_t> total_count_{0};
+
+  // Estimate a key needs to enter the top-K list, 0 while the list is not full.
+  std::atomic<uint64_t> min_top_count_{0};
+  mutable std::mutex mutex_;
+  std::vector<Entry> top_;
+
+  DISALLOW_COPY_AND_ASSIGN(HotKeySketch);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_HOT_KEYS_H
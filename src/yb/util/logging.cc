@@ -46,6 +46,7 @@
 #include <signal.h>
 #include <stdio.h>
 
+#include <atomic>
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -59,6 +60,7 @@
 #include "yb/gutil/callback.h"
 #include "yb/gutil/spinlock.h"
 
+#include "yb/util/async_logger.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 
@@ -67,6 +69,16 @@ DEFINE_string(log_filename, "",
     "full path is <log_dir>/<log_filename>.[INFO|WARN|ERROR|FATAL]");
 TAG_FLAG(log_filename, stable);
 
+DEFINE_bool(log_async, true,
+    "Write the INFO and WARNING log files from a dedicated thread, so that the threads that log "
+    "do not wait for the disk. Messages are dropped, and the drops reported in the log, when "
+    "the writer falls behind by more than --log_async_buffer_bytes_per_level.");
+TAG_FLAG(log_async, advanced);
+
+DEFINE_int32(log_async_buffer_bytes_per_level, 2 * 1024 * 1024,
+    "Maximum size of the log messages buffered for each asynchronously written log file.");
+TAG_FLAG(log_async_buffer_bytes_per_level, advanced);
+
 const char* kProjName = "yb";
 
 bool logging_initialized = false;
@@ -142,7 +154,54 @@ void UnregisterLoggingCallbackUnlocked() {
   registered_sink = nullptr;
 }
 
+// The loggers of the severities that are written asynchronously, installed with
+// google::base::SetLogger(). Read without 'logging_mutex' by the failure function.
+std::atomic<AsyncLogger*> async_loggers[google::NUM_SEVERITIES];
+
+void EnableAsyncLoggingUnlocked() {
+  CHECK(logging_mutex.IsHeld());
+  // ERROR and FATAL messages are rare and stay synchronous, so that they are not lost on a crash.
+  for (int severity : {google::INFO, google::WARNING}) {
+    auto* logger = new AsyncLogger(
+        google::base::GetLogger(severity), FLAGS_log_async_buffer_bytes_per_level);
+    logger->Start();
+    google::base::SetLogger(severity, logger);
+    async_loggers[severity].store(logger, std::memory_order_release);
+  }
+}
+
+void DisableAsyncLoggingUnlocked() {
+  CHECK(logging_mutex.IsHeld());
+  for (auto& entry : async_loggers) {
+    auto* logger = entry.exchange(nullptr, std::memory_order_acq_rel);
+    if (logger == nullptr) {
+      continue;
+    }
+    logger->Stop();
+    // glog writes to the loggers under its own lock, so nothing uses the logger once it is
+    // replaced.
+    for (int severity = google::INFO; severity < google::NUM_SEVERITIES; ++severity) {
+      if (google::base::GetLogger(severity) == logger) {
+        google::base::SetLogger(severity, logger->wrapped());
+      }
+    }
+    delete logger;
+  }
+}
+
+void FlushAsyncLoggers() {
+  for (auto& entry : async_loggers) {
+    auto* logger = entry.load(std::memory_order_acquire);
+    if (logger != nullptr) {
+      logger->Flush();
+    }
+  }
+}
+
 void DumpStackTraceAndExit() {
+  // Write the buffered messages, including the fatal one logged to the INFO and WARNING files.
+  FlushAsyncLoggers();
+
   const auto stack_trace = GetStackTrace();
   if (write(STDERR_FILENO, stack_trace.c_str(), stack_trace.length()) < 0) {
     // Ignore errors.
@@ -206,6 +265,10 @@ void InitGoogleLoggingSafe(const char* arg) {
 
   google::InstallFailureFunction(DumpStackTraceAndExit);
 
+  if (FLAGS_log_async && !FLAGS_logtostderr) {
+    EnableAsyncLoggingUnlocked();
+  }
+
   // Needs to be done after InitGoogleLogging
   if (FLAGS_log_filename.empty()) {
     CHECK_STRNE(google::ProgramInvocationShortName(), "UNKNOWN")
@@ -297,6 +360,8 @@ void ShutdownLoggingSafe() {
     UnregisterLoggingCallbackUnlocked();
   }
 
+  DisableAsyncLoggingUnlocked();
+
   google::ShutdownGoogleLogging();
 
   logging_initialized = false;
@@ -72,6 +72,17 @@
       __FILE__, __LINE__, google::GLOG_ ## severity, num_suppressed, \
       &google::LogMessage::SendToLog).stream()
 
+// Same as YB_LOG_EVERY_N_SECS(INFO, n_secs), for verbose logging at the given level. The verbose
+// level is checked first, so that call sites in hot paths cost nothing more than a VLOG while the
+// level is off.
+#define YB_VLOG_EVERY_N_SECS(verboselevel, n_secs) \
+  static logging_internal::LogThrottler VLOG_THROTTLER;  \
+  int vlog_num_suppressed = 0; \
+  if (VLOG_IS_ON(verboselevel) && VLOG_THROTTLER.ShouldLog(n_secs, &vlog_num_suppressed)) \
+    google::LogMessage( \
+      __FILE__, __LINE__, google::GLOG_INFO, vlog_num_suppressed, \
+      &google::LogMessage::SendToLog).stream()
+
 namespace yb {
 enum PRIVATE_ThrottleMsg {THROTTLE_MSG};
 } // namespace yb
@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -43,6 +44,7 @@
 #include "yb/util/test_util.h"
 
 DECLARE_int32(memory_limit_soft_percentage);
+DECLARE_int64(mem_tracker_update_batch_bytes);
 
 namespace yb {
 
@@ -260,6 +262,67 @@ TEST(MemTrackerTest, ScopedTrackedConsumption) {
   ASSERT_EQ(0, m->consumption());
 }
 
+TEST(MemTrackerTest, BatchedUpdates) {
+  google::FlagSaver saver;
+  FLAGS_mem_tracker_update_batch_bytes = 100;
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker(-1, "p");
+  shared_ptr<MemTracker> c = MemTracker::CreateTracker(150, "c", p);
+
+  // Small changes are buffered until they add up to the batch size.
+  c->Consume(60);
+  EXPECT_EQ(0, c->consumption());
+  EXPECT_EQ(0, p->consumption());
+  c->Consume(60);
+  EXPECT_EQ(120, c->consumption());
+  EXPECT_EQ(120, p->consumption());
+
+  // Large changes are applied right away.
+  c->Consume(200);
+  EXPECT_EQ(320, p->consumption());
+  c->Release(200);
+  c->Release(50);
+  EXPECT_EQ(120, p->consumption());
+  c->FlushPendingConsumption();
+  EXPECT_EQ(70, c->consumption());
+  EXPECT_EQ(70, p->consumption());
+
+  // TryConsume() checks the limit against the buffered consumption.
+  c->Consume(50);
+  EXPECT_FALSE(c->TryConsume(40));
+  EXPECT_EQ(120, c->consumption());
+  EXPECT_TRUE(c->TryConsume(30));
+  EXPECT_EQ(150, c->consumption());
+
+  // Threads buffer their changes separately, nothing is lost when they are applied.
+  constexpr int kNumThreads = 8;
+  constexpr int kNumUpdates = 10000;
+  vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([c, i] {
+      for (int j = 0; j != kNumUpdates; ++j) {
+        c->Consume(i + 1);
+        if (j % 2) {
+          c->Release(i + 1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  c->FlushPendingConsumption();
+  int64_t expected = 150;
+  for (int i = 0; i != kNumThreads; ++i) {
+    expected += (i + 1) * kNumUpdates / 2;
+  }
+  EXPECT_EQ(expected, c->consumption());
+  EXPECT_EQ(expected, p->consumption());
+
+  c->Release(expected);
+  c->FlushPendingConsumption();
+  EXPECT_EQ(0, p->consumption());
+}
+
 TEST(MemTrackerTest, SoftLimitExceeded) {
   const int kNumIters = 100000;
   const int kMemLimit = 1000;
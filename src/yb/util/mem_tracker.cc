@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -46,6 +47,7 @@
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env.h"
@@ -86,6 +88,15 @@ DEFINE_int32(tcmalloc_max_free_bytes_percentage, 10,
 TAG_FLAG(tcmalloc_max_free_bytes_percentage, advanced);
 #endif
 
+DEFINE_int64(mem_tracker_update_batch_bytes, 0,
+             "Consumption changes smaller than this number of bytes are accumulated per thread "
+             "and applied to the memory tracker hierarchy once the accumulated change reaches it, "
+             "so that frequent small updates don't contend on the shared ancestor trackers. "
+             "Trackers lag behind their actual consumption by at most this number of bytes per "
+             "CPU for each of their descendants. 0 applies every change right away. Only "
+             "affects trackers created after it is set.");
+TAG_FLAG(mem_tracker_update_batch_bytes, advanced);
+
 DEFINE_bool(mem_tracker_logging, false,
             "Enable logging of memory tracker consume/release operations");
 
@@ -115,6 +126,15 @@ static GoogleOnceType root_tracker_once = GOOGLE_ONCE_INIT;
 // is greater than GC_RELEASE_SIZE, this will trigger a tcmalloc gc.
 static Atomic64 released_memory_since_gc;
 
+// Returns the index of the calling thread, assigned round robin so that threads are spread evenly
+// over the pending consumption cells of trackers.
+static size_t ThreadIndex() {
+  static std::atomic<size_t> next_thread_index{0};
+  static thread_local size_t thread_index = next_thread_index.fetch_add(
+      1, std::memory_order_relaxed);
+  return thread_index;
+}
+
 // Validate that various flags are percentages.
 static bool ValidatePercentage(const char* flagname, int value) {
   if (value >= 0 && value <= 100) {
@@ -187,6 +207,7 @@ MemTracker::MemTracker(ConsumptionFunction consumption_func, int64_t byte_limit,
       parent_(std::move(parent)),
       consumption_(0),
       consumption_func_(std::move(consumption_func)),
+      update_batch_bytes_(std::max<int64_t>(FLAGS_mem_tracker_update_batch_bytes, 0)),
       rand_(GetRandomSeed32()),
       enable_logging_(FLAGS_mem_tracker_logging),
       log_stack_(FLAGS_mem_tracker_log_stack_trace) {
@@ -196,10 +217,28 @@ MemTracker::MemTracker(ConsumptionFunction consumption_func, int64_t byte_limit,
   }
   soft_limit_ = (limit_ == -1)
       ? -1 : (limit_ * FLAGS_memory_limit_soft_percentage) / 100;
+  // The consumption of trackers with a consumption function is not updated by Consume().
+  if (update_batch_bytes_ > 0 && !consumption_func_) {
+    num_pending_ = 1;
+    while (num_pending_ < static_cast<size_t>(base::NumCPUs())) {
+      num_pending_ <<= 1;
+    }
+    void* buffer = nullptr;
+    int err = posix_memalign(&buffer, CACHELINE_SIZE, sizeof(PendingConsumption) * num_pending_);
+    CHECK_EQ(0, err) << "error calling posix_memalign";
+    pending_ = static_cast<PendingConsumption*>(buffer);
+    for (size_t i = 0; i != num_pending_; ++i) {
+      new (&pending_[i].bytes) std::atomic<int64_t>(0);
+    }
+  }
 }
 
 MemTracker::~MemTracker() {
   VLOG(1) << "Destroying tracker " << ToString();
+  if (pending_) {
+    FlushPendingConsumption();
+    free(pending_);
+  }
   if (parent_) {
     DCHECK(consumption() == 0) << "Memory tracker " << ToString()
         << " has unreleased consumption " << consumption();
@@ -311,14 +350,51 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  if (pending_ && BufferConsumption(&bytes)) {
+    return;
+  }
+  UpdateAllTrackers(bytes);
+}
+
+void MemTracker::UpdateAllTrackers(int64_t bytes) {
   for (auto& tracker : all_trackers_) {
     tracker->consumption_.IncrementBy(bytes);
+    // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
+    // reported amount, the subsequent call to FunctionContext::Free() may cause the
+    // process mem tracker to go negative until it is synced back to the tcmalloc
+    // metric. Don't blow up in this case. (Note that this doesn't affect non-process
+    // trackers since we can enforce that the reported memory usage is internally
+    // consistent.)
     if (tracker->consumption_func_) {
       DCHECK_GE(tracker->consumption_.current_value(), 0);
     }
   }
 }
 
+bool MemTracker::BufferConsumption(int64_t* bytes) {
+  if (std::abs(*bytes) >= update_batch_bytes_) {
+    return false;
+  }
+  auto& cell_bytes = pending_[ThreadIndex() & (num_pending_ - 1)].bytes;
+  const int64_t pending = cell_bytes.fetch_add(*bytes, std::memory_order_relaxed) + *bytes;
+  if (std::abs(pending) < update_batch_bytes_) {
+    return true;
+  }
+  // Other threads sharing the cell may have changed it since, take whatever is there.
+  *bytes = cell_bytes.exchange(0, std::memory_order_relaxed);
+  return *bytes == 0;
+}
+
+void MemTracker::FlushPendingConsumption() {
+  int64_t bytes = 0;
+  for (size_t i = 0; i != num_pending_; ++i) {
+    bytes += pending_[i].bytes.exchange(0, std::memory_order_relaxed);
+  }
+  if (bytes != 0) {
+    UpdateAllTrackers(bytes);
+  }
+}
+
 bool MemTracker::TryConsume(int64_t bytes) {
   if (consumption_func_) {
     UpdateConsumption();
@@ -329,6 +405,10 @@ bool MemTracker::TryConsume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  // Check the limits against the consumption buffered on this tracker as well.
+  if (pending_ && !limit_trackers_.empty()) {
+    FlushPendingConsumption();
+  }
 
   int i = 0;
   // Walk the tracker tree top-down, to avoid expanding a limit on a child whose parent
@@ -396,18 +476,11 @@ void MemTracker::Release(int64_t bytes) {
     LogUpdate(false, bytes);
   }
 
-  for (auto& tracker : all_trackers_) {
-    tracker->consumption_.IncrementBy(-bytes);
-    // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
-    // reported amount, the subsequent call to FunctionContext::Free() may cause the
-    // process mem tracker to go negative until it is synced back to the tcmalloc
-    // metric. Don't blow up in this case. (Note that this doesn't affect non-process
-    // trackers since we can enforce that the reported memory usage is internally
-    // consistent.)
-    if (tracker->consumption_func_) {
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
-    }
+  int64_t delta = -bytes;
+  if (pending_ && BufferConsumption(&delta)) {
+    return;
   }
+  UpdateAllTrackers(delta);
 }
 
 bool MemTracker::AnyLimitExceeded() {
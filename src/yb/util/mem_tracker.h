@@ -34,12 +34,14 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "yb/gutil/port.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/high_water_mark.h"
 #include "yb/util/locks.h"
@@ -211,6 +213,10 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Decreases consumption of this tracker and its ancestors by 'bytes'.
   void Release(int64_t bytes);
 
+  // Applies the consumption buffered by Consume() and Release() of this tracker, see
+  // --mem_tracker_update_batch_bytes, to this tracker and its ancestors.
+  void FlushPendingConsumption();
+
   // Returns true if a valid limit of this tracker or one of its ancestors is
   // exceeded.
   bool AnyLimitExceeded();
@@ -244,7 +250,9 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   bool has_limit() const { return limit_ >= 0; }
   const std::string& id() const { return id_; }
 
-  // Returns the memory consumed in bytes.
+  // Returns the memory consumed in bytes. Does not include the consumption buffered by
+  // Consume() and Release() of this tracker and its descendants, which is at most
+  // --mem_tracker_update_batch_bytes per CPU for each of them.
   int64_t consumption() const {
     return consumption_.current_value();
   }
@@ -295,6 +303,13 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
     return limit_ >= 0 && limit_ < consumption();
   }
 
+  // Adds 'bytes' to the consumption of this tracker and its ancestors.
+  void UpdateAllTrackers(int64_t bytes);
+
+  // Adds 'bytes' to the buffered consumption of the calling thread. Returns false and sets 'bytes'
+  // to the consumption to apply when it should be applied to the trackers rather than buffered.
+  bool BufferConsumption(int64_t* bytes);
+
   // If consumption is higher than max_consumption, attempts to free memory by calling any
   // added GC functions.  Returns true if max_consumption is still exceeded. Takes
   // gc_lock. Updates metrics if initialized.
@@ -358,6 +373,20 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   ConsumptionFunction consumption_func_;
 
+  // Consumption buffered by the threads hashing to the same cell, padded to avoid false sharing.
+  struct PendingConsumption {
+    std::atomic<int64_t> bytes;
+    char pad[CACHELINE_SIZE > sizeof(std::atomic<int64_t>) ?
+             CACHELINE_SIZE - sizeof(std::atomic<int64_t>) : 1];
+  } CACHELINE_ALIGNED;
+
+  // Deltas smaller than this are buffered, 0 if consumption is not buffered.
+  const int64_t update_batch_bytes_;
+  // Cache-aligned array of num_pending_ cells, a power of two, nullptr if consumption is not
+  // buffered.
+  PendingConsumption* pending_ = nullptr;
+  size_t num_pending_ = 0;
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
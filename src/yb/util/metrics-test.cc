@@ -34,12 +34,15 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
 #include "yb/gutil/bind.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/util/hdr_histogram.h"
+#include "yb/util/histogram.pb.h"
 #include "yb/util/jsonreader.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/metrics.h"
@@ -181,6 +184,33 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   // TODO: Test coverage needs to be improved a lot.
 }
 
+METRIC_DEFINE_striped_histogram(test_entity, test_striped_hist, "Test Striped Histogram",
+                                MetricUnit::kMilliseconds, "foo", 1000000, 3);
+
+TEST_F(MetricsTest, StripedHistogramTest) {
+  scoped_refptr<Histogram> hist = METRIC_test_striped_hist.Instantiate(entity_);
+  ASSERT_EQ(nullptr, hist->histogram_.get());
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; ++i) {
+    threads.emplace_back([hist, i] {
+      hist->Increment(2 + i);
+      hist->IncrementBy(10, 2);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(2, hist->MinValueForTests());
+  ASSERT_EQ(10, hist->MaxValueForTests());
+  ASSERT_EQ(12, hist->TotalCount());
+  ASSERT_EQ(8, hist->CountInBucketForValueForTests(10));
+
+  HistogramSnapshotPB snapshot;
+  ASSERT_OK(hist->GetHistogramSnapshotPB(&snapshot, MetricJsonOptions()));
+  ASSERT_EQ(12, snapshot.total_count());
+  ASSERT_EQ(2 + 3 + 4 + 5 + 8 * 10, snapshot.total_sum());
+}
+
 TEST_F(MetricsTest, JsonPrintTest) {
   scoped_refptr<Counter> bytes_seen = METRIC_reqs_pending.Instantiate(entity_);
   bytes_seen->Increment();
@@ -217,6 +247,69 @@ TEST_F(MetricsTest, JsonPrintTest) {
   ASSERT_EQ("", out.str());
 }
 
+namespace {
+
+// Returns the value of the series of the Prometheus output with the given name and label, or an
+// empty string if there is none.
+string PrometheusValue(const string& output, const string& name, const string& label) {
+  vector<string> lines = strings::Split(output, "\n", strings::SkipEmpty());
+  for (const auto& line : lines) {
+    if (line.compare(0, name.size() + 1, name + "{") != 0 || line.find(label) == string::npos) {
+      continue;
+    }
+    vector<string> fields = strings::Split(line.substr(line.find('}') + 1), " ",
+                                           strings::SkipEmpty());
+    return fields.empty() ? string() : fields[0];
+  }
+  return string();
+}
+
+} // namespace
+
+TEST_F(MetricsTest, PrometheusTabletAggregation) {
+  const MetricEntity::AttributeMap tablet1 = {
+      {"table_id", "t1"}, {"table_name", "table1"}, {"partition", "a"}};
+  const MetricEntity::AttributeMap tablet2 = {
+      {"table_id", "t1"}, {"table_name", "table1"}, {"partition", "b"}};
+  const MetricEntity::AttributeMap tablet3 = {{"table_id", "t2"}, {"table_name", "table2"}};
+  const MetricEntity::AttributeMap server = {{"metric_type", "server"}};
+
+  auto write = [&](MetricPrometheusOptions opts) {
+    std::stringstream out;
+    PrometheusWriter writer(&out, std::move(opts));
+    EXPECT_OK(writer.WriteSingleEntry(tablet1, "reqs", 1));
+    EXPECT_OK(writer.WriteSingleEntry(tablet2, "reqs", 2));
+    EXPECT_OK(writer.WriteSingleEntry(tablet3, "reqs", 4));
+    EXPECT_OK(writer.WriteSingleEntry(tablet3, "rows", 8));
+    EXPECT_OK(writer.WriteSingleEntry(server, "uptime", 16));
+    EXPECT_OK(writer.FlushAggregatedValues());
+    return out.str();
+  };
+
+  // Per table, without the tablet level labels.
+  string output = write(MetricPrometheusOptions());
+  ASSERT_EQ("3", PrometheusValue(output, "reqs", "table_id=\"t1\"")) << output;
+  ASSERT_EQ("4", PrometheusValue(output, "reqs", "table_id=\"t2\"")) << output;
+  ASSERT_EQ("8", PrometheusValue(output, "rows", "table_id=\"t2\"")) << output;
+  ASSERT_EQ("16", PrometheusValue(output, "uptime", "metric_type=\"server\"")) << output;
+  ASSERT_EQ(string::npos, output.find("partition")) << output;
+
+  // Per server.
+  MetricPrometheusOptions opts;
+  opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kServer;
+  output = write(opts);
+  ASSERT_EQ("7", PrometheusValue(output, "reqs", "metric_type=\"tablet\"")) << output;
+  ASSERT_EQ(string::npos, output.find("table_id")) << output;
+
+  // Filtered by metric name.
+  opts = MetricPrometheusOptions();
+  opts.requested_metrics = {"rows"};
+  output = write(opts);
+  ASSERT_EQ("8", PrometheusValue(output, "rows", "table_id=\"t2\"")) << output;
+  ASSERT_EQ("", PrometheusValue(output, "reqs", "table_id")) << output;
+  ASSERT_EQ("", PrometheusValue(output, "uptime", "metric_type")) << output;
+}
+
 // Test that metrics are retired when they are no longer referenced.
 TEST_F(MetricsTest, RetirementTest) {
   FLAGS_metrics_retirement_age_ms = 100;
@@ -276,6 +276,10 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 }
 
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
+  if (!writer->MatchesEntityType(prototype_->name())) {
+    return Status::OK();
+  }
+
   // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
   typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
   OrderedMetricMap metrics;
@@ -325,6 +329,49 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
   return Status::OK();
 }
 
+//
+// PrometheusWriter
+//
+
+bool PrometheusWriter::MatchesEntityType(const char* entity_type) const {
+  return opts_.entity_types.empty() ||
+         std::find(opts_.entity_types.begin(), opts_.entity_types.end(), entity_type) !=
+             opts_.entity_types.end();
+}
+
+bool PrometheusWriter::MatchesMetric(const std::string& name) const {
+  return MatchMetricInList(name, opts_.requested_metrics);
+}
+
+void PrometheusWriter::AddAggregatedValue(
+    const MetricEntity::AttributeMap& attr, const std::string& table_id, const std::string& name,
+    double value) {
+  const bool per_table = opts_.tablet_aggregation == MetricPrometheusOptions::Aggregation::kTable;
+  auto& entry = aggregated_[per_table ? table_id : std::string()];
+  if (entry.attributes.empty()) {
+    // The labels of a rolled up series are fixed, whatever the tablet level labels of the metrics
+    // are, e.g. the partition of the tablet.
+    if (per_table) {
+      entry.attributes["table_id"] = table_id;
+      entry.attributes["table_name"] = FindWithDefault(attr, "table_name", "");
+    }
+    entry.attributes["metric_type"] = "tablet";
+    entry.attributes["exported_instance"] = FLAGS_metric_node_name;
+  }
+  entry.values[name] += value;
+}
+
+CHECKED_STATUS PrometheusWriter::FlushAggregatedValues() {
+  for (const auto& entry : aggregated_) {
+    for (const auto& metric_entry : entry.second.values) {
+      RETURN_NOT_OK(FlushSingleEntry(
+          entry.second.attributes, metric_entry.first, metric_entry.second));
+    }
+  }
+  aggregated_.clear();
+  return Status::OK();
+}
+
 void MetricEntity::RetireOldMetrics() {
   MonoTime now = MonoTime::Now();
 
@@ -707,15 +754,39 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_(proto->striped() ? nullptr
+                                : new HdrHistogram(proto->max_trackable_value(),
+                                                   proto->num_sig_digits())),
+    striped_histogram_(proto->striped() ? new StripedHdrHistogram(proto->max_trackable_value(),
+                                                                   proto->num_sig_digits())
+                                        : nullptr) {
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  if (striped_histogram_) {
+    striped_histogram_->Increment(value);
+  } else {
+    histogram_->Increment(value);
+  }
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  if (striped_histogram_) {
+    striped_histogram_->IncrementBy(value, amount);
+  } else {
+    histogram_->IncrementBy(value, amount);
+  }
+}
+
+std::unique_ptr<HdrHistogram> Histogram::Snapshot() const {
+  if (!striped_histogram_) {
+    return std::unique_ptr<HdrHistogram>(new HdrHistogram(*histogram_));
+  }
+  std::unique_ptr<HdrHistogram> result(new HdrHistogram(
+      striped_histogram_->highest_trackable_value(),
+      striped_histogram_->num_significant_digits()));
+  striped_histogram_->MergeTo(result.get());
+  return result;
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -729,7 +800,8 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
+  auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -762,7 +834,8 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -796,22 +869,27 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return Snapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  return histogram_ ? histogram_->TotalCount() : Snapshot()->TotalCount();
+}
+
+uint64_t Histogram::ValueAtPercentile(double percentile) const {
+  return histogram_ ? histogram_->ValueAtPercentile(percentile)
+                    : Snapshot()->ValueAtPercentile(percentile);
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return Snapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return Snapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return Snapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(Histogram* latency_hist)
@@ -239,6 +239,8 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -313,6 +315,19 @@
       max_val, \
       num_sig_digits)
 
+// Defines a histogram that records into per-CPU stripes, see StripedHdrHistogram. Use it for
+// histograms updated concurrently from many threads on hot paths, e.g. once per RPC.
+#define METRIC_DEFINE_striped_histogram(entity, name, label, unit, desc, max_val, num_sig_digits) \
+  ::yb::HistogramPrototype BOOST_PP_CAT(METRIC_, name)(                                   \
+      ::yb::MetricPrototype::CtorArgs(BOOST_PP_STRINGIZE(entity), \
+                                      BOOST_PP_STRINGIZE(name), \
+                                      label, \
+                                      unit, \
+                                      desc, \
+                                      ::yb::STRIPED_HISTOGRAM), \
+      max_val, \
+      num_sig_digits)
+
 // The following macros act as forward declarations for entity types and metric prototypes.
 #define METRIC_DECLARE_entity(name) \
   extern ::yb::MetricEntityPrototype METRIC_ENTITY_##name
@@ -366,6 +381,7 @@ class MetricRegistry;
 
 class HdrHistogram;
 class Histogram;
+class StripedHdrHistogram;
 class HistogramPrototype;
 class HistogramSnapshotPB;
 
@@ -439,6 +455,25 @@ struct MetricJsonOptions {
   bool include_schema_info;
 };
 
+struct MetricPrometheusOptions {
+  // How the metrics of the tablets are rolled up.
+  enum class Aggregation {
+    // A series per table, labeled with table_id and table_name.
+    kTable,
+    // A single series per server, for the metrics of all the tablets.
+    kServer,
+  };
+
+  // Substrings to match the metric names against, '*' matches all the metrics.
+  std::vector<std::string> requested_metrics = {"*"};
+
+  // Types of the entities to export the metrics of, e.g. "tablet" or "server". Empty for all
+  // the types.
+  std::vector<std::string> entity_types;
+
+  Aggregation tablet_aggregation = Aggregation::kTable;
+};
+
 class MetricEntityPrototype {
  public:
   explicit MetricEntityPrototype(const char* name);
@@ -573,42 +608,40 @@ typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
+  explicit PrometheusWriter(std::stringstream* output,
+                            MetricPrometheusOptions opts = MetricPrometheusOptions())
     : output_(output),
+      opts_(std::move(opts)),
       timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch()).count()) {}
 
   template<typename T>
   CHECKED_STATUS WriteSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
+    if (!MatchesMetric(name)) {
+      return Status::OK();
+    }
     auto it = attr.find("table_id");
     if (it != attr.end()) {
-      // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
-        // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
-      }
-    } else {
-      // For non-tablet level metrics, export them directly.
-      RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
+      // For tablet level metrics, we roll up on the table or the server level.
+      AddAggregatedValue(attr, it->second, name, value);
+      return Status::OK();
     }
-    return Status::OK();
+    // For non-tablet level metrics, export them directly.
+    return FlushSingleEntry(attr, name, value);
   }
 
-  CHECKED_STATUS FlushAggregatedValues() {
-    for (const auto& entry : per_table_values_) {
-      const auto& attrs = per_table_attributes_[entry.first];
-      for (const auto& metric_entry : entry.second) {
-        RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
-      }
-    }
-    return Status::OK();
-  }
+  CHECKED_STATUS FlushAggregatedValues();
+
+  // Whether the metrics of the entities of the given type are requested.
+  bool MatchesEntityType(const char* entity_type) const;
 
  private:
+  bool MatchesMetric(const std::string& name) const;
+
+  void AddAggregatedValue(const MetricEntity::AttributeMap& attr, const std::string& table_id,
+                          const std::string& name, double value);
+
   template<typename T>
   CHECKED_STATUS FlushSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
@@ -630,12 +663,18 @@ class PrometheusWriter {
     return Status::OK();
   }
 
-  // Map from table_id to attributes
-  std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
-  // Map from table_id to map of metric_name to value
-  std::map<std::string, std::map<std::string, double>> per_table_values_;
+  struct AggregatedEntry {
+    MetricEntity::AttributeMap attributes;
+    // Map from metric_name to value
+    std::map<std::string, double> values;
+  };
+
+  // Map from table_id, or the empty string for the server level aggregation, to the rolled up
+  // metrics of its tablets.
+  std::map<std::string, AggregatedEntry> aggregated_;
   // Output stream
   std::stringstream* output_;
+  const MetricPrometheusOptions opts_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
 };
@@ -767,7 +806,10 @@ class MetricPrototypeRegistry {
 enum PrototypeFlags {
   // Flag which causes a Gauge prototype to expose itself as if it
   // were a counter.
-  EXPOSE_AS_COUNTER = 1 << 0
+  EXPOSE_AS_COUNTER = 1 << 0,
+  // Flag which causes a Histogram prototype to instantiate histograms that record into
+  // per-CPU stripes.
+  STRIPED_HISTOGRAM = 1 << 1
 };
 
 class MetricPrototype {
@@ -1103,6 +1145,7 @@ class HistogramPrototype : public MetricPrototype {
 
   uint64_t max_trackable_value() const { return max_trackable_value_; }
   int num_sig_digits() const { return num_sig_digits_; }
+  bool striped() const { return (args_.flags_ & STRIPED_HISTOGRAM) != 0; }
   virtual MetricType::Type type() const override { return MetricType::kHistogram; }
 
  private:
@@ -1125,6 +1168,9 @@ class Histogram : public Metric {
   // or IncrementBy()).
   uint64_t TotalCount() const;
 
+  // Return the value at the given percentile of the values added to the histogram.
+  uint64_t ValueAtPercentile(double percentile) const;
+
   virtual CHECKED_STATUS WriteAsJson(JsonWriter* w,
                              const MetricJsonOptions& opts) const override;
 
@@ -1142,10 +1188,16 @@ class Histogram : public Metric {
 
  private:
   FRIEND_TEST(MetricsTest, SimpleHistogramTest);
+  FRIEND_TEST(MetricsTest, StripedHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
 
+  // Returns a copy of the recorded values, merging the stripes of a striped histogram.
+  std::unique_ptr<HdrHistogram> Snapshot() const;
+
+  // Exactly one of these is set, depending on whether the prototype is striped.
   const gscoped_ptr<HdrHistogram> histogram_;
+  const gscoped_ptr<StripedHdrHistogram> striped_histogram_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -89,6 +89,37 @@ TEST_F(MtHdrHistogramTest, ConcurrentWriteTest) {
   delete[] threads;
 }
 
+static void IncrementSameStripedHistValue(
+    StripedHdrHistogram* hist, uint64_t value, uint64_t times) {
+  for (uint64_t i = 0; i < times; i++) {
+    hist->Increment(value);
+  }
+}
+
+TEST_F(MtHdrHistogramTest, ConcurrentStripedWriteTest) {
+  const uint64_t kValue = 1LU;
+
+  StripedHdrHistogram hist(100000LU, 3);
+
+  auto threads = new scoped_refptr<yb::Thread>[num_threads_];
+  for (int i = 0; i < num_threads_; i++) {
+    CHECK_OK(yb::Thread::Create("test", strings::Substitute("thread-$0", i),
+        IncrementSameStripedHistValue, &hist, kValue, num_times_, &threads[i]));
+  }
+  for (int i = 0; i < num_threads_; i++) {
+    CHECK_OK(ThreadJoiner(threads[i].get()).Join());
+  }
+
+  HdrHistogram snapshot(hist.highest_trackable_value(), hist.num_significant_digits());
+  hist.MergeTo(&snapshot);
+  ASSERT_EQ(num_threads_ * num_times_, snapshot.CountInBucketForValue(kValue));
+  ASSERT_EQ(num_threads_ * num_times_, snapshot.TotalCount());
+  ASSERT_EQ(kValue, snapshot.MinValue());
+  ASSERT_EQ(kValue, snapshot.MaxValue());
+
+  delete[] threads;
+}
+
 // Copy while writing, then iterate to ensure copies are consistent.
 TEST_F(MtHdrHistogramTest, ConcurrentCopyWhileWritingTest) {
   const int kNumCopies = 10;
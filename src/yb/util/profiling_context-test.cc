@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/util/monotime.h"
+#include "yb/util/profiling_context.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(cpu_attribution_sample_1_in_n);
+
+namespace yb {
+
+class ProfilingContextTest : public YBTest {
+ protected:
+  static const ProfilingAttribution* Find(const std::vector<ProfilingAttribution>& entries,
+                                          const std::string& tablet_id,
+                                          const std::string& activity) {
+    for (const auto& entry : entries) {
+      if (entry.tablet_id == tablet_id && entry.activity == activity) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+};
+
+TEST_F(ProfilingContextTest, TestAttribution) {
+  FLAGS_cpu_attribution_sample_1_in_n = 1;
+  for (int i = 0; i != 3; ++i) {
+    ScopedProfilingContext context("Busy");
+    // The tablet set later applies to the whole context, while nested contexts are ignored.
+    ScopedProfilingContext::SetTabletId("tablet-1");
+    ScopedProfilingContext nested("Nested", "tablet-2");
+    ScopedProfilingContext::AddLockWaitCycles(10000000);
+    const MonoTime deadline = MonoTime::Now() + MonoDelta::FromMilliseconds(20);
+    while (MonoTime::Now() < deadline) {
+    }
+  }
+  {
+    ScopedProfilingContext context("Idle", "tablet-2");
+  }
+
+  auto entries = GetProfilingAttribution();
+  auto busy = Find(entries, "tablet-1", "Busy");
+  ASSERT_NE(nullptr, busy);
+  ASSERT_EQ(3, busy->count);
+  ASSERT_GT(busy->cpu_micros, 0);
+  ASSERT_GT(busy->lock_wait_micros, 0);
+  ASSERT_EQ(nullptr, Find(entries, "tablet-2", "Nested"));
+  auto idle = Find(entries, "tablet-2", "Idle");
+  ASSERT_NE(nullptr, idle);
+  ASSERT_EQ(1, idle->count);
+  ASSERT_LT(idle->cpu_micros, busy->cpu_micros);
+
+  // Only one in two contexts is measured, and it stands for both.
+  FLAGS_cpu_attribution_sample_1_in_n = 2;
+  for (int i = 0; i != 4; ++i) {
+    ScopedProfilingContext context("Sampled", "tablet-3");
+  }
+  entries = GetProfilingAttribution();
+  auto sampled = Find(entries, "tablet-3", "Sampled");
+  ASSERT_NE(nullptr, sampled);
+  ASSERT_EQ(4, sampled->count);
+}
+
+} // namespace yb
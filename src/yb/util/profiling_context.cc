@@ -0,0 +1,190 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/profiling_context.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/sysinfo.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cpu_attribution_sample_1_in_n, 32,
+             "Measure the CPU and spinlock wait time of one in this many RPCs and operation "
+             "prepares and applies of each thread, to break them down by tablet. 0 disables it.");
+TAG_FLAG(cpu_attribution_sample_1_in_n, advanced);
+TAG_FLAG(cpu_attribution_sample_1_in_n, runtime);
+
+DEFINE_int32(cpu_attribution_window_sec, 60,
+             "Length of the rolling window over which the CPU and spinlock wait time breakdown "
+             "by tablet is reported.");
+TAG_FLAG(cpu_attribution_window_sec, advanced);
+TAG_FLAG(cpu_attribution_window_sec, runtime);
+
+namespace yb {
+
+namespace {
+
+__thread ScopedProfilingContext* current_context = nullptr;
+
+int NextContextWeight() {
+  static __thread uint32_t contexts_since_measured = 0;
+  const int sample_1_in_n = FLAGS_cpu_attribution_sample_1_in_n;
+  if (sample_1_in_n <= 0 || ++contexts_since_measured < static_cast<uint32_t>(sample_1_in_n)) {
+    return 0;
+  }
+  contexts_since_measured = 0;
+  return sample_1_in_n;
+}
+
+int64_t ThreadCpuNanos() {
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Totals of the measured contexts by tablet and activity, kept in buckets that together cover
+// the rolling window. A bucket is reset when it is reused for a later part of the window.
+class AttributionTable {
+ public:
+  static AttributionTable* Instance() {
+    static AttributionTable* instance = new AttributionTable();
+    return instance;
+  }
+
+  void Add(const std::string& tablet_id, const std::string& activity, int weight,
+           int64_t cpu_nanos, int64_t lock_wait_cycles) {
+    const int64_t epoch = CurrentEpoch();
+    std::lock_guard<std::mutex> lock(mutex_);
+    Bucket& bucket = buckets_[epoch % kNumBuckets];
+    if (bucket.epoch != epoch) {
+      bucket.epoch = epoch;
+      bucket.totals.clear();
+    }
+    Totals& totals = bucket.totals[Key(tablet_id, activity)];
+    totals.count += weight;
+    totals.cpu_nanos += cpu_nanos * weight;
+    totals.lock_wait_cycles += lock_wait_cycles * weight;
+  }
+
+  std::vector<ProfilingAttribution> Get() {
+    const int64_t epoch = CurrentEpoch();
+    std::map<Key, Totals> merged;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const Bucket& bucket : buckets_) {
+        if (bucket.epoch <= epoch - kNumBuckets) {
+          continue;
+        }
+        for (const auto& entry : bucket.totals) {
+          Totals& totals = merged[entry.first];
+          totals.count += entry.second.count;
+          totals.cpu_nanos += entry.second.cpu_nanos;
+          totals.lock_wait_cycles += entry.second.lock_wait_cycles;
+        }
+      }
+    }
+
+    const double cycles_per_micro = base::CyclesPerSecond() / 1000000.0;
+    std::vector<ProfilingAttribution> result;
+    result.reserve(merged.size());
+    for (const auto& entry : merged) {
+      result.push_back(ProfilingAttribution{
+          entry.first.first, entry.first.second, entry.second.count,
+          entry.second.cpu_nanos / 1000,
+          static_cast<int64_t>(entry.second.lock_wait_cycles / cycles_per_micro)});
+    }
+    return result;
+  }
+
+ private:
+  static constexpr int64_t kNumBuckets = 6;
+
+  typedef std::pair<std::string, std::string> Key;
+
+  struct Totals {
+    int64_t count = 0;
+    int64_t cpu_nanos = 0;
+    int64_t lock_wait_cycles = 0;
+  };
+
+  struct Bucket {
+    int64_t epoch = -1;
+    std::map<Key, Totals> totals;
+  };
+
+  static int64_t CurrentEpoch() {
+    const int64_t bucket_micros =
+        std::max<int64_t>(FLAGS_cpu_attribution_window_sec, 1) * 1000000 / kNumBuckets;
+    return GetMonoTimeMicros() / std::max<int64_t>(bucket_micros, 1);
+  }
+
+  std::mutex mutex_;
+  Bucket buckets_[kNumBuckets];
+};
+
+constexpr int64_t AttributionTable::kNumBuckets;
+
+} // namespace
+
+ScopedProfilingContext::ScopedProfilingContext(const char* activity, const std::string& tablet_id)
+    : active_(current_context == nullptr),
+      weight_(active_ ? NextContextWeight() : 0) {
+  if (!active_) {
+    return;
+  }
+  current_context = this;
+  if (weight_ != 0) {
+    activity_ = activity;
+    tablet_id_ = tablet_id;
+    start_cpu_nanos_ = ThreadCpuNanos();
+  }
+}
+
+ScopedProfilingContext::~ScopedProfilingContext() {
+  if (!active_) {
+    return;
+  }
+  current_context = nullptr;
+  if (weight_ != 0) {
+    const int64_t cpu_nanos = std::max<int64_t>(ThreadCpuNanos() - start_cpu_nanos_, 0);
+    AttributionTable::Instance()->Add(
+        tablet_id_, activity_, weight_, cpu_nanos, lock_wait_cycles_);
+  }
+}
+
+void ScopedProfilingContext::SetTabletId(const std::string& tablet_id) {
+  if (current_context != nullptr && current_context->weight_ != 0) {
+    current_context->tablet_id_ = tablet_id;
+  }
+}
+
+void ScopedProfilingContext::AddLockWaitCycles(int64_t cycles) {
+  if (current_context != nullptr && current_context->weight_ != 0) {
+    current_context->lock_wait_cycles_ += cycles;
+  }
+}
+
+std::vector<ProfilingAttribution> GetProfilingAttribution() {
+  return AttributionTable::Instance()->Get();
+}
+
+} // namespace yb
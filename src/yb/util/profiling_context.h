@@ -0,0 +1,77 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_PROFILING_CONTEXT_H
+#define YB_UTIL_PROFILING_CONTEXT_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+// Attributes the CPU time and spinlock wait time of the work done by the current thread while in
+// scope to an activity, like an RPC method or the apply of an operation, and to a tablet.
+//
+// Only one in --cpu_attribution_sample_1_in_n contexts of each thread is measured, and the
+// measured time is scaled up accordingly, so the breakdowns are estimates that are cheap enough
+// to collect all the time.
+//
+// Contexts don't nest: a context created while another one is active on the same thread does
+// nothing, so the work is attributed to the outermost activity.
+class ScopedProfilingContext {
+ public:
+  // 'activity' is copied only if the context is measured, so it's cheap to pass a literal.
+  explicit ScopedProfilingContext(const char* activity,
+                                  const std::string& tablet_id = std::string());
+  ~ScopedProfilingContext();
+
+  // Sets the tablet of the context active on the current thread, if that one is measured. Used when
+  // the tablet is only known after the context was created, e.g. after parsing an RPC request.
+  static void SetTabletId(const std::string& tablet_id);
+
+  // Adds to the spinlock wait time of the context active on the current thread.
+  static void AddLockWaitCycles(int64_t cycles);
+
+ private:
+  // Whether this is the outermost context of the thread.
+  const bool active_;
+  // Number of contexts this one stands for if it is measured, 0 otherwise.
+  const int weight_;
+  std::string activity_;
+  std::string tablet_id_;
+  int64_t start_cpu_nanos_ = 0;
+  int64_t lock_wait_cycles_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedProfilingContext);
+};
+
+struct ProfilingAttribution {
+  std::string tablet_id;
+  std::string activity;
+  // Estimated number of contexts and their total CPU and spinlock wait time.
+  int64_t count;
+  int64_t cpu_micros;
+  int64_t lock_wait_micros;
+};
+
+// Returns what was attributed during the last --cpu_attribution_window_sec seconds, ordered by
+// tablet and activity.
+std::vector<ProfilingAttribution> GetProfilingAttribution();
+
+} // namespace yb
+
+#endif // YB_UTIL_PROFILING_CONTEXT_H
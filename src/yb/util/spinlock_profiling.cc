@@ -44,6 +44,7 @@
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
+#include "yb/util/profiling_context.h"
 #include "yb/util/striped64.h"
 #include "yb/util/trace.h"
 
@@ -223,6 +224,8 @@ bool ContentionStacks::CollectSample(uint64_t* iterator, StackTrace* s, int64_t*
 // https://yugabyte.atlassian.net/browse/ENG-354
 ATTRIBUTE_NO_SANITIZE_THREAD
 void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
+  ScopedProfilingContext::AddLockWaitCycles(wait_cycles);
+
   bool profiling_enabled = base::subtle::Acquire_Load(&g_profiling_enabled);
   bool long_wait_time = wait_cycles > FLAGS_lock_contention_trace_threshold_cycles;
   // Short circuit this function quickly in the common case.
@@ -0,0 +1,140 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+#include "yb/util/time_series_encoding.h"
+
+namespace yb {
+
+namespace {
+
+typedef std::vector<std::pair<int64_t, double>> Samples;
+
+faststring Encode(const Samples& samples) {
+  TimeSeriesEncoder encoder;
+  for (const auto& sample : samples) {
+    encoder.Append(sample.first, sample.second);
+  }
+  faststring block;
+  encoder.Finish(&block);
+  return block;
+}
+
+void CheckRoundTrip(const Samples& samples) {
+  const faststring block = Encode(samples);
+  TimeSeriesDecoder decoder(Slice(block.data(), block.size()));
+  ASSERT_OK(decoder.Init());
+  ASSERT_EQ(samples.size(), decoder.count());
+  for (const auto& sample : samples) {
+    ASSERT_TRUE(decoder.HasNext());
+    int64_t timestamp = 0;
+    double value = 0;
+    ASSERT_OK(decoder.Next(&timestamp, &value));
+    ASSERT_EQ(sample.first, timestamp);
+    // Compare the bits, so that NaNs and signed zeros match too.
+    ASSERT_EQ(0, memcmp(&sample.second, &value, sizeof(value)));
+  }
+  ASSERT_FALSE(decoder.HasNext());
+}
+
+} // namespace
+
+class TimeSeriesEncodingTest : public YBTest {
+};
+
+TEST_F(TimeSeriesEncodingTest, TestRegularSamples) {
+  // Samples every 10 seconds, with a value that rarely changes, take a couple of bits each.
+  Samples samples;
+  for (int i = 0; i < 1000; ++i) {
+    samples.emplace_back(1500000000000 + i * 10000, 20.0 + (i / 100) * 0.5);
+  }
+  ASSERT_NO_FATALS(CheckRoundTrip(samples));
+  ASSERT_LT(Encode(samples).size(), samples.size() / 2);
+}
+
+TEST_F(TimeSeriesEncodingTest, TestIrregularSamples) {
+  std::mt19937_64 rng(SeedRandom());
+  std::uniform_int_distribution<int64_t> jitter(-5000, 5000);
+  std::normal_distribution<double> noise(0, 10);
+  Samples samples;
+  int64_t timestamp = -1000000;
+  for (int i = 0; i < 10000; ++i) {
+    // Mostly ordered timestamps, with gaps of all the sizes and a few going back in time.
+    timestamp += (i % 100 == 0) ? jitter(rng) * 1000000 : 1000 + jitter(rng) / (1 + i % 7);
+    samples.emplace_back(timestamp, noise(rng));
+  }
+  ASSERT_NO_FATALS(CheckRoundTrip(samples));
+}
+
+TEST_F(TimeSeriesEncodingTest, TestEdgeValues) {
+  ASSERT_NO_FATALS(CheckRoundTrip(Samples()));
+  const Samples single = {{42, 1.5}};
+  ASSERT_NO_FATALS(CheckRoundTrip(single));
+  const Samples extremes = {
+      {std::numeric_limits<int64_t>::min(), 0.0},
+      {std::numeric_limits<int64_t>::max(), -0.0},
+      {std::numeric_limits<int64_t>::min(), std::numeric_limits<double>::quiet_NaN()},
+      {0, std::numeric_limits<double>::infinity()},
+      {0, std::numeric_limits<double>::denorm_min()},
+      {1, std::numeric_limits<double>::max()},
+      {1, std::numeric_limits<double>::lowest()},
+      {-1, 1.0},
+  };
+  ASSERT_NO_FATALS(CheckRoundTrip(extremes));
+}
+
+TEST_F(TimeSeriesEncodingTest, TestReuseAndCorruption) {
+  TimeSeriesEncoder encoder;
+  encoder.Append(100, 1.0);
+  faststring first;
+  encoder.Finish(&first);
+  ASSERT_EQ(0, encoder.count());
+
+  encoder.Append(200, 2.0);
+  encoder.Append(300, 3.0);
+  encoder.Append(400, 4.0);
+  faststring second;
+  encoder.Finish(&second);
+
+  TimeSeriesDecoder decoder(Slice(second.data(), second.size()));
+  ASSERT_OK(decoder.Init());
+  ASSERT_EQ(3, decoder.count());
+  int64_t timestamp = 0;
+  double value = 0;
+  ASSERT_OK(decoder.Next(&timestamp, &value));
+  ASSERT_EQ(200, timestamp);
+  ASSERT_EQ(2.0, value);
+
+  // A truncated block fails to decode instead of reading past its end.
+  // The header and the first sample take 17 bytes.
+  TimeSeriesDecoder truncated(Slice(second.data(), 17));
+  ASSERT_OK(truncated.Init());
+  ASSERT_OK(truncated.Next(&timestamp, &value));
+  Status status;
+  while (truncated.HasNext() && status.ok()) {
+    status = truncated.Next(&timestamp, &value);
+  }
+  ASSERT_TRUE(status.IsCorruption()) << status;
+
+  TimeSeriesDecoder empty(Slice());
+  ASSERT_TRUE(empty.Init().IsCorruption());
+}
+
+} // namespace yb
@@ -0,0 +1,230 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/time_series_encoding.h"
+
+#include <algorithm>
+
+#include "yb/gutil/casts.h"
+#include "yb/util/bit-stream-utils.inline.h"
+#include "yb/util/coding.h"
+#include "yb/util/format.h"
+
+namespace yb {
+
+namespace {
+
+// The delta of delta of a timestamp is written as a prefix of up to kMaxDeltaPrefix one bits and a
+// zero bit, that selects the number of bits of its zigzag encoding. A zero prefix stands for a
+// zero delta of delta, and the longest one for the full 64 bits.
+constexpr int kDeltaOfDeltaBits[] = { 0, 7, 9, 12, 64 };
+constexpr int kMaxDeltaPrefix = arraysize(kDeltaOfDeltaBits) - 1;
+
+// The number of leading zeros of an XOR is stored in 5 bits, and its number of meaningful bits
+// minus one in 6 bits.
+constexpr int kLeadingZerosBits = 5;
+constexpr int kMaxLeadingZeros = (1 << kLeadingZerosBits) - 1;
+constexpr int kMeaningfulBitsBits = 6;
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ -(value & 1));
+}
+
+} // namespace
+
+TimeSeriesEncoder::TimeSeriesEncoder() : writer_(&bits_) {
+}
+
+void TimeSeriesEncoder::PutBits(uint64_t value, int num_bits) {
+  // BitWriter takes at most 32 bits at a time.
+  if (num_bits > 32) {
+    writer_.PutValue(value & 0xFFFFFFFF, 32);
+    writer_.PutValue(value >> 32, num_bits - 32);
+  } else {
+    writer_.PutValue(value, num_bits);
+  }
+}
+
+void TimeSeriesEncoder::Append(int64_t timestamp, double value) {
+  if (count_ == 0) {
+    PutBits(static_cast<uint64_t>(timestamp), 64);
+    prev_value_ = bit_cast<uint64_t>(value);
+    PutBits(prev_value_, 64);
+    prev_timestamp_ = timestamp;
+  } else {
+    AppendTimestamp(timestamp);
+    AppendValue(value);
+  }
+  ++count_;
+}
+
+void TimeSeriesEncoder::AppendTimestamp(int64_t timestamp) {
+  // The unsigned arithmetic wraps around, the decoder wraps it back.
+  const uint64_t delta = static_cast<uint64_t>(timestamp) - static_cast<uint64_t>(prev_timestamp_);
+  const uint64_t delta_of_delta = ZigZagEncode(static_cast<int64_t>(delta - prev_delta_));
+  prev_timestamp_ = timestamp;
+  prev_delta_ = delta;
+
+  int prefix = 0;
+  while (prefix < kMaxDeltaPrefix &&
+         delta_of_delta >= (1ULL << kDeltaOfDeltaBits[prefix])) {
+    ++prefix;
+  }
+  for (int i = 0; i < prefix; ++i) {
+    writer_.PutValue(1, 1);
+  }
+  if (prefix < kMaxDeltaPrefix) {
+    writer_.PutValue(0, 1);
+  }
+  PutBits(delta_of_delta, kDeltaOfDeltaBits[prefix]);
+}
+
+void TimeSeriesEncoder::AppendValue(double value) {
+  const uint64_t bits = bit_cast<uint64_t>(value);
+  const uint64_t xor_value = bits ^ prev_value_;
+  prev_value_ = bits;
+  if (xor_value == 0) {
+    writer_.PutValue(0, 1);
+    return;
+  }
+  writer_.PutValue(1, 1);
+
+  const int leading_zeros = std::min(__builtin_clzll(xor_value), kMaxLeadingZeros);
+  const int trailing_zeros = __builtin_ctzll(xor_value);
+  if (prev_leading_zeros_ >= 0 && leading_zeros >= prev_leading_zeros_ &&
+      trailing_zeros >= prev_trailing_zeros_) {
+    // The meaningful bits fit in those of the previous XOR.
+    writer_.PutValue(0, 1);
+    PutBits(xor_value >> prev_trailing_zeros_, 64 - prev_leading_zeros_ - prev_trailing_zeros_);
+    return;
+  }
+  writer_.PutValue(1, 1);
+  const int meaningful_bits = 64 - leading_zeros - trailing_zeros;
+  writer_.PutValue(leading_zeros, kLeadingZerosBits);
+  writer_.PutValue(meaningful_bits - 1, kMeaningfulBitsBits);
+  PutBits(xor_value >> trailing_zeros, meaningful_bits);
+  prev_leading_zeros_ = leading_zeros;
+  prev_trailing_zeros_ = trailing_zeros;
+}
+
+void TimeSeriesEncoder::Finish(faststring* out) {
+  writer_.Flush();
+  PutVarint32(out, count_);
+  out->append(bits_.data(), bits_.size());
+
+  writer_.Clear();
+  count_ = 0;
+  prev_timestamp_ = 0;
+  prev_delta_ = 0;
+  prev_value_ = 0;
+  prev_leading_zeros_ = -1;
+  prev_trailing_zeros_ = 0;
+}
+
+Status TimeSeriesDecoder::Init() {
+  uint32_t count = 0;
+  if (!GetVarint32(&block_, &count)) {
+    return STATUS(Corruption, "Bad time series block header");
+  }
+  count_ = count;
+  reader_ = BitReader(block_.data(), block_.size());
+  return Status::OK();
+}
+
+Status TimeSeriesDecoder::GetBits(int num_bits, uint64_t* value) {
+  if (num_bits > 32) {
+    uint64_t low = 0;
+    uint64_t high = 0;
+    if (!reader_.GetValue(32, &low) || !reader_.GetValue(num_bits - 32, &high)) {
+      return STATUS_FORMAT(Corruption, "Truncated time series block at sample $0", decoded_);
+    }
+    *value = low | (high << 32);
+  } else if (!reader_.GetValue(num_bits, value)) {
+    return STATUS_FORMAT(Corruption, "Truncated time series block at sample $0", decoded_);
+  }
+  return Status::OK();
+}
+
+Status TimeSeriesDecoder::Next(int64_t* timestamp, double* value) {
+  if (!HasNext()) {
+    return STATUS_FORMAT(IllegalState, "Read past the end of a time series block of $0 samples",
+                         count_);
+  }
+  if (decoded_ == 0) {
+    uint64_t bits = 0;
+    RETURN_NOT_OK(GetBits(64, &bits));
+    prev_timestamp_ = static_cast<int64_t>(bits);
+    RETURN_NOT_OK(GetBits(64, &prev_value_));
+  } else {
+    RETURN_NOT_OK(NextTimestamp());
+    RETURN_NOT_OK(NextValue());
+  }
+  ++decoded_;
+  *timestamp = prev_timestamp_;
+  *value = bit_cast<double>(prev_value_);
+  return Status::OK();
+}
+
+Status TimeSeriesDecoder::NextTimestamp() {
+  int prefix = 0;
+  while (prefix < kMaxDeltaPrefix) {
+    uint64_t bit = 0;
+    RETURN_NOT_OK(GetBits(1, &bit));
+    if (bit == 0) {
+      break;
+    }
+    ++prefix;
+  }
+  uint64_t delta_of_delta = 0;
+  if (kDeltaOfDeltaBits[prefix] != 0) {
+    RETURN_NOT_OK(GetBits(kDeltaOfDeltaBits[prefix], &delta_of_delta));
+  }
+  prev_delta_ += static_cast<uint64_t>(ZigZagDecode(delta_of_delta));
+  prev_timestamp_ = static_cast<int64_t>(static_cast<uint64_t>(prev_timestamp_) + prev_delta_);
+  return Status::OK();
+}
+
+Status TimeSeriesDecoder::NextValue() {
+  uint64_t bit = 0;
+  RETURN_NOT_OK(GetBits(1, &bit));
+  if (bit == 0) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(GetBits(1, &bit));
+  if (bit != 0) {
+    uint64_t leading_zeros = 0;
+    uint64_t meaningful_bits = 0;
+    RETURN_NOT_OK(GetBits(kLeadingZerosBits, &leading_zeros));
+    RETURN_NOT_OK(GetBits(kMeaningfulBitsBits, &meaningful_bits));
+    ++meaningful_bits;
+    if (leading_zeros + meaningful_bits > 64) {
+      return STATUS_FORMAT(Corruption, "Bad value encoding in time series block at sample $0",
+                           decoded_);
+    }
+    prev_leading_zeros_ = leading_zeros;
+    prev_trailing_zeros_ = 64 - leading_zeros - meaningful_bits;
+  } else if (prev_leading_zeros_ < 0) {
+    return STATUS_FORMAT(Corruption, "Bad value encoding in time series block at sample $0",
+                         decoded_);
+  }
+  uint64_t xor_value = 0;
+  RETURN_NOT_OK(GetBits(64 - prev_leading_zeros_ - prev_trailing_zeros_, &xor_value));
+  prev_value_ ^= xor_value << prev_trailing_zeros_;
+  return Status::OK();
+}
+
+} // namespace yb
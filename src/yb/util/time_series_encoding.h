@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_TIME_SERIES_ENCODING_H
+#define YB_UTIL_TIME_SERIES_ENCODING_H
+
+#include <stdint.h>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/bit-stream-utils.h"
+#include "yb/util/faststring.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+// Packs the consecutive samples of a time series into a block, the way Gorilla does: each
+// timestamp is stored as the delta of its delta from the previous one, which is a single bit for
+// regularly spaced samples, and each value as its XOR with the previous value, which has only a
+// few meaningful bits for slowly changing values.
+//
+// The block starts with the varint number of samples, followed by the bit stream. The timestamps
+// do not have to be ordered, but the encoding is the most compact when they are.
+class TimeSeriesEncoder {
+ public:
+  TimeSeriesEncoder();
+
+  void Append(int64_t timestamp, double value);
+
+  size_t count() const { return count_; }
+
+  // Appends the block with the samples appended so far to out, and resets the encoder for the next
+  // block.
+  void Finish(faststring* out);
+
+ private:
+  void PutBits(uint64_t value, int num_bits);
+  void AppendTimestamp(int64_t timestamp);
+  void AppendValue(double value);
+
+  faststring bits_;
+  BitWriter writer_;
+  size_t count_ = 0;
+
+  int64_t prev_timestamp_ = 0;
+  uint64_t prev_delta_ = 0;
+  uint64_t prev_value_ = 0;
+  // The meaningful bits of the previous XOR, that the following ones may reuse.
+  int prev_leading_zeros_ = -1;
+  int prev_trailing_zeros_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TimeSeriesEncoder);
+};
+
+// Reads back the samples of a block written by TimeSeriesEncoder. The block must outlive the
+// decoder.
+class TimeSeriesDecoder {
+ public:
+  explicit TimeSeriesDecoder(const Slice& block) : block_(block) {}
+
+  CHECKED_STATUS Init();
+
+  size_t count() const { return count_; }
+
+  bool HasNext() const { return decoded_ < count_; }
+
+  CHECKED_STATUS Next(int64_t* timestamp, double* value);
+
+ private:
+  CHECKED_STATUS GetBits(int num_bits, uint64_t* value);
+  CHECKED_STATUS NextTimestamp();
+  CHECKED_STATUS NextValue();
+
+  Slice block_;
+  BitReader reader_;
+  size_t count_ = 0;
+  size_t decoded_ = 0;
+
+  int64_t prev_timestamp_ = 0;
+  uint64_t prev_delta_ = 0;
+  uint64_t prev_value_ = 0;
+  int prev_leading_zeros_ = -1;
+  int prev_trailing_zeros_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TimeSeriesDecoder);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_TIME_SERIES_ENCODING_H
@@ -121,6 +121,37 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampledTrace) {
+  FLAGS_enable_tracing = false;
+  scoped_refptr<Trace> traceA(new Trace);
+  scoped_refptr<Trace> traceB(new Trace);
+  TRACE_TO(traceA, "not sampled yet");
+  {
+    ADOPT_TRACE(traceA.get());
+    EXPECT_TRUE(Trace::CurrentTrace() == nullptr);
+  }
+
+  traceA->set_trace_id(42);
+  ASSERT_TRUE(traceA->sampled());
+  TRACE_TO(traceA, "hello from traceA");
+  {
+    ADOPT_TRACE(traceA.get());
+    EXPECT_EQ(traceA.get(), Trace::CurrentTrace());
+    traceA->AddChildTrace(traceB.get());
+    EXPECT_EQ(42U, traceB->trace_id());
+    {
+      ADOPT_TRACE(traceB.get());
+      TRACE("hello from traceB");
+    }
+  }
+  EXPECT_EQ("Trace id: XX\n"
+            "XXXX XX:XX:XX.XXXXXX trace-test.cc:XXX] hello from traceA\n"
+            "Related trace:\n"
+            "Trace id: XX\n"
+            "XXXX XX:XX:XX.XXXXXX trace-test.cc:XXX] hello from traceB\n",
+            XOutDigits(traceA->DumpToString(false)));
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
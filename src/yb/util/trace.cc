@@ -32,9 +32,11 @@
 
 #include "yb/util/trace.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <limits>
 #include <strstream>
 #include <string>
 #include <vector>
@@ -45,13 +47,22 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
 
+DEFINE_int32(sampled_trace_1_in_n, 0,
+             "When tracing is disabled, collect the traces of about 1 in this number of requests "
+             "entering the system, together with the traces of the RPCs made to serve them on "
+             "all servers. 0 disables sampling.");
+TAG_FLAG(sampled_trace_1_in_n, advanced);
+TAG_FLAG(sampled_trace_1_in_n, runtime);
+
 namespace yb {
 
 using strings::internal::SubstituteArg;
@@ -159,7 +170,9 @@ int64_t GetCurrentMicrosFast(MonoTime now) {
 } // namespace
 
 ScopedAdoptTrace::ScopedAdoptTrace(Trace* t)
-    : old_trace_(Trace::threadlocal_trace_), is_enabled_(FLAGS_enable_tracing) {
+    : old_trace_(Trace::threadlocal_trace_),
+      // Replace the adopted trace even when 't' is not sampled, so entries don't go to it.
+      is_enabled_(FLAGS_enable_tracing || old_trace_ != nullptr || (t && t->sampled())) {
   if (is_enabled_) {
     trace_ = t;
     Trace::threadlocal_trace_ = t;
@@ -294,39 +307,47 @@ TraceEntry* Trace::NewEntry(int msg_len, const char* file_path, int line_number,
 }
 
 void Trace::AddEntry(TraceEntry* entry) {
-  std::lock_guard<simple_spinlock> l(lock_);
-  entry->next = nullptr;
-
-  if (entries_tail_ != nullptr) {
-    entries_tail_->next = entry;
-  } else {
-    DCHECK(entries_head_ == nullptr);
-    entries_head_ = entry;
-    trace_start_time_usec_ = GetCurrentMicrosFast(entry->timestamp);
+  entry->next = entries_head_.load(std::memory_order_relaxed);
+  while (!entries_head_.compare_exchange_weak(
+      entry->next, entry, std::memory_order_release, std::memory_order_relaxed)) {
+  }
+}
+
+void Trace::set_trace_id(uint64_t trace_id) {
+  if (trace_id != 0) {
+    trace_id_.store(trace_id, std::memory_order_relaxed);
+  }
+}
+
+void Trace::MaybeSample() {
+  const auto one_in_n = FLAGS_sampled_trace_1_in_n;
+  if (one_in_n > 0 && !FLAGS_enable_tracing && RandomWithChance(one_in_n)) {
+    // Trace ids only need to be unique among the traces that are around at the same time.
+    set_trace_id(RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max()));
   }
-  entries_tail_ = entry;
 }
 
 void Trace::Dump(std::ostream *out, bool include_time_deltas) const {
-  // Gather a copy of the list of entries under the lock. This is fast
-  // enough that we aren't worried about stalling concurrent tracers
-  // (whereas doing the logging itself while holding the lock might be
-  // too slow, if the output stream is a file, for example).
+  // Entries are linked from the most recent one, so gather them in reverse.
   vector<TraceEntry*> entries;
+  for (TraceEntry* cur = entries_head_.load(std::memory_order_acquire);
+      cur != nullptr;
+      cur = cur->next) {
+    entries.push_back(cur);
+  }
+  std::reverse(entries.begin(), entries.end());
+  const int64_t trace_start_time_usec =
+      entries.empty() ? 0 : GetCurrentMicrosFast(entries.front()->timestamp);
+
   vector<scoped_refptr<Trace> > child_traces;
-  decltype(trace_start_time_usec_) trace_start_time_usec;
   {
     std::lock_guard<simple_spinlock> l(lock_);
-    for (TraceEntry* cur = entries_head_;
-        cur != nullptr;
-        cur = cur->next) {
-      entries.push_back(cur);
-    }
-
     child_traces = child_traces_;
-    trace_start_time_usec = trace_start_time_usec_;
   }
 
+  if (sampled()) {
+    *out << "Trace id: " << trace_id() << std::endl;
+  }
   DoDump(out,
          include_time_deltas,
          trace_start_time_usec,
@@ -351,6 +372,7 @@ void Trace::DumpCurrentTrace() {
 
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
+  child_trace->set_trace_id(trace_id());
   {
     std::lock_guard<simple_spinlock> l(lock_);
     scoped_refptr<Trace> ptr(child_trace);
@@ -57,25 +57,23 @@ DECLARE_bool(enable_tracing);
 // 't' should be a Trace* pointer.
 #define ADOPT_TRACE(t) yb::ScopedAdoptTrace _adopt_trace(t);
 
-// Issue a trace message, if tracing is enabled in the current thread.
+// Issue a trace message, if tracing is enabled or the trace of the current thread is sampled.
 // See Trace::SubstituteAndTrace for arguments.
 // Example:
 //  TRACE("Acquired timestamp $0", timestamp);
 #define TRACE(format, substitutions...) \
   do { \
-    if (FLAGS_enable_tracing) { \
-      yb::Trace* _trace = Trace::CurrentTrace(); \
-      if (_trace) { \
-        _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
-          ##substitutions); \
-      } \
+    yb::Trace* _trace = Trace::CurrentTrace(); \
+    if (_trace && _trace->enabled()) { \
+      _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
+        ##substitutions); \
     } \
   } while (0)
 
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO(trace, format, substitutions...) \
   do { \
-    if (FLAGS_enable_tracing) { \
+    if ((trace)->enabled()) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, MonoTime::Now(), (format), ##substitutions); \
     } \
@@ -84,7 +82,7 @@ DECLARE_bool(enable_tracing);
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO_WITH_TIME(trace, time, format, substitutions...) \
   do { \
-    if (FLAGS_enable_tracing) { \
+    if ((trace)->enabled()) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, (time), (format), ##substitutions); \
     } \
@@ -104,6 +102,11 @@ struct TraceEntry;
 // A trace for a request or other process. This supports collecting trace entries
 // from a number of threads, and later dumping the results to a stream.
 //
+// Entries are collected for all traces when --enable_tracing is set. Otherwise they are only
+// collected for sampled traces, see --sampled_trace_1_in_n. A sampled trace has a non-zero trace
+// id, which is passed on to the traces of the RPCs made on behalf of it, including the ones made
+// to other servers, so that the traces of a sampled request can be found on every server.
+//
 // Callers should generally not add trace messages directly using the public
 // methods of this class. Rather, the TRACE(...) macros defined above should
 // be used such that file/line numbers are automatically included, etc.
@@ -153,8 +156,30 @@ class Trace : public RefCountedThreadSafe<Trace> {
   std::string DumpToString(bool include_time_deltas) const;
 
   // Attaches the given trace which will get appended at the end when Dumping.
+  // The child trace is sampled if this trace is.
   void AddChildTrace(Trace* child_trace);
 
+  // Returns the id of the trace if it is sampled, 0 otherwise.
+  uint64_t trace_id() const {
+    return trace_id_.load(std::memory_order_relaxed);
+  }
+
+  // Makes this a sampled trace with the given id, ignored if it is 0.
+  void set_trace_id(uint64_t trace_id);
+
+  // Marks this trace as sampled with a new trace id, with the chance set by
+  // --sampled_trace_1_in_n. Used by the traces of requests entering the system.
+  void MaybeSample();
+
+  bool sampled() const {
+    return trace_id() != 0;
+  }
+
+  // Whether entries are collected for this trace.
+  bool enabled() const {
+    return FLAGS_enable_tracing || sampled();
+  }
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
@@ -186,14 +211,15 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::atomic<ThreadSafeArena*> arena_ = {nullptr};
 
-  // Lock protecting the entries linked list.
-  mutable simple_spinlock lock_;
-  // The head of the linked list of entries (allocated inside arena_)
-  TraceEntry* entries_head_ = nullptr;
-  // The tail of the linked list of entries (allocated inside arena_)
-  TraceEntry* entries_tail_ = nullptr;
+  // The most recently added entry (allocated inside arena_), linked to the entries added before
+  // it. Entries are pushed without taking a lock, so that threads tracing into the same trace
+  // don't serialize on it.
+  std::atomic<TraceEntry*> entries_head_ = {nullptr};
 
-  int64_t trace_start_time_usec_ = 0;
+  std::atomic<uint64_t> trace_id_ = {0};
+
+  // Lock protecting child_traces_.
+  mutable simple_spinlock lock_;
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
@@ -208,6 +234,7 @@ typedef scoped_refptr<Trace> TracePtr;
 // on the same thread)
 class ScopedAdoptTrace {
  public:
+  // Does nothing unless tracing is enabled, 't' is sampled or another trace is adopted already.
   explicit ScopedAdoptTrace(Trace* t);
   ~ScopedAdoptTrace();
 
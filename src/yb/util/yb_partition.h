@@ -19,6 +19,7 @@
 #include <string>
 #include "yb/util/status.h"
 #include "yb/gutil/endian.h"
+#include "yb/gutil/hash/jenkins.h"
 
 namespace yb {
 
@@ -46,12 +47,15 @@ class YBPartition {
     return std::to_string(cql_hash_code);
   }
 
-  static void AppendBytesToKey(const char *bytes, size_t len, string *encoded_key) {
+  // The functions appending to a key take any buffer with the append() of std::string, e.g.
+  // a HashBuilder that hashes the key without building it.
+  template<typename Buffer>
+  static void AppendBytesToKey(const char *bytes, size_t len, Buffer *encoded_key) {
     encoded_key->append(bytes, len);
   }
 
-  template<typename signed_type, typename unsigned_type>
-  static void AppendIntToKey(signed_type val, string *encoded_key) {
+  template<typename signed_type, typename unsigned_type, typename Buffer>
+  static void AppendIntToKey(signed_type val, Buffer *encoded_key) {
     unsigned_type& uval = reinterpret_cast<unsigned_type&>(val);
     switch (sizeof(uval)) {
       case 1:
@@ -79,10 +83,32 @@ class YBPartition {
     // At the moment, Jenkins' hash is the only method we are using. In the future, we'll keep this
     // as the default hashing behavior. Constant 'kseed" cannot be changed as it'd yield a different
     // hashing result.
-    static const int kseed = 97;
-    const uint64_t hash_value = Hash64StringWithSeed(compound, kseed);
+    return HashValueToHashCode(Hash64StringWithSeed(compound, kseed));
+  }
+
+  // Computes HashColumnCompoundValue() of the concatenation of the appended values, without
+  // building the concatenation.
+  class HashBuilder {
+   public:
+    HashBuilder() : hasher_(kseed) {}
 
-    // Convert the 64-bit hash value to 16 bit integer.
+    void append(const char *bytes, size_t len) {
+      hasher_.append(bytes, len);
+    }
+
+    uint16_t Finish() const {
+      return HashValueToHashCode(hasher_.Finish());
+    }
+
+   private:
+    Hash64StringWithSeedBuilder hasher_;
+  };
+
+ private:
+  static const int kseed = 97;
+
+  // Converts the 64-bit hash value to 16 bit integer.
+  static uint16_t HashValueToHashCode(uint64_t hash_value) {
     const uint64_t h1 = hash_value >> 48;
     const uint64_t h2 = 3 * (hash_value >> 32);
     const uint64_t h3 = 5 * (hash_value >> 16);
@@ -90,7 +116,6 @@ class YBPartition {
 
     return (h1 ^ h2 ^ h3 ^ h4) & 0xffff;
   }
-
 };
 
 } // namespace yb
@@ -118,7 +118,7 @@ Status CQLMessage::QueryParameters::GetBindVariable(const std::string& name,
         return STATUS_SUBSTITUTE(
             RuntimeError, "Unsupported datatype $0", static_cast<int>(type->main()));
       }
-      Slice data(v->value);
+      Slice data = v->value;
       return value->Deserialize(type, YQL_CLIENT_CQL, &data);
     }
     case Value::Kind::IS_NULL:
@@ -340,6 +340,9 @@ bool CQLRequest::ParseRequest(
     return false;
   }
 
+  // The request keeps the uncompressed body alive since the values parsed from it point into it.
+  (*request)->body_buffer_ = std::move(buffer);
+
   // Parse the request body
   const Status status = (*request)->ParseBody();
   if (!status.ok()) {
@@ -480,7 +483,7 @@ Status CQLRequest::ParseValue(const bool with_name, Value* value) {
     value->kind = Value::Kind::NOT_NULL;
     if (length > 0) {
       RETURN_NOT_ENOUGH(length);
-      value->value.assign(to_char_ptr(data), kIntSize + length);
+      value->value = Slice(data, kIntSize + length);
       body_.remove_prefix(length);
       DVLOG(4) << "CQL value bytes " << value->value;
     }
@@ -871,7 +874,7 @@ void SerializeValue(const CQLMessage::Value& value, faststring* mesg) {
   switch (value.kind) {
     case CQLMessage::Value::Kind::NOT_NULL:
       SerializeInt(value.value.size(), mesg);
-      mesg->append(value.value);
+      mesg->append(value.value.data(), value.value.size());
       return;
     case CQLMessage::Value::Kind::IS_NULL:
       SerializeInt(-1, mesg);
@@ -1467,6 +1470,13 @@ void VoidResultResponse::SerializeResultBody(faststring* mesg) const {
 }
 
 //----------------------------------------------------------------------------------------
+namespace {
+
+// Rough size of the rows metadata, which is small compared with the rows of a large page.
+constexpr size_t kRowsMetadataSizeEstimate = 1024;
+
+} // namespace
+
 RowsResultResponse::RowsResultResponse(
     const QueryRequest& request, const ql::RowsResult::SharedPtr& result)
     : ResultResponse(request, Kind::ROWS), result_(result),
@@ -1483,6 +1493,10 @@ RowsResultResponse::~RowsResultResponse() {
 }
 
 void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
+  // The rows data is already in CQL row encoding as returned by the tablet servers and is spliced
+  // in as is. Reserve room for it upfront so that the message is not regrown while appending the
+  // rows of a large page.
+  mesg->reserve(mesg->size() + kRowsMetadataSizeEstimate + result_->rows_data().size());
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
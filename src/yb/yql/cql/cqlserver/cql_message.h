@@ -169,8 +169,11 @@ class CQLMessage {
 
     Kind kind = Kind::NOT_NULL;
     std::string name;
-    std::string value; // As required by QLValue::Deserialize() for CQL, the value includes
-                       // the 4-byte length header, i.e. "<4-byte-length><value>".
+    // As required by QLValue::Deserialize() for CQL, the value includes the 4-byte length
+    // header, i.e. "<4-byte-length><value>". It points into the body of the request it was parsed
+    // from and is only decoded when the bind variable is looked up, so large blobs are not copied
+    // while the request is parsed.
+    Slice value;
   };
 
   // Id of a prepared query for PREPARE, EXECUTE and BATCH requests.
@@ -312,6 +315,9 @@ class CQLRequest : public CQLMessage {
 
  private:
   Slice body_;
+
+  // Uncompressed body of a compressed request. Values parsed from the body point into it.
+  std::unique_ptr<uint8_t[]> body_buffer_;
 };
 
 // ------------------------------ Individual CQL requests -----------------------------------
@@ -114,12 +114,14 @@ CQLMetrics::CQLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity)
 }
 
 //------------------------------------------------------------------------------------------------
-CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListPos& pos)
+CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl, const size_t pool_index,
+                           const CQLProcessorListPos& pos)
     : QLProcessor(
           service_impl->messenger(), service_impl->client(), service_impl->metadata_cache(),
           service_impl->cql_metrics().get(), service_impl->cql_rpc_env()),
       service_impl_(service_impl),
       cql_metrics_(service_impl->cql_metrics()),
+      pool_index_(pool_index),
       pos_(pos),
       statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))) {
 }
@@ -128,7 +130,7 @@ CQLProcessor::~CQLProcessor() {
 }
 
 void CQLProcessor::Return() {
-  service_impl_->ReturnProcessor(pos_);
+  service_impl_->ReturnProcessor(pool_index_, pos_);
 }
 
 void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
@@ -144,7 +146,7 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
                                 &request, &response)) {
     cql_metrics_->num_errors_parsing_cql_->Increment();
     SendResponse(*response);
-    service_impl_->ReturnProcessor(pos_);
+    service_impl_->ReturnProcessor(pool_index_, pos_);
     return;
   }
 
@@ -189,6 +191,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  auto_prepared_stmts_.clear();
   SetCurrentCall(nullptr);
   Return();
 }
@@ -302,7 +305,15 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
-  RunAsync(req.query(), req.params(), statement_executed_cb_);
+  const shared_ptr<const CQLStatement> stmt = GetAutoPreparedStatement(req.query());
+  if (stmt != nullptr) {
+    Status s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
+    if (PREDICT_FALSE(!s.ok())) {
+      StatementExecuted(s);
+    }
+  } else {
+    RunAsync(req.query(), req.params(), statement_executed_cb_);
+  }
   return nullptr;
 }
 
@@ -313,6 +324,9 @@ CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
 
   BeginBatch(statement_executed_cb_);
 
+  // Unprepared statements of the same text are parsed and analyzed only once per batch.
+  std::unordered_map<string, const ql::ParseTree*> parsed_queries;
+
   for (const BatchRequest::Query& query : req.queries()) {
 
     if (query.is_prepared) {
@@ -332,9 +346,22 @@ CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
     } else {
 
       VLOG(1) << "BATCH QUERY " << query.query;
-      ql::ParseTree::UniPtr parse_tree;
-      RunBatch(query.query, query.params, &parse_tree, retry_count > 0);
-      parse_trees_.insert(std::move(parse_tree));
+      const auto itr = parsed_queries.find(query.query);
+      if (itr != parsed_queries.end()) {
+        ExecuteBatch(query.query, *itr->second, query.params);
+      } else if (const auto stmt = GetAutoPreparedStatement(query.query)) {
+        Status s = stmt->ExecuteBatch(this, query.params);
+        if (PREDICT_FALSE(!s.ok())) {
+          StatementExecuted(s);
+        }
+      } else {
+        ql::ParseTree::UniPtr parse_tree;
+        RunBatch(query.query, query.params, &parse_tree, retry_count > 0);
+        if (parse_tree != nullptr) {
+          parsed_queries.emplace(query.query, parse_tree.get());
+        }
+        parse_trees_.insert(std::move(parse_tree));
+      }
 
     }
 
@@ -383,6 +410,36 @@ shared_ptr<const CQLStatement> CQLProcessor::GetPreparedStatement(const CQLMessa
   return stmt;
 }
 
+shared_ptr<const CQLStatement> CQLProcessor::GetAutoPreparedStatement(const string& query) {
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(ql_env_.CurrentKeyspace(), query);
+  shared_ptr<const CQLStatement> stmt = service_impl_->GetPreparedStatement(query_id);
+  if (stmt != nullptr) {
+    stmt->clear_reparsed();
+    auto_prepared_stmts_.insert(stmt);
+    return stmt;
+  }
+  if (!service_impl_->ShouldAutoPrepareStatement(query_id)) {
+    return nullptr;
+  }
+
+  // Prepare the hot statement the same way a PREPARE request does so that it is shared with the
+  // clients preparing it explicitly. Only DML statements are worth keeping in the cache. If the
+  // prepare fails, leave it to the unprepared path to report the error.
+  shared_ptr<CQLStatement> new_stmt = service_impl_->AllocatePreparedStatement(
+      query_id, ql_env_.CurrentKeyspace(), query);
+  PreparedResult::UniPtr result;
+  const Status s = new_stmt->Prepare(this, service_impl_->prepared_stmts_mem_tracker(), &result);
+  if (!s.ok()) {
+    service_impl_->DeletePreparedStatement(new_stmt);
+    return nullptr;
+  }
+  if (result == nullptr) {
+    service_impl_->DeletePreparedStatement(new_stmt);
+  }
+  auto_prepared_stmts_.insert(new_stmt);
+  return new_stmt;
+}
+
 void CQLProcessor::StatementExecuted(const Status& s,
                                      const ql::ExecutedResult::SharedPtr& result) {
   unique_ptr<CQLResponse> response(ProcessResult(s, result));
@@ -403,7 +460,13 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
           ql_errcode == ErrorCode::STALE_METADATA) {
         // Delete all stale prepared statements from our cache. Since CQL protocol allows only one
         // unprepared query id to be returned, we will return just the last unprepared / stale one
-        // we found.
+        // we found. An auto-prepared statement is unknown to the client, so it is just deleted
+        // and the query retried below.
+        for (auto stmt : auto_prepared_stmts_) {
+          if (stmt->stale()) {
+            service_impl_->DeletePreparedStatement(stmt);
+          }
+        }
         for (auto stmt : stmts_) {
           if (stmt->stale()) {
             service_impl_->DeletePreparedStatement(stmt);
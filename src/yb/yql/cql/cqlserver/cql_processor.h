@@ -58,7 +58,7 @@ using CQLProcessorListPos = CQLProcessorList::iterator;
 class CQLProcessor : public ql::QLProcessor {
  public:
   // Constructor and destructor.
-  explicit CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListPos& pos);
+  CQLProcessor(CQLServiceImpl* service_impl, size_t pool_index, const CQLProcessorListPos& pos);
   ~CQLProcessor();
 
   // Processing an inbound call.
@@ -81,6 +81,10 @@ class CQLProcessor : public ql::QLProcessor {
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
+  // Get the cached statement of an unprepared query, preparing and caching it first if the query
+  // is hot. Nullptr will be returned if the query should be run unprepared.
+  std::shared_ptr<const CQLStatement> GetAutoPreparedStatement(const std::string& query);
+
   // Statement executed callback.
   void StatementExecuted(const Status& s, const ql::ExecutedResult::SharedPtr& result = nullptr);
 
@@ -99,7 +103,8 @@ class CQLProcessor : public ql::QLProcessor {
   // CQL metrics.
   std::shared_ptr<CQLMetrics> cql_metrics_;
 
-  // Position in the CQL processor list.
+  // Pool of the CQL processor and position in its processor list.
+  const size_t pool_index_;
   const CQLProcessorListPos pos_;
 
   //----------------------------- StatementExecuted callback and state ---------------------------
@@ -110,6 +115,9 @@ class CQLProcessor : public ql::QLProcessor {
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
+  // Cached statements executing the current unprepared queries.
+  std::unordered_set<std::shared_ptr<const CQLStatement>> auto_prepared_stmts_;
+
   // Current retry count.
   int retry_count_ = 0;
 
@@ -13,10 +13,12 @@
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/sysinfo.h"
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 #include "yb/yql/cql/cqlserver/cql_rpc.h"
@@ -27,11 +29,18 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 
 DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 0,
              "The maximum amount of memory the CQL proxy should use to maintain prepared "
              "statements. 0 or negative means unlimited.");
+DEFINE_int32(cql_auto_prepare_statement_min_hits, 2,
+             "Number of times the same unprepared statement text has to be received by the CQL "
+             "proxy before it is prepared and cached with the prepared statements, so that its "
+             "later executions skip parsing and semantic analysis. 0 disables auto-preparing.");
+TAG_FLAG(cql_auto_prepare_statement_min_hits, advanced);
+TAG_FLAG(cql_auto_prepare_statement_min_hits, runtime);
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
@@ -59,13 +68,17 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts)
           "cql_ybclient", FLAGS_cql_ybclient_reactor_threads, kRpcTimeoutSec,
           server->tserver() ? server->tserver()->permanent_uuid() : "",
           &opts, server->metric_entity()),
-      next_available_processor_(processors_.end()),
+      processor_pools_(base::NumCPUs()),
       messenger_(server->messenger()),
       cql_rpcserver_env_(new CQLRpcServerEnv(server->first_rpc_address().address().to_string(),
                                              opts.broadcast_rpc_address)) {
   // TODO(ENG-446): Handle metrics for all the methods individually.
   cql_metrics_ = std::make_shared<CQLMetrics>(server->metric_entity());
 
+  for (auto& pool : processor_pools_) {
+    pool = std::make_unique<ProcessorPool>();
+  }
+
   // Setup prepared statements' memory tracker. Add garbage-collect function to delete least
   // recently used statements when limit is hit.
   prepared_stmts_mem_tracker_ = MemTracker::CreateTracker(
@@ -131,26 +144,33 @@ void CQLServiceImpl::Handle(yb::rpc::InboundCallPtr inbound_call) {
 }
 
 CQLProcessor *CQLServiceImpl::GetProcessor() {
+  // Threads are assigned to the pools round-robin the first time they handle a call.
+  static std::atomic<size_t> next_thread_index(0);
+  static thread_local const size_t thread_index = next_thread_index++;
+  const size_t pool_index = thread_index % processor_pools_.size();
+  ProcessorPool& pool = *processor_pools_[pool_index];
+
   CQLProcessorListPos pos;
   {
     // Retrieve the next available processor. If none is available, allocate a new slot in the list.
     // Then create the processor outside the mutex below.
-    std::lock_guard<std::mutex> guard(processors_mutex_);
-    pos = (next_available_processor_ != processors_.end() ?
-           next_available_processor_++ : processors_.emplace(processors_.end()));
+    std::lock_guard<std::mutex> guard(pool.mutex);
+    pos = (pool.next_available_processor != pool.processors.end() ?
+           pool.next_available_processor++ : pool.processors.emplace(pool.processors.end()));
   }
 
   if (pos->get() == nullptr) {
-    pos->reset(new CQLProcessor(this, pos));
+    pos->reset(new CQLProcessor(this, pool_index, pos));
   }
   return pos->get();
 }
 
-void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
+void CQLServiceImpl::ReturnProcessor(const size_t pool_index, const CQLProcessorListPos& pos) {
   // Put the processor back before the next available one.
-  std::lock_guard<std::mutex> guard(processors_mutex_);
-  processors_.splice(next_available_processor_, processors_, pos);
-  next_available_processor_ = pos;
+  ProcessorPool& pool = *processor_pools_[pool_index];
+  std::lock_guard<std::mutex> guard(pool.mutex);
+  pool.processors.splice(pool.next_available_processor, pool.processors, pos);
+  pool.next_available_processor = pos;
 }
 
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
@@ -207,6 +227,22 @@ shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
   return stmt;
 }
 
+bool CQLServiceImpl::ShouldAutoPrepareStatement(const CQLMessage::QueryId& query_id) {
+  const int min_hits = FLAGS_cql_auto_prepare_statement_min_hits;
+  if (min_hits <= 0) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(unprepared_stmt_hits_mutex_);
+
+  // The hit counts only need to tell hot statement texts from one-off ones, so just start over
+  // when too many distinct texts have been seen instead of maintaining another LRU.
+  if (unprepared_stmt_hits_.size() >= kMaxTrackedUnpreparedStatements) {
+    unprepared_stmt_hits_.clear();
+  }
+  return ++unprepared_stmt_hits_[query_id] >= min_hits;
+}
+
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
   // Get exclusive lock before deleting the prepared statement.
   std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
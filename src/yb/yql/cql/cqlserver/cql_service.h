@@ -57,8 +57,8 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Processing all incoming request from RPC and sending response back.
   void Handle(yb::rpc::InboundCallPtr call) override;
 
-  // Return CQL processor at pos as available.
-  void ReturnProcessor(const CQLProcessorListPos& pos);
+  // Return CQL processor at pos of the given pool as available.
+  void ReturnProcessor(size_t pool_index, const CQLProcessorListPos& pos);
 
   // Allocate a prepared statement. If the statement already exists, return it instead.
   std::shared_ptr<CQLStatement> AllocatePreparedStatement(
@@ -67,6 +67,10 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Look up a prepared statement by its id. Nullptr will be returned if the statement is not found.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
+  // Record an execution of an unprepared statement and return whether it has been executed often
+  // enough to be prepared and cached with the prepared statements.
+  bool ShouldAutoPrepareStatement(const CQLMessage::QueryId& id);
+
   std::shared_ptr<ql::Statement> GetAuthPreparedStatement() const { return auth_prepared_stmt_; }
 
   // Delete the prepared statement from the cache.
@@ -95,6 +99,9 @@ class CQLServiceImpl : public CQLServerServiceIf {
  private:
   constexpr static int kRpcTimeoutSec = 5;
 
+  // Maximum number of distinct unprepared statements whose hit counts are tracked.
+  constexpr static size_t kMaxTrackedUnpreparedStatements = 10000;
+
   // Either gets an available processor or creates a new one.
   CQLProcessor *GetProcessor();
 
@@ -124,15 +131,21 @@ class CQLServiceImpl : public CQLServerServiceIf {
   mutable std::atomic<bool> is_metadata_initialized_ = { false };
   mutable std::mutex metadata_init_mutex_;
 
-  // List of CQL processors (in-use and available). In-use ones are at the beginning and available
-  // ones at the end.
-  CQLProcessorList processors_;
+  // A pool of CQL processors. Each thread handling calls gets processors from its own pool so that
+  // the threads do not contend on a single lock. A processor is returned to the pool it was taken
+  // from, even when it finishes on another thread.
+  struct ProcessorPool {
+    // List of CQL processors (in-use and available). In-use ones are at the beginning and
+    // available ones at the end.
+    CQLProcessorList processors;
 
-  // Next available CQL processor.
-  CQLProcessorListPos next_available_processor_;
+    // Next available CQL processor.
+    CQLProcessorListPos next_available_processor = processors.end();
 
-  // Mutex that protects access to processors_.
-  std::mutex processors_mutex_;
+    // Mutex that protects access to processors.
+    std::mutex mutex;
+  };
+  std::vector<std::unique_ptr<ProcessorPool>> processor_pools_;
 
   // Prepared statements cache.
   CQLStatementMap prepared_stmts_map_;
@@ -143,6 +156,11 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Mutex that protects the prepared statements and the LRU list.
   std::mutex prepared_stmts_mutex_;
 
+  // Number of times each unprepared statement has been received, to find the hot ones to
+  // auto-prepare, and the mutex that protects it.
+  std::unordered_map<CQLMessage::QueryId, int> unprepared_stmt_hits_;
+  std::mutex unprepared_stmt_hits_mutex_;
+
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
   // Tracker to measure and limit memory usage of prepared statements.
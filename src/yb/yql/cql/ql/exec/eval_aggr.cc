@@ -44,7 +44,9 @@ CHECKED_STATUS Executor::AggregateResultSets() {
       case TSOpcode::kNoOp:
         break;
       case TSOpcode::kAvg:
-        RETURN_NOT_OK(STATUS(NotSupported, "Function AVG() not yet supported"));
+        // AVG() is read as its SUM() and COUNT() partials, see AvgExprToPB().
+        RETURN_NOT_OK(EvalAvg(row_block, column_index, expr_node->ql_type()->main(), &ql_value));
+        column_index++;
         break;
       case TSOpcode::kCount:
         RETURN_NOT_OK(EvalCount(row_block, column_index, &ql_value));
@@ -67,8 +69,44 @@ CHECKED_STATUS Executor::AggregateResultSets() {
     column_index++;
   }
 
-  // Change the result set to the aggregate result.
-  std::static_pointer_cast<RowsResult>(result_)->set_rows_data(buffer.c_str(), buffer.size());
+  // Change the result set to the aggregate result. The columns read may differ from the selected
+  // ones when there are AVG() partials.
+  rows->set_rows_data(buffer.c_str(), buffer.size());
+  rows->set_column_schemas(pt_select->selected_schemas());
+  return Status::OK();
+}
+
+CHECKED_STATUS Executor::AvgExprToPB(const PTExpr::SharedPtr& expr, QLReadRequestPB *req) {
+  // Read AVG() as SUM() and COUNT() of its argument so that the partial results of the tablets
+  // can be merged. They take two consecutive columns in the result set.
+  QLExpressionPB *sum_pb = req->add_selected_exprs();
+  RETURN_NOT_OK(PTExprToPB(expr, sum_pb));
+  if (!sum_pb->has_tscall()) {
+    return STATUS(NotSupported, "Function AVG() with result conversion not yet supported");
+  }
+  switch (expr->ql_type()->main()) {
+    case DataType::INT8: FALLTHROUGH_INTENDED;
+    case DataType::INT16: FALLTHROUGH_INTENDED;
+    case DataType::INT32: FALLTHROUGH_INTENDED;
+    case DataType::INT64: FALLTHROUGH_INTENDED;
+    case DataType::FLOAT: FALLTHROUGH_INTENDED;
+    case DataType::DOUBLE:
+      break;
+    default:
+      return STATUS(NotSupported, "Function AVG() of this datatype not yet supported");
+  }
+  sum_pb->mutable_tscall()->set_opcode(static_cast<int32_t>(TSOpcode::kSum));
+  QLExpressionPB *count_pb = req->add_selected_exprs();
+  *count_pb = *sum_pb;
+  count_pb->mutable_tscall()->set_opcode(static_cast<int32_t>(TSOpcode::kCount));
+
+  QLRSRowDescPB *rsrow_desc_pb = req->mutable_rsrow_desc();
+  QLRSColDescPB *rscol_desc_pb = rsrow_desc_pb->add_rscol_descs();
+  rscol_desc_pb->set_name(expr->QLName());
+  expr->ql_type()->ToQLTypePB(rscol_desc_pb->mutable_ql_type());
+  rscol_desc_pb = rsrow_desc_pb->add_rscol_descs();
+  rscol_desc_pb->set_name(expr->QLName());
+  QLType::Create(DataType::INT64)->ToQLTypePB(rscol_desc_pb->mutable_ql_type());
   return Status::OK();
 }
 
@@ -151,5 +189,42 @@ CHECKED_STATUS Executor::EvalSum(const shared_ptr<QLRowBlock>& row_block,
   return Status::OK();
 }
 
+CHECKED_STATUS Executor::EvalAvg(const shared_ptr<QLRowBlock>& row_block,
+                                 int column_index,
+                                 DataType data_type,
+                                 QLValue *ql_value) {
+  QLValue sum;
+  QLValue count;
+  RETURN_NOT_OK(EvalSum(row_block, column_index, data_type, &sum));
+  RETURN_NOT_OK(EvalCount(row_block, column_index + 1, &count));
+  if (sum.IsNull() || count.int64_value() == 0) {
+    return Status::OK();
+  }
+  const int64_t n = count.int64_value();
+  switch (data_type) {
+    case DataType::INT8:
+      ql_value->set_int8_value(sum.int8_value() / n);
+      break;
+    case DataType::INT16:
+      ql_value->set_int16_value(sum.int16_value() / n);
+      break;
+    case DataType::INT32:
+      ql_value->set_int32_value(sum.int32_value() / n);
+      break;
+    case DataType::INT64:
+      ql_value->set_int64_value(sum.int64_value() / n);
+      break;
+    case DataType::FLOAT:
+      ql_value->set_float_value(sum.float_value() / n);
+      break;
+    case DataType::DOUBLE:
+      ql_value->set_double_value(sum.double_value() / n);
+      break;
+    default:
+      return STATUS(RuntimeError, "Unexpected datatype for argument of AVG()");
+  }
+  return Status::OK();
+}
+
 }  // namespace ql
 }  // namespace yb
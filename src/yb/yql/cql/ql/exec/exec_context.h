@@ -20,6 +20,7 @@
 #ifndef YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 #define YB_YQL_CQL_QL_EXEC_EXEC_CONTEXT_H_
 
+#include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ptree/process_context.h"
 #include "yb/yql/cql/ql/util/ql_env.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -201,6 +202,20 @@ class ExecContext : public ProcessContextBase {
     return ql_env_->Apply(op);
   }
 
+  // Apply one of the read operations of a select whose token range is read in parallel.
+  CHECKED_STATUS ApplyParallel(std::shared_ptr<client::YBqlReadOp> op) {
+    parallel_ops_.push_back(op);
+    return ql_env_->Apply(std::move(op));
+  }
+
+  // Access function for the parallel read operations applied in the current flush.
+  const std::vector<std::shared_ptr<client::YBqlReadOp>>& parallel_ops() const {
+    return parallel_ops_;
+  }
+  std::vector<std::shared_ptr<client::YBqlReadOp>>* mutable_parallel_ops() {
+    return &parallel_ops_;
+  }
+
   bool SelectingAggregate();
 
   // Variants of ProcessContextBase::Error() that report location of statement tnode as the error
@@ -223,6 +238,9 @@ class ExecContext : public ProcessContextBase {
   // Read/write operation to execute.
   std::shared_ptr<client::YBqlOp> op_;
 
+  // Read operations of a select whose token range is read in parallel, used instead of op_.
+  std::vector<std::shared_ptr<client::YBqlReadOp>> parallel_ops_;
+
   // Execution start time.
   const MonoTime start_time_;
 
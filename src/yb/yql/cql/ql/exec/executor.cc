@@ -20,8 +20,15 @@
 #include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/common/common.pb.h"
 
+DEFINE_int32(cql_parallel_aggregate_scan_ranges, 16,
+             "Number of token ranges a SELECT of aggregates over the whole table is split into and "
+             "read in parallel. 1 or less reads the table one tablet at a time.");
+TAG_FLAG(cql_parallel_aggregate_scan_ranges, advanced);
+TAG_FLAG(cql_parallel_aggregate_scan_ranges, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -569,6 +576,11 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
   for (const auto& expr : tnode->selected_exprs()) {
     if (expr->opcode() == TreeNodeOpcode::kPTAllColumns) {
       st = PTExprToPB(static_cast<const PTAllColumns*>(expr.get()), req);
+    } else if (expr->aggregate_opcode() == bfql::TSOpcode::kAvg) {
+      st = AvgExprToPB(expr, req);
+      if (PREDICT_FALSE(!st.ok())) {
+        return exec_context_->Error(st, ErrorCode::INVALID_ARGUMENTS);
+      }
     } else {
       st = PTExprToPB(expr, req->add_selected_exprs());
       if (PREDICT_FALSE(!st.ok())) {
@@ -660,11 +672,73 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     }
   }
 
+  // Aggregates over the whole table do not need the rows in order, so read the table in parallel.
+  if (tnode->is_aggregate() && !tnode->is_system() && !continue_select &&
+      req->hashed_column_values().empty() && exec_context_->UnreadPartitionsRemaining() == 0 &&
+      FLAGS_cql_parallel_aggregate_scan_ranges > 1) {
+    return ApplyParallelSelect(table, select_op);
+  }
+
   // Apply the operator.
   return exec_context_->Apply(select_op);
 }
 
+Status Executor::ApplyParallelSelect(const shared_ptr<YBTable>& table,
+                                     const shared_ptr<YBqlReadOp>& select_op) {
+  // Split the token range of the select into equal subranges and read each of them with its own
+  // op. An op whose subrange spans several tablets continues to the next tablet in
+  // FetchMoreRowsIfNeeded(), so the subranges need not match the tablet boundaries.
+  const QLReadRequestPB& req = select_op->request();
+  const int64_t lower = req.has_hash_code() ? req.hash_code() : 0;
+  const int64_t upper = req.has_max_hash_code() ? req.max_hash_code()
+                                                : PartitionSchema::kMaxPartitionKey;
+  if (lower > upper) {
+    return exec_context_->Apply(select_op);
+  }
+  const int64_t span = upper - lower + 1;
+  const int64_t ranges = std::min<int64_t>(FLAGS_cql_parallel_aggregate_scan_ranges, span);
+  for (int64_t i = 0; i < ranges; ++i) {
+    shared_ptr<YBqlReadOp> op(table->NewQLSelect());
+    *op->mutable_request() = req;
+    op->mutable_request()->set_hash_code(static_cast<int32_t>(lower + span * i / ranges));
+    op->mutable_request()->set_max_hash_code(
+        static_cast<int32_t>(lower + span * (i + 1) / ranges - 1));
+    op->set_yb_consistency_level(select_op->yb_consistency_level());
+    RETURN_NOT_OK(exec_context_->ApplyParallel(std::move(op)));
+  }
+  return Status::OK();
+}
+
+Status Executor::FetchMoreParallelRows() {
+  // Continue the ops that have not reached the end of their token ranges yet.
+  auto* ops = exec_context_->mutable_parallel_ops();
+  std::vector<shared_ptr<YBqlReadOp>> unfinished_ops;
+  for (auto& op : *ops) {
+    if (!op->response().has_paging_state()) {
+      continue;
+    }
+    QLPagingStatePB *paging_state = op->mutable_request()->mutable_paging_state();
+    paging_state->set_next_partition_key(op->response().paging_state().next_partition_key());
+    paging_state->set_next_row_key(op->response().paging_state().next_row_key());
+    unfinished_ops.push_back(std::move(op));
+  }
+  ops->clear();
+  for (auto& op : unfinished_ops) {
+    RETURN_NOT_OK(exec_context_->ApplyParallel(std::move(op)));
+  }
+
+  // The paging states are internal to the parallel ops, the client gets the whole result.
+  if (result_ != nullptr) {
+    std::static_pointer_cast<RowsResult>(result_)->clear_paging_state();
+  }
+  return Status::OK();
+}
+
 Status Executor::FetchMoreRowsIfNeeded() {
+  if (!exec_context_->parallel_ops().empty()) {
+    return FetchMoreParallelRows();
+  }
+
   if (result_ == nullptr) {
     return Status::OK();
   }
@@ -1064,26 +1138,35 @@ Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context
   return op->rows_data().empty() ? Status::OK() : AppendResult(std::make_shared<RowsResult>(op));
 }
 
+Status Executor::ProcessAsyncResult(client::YBqlOp* op, ExecContext* exec_context) {
+  Status s = ql_env_->GetOpError(op);
+  if (PREDICT_FALSE(!s.ok())) {
+    // YBOperation returns not-found error when the tablet is not found.
+    const auto error_code =
+        s.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
+    s = exec_context->Error(s, error_code);
+  }
+  if (s.ok()) {
+    s = ProcessOpResponse(op, exec_context);
+  }
+  return ProcessStatementStatus(*exec_context->parse_tree(), s);
+}
+
 Status Executor::ProcessAsyncResults() {
   Status s, ss;
   for (auto& exec_context : exec_contexts_) {
     client::YBqlOp* op = exec_context.op().get();
-    if (op == nullptr) {
-      continue; // Skip empty op.
-    }
-    ss = ql_env_->GetOpError(op);
-    if (PREDICT_FALSE(!ss.ok())) {
-      // YBOperation returns not-found error when the tablet is not found.
-      const auto error_code =
-          ss.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
-      ss = exec_context.Error(ss, error_code);
-    }
-    if (ss.ok()) {
-      ss = ProcessOpResponse(op, &exec_context);
+    if (op != nullptr) {
+      ss = ProcessAsyncResult(op, &exec_context);
+      if (PREDICT_FALSE(!ss.ok())) {
+        s = ss;
+      }
     }
-    ss = ProcessStatementStatus(*exec_context.parse_tree(), ss);
-    if (PREDICT_FALSE(!ss.ok())) {
-      s = ss;
+    for (const auto& parallel_op : exec_context.parallel_ops()) {
+      ss = ProcessAsyncResult(parallel_op.get(), &exec_context);
+      if (PREDICT_FALSE(!ss.ok())) {
+        s = ss;
+      }
     }
   }
   return s;
@@ -154,6 +154,7 @@ class Executor : public QLExprExecutor {
 
   // Process result of FlushAsyncDone.
   CHECKED_STATUS ProcessAsyncResults();
+  CHECKED_STATUS ProcessAsyncResult(client::YBqlOp* op, ExecContext* exec_context);
 
   // Append execution result.
   CHECKED_STATUS AppendResult(const RowsResult::SharedPtr& result);
@@ -161,6 +162,12 @@ class Executor : public QLExprExecutor {
   // Continue a multi-partition select (e.g. table scan or query with 'IN' condition on hash cols).
   CHECKED_STATUS FetchMoreRowsIfNeeded();
 
+  // Read the token range of a select in parallel subranges, and continue the subranges not read
+  // to the end yet.
+  CHECKED_STATUS ApplyParallelSelect(const std::shared_ptr<client::YBTable>& table,
+                                     const std::shared_ptr<client::YBqlReadOp>& select_op);
+  CHECKED_STATUS FetchMoreParallelRows();
+
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets();
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
@@ -176,6 +183,14 @@ class Executor : public QLExprExecutor {
                          int column_index,
                          DataType data_type,
                          QLValue *ql_value);
+  // Evaluate AVG() from its SUM() and COUNT() partials at column_index and column_index + 1.
+  CHECKED_STATUS EvalAvg(const std::shared_ptr<QLRowBlock>& row_block,
+                         int column_index,
+                         DataType data_type,
+                         QLValue *ql_value);
+
+  // Add the partials to read for an AVG() expression to the read request.
+  CHECKED_STATUS AvgExprToPB(const PTExpr::SharedPtr& expr, QLReadRequestPB *req);
 
   // Reset execution state.
   void Reset();
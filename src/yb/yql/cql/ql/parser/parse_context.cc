@@ -34,8 +34,10 @@ using std::string;
 ParseContext::ParseContext(const char *stmt,
                            size_t stmt_len,
                            const bool reparsed,
-                           shared_ptr<MemTracker> mem_tracker)
-    : ProcessContext(stmt, stmt_len, ParseTree::UniPtr(new ParseTree(reparsed, mem_tracker))),
+                           shared_ptr<MemTracker> mem_tracker,
+                           Arena *ptemp_mem)
+    : ProcessContext(stmt, stmt_len, ParseTree::UniPtr(new ParseTree(reparsed, mem_tracker)),
+                     ptemp_mem),
       bind_variables_(PTreeMem()),
       stmt_offset_(0),
       trace_scanning_(false),
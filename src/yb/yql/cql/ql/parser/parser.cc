@@ -42,10 +42,14 @@ Parser::~Parser() {
 CHECKED_STATUS Parser::Parse(const string& ql_stmt,
                              const bool reparsed,
                              shared_ptr<MemTracker> mem_tracker) {
+  // Destroy the previous context before its temporary memory is reused.
+  parse_context_ = nullptr;
+  ptemp_mem_.Reset();
   parse_context_ = ParseContext::UniPtr(new ParseContext(ql_stmt.c_str(),
                                                          ql_stmt.length(),
                                                          reparsed,
-                                                         mem_tracker));
+                                                         mem_tracker,
+                                                         &ptemp_mem_));
   lex_processor_.ScanInit(parse_context());
   gram_processor_.set_debug_level(parse_context_->trace_parsing());
 
@@ -104,6 +104,9 @@ class Parser {
 
  private:
   //------------------------------------------------------------------------------------------------
+  // Temporary memory pool of the parse context, reset and reused for each statement parsed.
+  Arena ptemp_mem_;
+
   // Parse context which consists of state variables and results.
   // NOTE: parse context must be FIRST class field to be destroyed by the class destructor
   //       after all other dependent class fields (e.g. processors below).
@@ -589,7 +589,8 @@ using namespace yb::ql;
                           HANDLER HAVING HEADER_P HOLD HOUR_P
 
                           IDENTITY_P IF_P ILIKE IMMEDIATE IMMUTABLE IMPLICIT_P IMPORT_P IN_P
-                          INCLUDING INCREMENT INDEX INDEXES INET INFINITY INHERIT INHERITS
+                          INCLUDE INCLUDING INCREMENT INDEX INDEXES INET INFINITY INHERIT
+                          INHERITS
                           INITIALLY INLINE_P INNER_P INOUT INPUT_P INSENSITIVE INSERT INSTEAD
                           INT_P INTEGER INTERSECT INTERVAL INTO INVOKER IS ISNULL ISOLATION
 
@@ -4884,6 +4885,7 @@ unreserved_keyword:
   | IMMUTABLE { $$ = $1; }
   | IMPLICIT_P { $$ = $1; }
   | IMPORT_P { $$ = $1; }
+  | INCLUDE { $$ = $1; }
   | INCLUDING { $$ = $1; }
   | INCREMENT { $$ = $1; }
   | INDEX { $$ = $1; }
@@ -7943,6 +7945,9 @@ opt_covering_clause:
   | COVERING '(' columnList ')' {
     $$ = $3;
   }
+  | INCLUDE '(' columnList ')' {
+    $$ = $3;
+  }
 ;
 
 /*
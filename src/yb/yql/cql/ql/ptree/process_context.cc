@@ -28,9 +28,10 @@ using std::string;
 // ProcessContextBase
 //--------------------------------------------------------------------------------------------------
 
-ProcessContextBase::ProcessContextBase(const char *stmt, size_t stmt_len)
+ProcessContextBase::ProcessContextBase(const char *stmt, size_t stmt_len, Arena *ptemp_mem)
     : stmt_(stmt),
       stmt_len_(stmt_len),
+      ptemp_mem_(ptemp_mem),
       error_code_(ErrorCode::SUCCESS) {
 }
 
@@ -233,8 +234,9 @@ CHECKED_STATUS ProcessContextBase::Error(const TreeNode::SharedPtr& tnode,
 
 ProcessContext::ProcessContext(const char *stmt,
                                size_t stmt_len,
-                               ParseTree::UniPtr parse_tree)
-    : ProcessContextBase(stmt, stmt_len),
+                               ParseTree::UniPtr parse_tree,
+                               Arena *ptemp_mem)
+    : ProcessContextBase(stmt, stmt_len, ptemp_mem),
       parse_tree_(std::move(parse_tree)) {
 }
 
@@ -41,8 +41,9 @@ class ProcessContextBase {
   typedef std::unique_ptr<const ProcessContextBase> UniPtrConst;
 
   //------------------------------------------------------------------------------------------------
-  // Constructor & destructor.
-  ProcessContextBase(const char *stmt, size_t stmt_len);
+  // Constructor & destructor. When given, 'ptemp_mem' is used as the temporary memory pool. It is
+  // owned by the caller, which may reset it for reuse once this context is destroyed.
+  ProcessContextBase(const char *stmt, size_t stmt_len, Arena *ptemp_mem = nullptr);
   virtual ~ProcessContextBase();
 
   // Handling parsing warning.
@@ -68,9 +69,10 @@ class ProcessContextBase {
   // Memory pool for allocating and deallocating operating memory spaces during a process.
   MemoryContext *PTempMem() const {
     if (ptemp_mem_ == nullptr) {
-      ptemp_mem_.reset(new Arena());
+      owned_ptemp_mem_.reset(new Arena());
+      ptemp_mem_ = owned_ptemp_mem_.get();
     }
-    return ptemp_mem_.get();
+    return ptemp_mem_;
   }
 
   // Access function for stmt_.
@@ -105,8 +107,9 @@ class ProcessContextBase {
   // completed.
   //
   // For performance, the temp arena and the error message that depends on it are created only when
-  // needed.
-  mutable std::unique_ptr<Arena> ptemp_mem_;
+  // needed, unless the arena is provided by the caller.
+  mutable Arena *ptemp_mem_;
+  mutable std::unique_ptr<Arena> owned_ptemp_mem_;
 
   // Latest parsing or scanning error code.
   ErrorCode error_code_;
@@ -126,7 +129,8 @@ class ProcessContext : public ProcessContextBase {
 
   //------------------------------------------------------------------------------------------------
   // Constructor & destructor.
-  ProcessContext(const char *stmt, size_t stmt_len, ParseTree::UniPtr parse_tree);
+  ProcessContext(const char *stmt, size_t stmt_len, ParseTree::UniPtr parse_tree,
+                 Arena *ptemp_mem = nullptr);
   virtual ~ProcessContext();
 
   // Saves the generated parse tree from the parsing process to this context.
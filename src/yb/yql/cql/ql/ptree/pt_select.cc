@@ -18,11 +18,22 @@
 #include "yb/yql/cql/ql/ptree/pt_select.h"
 
 #include <functional>
+#include <unordered_set>
 
 #include "yb/client/client.h"
 
+#include "yb/util/flag_tags.h"
+
 #include "yb/yql/cql/ql/ptree/sem_context.h"
 
+DEFINE_bool(cql_read_from_covering_index, false,
+            "Answer SELECTs from a covering secondary index of the table, without reading the "
+            "table, when the index has all the referenced columns. Indexes have entries only for "
+            "the rows written since their creation, so only enable it for indexes created "
+            "before their tables were loaded.");
+TAG_FLAG(cql_read_from_covering_index, advanced);
+TAG_FLAG(cql_read_from_covering_index, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -99,7 +110,7 @@ CHECKED_STATUS PTSelectStmt::Analyze(SemContext *sem_context) {
   RETURN_NOT_OK(from_clause_->Analyze(sem_context));
 
   // Collect table's schema for semantic analysis.
-  Status s = LookupTable(sem_context);
+  Status s = LookupTableOrCoveringIndex(sem_context);
   if (PREDICT_FALSE(!s.ok())) {
     // If it is a system table and it does not exist, do not analyze further. We will return
     // void result when the SELECT statement is executed.
@@ -154,6 +165,102 @@ void PTSelectStmt::PrintSemanticAnalysisResult(SemContext *sem_context) {
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Collects the columns referenced by a WHERE clause made of ANDed "<column> <op> <value>"
+// conditions, and those compared for equality. Returns false for any other form of condition.
+bool CollectWhereColumns(const PTExpr& expr,
+                         std::unordered_set<string>* referenced_columns,
+                         std::unordered_set<string>* equal_columns) {
+  if (expr.expr_op() == ExprOperator::kLogic2 && expr.ql_op() == QL_OP_AND) {
+    return CollectWhereColumns(*expr.op1(), referenced_columns, equal_columns) &&
+           CollectWhereColumns(*expr.op2(), referenced_columns, equal_columns);
+  }
+  if (expr.expr_op() != ExprOperator::kRelation2 ||
+      expr.op1()->expr_op() != ExprOperator::kRef ||
+      (!expr.op2()->is_constant() && expr.op2()->expr_op() != ExprOperator::kBindVar)) {
+    return false;
+  }
+  const string name = static_cast<const PTRef&>(*expr.op1()).name()->QLName();
+  referenced_columns->insert(name);
+  if (expr.ql_op() == QL_OP_EQUAL) {
+    equal_columns->insert(name);
+  }
+  return true;
+}
+
+} // namespace
+
+CHECKED_STATUS PTSelectStmt::LookupTableOrCoveringIndex(SemContext *sem_context) {
+  // Only plain selects of columns, filtered by simple conditions, are answered from an index.
+  const client::YBTableName name = table_name();
+  if (!FLAGS_cql_read_from_covering_index || name.is_system() || distinct_ ||
+      where_clause_ == nullptr || order_by_clause_ != nullptr) {
+    return LookupTable(sem_context);
+  }
+  std::unordered_set<string> referenced_columns, equal_columns;
+  for (const auto& expr : selected_exprs_->node_list()) {
+    if (expr->opcode() != TreeNodeOpcode::kPTRef) {
+      return LookupTable(sem_context);
+    }
+    referenced_columns.insert(static_cast<const PTRef&>(*expr).name()->QLName());
+  }
+  if (!CollectWhereColumns(*where_clause_, &referenced_columns, &equal_columns)) {
+    return LookupTable(sem_context);
+  }
+
+  // The table is read directly if the hash key is given.
+  const auto table = sem_context->GetTableDesc(name);
+  if (table == nullptr || table->index_map().empty()) {
+    return LookupTable(sem_context);
+  }
+  const YBSchema& schema = table->schema();
+  bool has_hash_key = true;
+  for (size_t idx = 0; idx < schema.num_hash_key_columns(); idx++) {
+    has_hash_key = has_hash_key && equal_columns.count(schema.Column(idx).name()) > 0;
+  }
+  if (has_hash_key) {
+    return LookupTable(sem_context);
+  }
+
+  // Index tables have the same column names as the indexed table, so the query is analyzed as is
+  // against the index table.
+  for (const auto& index : table->index_map()) {
+    const auto index_table = sem_context->GetTableDesc(index.first);
+    if (index_table == nullptr) {
+      continue;
+    }
+    const YBSchema& index_schema = index_table->schema();
+    std::unordered_set<string> index_columns;
+    bool has_index_hash_key = true;
+    for (size_t idx = 0; idx < index_schema.num_columns(); idx++) {
+      const string column_name = index_schema.Column(idx).name();
+      index_columns.insert(column_name);
+      if (idx < index_schema.num_hash_key_columns()) {
+        has_index_hash_key = has_index_hash_key && equal_columns.count(column_name) > 0;
+      }
+    }
+    if (!has_index_hash_key) {
+      continue;
+    }
+    bool covered = true;
+    for (const auto& column_name : referenced_columns) {
+      covered = covered && index_columns.count(column_name) > 0;
+    }
+    if (covered) {
+      VLOG(3) << "Reading " << name.ToString() << " from covering index "
+              << index_table->name().ToString();
+      return sem_context->LookupTable(index_table->name(), table_loc(), false /* write_table */,
+                                      &table_, &is_system_, &table_columns_, &num_key_columns_,
+                                      &num_hash_key_columns_, nullptr /* column_definitions */,
+                                      true /* allow_index_table */);
+    }
+  }
+  return LookupTable(sem_context);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 CHECKED_STATUS PTSelectStmt::AnalyzeDistinctClause(SemContext *sem_context) {
   // Only partition and static columns are allowed to be used with distinct clause.
   int key_count = 0;
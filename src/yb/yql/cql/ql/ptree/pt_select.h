@@ -247,6 +247,10 @@ class PTSelectStmt : public PTDmlStmt {
 
  private:
 
+  // Looks up the table to read or, when there is one, a covering index of it that has all the
+  // columns the query references, including the hash columns of the index in equality conditions.
+  CHECKED_STATUS LookupTableOrCoveringIndex(SemContext *sem_context);
+
   CHECKED_STATUS AnalyzeDistinctClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeOrderByClause(SemContext *sem_context);
   CHECKED_STATUS AnalyzeLimitClause(SemContext *sem_context);
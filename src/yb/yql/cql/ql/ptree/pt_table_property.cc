@@ -452,7 +452,30 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
     return STATUS(InvalidArgument, Substitute("$0 is not a valid table property", lhs_->c_str()));
   }
   switch (iterator->second) {
-    case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
+    case PropertyMapType::kCaching:
+      // Only the priority is used, 'keys' and 'rows_per_partition' have no equivalent here.
+      for (const auto& subproperty : map_elements_->node_list()) {
+        string subproperty_name;
+        ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+        if (subproperty_name == common::kCachingInMemory) {
+          bool in_memory = false;
+          RETURN_NOT_OK(GetBoolValueFromExpr(subproperty->rhs(), subproperty_name, &in_memory));
+          table_property->SetInMemory(in_memory);
+          continue;
+        }
+        if (subproperty_name != common::kCachingPriority) {
+          continue;
+        }
+        string str_val;
+        CachePriority priority;
+        RETURN_NOT_OK(GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name,
+                                             &str_val));
+        if (!common::ParseCachingPriorityString(str_val, &priority)) {
+          return STATUS(InvalidArgument, Substitute("Invalid caching priority '$0'", str_val));
+        }
+        table_property->SetCachePriority(priority);
+      }
+      break;
     case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
     case PropertyMapType::kCompression:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
@@ -676,10 +699,22 @@ Status PTTablePropertyMap::AnalyzeCaching() {
       return STATUS(InvalidArgument, Substitute("Invalid value for caching sub-option '$0': only "
           "'$1', '$2' and integer values are allowed", common::kCachingRowsPerPartition,
           common::kCachingAll, common::kCachingNone));
+    } else if (subproperty_name == common::kCachingPriority) {
+      CachePriority priority;
+      RETURN_NOT_OK(GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name, &str_val));
+      if (common::ParseCachingPriorityString(str_val, &priority)) {
+        continue;
+      }
+      return STATUS(InvalidArgument, Substitute("Invalid value for caching sub-option '$0': only "
+          "'high', 'normal' and 'low' are allowed", common::kCachingPriority));
+    } else if (subproperty_name == common::kCachingInMemory) {
+      bool in_memory;
+      RETURN_NOT_OK(GetBoolValueFromExpr(subproperty->rhs(), subproperty_name, &in_memory));
+      continue;
     }
-    return STATUS(InvalidArgument, Substitute("Invalid caching sub-options $0: only '$1' and "
-        "'$2' are allowed", subproperty_name, common::kCachingKeys,
-        common::kCachingRowsPerPartition));
+    return STATUS(InvalidArgument, Substitute("Invalid caching sub-options $0: only '$1', '$2', "
+        "'$3' and '$4' are allowed", subproperty_name, common::kCachingKeys,
+        common::kCachingRowsPerPartition, common::kCachingPriority, common::kCachingInMemory));
   }
   return Status::OK();
 }
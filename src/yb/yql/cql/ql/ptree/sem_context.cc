@@ -36,8 +36,9 @@ using client::YBSchema;
 SemContext::SemContext(const char *ql_stmt,
                        size_t stmt_len,
                        ParseTree::UniPtr parse_tree,
-                       QLEnv *ql_env)
-    : ProcessContext(ql_stmt, stmt_len, std::move(parse_tree)),
+                       QLEnv *ql_env,
+                       Arena *ptemp_mem)
+    : ProcessContext(ql_stmt, stmt_len, std::move(parse_tree), ptemp_mem),
       symtab_(PTempMem()),
       ql_env_(ql_env),
       cache_used_(false),
@@ -59,7 +60,8 @@ Status SemContext::LookupTable(const YBTableName& name,
                                MCVector<ColumnDesc>* col_descs,
                                int* num_key_columns,
                                int* num_hash_key_columns,
-                               MCVector<PTColumnDefinition::SharedPtr>* column_definitions) {
+                               MCVector<PTColumnDefinition::SharedPtr>* column_definitions,
+                               const bool allow_index_table) {
   *is_system = name.is_system();
   if (*is_system && write_table && client::FLAGS_yb_system_namespace_readonly) {
     return Error(loc, ErrorCode::SYSTEM_NAMESPACE_READONLY);
@@ -67,7 +69,8 @@ Status SemContext::LookupTable(const YBTableName& name,
 
   VLOG(3) << "Loading table descriptor for " << name.ToString();
   *table = GetTableDesc(name);
-  if (*table == nullptr || (*table)->IsIndex() && !FLAGS_allow_index_table_read_write) {
+  if (*table == nullptr ||
+      (*table)->IsIndex() && !FLAGS_allow_index_table_read_write && !allow_index_table) {
     return Error(loc, ErrorCode::TABLE_NOT_FOUND);
   }
   set_current_table(*table);
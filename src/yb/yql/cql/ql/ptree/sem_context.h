@@ -75,7 +75,8 @@ class SemContext : public ProcessContext {
   SemContext(const char *ql_stmt,
              size_t stmt_len,
              ParseTree::UniPtr parse_tree,
-             QLEnv *ql_env);
+             QLEnv *ql_env,
+             Arena *ptemp_mem = nullptr);
   virtual ~SemContext();
 
   // Memory pool for semantic analysis of the parse tree of a statement.
@@ -100,7 +101,8 @@ class SemContext : public ProcessContext {
   }
 
   //------------------------------------------------------------------------------------------------
-  // Load table schema into symbol table.
+  // Load table schema into symbol table. Index tables are loaded only if "allow_index_table" is
+  // set, i.e. when reading from an index table chosen by the analyzer.
   CHECKED_STATUS LookupTable(const client::YBTableName& name,
                              const YBLocation& loc,
                              bool write_table,
@@ -109,7 +111,8 @@ class SemContext : public ProcessContext {
                              MCVector<ColumnDesc>* col_descs = nullptr,
                              int* num_key_columns = nullptr,
                              int* num_hash_key_columns = nullptr,
-                             MCVector<PTColumnDefinition::SharedPtr>* column_definitions = nullptr);
+                             MCVector<PTColumnDefinition::SharedPtr>* column_definitions = nullptr,
+                             bool allow_index_table = false);
 
   //------------------------------------------------------------------------------------------------
   // Access functions to current processing table and column.
@@ -34,10 +34,14 @@ Analyzer::~Analyzer() {
 CHECKED_STATUS Analyzer::Analyze(const string& ql_stmt, ParseTree::UniPtr parse_tree) {
   ParseTree *ptree = parse_tree.get();
   DCHECK(ptree != nullptr) << "Parse tree is null";
+  // Destroy the previous context before its temporary memory is reused.
+  sem_context_ = nullptr;
+  ptemp_mem_.Reset();
   sem_context_ = SemContext::UniPtr(new SemContext(ql_stmt.c_str(),
                                                    ql_stmt.length(),
                                                    std::move(parse_tree),
-                                                   ql_env_));
+                                                   ql_env_,
+                                                   &ptemp_mem_));
   Status s = ptree->Analyze(sem_context_.get());
   if (PREDICT_FALSE(!s.ok())) {
     // When a statement is parsed for the first time, semantic analysis may fail because stale
@@ -53,6 +53,9 @@ class Analyzer {
   // Environment (YBClient) for analyzing statements.
   QLEnv *ql_env_;
 
+  // Temporary memory pool of the semantic context, reset and reused for each statement analyzed.
+  Arena ptemp_mem_;
+
   SemContext::UniPtr sem_context_;
 };
 
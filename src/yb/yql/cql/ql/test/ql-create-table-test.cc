@@ -181,6 +181,60 @@ TEST_F(TestQLCreateTable, TestQLCreateTableWithTTL) {
   EXPECT_EQ(1000, properties_pb.default_time_to_live());
 }
 
+TEST_F(TestQLCreateTable, TestQLCreateTableWithCachePriority) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get an available processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  EXEC_VALID_STMT("CREATE TABLE hot_table (c1 int, c2 int, PRIMARY KEY(c1)) WITH "
+                      "caching = {'keys' : 'ALL', 'priority' : 'high'};");
+  EXEC_INVALID_STMT("CREATE TABLE bad_priority_table (c1 int, c2 int, PRIMARY KEY(c1)) WITH "
+                        "caching = {'priority' : 'urgent'};");
+
+  // Query the table schema.
+  master::Master *master = cluster_->mini_master()->master();
+  master::CatalogManager *catalog_manager = master->catalog_manager();
+  master::GetTableSchemaRequestPB request_pb;
+  master::GetTableSchemaResponsePB response_pb;
+  request_pb.mutable_table()->mutable_namespace_()->set_name(kDefaultKeyspaceName);
+  request_pb.mutable_table()->set_table_name("hot_table");
+
+  // Verify the priority was stored in syscatalog table.
+  CHECK_OK(catalog_manager->GetTableSchema(&request_pb, &response_pb));
+  const TablePropertiesPB& properties_pb = response_pb.schema().table_properties();
+  EXPECT_TRUE(properties_pb.has_cache_priority());
+  EXPECT_EQ(HIGH_CACHE_PRIORITY, properties_pb.cache_priority());
+}
+
+TEST_F(TestQLCreateTable, TestQLCreateTableInMemory) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get an available processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  EXEC_VALID_STMT("CREATE TABLE lookup_table (c1 int, c2 int, PRIMARY KEY(c1)) WITH "
+                      "caching = {'in_memory' : true};");
+  EXEC_INVALID_STMT("CREATE TABLE bad_in_memory_table (c1 int, c2 int, PRIMARY KEY(c1)) WITH "
+                        "caching = {'in_memory' : 'always'};");
+
+  // Query the table schema.
+  master::Master *master = cluster_->mini_master()->master();
+  master::CatalogManager *catalog_manager = master->catalog_manager();
+  master::GetTableSchemaRequestPB request_pb;
+  master::GetTableSchemaResponsePB response_pb;
+  request_pb.mutable_table()->mutable_namespace_()->set_name(kDefaultKeyspaceName);
+  request_pb.mutable_table()->set_table_name("lookup_table");
+
+  // Verify the property was stored in syscatalog table.
+  CHECK_OK(catalog_manager->GetTableSchema(&request_pb, &response_pb));
+  const TablePropertiesPB& properties_pb = response_pb.schema().table_properties();
+  EXPECT_TRUE(properties_pb.in_memory());
+  EXPECT_FALSE(properties_pb.has_cache_priority());
+}
+
 TEST_F(TestQLCreateTable, TestQLCreateTableWithClusteringOrderBy) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -213,6 +213,8 @@ TEST_F(QLTestParser, TestCreateIndex) {
   // Valid statement: CREATE INDEX WITH CLUSTERING ORDER BY and COVERING.
   PARSE_VALID_STMT("CREATE INDEX IF NOT EXISTS i ON k.t ((c1, c2), c3, c4) "
                    "WITH CLUSTERING ORDER BY (c3 DESC, c4 ASC) COVERING (c5, c6);");
+  // Valid statement: CREATE INDEX with INCLUDE.
+  PARSE_VALID_STMT("CREATE INDEX i ON k.t ((c1, c2), c3, c4) INCLUDE (c5, c6);");
 
   // Invalid statement: mandatory index name missing.
   PARSE_INVALID_STMT("CREATE INDEX ON k.t (c1, c2, c3, c4);");
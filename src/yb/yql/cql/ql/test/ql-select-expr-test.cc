@@ -13,6 +13,8 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_int32(cql_parallel_aggregate_scan_ranges);
+
 namespace yb {
 namespace ql {
 
@@ -111,6 +113,17 @@ TEST_F(QLTestSelectedExpr, TestAggregateExpr) {
     CHECK_EQ(sum_all_row.column(1).int64_value(), 20);
     CHECK_EQ(sum_all_row.column(2).int64_value(), 20);
     CHECK_EQ(sum_all_row.column(3).int64_value(), 20);
+
+    // Test COUNT() - All rows, read one tablet at a time and in many more ranges than tablets.
+    for (int ranges : {1, 1000}) {
+      FLAGS_cql_parallel_aggregate_scan_ranges = ranges;
+      CHECK_VALID_STMT("SELECT count(*), count(v1) FROM test_aggr_expr;");
+      row_block = processor->row_block();
+      CHECK_EQ(row_block->row_count(), 1);
+      CHECK_EQ(row_block->row(0).column(0).int64_value(), 20);
+      CHECK_EQ(row_block->row(0).column(1).int64_value(), 20);
+    }
+    FLAGS_cql_parallel_aggregate_scan_ranges = 16;
   }
 
   //------------------------------------------------------------------------------------------------
@@ -175,6 +188,40 @@ TEST_F(QLTestSelectedExpr, TestAggregateExpr) {
     CHECK_LT(sum_all_row.column(5).double_value(), v6_total + 0.1);
   }
 
+  //------------------------------------------------------------------------------------------------
+  // Test AVG() aggregate function.
+  {
+    // Test AVG() - Not existing data.
+    CHECK_VALID_STMT("SELECT avg(v1), avg(v2), avg(v6) FROM test_aggr_expr WHERE h = 1 AND r = 1;");
+    row_block = processor->row_block();
+    CHECK_EQ(row_block->row_count(), 1);
+    const QLRow& avg_0_row = row_block->row(0);
+    CHECK(avg_0_row.column(0).IsNull());
+    CHECK(avg_0_row.column(1).IsNull());
+    CHECK(avg_0_row.column(2).IsNull());
+
+    // Test AVG() - Where condition provides full hash key.
+    CHECK_VALID_STMT("SELECT avg(v1), avg(v2), avg(v6) FROM test_aggr_expr WHERE h = 1;");
+    row_block = processor->row_block();
+    CHECK_EQ(row_block->row_count(), 1);
+    const QLRow& avg_2_row = row_block->row(0);
+    CHECK_EQ(avg_2_row.column(0).int64_value(), 506);
+    CHECK_EQ(avg_2_row.column(1).int32_value(), 56);
+    // Comparing floating point for 508.495
+    CHECK_GT(avg_2_row.column(2).double_value(), 508.49);
+    CHECK_LT(avg_2_row.column(2).double_value(), 508.50);
+
+    // Test AVG() - All rows, merging the partials of all tablets.
+    CHECK_VALID_STMT("SELECT avg(v1), avg(v2), avg(v6) FROM test_aggr_expr;");
+    row_block = processor->row_block();
+    CHECK_EQ(row_block->row_count(), 1);
+    const QLRow& avg_all_row = row_block->row(0);
+    CHECK_EQ(avg_all_row.column(0).int64_value(), v1_total / 20);
+    CHECK_EQ(avg_all_row.column(1).int32_value(), v2_total / 20);
+    CHECK_GT(avg_all_row.column(2).double_value(), v6_total / 20 - 0.1);
+    CHECK_LT(avg_all_row.column(2).double_value(), v6_total / 20 + 0.1);
+  }
+
   //------------------------------------------------------------------------------------------------
   // Test MAX() aggregate functions.
   {
@@ -15,6 +15,8 @@
 #include "yb/yql/cql/ql/test/ql-test-base.h"
 #include "yb/util/varint.h"
 
+DECLARE_bool(cql_read_from_covering_index);
+
 namespace yb {
 namespace ql {
 
@@ -239,6 +241,36 @@ TEST_F(QLTestAnalyzer, TestCreateIndex) {
   ANALYZE_INVALID_STMT("CREATE INDEX i ON t3 (c);", &parse_tree);
 }
 
+TEST_F(QLTestAnalyzer, TestSelectFromCoveringIndex) {
+  CreateSimulatedCluster();
+  TestQLProcessor *processor = GetQLProcessor();
+  CHECK_OK(processor->Run("CREATE TABLE t (h1 int, r1 int, c1 text, c2 int, c3 int, "
+                          "PRIMARY KEY ((h1), r1)) with transactions = {'enabled':true};"));
+  CHECK_OK(processor->Run("CREATE INDEX i ON t (c1) INCLUDE (c2);"));
+
+  FLAGS_cql_read_from_covering_index = true;
+  const auto reads_index = [this](const string& stmt) {
+    ParseTree::UniPtr parse_tree;
+    CHECK_OK(TestAnalyzer(stmt, &parse_tree));
+    const auto& select = static_cast<const PTSelectStmt&>(*parse_tree->root());
+    return select.table()->IsIndex();
+  };
+
+  // The index has all the referenced columns, including the indexed table's primary key.
+  EXPECT_TRUE(reads_index("SELECT c2 FROM t WHERE c1 = 'a';"));
+  EXPECT_TRUE(reads_index("SELECT h1, r1, c2 FROM t WHERE c1 = ? AND c2 > 1;"));
+
+  // The table is read when the hash key is given, or when the index does not cover the query.
+  EXPECT_FALSE(reads_index("SELECT c2 FROM t WHERE h1 = 1 AND c1 = 'a';"));
+  EXPECT_FALSE(reads_index("SELECT c3 FROM t WHERE c1 = 'a';"));
+  EXPECT_FALSE(reads_index("SELECT c2 FROM t WHERE c1 = 'a' AND c3 = 1;"));
+  EXPECT_FALSE(reads_index("SELECT * FROM t WHERE c1 = 'a';"));
+  EXPECT_FALSE(reads_index("SELECT c2 FROM t WHERE c1 > 'a';"));
+
+  FLAGS_cql_read_from_covering_index = false;
+  EXPECT_FALSE(reads_index("SELECT c2 FROM t WHERE c1 = 'a';"));
+}
+
 TEST_F(QLTestAnalyzer, TestTruncate) {
   CreateSimulatedCluster();
   TestQLProcessor *processor = GetQLProcessor();
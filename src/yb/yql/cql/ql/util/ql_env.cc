@@ -16,6 +16,9 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/cql/ql/util/ql_env.h"
+
+#include <gflags/gflags.h>
+
 #include "yb/client/callbacks.h"
 #include "yb/client/client.h"
 #include "yb/client/transaction.h"
@@ -24,10 +27,20 @@
 #include "yb/master/catalog_manager.h"
 #include "yb/rpc/messenger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/trace.h"
 
 using namespace std::literals;
 
+DEFINE_bool(cql_allow_local_calls_in_curr_thread, true,
+            "Whether the CQL server may execute the operations of a statement on a tablet whose "
+            "leader is the local tablet server in its own handler thread, instead of handing them "
+            "over to the tablet server's service threads. Together with the leaders listed in "
+            "system.partitions, this lets leader-aware drivers skip all the thread and network "
+            "hops for single-partition statements.");
+TAG_FLAG(cql_allow_local_calls_in_curr_thread, runtime);
+TAG_FLAG(cql_allow_local_calls_in_curr_thread, advanced);
+
 namespace yb {
 namespace ql {
 
@@ -141,6 +154,11 @@ bool QLEnv::FlushAsync(Callback<void(const Status &)>* cb) {
   DCHECK(requested_callback_ == nullptr);
   requested_callback_ = cb;
   TRACE("Flush Async");
+  // The flush callback only queues the call to resume in the handler thread, so the statement is
+  // not reentered from a local call that completes in the current thread. Unit tests without a
+  // current call run the callback in place, so they keep using the service threads.
+  session_->set_allow_local_calls_in_curr_thread(
+      current_call_ != nullptr && FLAGS_cql_allow_local_calls_in_curr_thread);
   session_->FlushAsync([this](const Status& status) { FlushAsyncDone(status); });
   return true;
 }
@@ -135,6 +135,9 @@ class RowsResult : public ExecutedResult {
   const std::vector<ColumnSchema>& column_schemas() const { return *column_schemas_; }
   const std::string& rows_data() const { return rows_data_; }
   void set_rows_data(const char *str, size_t size) { rows_data_.assign(str, size); }
+  void set_column_schemas(const std::shared_ptr<std::vector<ColumnSchema>>& column_schemas) {
+    column_schemas_ = column_schemas;
+  }
   const std::string& paging_state() const { return paging_state_; }
   QLClient client() const { return client_; }
 
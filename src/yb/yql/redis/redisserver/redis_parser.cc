@@ -139,13 +139,43 @@ CHECKED_STATUS ParseSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// TODO: support MSET
-CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
+// SETEX <key> <seconds> <value> and PSETEX <key> <milliseconds> <value> are executed as
+// SET <key> <value> EX|PX <ttl>, so the TTL is stored as the DocDB TTL of the value.
+CHECKED_STATUS ParseSetWithTtl(YBRedisWriteOp *op, const RedisClientCommand& args,
+                               const char* ttl_unit) {
+  RedisClientCommand set_args(5);
+  set_args[0] = "set";
+  set_args[1] = args[1];
+  set_args[2] = args[3];
+  set_args[3] = ttl_unit;
+  set_args[4] = args[2];
+  return ParseSet(op, set_args);
+}
+
+CHECKED_STATUS ParseSetEx(YBRedisWriteOp *op, const RedisClientCommand& args) {
+  return ParseSetWithTtl(op, args, "EX");
+}
+
+CHECKED_STATUS ParsePSetEx(YBRedisWriteOp *op, const RedisClientCommand& args) {
+  return ParseSetWithTtl(op, args, "PX");
+}
+
+CHECKED_STATUS ParseMSet(RedisMultiWriteOp *op, const RedisClientCommand& args) {
   if (args.size() < 3 || args.size() % 2 == 0) {
     return STATUS_SUBSTITUTE(InvalidCommand,
         "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
   }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
+  // Each key is set as by "SET <key> <value>".
+  RedisClientCommand set_args(3);
+  set_args[0] = "set";
+  op->ops.reserve(args.size() / 2);
+  for (size_t i = 1; i < args.size(); i += 2) {
+    set_args[1] = args[i];
+    set_args[2] = args[i + 1];
+    op->ops.push_back(std::make_shared<YBRedisWriteOp>(op->table));
+    RETURN_NOT_OK(ParseSet(op->ops.back().get(), set_args));
+  }
+  return Status::OK();
 }
 
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
@@ -404,6 +434,25 @@ CHECKED_STATUS ParseIncr(YBRedisWriteOp* op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
+CHECKED_STATUS ParseIncrBy(YBRedisWriteOp* op, const RedisClientCommand& args) {
+  auto increment = ParseInt64(args[2], "Increment");
+  RETURN_NOT_OK(increment);
+  RETURN_NOT_OK(ParseIncr(op, args));
+  op->mutable_request()->mutable_incr_request()->set_increment_int(*increment);
+  return Status::OK();
+}
+
+CHECKED_STATUS ParseDecrBy(YBRedisWriteOp* op, const RedisClientCommand& args) {
+  auto decrement = ParseInt64(args[2], "Decrement");
+  RETURN_NOT_OK(decrement);
+  if (*decrement == std::numeric_limits<int64_t>::min()) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Decrement is out of range: $0", *decrement);
+  }
+  RETURN_NOT_OK(ParseIncr(op, args));
+  op->mutable_request()->mutable_incr_request()->set_increment_int(-*decrement);
+  return Status::OK();
+}
+
 CHECKED_STATUS ParseGet(YBRedisReadOp* op, const RedisClientCommand& args) {
   op->mutable_request()->set_allocated_get_request(new RedisGetRequestPB());
   const auto& key = args[1];
@@ -428,9 +477,59 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
   return ParseCollection(op, args, boost::none, add_string_subkey, remove_duplicates);
 }
 
-// TODO: Support MGET
-CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
+CHECKED_STATUS ParseMGet(RedisMultiReadOp* op, const RedisClientCommand& args) {
+  // Each key is read as by "GET <key>".
+  RedisClientCommand get_args(2);
+  get_args[0] = "get";
+  op->ops.reserve(args.size() - 1);
+  for (size_t i = 1; i < args.size(); ++i) {
+    get_args[1] = args[i];
+    op->ops.push_back(std::make_shared<YBRedisReadOp>(op->table));
+    RETURN_NOT_OK(ParseGet(op->ops.back().get(), get_args));
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS ParseTtl(YBRedisReadOp* op, const RedisClientCommand& args) {
+  op->mutable_request()->set_allocated_get_request(new RedisGetRequestPB());
+  const auto& key = args[1];
+  op->mutable_request()->mutable_key_value()->set_key(key.cdata(), key.size());
+  op->mutable_request()->mutable_get_request()->set_request_type(
+      RedisGetRequestPB_GetRequestType_TTL);
+  return Status::OK();
+}
+
+// SCAN <cursor> [MATCH <pattern>] [COUNT <count>]
+// The cursor is the hash code to continue from, so each SCAN reads from a single tablet.
+CHECKED_STATUS ParseScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  auto cursor = ParseInt64(args[1], "Cursor");
+  RETURN_NOT_OK(cursor);
+  if (*cursor < 0 || *cursor >= kRedisClusterSlots) {
+    return STATUS_SUBSTITUTE(InvalidCommand, "Invalid cursor $0", *cursor);
+  }
+  op->mutable_request()->set_allocated_scan_request(new RedisScanRequestPB());
+  op->mutable_request()->mutable_key_value()->set_hash_code(static_cast<uint32_t>(*cursor));
+  auto* scan_request = op->mutable_request()->mutable_scan_request();
+  for (size_t idx = 2; idx < args.size(); idx += 2) {
+    if (idx + 1 == args.size()) {
+      return STATUS_SUBSTITUTE(InvalidCommand, "Expected a value after $0", args[idx].ToBuffer());
+    }
+    const string option = to_lower_case(args[idx]);
+    if (option == "match") {
+      scan_request->set_pattern(args[idx + 1].cdata(), args[idx + 1].size());
+    } else if (option == "count") {
+      auto count = ParseInt32(args[idx + 1], "Count");
+      RETURN_NOT_OK(count);
+      if (*count <= 0) {
+        return STATUS_SUBSTITUTE(InvalidCommand, "Invalid count $0", *count);
+      }
+      scan_request->set_count(*count);
+    } else {
+      return STATUS_SUBSTITUTE(InvalidCommand,
+          "Unidentified argument $0 found while parsing scan command", args[idx].ToBuffer());
+    }
+  }
+  return Status::OK();
 }
 
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
@@ -509,7 +608,12 @@ CHECKED_STATUS ParseIndexBound(const Slice& slice, RedisIndexBoundPB* bound_pb)
   return Status::OK();
 }
 
+// TSRANGEBYTIME <key> <low> <high> [AGGREGATION AVG|SUM|MIN|MAX|COUNT <bucket_size>]
 CHECKED_STATUS ParseTsRangeByTime(YBRedisReadOp* op, const RedisClientCommand& args) {
+  if (args.size() != 4 && args.size() != 7) {
+    return STATUS_SUBSTITUTE(InvalidArgument,
+                             "Expected 4 or 7 arguments for TSRANGEBYTIME, found $0", args.size());
+  }
   op->mutable_request()->set_allocated_get_collection_range_request(
       new RedisCollectionGetRangeRequestPB());
   op->mutable_request()->mutable_get_collection_range_request()->set_request_type(
@@ -525,6 +629,25 @@ CHECKED_STATUS ParseTsRangeByTime(YBRedisReadOp* op, const RedisClientCommand& a
       op->mutable_request()->mutable_subkey_range()->mutable_upper_bound(),
       RedisCollectionGetRangeRequestPB_GetRangeRequestType_TSRANGEBYTIME));
 
+  if (args.size() == 7) {
+    if (to_lower_case(args[4]) != "aggregation") {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Unexpected argument $0", args[4].ToBuffer());
+    }
+    RedisCollectionGetRangeRequestPB_AggregationType aggregation;
+    if (!RedisCollectionGetRangeRequestPB_AggregationType_Parse(
+            boost::to_upper_copy(args[5].ToBuffer()), &aggregation)) {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Unknown aggregation $0", args[5].ToBuffer());
+    }
+    auto bucket_size = ParseInt64(args[6], "Bucket size");
+    RETURN_NOT_OK(bucket_size);
+    if (*bucket_size <= 0) {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Bucket size must be positive: $0", *bucket_size);
+    }
+    auto* range_request = op->mutable_request()->mutable_get_collection_range_request();
+    range_request->set_aggregation(aggregation);
+    range_request->set_bucket_size(*bucket_size);
+  }
+
   op->mutable_request()->mutable_key_value()->set_key(key.ToBuffer());
   return Status::OK();
 }
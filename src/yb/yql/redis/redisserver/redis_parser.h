@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/container/small_vector.hpp>
 
@@ -37,6 +38,19 @@ constexpr int64_t kNoneTtl = -1;
 CHECKED_STATUS ParseSet(client::YBRedisWriteOp *op, const RedisClientCommand& args);
 CHECKED_STATUS ParseGet(client::YBRedisReadOp* op, const RedisClientCommand& args);
 
+// A command on multiple keys, such as MGET or MSET. It is executed as one operation per key, so
+// that the operations are batched by tablet together with the other commands of the call.
+template <class Op>
+struct RedisMultiOp {
+  explicit RedisMultiOp(std::shared_ptr<client::YBTable> table_) : table(std::move(table_)) {}
+
+  std::shared_ptr<client::YBTable> table;
+  std::vector<std::shared_ptr<Op>> ops;
+};
+
+typedef RedisMultiOp<client::YBRedisReadOp> RedisMultiReadOp;
+typedef RedisMultiOp<client::YBRedisWriteOp> RedisMultiWriteOp;
+
 // TODO: make additional command support here
 
 // RedisParser is a finite state machine with memory.
@@ -0,0 +1,167 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/yql/redis/redisserver/redis_pubsub.h"
+
+#include <functional>
+
+#include <gflags/gflags.h>
+
+#include "yb/yql/redis/redisserver/redis_encoding.h"
+#include "yb/yql/redis/redisserver/redis_rpc.h"
+
+#include "yb/rpc/connection.h"
+#include "yb/rpc/reactor.h"
+#include "yb/rpc/server_event.h"
+
+#include "yb/util/logging.h"
+#include "yb/util/size_literals.h"
+
+using yb::operator"" _MB;
+
+DEFINE_uint64(redis_max_pubsub_queued_bytes, 32_MB,
+              "Max size of published messages queued to a single subscriber. Subscribers that "
+              "fall further behind are disconnected.");
+
+namespace yb {
+namespace redisserver {
+
+// A message pushed to the subscribers of a channel, the same instance is queued to all of them.
+class RedisPubSub::Message : public rpc::ServerEventList {
+ public:
+  Message(const std::string& channel, const std::string& message)
+      : data_(EncodeAsArrayOfEncodedElements(std::initializer_list<std::string>{
+            EncodeAsBulkString("message").ToBuffer(),
+            EncodeAsBulkString(channel).ToBuffer(),
+            EncodeAsBulkString(message).ToBuffer()})) {}
+
+  size_t size() const { return data_.size(); }
+
+  void Serialize(std::deque<RefCntBuffer>* output) const override {
+    output->push_back(data_);
+  }
+
+  std::string ToString() const override {
+    return "RedisPubSub::Message";
+  }
+
+ private:
+  void Transferred(const Status& status, rpc::Connection* connection) override {
+    auto& context = static_cast<RedisConnectionContext&>(connection->context());
+    context.pubsub_queued_bytes_.fetch_sub(data_.size(), std::memory_order_acq_rel);
+  }
+
+  RefCntBuffer data_;
+};
+
+namespace {
+
+void DisconnectSlowSubscriber(const rpc::ConnectionPtr& connection) {
+  YB_LOG_EVERY_N_SECS(WARNING, 10) << "Disconnecting slow pub/sub subscriber "
+                                   << connection->ToString();
+  rpc::Reactor* reactor = connection->reactor();
+  reactor->ScheduleReactorTask(
+      MakeFunctorReactorTask(std::bind(&rpc::Reactor::DestroyConnection,
+                                       reactor,
+                                       connection.get(),
+                                       STATUS(NetworkError, "Slow pub/sub subscriber")),
+                             connection));
+}
+
+} // namespace
+
+size_t RedisPubSub::Subscribe(const rpc::ConnectionPtr& connection, const std::string& channel) {
+  auto* context = static_cast<RedisConnectionContext*>(&connection->context());
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!context->pubsub_) {
+    context->pubsub_ = shared_from_this();
+  }
+  if (context->subscriptions_.insert(channel).second) {
+    channels_[channel].emplace(context, connection);
+  }
+  return context->subscriptions_.size();
+}
+
+void RedisPubSub::EraseSubscriber(RedisConnectionContext* context, const std::string& channel) {
+  auto it = channels_.find(channel);
+  it->second.erase(context);
+  if (it->second.empty()) {
+    channels_.erase(it);
+  }
+}
+
+size_t RedisPubSub::Unsubscribe(RedisConnectionContext* context, const std::string& channel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (context->subscriptions_.erase(channel)) {
+    EraseSubscriber(context, channel);
+  }
+  return context->subscriptions_.size();
+}
+
+std::vector<std::string> RedisPubSub::UnsubscribeAll(RedisConnectionContext* context) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> result(context->subscriptions_.begin(),
+                                  context->subscriptions_.end());
+  for (const auto& channel : result) {
+    EraseSubscriber(context, channel);
+  }
+  context->subscriptions_.clear();
+  return result;
+}
+
+size_t RedisPubSub::Publish(const std::string& channel, const std::string& message) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = channels_.find(channel);
+  if (it == channels_.end()) {
+    return 0;
+  }
+  // Encoded once for all subscribers.
+  auto data = std::make_shared<Message>(channel, message);
+  size_t result = 0;
+  for (auto subscriber = it->second.begin(); subscriber != it->second.end();) {
+    auto* context = subscriber->first;
+    auto connection = subscriber->second.lock();
+    if (!connection) {
+      // The connection is being destroyed, its context will unsubscribe.
+      ++subscriber;
+      continue;
+    }
+    auto queued_bytes = context->pubsub_queued_bytes_.fetch_add(
+        data->size(), std::memory_order_acq_rel);
+    if (queued_bytes + data->size() > FLAGS_redis_max_pubsub_queued_bytes) {
+      context->pubsub_queued_bytes_.fetch_sub(data->size(), std::memory_order_acq_rel);
+      // Drop all subscriptions of the connection, so it is disconnected only once.
+      for (const auto& other_channel : context->subscriptions_) {
+        if (other_channel != channel) {
+          EraseSubscriber(context, other_channel);
+        }
+      }
+      context->subscriptions_.clear();
+      subscriber = it->second.erase(subscriber);
+      DisconnectSlowSubscriber(connection);
+      continue;
+    }
+    connection->QueueOutboundData(data);
+    ++result;
+    ++subscriber;
+  }
+  if (it->second.empty()) {
+    channels_.erase(it);
+  }
+  return result;
+}
+
+} // namespace redisserver
+} // namespace yb
@@ -0,0 +1,70 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#ifndef YB_YQL_REDIS_REDISSERVER_REDIS_PUBSUB_H
+#define YB_YQL_REDIS_REDISSERVER_REDIS_PUBSUB_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/rpc/rpc_fwd.h"
+
+namespace yb {
+namespace redisserver {
+
+class RedisConnectionContext;
+
+// Channels of this redis server and the connections subscribed to them. Published messages are
+// pushed to the subscribed connections directly, they are not stored in DocDB.
+//
+// The channels of a connection are kept in its RedisConnectionContext, both are guarded by the
+// mutex of this class.
+class RedisPubSub : public std::enable_shared_from_this<RedisPubSub> {
+ public:
+  // Subscribes the connection to the channel. Returns the number of channels the connection is
+  // subscribed to.
+  size_t Subscribe(const rpc::ConnectionPtr& connection, const std::string& channel);
+
+  // Unsubscribes the connection from the channel. Returns the number of channels the connection
+  // is still subscribed to.
+  size_t Unsubscribe(RedisConnectionContext* context, const std::string& channel);
+
+  // Unsubscribes the connection from all channels, and returns them.
+  std::vector<std::string> UnsubscribeAll(RedisConnectionContext* context);
+
+  // Queues the message to all subscribers of the channel. Subscribers that do not read their
+  // messages fast enough are disconnected. Returns the number of subscribers that received the
+  // message.
+  size_t Publish(const std::string& channel, const std::string& message);
+
+ private:
+  class Message;
+
+  // Removes the context from the subscribers of the channel, requires mutex_.
+  void EraseSubscriber(RedisConnectionContext* context, const std::string& channel);
+
+  std::mutex mutex_;
+  // The subscribers of each channel. The context is removed from here before it is destroyed.
+  typedef std::unordered_map<RedisConnectionContext*, std::weak_ptr<rpc::Connection>> Subscribers;
+  std::unordered_map<std::string, Subscribers> channels_;
+};
+
+} // namespace redisserver
+} // namespace yb
+
+#endif // YB_YQL_REDIS_REDISSERVER_REDIS_PUBSUB_H
@@ -21,6 +21,7 @@
 
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
+#include "yb/yql/redis/redisserver/redis_pubsub.h"
 
 #include "yb/rpc/connection.h"
 #include "yb/rpc/messenger.h"
@@ -55,7 +56,11 @@ namespace redisserver {
 RedisConnectionContext::RedisConnectionContext()
     : ConnectionContextWithQueue(FLAGS_redis_max_concurrent_commands) {}
 
-RedisConnectionContext::~RedisConnectionContext() {}
+RedisConnectionContext::~RedisConnectionContext() {
+  if (pubsub_) {
+    pubsub_->UnsubscribeAll(this);
+  }
+}
 
 Status RedisConnectionContext::ProcessCalls(const rpc::ConnectionPtr& connection,
                                             Slice slice,
@@ -196,7 +201,7 @@ void RedisInboundCall::LogTrace() const {
   MonoTime now = MonoTime::Now();
   auto total_time = now.GetDeltaSince(timing_.time_received).ToMilliseconds();
 
-  if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces)) {
+  if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces || trace_->sampled())) {
     LOG(INFO) << ToString() << " took " << total_time << "ms. Trace:";
     trace_->Dump(&LOG(INFO), /* include_time_deltas */ true);
   }
@@ -220,7 +225,7 @@ bool RedisInboundCall::DumpPB(const rpc::DumpRunningRpcsRequestPB& req,
 
   // RedisClientBatch client_batch_
   rpc::RedisCallDetailsPB* redis_details = resp->mutable_redis_details();
-  for (RedisClientCommand command : client_batch_) {
+  for (const RedisClientCommand& command : client_batch_) {
     string query = "";
     for (Slice arg : command) {
       query += " " + arg.ToDebugString(FLAGS_rpcz_max_redis_query_dump_size);
@@ -236,11 +241,12 @@ Out DoSerializeResponses(const Collection& responses, Out out) {
   // TODO(Amit): As and when we implement get/set and its h* equivalents, we would have to
   // handle arrays, hashes etc. For now, we only support the string response.
 
+  static const std::string kUnknownError = "Unknown error"s;
   for (const auto& redis_response : responses) {
-    string error_message = redis_response.error_message();
-    if (error_message == "") {
-      error_message = "Unknown error";
-    }
+    // Responses are serialized twice, to find the size and to write them, so don't copy anything
+    // out of them here.
+    const std::string& error_message =
+        redis_response.error_message().empty() ? kUnknownError : redis_response.error_message();
     // Several types of error cases:
     //    1) Parsing error: The command is malformed (eg. too few arguments "SET a")
     //    2) Server error: Request to server failed due to reasons not related to the command
@@ -259,6 +265,14 @@ Out DoSerializeResponses(const Collection& responses, Out out) {
       out = SerializeBulkString(redis_response.string_response(), out);
     } else if (redis_response.has_int_response()) {
       out = SerializeInteger(redis_response.int_response(), out);
+    } else if (redis_response.has_encoded_response()) {
+      out = SerializeEncoded(redis_response.encoded_response(), out);
+    } else if (redis_response.has_next_cursor()) {
+      // SCAN responds with the cursor to continue from, followed by the keys found.
+      static const std::string kScanResponseHeader = "*2\r\n"s;
+      out = SerializeEncoded(kScanResponseHeader, out);
+      out = SerializeBulkString(std::to_string(redis_response.next_cursor()), out);
+      out = SerializeArray(redis_response.array_response().elements(), out);
     } else if (redis_response.has_array_response()) {
       if (redis_response.array_response().has_encoded() &&
           redis_response.array_response().encoded()) {
@@ -16,6 +16,11 @@
 #ifndef YB_YQL_REDIS_REDISSERVER_REDIS_RPC_H
 #define YB_YQL_REDIS_REDISSERVER_REDIS_RPC_H
 
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+
 #include <boost/container/small_vector.hpp>
 
 #include "yb/yql/redis/redisserver/redis_fwd.h"
@@ -28,6 +33,7 @@ namespace yb {
 namespace redisserver {
 
 class RedisParser;
+class RedisPubSub;
 
 class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
  public:
@@ -52,6 +58,14 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
 
   std::unique_ptr<RedisParser> parser_;
   size_t commands_in_batch_ = 0;
+
+  // Pub/sub state of the connection. pubsub_ is set by the first SUBSCRIBE, subscriptions_ is
+  // guarded by the mutex of pubsub_.
+  friend class RedisPubSub;
+  std::shared_ptr<RedisPubSub> pubsub_;
+  std::set<std::string> subscriptions_;
+  // Size of the published messages queued to this connection, but not yet sent.
+  std::atomic<size_t> pubsub_queued_bytes_{0};
 };
 
 class RedisInboundCall : public rpc::QueueableInboundCall {
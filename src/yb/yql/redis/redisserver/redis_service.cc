@@ -13,18 +13,20 @@
 
 #include "yb/yql/redis/redisserver/redis_service.h"
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include <boost/lockfree/queue.hpp>
 
-#include <boost/logic/tribool.hpp>
-
 #include <boost/preprocessor/seq/for_each.hpp>
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/casts.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/substitute.h"
 
@@ -34,14 +36,19 @@
 #include "yb/client/client_builder-internal.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/common/partition.h"
 #include "yb/common/redis_protocol.pb.h"
 
+#include "yb/master/master.pb.h"
+
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
+#include "yb/yql/redis/redisserver/redis_pubsub.h"
 #include "yb/yql/redis/redisserver/redis_rpc.h"
 #include "yb/yql/redis/redisserver/redis_server.h"
 
+#include "yb/rpc/connection.h"
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/tserver/tablet_server.h"
@@ -111,7 +118,7 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
 
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, MULTI_READ)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
@@ -128,15 +135,19 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
     ((exists, Exists, 2, READ)) \
     ((getrange, GetRange, 4, READ)) \
     ((zcard, ZCard, 2, READ)) \
+    ((ttl, Ttl, 2, READ)) \
+    ((scan, Scan, -2, READ)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, MULTI_WRITE)) \
+    ((setex, SetEx, 4, WRITE)) \
+    ((psetex, PSetEx, 4, WRITE)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hdel, HDel, -3, WRITE)) \
     ((sadd, SAdd, -3, WRITE)) \
     ((srem, SRem, -3, WRITE)) \
     ((tsadd, TsAdd, -4, WRITE)) \
-    ((tsrangebytime, TsRangeByTime, 4, READ)) \
+    ((tsrangebytime, TsRangeByTime, -4, READ)) \
     ((zrangebyscore, ZRangeByScore, -4, READ)) \
     ((zrevrange, ZRevRange, -4, READ)) \
     ((tsrem, TsRem, -3, WRITE)) \
@@ -147,6 +158,8 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
     ((del, Del, 2, WRITE)) \
     ((setrange, SetRange, 4, WRITE)) \
     ((incr, Incr, 2, WRITE)) \
+    ((incrby, IncrBy, 3, WRITE)) \
+    ((decrby, DecrBy, 3, WRITE)) \
     ((echo, Echo, 2, LOCAL)) \
     ((auth, Auth, -1, LOCAL)) \
     ((config, Config, -1, LOCAL)) \
@@ -155,6 +168,10 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
     ((ping, Ping, -1, LOCAL)) \
     ((command, Command, -1, LOCAL)) \
     ((quit, Quit, 1, LOCAL)) \
+    ((publish, Publish, 3, PUBSUB)) \
+    ((subscribe, Subscribe, -2, PUBSUB)) \
+    ((unsubscribe, Unsubscribe, -1, PUBSUB)) \
+    ((cluster, Cluster, 2, CLUSTER)) \
     ((flushdb, FlushDB, 1, TRUNCATE)) \
     ((flushall, FlushAll, 1, TRUNCATE))
     /**/
@@ -182,8 +199,12 @@ typedef boost::container::small_vector_base<Slice> RedisKeyList;
 
 #define READ_OP YBRedisReadOp
 #define WRITE_OP YBRedisWriteOp
+#define MULTI_READ_OP RedisMultiReadOp
+#define MULTI_WRITE_OP RedisMultiWriteOp
 #define LOCAL_OP RedisResponsePB
+#define PUBSUB_OP RedisPubSub
 #define TRUNCATE_OP void
+#define CLUSTER_OP void
 
 #define DO_PARSER_FORWARD(name, cname, arity, type) \
     CHECKED_STATUS BOOST_PP_CAT(Parse, cname)( \
@@ -195,18 +216,98 @@ BOOST_PP_SEQ_FOR_EACH(PARSER_FORWARD, ~, REDIS_COMMANDS)
 
 namespace {
 
+// Combines the responses of the per-key operations of a multi-key command into the response of the
+// command. A read, i.e. MGET, responds with the array of the values read, nil standing for a key
+// that has no string value. A write, i.e. MSET, responds with the first error or OK.
+class MultiResponse {
+ public:
+  MultiResponse(const std::shared_ptr<RedisInboundCall>& call,
+                size_t index,
+                size_t size,
+                const rpc::RpcMethodMetrics& metrics,
+                bool read)
+      : call_(call),
+        index_(index),
+        read_(read),
+        metrics_(metrics),
+        responses_(size),
+        left_(size) {}
+
+  void Respond(size_t index, const Status& status, RedisResponsePB* response) {
+    if (!status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (status_.ok()) {
+        status_ = status;
+      }
+    } else {
+      responses_[index].Swap(response);
+    }
+    if (left_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Finish();
+    }
+  }
+
+ private:
+  void Finish() {
+    if (!status_.ok()) {
+      call_->RespondFailure(index_, status_);
+      return;
+    }
+    RedisResponsePB response;
+    response.set_code(RedisResponsePB_RedisStatusCode_OK);
+    if (read_) {
+      auto* array = response.mutable_array_response();
+      array->set_encoded(true);
+      for (const auto& value : responses_) {
+        if (value.code() == RedisResponsePB_RedisStatusCode_OK && value.has_string_response()) {
+          // Encode the value right into its element, without an intermediate buffer.
+          const auto& input = value.string_response();
+          auto* element = array->add_elements();
+          element->resize(SerializeBulkString(input, size_t(0)));
+          auto* end = SerializeBulkString(input, pointer_cast<uint8_t*>(&(*element)[0]));
+          DCHECK_EQ(pointer_cast<uint8_t*>(&(*element)[0]) + element->size(), end);
+        } else {
+          array->add_elements(kNilResponse);
+        }
+      }
+    } else {
+      for (auto& result : responses_) {
+        if (result.code() != RedisResponsePB_RedisStatusCode_OK) {
+          response.Swap(&result);
+          break;
+        }
+      }
+    }
+    call_->RespondSuccess(index_, metrics_, &response);
+  }
+
+  std::shared_ptr<RedisInboundCall> call_;
+  const size_t index_;
+  const bool read_;
+  rpc::RpcMethodMetrics metrics_;
+  std::vector<RedisResponsePB> responses_;
+  std::atomic<size_t> left_;
+  std::mutex mutex_;
+  Status status_;
+};
+
 class Operation {
  public:
+  // The operation of a multi-key command responds through 'multi_response', at 'multi_index'.
   template <class Op>
   Operation(const std::shared_ptr<RedisInboundCall>& call,
             size_t index,
             std::shared_ptr<Op> operation,
-            const rpc::RpcMethodMetrics& metrics)
+            const rpc::RpcMethodMetrics& metrics,
+            std::shared_ptr<MultiResponse> multi_response = nullptr,
+            size_t multi_index = 0)
     : read_(std::is_same<Op, YBRedisReadOp>::value),
       call_(call),
       index_(index),
       operation_(std::move(operation)),
-      metrics_(metrics) {
+      metrics_(metrics),
+      multi_response_(std::move(multi_response)),
+      multi_index_(multi_index) {
     auto status = operation_->GetPartitionKey(&partition_key_);
     if (!status.ok()) {
       Respond(status);
@@ -273,7 +374,9 @@ class Operation {
 
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
-    if (status.ok()) {
+    if (multi_response_) {
+      multi_response_->Respond(multi_index_, status, &response());
+    } else if (status.ok()) {
       call_->RespondSuccess(index_, metrics_, &response());
     } else {
       call_->RespondFailure(index_, status);
@@ -287,6 +390,8 @@ class Operation {
   rpc::RpcMethodMetrics metrics_;
   std::string partition_key_;
   scoped_refptr<client::internal::RemoteTablet> tablet_;
+  std::shared_ptr<MultiResponse> multi_response_;
+  size_t multi_index_;
   std::atomic<bool> responded_{false};
 };
 
@@ -333,22 +438,40 @@ class SessionPool {
 class BatchContext;
 typedef scoped_refptr<BatchContext> BatchContextPtr;
 
+// A block of operations of the same kind (read or write) on one tablet that are flushed together.
+// A block is launched once all the blocks it depends on are processed.
 class Block : public std::enable_shared_from_this<Block> {
  public:
   typedef MCVector<Operation*> Ops;
 
   Block(const BatchContextPtr& context,
         Ops::allocator_type allocator,
-        rpc::RpcMethodMetrics metrics_internal)
+        rpc::RpcMethodMetrics metrics_internal,
+        bool read)
       : context_(context),
         ops_(allocator),
         metrics_internal_(std::move(metrics_internal)),
-        start_(MonoTime::Now()) {}
+        start_(MonoTime::Now()),
+        read_(read) {}
+
+  bool read() const {
+    return read_;
+  }
 
   void AddOperation(Operation* operation) {
     ops_.push_back(operation);
   }
 
+  // Makes 'dependent' wait for this block to be processed before it is launched.
+  void AddDependent(const std::shared_ptr<Block>& dependent) {
+    dependents_.push_back(dependent);
+    dependent->dependencies_left_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool ready() const {
+    return dependencies_left_.load(std::memory_order_acquire) == 0;
+  }
+
   void Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread = true) {
     session_pool_ = session_pool;
     session_ = session_pool->Take();
@@ -359,18 +482,13 @@ class Block : public std::enable_shared_from_this<Block> {
     if (has_ok) {
       // Allow local calls in this thread only if no one is waiting behind us.
       session_->set_allow_local_calls_in_curr_thread(
-          allow_local_calls_in_curr_thread && this->next_ == nullptr);
+          allow_local_calls_in_curr_thread && dependents_.empty());
       session_->FlushAsync(BlockCallback(shared_from_this()));
     } else {
       Processed();
     }
   }
 
-  std::shared_ptr<Block> SetNext(const std::shared_ptr<Block>& next) {
-    std::shared_ptr<Block> result = std::move(next_);
-    next_ = next;
-    return result;
-  }
  private:
   class BlockCallback {
    public:
@@ -410,49 +528,49 @@ class Block : public std::enable_shared_from_this<Block> {
     auto allow_local_calls_in_curr_thread = session_->allow_local_calls_in_curr_thread();
     session_pool_->Release(session_);
     session_.reset();
-    if (next_) {
-      next_->Launch(session_pool_, allow_local_calls_in_curr_thread);
+
+    // Launch the dependents that do not wait for other blocks anymore. Only the last one launched
+    // may make local calls in this thread, so that it does not hold back the others.
+    boost::container::small_vector<Block*, 4> ready;
+    for (const auto& dependent : dependents_) {
+      if (dependent->dependencies_left_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ready.push_back(dependent.get());
+      }
     }
+    for (size_t i = 0; i != ready.size(); ++i) {
+      ready[i]->Launch(session_pool_, allow_local_calls_in_curr_thread && i + 1 == ready.size());
+    }
+    dependents_.clear();
     context_.reset();
   }
+
  private:
   BatchContextPtr context_;
   Ops ops_;
   rpc::RpcMethodMetrics metrics_internal_;
   MonoTime start_;
+  const bool read_;
   SessionPool* session_pool_;
   std::shared_ptr<client::YBSession> session_;
-  std::shared_ptr<Block> next_;
-};
-
-struct BlockData {
-  explicit BlockData(Arena* arena) : used_keys(UsedKeys::allocator_type(arena)) {}
-
-  typedef MCUnorderedSet<Slice, Slice::Hash> UsedKeys;
-  UsedKeys used_keys;
-  std::shared_ptr<Block> block;
-  size_t count = 0;
+  std::vector<std::shared_ptr<Block>> dependents_;
+  std::atomic<size_t> dependencies_left_{0};
 };
 
+// Groups the operations of a batch on one tablet into blocks. With safe batching, an operation
+// waits only for the blocks that last used its keys, so operations on other keys keep being
+// flushed concurrently.
 class TabletOperations {
  public:
   explicit TabletOperations(Arena* arena)
-      : read_data_(arena), write_data_(arena) {}
-
-  BlockData& data(bool read) {
-    return read ? read_data_ : write_data_;
-  }
+      : key_blocks_(KeyBlocks::allocator_type(arena)) {}
 
   void Done(SessionPool* session_pool, bool allow_local_calls_in_curr_thread) {
-    if (flush_head_) {
-      flush_head_->Launch(session_pool, allow_local_calls_in_curr_thread);
-    } else {
-      if (read_data_.block) {
-        read_data_.block->Launch(session_pool, allow_local_calls_in_curr_thread);
-      }
-      if (write_data_.block) {
-        write_data_.block->Launch(session_pool, allow_local_calls_in_curr_thread);
-      }
+    // The other blocks are launched when the blocks they depend on are processed.
+    if (read_block_) {
+      read_block_->Launch(session_pool, allow_local_calls_in_curr_thread && !write_block_);
+    }
+    if (write_block_) {
+      write_block_->Launch(session_pool, allow_local_calls_in_curr_thread);
     }
   }
 
@@ -463,70 +581,56 @@ class TabletOperations {
     bool read = operation->read();
     boost::container::small_vector<Slice, RedisClientCommand::static_capacity> keys;
     operation->GetKeys(&keys);
-    CheckConflicts(read, keys);
-    auto& data = this->data(read);
-    if (!data.block) {
-      ArenaAllocator<Block> alloc(arena);
-      data.block = std::allocate_shared<Block>(alloc, context, alloc, metrics_internal[read]);
-      if (read == last_conflict_was_read_) {
-        auto old_value = this->data(!read).block->SetNext(data.block);
-        if (old_value) {
-          LOG(DFATAL) << "Opposite already had next block: "
-                      << operation->call().serialized_request().ToDebugString();
-        }
+
+    // Blocks that last used the keys of the operation.
+    boost::container::small_vector<std::shared_ptr<Block>, 4> dependencies;
+    for (const auto& key : keys) {
+      auto it = key_blocks_.find(key);
+      if (it != key_blocks_.end() &&
+          std::find(dependencies.begin(), dependencies.end(), it->second) == dependencies.end()) {
+        dependencies.push_back(it->second);
       }
     }
-    data.block->AddOperation(operation);
-    RememberKeys(read, &keys);
-  }
 
- private:
-  void ConflictFound(bool read) {
-    auto& data = this->data(read);
-    auto& opposite_data = this->data(!read);
-
-    if (indeterminate(last_conflict_was_read_)) {
-      flush_head_ = opposite_data.block;
-      opposite_data.block->SetNext(data.block);
+    std::shared_ptr<Block> block;
+    if (dependencies.empty()) {
+      auto& first_block = read ? read_block_ : write_block_;
+      if (!first_block) {
+        first_block = NewBlock(context, arena, metrics_internal, read);
+      }
+      block = first_block;
+    } else if (dependencies.size() == 1 && dependencies.front()->read() == read) {
+      // Operations of the same kind keep their order within a block.
+      block = dependencies.front();
     } else {
-      data.block = nullptr;
-      data.used_keys.clear();
-    }
-    last_conflict_was_read_ = read;
-  }
-
-  void CheckConflicts(bool read, const RedisKeyList& keys) {
-    if (last_conflict_was_read_ == read) {
-      return;
-    }
-    auto& opposite = data(!read);
-    bool conflict = false;
-    for (const auto& key : keys) {
-      if (opposite.used_keys.count(key)) {
-        conflict = true;
-        break;
+      block = NewBlock(context, arena, metrics_internal, read);
+      for (const auto& dependency : dependencies) {
+        dependency->AddDependent(block);
       }
     }
-    if (conflict) {
-      ConflictFound(read);
+    block->AddOperation(operation);
+
+    for (auto& key : keys) {
+      key_blocks_[std::move(key)] = block;
     }
   }
 
-  void RememberKeys(bool read, RedisKeyList* keys) {
-    auto& dest = read ? read_data_ : write_data_;
-    for (auto& key : *keys) {
-      dest.used_keys.insert(std::move(key));
-    }
+ private:
+  static std::shared_ptr<Block> NewBlock(const BatchContextPtr& context,
+                                         Arena* arena,
+                                         rpc::RpcMethodMetrics* metrics_internal,
+                                         bool read) {
+    ArenaAllocator<Block> alloc(arena);
+    return std::allocate_shared<Block>(alloc, context, alloc, metrics_internal[read], read);
   }
 
-  BlockData read_data_;
-  BlockData write_data_;
-  std::shared_ptr<Block> flush_head_;
+  // The first read and write blocks, that do not depend on other blocks.
+  std::shared_ptr<Block> read_block_;
+  std::shared_ptr<Block> write_block_;
 
-  // true - last conflict was read.
-  // false - last conflict was write.
-  // indeterminate - no conflict was found yet.
-  boost::logic::tribool last_conflict_was_read_ = boost::logic::indeterminate;
+  // The block that last used each key.
+  typedef MCUnorderedMap<Slice, std::shared_ptr<Block>, Slice::Hash> KeyBlocks;
+  KeyBlocks key_blocks_;
 };
 
 class BatchContext : public RefCountedThreadSafe<BatchContext> {
@@ -578,6 +682,21 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
     }
   }
 
+  // Applies the per-key operations of a multi-key command.
+  template <class Op>
+  void ApplyMulti(size_t idx,
+                  std::vector<std::shared_ptr<Op>> ops,
+                  const rpc::RpcMethodMetrics& metrics) {
+    auto multi_response = std::make_shared<MultiResponse>(
+        call_, idx, ops.size(), metrics, std::is_same<Op, YBRedisReadOp>::value);
+    for (size_t i = 0; i != ops.size(); ++i) {
+      operations_.emplace_back(call_, idx, std::move(ops[i]), metrics, multi_response, i);
+      if (PREDICT_FALSE(operations_.back().responded())) {
+        operations_.pop_back();
+      }
+    }
+  }
+
  private:
   void LookupDone(Operation* operation, const Status& status) {
     if (!status.ok()) {
@@ -685,12 +804,31 @@ class RedisServiceImpl::Impl {
       Parser<Op> parser,
       BatchContext* context);
 
+  template<class Op>
+  void MultiCommand(
+      const RedisCommandInfo& info,
+      size_t idx,
+      Parser<RedisMultiOp<Op>> parser,
+      BatchContext* context);
+
   void TruncateCommand(
       const RedisCommandInfo& info,
       size_t idx,
       void (*parse)(const RedisClientCommand&),
       BatchContext* context);
 
+  void PubSubCommand(
+      const RedisCommandInfo& info,
+      size_t idx,
+      RedisResponsePB (*parse)(const RedisClientCommand&, const rpc::ConnectionPtr&, RedisPubSub*),
+      BatchContext* context);
+
+  void ClusterCommand(
+      const RedisCommandInfo& info,
+      size_t idx,
+      Status (*parse)(const RedisClientCommand&),
+      BatchContext* context);
+
   constexpr static int kRpcTimeoutSec = 5;
 
   void PopulateHandlers();
@@ -713,6 +851,9 @@ class RedisServiceImpl::Impl {
   SessionPool session_pool_;
   std::shared_ptr<client::YBTable> table_;
 
+  // Channels of this server, shared with the connection contexts of the subscribers.
+  std::shared_ptr<RedisPubSub> pubsub_ = std::make_shared<RedisPubSub>();
+
   RedisServer* server_;
 };
 
@@ -773,6 +914,96 @@ RedisResponsePB ParseQuit(const RedisClientCommand& command) {
   return RedisResponsePB();
 }
 
+// Encodes a reply to SUBSCRIBE or UNSUBSCRIBE for one channel.
+std::string EncodeSubscriptionReply(
+    const std::string& kind, const Slice* channel, size_t num_subscriptions) {
+  return EncodeAsArrayOfEncodedElements(std::initializer_list<std::string>{
+      EncodeAsBulkString(kind).ToBuffer(),
+      channel ? EncodeAsBulkString(channel->ToBuffer()).ToBuffer() : kNilResponse,
+      EncodeAsInteger(static_cast<int64_t>(num_subscriptions)).ToBuffer()});
+}
+
+RedisResponsePB ParsePublish(const RedisClientCommand& command,
+                             const rpc::ConnectionPtr& connection,
+                             RedisPubSub* pubsub) {
+  RedisResponsePB responsePB;
+  responsePB.set_code(RedisResponsePB_RedisStatusCode_OK);
+  responsePB.set_int_response(pubsub->Publish(command[1].ToBuffer(), command[2].ToBuffer()));
+  return responsePB;
+}
+
+RedisResponsePB ParseSubscribe(const RedisClientCommand& command,
+                               const rpc::ConnectionPtr& connection,
+                               RedisPubSub* pubsub) {
+  RedisResponsePB responsePB;
+  responsePB.set_code(RedisResponsePB_RedisStatusCode_OK);
+  std::string* reply = responsePB.mutable_encoded_response();
+  for (size_t i = 1; i != command.size(); ++i) {
+    const size_t num_subscriptions = pubsub->Subscribe(connection, command[i].ToBuffer());
+    *reply += EncodeSubscriptionReply("subscribe", &command[i], num_subscriptions);
+  }
+  return responsePB;
+}
+
+RedisResponsePB ParseUnsubscribe(const RedisClientCommand& command,
+                                 const rpc::ConnectionPtr& connection,
+                                 RedisPubSub* pubsub) {
+  auto* context = static_cast<RedisConnectionContext*>(&connection->context());
+  RedisResponsePB responsePB;
+  responsePB.set_code(RedisResponsePB_RedisStatusCode_OK);
+  std::string* reply = responsePB.mutable_encoded_response();
+  if (command.size() > 1) {
+    for (size_t i = 1; i != command.size(); ++i) {
+      const size_t num_subscriptions = pubsub->Unsubscribe(context, command[i].ToBuffer());
+      *reply += EncodeSubscriptionReply("unsubscribe", &command[i], num_subscriptions);
+    }
+    return responsePB;
+  }
+  // Without channels, unsubscribes from all of them.
+  auto channels = pubsub->UnsubscribeAll(context);
+  if (channels.empty()) {
+    *reply = EncodeSubscriptionReply("unsubscribe", nullptr, 0);
+  }
+  for (size_t i = 0; i != channels.size(); ++i) {
+    Slice channel(channels[i]);
+    *reply += EncodeSubscriptionReply("unsubscribe", &channel, channels.size() - i - 1);
+  }
+  return responsePB;
+}
+
+Status ParseCluster(const RedisClientCommand& command) {
+  if (!boost::iequals(command[1].ToBuffer(), "slots")) {
+    return STATUS_SUBSTITUTE(InvalidCommand, "CLUSTER $0 is not supported", command[1].ToBuffer());
+  }
+  return Status::OK();
+}
+
+// Encodes one entry of the CLUSTER SLOTS response: the hash slot range of the tablet, followed by
+// its leader and then the other replicas. The redis servers of all tablet servers are expected to
+// listen on the same port.
+std::string EncodeClusterSlots(const master::TabletLocationsPB& tablet, uint16_t redis_port) {
+  const auto& partition = tablet.partition();
+  const int64_t start = partition.partition_key_start().empty() ? 0 :
+      PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+  const int64_t end = partition.partition_key_end().empty() ? kRedisClusterSlots - 1 :
+      PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end()) - 1;
+  std::vector<std::string> elements = {
+      EncodeAsInteger(start).ToBuffer(), EncodeAsInteger(end).ToBuffer()};
+  for (bool leader : {true, false}) {
+    for (const auto& replica : tablet.replicas()) {
+      if ((replica.role() == consensus::RaftPeerPB::LEADER) != leader ||
+          replica.ts_info().rpc_addresses().empty()) {
+        continue;
+      }
+      elements.push_back(EncodeAsArrayOfEncodedElements(std::initializer_list<std::string>{
+          EncodeAsBulkString(replica.ts_info().rpc_addresses(0).host()).ToBuffer(),
+          EncodeAsInteger(static_cast<int64_t>(redis_port)).ToBuffer(),
+          EncodeAsBulkString(replica.ts_info().permanent_uuid()).ToBuffer()}));
+    }
+  }
+  return EncodeAsArrayOfEncodedElements(elements);
+}
+
 void ParseFlushDB(const RedisClientCommand& command) {
   // NOOP
 }
@@ -786,8 +1017,12 @@ void ParseFlushAll(const RedisClientCommand& command) {
 
 #define READ_COMMAND Command<YBRedisReadOp>
 #define WRITE_COMMAND Command<YBRedisWriteOp>
+#define MULTI_READ_COMMAND MultiCommand<YBRedisReadOp>
+#define MULTI_WRITE_COMMAND MultiCommand<YBRedisWriteOp>
 #define LOCAL_COMMAND LocalCommand
 #define TRUNCATE_COMMAND TruncateCommand
+#define PUBSUB_COMMAND PubSubCommand
+#define CLUSTER_COMMAND ClusterCommand
 
 #define DO_POPULATE_HANDLER(name, cname, arity, type) \
   { \
@@ -960,6 +1195,24 @@ void RedisServiceImpl::Impl::Command(
   context->Apply(idx, std::move(op), info.metrics);
 }
 
+template<class Op>
+void RedisServiceImpl::Impl::MultiCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Parser<RedisMultiOp<Op>> parser,
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  RedisMultiOp<Op> multi_op(table_);
+  const auto& command = context->command(idx);
+  Status s = parser(&multi_op, command);
+  if (!s.ok()) {
+    RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+    return;
+  }
+  context->ApplyMulti(idx, std::move(multi_op.ops), info.metrics);
+}
+
 void RedisServiceImpl::Impl::TruncateCommand(
     const RedisCommandInfo& info,
     size_t idx,
@@ -980,6 +1233,52 @@ void RedisServiceImpl::Impl::TruncateCommand(
   VLOG(4) << "Done responding to " << command[0].ToBuffer();
 }
 
+void RedisServiceImpl::Impl::PubSubCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    RedisResponsePB (*parse)(const RedisClientCommand&, const rpc::ConnectionPtr&, RedisPubSub*),
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+  const auto& command = context->command(idx);
+  RedisResponsePB response = parse(command, context->call()->connection(), pubsub_.get());
+  context->call()->RespondSuccess(idx, info.metrics, &response);
+}
+
+// Responds with the hash slots of the tablets of the redis table and the tablet servers hosting
+// them, so that cluster aware clients could send the commands to the leaders directly. Such
+// commands are executed without a proxy hop, since the client of a redis server in a tablet server
+// calls the local tablet server directly.
+void RedisServiceImpl::Impl::ClusterCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Status (*parse)(const RedisClientCommand&),
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+  const auto& command = context->command(idx);
+  Status s = parse(command);
+  if (!s.ok()) {
+    context->call()->RespondFailure(idx, s);
+    return;
+  }
+  google::protobuf::RepeatedPtrField<master::TabletLocationsPB> tablets;
+  s = client_->GetTablets(table_->name(), 0 /* max_tablets */, &tablets);
+  RedisResponsePB resp;
+  if (s.ok()) {
+    resp.set_code(RedisResponsePB_RedisStatusCode_OK);
+    auto* array = resp.mutable_array_response();
+    array->set_encoded(true);
+    const uint16_t redis_port = server_->first_rpc_address().port();
+    for (const auto& tablet : tablets) {
+      array->add_elements(EncodeClusterSlots(tablet, redis_port));
+    }
+  } else {
+    const Slice message = s.message();
+    resp.set_code(RedisResponsePB_RedisStatusCode_SERVER_ERROR);
+    resp.set_error_message(message.data(), message.size());
+  }
+  context->call()->RespondSuccess(idx, info.metrics, &resp);
+}
+
 void RedisServiceImpl::Impl::RespondWithFailure(
     std::shared_ptr<RedisInboundCall> call,
     size_t idx,
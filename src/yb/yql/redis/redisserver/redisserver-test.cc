@@ -13,9 +13,11 @@
 
 #include <cpp_redis/cpp_redis>
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <random>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -42,6 +44,7 @@ DECLARE_bool(redis_safe_batch);
 DECLARE_bool(emulate_redis_responses);
 DECLARE_int32(redis_max_value_size);
 DECLARE_int32(redis_max_command_size);
+DECLARE_int32(redis_chunked_string_min_bytes);
 DECLARE_int32(rpc_max_message_size);
 DECLARE_int32(consensus_max_batch_size_bytes);
 DECLARE_int32(consensus_rpc_timeout_ms);
@@ -807,6 +810,22 @@ TEST_F_EX(TestRedisService, SafeBatchPipeline, TestRedisServiceSafeBatch) {
   LOG(INFO) << yb::Format("Safe set: $0ms, get: $1ms", set_time.count(), get_time.count());
 }
 
+// A key used over and over in the batch must not reorder the commands on it nor the commands on the
+// other keys, which are not serialized behind it.
+TEST_F_EX(TestRedisService, SafeBatchRepeatedKey, TestRedisServiceSafeBatch) {
+  SendCommandAndExpectResponse(__LINE__, PipelineSetCommand(), PipelineSetResponse());
+  std::string command;
+  std::string response;
+  for (size_t i = 0; i != kPipelineKeys; ++i) {
+    command += yb::Format("set counter $0\r\nget counter\r\nget $0\r\n", i);
+    std::string counter = std::to_string(i);
+    std::string value = std::to_string(ValueForKey(i));
+    response += yb::Format("+OK\r\n$$$0\r\n$1\r\n$$$2\r\n$3\r\n",
+                           counter.length(), counter, value.length(), value);
+  }
+  SendCommandAndExpectResponse(__LINE__, command, response);
+}
+
 TEST_F(TestRedisService, BatchedCommandMulti) {
   SendCommandAndExpectResponse(
       __LINE__,
@@ -966,6 +985,63 @@ TEST_F(TestRedisService, TestSetThenGet) {
   );
 }
 
+TEST_F(TestRedisService, TestMSetThenMGet) {
+  SendCommandAndExpectResponse(__LINE__,
+      EncodeAsArray({"mset"s, "k1"s, "v1"s, "k2"s, "v2"s}), EncodeAsSimpleString("OK"));
+  SendCommandAndExpectResponse(__LINE__,
+      EncodeAsArray({"mget"s, "k1"s, "missing"s, "k2"s}),
+      "*3\r\n$2\r\nv1\r\n$-1\r\n$2\r\nv2\r\n");
+  SendCommandAndExpectResponse(__LINE__, EncodeAsArray({"get"s, "k2"s}), EncodeAsBulkString("v2"));
+}
+
+TEST_F(TestRedisService, TestPubSub) {
+  SendCommandAndExpectResponse(__LINE__, EncodeAsArray({"subscribe"s, "ch1"s, "ch2"s}),
+      "*3\r\n$9\r\nsubscribe\r\n$3\r\nch1\r\n:1\r\n"
+      "*3\r\n$9\r\nsubscribe\r\n$3\r\nch2\r\n:2\r\n");
+  DoRedisTestInt(__LINE__, {"PUBLISH", "ch1", "hello"}, 1);
+  DoRedisTestInt(__LINE__, {"PUBLISH", "other", "hello"}, 0);
+  SyncClient();
+
+  // The message was pushed to the subscriber before the response to its next command.
+  SendCommandAndExpectResponse(__LINE__, EncodeAsArray({"ping"s}),
+      "*3\r\n$7\r\nmessage\r\n$3\r\nch1\r\n$5\r\nhello\r\n$4\r\nPONG\r\n");
+  SendCommandAndExpectResponse(__LINE__, EncodeAsArray({"unsubscribe"s, "ch1"s}),
+      "*3\r\n$11\r\nunsubscribe\r\n$3\r\nch1\r\n:1\r\n");
+  DoRedisTestInt(__LINE__, {"PUBLISH", "ch1", "hello"}, 0);
+  SyncClient();
+  SendCommandAndExpectResponse(__LINE__, EncodeAsArray({"unsubscribe"s}),
+      "*3\r\n$11\r\nunsubscribe\r\n$3\r\nch2\r\n:0\r\n");
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestClusterSlots) {
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  DoRedisTest(__LINE__, {"CLUSTER", "SLOTS"}, cpp_redis::reply::type::array,
+      [&ranges](const RedisReply& reply) {
+        for (const auto& entry : reply.as_array()) {
+          const auto& fields = entry.as_array();
+          // The slot range and at least the leader.
+          ASSERT_GE(fields.size(), 3);
+          ranges.emplace_back(fields[0].as_integer(), fields[1].as_integer());
+          ASSERT_EQ(3, fields[2].as_array().size());
+        }
+      });
+  DoRedisTestExpectError(__LINE__, {"CLUSTER", "NODES"});
+  SyncClient();
+  VerifyCallbacks();
+
+  // The ranges cover all hash slots.
+  std::sort(ranges.begin(), ranges.end());
+  ASSERT_FALSE(ranges.empty());
+  int64_t next_slot = 0;
+  for (const auto& range : ranges) {
+    ASSERT_EQ(next_slot, range.first);
+    ASSERT_LE(range.first, range.second);
+    next_slot = range.second + 1;
+  }
+  ASSERT_EQ(kRedisClusterSlots, next_slot);
+}
+
 TEST_F(TestRedisService, TestUsingOpenSourceClient) {
   DoRedisTestOk(__LINE__, {"SET", "hello", "42"});
 
@@ -1038,6 +1114,84 @@ TEST_F(TestRedisService, TestTtl) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestSetExAndTtl) {
+  DoRedisTestOk(__LINE__, {"SET", "k1", "v1"});
+  DoRedisTestOk(__LINE__, {"SETEX", "k2", "1", "v2"});
+  DoRedisTestOk(__LINE__, {"PSETEX", "k3", "1000", "v3"});
+  DoRedisTestOk(__LINE__, {"SETEX", "k4", NonTsanVsTsan("20", "100"), "v4"});
+  DoRedisTestInt(__LINE__, {"HSET", "h1", "f1", "v1"}, 1);
+  DoRedisTestExpectError(__LINE__, {"SETEX", "k5", std::to_string(kRedisMaxTtlSeconds + 1), "v5"});
+  SyncClient();
+
+  DoRedisTestInt(__LINE__, {"TTL", "k1"}, -1);
+  DoRedisTestInt(__LINE__, {"TTL", "h1"}, -1);
+  DoRedisTestInt(__LINE__, {"TTL", "missing"}, -2);
+  SyncClient();
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+
+  DoRedisTestNull(__LINE__, {"GET", "k2"});
+  DoRedisTestNull(__LINE__, {"GET", "k3"});
+  DoRedisTestBulkString(__LINE__, {"GET", "k4"}, "v4");
+  DoRedisTestInt(__LINE__, {"TTL", "k2"}, -2);
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestScan) {
+  constexpr size_t kNumKeys = 100;
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    DoRedisTestOk(__LINE__, {"SET", "key" + std::to_string(i), "v"});
+  }
+  DoRedisTestOk(__LINE__, {"SET", "other", "v"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", std::to_string(kRedisClusterSlots)});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "COUNT"});
+  SyncClient();
+
+  std::set<std::string> keys;
+  std::string cursor = "0";
+  size_t iterations = 0;
+  do {
+    DoRedisTest(__LINE__, {"SCAN", cursor, "MATCH", "key*", "COUNT", "10"},
+        cpp_redis::reply::type::array,
+        [&cursor, &keys](const RedisReply& reply) {
+          const auto& replies = reply.as_array();
+          ASSERT_EQ(2, replies.size());
+          cursor = replies[0].as_string();
+          for (const auto& key : replies[1].as_array()) {
+            keys.insert(key.as_string());
+          }
+        });
+    SyncClient();
+    ASSERT_LE(++iterations, kNumKeys);
+  } while (cursor != "0");
+  ASSERT_EQ(kNumKeys, keys.size());
+
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestIncrBy) {
+  // The commands are sent in one pipeline, so each increment has to see the previous writes to
+  // the key in the same batch.
+  DoRedisTestOk(__LINE__, {"SET", "counter", "10"});
+  DoRedisTestInt(__LINE__, {"INCR", "counter"}, 11);
+  DoRedisTestInt(__LINE__, {"INCRBY", "counter", "5"}, 16);
+  DoRedisTestInt(__LINE__, {"DECRBY", "counter", "3"}, 13);
+  DoRedisTestInt(__LINE__, {"INCRBY", "counter", "-20"}, -7);
+  DoRedisTestBulkString(__LINE__, {"GET", "counter"}, "-7");
+  DoRedisTestInt(__LINE__, {"DEL", "counter"}, 1);
+  DoRedisTestInt(__LINE__, {"INCRBY", "counter", "7"}, 7);
+  DoRedisTestInt(__LINE__, {"INCRBY", "new_counter", "3"}, 3);
+  DoRedisTestOk(__LINE__, {"SET", "text", "abc"});
+  DoRedisTestExpectError(__LINE__, {"INCR", "text"});
+  DoRedisTestExpectError(__LINE__, {"INCRBY", "counter", "x"});
+  SyncClient();
+
+  DoRedisTestBulkString(__LINE__, {"GET", "counter"}, "7");
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestDummyLocal) {
   expected_no_sessions_ = true;
   DoRedisTestBulkString(__LINE__, {"INFO"}, kInfoResponse);
@@ -1589,6 +1743,32 @@ TEST_F(TestRedisService, TestTsRangeByTime) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestTsRangeByTimeAggregation) {
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_agg", "-25", "1", "-15", "2", "-5", "3", "5", "4",
+      "15", "6"});
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_text", "1", "a"});
+
+  SyncClient();
+  // Buckets start at multiples of the bucket size, also for negative timestamps.
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-30", "30", "AGGREGATION", "SUM", "20"},
+      {"-40", "1.000000", "-20", "5.000000", "0", "10.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-30", "30", "AGGREGATION", "COUNT",
+      "20"}, {"-40", "1", "-20", "2", "0", "2"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-20", "20", "aggregation", "max", "20"},
+      {"-20", "3.000000", "0", "6.000000"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-30", "30", "AGGREGATION", "AVG",
+      "100"}, {"-100", "2.000000", "0", "5.000000"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-30", "30", "AGGREGATION",
+      "MEDIAN", "20"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-30", "30", "AGGREGATION",
+      "SUM", "0"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_text", "0", "10", "AGGREGATION",
+      "SUM", "10"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTsRem) {
 
   // Try some deletes before inserting any data.
@@ -1889,6 +2069,62 @@ TEST_F(TestRedisService, TestAdditionalCommands) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestChunkedStrings) {
+  FLAGS_redis_chunked_string_min_bytes = 1000;
+
+  // Spans three chunks of 64KB, and the bytes tell their offsets apart.
+  std::string expected;
+  for (int i = 0; i < 150000; ++i) {
+    expected.push_back('a' + i % 23);
+  }
+  DoRedisTestOk(__LINE__, {"SET", "key", expected.substr(0, 500)});
+  // Makes the string long enough to be stored in chunks.
+  DoRedisTestInt(__LINE__, {"APPEND", "key", expected.substr(500, 100000)}, 100500);
+  // Pipelined with the previous append, so it could find the chunks only in the write batch.
+  DoRedisTestInt(__LINE__, {"APPEND", "key", expected.substr(100500)}, expected.size());
+  SyncClient();
+
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, expected);
+  DoRedisTestInt(__LINE__, {"STRLEN", "key"}, expected.size());
+  DoRedisTestBulkString(__LINE__, {"GETRANGE", "key", "65530", "65545"},
+                        expected.substr(65530, 16));
+  DoRedisTestBulkString(__LINE__, {"GETRANGE", "key", "-10", "-1"},
+                        expected.substr(expected.size() - 10));
+  SyncClient();
+
+  // Across the boundary of the first two chunks.
+  expected.replace(65530, 12, "xyzxyzxyzxyz");
+  DoRedisTestInt(__LINE__, {"SETRANGE", "key", "65530", "xyzxyzxyzxyz"}, expected.size());
+  // Past the end, leaving a gap of zeros.
+  expected.resize(expected.size() + 70000, '\0');
+  expected += "tail";
+  DoRedisTestInt(__LINE__, {"SETRANGE", "key", std::to_string(expected.size() - 4), "tail"},
+                 expected.size());
+  SyncClient();
+
+  DoRedisTestInt(__LINE__, {"STRLEN", "key"}, expected.size());
+  DoRedisTestBulkString(__LINE__, {"GETRANGE", "key", "65520", "65550"},
+                        expected.substr(65520, 31));
+  DoRedisTestBulkString(__LINE__, {"GETRANGE", "key", "-70010", "-1"},
+                        expected.substr(expected.size() - 70010));
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, expected);
+  DoRedisTestExpectError(__LINE__, {"HGET", "key", "subkey"});
+  SyncClient();
+
+  // A plain value overwrites all the chunks.
+  DoRedisTestBulkString(__LINE__, {"GETSET", "key", "short"}, expected);
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, "short");
+  DoRedisTestInt(__LINE__, {"STRLEN", "key"}, 5);
+  DoRedisTestInt(__LINE__, {"APPEND", "key", "er"}, 7);
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "key"}, "shorter");
+  DoRedisTestInt(__LINE__, {"DEL", "key"}, 1);
+  SyncClient();
+
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestDel) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;